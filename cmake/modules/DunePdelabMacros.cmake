@@ -3,6 +3,9 @@ message(AUTHOR_WARNING "TODO: Implement Eigen test.")
 
 find_package(CXXUnorderedContainers)
 
+# OpenMP is optional and only enabled for targets that ask for it, see add_dune_openmp_flags
+find_package(OpenMP)
+
 function(add_dune_petsc_flags)
   if(PETSC_FOUND)
     cmake_parse_arguments(ADD_PETSC "SOURCE_ONLY;OBJECT" "" "" ${ARGN})
@@ -29,3 +32,15 @@ function(add_dune_petsc_flags)
 
   endif(PETSC_FOUND)
 endfunction(add_dune_petsc_flags)
+
+# Adds the compiler and linker flags for OpenMP to the given targets. The threaded
+# code paths (e.g. colored assembly in DefaultAssembler) are only compiled if _OPENMP
+# is defined.
+function(add_dune_openmp_flags)
+  if(OPENMP_FOUND)
+    foreach(_target ${ARGN})
+      set_property(TARGET ${_target} APPEND_STRING PROPERTY COMPILE_FLAGS " ${OpenMP_CXX_FLAGS}")
+      set_property(TARGET ${_target} APPEND_STRING PROPERTY LINK_FLAGS " ${OpenMP_CXX_FLAGS}")
+    endforeach(_target ${ARGN})
+  endif(OPENMP_FOUND)
+endfunction(add_dune_openmp_flags)
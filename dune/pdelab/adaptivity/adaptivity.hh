@@ -13,6 +13,7 @@
 #include<dune/geometry/quadraturerules.hh>
 #include<dune/pdelab/gridfunctionspace/genericdatahandle.hh>
 #include<dune/pdelab/gridfunctionspace/localfunctionspace.hh>
+#include<dune/pdelab/adaptivity/doerflermarking.hh>
 
 #include<dune/pdelab/common/function.hh>
 // for InterpolateBackendStandard
@@ -243,15 +244,21 @@ namespace Dune {
         Geometry fine_geometry = _current->geometry();
         Geometry coarse_geometry = _ancestor->geometry();
 
+        // the finite elements do not change within the quadrature loop
+        const FE& fine_fe = fem.find(*_current);
+        const FE& coarse_fe = fem.find(*_ancestor);
+
+        // integrate the fine function against the coarse basis and apply the
+        // inverse mass matrix once afterwards instead of at every quadrature point
+        std::vector<RF> projection(inverse_mass_matrix.M(),RF(0.0));
+
         const QuadratureRule<DF,dim>& rule = QuadratureRules<DF,dim>::rule(_current->type(),_int_order);
         // iterate over quadrature points
         for (typename QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
             typename Geometry::LocalCoordinate coarse_local = coarse_geometry.local(fine_geometry.global(it->position()));
-            const FE* fe = &fem.find(*_current);
-            fe->localBasis().evaluateFunction(it->position(),fine_phi);
-            fe = &fem.find(*_ancestor);
-            fe->localBasis().evaluateFunction(coarse_local,coarse_phi);
+            fine_fe.localBasis().evaluateFunction(it->position(),fine_phi);
+            coarse_fe.localBasis().evaluateFunction(coarse_local,coarse_phi);
             const DF factor = it->weight()
               * fine_geometry.integrationElement(it->position())
               / coarse_geometry.integrationElement(coarse_local);
@@ -262,15 +269,14 @@ namespace Dune {
                 val.axpy(_u_fine[fine_offset + i],fine_phi[i]);
               }
 
-            for (size_type i = 0; i < coarse_phi.size(); ++i)
-              {
-                Range x(0.0);
-                for (size_type j = 0; j < inverse_mass_matrix.M(); ++j)
-                  x.axpy(inverse_mass_matrix[i][j],coarse_phi[j]);
-                (*_u_coarse)[coarse_offset + i] += factor * (x * val);
-              }
+            for (size_type j = 0; j < projection.size(); ++j)
+              projection[j] += factor * (coarse_phi[j] * val);
           }
 
+        for (size_type i = 0; i < inverse_mass_matrix.N(); ++i)
+          for (size_type j = 0; j < projection.size(); ++j)
+            (*_u_coarse)[coarse_offset + i] += inverse_mass_matrix[i][j] * projection[j];
+
         ++_leaf_index;
       }
 
@@ -724,53 +730,70 @@ namespace Dune {
 
 
 
+#ifndef DOXYGEN
+
+    namespace impl {
+
+      // Computes refinement and coarsening thresholds from a histogram of the entries of x
+      template<typename T>
+      void fraction_thresholds(const T& x, typename T::ElementType alpha, typename T::ElementType beta,
+                               bool weighted, typename T::ElementType& eta_alpha,
+                               typename T::ElementType& eta_beta, std::size_t bins)
+      {
+        typedef typename T::ElementType NumberType;
+        IndicatorStatistics<NumberType> stats;
+        for (typename T::const_iterator it = x.begin(), end = x.end(); it != end; ++it)
+          stats.add(*it);
+        IndicatorHistogram<NumberType> histogram(stats,bins);
+        for (typename T::const_iterator it = x.begin(), end = x.end(); it != end; ++it)
+          histogram.add(*it);
+        eta_alpha = histogram.upperThreshold(alpha,weighted);
+        eta_beta = histogram.lowerThreshold(beta,weighted);
+      }
+
+      // Reports the error and element fractions obtained with the given thresholds
+      template<typename T>
+      void print_fractions(const T& x, typename T::ElementType eta_alpha, typename T::ElementType eta_beta)
+      {
+        typedef typename T::ElementType NumberType;
+        NumberType total_error = 0.0;
+        NumberType sum_alpha = 0.0;
+        NumberType sum_beta = 0.0;
+        unsigned int alpha_count = 0;
+        unsigned int beta_count = 0;
+        for (typename T::const_iterator it = x.begin(), end = x.end(); it != end; ++it)
+          {
+            total_error += *it;
+            if (*it >= eta_alpha) { sum_alpha += *it; alpha_count++; }
+            if (*it < eta_beta) { sum_beta += *it; beta_count++; }
+          }
+        std::cout << "+++ eta_alpha=" << eta_alpha << " alpha_fraction=" << sum_alpha/total_error
+                  << " elements: " << alpha_count << " of " << x.N() << std::endl;
+        std::cout << "+++ eta_beta=" << eta_beta << " beta_fraction=" << sum_beta/total_error
+                  << " elements: " << beta_count << " of " << x.N() << std::endl;
+      }
+
+    } // namespace impl
+
+#endif // DOXYGEN
+
+    /** \brief Compute thresholds such that the elements with an error above eta_alpha carry
+     *         a fraction alpha and those below eta_beta a fraction beta of the total error.
+     *
+     * The thresholds are located in a single histogram pass over x with the given number of
+     * logarithmically spaced bins, see DoerflerMarking for a parallel version that also marks
+     * the grid.
+     */
     template<typename T>
     void error_fraction(const T& x, typename T::ElementType alpha, typename T::ElementType beta,
-                        typename T::ElementType& eta_alpha, typename T::ElementType& eta_beta, int verbose=0)
+                        typename T::ElementType& eta_alpha, typename T::ElementType& eta_beta, int verbose=0,
+                        std::size_t bins=1024)
     {
       if (verbose>0)
         std::cout << "+++ error fraction: alpha=" << alpha << " beta=" << beta << std::endl;
-      const int steps=20; // max number of bisection steps
-      typedef typename T::ElementType NumberType;
-      NumberType total_error = x.one_norm();
-      NumberType max_error = x.infinity_norm();
-      NumberType eta_alpha_left = 0.0;
-      NumberType eta_alpha_right = max_error;
-      NumberType eta_beta_left = 0.0;
-      NumberType eta_beta_right = max_error;
-      for (int j=1; j<=steps; j++)
-        {
-          eta_alpha = 0.5*(eta_alpha_left+eta_alpha_right);
-          eta_beta = 0.5*(eta_beta_left+eta_beta_right);
-          NumberType sum_alpha=0.0;
-          NumberType sum_beta=0.0;
-          unsigned int alpha_count = 0;
-          unsigned int beta_count = 0;
-          for (typename T::const_iterator it = x.begin(),
-                 end = x.end();
-               it != end;
-               ++it)
-            {
-              if (*it >=eta_alpha) { sum_alpha += *it; alpha_count++;}
-              if (*it < eta_beta) { sum_beta += *it; beta_count++;}
-            }
-          if (verbose>1)
-            {
-              std::cout << "+++ " << j << " eta_alpha=" << eta_alpha << " alpha_fraction=" << sum_alpha/total_error
-                        << " elements: " << alpha_count << " of " << x.N() << std::endl;
-              std::cout << "+++ " << j << " eta_beta=" << eta_beta << " beta_fraction=" << sum_beta/total_error
-                        << " elements: " << beta_count << " of " << x.N() << std::endl;
-            }
-          if (std::abs(alpha-sum_alpha/total_error) <= 0.01 && std::abs(beta-sum_beta/total_error) <= 0.01) break;
-          if (sum_alpha>alpha*total_error)
-            eta_alpha_left = eta_alpha;
-          else
-            eta_alpha_right = eta_alpha;
-          if (sum_beta>beta*total_error)
-            eta_beta_right = eta_beta;
-          else
-            eta_beta_left = eta_beta;
-        }
+      impl::fraction_thresholds(x,alpha,beta,true,eta_alpha,eta_beta,bins);
+      if (verbose>1)
+        impl::print_fractions(x,eta_alpha,eta_beta);
       if (verbose>0)
         {
           std::cout << "+++ refine_threshold=" << eta_alpha
@@ -779,52 +802,19 @@ namespace Dune {
     }
 
 
+    /** \brief Compute thresholds such that a fraction alpha of the elements has an error above
+     *         eta_alpha and a fraction beta an error below eta_beta.
+     *
+     * \see error_fraction()
+     */
     template<typename T>
     void element_fraction(const T& x, typename T::ElementType alpha, typename T::ElementType beta,
-                          typename T::ElementType& eta_alpha, typename T::ElementType& eta_beta, int verbose=0)
+                          typename T::ElementType& eta_alpha, typename T::ElementType& eta_beta, int verbose=0,
+                          std::size_t bins=1024)
     {
-      const int steps=20; // max number of bisection steps
-      typedef typename T::ElementType NumberType;
-      NumberType total_error =x.N();
-      NumberType max_error = x.infinity_norm();
-      NumberType eta_alpha_left = 0.0;
-      NumberType eta_alpha_right = max_error;
-      NumberType eta_beta_left = 0.0;
-      NumberType eta_beta_right = max_error;
-      for (int j=1; j<=steps; j++)
-        {
-          eta_alpha = 0.5*(eta_alpha_left+eta_alpha_right);
-          eta_beta = 0.5*(eta_beta_left+eta_beta_right);
-          NumberType sum_alpha=0.0;
-          NumberType sum_beta=0.0;
-          unsigned int alpha_count = 0;
-          unsigned int beta_count = 0;
-
-          for (typename T::const_iterator it = x.begin(),
-                 end = x.end();
-               it != end;
-               ++it)
-            {
-              if (*it>=eta_alpha) { sum_alpha += 1.0; alpha_count++;}
-              if (*it< eta_beta) { sum_beta +=1.0; beta_count++;}
-            }
-          if (verbose>1)
-            {
-              std::cout << j << " eta_alpha=" << eta_alpha << " alpha_fraction=" << sum_alpha/total_error
-                        << " elements: " << alpha_count << " of " << x.N() << std::endl;
-              std::cout << j << " eta_beta=" << eta_beta << " beta_fraction=" << sum_beta/total_error
-                        << " elements: " << beta_count << " of " << x.N() << std::endl;
-            }
-          if (std::abs(alpha-sum_alpha/total_error) <= 0.01 && std::abs(beta-sum_beta/total_error) <= 0.01) break;
-          if (sum_alpha>alpha*total_error)
-            eta_alpha_left = eta_alpha;
-          else
-            eta_alpha_right = eta_alpha;
-          if (sum_beta>beta*total_error)
-            eta_beta_right = eta_beta;
-          else
-            eta_beta_left = eta_beta;
-        }
+      impl::fraction_thresholds(x,alpha,beta,false,eta_alpha,eta_beta,bins);
+      if (verbose>1)
+        impl::print_fractions(x,eta_alpha,eta_beta);
       if (verbose>0)
         {
           std::cout << "+++ refine_threshold=" << eta_alpha
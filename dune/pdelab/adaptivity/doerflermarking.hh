@@ -0,0 +1,492 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_ADAPTIVITY_DOERFLERMARKING_HH
+#define DUNE_PDELAB_ADAPTIVITY_DOERFLERMARKING_HH
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/shared_ptr.hh>
+#include <dune/grid/common/gridenums.hh>
+
+#include <dune/pdelab/gridfunctionspace/localfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/lfsindexcache.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+#ifndef DOXYGEN
+
+    namespace impl {
+
+      // Global properties of a set of nonnegative error indicators
+      template<typename NT>
+      struct IndicatorStatistics
+      {
+        double count;
+        NT sum;
+        NT max;
+        NT min_positive;
+
+        IndicatorStatistics()
+        {
+          clear();
+        }
+
+        void clear()
+        {
+          count = 0.0;
+          sum = 0.0;
+          max = 0.0;
+          min_positive = std::numeric_limits<NT>::max();
+        }
+
+        void add(NT v)
+        {
+          count += 1.0;
+          sum += v;
+          max = std::max(max,v);
+          if (v > 0.0)
+            min_positive = std::min(min_positive,v);
+        }
+
+        void merge(const IndicatorStatistics& other)
+        {
+          count += other.count;
+          sum += other.sum;
+          max = std::max(max,other.max);
+          min_positive = std::min(min_positive,other.min_positive);
+        }
+
+        template<typename CC>
+        void reduce(const CC& comm)
+        {
+          count = comm.sum(count);
+          sum = comm.sum(sum);
+          max = comm.max(max);
+          min_positive = comm.min(min_positive);
+        }
+      };
+
+      // Histogram of the error indicators with logarithmically spaced bins between
+      // the smallest positive and the largest indicator. Exact zeros are kept in a
+      // separate bucket. Each bin stores the number of indicators and their sum, which
+      // allows to compute both error and element fractions from the same histogram.
+      template<typename NT>
+      class IndicatorHistogram
+      {
+
+      public:
+
+        IndicatorHistogram(const IndicatorStatistics<NT>& stats, std::size_t bins)
+          : _bins(std::max(bins,std::size_t(1)))
+          , _min(stats.min_positive)
+          , _max(stats.max)
+          , _counts(_bins + 1,0.0)
+          , _sums(_bins + 1,0.0)
+        {
+          if (!(_max > 0.0))
+            _min = _max = 0.0;
+          _log_range = _max > _min ? std::log(_max/_min) : NT(0.0);
+        }
+
+        void clear()
+        {
+          std::fill(_counts.begin(),_counts.end(),0.0);
+          std::fill(_sums.begin(),_sums.end(),0.0);
+        }
+
+        void add(NT v)
+        {
+          const std::size_t b = bin(v);
+          _counts[b] += 1.0;
+          _sums[b] += v;
+        }
+
+        void merge(const IndicatorHistogram& other)
+        {
+          for (std::size_t b = 0; b <= _bins; ++b)
+            {
+              _counts[b] += other._counts[b];
+              _sums[b] += other._sums[b];
+            }
+        }
+
+        template<typename CC>
+        void reduce(const CC& comm)
+        {
+          comm.sum(&_counts[0],_counts.size());
+          comm.sum(&_sums[0],_sums.size());
+        }
+
+        //! Smallest threshold for which the indicators >= threshold make up the given fraction.
+        NT upperThreshold(NT fraction, bool weighted) const
+        {
+          const NT target = fraction*total(weighted);
+          if (!(target > 0.0))
+            return std::numeric_limits<NT>::max();
+          NT accumulated = 0.0;
+          for (std::size_t b = _bins; b > 0; --b)
+            {
+              const NT w = weight(b,weighted);
+              if (w > 0.0 && accumulated + w >= target)
+                return upperEdge(b) - (target - accumulated)/w*(upperEdge(b) - lowerEdge(b));
+              accumulated += w;
+            }
+          return 0.0;
+        }
+
+        //! Threshold for which the indicators < threshold make up the given fraction.
+        NT lowerThreshold(NT fraction, bool weighted) const
+        {
+          const NT target = fraction*total(weighted);
+          if (!(target > 0.0))
+            return 0.0;
+          NT accumulated = weight(0,weighted);
+          if (accumulated >= target)
+            return 0.0;
+          for (std::size_t b = 1; b <= _bins; ++b)
+            {
+              const NT w = weight(b,weighted);
+              if (w > 0.0 && accumulated + w >= target)
+                return lowerEdge(b) + (target - accumulated)/w*(upperEdge(b) - lowerEdge(b));
+              accumulated += w;
+            }
+          return _max;
+        }
+
+      private:
+
+        std::size_t bin(NT v) const
+        {
+          if (!(v > 0.0))
+            return 0;
+          if (!(_log_range > 0.0))
+            return _bins;
+          const NT position = _bins*std::log(v/_min)/_log_range;
+          if (!(position > 0.0))
+            return 1;
+          return std::min(std::size_t(position),_bins - 1) + 1;
+        }
+
+        NT lowerEdge(std::size_t b) const
+        {
+          if (b == 0)
+            return 0.0;
+          if (!(_log_range > 0.0))
+            return _min;
+          return _min*std::exp(_log_range*(b - 1)/_bins);
+        }
+
+        NT upperEdge(std::size_t b) const
+        {
+          if (b == 0)
+            return 0.0;
+          if (b == _bins || !(_log_range > 0.0))
+            return _max;
+          return _min*std::exp(_log_range*b/_bins);
+        }
+
+        NT weight(std::size_t b, bool weighted) const
+        {
+          return weighted ? _sums[b] : NT(_counts[b]);
+        }
+
+        NT total(bool weighted) const
+        {
+          NT t = 0.0;
+          for (std::size_t b = 0; b <= _bins; ++b)
+            t += weight(b,weighted);
+          return t;
+        }
+
+        std::size_t _bins;
+        NT _min;
+        NT _max;
+        NT _log_range;
+        std::vector<double> _counts;
+        std::vector<NT> _sums;
+
+      };
+
+      // Adds all values with a nonzero include flag to the accumulator. The values are
+      // distributed statically across the threads and the per-thread results are merged
+      // in thread order, so the result only depends on the number of threads.
+      template<typename NT, typename Accumulator>
+      void accumulateIndicators(const std::vector<NT>& values, const std::vector<char>& include,
+                                Accumulator& result, int threads)
+      {
+        const long n = values.size();
+#ifdef _OPENMP
+        const int thread_count = threads > 0 ? threads : omp_get_max_threads();
+#else
+        const int thread_count = 1;
+#endif
+        Accumulator empty(result);
+        empty.clear();
+        std::vector<Accumulator> partial(thread_count,empty);
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(thread_count)
+#endif
+        {
+#ifdef _OPENMP
+          Accumulator& local = partial[omp_get_thread_num()];
+#pragma omp for schedule(static)
+#else
+          Accumulator& local = partial[0];
+#endif
+          for (long i = 0; i < n; ++i)
+            if (include[i])
+              local.add(values[i]);
+        }
+
+        for (int t = 0; t < thread_count; ++t)
+          result.merge(partial[t]);
+      }
+
+    } // namespace impl
+
+#endif // DOXYGEN
+
+    //! Marks a grid for adaptation based on a cellwise error indicator.
+    /**
+     * DoerflerMarking computes the refinement and coarsening thresholds of the error
+     * and element fraction strategies (see error_fraction() and element_fraction())
+     * and marks the grid with them. In contrast to those functions, it
+     *
+     * - traverses the grid only once in update(), which gathers the indicators of all
+     *   cells into a flat array; marking afterwards only revisits the stored cells,
+     * - determines both thresholds from a single histogram over the indicators instead
+     *   of repeated bisection passes; the histogram has logarithmically spaced bins and
+     *   the thresholds are interpolated linearly inside the bin containing them,
+     * - builds the histogram with several threads if compiled with OpenMP support and
+     * - reduces the histogram across all processes of the grid view's communicator, so
+     *   that all processes obtain the same, global thresholds. Only interior cells enter
+     *   the statistics, while all cells are marked.
+     *
+     * The stored cells become invalid as soon as the grid changes, so update() has to be
+     * called after each adaptation and whenever the indicator changes.
+     *
+     * \tparam Grid  The grid to mark.
+     * \tparam X     The DOF vector type of the indicator, which is expected to live on
+     *               a space with a single DOF per cell (e.g. P0).
+     */
+    template<typename Grid, typename X>
+    class DoerflerMarking
+    {
+
+      typedef typename Grid::template Partition<Dune::All_Partition>::LeafGridView GV;
+      typedef typename GV::template Codim<0>::Iterator Iterator;
+      typedef typename GV::template Codim<0>::EntityPointer CellPointer;
+
+      typedef typename X::GridFunctionSpace GFS;
+      typedef LocalFunctionSpace<GFS> LFS;
+      typedef LFSIndexCache<LFS> LFSCache;
+      typedef typename X::template ConstLocalView<LFSCache> XView;
+
+    public:
+
+      typedef typename X::ElementType NumberType;
+      typedef std::size_t size_type;
+
+      //! Constructs the marking, call update() before computing thresholds or marking.
+      /**
+       * \param grid  The grid to mark.
+       * \param x     The cellwise error indicator.
+       * \param bins  The number of histogram bins used to locate the thresholds.
+       */
+      DoerflerMarking(Grid& grid, const X& x, size_type bins = 1024)
+        : _grid(grid)
+        , _x(x)
+        , _bins(bins)
+        , _threads(0)
+        , _refined(0)
+        , _coarsened(0)
+      {}
+
+      //! Sets the number of threads used for the histogram, 0 selects the OpenMP default.
+      void setThreads(int threads)
+      {
+        _threads = threads;
+      }
+
+      int threads() const
+      {
+        return _threads;
+      }
+
+      //! Sets the number of histogram bins.
+      void setBins(size_type bins)
+      {
+        _bins = bins;
+      }
+
+      size_type bins() const
+      {
+        return _bins;
+      }
+
+      //! Traverses the grid and gathers the indicator of every cell.
+      void update()
+      {
+        const GV gv = _grid.template leafGridView<Dune::All_Partition>();
+
+        _cells.clear();
+        _values.clear();
+        _interior.clear();
+        _cells.reserve(gv.size(0));
+        _values.reserve(gv.size(0));
+        _interior.reserve(gv.size(0));
+
+        LFS lfs(_x.gridFunctionSpace());
+        LFSCache lfs_cache(lfs);
+        XView x_view(_x);
+
+        for (Iterator it = gv.template begin<0>(); it != gv.template end<0>(); ++it)
+          {
+            lfs.bind(*it);
+            lfs_cache.update();
+            x_view.bind(lfs_cache);
+            _cells.push_back(CellPointer(it));
+            _values.push_back(x_view[0]);
+            _interior.push_back(it->partitionType() == Dune::InteriorEntity);
+            x_view.unbind();
+          }
+
+        impl::IndicatorStatistics<NumberType> stats;
+        impl::accumulateIndicators(_values,_interior,stats,_threads);
+        stats.reduce(gv.comm());
+
+        impl::IndicatorHistogram<NumberType> histogram(stats,_bins);
+        impl::accumulateIndicators(_values,_interior,histogram,_threads);
+        histogram.reduce(gv.comm());
+
+        _stats = stats;
+        _histogram = make_shared<impl::IndicatorHistogram<NumberType> >(histogram);
+      }
+
+      //! Thresholds such that the refined cells carry a fraction alpha and the coarsened cells a fraction beta of the total error.
+      void errorFraction(NumberType alpha, NumberType beta,
+                         NumberType& eta_alpha, NumberType& eta_beta, int verbose = 0) const
+      {
+        thresholds(alpha,beta,true,eta_alpha,eta_beta,verbose);
+      }
+
+      //! Thresholds such that a fraction alpha of the cells is refined and a fraction beta is coarsened.
+      void elementFraction(NumberType alpha, NumberType beta,
+                           NumberType& eta_alpha, NumberType& eta_beta, int verbose = 0) const
+      {
+        thresholds(alpha,beta,false,eta_alpha,eta_beta,verbose);
+      }
+
+      //! Marks the cells with the given thresholds, see mark_grid().
+      void mark(NumberType refine_threshold, NumberType coarsen_threshold,
+                int min_level = 0, int max_level = std::numeric_limits<int>::max(), int verbose = 0)
+      {
+        _refined = 0;
+        _coarsened = 0;
+        for (size_type i = 0; i < _cells.size(); ++i)
+          {
+            const typename GV::template Codim<0>::Entity& e = *_cells[i];
+            if (_values[i] >= refine_threshold && e.level() < max_level)
+              {
+                _grid.mark(1,e);
+                ++_refined;
+              }
+            if (_values[i] <= coarsen_threshold && e.level() > min_level)
+              {
+                _grid.mark(-1,e);
+                ++_coarsened;
+              }
+          }
+        if (verbose > 0)
+          std::cout << "+++ mark_grid: " << _refined << " marked for refinement, "
+                    << _coarsened << " marked for coarsening" << std::endl;
+      }
+
+      //! Gathers the indicator and marks the grid with the error fraction strategy.
+      void markErrorFraction(NumberType alpha, NumberType beta,
+                             int min_level = 0, int max_level = std::numeric_limits<int>::max(), int verbose = 0)
+      {
+        update();
+        NumberType eta_alpha, eta_beta;
+        errorFraction(alpha,beta,eta_alpha,eta_beta,verbose);
+        mark(eta_alpha,eta_beta,min_level,max_level,verbose);
+      }
+
+      //! Gathers the indicator and marks the grid with the element fraction strategy.
+      void markElementFraction(NumberType alpha, NumberType beta,
+                               int min_level = 0, int max_level = std::numeric_limits<int>::max(), int verbose = 0)
+      {
+        update();
+        NumberType eta_alpha, eta_beta;
+        elementFraction(alpha,beta,eta_alpha,eta_beta,verbose);
+        mark(eta_alpha,eta_beta,min_level,max_level,verbose);
+      }
+
+      //! The global sum of the indicators.
+      NumberType totalError() const
+      {
+        return _stats.sum;
+      }
+
+      //! The global maximum of the indicators.
+      NumberType maxError() const
+      {
+        return _stats.max;
+      }
+
+      //! The number of cells marked for refinement on this process by the last call to mark().
+      size_type refined() const
+      {
+        return _refined;
+      }
+
+      //! The number of cells marked for coarsening on this process by the last call to mark().
+      size_type coarsened() const
+      {
+        return _coarsened;
+      }
+
+    private:
+
+      void thresholds(NumberType alpha, NumberType beta, bool weighted,
+                      NumberType& eta_alpha, NumberType& eta_beta, int verbose) const
+      {
+        if (!_histogram)
+          DUNE_THROW(Exception,"DoerflerMarking: update() has to be called before computing thresholds");
+        eta_alpha = _histogram->upperThreshold(alpha,weighted);
+        eta_beta = _histogram->lowerThreshold(beta,weighted);
+        if (verbose > 0)
+          std::cout << "+++ refine_threshold=" << eta_alpha
+                    << " coarsen_threshold=" << eta_beta << std::endl;
+      }
+
+      Grid& _grid;
+      const X& _x;
+      size_type _bins;
+      int _threads;
+      std::vector<CellPointer> _cells;
+      std::vector<NumberType> _values;
+      std::vector<char> _interior;
+      impl::IndicatorStatistics<NumberType> _stats;
+      shared_ptr<impl::IndicatorHistogram<NumberType> > _histogram;
+      size_type _refined;
+      size_type _coarsened;
+
+    };
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_ADAPTIVITY_DOERFLERMARKING_HH
@@ -5,7 +5,10 @@
 #include <utility>
 #include <vector>
 #include <algorithm>
-#include <set>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include <dune/common/iteratorfacades.hh>
 
@@ -28,7 +31,13 @@ namespace Dune {
        * than the older pattern constructon method in PDELab. By letting the user specify
        * the average number of nonzeroes per row, it is possible to use a more efficient
        * array-based storage scheme for the majority of the pattern entries, only using
-       * expensive map-like lookups for those entries that exceed that average.
+       * a slower overflow area for those entries that exceed that average.
+       *
+       * The overflow area consists of one append buffer per thread, which is sorted and
+       * stripped of duplicates whenever it has doubled in size. Before the pattern is read,
+       * the buffers are merged into a single sorted list of (row,column) pairs. As long as
+       * different threads never add links to the same row (which is guaranteed by the colored
+       * assembly mode of the DefaultAssembler), add_link() may be called concurrently.
        *
        * BCRSPattern requires a recent version of the BCRSMatrix with support for row-wise
        * setting of column indices and split allocation of column index and data arrays.
@@ -51,13 +60,19 @@ namespace Dune {
         //! BCRSPattern cannot contain nested subpatterns. This entry is only required for TMP purposes.
         typedef void SubPattern;
 
+        //! add_link() may be called concurrently for different rows, see PatternSupportsConcurrentInsertion.
+        static const bool supports_concurrent_insertion = true;
+
       private:
 
         //! Marker value indicating an empty array entry.
         static const size_type empty = ~static_cast<size_type>(0);
 
+        //! Minimum number of entries in an overflow buffer before it gets compacted.
+        static const size_type min_compaction_size = 1024;
+
         //! Functor for looking up a column index within a row.
-        /**ss
+        /**
          * Looking up column indices requires a special comparison iterator,
          * as we want to either return the position of the actual index if it
          * has already been inserted or of the first empty matrix entry that we
@@ -82,12 +97,40 @@ namespace Dune {
 
         };
 
+        typedef std::pair<size_type,size_type> Link;
+        typedef std::vector<Link> Overflow;
 
-        typedef typename std::vector<size_type>::iterator IndicesIterator;
-        typedef typename std::set<std::pair<size_type,size_type> >::iterator OverflowIterator;
+        //! Append buffer for the overflow entries of a single thread.
+        struct OverflowBuffer
+        {
+
+          OverflowBuffer()
+            : compaction_size(min_compaction_size)
+          {}
+
+          //! Sorts the buffer and removes duplicate entries.
+          void compact()
+          {
+            std::sort(links.begin(),links.end());
+            links.erase(std::unique(links.begin(),links.end()),links.end());
+            compaction_size = std::max(size_type(min_compaction_size),size_type(2*links.size()));
+          }
+
+          void add(const Link& link)
+          {
+            links.push_back(link);
+            if (links.size() >= compaction_size)
+              compact();
+          }
+
+          Overflow links;
+          size_type compaction_size;
+
+        };
 
+        typedef typename std::vector<size_type>::iterator IndicesIterator;
         typedef typename std::vector<size_type>::const_iterator ConstIndicesIterator;
-        typedef typename std::set<std::pair<size_type,size_type> >::const_iterator ConstOverflowIterator;
+        typedef typename Overflow::const_iterator ConstOverflowIterator;
 
       public:
 
@@ -113,8 +156,20 @@ namespace Dune {
             }
           else
             {
-              // The row is already full -> spill into map
-              _overflow.insert(std::make_pair(i,j));
+              // The row is already full -> spill into the overflow buffer of this thread
+#ifdef _OPENMP
+              const std::size_t thread = omp_get_thread_num();
+              if (thread + 1 < _buffers.size())
+                _buffers[thread].add(std::make_pair(i,j));
+              else
+                {
+                  // more threads than anticipated, the last buffer is shared by all of them
+#pragma omp critical (dune_pdelab_bcrspattern_overflow)
+                  _buffers.back().add(std::make_pair(i,j));
+                }
+#else
+              _buffers.front().add(std::make_pair(i,j));
+#endif
             }
         }
 
@@ -133,6 +188,7 @@ namespace Dune {
         template<typename I>
         void sizes(I rit) const
         {
+          mergeOverflow();
           ConstIndicesIterator it = _indices.begin();
           ConstIndicesIterator end = _indices.begin() + _entries_per_row;
           ConstOverflowIterator oit = _overflow.begin();
@@ -186,24 +242,16 @@ namespace Dune {
           {
             if (_in_overflow)
               {
-                if (_oit != _oend)
-                  ++_oit;
-                if (_oit->first == _row)
-                  return;
+                ++_oit;
                 // we have exhausted the row, invalidate iterator
-                _at_end = true;
+                if (_oit == _oend || _oit->first != _row)
+                  _at_end = true;
               }
             else
               {
-                if (_it != _end)
-                  ++_it;
+                ++_it;
                 if (_it == _end || *_it == empty)
-                  {
-                    _in_overflow = true;
-                    // we have exhausted the row, invalidate iterator
-                    if (_oit == _oend || _oit->first > _row)
-                      _at_end = true;
-                  }
+                  switchToOverflow();
               }
           }
 
@@ -213,33 +261,43 @@ namespace Dune {
               return false;
             if (_at_end || other._at_end)
               return _at_end && other._at_end;
+            if (_in_overflow != other._in_overflow)
+              return false;
             if (_in_overflow)
               return _oit == other._oit;
             else
               return _it == other._it;
           }
 
+          void switchToOverflow()
+          {
+            _in_overflow = true;
+            // we have exhausted the row, invalidate iterator
+            if (_oit == _oend || _oit->first != _row)
+              _at_end = true;
+          }
+
           iterator(const BCRSPattern& p, size_type row, bool at_end)
             : _row(row)
             , _in_overflow(false)
             , _at_end(at_end)
             , _it(p._indices.begin() + row * p._entries_per_row)
             , _end(p._indices.begin() + (row+1) * p._entries_per_row)
-            , _oit(p._overflow.lower_bound(std::make_pair(row,0)))
+            , _oit(std::lower_bound(p._overflow.begin(),p._overflow.end(),Link(row,0)))
             , _oend(p._overflow.end())
           {
-            // catch corner case with completely empty row
-            if ((!_at_end) && _it == _end)
-              _at_end = _oit != _oend && _oit->first == _row;
+            // catch corner case with a row that has no entries in the array
+            if ((!_at_end) && (_it == _end || *_it == empty))
+              switchToOverflow();
           }
 
           size_type _row;
           bool _in_overflow;
           bool _at_end;
-          typename std::vector<size_type>::const_iterator _it;
-          typename std::vector<size_type>::const_iterator _end;
-          typename std::set<std::pair<size_type,size_type> >::const_iterator _oit;
-          const typename std::set<std::pair<size_type,size_type> >::const_iterator _oend;
+          ConstIndicesIterator _it;
+          ConstIndicesIterator _end;
+          ConstOverflowIterator _oit;
+          ConstOverflowIterator _oend;
 
 #endif // DOXYGEN
 
@@ -248,12 +306,14 @@ namespace Dune {
         //! Returns an iterator to the first column index of row i.
         iterator begin(size_type i) const
         {
+          mergeOverflow();
           return iterator(*this,i,false);
         }
 
         //! Returns an iterator past the last column index of row i.
         iterator end(size_type i) const
         {
+          mergeOverflow();
           return iterator(*this,i,true);
         }
 
@@ -268,6 +328,11 @@ namespace Dune {
           , _col_ordering(col_ordering)
           , _entries_per_row(entries_per_row)
           , _indices(row_ordering.blockCount()*entries_per_row,size_type(empty))
+#ifdef _OPENMP
+          , _buffers(omp_get_max_threads() + 1)
+#else
+          , _buffers(1)
+#endif
         {}
 
         const RowOrdering& rowOrdering() const
@@ -290,7 +355,9 @@ namespace Dune {
         void clear()
         {
           _indices = std::vector<size_type>();
-          _overflow = std::set<std::pair<size_type,size_type> >();
+          _overflow = Overflow();
+          for (typename std::vector<OverflowBuffer>::iterator it = _buffers.begin(); it != _buffers.end(); ++it)
+            *it = OverflowBuffer();
         }
 
         size_type entriesPerRow() const
@@ -300,17 +367,46 @@ namespace Dune {
 
         size_type overflowCount() const
         {
+          mergeOverflow();
           return _overflow.size();
         }
 
       private:
 
+        //! Merges the per-thread overflow buffers into the sorted overflow area.
+        void mergeOverflow() const
+        {
+          bool pending = false;
+          for (typename std::vector<OverflowBuffer>::const_iterator it = _buffers.begin(); it != _buffers.end(); ++it)
+            pending |= !it->links.empty();
+          if (!pending)
+            return;
+
+          const int buffer_count = _buffers.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+          for (int b = 0; b < buffer_count; ++b)
+            _buffers[b].compact();
+
+          for (int b = 0; b < buffer_count; ++b)
+            {
+              Overflow& links = _buffers[b].links;
+              const size_type old_size = _overflow.size();
+              _overflow.insert(_overflow.end(),links.begin(),links.end());
+              std::inplace_merge(_overflow.begin(),_overflow.begin() + old_size,_overflow.end());
+              _overflow.erase(std::unique(_overflow.begin(),_overflow.end()),_overflow.end());
+              _buffers[b] = OverflowBuffer();
+            }
+        }
+
         const RowOrdering& _row_ordering;
         const ColOrdering& _col_ordering;
         const size_type _entries_per_row;
 
         std::vector<size_type> _indices;
-        std::set<std::pair<size_type,size_type> > _overflow;
+        mutable Overflow _overflow;
+        mutable std::vector<OverflowBuffer> _buffers;
 
       };
 
@@ -333,6 +429,9 @@ namespace Dune {
         //! size type used by NestedPattern.
         typedef typename SubPattern::size_type size_type;
 
+        //! Different rows always end up in different rows of the subpatterns.
+        static const bool supports_concurrent_insertion = SubPattern::supports_concurrent_insertion;
+
         //! Add a link between the row indicated by ri and the column indicated by ci.
         /**
          * This method just forwards the call to the relevant block as indicated by the
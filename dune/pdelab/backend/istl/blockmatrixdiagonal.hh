@@ -3,6 +3,8 @@
 #ifndef DUNE_PDELAB_BACKEND_ISTL_BLOCKMATRIXDIAGONAL_HH
 #define DUNE_PDELAB_BACKEND_ISTL_BLOCKMATRIXDIAGONAL_HH
 
+#include <dune/common/shared_ptr.hh>
+
 #include <dune/pdelab/backend/istlmatrixbackend.hh>
 #include <dune/pdelab/backend/istlvectorbackend.hh>
 #include <dune/pdelab/backend/istl/utility.hh>
@@ -321,6 +323,82 @@ namespace Dune {
 
       };
 
+      //! Keeps the inverted (block-)diagonal of a matrix between solves.
+      /**
+       * The inverse is computed by update() and only recomputed if reuse is
+       * false, the matrix type changes or the number of rows of the matrix
+       * changes.  This is used by the solver backends for explicit time
+       * stepping, where the mass matrix is often time-independent and does
+       * not have to be inverted in every stage.
+       */
+      class InverseBlockDiagonalCache
+      {
+
+        struct Base
+        {
+          virtual ~Base() {}
+        };
+
+        template<typename M>
+        struct Inverse
+          : public Base
+        {
+          typedef typename BlockMatrixDiagonal<M>::MatrixElementVector Diagonal;
+
+          Inverse(const M& m)
+            : diagonal(m)
+            , rows(raw(m).N())
+          {
+            diagonal.invert();
+          }
+
+          Diagonal diagonal;
+          std::size_t rows;
+        };
+
+      public:
+
+        //! Returns whether an inverse has been computed.
+        bool ready() const
+        {
+          return bool(_inverse);
+        }
+
+        //! Discards the stored inverse.
+        void reset()
+        {
+          _inverse.reset();
+        }
+
+        //! Returns the inverted diagonal of A, computing it if necessary.
+        /**
+         * \param A     the matrix
+         * \param reuse whether an inverse computed in an earlier call may be returned
+         * \return true if the inverse has been recomputed
+         */
+        template<typename M>
+        bool update(const M& A, bool reuse)
+        {
+          Inverse<M>* inverse = dynamic_cast<Inverse<M>*>(_inverse.get());
+          if (reuse && inverse && inverse->rows == raw(A).N())
+            return false;
+          _inverse = make_shared<Inverse<M> >(A);
+          return true;
+        }
+
+        //! Computes y = D^{-1} x with the inverse computed by the last call to update().
+        template<typename M, typename X, typename Y>
+        void mv(const X& x, Y& y) const
+        {
+          static_cast<const Inverse<M>&>(*_inverse).diagonal.mv(x,y);
+        }
+
+      private:
+
+        shared_ptr<Base> _inverse;
+
+      };
+
     } // namespace istl
   } // namespace PDELab
 } // namespace Dune
@@ -0,0 +1,225 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_BACKEND_ISTL_GALERKINPRODUCT_HH
+#define DUNE_PDELAB_BACKEND_ISTL_GALERKINPRODUCT_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fmatrix.hh>
+
+namespace Dune {
+  namespace PDELab {
+    namespace istl {
+
+      //! \addtogroup Backend
+      //! \ingroup PDELab
+      //! \{
+
+      //! Galerkin product \f$ A_c = P^T A P \f$ of BCRS matrices, split into a symbolic and a numeric phase.
+      /**
+       * The symbolic phase (setup()) computes the sparsity pattern of the coarse matrix and
+       * remembers, for every entry of the fine matrix, the coarse matrix entries it contributes
+       * to. The numeric phase (apply()) then only runs over the entries of the fine matrix and
+       * accumulates the block products, without any allocation or index search. As long as
+       * the sparsity pattern of the fine matrix and the prolongation matrix do not change,
+       * setup() only has to be called once.
+       *
+       * The contribution map stores one pointer for each block product P_ki^T A_kl P_lj, that
+       * is up to nnz(A) * m^2 pointers, where m is the maximal number of blocks in a row of
+       * P. For the prolongation from a conforming Q1 space to a DG space, m is the number of
+       * vertices of a cell, so in 3D the map takes 64 pointers per block of A, about as much
+       * memory as A itself for Q1 DG blocks. memory() returns the actual size.
+       *
+       * The prolongation matrix and the coarse matrix must stay alive and keep their structure
+       * between setup() and apply(), the values of the prolongation matrix are read in every
+       * call to apply().
+       *
+       * \tparam P  BCRSMatrix type of the prolongation from the coarse to the fine space.
+       * \tparam M  BCRSMatrix type of the fine matrix.
+       * \tparam CM BCRSMatrix type of the coarse matrix.
+       */
+      template<typename P, typename M, typename CM>
+      class GalerkinProduct
+      {
+
+        typedef typename P::block_type PBlock;
+        typedef typename M::block_type Block;
+        typedef typename CM::block_type CBlock;
+        typedef typename CBlock::field_type field_type;
+
+        typedef FieldMatrix<field_type,PBlock::rows,PBlock::cols> ProductBlock;
+
+      public:
+
+        typedef typename M::size_type size_type;
+
+        GalerkinProduct()
+          : _rows(0)
+          , _nonzeroes(0)
+          , _revision(0)
+          , _max_p_row(0)
+        {}
+
+        //! Returns whether setup() has been called.
+        bool ready() const
+        {
+          return !_offsets.empty();
+        }
+
+        //! Returns whether A can be used with the structure built by setup().
+        /**
+         * The sparsity pattern of A is not compared entry by entry. Instead, the caller passes
+         * a revision of the structure, e.g. GridFunctionSpace::revision() of the space A was
+         * assembled on, and A is accepted if the revision and the number of rows and nonzeroes
+         * are the same as in the call to setup().
+         */
+        bool matches(const M& A, std::size_t revision) const
+        {
+          return ready() && revision == _revision && A.N() == _rows && A.nonzeroes() == _nonzeroes;
+        }
+
+        //! Returns the number of bytes used by the contribution map.
+        std::size_t memory() const
+        {
+          return _offsets.capacity() * sizeof(std::size_t) + _targets.capacity() * sizeof(CBlock*);
+        }
+
+        //! Symbolic phase: builds the structure of Ac and the contribution map.
+        /**
+         * Ac has to be an empty matrix that has not been set up yet. Its entries are
+         * initialized to zero. The revision identifies the structure of A for matches().
+         */
+        void setup(const P& p, const M& A, CM& Ac, std::size_t revision = 0)
+        {
+          if (p.N() != A.M() || A.N() != A.M())
+            DUNE_THROW(RangeError,"GalerkinProduct: matrix sizes do not match");
+
+          const size_type n = p.M();
+
+          // sparsity pattern of the coarse matrix
+          std::vector<std::vector<size_type> > pattern(n);
+          _max_p_row = 0;
+          for (typename P::ConstRowIterator row = p.begin(); row != p.end(); ++row)
+            _max_p_row = std::max(_max_p_row,std::size_t(row->size()));
+
+          for (typename M::ConstRowIterator row = A.begin(); row != A.end(); ++row)
+            for (typename M::ConstColIterator it = row->begin(); it != row->end(); ++it)
+              for (typename P::ConstColIterator pi = p[row.index()].begin(); pi != p[row.index()].end(); ++pi)
+                for (typename P::ConstColIterator pj = p[it.index()].begin(); pj != p[it.index()].end(); ++pj)
+                  pattern[pi.index()].push_back(pj.index());
+
+          Ac.setBuildMode(CM::random);
+          Ac.setSize(n,n);
+          for (size_type i = 0; i < n; ++i)
+            {
+              std::sort(pattern[i].begin(),pattern[i].end());
+              pattern[i].erase(std::unique(pattern[i].begin(),pattern[i].end()),pattern[i].end());
+              Ac.setrowsize(i,pattern[i].size());
+            }
+          Ac.endrowsizes();
+          for (size_type i = 0; i < n; ++i)
+            {
+              for (std::size_t k = 0; k < pattern[i].size(); ++k)
+                Ac.addindex(i,pattern[i][k]);
+              std::vector<size_type>().swap(pattern[i]);
+            }
+          Ac.endindices();
+          Ac = field_type(0);
+
+          // contribution map: the targets of each fine matrix entry (k,l) are stored
+          // row-major as Ac[i][j] for all i in row k and all j in row l of p
+          _rows = A.N();
+          _nonzeroes = A.nonzeroes();
+          _revision = revision;
+          _offsets.clear();
+          _offsets.reserve(A.nonzeroes() + 1);
+          _targets.clear();
+          _offsets.push_back(0);
+          for (typename M::ConstRowIterator row = A.begin(); row != A.end(); ++row)
+            for (typename M::ConstColIterator it = row->begin(); it != row->end(); ++it)
+              {
+                for (typename P::ConstColIterator pi = p[row.index()].begin(); pi != p[row.index()].end(); ++pi)
+                  for (typename P::ConstColIterator pj = p[it.index()].begin(); pj != p[it.index()].end(); ++pj)
+                    _targets.push_back(&Ac[pi.index()][pj.index()]);
+                _offsets.push_back(_targets.size());
+              }
+
+          _products.resize(_max_p_row);
+        }
+
+        //! Numeric phase: computes the values of Ac from the current values of p and A.
+        void apply(const P& p, const M& A, CM& Ac) const
+        {
+          if (!ready())
+            DUNE_THROW(InvalidStateException,"GalerkinProduct: apply() called before setup()");
+
+          Ac = field_type(0);
+          CBlock* const* const targets = _targets.empty() ? 0 : &_targets[0];
+          std::size_t e = 0;
+          for (typename M::ConstRowIterator row = A.begin(); row != A.end(); ++row)
+            {
+              const typename P::row_type& prow = p[row.index()];
+              for (typename M::ConstColIterator it = row->begin(); it != row->end(); ++it, ++e)
+                {
+                  const typename P::row_type& pcol = p[it.index()];
+
+                  // A_kl P_lj for all j in row l of p
+                  std::size_t j = 0;
+                  for (typename P::ConstColIterator pj = pcol.begin(); pj != pcol.end(); ++pj, ++j)
+                    multiply(*it,*pj,_products[j]);
+
+                  // Ac_ij += P_ki^T (A_kl P_lj)
+                  CBlock* const* target = targets + _offsets[e];
+                  for (typename P::ConstColIterator pi = prow.begin(); pi != prow.end(); ++pi)
+                    for (std::size_t jj = 0; jj < j; ++jj, ++target)
+                      addTransposedProduct(*pi,_products[jj],**target);
+                }
+            }
+        }
+
+      private:
+
+        static void multiply(const Block& a, const PBlock& b, ProductBlock& c)
+        {
+          for (int r = 0; r < PBlock::rows; ++r)
+            for (int s = 0; s < PBlock::cols; ++s)
+              {
+                field_type sum(0);
+                for (int k = 0; k < PBlock::rows; ++k)
+                  sum += a[r][k] * b[k][s];
+                c[r][s] = sum;
+              }
+        }
+
+        static void addTransposedProduct(const PBlock& a, const ProductBlock& b, CBlock& c)
+        {
+          for (int r = 0; r < PBlock::cols; ++r)
+            for (int s = 0; s < PBlock::cols; ++s)
+              {
+                field_type sum(0);
+                for (int k = 0; k < PBlock::rows; ++k)
+                  sum += a[k][r] * b[k][s];
+                c[r][s] += sum;
+              }
+        }
+
+        size_type _rows;
+        std::size_t _nonzeroes;
+        std::size_t _revision;
+        std::size_t _max_p_row;
+        std::vector<std::size_t> _offsets;
+        std::vector<CBlock*> _targets;
+        mutable std::vector<ProductBlock> _products;
+
+      };
+
+      //! \} group Backend
+
+    } // namespace istl
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_BACKEND_ISTL_GALERKINPRODUCT_HH
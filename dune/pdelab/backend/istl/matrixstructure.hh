@@ -0,0 +1,139 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifndef DUNE_PDELAB_BACKEND_ISTL_MATRIXSTRUCTURE_HH
+#define DUNE_PDELAB_BACKEND_ISTL_MATRIXSTRUCTURE_HH
+
+#include <cstddef>
+#include <vector>
+
+#include <dune/pdelab/backend/istl/matrixhelpers.hh>
+
+namespace Dune {
+  namespace PDELab {
+    namespace istl {
+
+#ifndef DOXYGEN
+
+      // Column indices of a single BCRSMatrix in compressed row storage.
+      class CompressedRowStructure
+      {
+
+      public:
+
+        typedef std::size_t size_type;
+
+        template<typename M>
+        void extract(const M& m)
+        {
+          _rows = m.N();
+          _cols = m.M();
+          _offsets.assign(1,0);
+          _offsets.reserve(m.N() + 1);
+          _columns.clear();
+          _columns.reserve(m.nonzeroes());
+          for (typename M::ConstRowIterator rit = m.begin(); rit != m.end(); ++rit)
+            {
+              for (typename M::ConstColIterator cit = rit->begin(); cit != rit->end(); ++cit)
+                _columns.push_back(cit.index());
+              _offsets.push_back(_columns.size());
+            }
+        }
+
+        template<typename M>
+        void allocate(M& m) const
+        {
+          m.setSize(_rows,_cols,0);
+          m.setBuildMode(M::random);
+          for (size_type i = 0; i < _rows; ++i)
+            m.setrowsize(i,_offsets[i+1] - _offsets[i]);
+          m.endrowsizes();
+          for (size_type i = 0; i < _rows; ++i)
+            m.setIndices(i,_columns.begin() + _offsets[i],_columns.begin() + _offsets[i+1]);
+          m.endindices();
+        }
+
+      private:
+
+        size_type _rows;
+        size_type _cols;
+        std::vector<size_type> _offsets;
+        std::vector<size_type> _columns;
+
+      };
+
+#endif // DOXYGEN
+
+      //! The sparsity structure of a (possibly nested) BCRSMatrix without its entries.
+      /**
+       * MatrixStructure stores the column indices of a BCRSMatrix and, for nested
+       * matrices, recursively those of all its blocks. It can be used to allocate
+       * further matrices with the same structure without having to run the pattern
+       * assembly of the GridOperator again.
+       *
+       * \tparam M  The BCRSMatrix type.
+       */
+      template<typename M, bool nested = requires_pattern<typename M::block_type>::value>
+      class MatrixStructure
+      {
+
+      public:
+
+        //! Extracts the structure of the matrix m.
+        explicit MatrixStructure(const M& m)
+        {
+          _structure.extract(m);
+        }
+
+        //! Sets up the matrix m with the stored structure, the matrix entries are not initialized.
+        void allocate(M& m) const
+        {
+          _structure.allocate(m);
+        }
+
+      private:
+
+        CompressedRowStructure _structure;
+
+      };
+
+#ifndef DOXYGEN
+
+      template<typename M>
+      class MatrixStructure<M,true>
+      {
+
+        typedef MatrixStructure<typename M::block_type> BlockStructure;
+
+      public:
+
+        explicit MatrixStructure(const M& m)
+        {
+          _structure.extract(m);
+          _blocks.reserve(m.nonzeroes());
+          for (typename M::ConstRowIterator rit = m.begin(); rit != m.end(); ++rit)
+            for (typename M::ConstColIterator cit = rit->begin(); cit != rit->end(); ++cit)
+              _blocks.push_back(BlockStructure(*cit));
+        }
+
+        void allocate(M& m) const
+        {
+          _structure.allocate(m);
+          typename std::vector<BlockStructure>::const_iterator bit = _blocks.begin();
+          for (typename M::RowIterator rit = m.begin(); rit != m.end(); ++rit)
+            for (typename M::ColIterator cit = rit->begin(); cit != rit->end(); ++cit, ++bit)
+              bit->allocate(*cit);
+        }
+
+      private:
+
+        CompressedRowStructure _structure;
+        std::vector<BlockStructure> _blocks;
+
+      };
+
+#endif // DOXYGEN
+
+    } // namespace istl
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_BACKEND_ISTL_MATRIXSTRUCTURE_HH
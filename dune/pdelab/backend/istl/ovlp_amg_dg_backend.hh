@@ -1,6 +1,8 @@
 #ifndef DUNE_PDELAB_OVLP_AMG_DG_BACKEND_HH
 #define DUNE_PDELAB_OVLP_AMG_DG_BACKEND_HH
 
+#include <dune/common/shared_ptr.hh>
+
 #include <dune/istl/matrixmatrix.hh>
 
 #include <dune/grid/common/datahandleif.hh>
@@ -8,11 +10,13 @@
 #include <dune/pdelab/backend/istlvectorbackend.hh>
 #include <dune/pdelab/backend/istlmatrixbackend.hh>
 #include <dune/pdelab/backend/ovlpistlsolverbackend.hh>
+#include <dune/pdelab/backend/istl/galerkinproduct.hh>
 #include <dune/pdelab/gridoperator/gridoperator.hh>
 #include <dune/pdelab/localoperator/flags.hh>
 #include <dune/pdelab/localoperator/idefault.hh>
 #include <dune/pdelab/localoperator/pattern.hh>
 #include <dune/pdelab/localoperator/defaultimp.hh>
+#include <dune/pdelab/common/performancetrace.hh>
 
 namespace Dune {
   namespace PDELab {
@@ -447,7 +451,8 @@ template<class DGGO, class DGCC, class CGGFS, class CGCC, class TransferLOP,
          template<class,class,class,int> class DGPrec, template<class> class Solver, int s=96>
 class ISTLBackend_OVLP_AMG_4_DG :
   public Dune::PDELab::OVLPScalarProductImplementation<typename DGGO::Traits::TrialGridFunctionSpace>,
-  public Dune::PDELab::LinearResultStorage
+  public Dune::PDELab::LinearResultStorage,
+  public Dune::PDELab::ReusablePreconditioner
 {
 public:
   // DG grid function space
@@ -471,13 +476,34 @@ public:
   typedef Dune::PDELab::GridOperator<CGGFS,GFS,CGTODGLOP,MBE,field_type,field_type,field_type,CC,CC> PGO;
   typedef typename PGO::Jacobian PMatrix; // wrapped ISTL prolongation matrix
   typedef typename PMatrix::BaseT P;      // ISTL prolongation matrix
-
   // CG subspace matrix
   typedef typename Dune::TransposedMatMultMatResult<P,Matrix>::type PTADG;
   typedef typename Dune::MatMultMatResult<PTADG,P>::type CGMatrix; // istl coarse space matrix
 
+  // parallel AMG on the CG subspace
+  typedef typename Dune::PDELab::istl::CommSelector<s,Dune::MPIHelper::isFake>::type Comm;
+  typedef Dune::OverlappingSchwarzOperator<CGMatrix,CGVector,CGVector,Comm> ParCGOperator;
+  typedef Dune::SeqSSOR<CGMatrix,CGVector,CGVector,1> Smoother;
+  typedef Dune::BlockPreconditioner<CGVector,CGVector,Comm,Smoother> ParSmoother;
+  typedef Dune::Amg::AMG<ParCGOperator,CGVector,ParSmoother,Comm> AMG;
+
 private:
 
+  /** an empty local operator to assemble processor boundary constraints
+   */
+  class EmptyLop : public Dune::PDELab::NumericalJacobianApplyVolume<EmptyLop>,
+                   public Dune::PDELab::FullVolumePattern,
+                   public Dune::PDELab::LocalOperatorDefaultFlags,
+                   public Dune::PDELab::InstationaryLocalOperatorDefaultMethods<double>
+  {
+  };
+
+  // grid operators with empty local operator => matrix data type and constraints assembly
+  typedef Dune::PDELab::GridOperator<CGGFS,CGGFS,EmptyLop,MBE,field_type,field_type,field_type,CGCC,CGCC> CGGO;
+  typedef typename CGGO::Jacobian CGM;
+  typedef Dune::PDELab::GridOperator<GFS,GFS,EmptyLop,MBE,field_type,field_type,field_type,DGCC,DGCC> DGGOEmpty;
+  typedef Dune::PDELab::istl::ParallelHelper<CGGFS> CGHELPER;
+
   const GFS& gfs;
   DGGO& dggo;
   const DGCC& dgcc;
@@ -491,14 +517,16 @@ private:
   PGO pgo;              // grid operator to assemble prolongation matrix
   PMatrix pmatrix;      // wrapped prolongation matrix
 
-  /** an empty local operator to assemble processor boundary constraints
-   */
-  class EmptyLop : public Dune::PDELab::NumericalJacobianApplyVolume<EmptyLop>,
-                   public Dune::PDELab::FullVolumePattern,
-                   public Dune::PDELab::LocalOperatorDefaultFlags,
-                   public Dune::PDELab::InstationaryLocalOperatorDefaultMethods<double>
-  {
-  };
+  // data kept between calls to apply(), set up by the symbolic phase
+  EmptyLop emptylop;
+  shared_ptr<CGGO> cggo;
+  shared_ptr<DGGOEmpty> dggoempty;
+  shared_ptr<CGM> acg;                 // CG subspace matrix
+  Dune::PDELab::istl::GalerkinProduct<P,Matrix,CGMatrix> galerkin_product;
+  shared_ptr<CGHELPER> cghelper;
+  shared_ptr<Comm> oocc;
+  shared_ptr<ParCGOperator> paroop;
+  shared_ptr<AMG> amg;
 
 public:
 
@@ -509,10 +537,15 @@ public:
   }
 
   /** make backend object
+
+      If reuse_ is true, the AMG hierarchy on the CG subspace is only built in the first call
+      to apply() and kept for all following linear systems, see ReusablePreconditioner. The
+      CG subspace matrix itself is recomputed in every call.
    */
   ISTLBackend_OVLP_AMG_4_DG(DGGO& dggo_, const DGCC& dgcc_, CGGFS& cggfs_, const CGCC& cgcc_,
-                            unsigned maxiter_=5000, int verbose_=1, bool usesuperlu_=true) :
+                            unsigned maxiter_=5000, int verbose_=1, bool usesuperlu_=true, bool reuse_=false) :
     Dune::PDELab::OVLPScalarProductImplementation<typename DGGO::Traits::TrialGridFunctionSpace>(dggo_.trialGridFunctionSpace()),
+    Dune::PDELab::ReusablePreconditioner(reuse_),
     gfs(dggo_.trialGridFunctionSpace()), dggo(dggo_), dgcc(dgcc_), cggfs(cggfs_), cgcc(cgcc_), maxiter(maxiter_), verbose(verbose_), usesuperlu(usesuperlu_),
     cgtodglop(), pgo(cggfs,dggo.trialGridFunctionSpace(),cgtodglop), pmatrix(pgo)
   {
@@ -534,6 +567,23 @@ public:
     pgo.jacobian(cgx,pmatrix);
   }
 
+  //! Discards all data kept between calls to apply().
+  /**
+   * The sparsity pattern of the DG matrix is checked in every call to apply(), so this is
+   * only necessary if the CG constraints have changed.
+   */
+  void reset ()
+  {
+    amg.reset();
+    paroop.reset();
+    cghelper.reset();
+    oocc.reset();
+    galerkin_product = Dune::PDELab::istl::GalerkinProduct<P,Matrix,CGMatrix>();
+    acg.reset();
+    dggoempty.reset();
+    cggo.reset();
+  }
+
   /*! \brief solve the given linear system
 
     \param[in] A the given matrix
@@ -549,73 +599,81 @@ public:
     typedef Dune::PDELab::OVLPScalarProduct<GFS,V> PSP;
     PSP psp(*this);
 
-    // compute CG matrix
-    // make grid operator with empty local operator => matrix data type and constraints assembly
-    EmptyLop emptylop;
-    typedef Dune::PDELab::GridOperator<CGGFS,CGGFS,EmptyLop,MBE,field_type,field_type,field_type,CGCC,CGCC> CGGO;
-    CGGO cggo(cggfs,cgcc,cggfs,cgcc,emptylop);
-    typedef typename CGGO::Jacobian CGM;
-
-    // do triple matrix product ACG = P^T ADG P; this is purely local
+    // symbolic phase: structure of ACG = P^T ADG P, grid operators and parallel index set,
+    // only redone if the DG space has a new revision or the size of the DG matrix has changed
     Dune::Timer watch;
     watch.reset();
-    tags::attached_container attached_container;
-    CGM acg(attached_container);
+    if (!galerkin_product.matches(Dune::PDELab::istl::raw(A),gfs.revision()))
+      {
+        PerformanceTrace::Region region("galerkin product setup","solver");
+        reset();
+        cggo = make_shared<CGGO>(cggfs,cgcc,cggfs,cgcc,emptylop);
+        dggoempty = make_shared<DGGOEmpty>(gfs,dgcc,gfs,dgcc,emptylop);
+        tags::attached_container attached_container;
+        acg = make_shared<CGM>(attached_container);
+        galerkin_product.setup(Dune::PDELab::istl::raw(pmatrix),Dune::PDELab::istl::raw(A),Dune::PDELab::istl::raw(*acg),
+                               gfs.revision());
+        oocc = make_shared<Comm>(gfs.gridView().comm());
+        cghelper = make_shared<CGHELPER>(cggfs,2);
+        cghelper->createIndexSetAndProjectForAMG(*acg,*oocc);
+        paroop = make_shared<ParCGOperator>(Dune::PDELab::istl::raw(*acg),*oocc);
+        double symbolic_time = watch.elapsed();
+        if (verbose>0 && gfs.gridView().comm().rank()==0) std::cout << "=== triple matrix product setup " << symbolic_time << " s, "
+                                                                    << galerkin_product.memory() << " bytes" << std::endl;
+        watch.reset();
+      }
+
+    // numeric phase of the triple matrix product; this is purely local
     {
-      PTADG ptadg;
-      Dune::transposeMatMultMat(ptadg,Dune::PDELab::istl::raw(pmatrix),Dune::PDELab::istl::raw(A)); // 1a
-      //Dune::transposeMatMultMat(ptadg,Dune::PDELab::istl::raw(pmatrix),Dune::PDELab::istl::raw(A2));   // 1b
-      Dune::matMultMat(Dune::PDELab::istl::raw(acg),ptadg,Dune::PDELab::istl::raw(pmatrix));
+      PerformanceTrace::Region region("galerkin product","solver");
+      galerkin_product.apply(Dune::PDELab::istl::raw(pmatrix),Dune::PDELab::istl::raw(A),Dune::PDELab::istl::raw(*acg));
     }
     double triple_product_time = watch.elapsed();
     if (verbose>0 && gfs.gridView().comm().rank()==0) std::cout << "=== triple matrix product " << triple_product_time << " s" << std::endl;
-    //Dune::printmatrix(std::cout,Dune::PDELab::istl::raw(acg),"triple product matrix","row",10,2);
+    //Dune::printmatrix(std::cout,Dune::PDELab::istl::raw(*acg),"triple product matrix","row",10,2);
     CGV cgx(cggfs,0.0);     // need vector to call jacobian
-    cggo.jacobian(cgx,acg); // insert trivial rows at processor boundaries
+    cggo->jacobian(cgx,*acg); // insert trivial rows at processor boundaries
     //std::cout << "CG constraints: " << cgcc.size() << " out of " << cggfs.globalSize() << std::endl;
 
     // NOW we need to insert the processor boundary conditions in DG matrix
-    typedef Dune::PDELab::GridOperator<GFS,GFS,EmptyLop,MBE,field_type,field_type,field_type,DGCC,DGCC> DGGOEmpty;
-    DGGOEmpty dggoempty(gfs,dgcc,gfs,dgcc,emptylop);
-    dggoempty.jacobian(z,A);
+    dggoempty->jacobian(z,A);
 
     // and in the residual
     Dune::PDELab::set_constrained_dofs(dgcc,0.0,r);
 
     // now set up parallel AMG solver for the CG subspace
-    typedef typename Dune::PDELab::istl::CommSelector<s,Dune::MPIHelper::isFake>::type Comm;
-    Comm oocc(gfs.gridView().comm());
-    typedef Dune::PDELab::istl::ParallelHelper<CGGFS> CGHELPER;
-    CGHELPER cghelper(cggfs,2);
-    cghelper.createIndexSetAndProjectForAMG(acg,oocc);
-    typedef Dune::OverlappingSchwarzOperator<CGMatrix,CGVector,CGVector,Comm> ParCGOperator;
-    ParCGOperator paroop(Dune::PDELab::istl::raw(acg),oocc);
-    Dune::OverlappingSchwarzScalarProduct<CGVector,Comm> sp(oocc);
-    typedef Dune::Amg::Parameters Parameters; // AMG parameters (might be nice to change from outside)
-    Parameters params(15,2000);
-    params.setDefaultValuesIsotropic(CGGFS::Traits::GridViewType::Traits::Grid::dimension);
-    params.setDebugLevel(verbose);
-    params.setCoarsenTarget(2000);
-    params.setMaxLevel(20);
-    params.setProlongationDampingFactor(1.6);
-    params.setNoPreSmoothSteps(3);
-    params.setNoPostSmoothSteps(3);
-    params.setGamma(1);
-    params.setAdditive(false);
-    //params.setAccumulate(Dune::Amg::AccumulationMode::noAccu); // atOnceAccu results in deadlock
-    typedef Dune::SeqSSOR<CGMatrix,CGVector,CGVector,1> Smoother;
-    typedef Dune::BlockPreconditioner<CGVector,CGVector,Comm,Smoother> ParSmoother;
-    typedef typename Dune::Amg::SmootherTraits<ParSmoother>::Arguments SmootherArgs;
-    SmootherArgs smootherArgs;
-    smootherArgs.iterations = 2;
-    smootherArgs.relaxationFactor = 0.92;
-    typedef Dune::Amg::CoarsenCriterion<Dune::Amg::SymmetricCriterion<CGMatrix,Dune::Amg::FirstDiagonal> > Criterion;
-    Criterion criterion(params);
-    typedef Dune::Amg::AMG<ParCGOperator,CGVector,ParSmoother,Comm> AMG;
-    watch.reset();
-    AMG amg(paroop,criterion,smootherArgs,oocc);
-    double amg_setup_time = watch.elapsed();
-    if (verbose>0 && gfs.gridView().comm().rank()==0) std::cout << "=== AMG setup " <<amg_setup_time << " s" << std::endl;
+    double amg_setup_time = 0.0;
+    if (!amg || !reuse)
+      {
+        typedef Dune::Amg::Parameters Parameters; // AMG parameters (might be nice to change from outside)
+        Parameters params(15,2000);
+        params.setDefaultValuesIsotropic(CGGFS::Traits::GridViewType::Traits::Grid::dimension);
+        params.setDebugLevel(verbose);
+        params.setCoarsenTarget(2000);
+        params.setMaxLevel(20);
+        params.setProlongationDampingFactor(1.6);
+        params.setNoPreSmoothSteps(3);
+        params.setNoPostSmoothSteps(3);
+        params.setGamma(1);
+        params.setAdditive(false);
+        //params.setAccumulate(Dune::Amg::AccumulationMode::noAccu); // atOnceAccu results in deadlock
+        typedef typename Dune::Amg::SmootherTraits<ParSmoother>::Arguments SmootherArgs;
+        SmootherArgs smootherArgs;
+        smootherArgs.iterations = 2;
+        smootherArgs.relaxationFactor = 0.92;
+        typedef Dune::Amg::CoarsenCriterion<Dune::Amg::SymmetricCriterion<CGMatrix,Dune::Amg::FirstDiagonal> > Criterion;
+        Criterion criterion(params);
+        watch.reset();
+        PerformanceTrace::Region setup_region("preconditioner setup","solver");
+        amg.reset();
+        amg = make_shared<AMG>(*paroop,criterion,smootherArgs,*oocc);
+        setup_region.end();
+        amg_setup_time = watch.elapsed();
+        setup_time = amg_setup_time;
+        if (verbose>0 && gfs.gridView().comm().rank()==0) std::cout << "=== AMG setup " <<amg_setup_time << " s" << std::endl;
+      }
+    else if (verbose>0 && gfs.gridView().comm().rank()==0)
+      std::cout << "=== AMG setup skipped (reusing hierarchy)" << std::endl;
 
     // set up hybrid DG/CG preconditioner
     typedef DGPrec<Matrix,Vector,Vector,1> DGPrecType;
@@ -623,18 +681,8 @@ public:
     //DGPrecType dgprec(Dune::PDELab::istl::raw(A),0.92);
     typedef Dune::PDELab::istl::ParallelHelper<GFS> DGHELPER;
     typedef OvlpDGAMGPrec<GFS,Matrix,DGPrecType,DGCC,CGGFS,AMG,CGCC,P,DGHELPER,Comm> HybridPrec;
-    HybridPrec hybridprec(gfs,Dune::PDELab::istl::raw(A),dgprec,dgcc,cggfs,amg,cgcc,Dune::PDELab::istl::raw(pmatrix),
-                          this->parallelHelper(),oocc,3,3);
-
-    // /********/
-    // /* Test */
-    // /********/
-    // Solver<CGVector> testsolver(paroop,sp,amg,1e-8,100,2);
-    // CGV cgxx(cggfs,0.0);
-    // CGV cgdd(cggfs,1.0);
-    // Dune::InverseOperatorResult statstat;
-    // testsolver.apply(Dune::PDELab::istl::raw(cgxx),Dune::PDELab::istl::raw(cgdd),statstat);
-    // /********/
+    HybridPrec hybridprec(gfs,Dune::PDELab::istl::raw(A),dgprec,dgcc,cggfs,*amg,cgcc,Dune::PDELab::istl::raw(pmatrix),
+                          this->parallelHelper(),*oocc,3,3);
 
     // set up solver
     int verb=verbose;
@@ -644,7 +692,9 @@ public:
     // solve
     Dune::InverseOperatorResult stat;
     watch.reset();
+    PerformanceTrace::Region krylov_region("krylov","solver");
     solver.apply(z,r,stat);
+    krylov_region.end();
     double amg_solve_time = watch.elapsed();
     if (verbose>0 && gfs.gridView().comm().rank()==0) std::cout << "=== Hybrid total solve time " << amg_solve_time+amg_setup_time+triple_product_time << " s" << std::endl;
     res.converged  = stat.converged;
@@ -3,10 +3,13 @@
 #ifndef DUNE_PDELAB_BACKEND_ISTL_PARALLELHELPER_HH
 #define DUNE_PDELAB_BACKEND_ISTL_PARALLELHELPER_HH
 
+#include <cstddef>
 #include <limits>
+#include <map>
 
 #include <dune/common/deprecated.hh>
 #include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/shared_ptr.hh>
 #include <dune/common/static_assert.hh>
 #include <dune/common/stdstreams.hh>
 
@@ -23,9 +26,11 @@
 
 #include <dune/pdelab/constraints/common/constraints.hh>
 #include <dune/pdelab/gridfunctionspace/genericdatahandle.hh>
+#include <dune/pdelab/gridfunctionspace/communicationschedule.hh>
 #include <dune/pdelab/backend/istlvectorbackend.hh>
 #include <dune/pdelab/backend/istl/utility.hh>
 #include <dune/pdelab/gridfunctionspace/tags.hh>
+#include <dune/pdelab/common/performancetrace.hh>
 
 namespace Dune {
   namespace PDELab {
@@ -58,12 +63,16 @@ namespace Dune {
 
       public:
 
+        //! Type of the communication schedules used by communicate().
+        typedef GFSCommunicationSchedule<GFS> CommunicationSchedule;
+
         ParallelHelper (const GFS& gfs, int verbose = 1)
           : _gfs(gfs)
           , _rank(gfs.gridView().comm().rank())
           , _ranks(gfs,_rank)
           , _ghosts(gfs,false)
           , _verbose(verbose)
+          , _schedules_revision(gfs.revision())
         {
 
           // Let's try to be clever and reduce the communication overhead by picking the smallest
@@ -89,13 +98,19 @@ namespace Dune {
               //GFSDataHandle<GFS,GhostVector,GhostGatherScatter>
               GhostDataHandle<GFS,GhostVector>
                 gdh(_gfs,_ghosts,false);
-              _gfs.gridView().communicate(gdh,_interiorBorder_all_interface,Dune::ForwardCommunication);
+              {
+                PerformanceTrace::Region region("communication","communication");
+                _gfs.gridView().communicate(gdh,_interiorBorder_all_interface,Dune::ForwardCommunication);
+              }
 
               // create disjoint DOF partitioning
               //            GFSDataHandle<GFS,RankVector,DisjointPartitioningGatherScatter<RankIndex> >
               //  ibdh(_gfs,_ranks,DisjointPartitioningGatherScatter<RankIndex>(_rank));
               DisjointPartitioningDataHandle<GFS,RankVector> pdh(_gfs,_ranks);
-              _gfs.gridView().communicate(pdh,_interiorBorder_all_interface,Dune::ForwardCommunication);
+              {
+                PerformanceTrace::Region region("communication","communication");
+                _gfs.gridView().communicate(pdh,_interiorBorder_all_interface,Dune::ForwardCommunication);
+              }
 
             }
 
@@ -222,6 +237,38 @@ namespace Dune {
 
       public:
 
+        //! Exchanges the DOF data of x over the given interface and combines it using gather_scatter.
+        /**
+         * This has the same effect as communicating the corresponding data handle through
+         * the grid, e.g. communicate(x,InteriorBorder_InteriorBorder_Interface,AddGatherScatter())
+         * replaces communicating an AddDataHandle, but uses a communication schedule that is
+         * built on the first call for each interface and reused afterwards. Use this for
+         * exchanges repeated many times with the same DOF layout, like those in Krylov solvers.
+         */
+        template<typename X, typename GatherScatter>
+        void communicate(X& x, InterfaceType interface, GatherScatter gather_scatter) const
+        {
+          communicationSchedule(interface).communicate(x,gather_scatter);
+        }
+
+        //! Returns the communication schedule for the given interface, building it on first use.
+        /**
+         * The schedules are rebuilt after the revision() of the GridFunctionSpace has changed.
+         * Has to be called collectively on all processes.
+         */
+        const CommunicationSchedule& communicationSchedule(InterfaceType interface) const
+        {
+          if (_schedules_revision != _gfs.revision())
+            {
+              _schedules.clear();
+              _schedules_revision = _gfs.revision();
+            }
+          shared_ptr<CommunicationSchedule>& schedule = _schedules[interface];
+          if (!schedule)
+            schedule = make_shared<CommunicationSchedule>(_gfs,interface);
+          return *schedule;
+        }
+
         //! Returns the MPI rank of this process.
         RankIndex rank() const
         {
@@ -243,12 +290,17 @@ namespace Dune {
          *           of blocking and will not work correctly otherwise. Also note that AMG
          *           will only work correctly for P1 discretisations.
          *
+         * The result only depends on the DOF layout of the GridFunctionSpace, so callers that
+         * solve repeatedly can keep c until the revision() of the space changes.
+         *
          * \param m  The PDELab matrix container.
          * \param c  The parallel information object providing index set, interfaces and
          *           communicators.
+         * \return   The number of communication rounds (grid communications and collective
+         *           operations) performed.
          */
         template<typename MatrixType, typename Comm>
-        void createIndexSetAndProjectForAMG(MatrixType& m, Comm& c);
+        std::size_t createIndexSetAndProjectForAMG(MatrixType& m, Comm& c);
 
       private:
 
@@ -283,13 +335,17 @@ namespace Dune {
 
         //! The actual communication interface used when algorithm requires All_All_Interface.
         InterfaceType _all_all_interface;
+
+        //! Communication schedules used by communicate(), by interface.
+        mutable std::map<InterfaceType,shared_ptr<CommunicationSchedule> > _schedules;
+        mutable std::size_t _schedules_revision;
       };
 
 #if HAVE_MPI
 
       template<typename GFS>
       template<typename M, typename C>
-      void ParallelHelper<GFS>::createIndexSetAndProjectForAMG(M& m, C& c)
+      std::size_t ParallelHelper<GFS>::createIndexSetAndProjectForAMG(M& m, C& c)
       {
 
         const bool is_bcrs_matrix =
@@ -324,6 +380,7 @@ namespace Dune {
 
         // Do we need to communicate at all?
         const bool need_communication = _gfs.gridView().comm().size() > 1;
+        std::size_t rounds = 0;
 
         // First find out which dofs we share with other processors
         typedef typename BackendVectorSelector<GFS,bool>::Type BoolVector;
@@ -332,7 +389,11 @@ namespace Dune {
         if (need_communication)
           {
             SharedDOFDataHandle<GFS,BoolVector> data_handle(_gfs,sharedDOF,false);
-            _gfs.gridView().communicate(data_handle,_all_all_interface,Dune::ForwardCommunication);
+            {
+              PerformanceTrace::Region region("communication","communication");
+              _gfs.gridView().communicate(data_handle,_all_all_interface,Dune::ForwardCommunication);
+            }
+            ++rounds;
           }
 
         // Count shared dofs that we own
@@ -348,6 +409,7 @@ namespace Dune {
         // Communicate per-rank count of owned and shared DOFs to all processes.
         std::vector<GlobalIndex> counts(_gfs.gridView().comm().size());
         _gfs.gridView().comm().allgather(&count, 1, &(counts[0]));
+        ++rounds;
 
         // Compute start index start_p = \sum_{i=0}^{i<p} counts_i
         GlobalIndex start = std::accumulate(counts.begin(),counts.begin() + _rank,GlobalIndex(0));
@@ -366,7 +428,11 @@ namespace Dune {
         if (need_communication)
           {
             MinDataHandle<GFS,GIVector> data_handle(_gfs,scalarIndices);
-            _gfs.gridView().communicate(data_handle,_interiorBorder_all_interface,Dune::ForwardCommunication);
+            {
+              PerformanceTrace::Region region("communication","communication");
+              _gfs.gridView().communicate(data_handle,_interiorBorder_all_interface,Dune::ForwardCommunication);
+            }
+            ++rounds;
           }
 
         // Setup the index set
@@ -402,11 +468,19 @@ namespace Dune {
         if (need_communication)
           {
             GFSNeighborDataHandle<GFS,int> data_handle(_gfs,_rank,neighbors);
-            _gfs.gridView().communicate(data_handle,_all_all_interface,Dune::ForwardCommunication);
+            {
+              PerformanceTrace::Region region("communication","communication");
+              _gfs.gridView().communicate(data_handle,_all_all_interface,Dune::ForwardCommunication);
+            }
+            ++rounds;
           }
 
         c.remoteIndices().setNeighbours(neighbors);
         c.remoteIndices().template rebuild<false>();
+        if (need_communication)
+          ++rounds;
+
+        return rounds;
       }
 
 #endif // HAVE_MPI
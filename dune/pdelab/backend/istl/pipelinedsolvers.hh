@@ -0,0 +1,564 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_BACKEND_ISTL_PIPELINEDSOLVERS_HH
+#define DUNE_PDELAB_BACKEND_ISTL_PIPELINEDSOLVERS_HH
+
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+
+#if HAVE_MPI
+#include <mpi.h>
+#include <dune/common/parallel/mpicollectivecommunication.hh>
+#include <dune/common/parallel/mpitraits.hh>
+#endif
+
+#include <dune/common/parallel/collectivecommunication.hh>
+#include <dune/common/timer.hh>
+
+#include <dune/istl/istlexception.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/scalarproducts.hh>
+#include <dune/istl/solver.hh>
+
+#include <dune/pdelab/common/performancetrace.hh>
+
+namespace Dune {
+  namespace PDELab {
+    namespace istl {
+
+      //! \addtogroup Backend
+      //! \ingroup PDELab
+      //! \{
+
+      //! Sums a few values over all ranks, possibly overlapped with computation.
+      /**
+       * The generic implementation performs a blocking sum in start().  With
+       * MPI 3 the sum is a non-blocking MPI_Iallreduce that is completed in
+       * finish(), so the work in between overlaps with the reduction.
+       *
+       * \tparam Comm The collective communication of the grid view.
+       */
+      template<typename Comm>
+      class GlobalSum
+      {
+      public:
+
+        explicit GlobalSum(const Comm& comm)
+          : _comm(comm)
+        {}
+
+        //! Starts summing values[0],...,values[n-1] in place.
+        template<typename T>
+        void start(T* values, int n)
+        {
+          _comm.sum(values,n);
+        }
+
+        //! Waits until the values passed to start() hold the global sums.
+        void finish()
+        {}
+
+      private:
+        Comm _comm;
+      };
+
+#if HAVE_MPI && MPI_VERSION >= 3
+
+      template<>
+      class GlobalSum<CollectiveCommunication<MPI_Comm> >
+      {
+      public:
+
+        explicit GlobalSum(const CollectiveCommunication<MPI_Comm>& comm)
+          : _comm(comm)
+          , _pending(false)
+        {}
+
+        // a copy never owns the pending request of the original
+        GlobalSum(const GlobalSum& other)
+          : _comm(other._comm)
+          , _pending(false)
+        {}
+
+        ~GlobalSum()
+        {
+          finish();
+        }
+
+        template<typename T>
+        void start(T* values, int n)
+        {
+          finish();
+          MPI_Iallreduce(MPI_IN_PLACE,values,n,MPITraits<T>::getType(),MPI_SUM,_comm,&_request);
+          _pending = true;
+        }
+
+        void finish()
+        {
+          if (!_pending)
+            return;
+          PerformanceTrace::Region region("communication","communication");
+          MPI_Wait(&_request,MPI_STATUS_IGNORE);
+          _pending = false;
+        }
+
+      private:
+
+        GlobalSum& operator=(const GlobalSum&);
+
+        MPI_Comm _comm;
+        MPI_Request _request;
+        bool _pending;
+      };
+
+#endif // HAVE_MPI && MPI_VERSION >= 3
+
+      //! Interface of parallel scalar products that can fuse several global reductions into one.
+      /**
+       * The pipelined Krylov solvers compute all inner products of an iteration
+       * locally, sum them up in a single non-blocking reduction and apply the
+       * operator and the preconditioner while the reduction is in flight.
+       */
+      template<class X>
+      class FusedScalarProduct
+      {
+      public:
+
+        typedef typename X::field_type field_type;
+
+        //! Returns the rank-local contribution to the dot product of x and y.
+        virtual field_type localDot(const X& x, const X& y) = 0;
+
+        //! Starts summing values[0],...,values[n-1] over all ranks in place.
+        virtual void startGlobalSum(field_type* values, int n) = 0;
+
+        //! Waits for the sum started by startGlobalSum().
+        virtual void finishGlobalSum() = 0;
+
+        virtual ~FusedScalarProduct() {}
+      };
+
+#ifndef DOXYGEN
+
+      namespace impl {
+
+        // Collects the inner products of one iteration and reduces them at once.
+        // Scalar products without support for fused reductions are evaluated
+        // one by one.
+        template<class X>
+        class FusedDots
+        {
+        public:
+
+          typedef typename X::field_type field_type;
+
+          explicit FusedDots(ScalarProduct<X>& sp)
+            : _sp(sp)
+            , _fused(dynamic_cast<FusedScalarProduct<X>*>(&sp))
+            , _n(0)
+          {}
+
+          void add(const X& x, const X& y)
+          {
+            if (_n == max_dots)
+              DUNE_THROW(ISTLError,"too many inner products in one reduction");
+            _values[_n++] = _fused ? _fused->localDot(x,y) : _sp.dot(x,y);
+          }
+
+          void start()
+          {
+            if (_fused)
+              _fused->startGlobalSum(_values,_n);
+          }
+
+          const field_type* finish()
+          {
+            if (_fused)
+              _fused->finishGlobalSum();
+            _n = 0;
+            return _values;
+          }
+
+        private:
+
+          static const int max_dots = 8;
+
+          ScalarProduct<X>& _sp;
+          FusedScalarProduct<X>* _fused;
+          int _n;
+          field_type _values[max_dots];
+        };
+
+      } // namespace impl
+
+#endif // DOXYGEN
+
+      //! Pipelined preconditioned conjugate gradient method.
+      /**
+       * Variant of the CG method by Ghysels and Vanroose ("Hiding global
+       * synchronization latency in the preconditioned Conjugate Gradient
+       * algorithm", Parallel Computing 40, 2014).  The three inner products
+       * of an iteration are computed in a single global reduction that
+       * overlaps with one application of the preconditioner and the
+       * operator.  This trades two additional vector updates per iteration
+       * for one latency-bound reduction instead of two.  Due to the
+       * recurrences the computed residual may drift from the true residual
+       * for very small reductions.
+       *
+       * The constructor takes the same arguments as Dune::CGSolver, so the
+       * class can be used wherever the backends take the solver as a
+       * template template parameter.  Fused reductions are used if the scalar
+       * product implements FusedScalarProduct.
+       */
+      template<class X>
+      class PipelinedCGSolver
+        : public InverseOperator<X,X>
+      {
+      public:
+
+        typedef X domain_type;
+        typedef X range_type;
+        typedef typename X::field_type field_type;
+
+        PipelinedCGSolver(LinearOperator<X,X>& op, ScalarProduct<X>& sp, Preconditioner<X,X>& prec,
+                          double reduction, int maxit, int verbose)
+          : _op(op)
+          , _sp(sp)
+          , _prec(prec)
+          , _reduction(reduction)
+          , _maxit(maxit)
+          , _verbose(verbose)
+        {}
+
+        //! Solves A x = b, b is overwritten with the residual.
+        virtual void apply(X& x, X& b, InverseOperatorResult& res)
+        {
+          res.clear();
+          Timer watch;
+          impl::FusedDots<X> dots(_sp);
+
+          _prec.pre(x,b);
+
+          // r = b - A x, computed in place like in the ISTL solvers
+          _op.applyscaleadd(-1.0,x,b);
+          X& r = b;
+
+          X u(x), w(x), m(x), n(x), z(x), q(x), s(x), p(x);
+          u = 0.0;
+          _prec.apply(u,r);
+          _op.apply(u,w);
+
+          if (_verbose > 0)
+            std::cout << "=== PipelinedCGSolver" << std::endl;
+
+          field_type gamma_old(0.0), alpha(0.0);
+          double def0 = 0.0, def = 0.0;
+          int i = 0;
+          for (;; ++i)
+            {
+              // the reduction is hidden behind m = M^{-1} w and n = A m
+              dots.add(r,u);
+              dots.add(w,u);
+              dots.add(r,r);
+              dots.start();
+              m = 0.0;
+              _prec.apply(m,w);
+              _op.apply(m,n);
+              const field_type* values = dots.finish();
+              const field_type gamma = values[0];
+              const field_type delta = values[1];
+              def = std::sqrt(std::abs(static_cast<double>(values[2])));
+
+              if (i == 0)
+                {
+                  def0 = def;
+                  if (_verbose > 1)
+                    std::cout << std::setw(5) << "Iter" << std::setw(16) << "Defect" << std::setw(16) << "Rate" << std::endl
+                              << std::setw(5) << 0 << std::setw(16) << def0 << std::endl;
+                  if (def0 < 1e-30)
+                    {
+                      res.converged = true;
+                      break;
+                    }
+                }
+              else
+                {
+                  if (_verbose > 1)
+                    std::cout << std::setw(5) << i << std::setw(16) << def << std::setw(16) << def/def0 << std::endl;
+                  if (def < def0*_reduction || def < 1e-30)
+                    {
+                      res.converged = true;
+                      break;
+                    }
+                }
+
+              if (i == _maxit)
+                break;
+
+              if (delta == field_type(0.0))
+                DUNE_THROW(ISTLError,"breakdown in pipelined CG - <w,u> = 0");
+
+              if (i == 0)
+                {
+                  alpha = gamma/delta;
+                  z = n;
+                  q = m;
+                  s = w;
+                  p = u;
+                }
+              else
+                {
+                  const field_type beta = gamma/gamma_old;
+                  alpha = gamma/(delta - beta*gamma/alpha);
+                  z *= beta; z += n;
+                  q *= beta; q += m;
+                  s *= beta; s += w;
+                  p *= beta; p += u;
+                }
+
+              x.axpy(alpha,p);
+              r.axpy(-alpha,s);
+              u.axpy(-alpha,q);
+              w.axpy(-alpha,z);
+              gamma_old = gamma;
+            }
+
+          _prec.post(x);
+          finalize(res,i,def0,def,watch.elapsed());
+        }
+
+        //! Solves A x = b with the given reduction, b is overwritten with the residual.
+        virtual void apply(X& x, X& b, double reduction, InverseOperatorResult& res)
+        {
+          const double saved_reduction = _reduction;
+          _reduction = reduction;
+          apply(x,b,res);
+          _reduction = saved_reduction;
+        }
+
+      private:
+
+        void finalize(InverseOperatorResult& res, int i, double def0, double def, double elapsed) const
+        {
+          res.iterations = i;
+          res.reduction = def0 > 0.0 ? def/def0 : 0.0;
+          res.conv_rate = i > 0 ? std::pow(res.reduction,1.0/i) : 0.0;
+          res.elapsed = elapsed;
+          if (_verbose > 0)
+            std::cout << "=== rate=" << res.conv_rate
+                      << ", T=" << res.elapsed
+                      << ", TIT=" << (i > 0 ? res.elapsed/i : 0.0)
+                      << ", IT=" << i << std::endl;
+        }
+
+        LinearOperator<X,X>& _op;
+        ScalarProduct<X>& _sp;
+        Preconditioner<X,X>& _prec;
+        double _reduction;
+        int _maxit;
+        int _verbose;
+      };
+
+      //! Pipelined preconditioned BiCGStab method.
+      /**
+       * Right preconditioned variant of the pipelined BiCGStab method by Cools
+       * and Vanroose ("The communication-hiding pipelined BiCGStab method for
+       * the parallel solution of large unsymmetric linear systems", Parallel
+       * Computing 65, 2017).  The inner products of an iteration are computed
+       * in two global reductions instead of four, each of which overlaps with
+       * one application of the preconditioner and the operator.
+       *
+       * The constructor takes the same arguments as Dune::BiCGSTABSolver.
+       * Fused reductions are used if the scalar product implements
+       * FusedScalarProduct.  Unlike Dune::BiCGSTABSolver, iterations are
+       * counted in full steps.
+       */
+      template<class X>
+      class PipelinedBiCGSTABSolver
+        : public InverseOperator<X,X>
+      {
+      public:
+
+        typedef X domain_type;
+        typedef X range_type;
+        typedef typename X::field_type field_type;
+
+        PipelinedBiCGSTABSolver(LinearOperator<X,X>& op, ScalarProduct<X>& sp, Preconditioner<X,X>& prec,
+                                double reduction, int maxit, int verbose)
+          : _op(op)
+          , _sp(sp)
+          , _prec(prec)
+          , _reduction(reduction)
+          , _maxit(maxit)
+          , _verbose(verbose)
+        {}
+
+        //! Solves A x = b, b is overwritten with the residual.
+        virtual void apply(X& x, X& b, InverseOperatorResult& res)
+        {
+          res.clear();
+          Timer watch;
+          impl::FusedDots<X> dots(_sp);
+
+          _prec.pre(x,b);
+
+          // r = b - A x, computed in place like in the ISTL solvers
+          _op.applyscaleadd(-1.0,x,b);
+          X& r = b;
+
+          // hatted vectors carry the preconditioner applied to their partner:
+          // rh = M^{-1} r, w = A rh, wh = M^{-1} w, t = A wh, s = A p,
+          // sh = M^{-1} s, z = A sh, zh = M^{-1} z, v = A zh
+          X rt(r), rh(x), w(x), wh(x), t(x), p(x), s(x), sh(x), z(x), zh(x), v(x), q(x), qh(x), y(x);
+          rh = 0.0;
+          _prec.apply(rh,r);
+          _op.apply(rh,w);
+
+          dots.add(rt,r);
+          dots.add(rt,w);
+          dots.add(r,r);
+          dots.start();
+          wh = 0.0;
+          _prec.apply(wh,w);
+          _op.apply(wh,t);
+          const field_type* values = dots.finish();
+          field_type rho = values[0];
+          const field_type rtw = values[1];
+          const double def0 = std::sqrt(std::abs(static_cast<double>(values[2])));
+          double def = def0;
+
+          if (_verbose > 0)
+            std::cout << "=== PipelinedBiCGSTABSolver" << std::endl;
+          if (_verbose > 1)
+            std::cout << std::setw(5) << "Iter" << std::setw(16) << "Defect" << std::setw(16) << "Rate" << std::endl
+                      << std::setw(5) << 0 << std::setw(16) << def0 << std::endl;
+
+          int i = 0;
+          if (def0 < 1e-30)
+            res.converged = true;
+          else
+            {
+              if (rtw == field_type(0.0))
+                DUNE_THROW(ISTLError,"breakdown in pipelined BiCGSTAB - <rt,w> = 0");
+
+              field_type alpha = rho/rtw, beta(0.0), omega(0.0);
+              for (i = 1; i <= _maxit; ++i)
+                {
+                  if (i == 1)
+                    {
+                      p = rh;
+                      s = w;
+                      sh = wh;
+                      z = t;
+                    }
+                  else
+                    {
+                      p.axpy(-omega,sh); p *= beta; p += rh;
+                      s.axpy(-omega,z); s *= beta; s += w;
+                      sh.axpy(-omega,zh); sh *= beta; sh += wh;
+                      z.axpy(-omega,v); z *= beta; z += t;
+                    }
+
+                  q = r; q.axpy(-alpha,s);
+                  qh = rh; qh.axpy(-alpha,sh);
+                  y = w; y.axpy(-alpha,z);
+
+                  // first reduction, hidden behind zh = M^{-1} z and v = A zh
+                  dots.add(q,y);
+                  dots.add(y,y);
+                  dots.start();
+                  zh = 0.0;
+                  _prec.apply(zh,z);
+                  _op.apply(zh,v);
+                  values = dots.finish();
+                  const field_type qy = values[0];
+                  const field_type yy = values[1];
+                  if (yy == field_type(0.0))
+                    DUNE_THROW(ISTLError,"breakdown in pipelined BiCGSTAB - <y,y> = 0");
+                  omega = qy/yy;
+
+                  x.axpy(alpha,p);
+                  x.axpy(omega,qh);
+                  r = q; r.axpy(-omega,y);
+                  rh = qh; rh.axpy(-omega,wh); rh.axpy(omega*alpha,zh);
+                  w = y; w.axpy(-omega,t); w.axpy(omega*alpha,v);
+
+                  // second reduction, hidden behind wh = M^{-1} w and t = A wh
+                  dots.add(rt,r);
+                  dots.add(rt,w);
+                  dots.add(rt,s);
+                  dots.add(rt,z);
+                  dots.add(r,r);
+                  dots.start();
+                  wh = 0.0;
+                  _prec.apply(wh,w);
+                  _op.apply(wh,t);
+                  values = dots.finish();
+                  const field_type rho_new = values[0];
+                  const field_type rtw_new = values[1];
+                  const field_type rts = values[2];
+                  const field_type rtz = values[3];
+                  def = std::sqrt(std::abs(static_cast<double>(values[4])));
+
+                  if (_verbose > 1)
+                    std::cout << std::setw(5) << i << std::setw(16) << def << std::setw(16) << def/def0 << std::endl;
+                  if (def < def0*_reduction || def < 1e-30)
+                    {
+                      res.converged = true;
+                      break;
+                    }
+
+                  if (omega == field_type(0.0) || rho == field_type(0.0))
+                    DUNE_THROW(ISTLError,"breakdown in pipelined BiCGSTAB - omega or rho = 0");
+                  beta = (alpha/omega)*(rho_new/rho);
+                  rho = rho_new;
+                  const field_type denominator = rtw_new + beta*rts - beta*omega*rtz;
+                  if (denominator == field_type(0.0))
+                    DUNE_THROW(ISTLError,"breakdown in pipelined BiCGSTAB - <rt,s> = 0");
+                  alpha = rho/denominator;
+                }
+              if (i > _maxit)
+                i = _maxit;
+            }
+
+          _prec.post(x);
+          res.iterations = i;
+          res.reduction = def0 > 0.0 ? def/def0 : 0.0;
+          res.conv_rate = i > 0 ? std::pow(res.reduction,1.0/i) : 0.0;
+          res.elapsed = watch.elapsed();
+          if (_verbose > 0)
+            std::cout << "=== rate=" << res.conv_rate
+                      << ", T=" << res.elapsed
+                      << ", TIT=" << (i > 0 ? res.elapsed/i : 0.0)
+                      << ", IT=" << i << std::endl;
+        }
+
+        //! Solves A x = b with the given reduction, b is overwritten with the residual.
+        virtual void apply(X& x, X& b, double reduction, InverseOperatorResult& res)
+        {
+          const double saved_reduction = _reduction;
+          _reduction = reduction;
+          apply(x,b,res);
+          _reduction = saved_reduction;
+        }
+
+      private:
+
+        LinearOperator<X,X>& _op;
+        ScalarProduct<X>& _sp;
+        Preconditioner<X,X>& _prec;
+        double _reduction;
+        int _maxit;
+        int _verbose;
+      };
+
+      //! \} group Backend
+
+    } // namespace istl
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_BACKEND_ISTL_PIPELINEDSOLVERS_HH
@@ -9,6 +9,7 @@
 #include <dune/pdelab/backend/istlmatrixbackend.hh>
 #include <dune/pdelab/backend/ovlpistlsolverbackend.hh>
 #include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/common/performancetrace.hh>
 
 namespace Dune {
   namespace PDELab {
@@ -257,7 +258,9 @@ namespace Dune {
         Criterion criterion(params);
         typedef Dune::Amg::AMG<CGOperator,CGVector,Smoother> AMG;
         watch.reset();
+        PerformanceTrace::Region setup_region("preconditioner setup","solver");
         AMG amg(cgop,criterion,smootherArgs);
+        setup_region.end();
         double amg_setup_time = watch.elapsed();
         if (verbose>0) std::cout << "=== AMG setup " <<amg_setup_time << " s" << std::endl;
 
@@ -273,7 +276,9 @@ namespace Dune {
         // solve
         Dune::InverseOperatorResult stat;
         watch.reset();
+        PerformanceTrace::Region krylov_region("krylov","solver");
         solver.apply(Dune::PDELab::istl::raw(z),Dune::PDELab::istl::raw(r),stat);
+        krylov_region.end();
         double amg_solve_time = watch.elapsed();
         if (verbose>0) std::cout << "=== Hybrid total solve time " << amg_solve_time+amg_setup_time+triple_product_time << " s" << std::endl;
         res.converged  = stat.converged;
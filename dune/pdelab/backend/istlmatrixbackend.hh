@@ -7,6 +7,8 @@
 #include <dune/pdelab/backend/common/uncachedmatrixview.hh>
 #include <dune/pdelab/backend/istl/matrixhelpers.hh>
 #include <dune/pdelab/backend/istl/descriptors.hh>
+#include <dune/pdelab/backend/istl/matrixstructure.hh>
+#include <dune/pdelab/gridoperator/common/matrixstructurecache.hh>
 
 namespace Dune {
   namespace PDELab {
@@ -88,11 +90,18 @@ namespace Dune {
 #endif // HAVE_TEMPLATE_ALIASES
 
 
+      /** \brief Construct matrix container with the occupation pattern of a GridOperator
+       *
+       * The occupation pattern is only assembled for the first matrix created for a given
+       * GridOperator, further matrices copy the structure stored in the
+       * GridOperator's MatrixStructureCache, as long as the function spaces have not been
+       * updated in between.
+       */
       template<typename GO>
       ISTLMatrixContainer (const GO& go)
         : _container(make_shared<Container>())
       {
-        _stats = go.matrixBackend().buildPattern(go,*this);
+        allocate(go);
       }
 
       /** \brief Construct matrix container using an externally given matrix as storage
@@ -102,20 +111,20 @@ namespace Dune {
        * \param go GridOperator object used to assemble into the matrix
        * \param container ISTL matrix type that stores the actual data
        *
-       * This ISTLMatrixContainer constructor will reassemble the matrix occupation pattern.
+       * This ISTLMatrixContainer constructor will reinitialize the matrix occupation pattern.
        */
       template<typename GO>
       ISTLMatrixContainer (const GO& go, Container& container)
         : _container(Dune::stackobject_to_shared_ptr(container))
       {
-        _stats = go.matrixBackend().buildPattern(go,*this);
+        allocate(go);
       }
 
       template<typename GO>
       ISTLMatrixContainer (const GO& go, const E& e)
         : _container(make_shared<Container>())
       {
-        _stats = go.matrixBackend().buildPattern(go,*this);
+        allocate(go);
         (*_container) = e;
       }
 
@@ -253,6 +262,38 @@ namespace Dune {
 
     private:
 
+      //! Matrix structure and pattern statistics stored in the MatrixStructureCache of a GridOperator.
+      struct CachedStructure
+      {
+
+        CachedStructure(const Container& container, const std::vector<PatternStatistics>& stats_)
+          : structure(container)
+          , stats(stats_)
+        {}
+
+        istl::MatrixStructure<Container> structure;
+        std::vector<PatternStatistics> stats;
+
+      };
+
+      template<typename GO>
+      void allocate(const GO& go)
+      {
+        MatrixStructureCache& cache = go.matrixStructureCache();
+        shared_ptr<const CachedStructure> cached = cache.template get<CachedStructure>();
+        if (cached)
+          {
+            cached->structure.allocate(*_container);
+            _stats = cached->stats;
+          }
+        else
+          {
+            _stats = go.matrixBackend().buildPattern(go,*this);
+            if (cache.enabled())
+              cache.set(shared_ptr<const CachedStructure>(make_shared<CachedStructure>(*_container,_stats)));
+          }
+      }
+
       shared_ptr<Container> _container;
       std::vector<PatternStatistics> _stats;
 
@@ -28,7 +28,9 @@
 #include <dune/pdelab/backend/istlmatrixbackend.hh>
 #include <dune/pdelab/backend/istl/blockmatrixdiagonal.hh>
 #include <dune/pdelab/backend/istl/parallelhelper.hh>
+#include <dune/pdelab/backend/istl/pipelinedsolvers.hh>
 #include <dune/pdelab/backend/seqistlsolverbackend.hh>
+#include <dune/pdelab/common/performancetrace.hh>
 
 namespace Dune {
   namespace PDELab {
@@ -79,7 +81,16 @@ namespace Dune {
        *       destruct the constructed object.
        */
       NonoverlappingOperator (const GFS& gfs_, const M& A)
-        : gfs(gfs_), _A_(A)
+        : gfs(gfs_), _A_(A), helper(0)
+      { }
+
+      //! Construct a non-overlapping operator communicating through the schedules of a parallel helper
+      /**
+       * The consistency exchange in apply() and applyscaleadd() reuses the communication
+       * schedule cached by helper_ instead of communicating a data handle through the grid.
+       */
+      NonoverlappingOperator (const GFS& gfs_, const M& A, const istl::ParallelHelper<GFS>& helper_)
+        : gfs(gfs_), _A_(A), helper(&helper_)
       { }
 
       //! apply operator
@@ -94,9 +105,7 @@ namespace Dune {
         istl::raw(_A_).mv(istl::raw(x),istl::raw(y));
 
         // accumulate y on border
-        Dune::PDELab::AddDataHandle<GFS,Y> adddh(gfs,y);
-        if (gfs.gridView().comm().size()>1)
-          gfs.gridView().communicate(adddh,Dune::InteriorBorder_InteriorBorder_Interface,Dune::ForwardCommunication);
+        make_consistent(y);
       }
 
       //! apply operator to x, scale and add:  \f$ y = y + \alpha A(x) \f$
@@ -111,9 +120,7 @@ namespace Dune {
         istl::raw(_A_).usmv(alpha,istl::raw(x),istl::raw(y));
 
         // accumulate y on border
-        Dune::PDELab::AddDataHandle<GFS,Y> adddh(gfs,y);
-        if (gfs.gridView().comm().size()>1)
-          gfs.gridView().communicate(adddh,Dune::InteriorBorder_InteriorBorder_Interface,Dune::ForwardCommunication);
+        make_consistent(y);
       }
 
       //! extract the matrix
@@ -123,14 +130,35 @@ namespace Dune {
       }
 
     private:
+
+      void make_consistent (Y& y) const
+      {
+        if (gfs.gridView().comm().size()>1)
+          {
+            PerformanceTrace::Region region("communication","communication");
+            if (helper)
+              helper->communicate(y,Dune::InteriorBorder_InteriorBorder_Interface,AddGatherScatter());
+            else
+              {
+                Dune::PDELab::AddDataHandle<GFS,Y> adddh(gfs,y);
+                gfs.gridView().communicate(adddh,Dune::InteriorBorder_InteriorBorder_Interface,Dune::ForwardCommunication);
+              }
+          }
+      }
+
       const GFS& gfs;
       const M& _A_;
+      const istl::ParallelHelper<GFS>* helper;
     };
 
     // parallel scalar product assuming no overlap
     template<class GFS, class X>
-    class NonoverlappingScalarProduct : public Dune::ScalarProduct<X>
+    class NonoverlappingScalarProduct
+      : public Dune::ScalarProduct<X>
+      , public istl::FusedScalarProduct<X>
     {
+      typedef typename GFS::Traits::GridViewType::CollectiveCommunication CollectiveCommunication;
+
     public:
       //! export types
       typedef X domain_type;
@@ -142,7 +170,7 @@ namespace Dune {
       /*! \brief Constructor needs to know the grid function space
        */
       NonoverlappingScalarProduct (const GFS& gfs_, const istl::ParallelHelper<GFS>& helper_)
-        : gfs(gfs_), helper(helper_)
+        : gfs(gfs_), helper(helper_), global_sum(gfs_.gridView().comm())
       {}
 
       /*! \brief Dot product of two vectors.
@@ -166,18 +194,39 @@ namespace Dune {
         return sqrt(static_cast<double>(this->dot(x,x)));
       }
 
+      //! Local dot product on the unique partition, without communication.
+      virtual field_type localDot (const X& x, const X& y)
+      {
+        return helper.disjointDot(x,y);
+      }
+
+      //! Starts the global sum of several local dot products.
+      virtual void startGlobalSum (field_type* values, int n)
+      {
+        global_sum.start(values,n);
+      }
+
+      //! Completes the global sum started by startGlobalSum().
+      virtual void finishGlobalSum ()
+      {
+        global_sum.finish();
+      }
+
       /*! \brief make additive vector consistent
        */
       void make_consistent (X& x) const
       {
-        Dune::PDELab::AddDataHandle<GFS,X> adddh(gfs,x);
         if (gfs.gridView().comm().size()>1)
-          gfs.gridView().communicate(adddh,Dune::InteriorBorder_InteriorBorder_Interface,Dune::ForwardCommunication);
+          {
+            PerformanceTrace::Region region("communication","communication");
+            helper.communicate(x,Dune::InteriorBorder_InteriorBorder_Interface,AddGatherScatter());
+          }
       }
 
     private:
       const GFS& gfs;
       const istl::ParallelHelper<GFS>& helper;
+      istl::GlobalSum<CollectiveCommunication> global_sum;
     };
 
     // parallel Richardson preconditioner
@@ -288,9 +337,12 @@ namespace Dune {
       {
         // make the diagonal consistent...
         typename istl::BlockMatrixDiagonal<A>::template AddMatrixElementVectorDataHandle<GFS> addDH(gfs, _inverse_diagonal);
-        gfs.gridView().communicate(addDH,
-                                   InteriorBorder_InteriorBorder_Interface,
-                                   ForwardCommunication);
+        {
+          PerformanceTrace::Region region("communication","communication");
+          gfs.gridView().communicate(addDH,
+                                     InteriorBorder_InteriorBorder_Interface,
+                                     ForwardCommunication);
+        }
 
         // ... and then invert it
         _inverse_diagonal.invert();
@@ -362,7 +414,7 @@ namespace Dune {
       void apply(M& A, V& z, W& r, typename V::ElementType reduction)
       {
         typedef Dune::PDELab::NonoverlappingOperator<GFS,M,V,W> POP;
-        POP pop(gfs,A);
+        POP pop(gfs,A,phelper);
         typedef Dune::PDELab::NonoverlappingScalarProduct<GFS,V> PSP;
         PSP psp(gfs,phelper);
         typedef Dune::PDELab::NonoverlappingRichardson<GFS,V,W> PRICH;
@@ -371,7 +423,9 @@ namespace Dune {
         if (gfs.gridView().comm().rank()==0) verb=verbose;
         Dune::CGSolver<V> solver(pop,psp,prich,reduction,maxiter,verb);
         Dune::InverseOperatorResult stat;
+        PerformanceTrace::Region krylov_region("krylov","solver");
         solver.apply(z,r,stat);
+        krylov_region.end();
         res.converged  = stat.converged;
         res.iterations = stat.iterations;
         res.elapsed    = stat.elapsed;
@@ -451,7 +505,7 @@ namespace Dune {
       void apply(M& A, V& z, W& r, typename V::ElementType reduction)
       {
         typedef NonoverlappingOperator<GFS,M,V,W> POP;
-        POP pop(gfs,A);
+        POP pop(gfs,A,phelper);
         typedef NonoverlappingScalarProduct<GFS,V> PSP;
         PSP psp(gfs,phelper);
 
@@ -462,7 +516,9 @@ namespace Dune {
         if (gfs.gridView().comm().rank()==0) verb=verbose;
         CGSolver<V> solver(pop,psp,ppre,reduction,maxiter,verb);
         InverseOperatorResult stat;
+        PerformanceTrace::Region krylov_region("krylov","solver");
         solver.apply(z,r,stat);
+        krylov_region.end();
         res.converged  = stat.converged;
         res.iterations = stat.iterations;
         res.elapsed    = stat.elapsed;
@@ -517,7 +573,7 @@ namespace Dune {
       void apply(M& A, V& z, W& r, typename V::ElementType reduction)
       {
         typedef Dune::PDELab::NonoverlappingOperator<GFS,M,V,W> POP;
-        POP pop(gfs,A);
+        POP pop(gfs,A,phelper);
         typedef Dune::PDELab::NonoverlappingScalarProduct<GFS,V> PSP;
         PSP psp(gfs,phelper);
         typedef Dune::PDELab::NonoverlappingRichardson<GFS,V,W> PRICH;
@@ -526,7 +582,9 @@ namespace Dune {
         if (gfs.gridView().comm().rank()==0) verb=verbose;
         Dune::BiCGSTABSolver<V> solver(pop,psp,prich,reduction,maxiter,verb);
         Dune::InverseOperatorResult stat;
+        PerformanceTrace::Region krylov_region("krylov","solver");
         solver.apply(z,r,stat);
+        krylov_region.end();
         res.converged  = stat.converged;
         res.iterations = stat.iterations;
         res.elapsed    = stat.elapsed;
@@ -591,7 +649,7 @@ namespace Dune {
       void apply(M& A, V& z, W& r, typename V::ElementType reduction)
       {
         typedef Dune::PDELab::NonoverlappingOperator<GFS,M,V,W> POP;
-        POP pop(gfs,A);
+        POP pop(gfs,A,phelper);
         typedef Dune::PDELab::NonoverlappingScalarProduct<GFS,V> PSP;
         PSP psp(gfs,phelper);
 
@@ -602,7 +660,91 @@ namespace Dune {
         if (gfs.gridView().comm().rank()==0) verb=verbose;
         Dune::BiCGSTABSolver<V> solver(pop,psp,ppre,reduction,maxiter,verb);
         Dune::InverseOperatorResult stat;
+        PerformanceTrace::Region krylov_region("krylov","solver");
+        solver.apply(z,r,stat);
+        krylov_region.end();
+        res.converged  = stat.converged;
+        res.iterations = stat.iterations;
+        res.elapsed    = stat.elapsed;
+        res.reduction  = stat.reduction;
+        res.conv_rate  = stat.conv_rate;
+      }
+
+      /*! \brief Return access to result data */
+      const Dune::PDELab::LinearSolverResult<double>& result() const
+      {
+        return res;
+      }
+
+    private:
+      const GFS& gfs;
+      PHELPER phelper;
+      Dune::PDELab::LinearSolverResult<double> res;
+      unsigned maxiter;
+      int verbose;
+    };
+
+    //! \brief Base class for nonoverlapping parallel solvers with Jacobi preconditioner
+    /**
+     * \tparam GFS    The GridFunctionSpace.
+     * \tparam Solver The ISTL-style inverse operator, taking the vector type
+     *                as its only template parameter.
+     */
+    template<class GFS, template<class> class Solver>
+    class ISTLBackend_NOVLP_Jacobi_Base
+    {
+      typedef istl::ParallelHelper<GFS> PHELPER;
+
+    public:
+      /*! \brief make a linear solver object
+
+        \param[in] gfs_ a grid function space
+        \param[in] maxiter_ maximum number of iterations to do
+        \param[in] verbose_ print messages if true
+      */
+      explicit ISTLBackend_NOVLP_Jacobi_Base (const GFS& gfs_, unsigned maxiter_=5000, int verbose_=1)
+        : gfs(gfs_), phelper(gfs,verbose_), maxiter(maxiter_), verbose(verbose_)
+      {}
+
+      /*! \brief compute global norm of a vector
+
+        \param[in] v the given vector
+      */
+      template<class V>
+      typename V::ElementType norm (const V& v) const
+      {
+        V x(v); // make a copy because it has to be made consistent
+        typedef Dune::PDELab::NonoverlappingScalarProduct<GFS,V> PSP;
+        PSP psp(gfs,phelper);
+        psp.make_consistent(x);
+        return psp.norm(x);
+      }
+
+      /*! \brief solve the given linear system
+
+        \param[in] A the given matrix
+        \param[out] z the solution vector to be computed
+        \param[in] r right hand side
+        \param[in] reduction to be achieved
+      */
+      template<class M, class V, class W>
+      void apply(M& A, V& z, W& r, typename V::ElementType reduction)
+      {
+        typedef Dune::PDELab::NonoverlappingOperator<GFS,M,V,W> POP;
+        POP pop(gfs,A,phelper);
+        typedef Dune::PDELab::NonoverlappingScalarProduct<GFS,V> PSP;
+        PSP psp(gfs,phelper);
+
+        typedef NonoverlappingJacobi<M,V,W> PPre;
+        PPre ppre(gfs,A);
+
+        int verb=0;
+        if (gfs.gridView().comm().rank()==0) verb=verbose;
+        Solver<V> solver(pop,psp,ppre,reduction,maxiter,verb);
+        Dune::InverseOperatorResult stat;
+        PerformanceTrace::Region krylov_region("krylov","solver");
         solver.apply(z,r,stat);
+        krylov_region.end();
         res.converged  = stat.converged;
         res.iterations = stat.iterations;
         res.elapsed    = stat.elapsed;
@@ -624,24 +766,74 @@ namespace Dune {
       int verbose;
     };
 
+    //! \brief Nonoverlapping parallel pipelined CG solver with Jacobi preconditioner
+    /**
+     * The three dot products of an iteration are combined into a single
+     * global reduction that is overlapped with the preconditioner and the
+     * matrix-vector product.
+     */
+    template<class GFS>
+    class ISTLBackend_NOVLP_PipelinedCG_Jacobi
+      : public ISTLBackend_NOVLP_Jacobi_Base<GFS,istl::PipelinedCGSolver>
+    {
+    public:
+      /*! \brief make a linear solver object
+
+        \param[in] gfs a grid function space
+        \param[in] maxiter maximum number of iterations to do
+        \param[in] verbose print messages if true
+      */
+      explicit ISTLBackend_NOVLP_PipelinedCG_Jacobi (const GFS& gfs, unsigned maxiter=5000, int verbose=1)
+        : ISTLBackend_NOVLP_Jacobi_Base<GFS,istl::PipelinedCGSolver>(gfs,maxiter,verbose)
+      {}
+    };
+
+    //! \brief Nonoverlapping parallel pipelined BiCGStab solver with Jacobi preconditioner
+    /**
+     * Needs two global reductions per iteration instead of the four of
+     * ISTLBackend_NOVLP_BCGS_Jacobi, both overlapped with computation.
+     */
+    template<class GFS>
+    class ISTLBackend_NOVLP_PipelinedBCGS_Jacobi
+      : public ISTLBackend_NOVLP_Jacobi_Base<GFS,istl::PipelinedBiCGSTABSolver>
+    {
+    public:
+      /*! \brief make a linear solver object
+
+        \param[in] gfs a grid function space
+        \param[in] maxiter maximum number of iterations to do
+        \param[in] verbose print messages if true
+      */
+      explicit ISTLBackend_NOVLP_PipelinedBCGS_Jacobi (const GFS& gfs, unsigned maxiter=5000, int verbose=1)
+        : ISTLBackend_NOVLP_Jacobi_Base<GFS,istl::PipelinedBiCGSTABSolver>(gfs,maxiter,verbose)
+      {}
+    };
+
     //! Solver to be used for explicit time-steppers with (block-)diagonal mass matrix
+    /**
+     * If reuse is enabled, the inverted diagonal of the matrix is computed
+     * once and used for all following solves.
+     */
     template<typename GFS>
     class ISTLBackend_NOVLP_ExplicitDiagonal
+      : public ReusablePreconditioner
     {
       typedef istl::ParallelHelper<GFS> PHELPER;
 
       const GFS& gfs;
       PHELPER phelper;
       Dune::PDELab::LinearSolverResult<double> res;
+      istl::InverseBlockDiagonalCache inverse;
 
     public:
       /*! \brief make a linear solver object
 
         \param[in] gfs_ GridFunctionSpace, used to identify DoFs for parallel
         communication
+        \param[in] reuse_ keep the inverted diagonal between calls to apply()
       */
-      explicit ISTLBackend_NOVLP_ExplicitDiagonal(const GFS& gfs_)
-        : gfs(gfs_), phelper(gfs)
+      explicit ISTLBackend_NOVLP_ExplicitDiagonal(const GFS& gfs_, bool reuse_=false)
+        : ReusablePreconditioner(reuse_), gfs(gfs_), phelper(gfs)
       {}
 
       /*! \brief compute global norm of a vector
@@ -668,14 +860,25 @@ namespace Dune {
       template<class M, class V, class W>
       void apply(M& A, V& z, W& r, typename W::ElementType reduction)
       {
-        Dune::SeqJac<M,V,W> jac(A,1,1.0);
-        jac.pre(z,r);
-        jac.apply(z,r);
-        jac.post(z);
+        if (reuse)
+          {
+            Timer watch;
+            if (inverse.update(A,true))
+              setup_time = watch.elapsed();
+            inverse.mv<M>(r,z);
+          }
+        else
+          {
+            inverse.reset();
+            Dune::SeqJac<M,V,W> jac(A,1,1.0);
+            jac.pre(z,r);
+            jac.apply(z,r);
+            jac.post(z);
+          }
         if (gfs.gridView().comm().size()>1)
         {
-          Dune::PDELab::AddDataHandle<GFS,V> adddh(gfs,z);
-          gfs.gridView().communicate(adddh,Dune::InteriorBorder_InteriorBorder_Interface,Dune::ForwardCommunication);
+          PerformanceTrace::Region region("communication","communication");
+          phelper.communicate(z,Dune::InteriorBorder_InteriorBorder_Interface,AddGatherScatter());
         }
         res.converged  = true;
         res.iterations = 1;
@@ -772,13 +975,13 @@ namespace Dune {
         Dune::InverseOperatorResult stat;
         //make r consistent
         if (gfs.gridView().comm().size()>1){
-          Dune::PDELab::AddDataHandle<GFS,V> adddh(gfs,r);
-          gfs.gridView().communicate(adddh,
-                                     Dune::InteriorBorder_InteriorBorder_Interface,
-                                     Dune::ForwardCommunication);
+          PerformanceTrace::Region region("communication","communication");
+          phelper.communicate(r,Dune::InteriorBorder_InteriorBorder_Interface,AddGatherScatter());
         }
 
+        PerformanceTrace::Region krylov_region("krylov","solver");
         solver.apply(z,r,stat);
+        krylov_region.end();
         res.converged  = stat.converged;
         res.iterations = stat.iterations;
         res.elapsed    = stat.elapsed;
@@ -861,7 +1064,7 @@ namespace Dune {
 
     template<class GO,int s, template<class,class,class,int> class Preconditioner,
              template<class> class Solver>
-    class ISTLBackend_AMG_NOVLP : public LinearResultStorage
+    class ISTLBackend_AMG_NOVLP : public LinearResultStorage, public ReusablePreconditioner
     {
       typedef typename GO::Traits::TrialGridFunctionSpace GFS;
       typedef typename istl::ParallelHelper<GFS> PHELPER;
@@ -886,13 +1089,13 @@ namespace Dune {
       ISTLBackend_AMG_NOVLP(const GO& grid_operator, unsigned maxiter_=5000,
                             int verbose_=1, bool reuse_=false,
                             bool usesuperlu_=true)
-        : _grid_operator(grid_operator)
+        : ReusablePreconditioner(reuse_)
+        , _grid_operator(grid_operator)
         , gfs(grid_operator.trialGridFunctionSpace())
         , phelper(gfs,verbose_)
         , maxiter(maxiter_)
         , params(15,2000,1.2,1.6,Dune::Amg::atOnceAccu)
         , verbose(verbose_)
-        , reuse(reuse_)
         , firstapply(true)
         , usesuperlu(usesuperlu_)
       {
@@ -977,24 +1180,26 @@ namespace Dune {
         if (gfs.gridView().comm().rank()==0) verb=verbose;
         //only construct a new AMG if the matrix changes
         if (reuse==false || firstapply==true){
+          PerformanceTrace::Region setup_region("preconditioner setup","solver");
           amg.reset(new AMG(oop, criterion, smootherArgs, oocc));
           firstapply = false;
           stats.tsetup = watch.elapsed();
           stats.levels = amg->maxlevels();
           stats.directCoarseLevelSolver=amg->usesDirectCoarseLevelSolver();
+          setup_time = stats.tsetup;
         }
 
         Dune::InverseOperatorResult stat;
         // make r consistent
         if (gfs.gridView().comm().size()>1) {
-          Dune::PDELab::AddDataHandle<GFS,V> adddh(gfs,r);
-          gfs.gridView().communicate(adddh,
-                                     Dune::InteriorBorder_InteriorBorder_Interface,
-                                     Dune::ForwardCommunication);
+          PerformanceTrace::Region region("communication","communication");
+          phelper.communicate(r,Dune::InteriorBorder_InteriorBorder_Interface,AddGatherScatter());
         }
         watch.reset();
         Solver<VectorType> solver(oop,sp,*amg,reduction,maxiter,verb);
+        PerformanceTrace::Region krylov_region("krylov","solver");
         solver.apply(istl::raw(z),istl::raw(r),stat);
+        krylov_region.end();
         stats.tsolve= watch.elapsed();
         res.converged  = stat.converged;
         res.iterations = stat.iterations;
@@ -1019,7 +1224,6 @@ namespace Dune {
       unsigned maxiter;
       Parameters params;
       int verbose;
-      bool reuse;
       bool firstapply;
       bool usesuperlu;
       Dune::shared_ptr<AMG> amg;
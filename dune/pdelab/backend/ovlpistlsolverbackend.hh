@@ -5,6 +5,7 @@
 
 #include <dune/common/deprecated.hh>
 #include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/shared_ptr.hh>
 
 #include <dune/istl/owneroverlapcopy.hh>
 #include <dune/istl/solvercategory.hh>
@@ -21,8 +22,11 @@
 #include <dune/pdelab/gridfunctionspace/genericdatahandle.hh>
 #include <dune/pdelab/backend/istlvectorbackend.hh>
 #include <dune/pdelab/backend/istlmatrixbackend.hh>
+#include <dune/pdelab/backend/istl/blockmatrixdiagonal.hh>
 #include <dune/pdelab/backend/istl/parallelhelper.hh>
+#include <dune/pdelab/backend/istl/pipelinedsolvers.hh>
 #include <dune/pdelab/backend/seqistlsolverbackend.hh>
+#include <dune/pdelab/common/performancetrace.hh>
 
 namespace Dune {
   namespace PDELab {
@@ -85,7 +89,10 @@ namespace Dune {
     template<class GFS, class X>
     class OverlappingScalarProduct
       : public Dune::ScalarProduct<X>
+      , public istl::FusedScalarProduct<X>
     {
+      typedef typename GFS::Traits::GridViewType::CollectiveCommunication CollectiveCommunication;
+
     public:
       //! export types
       typedef X domain_type;
@@ -97,7 +104,7 @@ namespace Dune {
       /*! \brief Constructor needs to know the grid function space
        */
       OverlappingScalarProduct (const GFS& gfs_, const istl::ParallelHelper<GFS>& helper_)
-        : gfs(gfs_), helper(helper_)
+        : gfs(gfs_), helper(helper_), global_sum(gfs_.gridView().comm())
       {}
 
 
@@ -122,9 +129,28 @@ namespace Dune {
         return sqrt(static_cast<double>(this->dot(x,x)));
       }
 
+      //! Local dot product on the unique partition, without communication.
+      virtual field_type localDot (const X& x, const X& y)
+      {
+        return helper.disjointDot(x,y);
+      }
+
+      //! Starts the global sum of several local dot products.
+      virtual void startGlobalSum (field_type* values, int n)
+      {
+        global_sum.start(values,n);
+      }
+
+      //! Completes the global sum started by startGlobalSum().
+      virtual void finishGlobalSum ()
+      {
+        global_sum.finish();
+      }
+
     private:
       const GFS& gfs;
       const istl::ParallelHelper<GFS>& helper;
+      istl::GlobalSum<CollectiveCommunication> global_sum;
     };
 
     // wrapped sequential preconditioner
@@ -169,9 +195,11 @@ namespace Dune {
         range_type dd(d);
         set_constrained_dofs(cc,0.0,dd);
         prec.apply(istl::raw(v),istl::raw(dd));
-        Dune::PDELab::AddDataHandle<GFS,domain_type> adddh(gfs,v);
         if (gfs.gridView().comm().size()>1)
-          gfs.gridView().communicate(adddh,Dune::All_All_Interface,Dune::ForwardCommunication);
+          {
+            PerformanceTrace::Region region("communication","communication");
+            helper.communicate(v,Dune::All_All_Interface,AddGatherScatter());
+          }
       }
 
       /*!
@@ -234,11 +262,16 @@ namespace Dune {
       {
         Dune::InverseOperatorResult stat;
         Y b(d); // need copy, since solver overwrites right hand side
+        PerformanceTrace::Region subdomain_region("subdomain solve","solver");
         solver.apply(istl::raw(v),istl::raw(b),stat);
+        subdomain_region.end();
         if (gfs.gridView().comm().size()>1)
           {
             AddDataHandle<GFS,X> adddh(gfs,v);
-            gfs.gridView().communicate(adddh,Dune::All_All_Interface,Dune::ForwardCommunication);
+            {
+              PerformanceTrace::Region region("communication","communication");
+              gfs.gridView().communicate(adddh,Dune::All_All_Interface,Dune::ForwardCommunication);
+            }
           }
       }
 
@@ -297,12 +330,16 @@ namespace Dune {
       {
         Dune::InverseOperatorResult stat;
         Y b(d); // need copy, since solver overwrites right hand side
+        PerformanceTrace::Region subdomain_region("subdomain solve","solver");
         solver.apply(istl::raw(v),istl::raw(b),stat);
+        subdomain_region.end();
         if (gfs.gridView().comm().size()>1)
           {
             helper.maskForeignDOFs(istl::raw(v));
-            AddDataHandle<GFS,X> adddh(gfs,v);
-            gfs.gridView().communicate(adddh,Dune::InteriorBorder_All_Interface,Dune::ForwardCommunication);
+            {
+              PerformanceTrace::Region region("communication","communication");
+              helper.communicate(v,Dune::InteriorBorder_All_Interface,AddGatherScatter());
+            }
           }
       }
 
@@ -340,6 +377,19 @@ namespace Dune {
         return gfs.gridView().comm().sum(sum);
       }
 
+      //! Local dot product on the unique partition, without communication.
+      template<typename X>
+      typename X::ElementType localDot (const X& x, const X& y) const
+      {
+        return helper.disjointDot(x,y);
+      }
+
+      //! The collective communication of the grid view.
+      const typename GFS::Traits::GridViewType::CollectiveCommunication& comm() const
+      {
+        return gfs.gridView().comm();
+      }
+
       /*! \brief Norm of a right-hand side vector.
         The vector must be consistent on the interior+border partition
       */
@@ -369,11 +419,14 @@ namespace Dune {
     template<typename GFS, typename X>
     class OVLPScalarProduct
       : public ScalarProduct<X>
+      , public istl::FusedScalarProduct<X>
     {
+      typedef typename GFS::Traits::GridViewType::CollectiveCommunication CollectiveCommunication;
+
     public:
       enum {category=Dune::SolverCategory::overlapping};
       OVLPScalarProduct(const OVLPScalarProductImplementation<GFS>& implementation_)
-        : implementation(implementation_)
+        : implementation(implementation_), global_sum(implementation_.comm())
       {}
 
       virtual typename X::BaseT::field_type dot(const X& x, const X& y)
@@ -386,8 +439,24 @@ namespace Dune {
         return sqrt(static_cast<double>(this->dot(x,x)));
       }
 
+      virtual typename X::BaseT::field_type localDot(const X& x, const X& y)
+      {
+        return implementation.localDot(x,y);
+      }
+
+      virtual void startGlobalSum(typename X::BaseT::field_type* values, int n)
+      {
+        global_sum.start(values,n);
+      }
+
+      virtual void finishGlobalSum()
+      {
+        global_sum.finish();
+      }
+
     private:
       const OVLPScalarProductImplementation<GFS>& implementation;
+      istl::GlobalSum<CollectiveCommunication> global_sum;
     };
 
     template<class GFS, class C,
@@ -432,7 +501,9 @@ namespace Dune {
         if (gfs.gridView().comm().rank()==0) verb=verbose;
         Solver<V> solver(pop,psp,wprec,reduction,maxiter,verb);
         Dune::InverseOperatorResult stat;
+        PerformanceTrace::Region krylov_region("krylov","solver");
         solver.apply(z,r,stat);
+        krylov_region.end();
         res.converged  = stat.converged;
         res.iterations = stat.iterations;
         res.elapsed    = stat.elapsed;
@@ -487,7 +558,9 @@ namespace Dune {
         if (gfs.gridView().comm().rank()==0) verb=verbose;
         Solver<V> solver(pop,psp,wprec,reduction,maxiter,verb);
         Dune::InverseOperatorResult stat;
+        PerformanceTrace::Region krylov_region("krylov","solver");
         solver.apply(z,r,stat);
+        krylov_region.end();
         res.converged  = stat.converged;
         res.iterations = stat.iterations;
         res.elapsed    = stat.elapsed;
@@ -543,7 +616,9 @@ namespace Dune {
         if (gfs.gridView().comm().rank()==0) verb=verbose;
         Solver<V> solver(pop,psp,wprec,reduction,maxiter,verb);
         Dune::InverseOperatorResult stat;
+        PerformanceTrace::Region krylov_region("krylov","solver");
         solver.apply(z,r,stat);
+        krylov_region.end();
         res.converged  = stat.converged;
         res.iterations = stat.iterations;
         res.elapsed    = stat.elapsed;
@@ -652,6 +727,83 @@ namespace Dune {
       {}
     };
 
+    /**
+     * @brief Overlapping parallel pipelined CG solver with SSOR preconditioner
+     *
+     * The three dot products of an iteration are combined into a single
+     * global reduction that is overlapped with the preconditioner and the
+     * matrix-vector product.
+     * @tparam GFS The Type of the GridFunctionSpace.
+     * @tparam CC The Type of the Constraints Container.
+     */
+    template<class GFS, class CC>
+    class ISTLBackend_OVLP_PipelinedCG_SSORk
+      : public ISTLBackend_OVLP_Base<GFS,CC,Dune::SeqSSOR, istl::PipelinedCGSolver>
+    {
+    public:
+      /*! \brief make a linear solver object
+
+        \param[in] gfs a grid function space
+        \param[in] cc a constraints container object
+        \param[in] maxiter maximum number of iterations to do
+        \param[in] steps number of SSOR steps to apply as inner iteration
+        \param[in] verbose print messages if true
+      */
+      ISTLBackend_OVLP_PipelinedCG_SSORk (const GFS& gfs, const CC& cc, unsigned maxiter=5000,
+                                          int steps=5, int verbose=1)
+        : ISTLBackend_OVLP_Base<GFS,CC,Dune::SeqSSOR, istl::PipelinedCGSolver>(gfs, cc, maxiter, steps, verbose)
+      {}
+    };
+
+    /**
+     * @brief Overlapping parallel pipelined BiCGStab solver with SSOR preconditioner
+     *
+     * Needs two global reductions per iteration instead of the four of
+     * ISTLBackend_OVLP_BCGS_SSORk, both overlapped with computation.
+     * @tparam GFS The Type of the GridFunctionSpace.
+     * @tparam CC The Type of the Constraints Container.
+     */
+    template<class GFS, class CC>
+    class ISTLBackend_OVLP_PipelinedBCGS_SSORk
+      : public ISTLBackend_OVLP_Base<GFS,CC,Dune::SeqSSOR, istl::PipelinedBiCGSTABSolver>
+    {
+    public:
+      /*! \brief make a linear solver object
+
+        \param[in] gfs a grid function space
+        \param[in] cc a constraints container object
+        \param[in] maxiter maximum number of iterations to do
+        \param[in] steps number of SSOR steps to apply as inner iteration
+        \param[in] verbose print messages if true
+      */
+      ISTLBackend_OVLP_PipelinedBCGS_SSORk (const GFS& gfs, const CC& cc, unsigned maxiter=5000,
+                                            int steps=5, int verbose=1)
+        : ISTLBackend_OVLP_Base<GFS,CC,Dune::SeqSSOR, istl::PipelinedBiCGSTABSolver>(gfs, cc, maxiter, steps, verbose)
+      {}
+    };
+
+    /**
+     * @brief Overlapping parallel pipelined BiCGStab solver with ILU0 preconditioner
+     * @tparam GFS The Type of the GridFunctionSpace.
+     * @tparam CC The Type of the Constraints Container.
+     */
+    template<class GFS, class CC>
+    class ISTLBackend_OVLP_PipelinedBCGS_ILU0
+      : public ISTLBackend_OVLP_ILU0_Base<GFS,CC,istl::PipelinedBiCGSTABSolver>
+    {
+    public:
+      /*! \brief make a linear solver object
+
+        \param[in] gfs a grid function space
+        \param[in] cc a constraints container object
+        \param[in] maxiter maximum number of iterations to do
+        \param[in] verbose print messages if true
+      */
+      ISTLBackend_OVLP_PipelinedBCGS_ILU0 (const GFS& gfs, const CC& cc, unsigned maxiter=5000, int verbose=1)
+        : ISTLBackend_OVLP_ILU0_Base<GFS,CC,istl::PipelinedBiCGSTABSolver>(gfs, cc, maxiter, verbose)
+      {}
+    };
+
     /**
      * @brief Overlapping parallel restarted GMRes solver with ILU0 preconditioner
      * @tparam GFS The Type of the GridFunctionSpace.
@@ -696,7 +848,9 @@ namespace Dune {
         if (gfs.gridView().comm().rank()==0) verb=verbose;
         RestartedGMResSolver<V> solver(pop,psp,wprec,reduction,restart,maxiter,verb,recalc_defect);
         Dune::InverseOperatorResult stat;
+        PerformanceTrace::Region krylov_region("krylov","solver");
         solver.apply(z,r,stat);
+        krylov_region.end();
         res.converged  = stat.converged;
         res.iterations = stat.iterations;
         res.elapsed    = stat.elapsed;
@@ -754,7 +908,9 @@ namespace Dune {
         if (gfs.gridView().comm().rank()==0) verb=verbose;
         Solver<V> solver(pop,psp,prec,reduction,maxiter,verb);
         Dune::InverseOperatorResult stat;
+        PerformanceTrace::Region krylov_region("krylov","solver");
         solver.apply(z,r,stat);
+        krylov_region.end();
         res.converged  = stat.converged;
         res.iterations = stat.iterations;
         res.elapsed    = stat.elapsed;
@@ -825,23 +981,28 @@ namespace Dune {
 
 
     /** @brief Solver to be used for explicit time-steppers with (block-)diagonal mass matrix
+     *
+     * If reuse is enabled, the inverted diagonal of the matrix is computed
+     * once and used for all following solves.
+     *
      * @tparam GFS The Type of the GridFunctionSpace.
      */
     template<class GFS>
     class ISTLBackend_OVLP_ExplicitDiagonal
-      : public LinearResultStorage
+      : public LinearResultStorage, public ReusablePreconditioner
     {
     public:
       /*! \brief make a linear solver object
 
         \param[in] gfs_ a grid function space
+        \param[in] reuse_ keep the inverted diagonal between calls to apply()
       */
-      explicit ISTLBackend_OVLP_ExplicitDiagonal (const GFS& gfs_)
-        : gfs(gfs_)
+      explicit ISTLBackend_OVLP_ExplicitDiagonal (const GFS& gfs_, bool reuse_=false)
+        : ReusablePreconditioner(reuse_), gfs(gfs_)
       {}
 
       explicit ISTLBackend_OVLP_ExplicitDiagonal (const ISTLBackend_OVLP_ExplicitDiagonal& other_)
-        : gfs(other_.gfs)
+        : ReusablePreconditioner(other_.reuse), gfs(other_.gfs)
       {}
 
       /*! \brief compute global norm of a vector
@@ -869,14 +1030,28 @@ namespace Dune {
       template<class M, class V, class W>
       void apply(M& A, V& z, W& r, typename W::ElementType reduction)
       {
-        Dune::SeqJac<typename M::BaseT,typename V::BaseT,typename W::BaseT> jac(istl::raw(A),1,1.0);
-        jac.pre(istl::raw(z),istl::raw(r));
-        jac.apply(istl::raw(z),istl::raw(r));
-        jac.post(istl::raw(z));
+        if (reuse)
+          {
+            Timer watch;
+            if (inverse.update(A,true))
+              setup_time = watch.elapsed();
+            inverse.mv<M>(r,z);
+          }
+        else
+          {
+            inverse.reset();
+            Dune::SeqJac<typename M::BaseT,typename V::BaseT,typename W::BaseT> jac(istl::raw(A),1,1.0);
+            jac.pre(istl::raw(z),istl::raw(r));
+            jac.apply(istl::raw(z),istl::raw(r));
+            jac.post(istl::raw(z));
+          }
         if (gfs.gridView().comm().size()>1)
         {
           CopyDataHandle<GFS,V> copydh(gfs,z);
-          gfs.gridView().communicate(copydh,Dune::InteriorBorder_All_Interface,Dune::ForwardCommunication);
+          {
+            PerformanceTrace::Region region("communication","communication");
+            gfs.gridView().communicate(copydh,Dune::InteriorBorder_All_Interface,Dune::ForwardCommunication);
+          }
         }
         res.converged  = true;
         res.iterations = 1;
@@ -887,12 +1062,13 @@ namespace Dune {
 
     private:
       const GFS& gfs;
+      istl::InverseBlockDiagonalCache inverse;
     };
     //! \} Overlapping Solvers
 
     template<class GO, int s, template<class,class,class,int> class Preconditioner,
              template<class> class Solver>
-    class ISTLBackend_AMG : public LinearResultStorage
+    class ISTLBackend_AMG : public LinearResultStorage, public ReusablePreconditioner
     {
       typedef typename GO::Traits::TrialGridFunctionSpace GFS;
       typedef istl::ParallelHelper<GFS> PHELPER;
@@ -923,8 +1099,10 @@ namespace Dune {
       ISTLBackend_AMG(const GFS& gfs_, unsigned maxiter_=5000,
                       int verbose_=1, bool reuse_=false,
                       bool usesuperlu_=true)
-        : gfs(gfs_), phelper(gfs,verbose_), maxiter(maxiter_), params(15,2000),
-          verbose(verbose_), reuse(reuse_), firstapply(true),
+        : ReusablePreconditioner(reuse_), gfs(gfs_), phelper(make_shared<PHELPER>(gfs,verbose_)),
+          phelper_revision(gfs.revision()), comm_revision(0), comm_rounds(0),
+          maxiter(maxiter_), params(15,2000),
+          verbose(verbose_), firstapply(true),
           usesuperlu(usesuperlu_)
       {
         params.setDefaultValuesIsotropic(GFS::Traits::GridViewType::Traits::Grid::dimension);
@@ -973,10 +1151,24 @@ namespace Dune {
       typename V::ElementType norm (const V& v) const
       {
         typedef OverlappingScalarProduct<GFS,V> PSP;
-        PSP psp(gfs,phelper);
+        PSP psp(gfs,parallelHelper());
         return psp.norm(v);
       }
 
+      /*! \brief discard the parallel index set
+
+        The index set and the remote index information are computed in the
+        first call to apply() and kept for all later solves until the
+        revision() of the GridFunctionSpace changes, i.e. until it is
+        update()d after grid adaptation. Call this method if the
+        parallel layout changes in any other way.
+      */
+      void invalidateIndexSet()
+      {
+        amg.reset();
+        oocc.reset();
+      }
+
       /*! \brief solve the given linear system
 
         \param[in] A the given matrix
@@ -987,14 +1179,33 @@ namespace Dune {
       void apply(M& A, V& z, V& r, typename V::ElementType reduction)
       {
         Timer watch;
-        Comm oocc(gfs.gridView().comm());
         MatrixType& mat=istl::raw(A);
         typedef Dune::Amg::CoarsenCriterion<Dune::Amg::SymmetricCriterion<MatrixType,
           Dune::Amg::FirstDiagonal> > Criterion;
+        if (!oocc || comm_revision != gfs.revision())
+          {
+            Timer index_set_watch;
+            // the hierarchy refers to the old index set
+            amg.reset();
+            firstapply = true;
+            oocc = make_shared<Comm>(gfs.gridView().comm());
+            comm_revision = gfs.revision();
+            comm_rounds = 0;
+#if HAVE_MPI
+            PerformanceTrace::Region region("parallel index set","solver");
+            comm_rounds = parallelHelper().createIndexSetAndProjectForAMG(A, *oocc);
+#endif
+            stats.tindexset = index_set_watch.elapsed();
+            ++stats.indexSetBuilds;
+          }
+        else
+          {
+            ++stats.indexSetReuses;
+            stats.savedCommunicationRounds += comm_rounds;
+          }
 #if HAVE_MPI
-        phelper.createIndexSetAndProjectForAMG(A, oocc);
-        Operator oop(mat, oocc);
-        Dune::OverlappingSchwarzScalarProduct<VectorType,Comm> sp(oocc);
+        Operator oop(mat, *oocc);
+        Dune::OverlappingSchwarzScalarProduct<VectorType,Comm> sp(*oocc);
 #else
         Operator oop(mat);
         Dune::SeqScalarProduct<VectorType> sp;
@@ -1010,17 +1221,21 @@ namespace Dune {
         if (gfs.gridView().comm().rank()==0) verb=verbose;
         //only construct a new AMG if the matrix changes
         if (reuse==false || firstapply==true){
-          amg.reset(new AMG(oop, criterion, smootherArgs, oocc));
+          PerformanceTrace::Region setup_region("preconditioner setup","solver");
+          amg.reset(new AMG(oop, criterion, smootherArgs, *oocc));
           firstapply = false;
           stats.tsetup = watch.elapsed();
           stats.levels = amg->maxlevels();
           stats.directCoarseLevelSolver=amg->usesDirectCoarseLevelSolver();
+          setup_time = stats.tsetup;
         }
         watch.reset();
         Solver<VectorType> solver(oop,sp,*amg,reduction,maxiter,verb);
         Dune::InverseOperatorResult stat;
 
+        PerformanceTrace::Region krylov_region("krylov","solver");
         solver.apply(istl::raw(z),istl::raw(r),stat);
+        krylov_region.end();
         stats.tsolve= watch.elapsed();
         res.converged  = stat.converged;
         res.iterations = stat.iterations;
@@ -1039,12 +1254,27 @@ namespace Dune {
       }
 
     private:
+
+      // the ownership information has to follow the DOF layout of the space
+      PHELPER& parallelHelper() const
+      {
+        if (phelper_revision != gfs.revision())
+          {
+            phelper = make_shared<PHELPER>(gfs,verbose);
+            phelper_revision = gfs.revision();
+          }
+        return *phelper;
+      }
+
       const GFS& gfs;
-      PHELPER phelper;
+      mutable shared_ptr<PHELPER> phelper;
+      mutable std::size_t phelper_revision;
+      shared_ptr<Comm> oocc;
+      std::size_t comm_revision;
+      std::size_t comm_rounds;
       unsigned maxiter;
       Parameters params;
       int verbose;
-      bool reuse;
       bool firstapply;
       bool usesuperlu;
       shared_ptr<AMG> amg;
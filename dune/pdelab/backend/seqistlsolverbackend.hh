@@ -4,6 +4,8 @@
 #define DUNE_SEQISTLSOLVERBACKEND_HH
 
 #include <dune/common/deprecated.hh>
+#include <dune/common/nullptr.hh>
+#include <dune/common/shared_ptr.hh>
 #include <dune/common/parallel/mpihelper.hh>
 
 #include <dune/istl/owneroverlapcopy.hh>
@@ -22,6 +24,8 @@
 #include <dune/pdelab/backend/solver.hh>
 #include <dune/pdelab/backend/istlvectorbackend.hh>
 #include <dune/pdelab/backend/istlmatrixbackend.hh>
+#include <dune/pdelab/backend/istl/blockmatrixdiagonal.hh>
+#include <dune/pdelab/common/performancetrace.hh>
 
 namespace Dune {
   namespace PDELab {
@@ -62,6 +66,75 @@ namespace Dune {
       GOS& gos;
     };
 
+    //! Operator applying the jacobian of a non-linear GridOperator without assembling it
+    /**
+     * The jacobian is evaluated at the linearization point passed to
+     * setLinearizationPoint() by means of GridOperator::jacobian_apply(x,z,r).
+     * In contrast to OnTheFlyOperator, the operator acts on the raw ISTL
+     * vectors and can be passed directly to the ISTL Krylov solvers.
+     */
+    template<typename GO>
+    class NonlinearOnTheFlyOperator
+      : public Dune::LinearOperator<typename GO::Traits::Domain::BaseT,
+                                    typename GO::Traits::Range::BaseT>
+    {
+      typedef typename GO::Traits::Domain Domain;
+      typedef typename GO::Traits::Range Range;
+
+    public:
+      typedef typename Domain::BaseT domain_type;
+      typedef typename Range::BaseT range_type;
+      typedef typename domain_type::field_type field_type;
+
+      enum {category=Dune::SolverCategory::sequential};
+
+      NonlinearOnTheFlyOperator (const GO& go)
+        : _go(go)
+        , _x(nullptr)
+        , _z(go.trialGridFunctionSpace(),tags::unattached_container())
+        , _y(go.testGridFunctionSpace(),tags::unattached_container())
+      {}
+
+      //! Sets the point at which the jacobian is evaluated, x has to outlive all subsequent applications.
+      void setLinearizationPoint (const Domain& x)
+      {
+        _x = &x;
+      }
+
+      virtual void apply (const domain_type& z, range_type& y) const
+      {
+        y = 0.0;
+        jacobianApply(z,y);
+      }
+
+      virtual void applyscaleadd (field_type alpha, const domain_type& z, range_type& y) const
+      {
+        range_type temp(y);
+        temp = 0.0;
+        jacobianApply(z,temp);
+        y.axpy(alpha,temp);
+      }
+
+    private:
+
+      void jacobianApply (const domain_type& z, range_type& y) const
+      {
+        if (!_x)
+          DUNE_THROW(InvalidStateException,"NonlinearOnTheFlyOperator: no linearization point set");
+        // wrap the raw vectors without copying them
+        _z.attach(stackobject_to_shared_ptr(const_cast<domain_type&>(z)));
+        _y.attach(stackobject_to_shared_ptr(y));
+        _go.jacobian_apply(*_x,_z,_y);
+        _z.detach();
+        _y.detach();
+      }
+
+      const GO& _go;
+      const Domain* _x;
+      mutable Domain _z;
+      mutable Range _y;
+    };
+
     //==============================================================================
     // Here we add some standard linear solvers conforming to the linear solver
     // interface required to solve linear and nonlinear problems.
@@ -102,7 +175,9 @@ namespace Dune {
                        typename W::BaseT,1> prec(istl::raw(A), 3, 1.0);
         Solver<typename V::BaseT> solver(opa, prec, reduction, maxiter, verbose);
         Dune::InverseOperatorResult stat;
+        PerformanceTrace::Region krylov_region("krylov","solver");
         solver.apply(istl::raw(z), istl::raw(r), stat);
+        krylov_region.end();
         res.converged  = stat.converged;
         res.iterations = stat.iterations;
         res.elapsed    = stat.elapsed;
@@ -146,7 +221,9 @@ namespace Dune {
                       typename W::BaseT> ilu0(istl::raw(A), 1.0);
         Solver<typename V::BaseT> solver(opa, ilu0, reduction, maxiter, verbose);
         Dune::InverseOperatorResult stat;
+        PerformanceTrace::Region krylov_region("krylov","solver");
         solver.apply(istl::raw(z), istl::raw(r), stat);
+        krylov_region.end();
         res.converged  = stat.converged;
         res.iterations = stat.iterations;
         res.elapsed    = stat.elapsed;
@@ -190,7 +267,9 @@ namespace Dune {
                       typename W::BaseT> ilun(istl::raw(A), n_, w_);
         Solver<typename V::BaseT> solver(opa, ilun, reduction, maxiter, verbose);
         Dune::InverseOperatorResult stat;
+        PerformanceTrace::Region krylov_region("krylov","solver");
         solver.apply(istl::raw(z), istl::raw(r), stat);
+        krylov_region.end();
         res.converged  = stat.converged;
         res.iterations = stat.iterations;
         res.elapsed    = stat.elapsed;
@@ -416,7 +495,9 @@ namespace Dune {
         typedef typename M::Container ISTLM;
         Dune::SuperLU<ISTLM> solver(istl::raw(A), verbose);
         Dune::InverseOperatorResult stat;
+        PerformanceTrace::Region krylov_region("krylov","solver");
         solver.apply(istl::raw(z), istl::raw(r), stat);
+        krylov_region.end();
         res.converged  = stat.converged;
         res.iterations = stat.iterations;
         res.elapsed    = stat.elapsed;
@@ -429,14 +510,120 @@ namespace Dune {
     };
 #endif // HAVE_SUPERLU
 
+    //! Base class for sequential Krylov solvers applying the jacobian without assembling it
+    /**
+     * The linear systems are solved without preconditioner, the jacobian is
+     * applied via GridOperator::jacobian_apply(x,z,r) at the linearization point
+     * set with setLinearizationPoint().  The matrix argument of apply() is
+     * ignored and may be an unattached container.
+     *
+     * \tparam GO     The GridOperator.
+     * \tparam Solver The ISTL Krylov solver.
+     */
+    template<class GO, template<class> class Solver>
+    class ISTLBackend_SEQ_MatrixFree_Base
+      : public SequentialNorm, public LinearResultStorage, public MatrixFreeLinearSolver
+    {
+    public:
+      /*! \brief make a linear solver object
+
+        \param[in] go the grid operator whose jacobian is applied
+        \param[in] maxiter_ maximum number of iterations to do
+        \param[in] verbose_ print messages if true
+      */
+      explicit ISTLBackend_SEQ_MatrixFree_Base(const GO& go, unsigned maxiter_=5000, int verbose_=1)
+        : opa(go), maxiter(maxiter_), verbose(verbose_)
+      {}
+
+      //! Sets the point at which the jacobian is evaluated.
+      void setLinearizationPoint(const typename GO::Traits::Domain& x)
+      {
+        opa.setLinearizationPoint(x);
+      }
+
+      /*! \brief solve the given linear system
+
+        \param[in] A ignored
+        \param[out] z the solution vector to be computed
+        \param[in] r right hand side
+        \param[in] reduction to be achieved
+      */
+      template<class M, class V, class W>
+      void apply(M& A, V& z, W& r, typename W::ElementType reduction)
+      {
+        Dune::Richardson<typename V::BaseT,typename W::BaseT> prec(1.0);
+        Solver<typename V::BaseT> solver(opa, prec, reduction, maxiter, verbose);
+        Dune::InverseOperatorResult stat;
+        PerformanceTrace::Region krylov_region("krylov","solver");
+        solver.apply(istl::raw(z), istl::raw(r), stat);
+        krylov_region.end();
+        res.converged  = stat.converged;
+        res.iterations = stat.iterations;
+        res.elapsed    = stat.elapsed;
+        res.reduction  = stat.reduction;
+        res.conv_rate  = stat.conv_rate;
+      }
+
+    private:
+      NonlinearOnTheFlyOperator<GO> opa;
+      unsigned maxiter;
+      int verbose;
+    };
+
+    /**
+     * @brief Backend for sequential matrix-free BiCGSTAB solver.
+     */
+    template<class GO>
+    class ISTLBackend_SEQ_MatrixFree_BCGS
+      : public ISTLBackend_SEQ_MatrixFree_Base<GO, Dune::BiCGSTABSolver>
+    {
+    public:
+      /*! \brief make a linear solver object
+
+        \param[in] go the grid operator whose jacobian is applied
+        \param[in] maxiter_ maximum number of iterations to do
+        \param[in] verbose_ print messages if true
+      */
+      explicit ISTLBackend_SEQ_MatrixFree_BCGS (const GO& go, unsigned maxiter_=5000, int verbose_=1)
+        : ISTLBackend_SEQ_MatrixFree_Base<GO, Dune::BiCGSTABSolver>(go, maxiter_, verbose_)
+      {}
+    };
+
+    /**
+     * @brief Backend for sequential matrix-free conjugate gradient solver.
+     */
+    template<class GO>
+    class ISTLBackend_SEQ_MatrixFree_CG
+      : public ISTLBackend_SEQ_MatrixFree_Base<GO, Dune::CGSolver>
+    {
+    public:
+      /*! \brief make a linear solver object
+
+        \param[in] go the grid operator whose jacobian is applied
+        \param[in] maxiter_ maximum number of iterations to do
+        \param[in] verbose_ print messages if true
+      */
+      explicit ISTLBackend_SEQ_MatrixFree_CG (const GO& go, unsigned maxiter_=5000, int verbose_=1)
+        : ISTLBackend_SEQ_MatrixFree_Base<GO, Dune::CGSolver>(go, maxiter_, verbose_)
+      {}
+    };
+
     //! Solver to be used for explicit time-steppers with (block-)diagonal mass matrix
+    /**
+     * If reuse is enabled, the inverted diagonal of the matrix is computed
+     * once and used for all following solves, which is worthwhile for a
+     * time-independent mass matrix.
+     */
     class ISTLBackend_SEQ_ExplicitDiagonal
-      : public SequentialNorm, public LinearResultStorage
+      : public SequentialNorm, public LinearResultStorage, public ReusablePreconditioner
     {
     public:
       /*! \brief make a linear solver object
+
+        \param[in] reuse_ keep the inverted diagonal between calls to apply()
       */
-      ISTLBackend_SEQ_ExplicitDiagonal ()
+      explicit ISTLBackend_SEQ_ExplicitDiagonal (bool reuse_=false)
+        : ReusablePreconditioner(reuse_)
       {}
 
       /*! \brief solve the given linear system
@@ -449,18 +636,32 @@ namespace Dune {
       template<class M, class V, class W>
       void apply(M& A, V& z, W& r, typename W::ElementType reduction)
       {
-        Dune::SeqJac<typename M::BaseT,
-                     typename V::BaseT,
-                     typename W::BaseT> jac(istl::raw(A),1,1.0);
-        jac.pre(z,r);
-        jac.apply(z,r);
-        jac.post(z);
+        if (reuse)
+          {
+            Timer watch;
+            if (inverse.update(A,true))
+              setup_time = watch.elapsed();
+            inverse.mv<M>(r,z);
+          }
+        else
+          {
+            inverse.reset();
+            Dune::SeqJac<typename M::BaseT,
+                         typename V::BaseT,
+                         typename W::BaseT> jac(istl::raw(A),1,1.0);
+            jac.pre(z,r);
+            jac.apply(z,r);
+            jac.post(z);
+          }
         res.converged  = true;
         res.iterations = 1;
         res.elapsed    = 0.0;
         res.reduction  = reduction;
         res.conv_rate  = reduction; // pow(reduction,1.0/1)
       }
+
+    private:
+      istl::InverseBlockDiagonalCache inverse;
     };
 
     //! \} Sequential Solvers
@@ -471,6 +672,19 @@ namespace Dune {
      */
     struct ISTLAMGStatistics
     {
+      ISTLAMGStatistics()
+        : tprepare(0.0)
+        , levels(0)
+        , tsolve(0.0)
+        , tsetup(0.0)
+        , iterations(0)
+        , directCoarseLevelSolver(false)
+        , tindexset(0.0)
+        , indexSetBuilds(0)
+        , indexSetReuses(0)
+        , savedCommunicationRounds(0)
+      {}
+
       /**
        * @brief The needed for computing the parallel information and
        * for adapting the linear system.
@@ -486,11 +700,23 @@ namespace Dune {
       int iterations;
       /** @brief True if a direct solver was used on the coarset level. */
       bool directCoarseLevelSolver;
+      /** @brief The time needed for the last construction of the parallel index set. */
+      double tindexset;
+      /** @brief The number of times the parallel index set was constructed. */
+      int indexSetBuilds;
+      /** @brief The number of solves that reused the parallel index set of an earlier solve. */
+      int indexSetReuses;
+      /**
+       * @brief The number of communication rounds saved by reusing the parallel index set.
+       *
+       * Every reuse saves the rounds of the last construction and roughly tindexset seconds.
+       */
+      std::size_t savedCommunicationRounds;
     };
 
     template<class GO, template<class,class,class,int> class Preconditioner, template<class> class Solver,
               bool skipBlocksizeCheck = false>
-    class ISTLBackend_SEQ_AMG : public LinearResultStorage
+    class ISTLBackend_SEQ_AMG : public LinearResultStorage, public ReusablePreconditioner
     {
       typedef typename GO::Traits::TrialGridFunctionSpace GFS;
       typedef typename GO::Traits::Jacobian M;
@@ -506,8 +732,8 @@ namespace Dune {
     public:
       ISTLBackend_SEQ_AMG(unsigned maxiter_=5000, int verbose_=1,
                           bool reuse_=false, bool usesuperlu_=true)
-        : maxiter(maxiter_), params(15,2000), verbose(verbose_),
-          reuse(reuse_), firstapply(true), usesuperlu(usesuperlu_)
+        : ReusablePreconditioner(reuse_), maxiter(maxiter_), params(15,2000), verbose(verbose_),
+          firstapply(true), usesuperlu(usesuperlu_)
       {
         params.setDefaultValuesIsotropic(GFS::Traits::GridViewType::Traits::Grid::dimension);
         params.setDebugLevel(verbose_);
@@ -561,17 +787,21 @@ namespace Dune {
         Operator oop(mat);
         //only construct a new AMG if the matrix changes
         if (reuse==false || firstapply==true){
+          PerformanceTrace::Region setup_region("preconditioner setup","solver");
           amg.reset(new AMG(oop, criterion, smootherArgs));
           firstapply = false;
           stats.tsetup = watch.elapsed();
           stats.levels = amg->maxlevels();
           stats.directCoarseLevelSolver=amg->usesDirectCoarseLevelSolver();
+          setup_time = stats.tsetup;
         }
         watch.reset();
         Dune::InverseOperatorResult stat;
 
         Solver<VectorType> solver(oop,*amg,reduction,maxiter,verbose);
+        PerformanceTrace::Region krylov_region("krylov","solver");
         solver.apply(istl::raw(z),istl::raw(r),stat);
+        krylov_region.end();
         stats.tsolve= watch.elapsed();
         res.converged  = stat.converged;
         res.iterations = stat.iterations;
@@ -594,7 +824,6 @@ namespace Dune {
       unsigned maxiter;
       Parameters params;
       int verbose;
-      bool reuse;
       bool firstapply;
       bool usesuperlu;
       Dune::shared_ptr<AMG> amg;
@@ -6,7 +6,6 @@
 #include <algorithm>
 #include <functional>
 #include <numeric>
-#include <unordered_set>
 
 #include <dune/common/typetraits.hh>
 #include <dune/common/shared_ptr.hh>
@@ -19,9 +18,17 @@ namespace Dune {
   namespace PDELab {
     namespace simple {
 
+      //! Pattern builder for SparseMatrixContainer.
+      /**
+       * The column indices of each row are appended to a plain vector, which is sorted and
+       * stripped of duplicates whenever it has doubled in size since the last compaction.
+       * Links to different rows may be added concurrently. finalize() has to be called
+       * before reading the pattern, afterwards every row contains its column indices in
+       * ascending order.
+       */
       template<typename _RowOrdering, typename _ColOrdering>
       class SparseMatrixPattern
-        : public std::vector< std::unordered_set<std::size_t> >
+        : public std::vector< std::vector<std::size_t> >
       {
 
       public:
@@ -29,24 +36,50 @@ namespace Dune {
         typedef _RowOrdering RowOrdering;
         typedef _ColOrdering ColOrdering;
 
-        typedef std::unordered_set<std::size_t> col_type;
+        typedef std::vector<std::size_t> col_type;
 
         template<typename RI, typename CI>
         void add_link(const RI& ri, const CI& ci)
         {
-          this->resize(_row_ordering.blockCount());
-          (*this)[ri.back()].insert(ci.back());
+          const std::size_t i = ri.back();
+          col_type& row = (*this)[i];
+          row.push_back(ci.back());
+          if (row.size() >= _compaction_size[i])
+            _compaction_size[i] = std::max(std::size_t(min_compaction_size),2*compact(row));
+        }
+
+        //! Sorts the column indices of all rows and removes duplicates.
+        void finalize()
+        {
+          const long rows = this->size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+          for (long i = 0; i < rows; ++i)
+            compact((*this)[i]);
         }
 
         SparseMatrixPattern(const RowOrdering& row_ordering, const ColOrdering& col_ordering)
-          : _row_ordering(row_ordering)
+          : std::vector<col_type>(row_ordering.blockCount())
+          , _row_ordering(row_ordering)
           , _col_ordering(col_ordering)
+          , _compaction_size(row_ordering.blockCount(),std::size_t(min_compaction_size))
         {}
 
       private:
 
+        static const std::size_t min_compaction_size = 16;
+
+        static std::size_t compact(col_type& row)
+        {
+          std::sort(row.begin(),row.end());
+          row.erase(std::unique(row.begin(),row.end()),row.end());
+          return row.size();
+        }
+
         const RowOrdering& _row_ordering;
         const ColOrdering& _col_ordering;
+        std::vector<std::size_t> _compaction_size;
 
       };
 
@@ -279,6 +312,7 @@ namespace Dune {
           typedef typename Pattern::col_type col_type;
           Pattern pattern(go.testGridFunctionSpace().ordering(),go.trialGridFunctionSpace().ordering());
           go.fill_pattern(pattern);
+          pattern.finalize();
 
           c->_rows = go.testGridFunctionSpace().size();
           c->_cols = go.trialGridFunctionSpace().size();
@@ -298,11 +332,7 @@ namespace Dune {
           auto colit = c->_colindex.begin();
           c->_rowoffset[0] = 0;
           for (auto & row : pattern)
-          {
-            auto last = std::copy(row.begin(),row.end(),colit);
-            std::sort(colit, last);
-            colit = last;
-          }
+            colit = std::copy(row.begin(),row.end(),colit);
         }
 
         template<typename V>
@@ -52,6 +52,56 @@ namespace Dune {
       Dune::PDELab::LinearSolverResult<double> res;
     };
 
+    //! Base class for linear solver backends which can keep their preconditioner between solves
+    /**
+     * If reuse is enabled, apply() only sets up the preconditioner on its first
+     * call and uses it for all subsequent linear systems, even if the matrix has
+     * changed in the meantime.  The flag can be changed between two calls to
+     * apply(), which allows e.g. the Newton solver to lag the preconditioner
+     * behind the jacobian.
+     */
+    class ReusablePreconditioner
+    {
+    public:
+      //! Sets whether the next calls to apply() reuse the existing preconditioner.
+      void setReuse(bool reuse_)
+      {
+        reuse = reuse_;
+      }
+
+      //! Returns whether the next calls to apply() reuse the existing preconditioner.
+      bool getReuse() const
+      {
+        return reuse;
+      }
+
+      //! Returns the time needed for the last setup of the preconditioner.
+      double preconditionerSetupTime() const
+      {
+        return setup_time;
+      }
+
+    protected:
+      explicit ReusablePreconditioner(bool reuse_ = false)
+        : reuse(reuse_)
+        , setup_time(0.0)
+      {}
+
+      bool reuse;
+      double setup_time;
+    };
+
+    //! Base class for linear solver backends which do not need an assembled matrix
+    /**
+     * Solvers derived from this class only require the application of the
+     * jacobian.  They have to provide a method setLinearizationPoint(x) which
+     * is called with the current iterate before each linear solve, and they
+     * have to accept an unattached matrix container in apply().  The Newton
+     * solver detects such backends and skips the assembly of the jacobian.
+     */
+    struct MatrixFreeLinearSolver
+    {};
+
     //! \} group Backend
 
   } // end namespace PDELab
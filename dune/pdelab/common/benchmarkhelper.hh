@@ -12,11 +12,20 @@
 #include <dune/common/exceptions.hh>
 #include <dune/common/ios_state.hh>
 
+#include <dune/pdelab/common/clock.hh>
+#include <dune/pdelab/common/performancetrace.hh>
+
 #include <ctime>
 
 namespace Dune {
   namespace PDELab {
 
+    //! Time source based on std::clock()
+    /**
+     * \note std::clock() measures the CPU time of the process, not the wall
+     *       time: time spent waiting is not counted and the time of all
+     *       threads is summed up.
+     */
     struct CppClockWallTimeSource
     {
 
@@ -27,6 +36,17 @@ namespace Dune {
 
     };
 
+    //! Time source based on the monotonic wall clock of getMonotonicSeconds()
+    struct MonotonicWallTimeSource
+    {
+
+      double operator()() const
+      {
+        return getMonotonicSeconds();
+      }
+
+    };
+
 #if HAVE_MPI
 #include"mpi.h"
 
@@ -44,7 +64,7 @@ namespace Dune {
 
 #else
 
-    typedef CppClockWallTimeSource DefaultTimeSource;
+    typedef MonotonicWallTimeSource DefaultTimeSource;
 
 #endif
 
@@ -231,7 +251,47 @@ namespace Dune {
         print_entry(s,"total",_run_times,summary_only);
       }
 
+      //! Writes the timings of all runs and their statistics as a JSON object.
+      void print_json(std::ostream& s)
+      {
+        ios_base_all_saver ios_saver(s);
+
+        if (_statistics_stale)
+          update_statistics();
+
+        s << std::setprecision(9) << "{\n  \"name\": ";
+        writeJSONString(s,_name);
+        s << ",\n  \"runs\": " << _run << ",\n  \"tasks\": {";
+        for (std::map<std::string,BenchmarkEntry>::const_iterator it = _tasks.begin(), end = _tasks.end();
+             it != end;
+             ++it)
+          {
+            s << (it == _tasks.begin() ? "\n    " : ",\n    ");
+            writeJSONString(s,it->first);
+            s << ": ";
+            print_json_entry(s,it->second);
+          }
+        s << "\n  },\n  \"total\": ";
+        print_json_entry(s,_run_times);
+        s << "\n}" << std::endl;
+      }
+
     private:
+
+      void print_json_entry(std::ostream& s, const BenchmarkEntry& entry) const
+      {
+        s << "{ \"timings\": [";
+        for (std::vector<Timing>::const_iterator it = entry.timings.begin(),
+               end = entry.timings.end();
+             it != end;
+             ++it)
+          s << (it == entry.timings.begin() ? "" : ", ") << it->elapsed();
+        s << "], \"min\": " << entry.min
+          << ", \"max\": " << entry.max
+          << ", \"avg\": " << entry.avg
+          << ", \"std_dev\": " << entry.std_dev << " }";
+      }
+
       const std::string _name;
       TimeSource _time;
       std::size_t _run;
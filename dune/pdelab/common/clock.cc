@@ -128,6 +128,75 @@ namespace Dune {
     const std::string &getWallTimeImp()
     { return WallTimeClock::instance().clockName; }
 
+    //////////////////////////////////////////////////////////////////////
+    //
+    //  Monotonic time
+    //
+
+#if HAVE_POSIX_CLOCK && defined(_POSIX_MONOTONIC_CLOCK) && _POSIX_MONOTONIC_CLOCK >= 0
+    TimeSpec posixGetMonotonicTime() {
+      timespec result;
+      if(clock_gettime(CLOCK_MONOTONIC, &result) < 0)
+        DUNE_THROW(ClockError, "clock_gettime(CLOCK_MONOTONIC, ...) failed: "
+                   "errno = " << errno);
+      TimeSpec tmp = { result.tv_sec, result.tv_nsec };
+      return tmp;
+    }
+
+    TimeSpec posixGetMonotonicTimeResolution() {
+      timespec result;
+      if(clock_getres(CLOCK_MONOTONIC, &result) < 0)
+        DUNE_THROW(ClockError, "clock_getres(CLOCK_MONOTONIC, ...) failed: "
+                   "errno = " << errno);
+      TimeSpec tmp = { result.tv_sec, result.tv_nsec };
+      return tmp;
+    }
+
+    bool checkPOSIXGetMonotonicTime() {
+# if _POSIX_MONOTONIC_CLOCK == 0
+      return sysconf(_SC_MONOTONIC_CLOCK) > 0;
+# else // _POSIX_MONOTONIC_CLOCK > 0
+      return true;
+# endif // _POSIX_MONOTONIC_CLOCK > 0
+    }
+#endif // HAVE_POSIX_CLOCK && _POSIX_MONOTONIC_CLOCK >= 0
+
+    struct MonotonicTimeClock {
+      TimeSpec (*clock)();
+      TimeSpec resolution;
+      std::string clockName;
+
+      static const MonotonicTimeClock &instance() {
+        static const MonotonicTimeClock clock;
+        return clock;
+      }
+
+    private:
+      MonotonicTimeClock() {
+#if HAVE_POSIX_CLOCK && defined(_POSIX_MONOTONIC_CLOCK) && _POSIX_MONOTONIC_CLOCK >= 0
+        if(checkPOSIXGetMonotonicTime()) {
+          clock = posixGetMonotonicTime;
+          resolution = posixGetMonotonicTimeResolution();
+          clockName = "clock_gettime(CLOCK_MONOTONIC, ...)";
+          return;
+        }
+#endif // HAVE_POSIX_CLOCK && _POSIX_MONOTONIC_CLOCK >= 0
+        // fall back to the wall time, which may jump when the system time is
+        // adjusted
+        {
+          clock = WallTimeClock::instance().clock;
+          resolution = WallTimeClock::instance().resolution;
+          clockName = WallTimeClock::instance().clockName;
+        }
+      }
+    };
+    TimeSpec getMonotonicTime()
+    { return MonotonicTimeClock::instance().clock(); }
+    TimeSpec getMonotonicTimeResolution()
+    { return MonotonicTimeClock::instance().resolution; }
+    const std::string &getMonotonicTimeImp()
+    { return MonotonicTimeClock::instance().clockName; }
+
     //////////////////////////////////////////////////////////////////////
     //
     //  Process Time
@@ -5,8 +5,12 @@
 #define DUNE_PDELAB_COMMON_CLOCK_HH
 
 #include <ostream>
+#include <string>
 
+#include <sys/time.h>
 #include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
 
 #include <dune/common/exceptions.hh>
 
@@ -67,6 +71,48 @@ namespace Dune {
     //! \brief return a string describing which implementation is used to get
     //!        the wall time
     const std::string &getWallTimeImp();
+    //! \brief get the time in seconds of a monotonic clock, i.e. wall time
+    //!        that is not affected by adjustments of the system time
+    /**
+     * The clock starts at an unspecified point in time, so only differences
+     * are meaningful.  If no monotonic clock is available, the wall time is
+     * used.
+     */
+    TimeSpec getMonotonicTime();
+    //! get resolution of the monotonic time in seconds
+    TimeSpec getMonotonicTimeResolution();
+    //! \brief return a string describing which implementation is used to get
+    //!        the monotonic time
+    const std::string &getMonotonicTimeImp();
+    //! \brief get the time in seconds of a monotonic clock, without linking
+    //!        libdunepdelab
+    /**
+     * Header-only variant of getMonotonicTime() for code that must not depend
+     * on the library, like the PerformanceTrace.  Uses
+     * clock_gettime(CLOCK_MONOTONIC) where the system provides it and falls
+     * back to the wall time of gettimeofday() otherwise.  The clock starts at
+     * an unspecified point in time, so only differences are meaningful.
+     */
+    inline double getMonotonicSeconds() {
+#if defined(_POSIX_MONOTONIC_CLOCK) && _POSIX_MONOTONIC_CLOCK >= 0
+      timespec ts;
+      if(clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+        return ts.tv_sec + 1e-9 * ts.tv_nsec;
+#endif
+      timeval tv;
+      gettimeofday(&tv, NULL);
+      return tv.tv_sec + 1e-6 * tv.tv_usec;
+    }
+    //! \brief return a string describing which implementation is used by
+    //!        getMonotonicSeconds()
+    inline std::string getMonotonicSecondsImp() {
+#if defined(_POSIX_MONOTONIC_CLOCK) && _POSIX_MONOTONIC_CLOCK >= 0
+      timespec ts;
+      if(clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+        return "clock_gettime(CLOCK_MONOTONIC, ...)";
+#endif
+      return "gettimeofday(...)";
+    }
     //! get the process time in seconds used by the current process
     TimeSpec getProcessTime();
     //! get resolution of the process time in seconds
@@ -0,0 +1,350 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_COMMON_DUALNUMBER_HH
+#define DUNE_PDELAB_COMMON_DUALNUMBER_HH
+
+#include <cmath>
+#include <ostream>
+
+#include <dune/common/fvector.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! Number type for forward mode automatic differentiation.
+    /**
+     * A DualNumber stores a value together with its partial derivatives with respect to N
+     * independent variables. All arithmetic operations and the elementary functions below
+     * propagate the derivatives by the chain rule, so evaluating an expression with dual
+     * numbers yields its exact derivatives in the same pass, up to rounding. An independent
+     * variable is created by seeding one of the derivatives with 1:
+     *
+     * \code
+     * DualNumber<double,2> x(3.0,0), y(2.0,1);
+     * DualNumber<double,2> f = x*x*y + sin(y);
+     * // f.value() == 18.0 + sin(2.0), f.derivative(0) == 12.0, f.derivative(1) == 9.0 + cos(2.0)
+     * \endcode
+     *
+     * Comparisons only take the values into account, so code branching on the value of a
+     * dual number computes the derivatives of the branch taken. The functions are found by
+     * argument dependent lookup, code that should work with both dual numbers and plain
+     * floating point numbers therefore has to call them unqualified (e.g. <tt>using
+     * std::exp; exp(u);</tt> instead of <tt>std::exp(u)</tt>). There is deliberately no
+     * conversion back to T, use value() to explicitly drop the derivatives.
+     *
+     * \tparam T The underlying floating point type.
+     * \tparam N The number of independent variables.
+     */
+    template<typename T, int N>
+    class DualNumber
+    {
+
+    public:
+
+      //! The underlying floating point type.
+      typedef T value_type;
+
+      //! The type of the vector of partial derivatives.
+      typedef Dune::FieldVector<T,N> DerivativeType;
+
+      //! The number of independent variables.
+      static const int size = N;
+
+      //! Creates a dual number with value and derivatives 0.
+      DualNumber()
+        : _value(0)
+        , _derivatives(0)
+      {}
+
+      //! Creates a constant, i.e. a dual number whose derivatives vanish.
+      DualNumber(const T& value)
+        : _value(value)
+        , _derivatives(0)
+      {}
+
+      //! Creates the independent variable number i with the given value.
+      DualNumber(const T& value, int i)
+        : _value(value)
+        , _derivatives(0)
+      {
+        _derivatives[i] = 1;
+      }
+
+      //! Creates a dual number from its value and derivatives.
+      DualNumber(const T& value, const DerivativeType& derivatives)
+        : _value(value)
+        , _derivatives(derivatives)
+      {}
+
+      //! The value.
+      const T& value() const
+      {
+        return _value;
+      }
+
+      //! The value.
+      T& value()
+      {
+        return _value;
+      }
+
+      //! The partial derivative with respect to the independent variable number i.
+      const T& derivative(int i) const
+      {
+        return _derivatives[i];
+      }
+
+      //! The partial derivative with respect to the independent variable number i.
+      T& derivative(int i)
+      {
+        return _derivatives[i];
+      }
+
+      //! All partial derivatives.
+      const DerivativeType& derivatives() const
+      {
+        return _derivatives;
+      }
+
+      //! All partial derivatives.
+      DerivativeType& derivatives()
+      {
+        return _derivatives;
+      }
+
+      DualNumber& operator+=(const DualNumber& b)
+      {
+        _value += b._value;
+        _derivatives += b._derivatives;
+        return *this;
+      }
+
+      DualNumber& operator+=(const T& b)
+      {
+        _value += b;
+        return *this;
+      }
+
+      DualNumber& operator-=(const DualNumber& b)
+      {
+        _value -= b._value;
+        _derivatives -= b._derivatives;
+        return *this;
+      }
+
+      DualNumber& operator-=(const T& b)
+      {
+        _value -= b;
+        return *this;
+      }
+
+      DualNumber& operator*=(const DualNumber& b)
+      {
+        // (ab)' = a'b + ab'
+        _derivatives *= b._value;
+        _derivatives.axpy(_value,b._derivatives);
+        _value *= b._value;
+        return *this;
+      }
+
+      DualNumber& operator*=(const T& b)
+      {
+        _value *= b;
+        _derivatives *= b;
+        return *this;
+      }
+
+      DualNumber& operator/=(const DualNumber& b)
+      {
+        // (a/b)' = (a' - (a/b) b') / b
+        _value /= b._value;
+        _derivatives.axpy(-_value,b._derivatives);
+        _derivatives /= b._value;
+        return *this;
+      }
+
+      DualNumber& operator/=(const T& b)
+      {
+        _value /= b;
+        _derivatives /= b;
+        return *this;
+      }
+
+      friend DualNumber operator+(const DualNumber& a)
+      {
+        return a;
+      }
+
+      friend DualNumber operator-(const DualNumber& a)
+      {
+        DualNumber r(a);
+        r._value = -r._value;
+        r._derivatives *= -1;
+        return r;
+      }
+
+      // The operators taking a T are defined as friends, so the scalar operand can be any
+      // type implicitly convertible to T, e.g. an integer literal.
+
+      friend DualNumber operator+(DualNumber a, const DualNumber& b) { return a += b; }
+      friend DualNumber operator+(DualNumber a, const T& b) { return a += b; }
+      friend DualNumber operator+(const T& a, DualNumber b) { return b += a; }
+
+      friend DualNumber operator-(DualNumber a, const DualNumber& b) { return a -= b; }
+      friend DualNumber operator-(DualNumber a, const T& b) { return a -= b; }
+      friend DualNumber operator-(const T& a, const DualNumber& b) { return -b + a; }
+
+      friend DualNumber operator*(DualNumber a, const DualNumber& b) { return a *= b; }
+      friend DualNumber operator*(DualNumber a, const T& b) { return a *= b; }
+      friend DualNumber operator*(const T& a, DualNumber b) { return b *= a; }
+
+      friend DualNumber operator/(DualNumber a, const DualNumber& b) { return a /= b; }
+      friend DualNumber operator/(DualNumber a, const T& b) { return a /= b; }
+      friend DualNumber operator/(const T& a, const DualNumber& b) { return DualNumber(a) /= b; }
+
+      friend bool operator==(const DualNumber& a, const DualNumber& b) { return a._value == b._value; }
+      friend bool operator==(const DualNumber& a, const T& b) { return a._value == b; }
+      friend bool operator==(const T& a, const DualNumber& b) { return a == b._value; }
+
+      friend bool operator!=(const DualNumber& a, const DualNumber& b) { return a._value != b._value; }
+      friend bool operator!=(const DualNumber& a, const T& b) { return a._value != b; }
+      friend bool operator!=(const T& a, const DualNumber& b) { return a != b._value; }
+
+      friend bool operator<(const DualNumber& a, const DualNumber& b) { return a._value < b._value; }
+      friend bool operator<(const DualNumber& a, const T& b) { return a._value < b; }
+      friend bool operator<(const T& a, const DualNumber& b) { return a < b._value; }
+
+      friend bool operator<=(const DualNumber& a, const DualNumber& b) { return a._value <= b._value; }
+      friend bool operator<=(const DualNumber& a, const T& b) { return a._value <= b; }
+      friend bool operator<=(const T& a, const DualNumber& b) { return a <= b._value; }
+
+      friend bool operator>(const DualNumber& a, const DualNumber& b) { return a._value > b._value; }
+      friend bool operator>(const DualNumber& a, const T& b) { return a._value > b; }
+      friend bool operator>(const T& a, const DualNumber& b) { return a > b._value; }
+
+      friend bool operator>=(const DualNumber& a, const DualNumber& b) { return a._value >= b._value; }
+      friend bool operator>=(const DualNumber& a, const T& b) { return a._value >= b; }
+      friend bool operator>=(const T& a, const DualNumber& b) { return a >= b._value; }
+
+      friend std::ostream& operator<<(std::ostream& s, const DualNumber& a)
+      {
+        return s << a._value << " " << a._derivatives;
+      }
+
+      //! Applies the chain rule for a function with value f and derivative df at value().
+      DualNumber chain(const T& f, const T& df) const
+      {
+        DualNumber r(f,_derivatives);
+        r._derivatives *= df;
+        return r;
+      }
+
+    private:
+
+      T _value;
+      DerivativeType _derivatives;
+
+    };
+
+    //! Returns the value of a dual number, or the number itself for plain floating point types.
+    template<typename T, int N>
+    const T& primalValue(const DualNumber<T,N>& a)
+    {
+      return a.value();
+    }
+
+    template<typename T>
+    const T& primalValue(const T& a)
+    {
+      return a;
+    }
+
+    template<typename T, int N>
+    DualNumber<T,N> abs(const DualNumber<T,N>& a)
+    {
+      return a.value() < 0 ? -a : a;
+    }
+
+    template<typename T, int N>
+    DualNumber<T,N> fabs(const DualNumber<T,N>& a)
+    {
+      return abs(a);
+    }
+
+    template<typename T, int N>
+    DualNumber<T,N> sqrt(const DualNumber<T,N>& a)
+    {
+      const T s = std::sqrt(a.value());
+      return a.chain(s,T(0.5)/s);
+    }
+
+    template<typename T, int N>
+    DualNumber<T,N> exp(const DualNumber<T,N>& a)
+    {
+      const T e = std::exp(a.value());
+      return a.chain(e,e);
+    }
+
+    template<typename T, int N>
+    DualNumber<T,N> log(const DualNumber<T,N>& a)
+    {
+      return a.chain(std::log(a.value()),T(1)/a.value());
+    }
+
+    // The value is computed directly, as a^(b-1) a would give NaN at a = 0 for b < 1. The
+    // derivative vanishes for b = 0 and is not finite at a = 0 for 0 < b < 1, like for sqrt().
+    template<typename T, int N>
+    DualNumber<T,N> pow(const DualNumber<T,N>& a, const T& b)
+    {
+      const T db = b == 0 ? T(0) : b*std::pow(a.value(),b-1);
+      return a.chain(std::pow(a.value(),b),db);
+    }
+
+    template<typename T, int N>
+    DualNumber<T,N> pow(const DualNumber<T,N>& a, int b)
+    {
+      return pow(a,T(b));
+    }
+
+    template<typename T, int N>
+    DualNumber<T,N> pow(const T& a, const DualNumber<T,N>& b)
+    {
+      const T p = std::pow(a,b.value());
+      return b.chain(p,p*std::log(a));
+    }
+
+    template<typename T, int N>
+    DualNumber<T,N> pow(const DualNumber<T,N>& a, const DualNumber<T,N>& b)
+    {
+      return exp(b*log(a));
+    }
+
+    template<typename T, int N>
+    DualNumber<T,N> sin(const DualNumber<T,N>& a)
+    {
+      return a.chain(std::sin(a.value()),std::cos(a.value()));
+    }
+
+    template<typename T, int N>
+    DualNumber<T,N> cos(const DualNumber<T,N>& a)
+    {
+      return a.chain(std::cos(a.value()),-std::sin(a.value()));
+    }
+
+    template<typename T, int N>
+    DualNumber<T,N> tanh(const DualNumber<T,N>& a)
+    {
+      const T t = std::tanh(a.value());
+      return a.chain(t,1-t*t);
+    }
+
+    template<typename T, int N>
+    DualNumber<T,N> atan(const DualNumber<T,N>& a)
+    {
+      return a.chain(std::atan(a.value()),T(1)/(1+a.value()*a.value()));
+    }
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_COMMON_DUALNUMBER_HH
@@ -7,9 +7,25 @@
 namespace Dune {
   namespace PDELab {
 
+#ifndef DOXYGEN
+
+    namespace impl {
+
+      //! Evaluation state of the cached affine geometry data.
+      enum AffineState { affine_unknown, affine_geometry, nonaffine_geometry };
+
+    }
+
+#endif // DOXYGEN
+
     //! Wrap element
     /**
-     * \todo Please doc me!
+     * Besides access to the entity and its geometry, the wrapper provides the transposed
+     * inverse of the jacobian and the integration element of the geometry. For affine
+     * geometries (see affine()), these are evaluated once per element and returned for all
+     * further positions, so local operators can call them at every quadrature point without
+     * evaluating the geometry again. For all other geometries, they are evaluated at the
+     * given position as before.
      */
 	template<typename E>
 	class ElementGeometry
@@ -19,10 +35,17 @@ namespace Dune {
 	  typedef typename E::Geometry Geometry;
       //! \todo Please doc me!
 	  typedef E Entity;
+      //! Coordinate in the reference element
+      typedef typename Geometry::LocalCoordinate LocalCoordinate;
+      //! Type of the transposed inverse of the jacobian
+      typedef typename Geometry::JacobianInverseTransposed JacobianInverseTransposed;
+      //! Coordinate field type
+      typedef typename Geometry::ctype ctype;
 
       //! \todo Please doc me!
 	  ElementGeometry (const E& e_)
 		: e(e_)
+        , affine_state(impl::affine_unknown)
 	  {}
 
       //! \todo Please doc me!
@@ -42,15 +65,61 @@ namespace Dune {
 	  {
 		return e;
 	  }
-  
+
+      //! Returns whether the geometry of the element is affine.
+      bool affine () const
+      {
+        if (affine_state == impl::affine_unknown)
+          evaluateAffineData();
+        return affine_state == impl::affine_geometry;
+      }
+
+      //! Transposed inverse of the jacobian at the position x, evaluated only once for affine geometries.
+      JacobianInverseTransposed jacobianInverseTransposed (const LocalCoordinate& x) const
+      {
+        if (!affine())
+          return e.geometry().jacobianInverseTransposed(x);
+        return jacobian_inverse_transposed;
+      }
+
+      //! Integration element at the position x, evaluated only once for affine geometries.
+      ctype integrationElement (const LocalCoordinate& x) const
+      {
+        if (!affine())
+          return e.geometry().integrationElement(x);
+        return integration_element;
+      }
+
 	private:
+
+      void evaluateAffineData () const
+      {
+        const Geometry geo = e.geometry();
+        if (geo.affine())
+          {
+            // the data is constant, so any position in the reference element will do
+            const LocalCoordinate x(0.0);
+            jacobian_inverse_transposed = geo.jacobianInverseTransposed(x);
+            integration_element = geo.integrationElement(x);
+            affine_state = impl::affine_geometry;
+          }
+        else
+          affine_state = impl::nonaffine_geometry;
+      }
+
 	  const E& e;
+      mutable impl::AffineState affine_state;
+      mutable JacobianInverseTransposed jacobian_inverse_transposed;
+      mutable ctype integration_element;
 	};
 
 
     //! Wrap intersection
     /**
-     * \todo Please doc me!
+     * Like ElementGeometry, the wrapper caches geometric data that is constant for affine
+     * geometries: the integration element and, if the world dimension equals the grid
+     * dimension, the normals of an affine intersection as well as the transposed inverse
+     * jacobians of affine inside and outside cells (see insideJacobianInverseTransposed()).
      */
 	template<typename I>
 	class IntersectionGeometry
@@ -70,10 +139,19 @@ namespace Dune {
 	  enum { dimension=Entity::dimension };
       //! \todo Please doc me!
       enum { dimensionworld=Geometry::dimensionworld };
+      //! Coordinate on the intersection
+      typedef Dune::FieldVector<ctype, dimension-1> LocalCoordinate;
+      //! Coordinate in the reference element of the inside or outside cell
+      typedef typename Entity::Geometry::LocalCoordinate EntityLocalCoordinate;
+      //! Type of the transposed inverse of the jacobian of the inside and outside cells
+      typedef typename Entity::Geometry::JacobianInverseTransposed JacobianInverseTransposed;
 
       //! \todo Please doc me!
       IntersectionGeometry (const I& i_, unsigned int index_)
         : i(i_), index(index_)
+        , affine_state(impl::affine_unknown)
+        , inside_affine_state(impl::affine_unknown)
+        , outside_affine_state(impl::affine_unknown)
 	  {}
 
       //! \todo Please doc me!
@@ -173,6 +251,8 @@ namespace Dune {
 	  */
 	  Dune::FieldVector<ctype, dimensionworld> outerNormal (const Dune::FieldVector<ctype, dimension-1>& local) const
 	  {
+        if (constantNormal())
+          return outer_normal;
 		return i.outerNormal(local);
 	  }
 
@@ -184,6 +264,8 @@ namespace Dune {
 	  */
 	  Dune::FieldVector<ctype, dimensionworld> integrationOuterNormal (const Dune::FieldVector<ctype, dimension-1>& local) const
 	  {
+        if (constantNormal())
+          return integration_outer_normal;
 		return i.integrationOuterNormal(local);
 	  }
 
@@ -194,6 +276,8 @@ namespace Dune {
 	  */
 	  Dune::FieldVector<ctype, dimensionworld> unitOuterNormal (const Dune::FieldVector<ctype, dimension-1>& local) const
 	  {
+        if (constantNormal())
+          return unit_outer_normal;
 		return i.unitOuterNormal(local);
 	  }
 
@@ -246,9 +330,95 @@ namespace Dune {
         return index;
       }
 
+      //! Returns whether the geometry of the intersection is affine.
+      bool affine () const
+      {
+        if (affine_state == impl::affine_unknown)
+          evaluateAffineData();
+        return affine_state == impl::affine_geometry;
+      }
+
+      //! Integration element of the intersection at the position x, evaluated only once for affine geometries.
+      ctype integrationElement (const LocalCoordinate& x) const
+      {
+        if (!affine())
+          return i.geometry().integrationElement(x);
+        return integration_element;
+      }
+
+      //! Transposed inverse of the jacobian of the inside cell at the position x, evaluated only once for affine cells.
+      JacobianInverseTransposed insideJacobianInverseTransposed (const EntityLocalCoordinate& x) const
+      {
+        return evaluateJacobianInverseTransposed(*(i.inside()),x,inside_affine_state,inside_jacobian_inverse_transposed);
+      }
+
+      //! Transposed inverse of the jacobian of the outside cell at the position x, evaluated only once for affine cells.
+      JacobianInverseTransposed outsideJacobianInverseTransposed (const EntityLocalCoordinate& x) const
+      {
+        return evaluateJacobianInverseTransposed(*(i.outside()),x,outside_affine_state,outside_jacobian_inverse_transposed);
+      }
+
     private:
+
+      //! The normals of an affine intersection are constant unless the grid is embedded in a higher dimensional world.
+      bool constantNormal () const
+      {
+        return int(dimension) == int(dimensionworld) && affine();
+      }
+
+      void evaluateAffineData () const
+      {
+        const Geometry geo = i.geometry();
+        if (geo.affine())
+          {
+            // the data is constant, so any position on the intersection will do
+            const LocalCoordinate x(0.0);
+            integration_element = geo.integrationElement(x);
+            if (int(dimension) == int(dimensionworld))
+              {
+                outer_normal = i.outerNormal(x);
+                integration_outer_normal = i.integrationOuterNormal(x);
+                unit_outer_normal = i.unitOuterNormal(x);
+              }
+            affine_state = impl::affine_geometry;
+          }
+        else
+          affine_state = impl::nonaffine_geometry;
+      }
+
+      // returns the cached matrix for affine cells, only non-affine cells are evaluated at x
+      template<typename Element>
+      static JacobianInverseTransposed evaluateJacobianInverseTransposed (const Element& element, const EntityLocalCoordinate& x,
+                                                                          impl::AffineState& state, JacobianInverseTransposed& jit)
+      {
+        if (state == impl::affine_geometry)
+          return jit;
+        const typename Element::Geometry geo = element.geometry();
+        if (state == impl::affine_unknown)
+          {
+            state = geo.affine() ? impl::affine_geometry : impl::nonaffine_geometry;
+            if (state == impl::affine_geometry)
+              {
+                jit = geo.jacobianInverseTransposed(x);
+                return jit;
+              }
+          }
+        return geo.jacobianInverseTransposed(x);
+      }
+
 	  const I& i;
       const unsigned int index;
+
+      mutable impl::AffineState affine_state;
+      mutable ctype integration_element;
+      mutable Dune::FieldVector<ctype, dimensionworld> outer_normal;
+      mutable Dune::FieldVector<ctype, dimensionworld> integration_outer_normal;
+      mutable Dune::FieldVector<ctype, dimensionworld> unit_outer_normal;
+
+      mutable impl::AffineState inside_affine_state;
+      mutable JacobianInverseTransposed inside_jacobian_inverse_transposed;
+      mutable impl::AffineState outside_affine_state;
+      mutable JacobianInverseTransposed outside_jacobian_inverse_transposed;
 	};
 
   }
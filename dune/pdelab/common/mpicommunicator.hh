@@ -0,0 +1,42 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef DUNE_PDELAB_COMMON_MPICOMMUNICATOR_HH
+#define DUNE_PDELAB_COMMON_MPICOMMUNICATOR_HH
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parallel/collectivecommunication.hh>
+
+#if HAVE_MPI
+#include <dune/common/parallel/mpicollectivecommunication.hh>
+#endif
+
+namespace Dune {
+  namespace PDELab {
+
+#if HAVE_MPI
+
+    //! Returns the MPI communicator behind a collective communication.
+    /**
+     * Code doing point-to-point communication directly with MPI uses this to
+     * obtain the communicator of a grid view. For collective communications
+     * that are not backed by MPI, MPI_COMM_NULL is returned and the caller
+     * has to fall back to the communication interface of the grid.
+     */
+    inline MPI_Comm mpiCommunicator(const CollectiveCommunication<MPI_Comm>& comm)
+    {
+      return comm;
+    }
+
+    template<typename Comm>
+    MPI_Comm mpiCommunicator(const Comm& comm)
+    {
+      return MPI_COMM_NULL;
+    }
+
+#endif // HAVE_MPI
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_COMMON_MPICOMMUNICATOR_HH
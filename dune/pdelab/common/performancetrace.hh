@@ -0,0 +1,496 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifndef DUNE_PDELAB_COMMON_PERFORMANCETRACE_HH
+#define DUNE_PDELAB_COMMON_PERFORMANCETRACE_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if HAVE_MPI
+#include <mpi.h>
+#endif // HAVE_MPI
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/ios_state.hh>
+
+#include <dune/pdelab/common/clock.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! Hierarchical record of timings and counters
+    /**
+     * The grid operator, the assemblers, the Newton solver and the solver
+     * backends report the time spent in their phases (assembly, pattern
+     * construction, preconditioner setup, Krylov iterations, communication,
+     * ...) into the global instance of this class.  Regions nest, and every
+     * distinct path of region names forms one node of a tree that collects
+     * the number of calls and the total, minimal and maximal time.  Counters,
+     * e.g. the number of Krylov iterations, are added to the innermost open
+     * region.  In addition, the individual occurrences of the regions can be
+     * recorded for a timeline view.
+     *
+     * Tracing is disabled by default, in which case opening a region costs a
+     * single check.  Usage:
+     * \code
+Dune::PDELab::PerformanceTrace& trace = Dune::PDELab::PerformanceTrace::instance();
+trace.setEnabled(true);
+{
+  Dune::PDELab::PerformanceTrace::Region region("my phase","application");
+  ...
+  trace.count("my counter",42);
+}
+trace.write("trace");   // writes trace-<rank>.json and trace-<rank>.trace.json
+     * \endcode
+     *
+     * All times are taken from the monotonic clock of getMonotonicSeconds(),
+     * so they are not affected by adjustments of the system time, and are
+     * given in seconds since the creation of the instance.  The class is
+     * header-only, so the grid operator and the Newton solver can use it
+     * without linking libdunepdelab.
+     *
+     * \note Regions are only recorded outside of OpenMP parallel regions.
+     */
+    class PerformanceTrace
+    {
+    public:
+
+      //! Summary of all occurrences of a region at one position in the hierarchy
+      struct Node
+      {
+        std::string name;
+        std::string category;
+        std::size_t parent;
+        std::vector<std::size_t> children;
+        std::size_t calls;
+        double total;
+        double min;
+        double max;
+        std::map<std::string,double> counters;
+      };
+
+      //! A single occurrence of a region
+      struct Event
+      {
+        std::size_t node;
+        double start;
+        double duration;
+      };
+
+      //! A single change of a counter
+      struct CounterSample
+      {
+        std::size_t node;
+        std::string name;
+        double time;
+        double value;
+      };
+
+      //! Opens a region for the lifetime of the object
+      class Region
+      {
+      public:
+
+        Region(const char* name, const char* category = "pdelab")
+          : _active(PerformanceTrace::instance().enabled())
+        {
+#ifdef _OPENMP
+          if (omp_in_parallel())
+            _active = false;
+#endif
+          if (_active)
+            PerformanceTrace::instance().begin(name,category);
+        }
+
+        ~Region()
+        {
+          end();
+        }
+
+        //! Closes the region before the end of the lifetime of the object.
+        void end()
+        {
+          if (_active)
+            PerformanceTrace::instance().end();
+          _active = false;
+        }
+
+      private:
+
+        Region(const Region&);
+        Region& operator=(const Region&);
+
+        bool _active;
+      };
+
+      //! The global instance.
+      static PerformanceTrace& instance();
+
+      //! Returns whether regions and counters are recorded.
+      bool enabled() const
+      {
+        return _enabled;
+      }
+
+      //! Enables or disables recording.
+      void setEnabled(bool enabled)
+      {
+        _enabled = enabled;
+      }
+
+      //! Sets the maximal number of individual events kept for the timeline, 0 disables the timeline.
+      void setMaxEvents(std::size_t max_events)
+      {
+        _max_events = max_events;
+      }
+
+      //! Opens a region nested into the currently open region.
+      void begin(const char* name, const char* category = "pdelab");
+
+      //! Closes the innermost open region.
+      void end();
+
+      //! Adds value to the counter with the given name in the innermost open region.
+      void count(const char* name, double value = 1.0);
+
+      //! Discards everything recorded so far.
+      void clear();
+
+      //! Returns the seconds since the creation of the instance.
+      double now() const;
+
+      //! Returns all nodes of the hierarchy, node 0 is the root that contains all top level regions.
+      const std::vector<Node>& nodes() const
+      {
+        return _nodes;
+      }
+
+      //! Returns the recorded occurrences of the regions.
+      const std::vector<Event>& events() const
+      {
+        return _events;
+      }
+
+      //! Writes the hierarchy with timings and counters as a JSON object.
+      void writeJSON(std::ostream& s, int rank = 0) const;
+
+      //! Writes the recorded events in the Chrome trace event format.
+      /**
+       * The output can be loaded into chrome://tracing or Perfetto.  The rank is
+       * used as process id, so the files of several ranks can be merged.
+       */
+      void writeChromeTrace(std::ostream& s, int rank = 0) const;
+
+      //! \brief Writes basename-<rank>.json and basename-<rank>.trace.json, with
+      //!        the MPI rank if MPI has been initialized
+      void write(const std::string& basename) const;
+
+    private:
+
+      PerformanceTrace();
+      PerformanceTrace(const PerformanceTrace&);
+      PerformanceTrace& operator=(const PerformanceTrace&);
+
+      void writeNode(std::ostream& s, std::size_t node, int indent) const;
+
+      bool _enabled;
+      std::size_t _max_events;
+      double _epoch;
+      std::vector<Node> _nodes;
+      std::vector<Event> _events;
+      std::vector<CounterSample> _counter_samples;
+      // open regions as (node, start time)
+      std::vector<std::pair<std::size_t,double> > _stack;
+    };
+
+    namespace impl {
+
+      inline void writeIndent(std::ostream& s, int indent) {
+        for(int i = 0; i < indent; ++i)
+          s << "  ";
+      }
+
+      // rank of this process in MPI_COMM_WORLD, 0 if MPI is not used
+      inline int worldRank() {
+        int rank = 0;
+#if HAVE_MPI
+        int initialized = 0;
+        MPI_Initialized(&initialized);
+        if(initialized)
+          MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif // HAVE_MPI
+        return rank;
+      }
+
+    } // namespace impl
+
+    //! Writes a string as a quoted and escaped JSON string.
+    inline void writeJSONString(std::ostream& s, const std::string& str) {
+      s << '"';
+      for(std::string::const_iterator it = str.begin(); it != str.end(); ++it)
+        switch(*it) {
+        case '"':  s << "\\\""; break;
+        case '\\': s << "\\\\"; break;
+        case '\n': s << "\\n"; break;
+        case '\r': s << "\\r"; break;
+        case '\t': s << "\\t"; break;
+        default:
+          if(static_cast<unsigned char>(*it) < 0x20) {
+            char buffer[8];
+            std::sprintf(buffer, "\\u%04x", static_cast<unsigned>(*it));
+            s << buffer;
+          }
+          else
+            s << *it;
+        }
+      s << '"';
+    }
+
+    inline PerformanceTrace& PerformanceTrace::instance() {
+      static PerformanceTrace trace;
+      return trace;
+    }
+
+    inline PerformanceTrace::PerformanceTrace()
+      : _enabled(false)
+      , _max_events(1000000)
+      , _epoch(0.0)
+    {
+      _epoch = now();
+      clear();
+    }
+
+    inline double PerformanceTrace::now() const {
+      return getMonotonicSeconds() - _epoch;
+    }
+
+    inline void PerformanceTrace::clear() {
+      _nodes.clear();
+      _events.clear();
+      _counter_samples.clear();
+      _stack.clear();
+
+      Node root;
+      root.parent = 0;
+      root.calls = 0;
+      root.total = 0.0;
+      root.min = 0.0;
+      root.max = 0.0;
+      _nodes.push_back(root);
+    }
+
+    inline void PerformanceTrace::begin(const char* name, const char* category) {
+      if(!_enabled)
+        return;
+
+      const std::size_t parent = _stack.empty() ? 0 : _stack.back().first;
+
+      // look up the region among the children of the innermost open region
+      std::size_t node = 0;
+      const std::vector<std::size_t>& children = _nodes[parent].children;
+      for(std::size_t i = 0; i < children.size(); ++i)
+        if(_nodes[children[i]].name == name &&
+           _nodes[children[i]].category == category) {
+          node = children[i];
+          break;
+        }
+
+      if(node == 0) {
+        Node n;
+        n.name = name;
+        n.category = category;
+        n.parent = parent;
+        n.calls = 0;
+        n.total = 0.0;
+        n.min = std::numeric_limits<double>::max();
+        n.max = 0.0;
+        node = _nodes.size();
+        _nodes.push_back(n);
+        _nodes[parent].children.push_back(node);
+      }
+
+      _stack.push_back(std::make_pair(node, now()));
+    }
+
+    inline void PerformanceTrace::end() {
+      // regions opened before clear() are silently dropped
+      if(_stack.empty())
+        return;
+
+      const std::size_t node = _stack.back().first;
+      const double start = _stack.back().second;
+      const double duration = now() - start;
+      _stack.pop_back();
+
+      Node& n = _nodes[node];
+      ++n.calls;
+      n.total += duration;
+      n.min = std::min(n.min, duration);
+      n.max = std::max(n.max, duration);
+
+      if(_events.size() < _max_events) {
+        Event event = { node, start, duration };
+        _events.push_back(event);
+      }
+    }
+
+    inline void PerformanceTrace::count(const char* name, double value) {
+      if(!_enabled)
+        return;
+
+      const std::size_t node = _stack.empty() ? 0 : _stack.back().first;
+      double& counter = _nodes[node].counters[name];
+      counter += value;
+
+      if(_counter_samples.size() < _max_events) {
+        CounterSample sample;
+        sample.node = node;
+        sample.name = name;
+        sample.time = now();
+        sample.value = counter;
+        _counter_samples.push_back(sample);
+      }
+    }
+
+    inline void PerformanceTrace::writeNode(std::ostream& s, std::size_t node,
+                                     int indent) const {
+      const Node& n = _nodes[node];
+      impl::writeIndent(s, indent);
+      s << "{\n";
+      impl::writeIndent(s, indent+1);
+      s << "\"name\": ";
+      writeJSONString(s, n.name);
+      s << ",\n";
+      impl::writeIndent(s, indent+1);
+      s << "\"category\": ";
+      writeJSONString(s, n.category);
+      s << ",\n";
+      impl::writeIndent(s, indent+1);
+      s << "\"calls\": " << n.calls << ",\n";
+      impl::writeIndent(s, indent+1);
+      s << "\"total\": " << n.total << ",\n";
+      impl::writeIndent(s, indent+1);
+      s << "\"min\": " << (n.calls > 0 ? n.min : 0.0) << ",\n";
+      impl::writeIndent(s, indent+1);
+      s << "\"max\": " << n.max << ",\n";
+      impl::writeIndent(s, indent+1);
+      s << "\"avg\": " << (n.calls > 0 ? n.total/n.calls : 0.0) << ",\n";
+      impl::writeIndent(s, indent+1);
+      s << "\"counters\": {";
+      for(std::map<std::string,double>::const_iterator it = n.counters.begin();
+          it != n.counters.end(); ++it) {
+        s << (it == n.counters.begin() ? " " : ", ");
+        writeJSONString(s, it->first);
+        s << ": " << it->second;
+      }
+      s << (n.counters.empty() ? "},\n" : " },\n");
+      impl::writeIndent(s, indent+1);
+      s << "\"children\": [";
+      for(std::size_t i = 0; i < n.children.size(); ++i) {
+        s << (i == 0 ? "\n" : ",\n");
+        writeNode(s, n.children[i], indent+2);
+      }
+      if(!n.children.empty()) {
+        s << "\n";
+        impl::writeIndent(s, indent+1);
+      }
+      s << "]\n";
+      impl::writeIndent(s, indent);
+      s << "}";
+    }
+
+    inline void PerformanceTrace::writeJSON(std::ostream& s, int rank) const {
+      ios_base_all_saver saver(s);
+      s << std::setprecision(9);
+
+      const Node& root = _nodes[0];
+      s << "{\n";
+      s << "  \"rank\": " << rank << ",\n";
+      s << "  \"clock\": ";
+      writeJSONString(s, getMonotonicSecondsImp());
+      s << ",\n";
+      s << "  \"counters\": {";
+      for(std::map<std::string,double>::const_iterator it = root.counters.begin();
+          it != root.counters.end(); ++it) {
+        s << (it == root.counters.begin() ? " " : ", ");
+        writeJSONString(s, it->first);
+        s << ": " << it->second;
+      }
+      s << (root.counters.empty() ? "},\n" : " },\n");
+      s << "  \"regions\": [";
+      for(std::size_t i = 0; i < root.children.size(); ++i) {
+        s << (i == 0 ? "\n" : ",\n");
+        writeNode(s, root.children[i], 2);
+      }
+      if(!root.children.empty())
+        s << "\n  ";
+      s << "]\n";
+      s << "}\n";
+    }
+
+    inline void PerformanceTrace::writeChromeTrace(std::ostream& s, int rank) const {
+      ios_base_all_saver saver(s);
+      s << std::fixed << std::setprecision(3);
+
+      // timestamps and durations are given in microseconds
+      s << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+      s << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": " << rank
+        << ", \"tid\": 0, \"args\": {\"name\": \"rank " << rank << "\"}}";
+      for(std::vector<Event>::const_iterator it = _events.begin();
+          it != _events.end(); ++it) {
+        const Node& n = _nodes[it->node];
+        s << ",\n{\"name\": ";
+        writeJSONString(s, n.name);
+        s << ", \"cat\": ";
+        writeJSONString(s, n.category);
+        s << ", \"ph\": \"X\", \"ts\": " << 1e6*it->start
+          << ", \"dur\": " << 1e6*it->duration
+          << ", \"pid\": " << rank << ", \"tid\": 0}";
+      }
+      for(std::vector<CounterSample>::const_iterator it =
+            _counter_samples.begin(); it != _counter_samples.end(); ++it) {
+        s << ",\n{\"name\": ";
+        writeJSONString(s, it->name);
+        s << ", \"ph\": \"C\", \"ts\": " << 1e6*it->time
+          << ", \"pid\": " << rank << ", \"tid\": 0, \"args\": {\"value\": ";
+        s.unsetf(std::ios_base::floatfield);
+        s << std::setprecision(9) << it->value << "}}";
+        s << std::fixed << std::setprecision(3);
+      }
+      s << "\n]}\n";
+    }
+
+    inline void PerformanceTrace::write(const std::string& basename) const {
+      const int rank = impl::worldRank();
+      std::ostringstream name;
+      name << basename << "-" << rank;
+
+      std::ofstream json((name.str() + ".json").c_str());
+      if(!json)
+        DUNE_THROW(IOError, "could not open " << name.str() << ".json");
+      writeJSON(json, rank);
+
+      std::ofstream trace((name.str() + ".trace.json").c_str());
+      if(!trace)
+        DUNE_THROW(IOError, "could not open " << name.str() << ".trace.json");
+      writeChromeTrace(trace, rank);
+    }
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_COMMON_PERFORMANCETRACE_HH
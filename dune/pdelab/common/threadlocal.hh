@@ -0,0 +1,101 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_COMMON_THREADLOCAL_HH
+#define DUNE_PDELAB_COMMON_THREADLOCAL_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <dune/common/exceptions.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! One instance of T for every OpenMP thread.
+    /**
+     * Caches and temporary storage held as mutable members of local operators are written
+     * from const methods, which the colored mode of DefaultAssembler calls concurrently
+     * from several threads. Wrapping such members in a ThreadLocal gives every thread its
+     * own instance, selected by omp_get_thread_num(). Without OpenMP, there is a single
+     * instance.
+     *
+     * The instances are created up front for the maximum number of threads, so local() never
+     * modifies the container itself. T should therefore be cheap to default-construct, e.g. an
+     * empty std::vector. Copies do not share any instances with the original, they start out
+     * with default-constructed instances.
+     */
+    template<typename T>
+    class ThreadLocal
+    {
+
+    public:
+
+      ThreadLocal()
+        : _instances(capacity())
+      {}
+
+      ThreadLocal(const ThreadLocal&)
+        : _instances(capacity())
+      {}
+
+      ThreadLocal& operator=(const ThreadLocal&)
+      {
+        return *this;
+      }
+
+      //! Returns the instance of the calling thread.
+      T& local() const
+      {
+        return _instances[threadNumber()];
+      }
+
+      //! Returns the number of instances.
+      std::size_t size() const
+      {
+        return _instances.size();
+      }
+
+      //! Returns the instance of thread t, must not be called while other threads use it.
+      T& operator[](std::size_t t) const
+      {
+        return _instances[t];
+      }
+
+      //! Returns the number of the calling thread.
+      std::size_t threadNumber() const
+      {
+#ifdef _OPENMP
+        const std::size_t t = omp_get_thread_num();
+        if (t >= _instances.size())
+          DUNE_THROW(Exception,"ThreadLocal: thread number " << t
+                     << " exceeds the supported number of threads " << _instances.size());
+        return t;
+#else
+        return 0;
+#endif
+      }
+
+    private:
+
+      static std::size_t capacity()
+      {
+#ifdef _OPENMP
+        return std::max(std::max(omp_get_max_threads(),omp_get_num_procs()),256);
+#else
+        return 1;
+#endif
+      }
+
+      mutable std::vector<T> _instances;
+
+    };
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_COMMON_THREADLOCAL_HH
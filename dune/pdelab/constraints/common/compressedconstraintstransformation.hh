@@ -0,0 +1,271 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+#ifndef DUNE_PDELAB_CONSTRAINTS_COMMON_COMPRESSEDCONSTRAINTSTRANSFORMATION_HH
+#define DUNE_PDELAB_CONSTRAINTS_COMMON_COMPRESSEDCONSTRAINTSTRANSFORMATION_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <dune/pdelab/backend/backendselector.hh>
+#include <dune/pdelab/constraints/common/constraintstransformation.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! \addtogroup GridFunctionSpace
+    //! \ingroup PDELab
+    //! \{
+
+    //! \brief Frozen constraints container with compressed row storage
+    /**
+     * ConstraintsTransformation is a map of maps, which is convenient while
+     * the constraints are assembled, but every lookup during the assembly of
+     * the operator has to hash the container index.  This class is built
+     * once from a finished ConstraintsTransformation and stores all
+     * constraint rows sorted by container index in two flat arrays.  Finding
+     * the row of a DOF is a single access to a dense array indexed by the
+     * container index, which holds the row number + 1 for constrained DOFs
+     * and 0 for all others.
+     *
+     * The container offers the read-only part of the map interface, so it
+     * can be used as constraints container for the grid operators, the
+     * local index caches and the free functions in constraints.hh:
+     *
+     * \code
+     * typedef typename GFS::template ConstraintsContainer<R>::Type CC;
+     * CC cc;
+     * Dune::PDELab::constraints(bctype,gfs,cc);
+     * Dune::PDELab::CompressedConstraintsTransformation<GFS,R> ccc(gfs,cc);
+     * \endcode
+     *
+     * The container has to be rebuilt by calling assign() whenever the
+     * grid function space or the constraints have changed.
+     *
+     * \tparam GFS The grid function space the constraints belong to.
+     * \tparam F   The type of the constraint weights.
+     */
+    template<typename GFS, typename F>
+    class CompressedConstraintsTransformation
+    {
+
+      typedef typename GFS::Ordering::Traits::ContainerIndex CI;
+
+    public:
+
+      //! export ElementType
+      typedef F ElementType;
+      typedef F Field;
+
+      typedef std::size_t size_type;
+
+      //! A single constraint row, i.e. the weights of the DOFs a constrained DOF depends on.
+      /**
+       * An empty row denotes a Dirichlet constraint.
+       */
+      class Row
+      {
+
+        friend class CompressedConstraintsTransformation;
+
+      public:
+
+        typedef CI key_type;
+        typedef F mapped_type;
+        typedef std::pair<CI,F> value_type;
+        typedef const value_type* const_iterator;
+        typedef const_iterator iterator;
+        typedef std::size_t size_type;
+
+        Row()
+          : _begin(0)
+          , _end(0)
+        {}
+
+        const_iterator begin() const
+        {
+          return _begin;
+        }
+
+        const_iterator end() const
+        {
+          return _end;
+        }
+
+        size_type size() const
+        {
+          return _end - _begin;
+        }
+
+        bool empty() const
+        {
+          return _begin == _end;
+        }
+
+      private:
+
+        const value_type* _begin;
+        const value_type* _end;
+
+      };
+
+      //! export RowType
+      typedef Row RowType;
+
+      typedef CI key_type;
+      typedef Row mapped_type;
+      typedef std::pair<CI,Row> value_type;
+
+      typedef typename std::vector<value_type>::const_iterator const_iterator;
+      typedef const_iterator iterator;
+
+      //! Builds the compressed representation of the given constraints.
+      template<typename DI>
+      CompressedConstraintsTransformation(const GFS& gfs, const ConstraintsTransformation<DI,CI,F>& cg)
+        : _row_flags(gfs,0)
+      {
+        assign(gfs,cg);
+      }
+
+      CompressedConstraintsTransformation(const CompressedConstraintsTransformation& r)
+        : _rows(r._rows)
+        , _row_offsets(r._row_offsets)
+        , _entries(r._entries)
+        , _row_flags(r._row_flags)
+      {
+        bind_rows();
+      }
+
+      CompressedConstraintsTransformation& operator=(const CompressedConstraintsTransformation& r)
+      {
+        _rows = r._rows;
+        _row_offsets = r._row_offsets;
+        _entries = r._entries;
+        _row_flags = r._row_flags;
+        bind_rows();
+        return *this;
+      }
+
+      //! Replaces the contents by the compressed representation of the given constraints.
+      template<typename DI>
+      void assign(const GFS& gfs, const ConstraintsTransformation<DI,CI,F>& cg)
+      {
+        typedef typename ConstraintsTransformation<DI,CI,F>::const_iterator GlobalConstraintIterator;
+        typedef typename ConstraintsTransformation<DI,CI,F>::mapped_type::const_iterator GlobalEntryIterator;
+
+        // sort the rows by container index
+        std::vector<GlobalConstraintIterator> rows;
+        rows.reserve(cg.size());
+        size_type entry_count = 0;
+        for (GlobalConstraintIterator it = cg.begin(); it != cg.end(); ++it)
+          {
+            rows.push_back(it);
+            entry_count += it->second.size();
+          }
+        std::sort(rows.begin(),rows.end(),CompareRows<GlobalConstraintIterator>());
+
+        _rows.resize(rows.size());
+        _row_offsets.resize(rows.size() + 1);
+        _entries.clear();
+        _entries.reserve(entry_count);
+        _row_offsets[0] = 0;
+        for (size_type i = 0; i < rows.size(); ++i)
+          {
+            _rows[i].first = rows[i]->first;
+            for (GlobalEntryIterator eit = rows[i]->second.begin(); eit != rows[i]->second.end(); ++eit)
+              _entries.push_back(std::make_pair(eit->first,eit->second));
+            std::sort(_entries.begin() + _row_offsets[i],_entries.end(),CompareEntries());
+            _row_offsets[i+1] = _entries.size();
+          }
+        bind_rows();
+
+        // set up the dense row lookup
+        _row_flags = RowFlags(gfs,0);
+        for (size_type i = 0; i < _rows.size(); ++i)
+          _row_flags[_rows[i].first] = i + 1;
+      }
+
+      const_iterator begin() const
+      {
+        return _rows.begin();
+      }
+
+      const_iterator end() const
+      {
+        return _rows.end();
+      }
+
+      //! Returns the constraint row of the given DOF or end() if the DOF is not constrained.
+      const_iterator find(const CI& ci) const
+      {
+        const size_type row = _row_flags[ci];
+        return row == 0 ? _rows.end() : _rows.begin() + (row - 1);
+      }
+
+      //! Returns whether the given DOF is constrained.
+      bool contains(const CI& ci) const
+      {
+        return _row_flags[ci] != 0;
+      }
+
+      //! The number of constrained DOFs.
+      size_type size() const
+      {
+        return _rows.size();
+      }
+
+      bool empty() const
+      {
+        return _rows.empty();
+      }
+
+      //! The total number of entries in all constraint rows.
+      size_type entries() const
+      {
+        return _entries.size();
+      }
+
+    private:
+
+      typedef typename BackendVectorSelector<GFS,size_type>::Type RowFlags;
+
+      template<typename It>
+      struct CompareRows
+      {
+        bool operator()(const It& a, const It& b) const
+        {
+          return a->first < b->first;
+        }
+      };
+
+      struct CompareEntries
+      {
+        bool operator()(const typename Row::value_type& a, const typename Row::value_type& b) const
+        {
+          return a.first < b.first;
+        }
+      };
+
+      // point the row views to the entries of this object
+      void bind_rows()
+      {
+        for (size_type i = 0; i < _rows.size(); ++i)
+          {
+            _rows[i].second._begin = _entries.empty() ? 0 : &_entries[0] + _row_offsets[i];
+            _rows[i].second._end = _entries.empty() ? 0 : &_entries[0] + _row_offsets[i+1];
+          }
+      }
+
+      std::vector<value_type> _rows;
+      std::vector<size_type> _row_offsets;
+      std::vector<typename Row::value_type> _entries;
+      RowFlags _row_flags;
+
+    };
+
+   //! \} group GridFunctionSpace
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_CONSTRAINTS_COMMON_COMPRESSEDCONSTRAINTSTRANSFORMATION_HH
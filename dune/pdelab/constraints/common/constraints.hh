@@ -12,6 +12,7 @@
 #include<dune/pdelab/common/typetraits.hh>
 #include<dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
 #include"constraintstransformation.hh"
+#include"compressedconstraintstransformation.hh"
 
 namespace Dune {
   namespace PDELab {
@@ -913,8 +914,8 @@ namespace Dune {
      * #include <dune/pdelab/constraints/common/constraints.hh>
      * \endcode
      */
-    template<typename CG, typename XG>
-    void copy_constrained_dofs (const CG& cg, const XG& xgin, XG& xgout)
+    template<typename CG, typename XGIN, typename XGOUT>
+    void copy_constrained_dofs (const CG& cg, const XGIN& xgin, XGOUT& xgout)
     {
       typedef typename CG::const_iterator global_col_iterator;
       for (global_col_iterator cit=cg.begin(); cit!=cg.end(); ++cit)
@@ -927,8 +928,8 @@ namespace Dune {
 #ifndef DOXYGEN
 
     // Specialized version for unconstrained spaces
-    template<typename XG>
-    void copy_constrained_dofs (const EmptyTransformation& cg, const XG& xgin, XG& xgout)
+    template<typename XGIN, typename XGOUT>
+    void copy_constrained_dofs (const EmptyTransformation& cg, const XGIN& xgin, XGOUT& xgout)
     {}
 
 #endif // DOXYGEN
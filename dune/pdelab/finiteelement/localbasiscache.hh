@@ -2,11 +2,17 @@
 #ifndef DUNE_PDELAB_LOCALBASISCACHE_HH
 #define DUNE_PDELAB_LOCALBASISCACHE_HH
 
+#include<cstddef>
 #include<vector>
 #include<map>
+#include<algorithm>
 
 #include<dune/common/exceptions.hh>
+#include<dune/common/shared_ptr.hh>
 #include<dune/common/static_assert.hh>
+#include<dune/geometry/quadraturerules.hh>
+
+#include<dune/pdelab/common/threadlocal.hh>
 
 namespace Dune {
   namespace PDELab {
@@ -70,6 +76,217 @@ namespace Dune {
       mutable JacobianCache jacobiancache;
     };
 
+    //! \brief store values of basis functions and gradients at all points of a quadrature rule
+    /**
+     * In contrast to LocalBasisCache, which looks up every single evaluation point, this cache is
+     * bound once per element (or intersection) to a local basis and a quadrature rule. The values
+     * and reference gradients of all basis functions are stored in one contiguous array each,
+     * ordered by quadrature point, and are accessed by the index of the quadrature point:
+     *
+     * \code
+     * const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,intorder);
+     * const typename Cache::Table& table = cache.bind(lfsu.finiteElement().localBasis(),rule);
+     * for (std::size_t q = 0; q < rule.size(); ++q)
+     *   {
+     *     const RangeType* phi = table.evaluateFunction(q);
+     *     const JacobianType* js = table.evaluateJacobian(q);
+     *     ...
+     *   }
+     * \endcode
+     *
+     * A table is identified by the quadrature rule (rules obtained from Dune::QuadratureRules have
+     * a fixed address for each pair of GeometryType and order), the size and the order of the
+     * local basis and, for face quadrature rules, the local face number. The address of the basis
+     * object is not used, as finite element maps may hand out temporary or recycled objects. The
+     * cache therefore assumes that all bases of type LocalBasisType with the same size and order
+     * coincide on the reference element of the rule, which holds for the Lagrange and DG bases
+     * of dune-localfunctions (orientation variants only permute the local coefficients). As the
+     * embedding of a face rule into the element may differ between intersections with the same
+     * face number (e.g. due to different orientations or on nonconforming intersections), face
+     * tables also store the embedded points and are only reused if they match.
+     *
+     * Every OpenMP thread builds and looks up its own tables (see ThreadLocal), so an operator
+     * holding a cache can be called concurrently as in the colored mode of DefaultAssembler.
+     * References to tables remain valid for the lifetime of the cache and must only be used
+     * by the thread that obtained them.
+     */
+    template<class LocalBasisType>
+    class LocalBasisQuadratureCache
+    {
+      typedef typename LocalBasisType::Traits::DomainFieldType DomainFieldType;
+      typedef typename LocalBasisType::Traits::DomainType DomainType;
+      typedef typename LocalBasisType::Traits::RangeType RangeType;
+      typedef typename LocalBasisType::Traits::JacobianType JacobianType;
+
+      static const int dim = LocalBasisType::Traits::dimDomain;
+
+    public:
+
+      typedef std::size_t size_type;
+
+      //! \brief values and reference gradients of a local basis at the points of a quadrature rule
+      class Table
+      {
+        friend class LocalBasisQuadratureCache;
+
+      public:
+
+        //! number of basis functions
+        size_type size () const
+        {
+          return _size;
+        }
+
+        //! number of quadrature points
+        size_type points () const
+        {
+          return _positions.size();
+        }
+
+        //! values of all basis functions at quadrature point q
+        const RangeType* evaluateFunction (size_type q) const
+        {
+          return _values.data() + q*_size;
+        }
+
+        //! Jacobians of all basis functions with respect to local coordinates at quadrature point q
+        const JacobianType* evaluateJacobian (size_type q) const
+        {
+          return _jacobians.data() + q*_size;
+        }
+
+      private:
+
+        const void* _rule;
+        int _face;
+        size_type _size;
+        unsigned int _order;
+        std::vector<DomainType> _positions;
+        std::vector<RangeType> _values;
+        std::vector<JacobianType> _jacobians;
+      };
+
+      //! \brief constructor
+      LocalBasisQuadratureCache () {}
+
+      //! bind to a local basis and a quadrature rule on the reference element of the basis
+      const Table& bind (const LocalBasisType& localbasis,
+                         const Dune::QuadratureRule<DomainFieldType,dim>& rule) const
+      {
+        ThreadData& data = threads.local();
+        const Table* table = find(data,localbasis,&rule,-1,false);
+        if (table)
+          return *table;
+
+        data.positions.resize(rule.size());
+        for (size_type q = 0; q < rule.size(); ++q)
+          data.positions[q] = rule[q].position();
+        return build(data,localbasis,&rule,-1);
+      }
+
+      //! bind to a local basis and a quadrature rule on a face of the reference element
+      /**
+       * \param localbasis The local basis to evaluate.
+       * \param rule       The quadrature rule on the face.
+       * \param geometry   The embedding of the face into the element, e.g. ig.geometryInInside().
+       * \param face       The local number of the face within the element.
+       */
+      template<int mydim, typename Geometry>
+      const Table& bind (const LocalBasisType& localbasis,
+                         const Dune::QuadratureRule<DomainFieldType,mydim>& rule,
+                         const Geometry& geometry, int face) const
+      {
+        dune_static_assert(mydim < dim, "face quadrature rule must have lower dimension than the element");
+
+        ThreadData& data = threads.local();
+        data.positions.resize(rule.size());
+        for (size_type q = 0; q < rule.size(); ++q)
+          data.positions[q] = geometry.global(rule[q].position());
+
+        const Table* table = find(data,localbasis,&rule,face,true);
+        if (table)
+          return *table;
+        return build(data,localbasis,&rule,face);
+      }
+
+    private:
+
+      struct ThreadData
+      {
+        ThreadData()
+          : last(0)
+        {}
+
+        std::vector<shared_ptr<Table> > tables;
+        size_type last;
+        std::vector<DomainType> positions;
+        std::vector<RangeType> values;
+        std::vector<JacobianType> jacobians;
+      };
+
+      bool matches (const ThreadData& data, const Table& table, const LocalBasisType& localbasis,
+                    const void* rule, int face, bool check_positions) const
+      {
+        if (table._rule != rule || table._face != face ||
+            table._size != localbasis.size() || table._order != localbasis.order())
+          return false;
+        if (!check_positions)
+          return true;
+        for (size_type q = 0; q < data.positions.size(); ++q)
+          {
+            DomainType diff(table._positions[q]);
+            diff -= data.positions[q];
+            if (diff.infinity_norm() > 1e-12)
+              return false;
+          }
+        return true;
+      }
+
+      // looks up the table of the previous bind first, as operators usually bind the same
+      // rule for many elements in a row
+      const Table* find (ThreadData& data, const LocalBasisType& localbasis,
+                         const void* rule, int face, bool check_positions) const
+      {
+        if (data.last < data.tables.size() &&
+            matches(data,*data.tables[data.last],localbasis,rule,face,check_positions))
+          return data.tables[data.last].get();
+        for (size_type i = 0; i < data.tables.size(); ++i)
+          if (matches(data,*data.tables[i],localbasis,rule,face,check_positions))
+            {
+              data.last = i;
+              return data.tables[i].get();
+            }
+        return 0;
+      }
+
+      const Table& build (ThreadData& data, const LocalBasisType& localbasis, const void* rule, int face) const
+      {
+        shared_ptr<Table> table_ptr = make_shared<Table>();
+        Table& table = *table_ptr;
+        table._rule = rule;
+        table._face = face;
+        table._size = localbasis.size();
+        table._order = localbasis.order();
+        table._positions = data.positions;
+        table._values.resize(data.positions.size()*table._size);
+        table._jacobians.resize(data.positions.size()*table._size);
+
+        for (size_type q = 0; q < data.positions.size(); ++q)
+          {
+            localbasis.evaluateFunction(data.positions[q],data.values);
+            localbasis.evaluateJacobian(data.positions[q],data.jacobians);
+            std::copy(data.values.begin(),data.values.end(),table._values.begin() + q*table._size);
+            std::copy(data.jacobians.begin(),data.jacobians.end(),table._jacobians.begin() + q*table._size);
+          }
+
+        data.last = data.tables.size();
+        data.tables.push_back(table_ptr);
+        return table;
+      }
+
+      ThreadLocal<ThreadData> threads;
+    };
+
   }
 }
 
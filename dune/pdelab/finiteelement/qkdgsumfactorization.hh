@@ -0,0 +1,456 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifndef DUNE_PDELAB_QKDGSUMFACTORIZATION_HH
+#define DUNE_PDELAB_QKDGSUMFACTORIZATION_HH
+
+#include<algorithm>
+#include<cstddef>
+#include<vector>
+
+#include<dune/common/fvector.hh>
+#include<dune/geometry/type.hh>
+#include<dune/geometry/quadraturerules.hh>
+
+#include<dune/pdelab/common/threadlocal.hh>
+#include<dune/pdelab/finiteelementmap/qkdg.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! \brief sum-factorized evaluation and integration for the tensor product bases of QkDGLocalFiniteElement
+    /**
+     * The basis functions of QkDGLocalFiniteElement are products of one dimensional Lagrange
+     * polynomials, and basis function i belongs to the multiindex of i with the first
+     * direction running fastest. On a tensor product quadrature rule, the values of a
+     * function at all quadrature points can therefore be computed by applying the one
+     * dimensional basis matrix along one direction after the other. This costs
+     * O(k^{d+1}) operations per element instead of O(k^{2d}) for the evaluation of every
+     * basis function at every quadrature point. The transposed sweeps perform the
+     * integration against all test functions with the same complexity.
+     *
+     * The class uses its own quadrature rule, the tensor product of the one dimensional
+     * Gauss rule of the requested order, with the first direction running fastest:
+     *
+     * \code
+     * QkDGSumFactorization<DF,RF,k,dim> kernel(intorder);
+     * kernel.evaluate(coefficients,u,gradu);          // u and reference gradients of u
+     * for (std::size_t q = 0; q < kernel.points(); ++q)
+     *   {
+     *     // evaluate the integrand at kernel.position(q), weight with kernel.weight(q)
+     *     ...
+     *   }
+     * kernel.integrate(f,g,residual);                 // residual_i += f * phi_i + g * grad phi_i
+     * \endcode
+     *
+     * The same is available on the faces of the reference cube. The points on a face are
+     * ordered in the same way, with the normal direction left out, so both elements of an
+     * intersection share one numbering of the face quadrature points as long as their
+     * local coordinate systems are aligned (see matches()).
+     *
+     * Gradients are always taken with respect to the reference element; transforming them
+     * to the real element, and transforming the integrand back before the integration, is
+     * left to the caller.
+     *
+     * The intermediate results of the sweeps are kept in one set of buffers per OpenMP thread
+     * (see ThreadLocal), so a kernel shared by several copies of a local operator may be used
+     * concurrently, e.g. in the colored mode of DefaultAssembler.
+     */
+    template<class D, class R, int k, int d>
+    class QkDGSumFactorization
+    {
+      // a one dimensional basis evaluated at a set of points, stored row by row
+      struct Matrix1D
+      {
+        std::size_t rows;
+        std::vector<R> data;
+      };
+
+    public:
+
+      //! polynomial degree in each direction
+      enum { degree = k };
+
+      typedef std::size_t size_type;
+      typedef Dune::FieldVector<D,d> DomainType;
+      typedef Dune::FieldVector<D,d-1> FaceDomainType;
+      typedef Dune::FieldVector<R,d> GradientType;
+
+      //! \brief constructor, sets up the tensor product Gauss rule of the given order
+      explicit QkDGSumFactorization (int intorder)
+      {
+        const Dune::QuadratureRule<D,1>& rule =
+          Dune::QuadratureRules<D,1>::rule(Dune::GeometryType(Dune::GeometryType::cube,1),intorder);
+        const size_type m = rule.size();
+
+        std::vector<D> x(m), w(m);
+        for (size_type q = 0; q < m; ++q)
+          {
+            x[q] = rule[q].position()[0];
+            w[q] = rule[q].weight();
+          }
+
+        // one dimensional basis at the quadrature points and at both ends of the interval
+        _values.rows = _derivatives.rows = m;
+        _values.data.resize(m*(k+1));
+        _derivatives.data.resize(m*(k+1));
+        for (size_type q = 0; q < m; ++q)
+          for (int i = 0; i <= k; ++i)
+            {
+              _values.data[q*(k+1)+i] = QkStuff::p<D,R,k>(i,x[q]);
+              _derivatives.data[q*(k+1)+i] = QkStuff::dp<D,R,k>(i,x[q]);
+            }
+        for (int side = 0; side < 2; ++side)
+          {
+            _face_values[side].rows = _face_derivatives[side].rows = 1;
+            _face_values[side].data.resize(k+1);
+            _face_derivatives[side].data.resize(k+1);
+            for (int i = 0; i <= k; ++i)
+              {
+                _face_values[side].data[i] = QkStuff::p<D,R,k>(i,D(side));
+                _face_derivatives[side].data[i] = QkStuff::dp<D,R,k>(i,D(side));
+              }
+          }
+
+        // tensor product points in the element
+        _size = 1;
+        size_type points = 1;
+        for (int j = 0; j < d; ++j)
+          {
+            _size *= k+1;
+            points *= m;
+          }
+        _positions.resize(points);
+        _weights.resize(points);
+        for (size_type q = 0; q < points; ++q)
+          {
+            _weights[q] = 1.0;
+            size_type index = q;
+            for (int j = 0; j < d; ++j)
+              {
+                _positions[q][j] = x[index % m];
+                _weights[q] *= w[index % m];
+                index /= m;
+              }
+          }
+
+        // tensor product points on the faces
+        const size_type facepoints = points/m;
+        _face_positions.resize(facepoints);
+        _face_weights.resize(facepoints);
+        for (size_type q = 0; q < facepoints; ++q)
+          {
+            _face_weights[q] = 1.0;
+            size_type index = q;
+            for (int j = 0; j < d-1; ++j)
+              {
+                _face_positions[q][j] = x[index % m];
+                _face_weights[q] *= w[index % m];
+                index /= m;
+              }
+          }
+        for (int face = 0; face < 2*d; ++face)
+          {
+            const int normal = face/2;
+            _face_positions_in_element[face].resize(facepoints);
+            for (size_type q = 0; q < facepoints; ++q)
+              for (int j = 0, l = 0; j < d; ++j)
+                _face_positions_in_element[face][q][j] = (j == normal) ? D(face%2) : _face_positions[q][l++];
+          }
+
+        _buffersize = 1;
+        for (int j = 0; j < d; ++j)
+          _buffersize *= std::max(size_type(k+1),m);
+      }
+
+      //! number of basis functions
+      size_type size () const
+      {
+        return _size;
+      }
+
+      //! number of quadrature points in the element
+      size_type points () const
+      {
+        return _positions.size();
+      }
+
+      //! quadrature point q in local coordinates of the element
+      const DomainType& position (size_type q) const
+      {
+        return _positions[q];
+      }
+
+      //! weight of quadrature point q in the element
+      D weight (size_type q) const
+      {
+        return _weights[q];
+      }
+
+      //! number of quadrature points on a face
+      size_type facePoints () const
+      {
+        return _face_positions.size();
+      }
+
+      //! face quadrature point q in local coordinates of the face
+      const FaceDomainType& facePosition (size_type q) const
+      {
+        return _face_positions[q];
+      }
+
+      //! face quadrature point q in local coordinates of the element, on the given face of the element
+      const DomainType& facePosition (int face, size_type q) const
+      {
+        return _face_positions_in_element[face][q];
+      }
+
+      //! weight of face quadrature point q
+      D faceWeight (size_type q) const
+      {
+        return _face_weights[q];
+      }
+
+      //! check whether the embedding of a face into an element maps the face points of the kernel onto the given face
+      /**
+       * \param face     The local number of the face within the element.
+       * \param geometry The embedding of the face, e.g. ig.geometryInInside().
+       */
+      template<typename Geometry>
+      bool matches (int face, const Geometry& geometry) const
+      {
+        for (size_type q = 0; q < facePoints(); ++q)
+          {
+            DomainType diff = geometry.global(_face_positions[q]);
+            diff -= _face_positions_in_element[face][q];
+            if (diff.infinity_norm() > 1e-10)
+              return false;
+          }
+        return true;
+      }
+
+      //! values and reference gradients of a function at all quadrature points of the element
+      /**
+       * \param coefficients The size() coefficients of the function.
+       * \param values       Array of points() values, may be null.
+       * \param gradients    Array of points() gradients, may be null.
+       */
+      void evaluate (const R* coefficients, R* values, GradientType* gradients) const
+      {
+        Buffers& buffers = workspace();
+        const Matrix1D* matrices[d];
+        if (values)
+          {
+            for (int j = 0; j < d; ++j)
+              matrices[j] = &_values;
+            sweep(buffers,matrices,false,coefficients,values,false);
+          }
+        if (gradients)
+          for (int l = 0; l < d; ++l)
+            {
+              for (int j = 0; j < d; ++j)
+                matrices[j] = (j == l) ? &_derivatives : &_values;
+              sweep(buffers,matrices,false,coefficients,buffers.component.data(),false);
+              for (size_type q = 0; q < points(); ++q)
+                gradients[q][l] = buffers.component[q];
+            }
+      }
+
+      //! integrate against all basis functions on the element
+      /**
+       * Adds \f$\sum_q f_q \phi_i(x_q) + g_q \cdot \hat\nabla\phi_i(x_q)\f$ to entry i of
+       * the residual. The quadrature weights have to be included in f and g.
+       *
+       * \param values    Array of points() values f, may be null.
+       * \param gradients Array of points() vectors g, may be null.
+       * \param residual  The size() entries to add to.
+       */
+      void integrate (const R* values, const GradientType* gradients, R* residual) const
+      {
+        Buffers& buffers = workspace();
+        const Matrix1D* matrices[d];
+        if (values)
+          {
+            for (int j = 0; j < d; ++j)
+              matrices[j] = &_values;
+            sweep(buffers,matrices,true,values,residual,true);
+          }
+        if (gradients)
+          for (int l = 0; l < d; ++l)
+            {
+              for (size_type q = 0; q < points(); ++q)
+                buffers.component[q] = gradients[q][l];
+              for (int j = 0; j < d; ++j)
+                matrices[j] = (j == l) ? &_derivatives : &_values;
+              sweep(buffers,matrices,true,buffers.component.data(),residual,true);
+            }
+      }
+
+      //! values and reference gradients of a function at all quadrature points of a face
+      /**
+       * Same as evaluate(), with arrays of facePoints() entries.
+       */
+      void evaluateFace (int face, const R* coefficients, R* values, GradientType* gradients) const
+      {
+        const int normal = face/2;
+        const int side = face%2;
+        Buffers& buffers = workspace();
+        const Matrix1D* matrices[d];
+        if (values)
+          {
+            for (int j = 0; j < d; ++j)
+              matrices[j] = (j == normal) ? &_face_values[side] : &_values;
+            sweep(buffers,matrices,false,coefficients,values,false);
+          }
+        if (gradients)
+          for (int l = 0; l < d; ++l)
+            {
+              for (int j = 0; j < d; ++j)
+                if (j == normal)
+                  matrices[j] = (j == l) ? &_face_derivatives[side] : &_face_values[side];
+                else
+                  matrices[j] = (j == l) ? &_derivatives : &_values;
+              sweep(buffers,matrices,false,coefficients,buffers.component.data(),false);
+              for (size_type q = 0; q < facePoints(); ++q)
+                gradients[q][l] = buffers.component[q];
+            }
+      }
+
+      //! integrate against all basis functions on a face
+      /**
+       * Same as integrate(), with arrays of facePoints() entries.
+       */
+      void integrateFace (int face, const R* values, const GradientType* gradients, R* residual) const
+      {
+        const int normal = face/2;
+        const int side = face%2;
+        Buffers& buffers = workspace();
+        const Matrix1D* matrices[d];
+        if (values)
+          {
+            for (int j = 0; j < d; ++j)
+              matrices[j] = (j == normal) ? &_face_values[side] : &_values;
+            sweep(buffers,matrices,true,values,residual,true);
+          }
+        if (gradients)
+          for (int l = 0; l < d; ++l)
+            {
+              for (size_type q = 0; q < facePoints(); ++q)
+                buffers.component[q] = gradients[q][l];
+              for (int j = 0; j < d; ++j)
+                if (j == normal)
+                  matrices[j] = (j == l) ? &_face_derivatives[side] : &_face_values[side];
+                else
+                  matrices[j] = (j == l) ? &_derivatives : &_values;
+              sweep(buffers,matrices,true,buffers.component.data(),residual,true);
+            }
+      }
+
+    private:
+
+      // intermediate results of the sweeps
+      struct Buffers
+      {
+        std::vector<R> sweep[2];
+        std::vector<R> component;
+      };
+
+      // returns the buffers of the calling thread, allocating them on first use
+      Buffers& workspace () const
+      {
+        Buffers& buffers = _buffers.local();
+        if (buffers.component.size() != points())
+          {
+            buffers.sweep[0].resize(_buffersize);
+            buffers.sweep[1].resize(_buffersize);
+            buffers.component.resize(points());
+          }
+        return buffers;
+      }
+
+      // applies one matrix per direction, or its transpose, to the tensor in; the result is
+      // written to (or added to) out
+      void sweep (Buffers& buffers, const Matrix1D* const* matrices, bool transpose,
+                  const R* in, R* out, bool add) const
+      {
+        size_type extent[d];
+        for (int j = 0; j < d; ++j)
+          extent[j] = transpose ? matrices[j]->rows : k+1;
+
+        const R* src = in;
+        for (int j = 0; j < d; ++j)
+          {
+            const bool last = (j == d-1);
+            R* dst = last ? out : buffers.sweep[j%2].data();
+            apply(*matrices[j],transpose,j,extent,src,dst,last && add);
+            src = dst;
+          }
+      }
+
+      // applies a matrix along one direction of a tensor with the first direction running fastest
+      void apply (const Matrix1D& matrix, bool transpose, int direction, size_type* extent,
+                  const R* in, R* out, bool add) const
+      {
+        const size_type cols = k+1;
+        const size_type n_in = extent[direction];
+        const size_type n_out = transpose ? cols : matrix.rows;
+        size_type inner = 1;
+        size_type outer = 1;
+        for (int j = 0; j < direction; ++j)
+          inner *= extent[j];
+        for (int j = direction+1; j < d; ++j)
+          outer *= extent[j];
+
+        for (size_type o = 0; o < outer; ++o)
+          for (size_type r = 0; r < n_out; ++r)
+            {
+              R* y = out + (o*n_out + r)*inner;
+              if (!add)
+                for (size_type s = 0; s < inner; ++s)
+                  y[s] = 0.0;
+              for (size_type c = 0; c < n_in; ++c)
+                {
+                  const R a = transpose ? matrix.data[c*cols + r] : matrix.data[r*cols + c];
+                  const R* x = in + (o*n_in + c)*inner;
+                  for (size_type s = 0; s < inner; ++s)
+                    y[s] += a*x[s];
+                }
+            }
+        extent[direction] = n_out;
+      }
+
+      size_type _size;
+      Matrix1D _values;
+      Matrix1D _derivatives;
+      Matrix1D _face_values[2];
+      Matrix1D _face_derivatives[2];
+      std::vector<DomainType> _positions;
+      std::vector<D> _weights;
+      std::vector<FaceDomainType> _face_positions;
+      std::vector<DomainType> _face_positions_in_element[2*d];
+      std::vector<D> _face_weights;
+      size_type _buffersize;
+      ThreadLocal<Buffers> _buffers;
+    };
+
+    //! \brief tells whether the basis of a finite element map supports QkDGSumFactorization
+    /**
+     * Local operators can use this to opt into the sum-factorized kernels. The member
+     * Kernel is the matching QkDGSumFactorization, or void if the map is not supported.
+     */
+    template<typename FiniteElementMap>
+    struct QkDGSumFactorizationTraits
+    {
+      enum { available = false };
+      typedef void Kernel;
+    };
+
+    template<class D, class R, int k, int d>
+    struct QkDGSumFactorizationTraits<QkDGLocalFiniteElementMap<D,R,k,d> >
+    {
+      enum { available = true };
+      typedef QkDGSumFactorization<D,R,k,d> Kernel;
+    };
+
+  }
+}
+
+#endif
@@ -0,0 +1,408 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_GRIDFUNCTIONSPACE_COMMUNICATIONSCHEDULE_HH
+#define DUNE_PDELAB_GRIDFUNCTIONSPACE_COMMUNICATIONSCHEDULE_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/common/datahandleif.hh>
+#include <dune/grid/common/gridenums.hh>
+
+#include <dune/pdelab/common/mpicommunicator.hh>
+#include <dune/pdelab/common/performancetrace.hh>
+#include <dune/pdelab/gridfunctionspace/entityindexcache.hh>
+#include <dune/pdelab/gridfunctionspace/genericdatahandle.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! Precomputed schedule for exchanging DOF data of a grid function space.
+    /**
+     * Communicating a GFSDataHandle through the grid walks all interface entities,
+     * looks up their DOFs and packs the message buffers entity by entity on every
+     * call. For the DOF-wise exchanges used by the parallel solvers (adding up or
+     * copying vector entries), this work only depends on the DOF layout of the space,
+     * so this class does it once: it stores, for every neighboring process, the
+     * container indices to send and the container indices to apply the received
+     * values to, both ordered by the global id of the associated entity. An exchange
+     * then packs and unpacks contiguous buffers and uses persistent MPI requests.
+     *
+     * The data is combined with the same GatherScatter functors as used by the
+     * generic data handles, e.g.
+     *
+     * \code
+     * GFSCommunicationSchedule<GFS> schedule(gfs,InteriorBorder_InteriorBorder_Interface);
+     * schedule.communicate(v,AddGatherScatter());  // same as communicating an AddDataHandle
+     * \endcode
+     *
+     * If the grid does not communicate through MPI, communicate() falls back to
+     * communicating a GFSDataHandle through the grid. The schedule has to be rebuilt
+     * after the grid function space has changed.
+     *
+     * \tparam GFS The grid function space.
+     */
+    template<typename GFS>
+    class GFSCommunicationSchedule
+    {
+
+      typedef typename GFS::Traits::GridViewType GridView;
+      typedef typename GridView::Grid::GlobalIdSet::IdType IdType;
+      typedef typename GFS::Ordering::Traits::ContainerIndex ContainerIndex;
+
+      // DOFs attached to a single shared entity as seen from one neighbor
+      struct EntityRecord
+      {
+        IdType id;
+        std::size_t remote_size;
+        std::vector<ContainerIndex> container_indices;
+
+        bool operator<(const EntityRecord& r) const
+        {
+          return id < r.id;
+        }
+      };
+
+      typedef std::map<int,std::vector<EntityRecord> > EntityRecords;
+
+      //! Collects the DOFs of the entities shared with other processes, tagged with the remote rank.
+      class EntityCollector
+        : public CommDataHandleIF<EntityCollector,std::size_t>
+      {
+
+      public:
+
+        typedef std::size_t DataType;
+
+        bool contains(int dim, int codim) const
+        {
+          return _gfs.dataHandleContains(codim);
+        }
+
+        bool fixedsize(int dim, int codim) const
+        {
+          return true;
+        }
+
+        template<typename Entity>
+        std::size_t size(const Entity& e) const
+        {
+          return 2;
+        }
+
+        template<typename MessageBuffer, typename Entity>
+        void gather(MessageBuffer& buff, const Entity& e) const
+        {
+          _index_cache.update(e);
+          buff.write(static_cast<std::size_t>(_gfs.gridView().comm().rank()));
+          buff.write(_index_cache.size());
+        }
+
+        template<typename MessageBuffer, typename Entity>
+        void scatter(MessageBuffer& buff, const Entity& e, std::size_t n)
+        {
+          std::size_t rank, remote_size;
+          buff.read(rank);
+          buff.read(remote_size);
+
+          _index_cache.update(e);
+          // like DataGatherScatter, only apply received data to entities in partitions of the
+          // space; the DOFs of all other entities are received and discarded
+          if (!_gfs.containsPartition(e.partitionType()))
+            {
+              if (_index_cache.size() != 0)
+                DUNE_THROW(Exception,"expected no DOFs in partition '" << e.partitionType()
+                           << "', but have " << _index_cache.size());
+            }
+          else if (_check_sizes && _index_cache.size() > 0 && _index_cache.size() != remote_size)
+            DUNE_THROW(Exception,"size mismatch in GridFunctionSpace communication schedule, have "
+                       << _index_cache.size() << " DOFs, but neighbor sends " << remote_size);
+
+          EntityRecord record;
+          record.id = _gfs.gridView().grid().globalIdSet().id(e);
+          record.remote_size = remote_size;
+          record.container_indices.resize(_index_cache.size());
+          for (std::size_t i = 0; i < _index_cache.size(); ++i)
+            record.container_indices[i] = _index_cache.containerIndex(i);
+          _records[rank].push_back(record);
+        }
+
+        EntityCollector(const GFS& gfs, EntityRecords& records, bool check_sizes)
+          : _gfs(gfs)
+          , _index_cache(gfs)
+          , _records(records)
+          , _check_sizes(check_sizes)
+        {}
+
+      private:
+
+        const GFS& _gfs;
+        mutable EntityIndexCache<GFS> _index_cache;
+        EntityRecords& _records;
+        const bool _check_sizes;
+
+      };
+
+      //! Message buffer for the GatherScatter functors working on a contiguous array.
+      template<typename E>
+      class ArrayMessageBuffer
+      {
+
+      public:
+
+        explicit ArrayMessageBuffer(E* data)
+          : _pos(data)
+        {}
+
+        void write(const E& data)
+        {
+          *_pos++ = data;
+        }
+
+        void read(E& data)
+        {
+          data = *_pos++;
+        }
+
+      private:
+
+        E* _pos;
+
+      };
+
+      struct Neighbor
+      {
+        int rank;
+        std::vector<ContainerIndex> send_indices;
+        std::vector<ContainerIndex> recv_indices;
+        // false for received values without local DOFs, which are discarded
+        std::vector<char> recv_valid;
+      };
+
+      enum { tag = 4713 };
+
+    public:
+
+      //! Builds the schedule for communicating DOF data of gfs over the given interface.
+      /**
+       * This performs two communications through the grid, so it has to be called
+       * collectively on all processes.
+       */
+      GFSCommunicationSchedule(const GFS& gfs, InterfaceType interface, CommunicationDirection direction = ForwardCommunication)
+        : _gfs(gfs)
+        , _interface(interface)
+        , _direction(direction)
+#if HAVE_MPI
+        , _comm(mpiCommunicator(gfs.gridView().comm()))
+        , _element_size(0)
+#endif
+      {
+#if HAVE_MPI
+        if (_comm == MPI_COMM_NULL)
+          return;
+
+        PerformanceTrace::Region region("communication setup","communication");
+
+        // the entities we receive data for are those we receive something for in the given
+        // direction, the entities we send data for are those we receive something for in the
+        // opposite direction
+        EntityRecords recv_records, send_records;
+        {
+          EntityCollector collector(gfs,recv_records,true);
+          gfs.gridView().communicate(collector,interface,direction);
+        }
+        {
+          EntityCollector collector(gfs,send_records,false);
+          gfs.gridView().communicate(collector,interface,
+                                     direction == ForwardCommunication ? BackwardCommunication : ForwardCommunication);
+        }
+
+        std::map<int,Neighbor> neighbors;
+
+        // both sides order the DOFs by the global id of their entity
+        for (typename EntityRecords::iterator it = send_records.begin(); it != send_records.end(); ++it)
+          {
+            std::sort(it->second.begin(),it->second.end());
+            Neighbor& neighbor = neighbors[it->first];
+            neighbor.rank = it->first;
+            for (typename std::vector<EntityRecord>::const_iterator rit = it->second.begin(); rit != it->second.end(); ++rit)
+              neighbor.send_indices.insert(neighbor.send_indices.end(),rit->container_indices.begin(),rit->container_indices.end());
+          }
+
+        for (typename EntityRecords::iterator it = recv_records.begin(); it != recv_records.end(); ++it)
+          {
+            std::sort(it->second.begin(),it->second.end());
+            Neighbor& neighbor = neighbors[it->first];
+            neighbor.rank = it->first;
+            for (typename std::vector<EntityRecord>::const_iterator rit = it->second.begin(); rit != it->second.end(); ++rit)
+              {
+                if (rit->container_indices.empty())
+                  {
+                    neighbor.recv_indices.resize(neighbor.recv_indices.size() + rit->remote_size);
+                    neighbor.recv_valid.resize(neighbor.recv_valid.size() + rit->remote_size,0);
+                  }
+                else
+                  {
+                    neighbor.recv_indices.insert(neighbor.recv_indices.end(),rit->container_indices.begin(),rit->container_indices.end());
+                    neighbor.recv_valid.resize(neighbor.recv_valid.size() + rit->container_indices.size(),1);
+                  }
+              }
+          }
+
+        for (typename std::map<int,Neighbor>::const_iterator it = neighbors.begin(); it != neighbors.end(); ++it)
+          if (!it->second.send_indices.empty() || !it->second.recv_indices.empty())
+            _neighbors.push_back(it->second);
+#endif // HAVE_MPI
+      }
+
+      ~GFSCommunicationSchedule()
+      {
+#if HAVE_MPI
+        freeRequests();
+#endif
+      }
+
+      //! Exchanges the entries of v and combines them using gather_scatter.
+      /**
+       * This has the same effect as communicating a GFSDataHandle using
+       * DataGatherScatter<GatherScatter> over the interface of the schedule.
+       */
+      template<typename V, typename GatherScatter>
+      void communicate(V& v, GatherScatter gather_scatter) const
+      {
+#if HAVE_MPI
+        if (_comm != MPI_COMM_NULL)
+          {
+            typedef typename V::ElementType E;
+            setupRequests(sizeof(E));
+
+            ArrayMessageBuffer<E> send_buffer(reinterpret_cast<E*>(_send_buffer.empty() ? 0 : &_send_buffer[0]));
+            for (typename std::vector<Neighbor>::const_iterator it = _neighbors.begin(); it != _neighbors.end(); ++it)
+              for (std::size_t i = 0; i < it->send_indices.size(); ++i)
+                gather_scatter.gather(send_buffer,v[it->send_indices[i]]);
+
+            if (!_requests.empty())
+              {
+                MPI_Startall(_requests.size(),&_requests[0]);
+                MPI_Waitall(_requests.size(),&_requests[0],MPI_STATUSES_IGNORE);
+              }
+
+            ArrayMessageBuffer<E> recv_buffer(reinterpret_cast<E*>(_recv_buffer.empty() ? 0 : &_recv_buffer[0]));
+            for (typename std::vector<Neighbor>::const_iterator it = _neighbors.begin(); it != _neighbors.end(); ++it)
+              for (std::size_t i = 0; i < it->recv_indices.size(); ++i)
+                if (it->recv_valid[i])
+                  gather_scatter.scatter(recv_buffer,v[it->recv_indices[i]]);
+                else
+                  {
+                    E dummy;
+                    recv_buffer.read(dummy);
+                  }
+            return;
+          }
+#endif // HAVE_MPI
+
+        GFSDataHandle<GFS,V,DataGatherScatter<GatherScatter> > data_handle(_gfs,v,DataGatherScatter<GatherScatter>(gather_scatter));
+        _gfs.gridView().communicate(data_handle,_interface,_direction);
+      }
+
+      //! The grid function space of the schedule.
+      const GFS& gridFunctionSpace() const
+      {
+        return _gfs;
+      }
+
+      //! The interface the schedule communicates over.
+      InterfaceType interface() const
+      {
+        return _interface;
+      }
+
+      //! The number of processes this process exchanges data with.
+      std::size_t neighbors() const
+      {
+#if HAVE_MPI
+        return _neighbors.size();
+#else
+        return 0;
+#endif
+      }
+
+    private:
+
+      GFSCommunicationSchedule(const GFSCommunicationSchedule&);
+      GFSCommunicationSchedule& operator=(const GFSCommunicationSchedule&);
+
+#if HAVE_MPI
+
+      // (re)creates the buffers and persistent requests for values of the given size
+      void setupRequests(std::size_t element_size) const
+      {
+        if (element_size == _element_size)
+          return;
+
+        freeRequests();
+        _element_size = element_size;
+
+        std::size_t send_size = 0, recv_size = 0;
+        for (typename std::vector<Neighbor>::const_iterator it = _neighbors.begin(); it != _neighbors.end(); ++it)
+          {
+            send_size += it->send_indices.size();
+            recv_size += it->recv_indices.size();
+          }
+        _send_buffer.resize(send_size * element_size);
+        _recv_buffer.resize(recv_size * element_size);
+
+        std::size_t send_offset = 0, recv_offset = 0;
+        for (typename std::vector<Neighbor>::const_iterator it = _neighbors.begin(); it != _neighbors.end(); ++it)
+          {
+            if (!it->recv_indices.empty())
+              {
+                _requests.push_back(MPI_Request());
+                MPI_Recv_init(&_recv_buffer[recv_offset],it->recv_indices.size() * element_size,MPI_BYTE,
+                              it->rank,tag,_comm,&_requests.back());
+                recv_offset += it->recv_indices.size() * element_size;
+              }
+            if (!it->send_indices.empty())
+              {
+                _requests.push_back(MPI_Request());
+                MPI_Send_init(&_send_buffer[send_offset],it->send_indices.size() * element_size,MPI_BYTE,
+                              it->rank,tag,_comm,&_requests.back());
+                send_offset += it->send_indices.size() * element_size;
+              }
+          }
+      }
+
+      void freeRequests() const
+      {
+        for (std::size_t i = 0; i < _requests.size(); ++i)
+          MPI_Request_free(&_requests[i]);
+        _requests.clear();
+        _element_size = 0;
+      }
+
+#endif // HAVE_MPI
+
+      const GFS& _gfs;
+      const InterfaceType _interface;
+      const CommunicationDirection _direction;
+#if HAVE_MPI
+      const MPI_Comm _comm;
+      std::vector<Neighbor> _neighbors;
+      // the buffers are allocated with new, so they are suitably aligned for all element types
+      mutable std::vector<char> _send_buffer;
+      mutable std::vector<char> _recv_buffer;
+      mutable std::vector<MPI_Request> _requests;
+      mutable std::size_t _element_size;
+#endif
+
+    };
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_GRIDFUNCTIONSPACE_COMMUNICATIONSCHEDULE_HH
@@ -0,0 +1,219 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_GRIDFUNCTIONSPACE_CONNECTIVITYTABLE_HH
+#define DUNE_PDELAB_GRIDFUNCTIONSPACE_CONNECTIVITYTABLE_HH
+
+#include <cstddef>
+#include <vector>
+
+#include <dune/pdelab/common/elementmapper.hh>
+#include <dune/pdelab/common/performancetrace.hh>
+#include <dune/pdelab/constraints/common/constraintstransformation.hh>
+#include <dune/pdelab/gridfunctionspace/lfsindexcache.hh>
+#include <dune/pdelab/gridfunctionspace/localfunctionspace.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! Precomputed container indices and constraint flags of all cells of a grid function space.
+    /**
+     * Updating an LFSIndexCache after binding its local function space maps every DOF index
+     * of the cell to a container index through the ordering and looks up every DOF in the
+     * constraints container. Both only depend on the DOF layout of the space and on the
+     * constraints, so this table does it once for all cells of the grid view: it stores the
+     * container indices of each cell contiguously, in the order of the DOFs of the bound root
+     * local function space, together with one flag per DOF telling whether it is constrained
+     * and whether the constraint is of Dirichlet type. The cells are numbered like the
+     * ElementMapper of the grid view. An index cache can then be updated from the table
+     * (see LFSIndexCache::update(table,cell)), which copies a contiguous span and only has
+     * to look up the rows of DOFs with non-Dirichlet constraints, e.g. hanging nodes:
+     *
+     * \code
+     * GFSConnectivityTable<GFS> table(gfs,cc);
+     * lfs.bind(e);
+     * lfs_cache.update(table,cell_mapper.map(e));   // same as lfs_cache.update()
+     * \endcode
+     *
+     * The table has to be rebuilt with assign() after the grid function space or the
+     * constraints have changed. valid() detects changes of the space via
+     * GridFunctionSpace::revision() and of the constraints by comparing the address and the
+     * number of constrained DOFs of the container. Constraints recomputed in place with the
+     * same number of constrained DOFs go unnoticed, the table has to be rebuilt explicitly then.
+     *
+     * \tparam GFS The grid function space.
+     */
+    template<typename GFS>
+    class GFSConnectivityTable
+    {
+
+      typedef typename GFS::Traits::GridViewType GV;
+      typedef typename GV::template Codim<0>::Iterator ElementIterator;
+
+    public:
+
+      typedef typename GFS::Ordering::Traits::ContainerIndex ContainerIndex;
+      typedef std::size_t size_type;
+
+      //! Flags stored for every DOF.
+      enum DOFFlags
+        {
+          nonconstrained = 0,
+          constrained = 1<<0,
+          dirichlet = 1<<1
+        };
+
+      //! Creates an empty table, which has to be built with assign() before use.
+      GFSConnectivityTable()
+        : _gfs(0)
+        , _revision(0)
+        , _constraints(0)
+        , _constraints_size(0)
+      {}
+
+      //! Builds the table for a space without constraints.
+      explicit GFSConnectivityTable(const GFS& gfs)
+        : _gfs(0)
+        , _revision(0)
+        , _constraints(0)
+        , _constraints_size(0)
+      {
+        assign(gfs);
+      }
+
+      //! Builds the table for a space and its constraints container.
+      template<typename C>
+      GFSConnectivityTable(const GFS& gfs, const C& c)
+        : _gfs(0)
+        , _revision(0)
+        , _constraints(0)
+        , _constraints_size(0)
+      {
+        assign(gfs,c);
+      }
+
+      //! Rebuilds the table for a space without constraints.
+      void assign(const GFS& gfs)
+      {
+        assign(gfs,EmptyTransformation());
+        _constraints = 0;
+      }
+
+      //! Rebuilds the table for a space and its constraints container.
+      template<typename C>
+      void assign(const GFS& gfs, const C& c)
+      {
+        PerformanceTrace::Region region("connectivity table","assembly");
+
+        typedef LocalFunctionSpace<GFS> LFS;
+        LFS lfs(gfs);
+        LFSIndexCache<LFS,C> lfs_cache(lfs,c);
+
+        const GV& gv = gfs.gridView();
+        ElementMapper<GV> cell_mapper(gv);
+
+        _offsets.assign(gv.indexSet().size(0) + 1,0);
+        _container_indices.clear();
+        _dof_flags.clear();
+
+        // bind the cells in the order of the traversal, but store them by cell index
+        std::vector<size_type> cell_begin(_offsets.size() - 1);
+        for (ElementIterator it = gv.template begin<0>(); it != gv.template end<0>(); ++it)
+          {
+            lfs.bind(*it);
+            lfs_cache.update();
+            const size_type cell = cell_mapper.map(*it);
+            cell_begin[cell] = _container_indices.size();
+            _offsets[cell+1] = lfs_cache.size();
+            for (size_type i = 0; i < lfs_cache.size(); ++i)
+              {
+                _container_indices.push_back(lfs_cache.containerIndex(i));
+                _dof_flags.push_back(
+                  (lfs_cache.isConstrained(i) ? constrained : nonconstrained) |
+                  (lfs_cache.isDirichletConstraint(i) ? dirichlet : nonconstrained));
+              }
+          }
+
+        // sort the spans by cell index
+        for (size_type cell = 0; cell + 1 < _offsets.size(); ++cell)
+          _offsets[cell+1] += _offsets[cell];
+        std::vector<ContainerIndex> container_indices(_container_indices.size());
+        std::vector<unsigned char> dof_flags(_dof_flags.size());
+        for (size_type cell = 0; cell + 1 < _offsets.size(); ++cell)
+          for (size_type k = 0; k < _offsets[cell+1] - _offsets[cell]; ++k)
+            {
+              container_indices[_offsets[cell] + k] = _container_indices[cell_begin[cell] + k];
+              dof_flags[_offsets[cell] + k] = _dof_flags[cell_begin[cell] + k];
+            }
+        _container_indices.swap(container_indices);
+        _dof_flags.swap(dof_flags);
+
+        _gfs = &gfs;
+        _revision = gfs.revision();
+        _constraints = &c;
+        _constraints_size = c.size();
+      }
+
+      //! Returns whether the table has been built without constraints for the current state of gfs.
+      bool valid(const GFS& gfs) const
+      {
+        return _gfs == &gfs && _revision == gfs.revision() && _constraints == 0;
+      }
+
+      //! Returns whether the table has been built for the current state of gfs and the constraints c.
+      template<typename C>
+      bool valid(const GFS& gfs, const C& c) const
+      {
+        return _gfs == &gfs && _revision == gfs.revision() &&
+          _constraints == &c && _constraints_size == c.size();
+      }
+
+      //! Releases the memory of the table.
+      void clear()
+      {
+        _gfs = 0;
+        _constraints = 0;
+        _offsets.clear();
+        _container_indices.clear();
+        _dof_flags.clear();
+      }
+
+      //! Returns the number of cells.
+      size_type cells() const
+      {
+        return _offsets.empty() ? 0 : _offsets.size() - 1;
+      }
+
+      //! Returns the number of DOFs of a cell.
+      size_type size(size_type cell) const
+      {
+        return _offsets[cell+1] - _offsets[cell];
+      }
+
+      //! Returns the container indices of the DOFs of a cell.
+      const ContainerIndex* containerIndices(size_type cell) const
+      {
+        return _container_indices.empty() ? 0 : &_container_indices[0] + _offsets[cell];
+      }
+
+      //! Returns the flags of the DOFs of a cell, a combination of the values of DOFFlags.
+      const unsigned char* dofFlags(size_type cell) const
+      {
+        return _dof_flags.empty() ? 0 : &_dof_flags[0] + _offsets[cell];
+      }
+
+    private:
+
+      const GFS* _gfs;
+      std::size_t _revision;
+      const void* _constraints;
+      size_type _constraints_size;
+      std::vector<size_type> _offsets;
+      std::vector<ContainerIndex> _container_indices;
+      std::vector<unsigned char> _dof_flags;
+
+    };
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_GRIDFUNCTIONSPACE_CONNECTIVITYTABLE_HH
@@ -3,6 +3,8 @@
 #ifndef DUNE_PDELAB_GRIDFUNCTIONSPACE_GRIDFUNCTIONSPACEBASE_HH
 #define DUNE_PDELAB_GRIDFUNCTIONSPACE_GRIDFUNCTIONSPACEBASE_HH
 
+#include <cstddef>
+
 #include <dune/typetree/visitor.hh>
 #include <dune/typetree/traversal.hh>
 
@@ -66,6 +68,7 @@ namespace Dune {
           , _is_root_space(true)
           , _initialized(false)
           , _size_available(true)
+          , _revision(0)
         {}
 
         size_type _size;
@@ -75,6 +78,7 @@ namespace Dune {
         bool _is_root_space;
         bool _initialized;
         bool _size_available;
+        std::size_t _revision;
 
       };
 
@@ -101,6 +105,7 @@ namespace Dune {
               data._max_local_size = _max_local_size;
               data._size_available = ordering.update_gfs_data_size(data._size,data._block_count);
               data.setPartitionSet(ordering);
+              ++data._revision;
             }
         }
 
@@ -226,6 +231,16 @@ namespace Dune {
         return PartitionInfoProvider::containsPartition(partition);
       }
 
+      //! Returns a counter that is incremented every time the ordering of this space is updated.
+      /**
+       * Objects that derive data from the DOF numbering (e.g. matrix patterns) can store the
+       * revision at construction time and compare it later to detect that their data is stale.
+       */
+      std::size_t revision() const
+      {
+        return _revision;
+      }
+
       void update()
       {
         // We bypass the normal access using ordering() here to avoid a double
@@ -308,6 +323,7 @@ namespace Dune {
       using BaseT::_is_root_space;
       using BaseT::_initialized;
       using BaseT::_size_available;
+      using BaseT::_revision;
 
     };
 
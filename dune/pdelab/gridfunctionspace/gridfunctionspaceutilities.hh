@@ -10,6 +10,8 @@
 #include <dune/common/fvector.hh>
 #include <dune/common/static_assert.hh>
 
+#include <dune/geometry/type.hh>
+
 #include <dune/localfunctions/common/interfaceswitch.hh>
 
 #include"../common/function.hh"
@@ -29,6 +31,52 @@ namespace Dune {
     // output: convert grid function space to discrete grid function
     //===============================================================
 
+#ifndef DOXYGEN
+
+    namespace impl {
+
+      // Remembers the element a local function space has been bound to, so
+      // that repeated evaluations on the same element (VTK output, quadrature
+      // loops, probes) skip the binding and the update of the index cache.
+      template<typename GFS>
+      class LastElementBinding
+      {
+        typedef typename GFS::Traits::GridViewType::IndexSet::IndexType IndexType;
+
+      public:
+
+        LastElementBinding()
+          : _bound(false)
+          , _index(0)
+          , _revision(0)
+        {}
+
+        template<typename LFS, typename LFSCache, typename E>
+        void bind(const GFS& gfs, LFS& lfs, LFSCache& lfs_cache, const E& e)
+        {
+          const IndexType index = gfs.gridView().indexSet().index(e);
+          if (_bound && index == _index && e.type() == _type && gfs.revision() == _revision)
+            return;
+          lfs.bind(e);
+          lfs_cache.update();
+          _bound = true;
+          _index = index;
+          _type = e.type();
+          _revision = gfs.revision();
+        }
+
+      private:
+
+        bool _bound;
+        IndexType _index;
+        GeometryType _type;
+        std::size_t _revision;
+      };
+
+    } // namespace impl
+
+#endif // DOXYGEN
+
 
     /** \brief convert a grid function space and a coefficient vector into a
      *         grid function
@@ -47,6 +95,12 @@ namespace Dune {
      * spaces, and want to collectively treat them as a vector-valued
      * grid-function, look at VectorDiscreteGridFunction.
      *
+     * The local function space stays bound to the last element evaluated
+     * on, so consecutive evaluations on the same element only read the
+     * coefficients.  Changes to the coefficient vector are therefore seen
+     * by the next evaluation.  To evaluate at many points of one element,
+     * use the overload of evaluate() taking vectors of points and values.
+     *
      * \tparam T Type of GridFunctionSpace
      * \tparam X Type of coefficients vector
      */
@@ -131,20 +185,23 @@ namespace Dune {
                             const typename Traits::DomainType& x,
                             typename Traits::RangeType& y) const
       {
-        typedef FiniteElementInterfaceSwitch<
-          typename Dune::PDELab::LocalFunctionSpace<GFS>::Traits::FiniteElementType
-          > FESwitch;
-        lfs.bind(e);
-        lfs_cache.update();
-        x_view.bind(lfs_cache);
-        x_view.read(xl);
-        x_view.unbind();
-        FESwitch::basis(lfs.finiteElement()).evaluateFunction(x,yb);
-        y = 0;
-        for (unsigned int i=0; i<yb.size(); i++)
-        {
-          y.axpy(xl[i],yb[i]);
-        }
+        bind(e);
+        evaluateBound(x,y);
+      }
+
+      //! Evaluate the function at several points of the same element
+      /**
+       * The local function space is bound and the coefficients are read only
+       * once for all points.
+       */
+      void evaluate (const typename Traits::ElementType& e,
+                     const std::vector<typename Traits::DomainType>& x,
+                     std::vector<typename Traits::RangeType>& y) const
+      {
+        bind(e);
+        y.resize(x.size());
+        for (std::size_t i=0; i<x.size(); i++)
+          evaluateBound(x[i],y[i]);
       }
 
       //! get a reference to the GridView
@@ -159,9 +216,33 @@ namespace Dune {
       typedef LFSIndexCache<LFS> LFSCache;
       typedef typename X::template ConstLocalView<LFSCache> XView;
 
+      // bind to e (if not yet bound to it) and read the local coefficients
+      void bind (const typename Traits::ElementType& e) const
+      {
+        binding.bind(*pgfs,lfs,lfs_cache,e);
+        x_view.bind(lfs_cache);
+        x_view.read(xl);
+        x_view.unbind();
+      }
+
+      void evaluateBound (const typename Traits::DomainType& x,
+                          typename Traits::RangeType& y) const
+      {
+        typedef FiniteElementInterfaceSwitch<
+          typename Dune::PDELab::LocalFunctionSpace<GFS>::Traits::FiniteElementType
+          > FESwitch;
+        FESwitch::basis(lfs.finiteElement()).evaluateFunction(x,yb);
+        y = 0;
+        for (unsigned int i=0; i<yb.size(); i++)
+        {
+          y.axpy(xl[i],yb[i]);
+        }
+      }
+
       shared_ptr<GFS const> pgfs;
       mutable LFS lfs;
       mutable LFSCache lfs_cache;
+      mutable impl::LastElementBinding<GFS> binding;
       mutable XView x_view;
       mutable std::vector<typename Traits::RangeFieldType> xl;
       mutable std::vector<typename Traits::RangeType> yb;
@@ -224,21 +305,23 @@ namespace Dune {
                      const typename Traits::DomainType& x,
                      typename Traits::RangeType& y) const
       {
-        static const J2C& j2C = J2C();
-
-        lfs.bind();
-        lfs_cache.update();
-        x_view.bind(lfs_cache);
-        x_view.read(xl);
-        x_view.unbind();
-
-        lfs.finiteElement().basis().evaluateJacobian(x,jacobian);
+        bind(e);
+        evaluateBound(x,y);
+      }
 
-        y = 0;
-        for (std::size_t i=0; i < lfs.size(); i++) {
-          j2C(jacobian[i], yb);
-          y.axpy(xl[i], yb);
-        }
+      //! Evaluate the function at several points of the same element
+      /**
+       * The local function space is bound and the coefficients are read only
+       * once for all points.
+       */
+      void evaluate (const typename Traits::ElementType& e,
+                     const std::vector<typename Traits::DomainType>& x,
+                     std::vector<typename Traits::RangeType>& y) const
+      {
+        bind(e);
+        y.resize(x.size());
+        for (std::size_t i=0; i<x.size(); i++)
+          evaluateBound(x[i],y[i]);
       }
 
       //! get a reference to the GridView
@@ -252,9 +335,33 @@ namespace Dune {
       typedef LFSIndexCache<LFS> LFSCache;
       typedef typename X::template ConstLocalView<LFSCache> XView;
 
+      // bind to e (if not yet bound to it) and read the local coefficients
+      void bind (const typename Traits::ElementType& e) const
+      {
+        binding.bind(*pgfs,lfs,lfs_cache,e);
+        x_view.bind(lfs_cache);
+        x_view.read(xl);
+        x_view.unbind();
+      }
+
+      void evaluateBound (const typename Traits::DomainType& x,
+                          typename Traits::RangeType& y) const
+      {
+        static const J2C& j2C = J2C();
+
+        lfs.finiteElement().basis().evaluateJacobian(x,jacobian);
+
+        y = 0;
+        for (std::size_t i=0; i < lfs.size(); i++) {
+          j2C(jacobian[i], yb);
+          y.axpy(xl[i], yb);
+        }
+      }
+
       shared_ptr<GFS const> pgfs;
       mutable LFS lfs;
       mutable LFSCache lfs_cache;
+      mutable impl::LastElementBinding<GFS> binding;
       mutable XView x_view;
       mutable std::vector<typename Traits::RangeFieldType> xl;
       mutable std::vector<Jacobian> jacobian;
@@ -396,12 +503,49 @@ namespace Dune {
                             const typename Traits::DomainType& x,
                             typename Traits::RangeType& y) const
       {
-        lfs.bind(e);
-        lfs_cache.update();
+        bind(e);
+        evaluateBound(e,x,y);
+      }
+
+      //! Evaluate the function at several points of the same element
+      /**
+       * The local function space is bound and the coefficients are read only
+       * once for all points.
+       */
+      void evaluate (const typename Traits::ElementType& e,
+                     const std::vector<typename Traits::DomainType>& x,
+                     std::vector<typename Traits::RangeType>& y) const
+      {
+        bind(e);
+        y.resize(x.size());
+        for (std::size_t i=0; i<x.size(); i++)
+          evaluateBound(e,x[i],y[i]);
+      }
+
+      //! get a reference to the GridView
+      inline const typename Traits::GridViewType& getGridView () const
+      {
+        return pgfs->gridView();
+      }
+
+    private:
+      typedef LocalFunctionSpace<GFS> LFS;
+      typedef LFSIndexCache<LFS> LFSCache;
+      typedef typename X::template ConstLocalView<LFSCache> XView;
+
+      // bind to e (if not yet bound to it) and read the local coefficients
+      void bind (const typename Traits::ElementType& e) const
+      {
+        binding.bind(*pgfs,lfs,lfs_cache,e);
         x_view.bind(lfs_cache);
         x_view.read(xl);
         x_view.unbind();
+      }
 
+      void evaluateBound (const typename Traits::ElementType& e,
+                          const typename Traits::DomainType& x,
+                          typename Traits::RangeType& y) const
+      {
         lfs.finiteElement().localBasis().
           evaluateJacobianGlobal(x,J,e.geometry());
         y = 0;
@@ -428,20 +572,10 @@ namespace Dune {
           }
       }
 
-      //! get a reference to the GridView
-      inline const typename Traits::GridViewType& getGridView () const
-      {
-        return pgfs->gridView();
-      }
-
-    private:
-      typedef LocalFunctionSpace<GFS> LFS;
-      typedef LFSIndexCache<LFS> LFSCache;
-      typedef typename X::template ConstLocalView<LFSCache> XView;
-
       shared_ptr<GFS const> pgfs;
       mutable LFS lfs;
       mutable LFSCache lfs_cache;
+      mutable impl::LastElementBinding<GFS> binding;
       mutable XView x_view;
       mutable std::vector<typename Traits::RangeFieldType> xl;
       mutable std::vector<typename T::Traits::FiniteElementType::Traits::LocalBasisType::Traits::JacobianType> J;
@@ -510,23 +644,60 @@ namespace Dune {
       inline void evaluate (const typename Traits::ElementType& e,
                             const typename Traits::DomainType& x,
                             typename Traits::RangeType& y) const
+      {
+        bind(e);
+        evaluateBound(e,x,y);
+      }
+
+      //! Evaluate the function at several points of the same element
+      /**
+       * The local function space is bound and the coefficients are read only
+       * once for all points.
+       */
+      void evaluate (const typename Traits::ElementType& e,
+                     const std::vector<typename Traits::DomainType>& x,
+                     std::vector<typename Traits::RangeType>& y) const
+      {
+        bind(e);
+        y.resize(x.size());
+        for (std::size_t i=0; i<x.size(); i++)
+          evaluateBound(e,x[i],y[i]);
+      }
+
+      //! get a reference to the GridView
+      inline const typename Traits::GridViewType& getGridView () const
+      {
+        return pgfs->gridView();
+      }
+
+    private:
+      typedef LocalFunctionSpace<GFS> LFS;
+      typedef LFSIndexCache<LFS> LFSCache;
+      typedef typename X::template ConstLocalView<LFSCache> XView;
+
+      // bind to e (if not yet bound to it) and read the local coefficients
+      void bind (const typename Traits::ElementType& e) const
       {
         // get and bind local functions space
-        lfs.bind(e);
-        lfs_cache.update();
+        binding.bind(*pgfs,lfs,lfs_cache,e);
         x_view.bind(lfs_cache);
 
         // get local coefficients
         xl.resize(lfs.size());
         x_view.read(xl);
         x_view.unbind();
+      }
 
+      void evaluateBound (const typename Traits::ElementType& e,
+                          const typename Traits::DomainType& x,
+                          typename Traits::RangeType& y) const
+      {
         // get Jacobian of geometry
         const typename Traits::ElementType::Geometry::JacobianInverseTransposed
           JgeoIT = e.geometry().jacobianInverseTransposed(x);
 
         // get local Jacobians/gradients of the shape functions
-        std::vector<typename LBTraits::JacobianType> J(lfs.size());
+        J.resize(lfs.size());
         lfs.finiteElement().localBasis().evaluateJacobian(x,J);
 
         typename Traits::RangeType gradphi;
@@ -542,22 +713,13 @@ namespace Dune {
 
       }
 
-      //! get a reference to the GridView
-      inline const typename Traits::GridViewType& getGridView () const
-      {
-        return pgfs->gridView();
-      }
-
-    private:
-      typedef LocalFunctionSpace<GFS> LFS;
-      typedef LFSIndexCache<LFS> LFSCache;
-      typedef typename X::template ConstLocalView<LFSCache> XView;
-
       shared_ptr<GFS const> pgfs;
       mutable LFS lfs;
       mutable LFSCache lfs_cache;
+      mutable impl::LastElementBinding<GFS> binding;
       mutable XView x_view;
       mutable std::vector<typename Traits::RangeFieldType> xl;
+      mutable std::vector<typename LBTraits::JacobianType> J;
     };
 
     /** \brief DiscreteGridFunction with Piola transformation
@@ -609,13 +771,51 @@ namespace Dune {
                             const typename Traits::DomainType& x,
                             typename Traits::RangeType& y) const
       {
-        // evaluate shape function on the reference element as before
-        lfs.bind(e);
-        lfs_cache.update();
+        bind(e);
+        evaluateBound(e,x,y);
+      }
+
+      //! Evaluate the function at several points of the same element
+      /**
+       * The local function space is bound and the coefficients are read only
+       * once for all points.
+       */
+      void evaluate (const typename Traits::ElementType& e,
+                     const std::vector<typename Traits::DomainType>& x,
+                     std::vector<typename Traits::RangeType>& y) const
+      {
+        bind(e);
+        y.resize(x.size());
+        for (std::size_t i=0; i<x.size(); i++)
+          evaluateBound(e,x[i],y[i]);
+      }
+
+      //! get a reference to the GridView
+      inline const typename Traits::GridViewType& getGridView () const
+      {
+        return pgfs->gridView();
+      }
+
+    private:
+
+      typedef LocalFunctionSpace<GFS> LFS;
+      typedef LFSIndexCache<LFS> LFSCache;
+      typedef typename X::template ConstLocalView<LFSCache> XView;
+
+      // bind to e (if not yet bound to it) and read the local coefficients
+      void bind (const typename Traits::ElementType& e) const
+      {
+        binding.bind(*pgfs,lfs,lfs_cache,e);
         x_view.bind(lfs_cache);
         x_view.read(xl);
         x_view.unbind();
+      }
 
+      void evaluateBound (const typename Traits::ElementType& e,
+                          const typename Traits::DomainType& x,
+                          typename Traits::RangeType& y) const
+      {
+        // evaluate shape function on the reference element as before
         lfs.finiteElement().localBasis().evaluateFunction(x,yb);
         typename Traits::RangeType yhat;
         yhat = 0;
@@ -631,21 +831,10 @@ namespace Dune {
         y /= J.determinant();
       }
 
-      //! get a reference to the GridView
-      inline const typename Traits::GridViewType& getGridView () const
-      {
-        return pgfs->gridView();
-      }
-
-    private:
-
-      typedef LocalFunctionSpace<GFS> LFS;
-      typedef LFSIndexCache<LFS> LFSCache;
-      typedef typename X::template ConstLocalView<LFSCache> XView;
-
       shared_ptr<GFS const> pgfs;
       mutable LFS lfs;
       mutable LFSCache lfs_cache;
+      mutable impl::LastElementBinding<GFS> binding;
       mutable XView x_view;
       mutable std::vector<typename Traits::RangeFieldType> xl;
       mutable std::vector<typename Traits::RangeType> yb;
@@ -756,19 +945,23 @@ namespace Dune {
                             const typename Traits::DomainType& x,
                             typename Traits::RangeType& y) const
       {
-        lfs.bind(e);
-        lfs_cache.update();
-        x_view.bind(lfs_cache);
-        x_view.read(xl);
-        x_view.unbind();
-        for (unsigned int k=0; k < dimR; k++)
-          {
-            lfs.child(remap[k]).finiteElement().localBasis().
-              evaluateFunction(x,yb);
-            y[k] = 0.0;
-            for (unsigned int i=0; i<yb.size(); i++)
-              y[k] += xl[lfs.child(remap[k]).localIndex(i)]*yb[i];
-          }
+        bind(e);
+        evaluateBound(x,y);
+      }
+
+      //! Evaluate the function at several points of the same element
+      /**
+       * The local function space is bound and the coefficients are read only
+       * once for all points.
+       */
+      void evaluate (const typename Traits::ElementType& e,
+                     const std::vector<typename Traits::DomainType>& x,
+                     std::vector<typename Traits::RangeType>& y) const
+      {
+        bind(e);
+        y.resize(x.size());
+        for (std::size_t i=0; i<x.size(); i++)
+          evaluateBound(x[i],y[i]);
       }
 
       //! get a reference to the GridView
@@ -782,10 +975,33 @@ namespace Dune {
       typedef LFSIndexCache<LFS> LFSCache;
       typedef typename X::template ConstLocalView<LFSCache> XView;
 
+      // bind to e (if not yet bound to it) and read the local coefficients
+      void bind (const typename Traits::ElementType& e) const
+      {
+        binding.bind(*pgfs,lfs,lfs_cache,e);
+        x_view.bind(lfs_cache);
+        x_view.read(xl);
+        x_view.unbind();
+      }
+
+      void evaluateBound (const typename Traits::DomainType& x,
+                          typename Traits::RangeType& y) const
+      {
+        for (unsigned int k=0; k < dimR; k++)
+          {
+            lfs.child(remap[k]).finiteElement().localBasis().
+              evaluateFunction(x,yb);
+            y[k] = 0.0;
+            for (unsigned int i=0; i<yb.size(); i++)
+              y[k] += xl[lfs.child(remap[k]).localIndex(i)]*yb[i];
+          }
+      }
+
       shared_ptr<GFS const> pgfs;
       std::size_t remap[dimR];
       mutable LFS lfs;
       mutable LFSCache lfs_cache;
+      mutable impl::LastElementBinding<GFS> binding;
       mutable XView x_view;
       mutable std::vector<RF> xl;
       mutable std::vector<RT> yb;
@@ -852,14 +1068,51 @@ namespace Dune {
       inline void evaluate(const typename Traits::ElementType& e,
           const typename Traits::DomainType& x,
           typename Traits::RangeType& y) const
+      {
+        bind(e);
+        evaluateBound(e,x,y);
+      }
+
+      //! Evaluate the function at several points of the same element
+      /**
+       * The local function space is bound and the coefficients are read only
+       * once for all points.
+       */
+      void evaluate (const typename Traits::ElementType& e,
+                     const std::vector<typename Traits::DomainType>& x,
+                     std::vector<typename Traits::RangeType>& y) const
+      {
+        bind(e);
+        y.resize(x.size());
+        for (std::size_t i=0; i<x.size(); i++)
+          evaluateBound(e,x[i],y[i]);
+      }
+
+      //! \brief get a reference to the GridView
+      inline const typename Traits::GridViewType& getGridView () const
+      {
+        return pgfs->gridView();
+      }
+
+    private:
+      typedef LocalFunctionSpace<GFS> LFS;
+      typedef LFSIndexCache<LFS> LFSCache;
+      typedef typename X::template ConstLocalView<LFSCache> XView;
+
+      // bind to e (if not yet bound to it) and read the local coefficients
+      void bind (const typename Traits::ElementType& e) const
       {
         // get and bind local functions space
-        lfs.bind(e);
-        lfs_cache.update();
+        binding.bind(*pgfs,lfs,lfs_cache,e);
         x_view.bind(lfs_cache);
         x_view.read(xl);
         x_view.unbind();
+      }
 
+      void evaluateBound (const typename Traits::ElementType& e,
+                          const typename Traits::DomainType& x,
+                          typename Traits::RangeType& y) const
+      {
         // get Jacobian of geometry
         const typename Traits::ElementType::Geometry::JacobianInverseTransposed
           JgeoIT = e.geometry().jacobianInverseTransposed(x);
@@ -870,7 +1123,7 @@ namespace Dune {
         for(unsigned int k = 0; k != T::CHILDREN; ++k)
         {
           // get local Jacobians/gradients of the shape functions
-          std::vector<typename LBTraits::JacobianType> J(lfs.child(k).size());
+          J.resize(lfs.child(k).size());
           lfs.child(k).finiteElement().localBasis().evaluateJacobian(x,J);
 
           Dune::FieldVector<RF,LBTraits::dimDomain> gradphi;
@@ -884,21 +1137,10 @@ namespace Dune {
         }
       }
 
-
-      //! \brief get a reference to the GridView
-      inline const typename Traits::GridViewType& getGridView () const
-      {
-        return pgfs->gridView();
-      }
-
-    private:
-      typedef LocalFunctionSpace<GFS> LFS;
-      typedef LFSIndexCache<LFS> LFSCache;
-      typedef typename X::template ConstLocalView<LFSCache> XView;
-
       shared_ptr<GFS const> pgfs;
       mutable LFS lfs;
       mutable LFSCache lfs_cache;
+      mutable impl::LastElementBinding<GFS> binding;
       mutable XView x_view;
       mutable std::vector<RF> xl;
       mutable std::vector<JT> J;
@@ -3,6 +3,7 @@
 #ifndef DUNE_PDELAB_LFSINDEXCACHE_HH
 #define DUNE_PDELAB_LFSINDEXCACHE_HH
 
+#include <cassert>
 #include <vector>
 #include <stack>
 #include <algorithm>
@@ -347,23 +348,54 @@ namespace Dune {
               }
           }
 
-        if (constraint_entry_count > 0)
+        build_constraints_entries(non_dirichlet_constrained_dofs,constraint_entry_count);
+      }
+
+      //! Updates the cache from a precomputed table after binding the local function space to a cell.
+      /**
+       * Gives the same result as update(), but copies the container indices and constraint flags
+       * of the cell from the table (see GFSConnectivityTable) instead of mapping the DOF indices
+       * through the ordering; the constraints container is only searched for DOFs with
+       * non-Dirichlet constraints. The table has to be up to date for the space and for the
+       * constraints of this cache.
+       */
+      template<typename Table>
+      void update(const Table& table, size_type cell)
+      {
+        assert(table.size(cell) == _lfs.size());
+
+        // clear out existing state
+        _container_index_map.clear();
+        _inverse_map.clear();
+        _inverse_cache_built = false;
+
+        const size_type n = _lfs.size();
+        std::copy(table.containerIndices(cell),table.containerIndices(cell) + n,_container_indices.begin());
+        for (typename CIVector::iterator it = _container_indices.begin() + n; it != _container_indices.end(); ++it)
+          it->clear();
+
+        _constraints.resize(0);
+        std::vector<std::pair<size_type,typename C::const_iterator> > non_dirichlet_constrained_dofs;
+        size_type constraint_entry_count = 0;
+        const unsigned char* flags = table.dofFlags(cell);
+        for (size_type i = 0; i < n; ++i)
           {
-            _constraints.resize(constraint_entry_count);
-            typename ConstraintsVector::iterator eit = _constraints.begin();
-            for (typename std::vector<std::pair<size_type,typename C::const_iterator> >::const_iterator it = non_dirichlet_constrained_dofs.begin();
-                 it != non_dirichlet_constrained_dofs.end();
-                 ++it)
+            _dof_flags[i] = flags[i];
+            if (!(flags[i] & DOF_CONSTRAINED))
+              continue;
+
+            if (flags[i] & DOF_DIRICHLET)
+              _constraints_iterators[i] = make_pair(_constraints.end(),_constraints.end());
+            else
               {
-                _constraints_iterators[it->first].first = eit;
-                for (typename C::mapped_type::const_iterator cit = it->second->second.begin(); cit != it->second->second.end(); ++cit, ++eit)
-                  {
-                    eit->first = &(cit->first);
-                    eit->second = cit->second;
-                  }
-                _constraints_iterators[it->first].second = eit;
+                const typename C::const_iterator cit = _gfs_constraints.find(_container_indices[i]);
+                assert(cit != _gfs_constraints.end());
+                constraint_entry_count += cit->second.size();
+                non_dirichlet_constrained_dofs.push_back(make_pair(i,cit));
               }
           }
+
+        build_constraints_entries(non_dirichlet_constrained_dofs,constraint_entry_count);
       }
 
       const DI& dofIndex(size_type i) const
@@ -444,6 +476,28 @@ namespace Dune {
 
     private:
 
+      void build_constraints_entries(const std::vector<std::pair<size_type,typename C::const_iterator> >& non_dirichlet_constrained_dofs,
+                                     size_type constraint_entry_count)
+      {
+        if (constraint_entry_count > 0)
+          {
+            _constraints.resize(constraint_entry_count);
+            typename ConstraintsVector::iterator eit = _constraints.begin();
+            for (typename std::vector<std::pair<size_type,typename C::const_iterator> >::const_iterator it = non_dirichlet_constrained_dofs.begin();
+                 it != non_dirichlet_constrained_dofs.end();
+                 ++it)
+              {
+                _constraints_iterators[it->first].first = eit;
+                for (typename C::mapped_type::const_iterator cit = it->second->second.begin(); cit != it->second->second.end(); ++cit, ++eit)
+                  {
+                    eit->first = &(cit->first);
+                    eit->second = cit->second;
+                  }
+                _constraints_iterators[it->first].second = eit;
+              }
+          }
+      }
+
       struct sort_container_indices
       {
         template<typename T>
@@ -599,6 +653,19 @@ namespace Dune {
         TypeTree::applyToTree(_lfs.gridFunctionSpace().ordering(),index_mapper);
       }
 
+      //! Updates the cache from a precomputed table, see GFSConnectivityTable.
+      template<typename Table>
+      void update(const Table& table, size_type cell)
+      {
+        assert(table.size(cell) == _lfs.size());
+
+        _container_index_map.clear();
+        const size_type n = _lfs.size();
+        std::copy(table.containerIndices(cell),table.containerIndices(cell) + n,_container_indices.begin());
+        for (typename CIVector::iterator it = _container_indices.begin() + n; it != _container_indices.end(); ++it)
+          it->clear();
+      }
+
       const DI& dofIndex(size_type i) const
       {
         return _lfs.dofIndex(i);
@@ -743,23 +810,41 @@ namespace Dune {
               }
           }
 
-        if (constraint_entry_count > 0)
+        build_constraints_entries(non_dirichlet_constrained_dofs,constraint_entry_count);
+      }
+
+      //! Updates the cache from a precomputed table, see GFSConnectivityTable.
+      /**
+       * Takes the constraint flags from the table and only searches the constraints container
+       * for DOFs with non-Dirichlet constraints.
+       */
+      template<typename Table>
+      void update(const Table& table, size_type cell)
+      {
+        assert(table.size(cell) == _lfs.size());
+
+        _constraints.resize(0);
+        std::vector<std::pair<size_type,typename C::const_iterator> > non_dirichlet_constrained_dofs;
+        size_type constraint_entry_count = 0;
+        const unsigned char* flags = table.dofFlags(cell);
+        for (size_type i = 0; i < _lfs.size(); ++i)
           {
-            _constraints.resize(constraint_entry_count);
-            typename ConstraintsVector::iterator eit = _constraints.begin();
-            for (typename std::vector<std::pair<size_type,typename C::const_iterator> >::const_iterator it = non_dirichlet_constrained_dofs.begin();
-                 it != non_dirichlet_constrained_dofs.end();
-                 ++it)
+            _dof_flags[i] = flags[i];
+            if (!(flags[i] & DOF_CONSTRAINED))
+              continue;
+
+            if (flags[i] & DOF_DIRICHLET)
+              _constraints_iterators[i] = make_pair(_constraints.end(),_constraints.end());
+            else
               {
-                _constraints_iterators[it->first].first = eit;
-                for (typename C::mapped_type::const_iterator cit = it->second->second.begin(); cit != it->second->second.end(); ++cit, ++eit)
-                  {
-                    eit->first = cit->first;
-                    eit->second = cit->second;
-                  }
-                _constraints_iterators[it->first].second = eit;
+                const typename C::const_iterator cit = _gfs_constraints.find(_lfs.dofIndex(i));
+                assert(cit != _gfs_constraints.end());
+                constraint_entry_count += cit->second.size();
+                non_dirichlet_constrained_dofs.push_back(make_pair(i,cit));
               }
           }
+
+        build_constraints_entries(non_dirichlet_constrained_dofs,constraint_entry_count);
       }
 
       const DI& dofIndex(size_type i) const
@@ -811,6 +896,28 @@ namespace Dune {
 
     private:
 
+      void build_constraints_entries(const std::vector<std::pair<size_type,typename C::const_iterator> >& non_dirichlet_constrained_dofs,
+                                     size_type constraint_entry_count)
+      {
+        if (constraint_entry_count > 0)
+          {
+            _constraints.resize(constraint_entry_count);
+            typename ConstraintsVector::iterator eit = _constraints.begin();
+            for (typename std::vector<std::pair<size_type,typename C::const_iterator> >::const_iterator it = non_dirichlet_constrained_dofs.begin();
+                 it != non_dirichlet_constrained_dofs.end();
+                 ++it)
+              {
+                _constraints_iterators[it->first].first = eit;
+                for (typename C::mapped_type::const_iterator cit = it->second->second.begin(); cit != it->second->second.end(); ++cit, ++eit)
+                  {
+                    eit->first = cit->first;
+                    eit->second = cit->second;
+                  }
+                _constraints_iterators[it->first].second = eit;
+              }
+          }
+      }
+
       const LFS& _lfs;
       CIVector _container_indices;
       std::vector<unsigned char> _dof_flags;
@@ -880,6 +987,12 @@ namespace Dune {
         // there's nothing to do here...
       }
 
+      template<typename Table>
+      void update(const Table& table, size_type cell)
+      {
+        // ...nor here
+      }
+
       CI containerIndex(size_type i) const
       {
         return CI(_lfs.dofIndex(i)[0]);
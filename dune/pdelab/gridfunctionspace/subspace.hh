@@ -241,6 +241,12 @@ namespace Dune {
           return _ordering.maxLocalSize();
         }
 
+        //! Returns the revision of the root space, see GridFunctionSpaceBase::revision().
+        std::size_t revision() const
+        {
+          return subSpace().baseGridFunctionSpace().revision();
+        }
+
         //! \}
 
       protected:
@@ -6,9 +6,15 @@
 #include <cstddef>
 #include <vector>
 #include <algorithm>
+#include <map>
+#include <set>
 
 #include <dune/common/deprecated.hh>
 #include <dune/common/parallel/mpihelper.hh>
+#if HAVE_MPI
+#include <dune/common/parallel/mpitraits.hh>
+#endif
+#include <dune/common/shared_ptr.hh>
 #include <dune/common/tuples.hh>
 
 #include <dune/geometry/typeindex.hh>
@@ -19,7 +25,9 @@
 #include <dune/pdelab/common/unordered_set.hh>
 #include <dune/pdelab/common/borderindexidcache.hh>
 #include <dune/pdelab/common/globaldofindex.hh>
+#include <dune/pdelab/common/mpicommunicator.hh>
 #include <dune/pdelab/gridfunctionspace/entityindexcache.hh>
+#include <dune/pdelab/common/performancetrace.hh>
 
 namespace Dune {
   namespace PDELab {
@@ -121,6 +129,9 @@ namespace Dune {
       void update(const GridOperator& grid_operator)
       {
         _communication_cache = make_shared<CommunicationCache>(grid_operator);
+#if HAVE_MPI
+        _async_exchange.reset();
+#endif
       }
 
       class CommunicationCache
@@ -481,20 +492,355 @@ namespace Dune {
 
       };
 
+#if HAVE_MPI
+
+      //! Collects the ranks sharing each border entity.
+      class NeighborRankCollector
+        : public CommDataHandleIF<NeighborRankCollector,int>
+      {
+
+      public:
+
+        typedef int DataType;
+        typedef std::map<std::pair<std::size_t,std::size_t>,std::vector<int> > EntityRanks;
+
+        bool contains(int dim, int codim) const
+        {
+          return
+            codim > 0 &&
+            (_gfsu.dataHandleContains(codim) ||
+             _gfsv.dataHandleContains(codim));
+        }
+
+        bool fixedsize(int dim, int codim) const
+        {
+          return true;
+        }
+
+        template<typename Entity>
+        std::size_t size(const Entity& e) const
+        {
+          return 1;
+        }
+
+        template<typename MessageBuffer, typename Entity>
+        void gather(MessageBuffer& buff, const Entity& e) const
+        {
+          buff.write(_grid_view.comm().rank());
+        }
+
+        template<typename MessageBuffer, typename Entity>
+        void scatter(MessageBuffer& buff, const Entity& e, std::size_t n)
+        {
+          int rank;
+          buff.read(rank);
+          _ranks[std::make_pair(GlobalGeometryTypeIndex::index(e.type()),
+                                static_cast<std::size_t>(_grid_view.indexSet().index(e)))].push_back(rank);
+        }
+
+        NeighborRankCollector(const GridView& grid_view, const GFSU& gfsu, const GFSV& gfsv, EntityRanks& ranks)
+          : _grid_view(grid_view)
+          , _gfsu(gfsu)
+          , _gfsv(gfsv)
+          , _ranks(ranks)
+        {}
+
+      private:
+
+        GridView _grid_view;
+        const GFSU& _gfsu;
+        const GFSV& _gfsv;
+        EntityRanks& _ranks;
+
+      };
+
+      //! Point-to-point exchange of the border entries with a fixed schedule.
+      /**
+       * The schedule lists, for every neighboring process, the matrix entries to send and the
+       * entries the received values have to be added to. It is built with a single blocking
+       * exchange of the entry descriptions on first use, after which every exchange only sends
+       * the values in this fixed order, using non-blocking MPI calls.
+       *
+       * Every process sharing a border entity with this process is a neighbor, even if there
+       * are no entries to send to it. As the interface InteriorBorder_InteriorBorder_Interface
+       * is symmetric, so are the neighbor sets, and every process receives exactly one message
+       * from each of its neighbors during setup. The entry descriptions and the values use
+       * separate tags, so a value message can never be mistaken for a setup message.
+       */
+      class AsyncEntryExchange
+      {
+
+        typedef typename M::field_type Field;
+        typedef typename GFSV::Ordering::Traits::ContainerIndex RowContainerIndex;
+        typedef typename GFSU::Ordering::Traits::ContainerIndex ColContainerIndex;
+        typedef std::pair<RowContainerIndex,ColContainerIndex> Entry;
+
+        // the description of a single border entry as sent to the neighbors
+        struct EntryRecord
+        {
+          IdType row_entity;
+          typename RowDOFIndex::TreeIndex row_tree_index;
+          typename BorderPattern::mapped_type::value_type col;
+        };
+
+        struct Neighbor
+        {
+          int rank;
+          std::vector<Entry> send_entries;
+          std::vector<Entry> recv_entries;
+          std::vector<char> recv_valid;
+          std::vector<Field> send_buffer;
+          std::vector<Field> recv_buffer;
+        };
+
+        enum { setup_tag = 4711, value_tag = 4712 };
+
+      public:
+
+        AsyncEntryExchange(const NonOverlappingBorderDOFExchanger& dof_exchanger,
+                           const GFSU& gfsu, const GFSV& gfsv, MPI_Comm comm)
+          : _comm(comm)
+          , _pending(0)
+        {
+          PerformanceTrace::Region region("communication setup","communication");
+          const CommunicationCache& cache = dof_exchanger.communicationCache();
+          const BorderPattern& pattern = cache.pattern();
+
+          // find the processes sharing each border entity
+          typename NeighborRankCollector::EntityRanks entity_ranks;
+          NeighborRankCollector collector(dof_exchanger.gridView(),gfsu,gfsv,entity_ranks);
+          dof_exchanger.gridView().communicate(collector,
+                                               InteriorBorder_InteriorBorder_Interface,
+                                               ForwardCommunication);
+
+          // all processes sharing a border entity are neighbors, in ascending order of their
+          // ranks, so that both sides of a pair agree on having to exchange a message
+          std::set<int> ranks;
+          for (typename NeighborRankCollector::EntityRanks::const_iterator it = entity_ranks.begin();
+               it != entity_ranks.end();
+               ++it)
+            ranks.insert(it->second.begin(),it->second.end());
+
+          std::map<int,std::size_t> neighbor_index;
+          std::vector<std::vector<EntryRecord> > records(ranks.size());
+          for (std::set<int>::const_iterator it = ranks.begin(); it != ranks.end(); ++it)
+            {
+              neighbor_index.insert(std::make_pair(*it,_neighbors.size()));
+              _neighbors.push_back(Neighbor());
+              _neighbors.back().rank = *it;
+            }
+
+          for (typename BorderPattern::const_iterator it = pattern.begin(); it != pattern.end(); ++it)
+            {
+              const RowDOFIndex& di = it->first;
+              const std::size_t row_gt_index = GFSV::Ordering::Traits::DOFIndexAccessor::geometryType(di);
+              const std::size_t row_entity_index = GFSV::Ordering::Traits::DOFIndexAccessor::entityIndex(di);
+              typename NeighborRankCollector::EntityRanks::const_iterator rit =
+                entity_ranks.find(std::make_pair(row_gt_index,row_entity_index));
+              if (rit == entity_ranks.end())
+                continue;
+
+              const RowContainerIndex ci = gfsv.ordering().mapIndex(di);
+              for (std::vector<int>::const_iterator rank_it = rit->second.begin(); rank_it != rit->second.end(); ++rank_it)
+                {
+                  const std::size_t n = neighbor_index.find(*rank_it)->second;
+                  Neighbor& neighbor = _neighbors[n];
+                  std::vector<EntryRecord>& neighbor_records = records[n];
+
+                  for (typename BorderPattern::mapped_type::const_iterator col_it = it->second.begin();
+                       col_it != it->second.end();
+                       ++col_it)
+                    {
+                      typename CommunicationCache::EntityIndex col_entity = cache.index(col_it->entityID());
+                      ColDOFIndex dj;
+                      GFSU::Ordering::Traits::DOFIndexAccessor::store(dj,col_entity.geometryTypeIndex(),col_entity.entityIndex(),col_it->treeIndex());
+                      neighbor.send_entries.push_back(Entry(ci,gfsu.ordering().mapIndex(dj)));
+
+                      EntryRecord record;
+                      record.row_entity = cache.id(row_gt_index,row_entity_index);
+                      record.row_tree_index = di.treeIndex();
+                      record.col = *col_it;
+                      neighbor_records.push_back(record);
+                    }
+                }
+            }
+
+          // send the entry descriptions and set up the receiving side from the ones we get
+          std::vector<MPI_Request> requests(_neighbors.size());
+          for (std::size_t n = 0; n < _neighbors.size(); ++n)
+            {
+              _neighbors[n].send_buffer.resize(_neighbors[n].send_entries.size());
+              MPI_Isend(records[n].empty() ? 0 : &records[n][0],
+                        records[n].size()*sizeof(EntryRecord),MPI_BYTE,
+                        _neighbors[n].rank,setup_tag,_comm,&requests[n]);
+            }
+
+          for (std::size_t n = 0; n < _neighbors.size(); ++n)
+            {
+              Neighbor& neighbor = _neighbors[n];
+              MPI_Status status;
+              MPI_Probe(neighbor.rank,setup_tag,_comm,&status);
+              int bytes;
+              MPI_Get_count(&status,MPI_BYTE,&bytes);
+              std::vector<EntryRecord> received(bytes / sizeof(EntryRecord));
+              MPI_Recv(received.empty() ? 0 : &received[0],bytes,MPI_BYTE,
+                       neighbor.rank,setup_tag,_comm,MPI_STATUS_IGNORE);
+
+              neighbor.recv_entries.resize(received.size());
+              neighbor.recv_valid.assign(received.size(),0);
+              neighbor.recv_buffer.resize(received.size());
+              for (std::size_t i = 0; i < received.size(); ++i)
+                {
+                  std::pair<bool,typename CommunicationCache::EntityIndex> row_index = cache.findIndex(received[i].row_entity);
+                  std::pair<bool,typename CommunicationCache::EntityIndex> col_index = cache.findIndex(received[i].col.entityID());
+                  if (!row_index.first || !col_index.first)
+                    continue;
+
+                  RowDOFIndex di;
+                  GFSV::Ordering::Traits::DOFIndexAccessor::store(di,
+                                                                  row_index.second.geometryTypeIndex(),
+                                                                  row_index.second.entityIndex(),
+                                                                  received[i].row_tree_index);
+                  ColDOFIndex dj;
+                  GFSU::Ordering::Traits::DOFIndexAccessor::store(dj,
+                                                                  col_index.second.geometryTypeIndex(),
+                                                                  col_index.second.entityIndex(),
+                                                                  received[i].col.treeIndex());
+                  neighbor.recv_entries[i] = Entry(gfsv.ordering().mapIndex(di),gfsu.ordering().mapIndex(dj));
+                  neighbor.recv_valid[i] = 1;
+                }
+            }
+
+          if (!requests.empty())
+            MPI_Waitall(requests.size(),&requests[0],MPI_STATUSES_IGNORE);
+        }
+
+        ~AsyncEntryExchange()
+        {
+          finish();
+        }
+
+        //! Sends the current border entries of the matrix and posts the receives.
+        void start(const Matrix& matrix)
+        {
+          finish();
+          PerformanceTrace::Region region("communication","communication");
+          _requests.resize(2*_neighbors.size());
+          for (std::size_t n = 0; n < _neighbors.size(); ++n)
+            {
+              Neighbor& neighbor = _neighbors[n];
+              MPI_Irecv(neighbor.recv_buffer.empty() ? 0 : &neighbor.recv_buffer[0],
+                        neighbor.recv_buffer.size(),MPITraits<Field>::getType(),
+                        neighbor.rank,value_tag,_comm,&_requests[2*n]);
+              for (std::size_t i = 0; i < neighbor.send_entries.size(); ++i)
+                neighbor.send_buffer[i] = matrix(neighbor.send_entries[i].first,neighbor.send_entries[i].second);
+              MPI_Isend(neighbor.send_buffer.empty() ? 0 : &neighbor.send_buffer[0],
+                        neighbor.send_buffer.size(),MPITraits<Field>::getType(),
+                        neighbor.rank,value_tag,_comm,&_requests[2*n+1]);
+            }
+          _pending = &matrix;
+        }
+
+        //! Waits for all messages, the received entries are added by accumulate().
+        void finish()
+        {
+          if (_requests.empty())
+            return;
+          PerformanceTrace::Region region("communication","communication");
+          MPI_Waitall(_requests.size(),&_requests[0],MPI_STATUSES_IGNORE);
+          _requests.clear();
+        }
+
+        //! Adds the received entries to the matrix, returns false if they belong to a different matrix.
+        bool accumulate(Matrix& matrix)
+        {
+          if (_pending != &matrix)
+            return false;
+          finish();
+          for (std::size_t n = 0; n < _neighbors.size(); ++n)
+            {
+              const Neighbor& neighbor = _neighbors[n];
+              for (std::size_t i = 0; i < neighbor.recv_entries.size(); ++i)
+                if (neighbor.recv_valid[i])
+                  matrix(neighbor.recv_entries[i].first,neighbor.recv_entries[i].second) += neighbor.recv_buffer[i];
+            }
+          _pending = 0;
+          return true;
+        }
+
+      private:
+
+        AsyncEntryExchange(const AsyncEntryExchange&);
+        AsyncEntryExchange& operator=(const AsyncEntryExchange&);
+
+        MPI_Comm _comm;
+        std::vector<Neighbor> _neighbors;
+        std::vector<MPI_Request> _requests;
+        const Matrix* _pending;
+
+      };
+
+#endif // HAVE_MPI
+
+      //! Starts the exchange of the border entries of matrix without waiting for it to complete.
+      /**
+       * The values sent are the current entries of the rows belonging to border DOFs, so all
+       * contributions to these rows must have been assembled. The exchange is completed by
+       * finishAccumulation(), and the received entries are added to the matrix by the next call
+       * to accumulateBorderEntries() for the same matrix. This requires the sparsity pattern
+       * to have been set up by this grid operator and MPI; otherwise nothing happens and
+       * accumulateBorderEntries() falls back to a blocking exchange.
+       */
+      void startAccumulation(const GridOperator& grid_operator, const Matrix& matrix)
+      {
+#if HAVE_MPI
+        if (_grid_view.comm().size() == 1 || !_communication_cache->initialized())
+          return;
+        if (!_async_exchange)
+          {
+            MPI_Comm comm = mpiCommunicator(_grid_view.comm());
+            if (comm == MPI_COMM_NULL)
+              return;
+            _async_exchange = make_shared<AsyncEntryExchange>(*this,
+                                                              grid_operator.trialGridFunctionSpace(),
+                                                              grid_operator.testGridFunctionSpace(),
+                                                              comm);
+          }
+        _async_exchange->start(matrix);
+#endif
+      }
+
+      //! Waits for the exchange started by startAccumulation() to complete.
+      void finishAccumulation()
+      {
+#if HAVE_MPI
+        if (_async_exchange)
+          _async_exchange->finish();
+#endif
+      }
+
       /** @brief Sums up the entries corresponding to border vertices.
       @param matrix Matrix to operate on.
       */
       void accumulateBorderEntries(const GridOperator& grid_operator, Matrix& matrix)
       {
+#if HAVE_MPI
+        // use the entries received during assembly, if any
+        if (_async_exchange && _async_exchange->accumulate(matrix))
+          return;
+#endif
         if (_grid_view.comm().size() > 1)
           {
             EntryAccumulator data_handle(*this,
                                          grid_operator.testGridFunctionSpace(),
                                          grid_operator.trialGridFunctionSpace(),
                                          matrix);
-            _grid_view.communicate(data_handle,
-                                   InteriorBorder_InteriorBorder_Interface,
-                                   ForwardCommunication);
+            {
+              PerformanceTrace::Region region("communication","communication");
+              _grid_view.communicate(data_handle,
+                                     InteriorBorder_InteriorBorder_Interface,
+                                     ForwardCommunication);
+            }
           }
       }
 
@@ -522,6 +868,9 @@ namespace Dune {
 
       shared_ptr<CommunicationCache> _communication_cache;
       GridView _grid_view;
+#if HAVE_MPI
+      shared_ptr<AsyncEntryExchange> _async_exchange;
+#endif
 
     };
 
@@ -546,6 +895,12 @@ namespace Dune {
       void accumulateBorderEntries(const GridOperator& grid_operator, typename GridOperator::Traits::Jacobian& matrix)
       {}
 
+      void startAccumulation(const GridOperator& grid_operator, const typename GridOperator::Traits::Jacobian& matrix)
+      {}
+
+      void finishAccumulation()
+      {}
+
       CommunicationCache& communicationCache()
       {
         return *this;
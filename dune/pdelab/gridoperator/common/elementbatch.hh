@@ -0,0 +1,342 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_GRIDOPERATOR_COMMON_ELEMENTBATCH_HH
+#define DUNE_PDELAB_GRIDOPERATOR_COMMON_ELEMENTBATCH_HH
+
+#include <cstddef>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+#include <dune/geometry/type.hh>
+#include <dune/typetree/typetree.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    /** \addtogroup GridOperator
+     *  \{
+     */
+
+    //! A batch of up to N cells of a grid view that share their finite elements.
+    /**
+     * The batch is the argument of the batched volume methods of a local operator, e.g.
+     * \code
+     * template<typename Batch, typename LFSU, typename X, typename LFSV, typename R>
+     * void alpha_volume_batch (const Batch& batch, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r) const;
+     * \endcode
+     * All cells of a batch have the same geometry type and use the same finite elements,
+     * so the local function spaces passed along with the batch (bound to its first cell)
+     * describe the local DOFs of every cell. The coefficients and results are stored as a
+     * structure of arrays, see BatchVector and BatchMatrix.
+     *
+     * The geometry of the cells is provided in the same layout: after bind() has been called
+     * with a position in the reference element, integrationElement() and
+     * jacobianInverseTransposed() return arrays with one entry per cell of the batch. If all
+     * cells of the batch are affine, the geometry is only evaluated on the first call to bind().
+     *
+     * \tparam GV  The grid view the cells belong to.
+     * \tparam N   The maximum number of cells in a batch.
+     */
+    template<typename GV, std::size_t N>
+    class ElementBatch
+    {
+
+      typedef typename GV::Traits::template Codim<0>::Iterator ElementIterator;
+
+    public:
+
+      typedef typename GV::Traits::template Codim<0>::Entity Element;
+      typedef typename GV::Traits::template Codim<0>::EntityPointer ElementPointer;
+      typedef typename Element::Geometry Geometry;
+      typedef typename Geometry::ctype ctype;
+      typedef std::size_t size_type;
+
+      enum { dimension = GV::dimension };
+      enum { dimensionworld = GV::dimensionworld };
+
+      //! The maximum number of cells in a batch.
+      static const size_type lanes = N;
+
+      typedef FieldVector<ctype,dimension> LocalCoordinate;
+
+      ElementBatch()
+        : _geometry_valid(false)
+        , _affine(false)
+      {
+        _elements.reserve(N);
+      }
+
+      //! Returns the number of cells in the batch.
+      size_type size() const
+      {
+        return _elements.size();
+      }
+
+      bool empty() const
+      {
+        return _elements.empty();
+      }
+
+      bool full() const
+      {
+        return _elements.size() == N;
+      }
+
+      //! Returns the e-th cell of the batch.
+      const Element& element(size_type e) const
+      {
+        return *_elements[e];
+      }
+
+      //! Returns the geometry type shared by all cells of the batch.
+      GeometryType type() const
+      {
+        return _elements[0]->type();
+      }
+
+      //! Appends the cell an iterator points to.
+      void push_back(const ElementIterator& it)
+      {
+        _elements.push_back(ElementPointer(it));
+        _geometry_valid = false;
+      }
+
+      //! Removes all cells from the batch.
+      void clear()
+      {
+        _elements.clear();
+        _geometry_valid = false;
+      }
+
+      //! Evaluates the geometries of all cells at the position x of the reference element.
+      void bind(const LocalCoordinate& x) const
+      {
+        if (_geometry_valid && _affine)
+          return;
+
+        _affine = true;
+        for (size_type e = 0; e < _elements.size(); ++e)
+          {
+            const Geometry geo = _elements[e]->geometry();
+            _affine = _affine && geo.affine();
+            _integration_element[e] = geo.integrationElement(x);
+            // Extract the columns with mv(), which all jacobian types (e.g. DiagonalMatrix) provide
+            const typename Geometry::JacobianInverseTransposed jit = geo.jacobianInverseTransposed(x);
+            for (int c = 0; c < dimension; ++c)
+              {
+                LocalCoordinate unit(0.0);
+                unit[c] = 1.0;
+                FieldVector<ctype,dimensionworld> column;
+                jit.mv(unit,column);
+                for (int r = 0; r < dimensionworld; ++r)
+                  _jacobian_inverse_transposed[r][c][e] = column[r];
+              }
+          }
+        _geometry_valid = true;
+      }
+
+      //! The integration elements of all cells at the position passed to bind().
+      const ctype* integrationElement() const
+      {
+        return _integration_element;
+      }
+
+      //! Entry (r,c) of the transposed inverse jacobians of all cells at the position passed to bind().
+      const ctype* jacobianInverseTransposed(int r, int c) const
+      {
+        return _jacobian_inverse_transposed[r][c];
+      }
+
+    private:
+
+      std::vector<ElementPointer> _elements;
+      mutable bool _geometry_valid;
+      mutable bool _affine;
+      mutable ctype _integration_element[N];
+      mutable ctype _jacobian_inverse_transposed[dimensionworld][dimension][N];
+
+    };
+
+
+    //! Local coefficients or residuals of all cells of an ElementBatch.
+    /**
+     * The entries are stored as a structure of arrays: all values belonging to the same local
+     * DOF are contiguous, one per cell of the batch. Accessing the container with a local
+     * function space and a DOF index returns a pointer to these N values, so a local operator
+     * can process the cells of the batch in its innermost loop:
+     * \code
+     * const RF* xi = x(lfsu,i);
+     * for (std::size_t e = 0; e < batch.size(); ++e)
+     *   u[e] += xi[e]*phi[i];
+     * \endcode
+     */
+    template<typename T, std::size_t N>
+    class BatchVector
+    {
+    public:
+
+      typedef T value_type;
+      typedef std::size_t size_type;
+
+      BatchVector()
+        : _size(0)
+      {}
+
+      //! Resizes the container to n DOFs per cell.
+      void resize(size_type n)
+      {
+        _container.resize(n*N);
+        _size = n;
+      }
+
+      //! Resizes the container to n DOFs per cell and assigns v to all entries.
+      void assign(size_type n, const T& v)
+      {
+        _container.assign(n*N,v);
+        _size = n;
+      }
+
+      //! Returns the number of DOFs per cell.
+      size_type size() const
+      {
+        return _size;
+      }
+
+      //! Returns the values of the i-th DOF of lfs for all cells.
+      template<typename LFS>
+      T* operator()(const LFS& lfs, size_type i)
+      {
+        return &_container[lfs.localIndex(i)*N];
+      }
+
+      //! Returns the values of the i-th DOF of lfs for all cells (const version).
+      template<typename LFS>
+      const T* operator()(const LFS& lfs, size_type i) const
+      {
+        return &_container[lfs.localIndex(i)*N];
+      }
+
+      //! Direct access to the value of local DOF k of cell e.
+      T& entry(size_type k, size_type e)
+      {
+        return _container[k*N + e];
+      }
+
+      const T& entry(size_type k, size_type e) const
+      {
+        return _container[k*N + e];
+      }
+
+    private:
+
+      std::vector<T> _container;
+      size_type _size;
+
+    };
+
+
+    //! Local jacobians of all cells of an ElementBatch.
+    /**
+     * Like BatchVector, the entries are stored as a structure of arrays: accessing the
+     * container with a pair of local function spaces and DOF indices returns a pointer to the
+     * values of that entry for all cells of the batch.
+     */
+    template<typename T, std::size_t N>
+    class BatchMatrix
+    {
+    public:
+
+      typedef T value_type;
+      typedef std::size_t size_type;
+
+      BatchMatrix()
+        : _rows(0)
+        , _cols(0)
+      {}
+
+      //! Resizes the matrix to r rows and c columns per cell and assigns v to all entries.
+      void assign(size_type r, size_type c, const T& v)
+      {
+        _container.assign(r*c*N,v);
+        _rows = r;
+        _cols = c;
+      }
+
+      size_type nrows() const
+      {
+        return _rows;
+      }
+
+      size_type ncols() const
+      {
+        return _cols;
+      }
+
+      //! Returns the values of the entry for the i-th DOF of lfsv and the j-th DOF of lfsu for all cells.
+      template<typename LFSV, typename LFSU>
+      T* operator()(const LFSV& lfsv, size_type i, const LFSU& lfsu, size_type j)
+      {
+        return &_container[(lfsu.localIndex(j)*_rows + lfsv.localIndex(i))*N];
+      }
+
+      //! Direct access to the entry (i,j) of the local matrix of cell e.
+      T& entry(size_type i, size_type j, size_type e)
+      {
+        return _container[(j*_rows + i)*N + e];
+      }
+
+      const T& entry(size_type i, size_type j, size_type e) const
+      {
+        return _container[(j*_rows + i)*N + e];
+      }
+
+    private:
+
+      std::vector<T> _container;
+      size_type _rows;
+      size_type _cols;
+
+    };
+
+
+#ifndef DOXYGEN
+
+    struct collect_finite_elements
+      : public TypeTree::TreeVisitor
+      , public TypeTree::DynamicTraversal
+    {
+
+      template<typename Node, typename TreePath>
+      void leaf(const Node& node, TreePath tp)
+      {
+        finite_elements.push_back(&node.finiteElement());
+      }
+
+      collect_finite_elements(std::vector<const void*>& finite_elements_)
+        : finite_elements(finite_elements_)
+      {}
+
+      std::vector<const void*>& finite_elements;
+
+    };
+
+#endif // DOXYGEN
+
+    //! Appends the addresses of the finite elements of all leaves of a bound local function space.
+    /**
+     * Two cells can be placed in the same ElementBatch if this signature agrees for both
+     * their trial and test spaces.
+     */
+    template<typename LFS>
+    void finiteElementSignature(const LFS& lfs, std::vector<const void*>& signature)
+    {
+      collect_finite_elements visitor(signature);
+      TypeTree::applyToTree(lfs,visitor);
+    }
+
+    //! \} group GridOperator
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_GRIDOPERATOR_COMMON_ELEMENTBATCH_HH
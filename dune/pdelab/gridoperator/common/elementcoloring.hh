@@ -0,0 +1,226 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_GRIDOPERATOR_COMMON_ELEMENTCOLORING_HH
+#define DUNE_PDELAB_GRIDOPERATOR_COMMON_ELEMENTCOLORING_HH
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#include <dune/common/hash.hh>
+
+#include <dune/pdelab/common/unordered_map.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    /** \addtogroup GridOperator
+     *  \{
+     */
+
+    //! Hash functor for container indices that works for all index types provided by the orderings.
+    struct ContainerIndexHash
+    {
+      template<typename CI>
+      std::size_t operator()(const CI& ci) const
+      {
+        return hash_range(ci.begin(),ci.end());
+      }
+    };
+
+    //! Partition of the cells of a grid view into independent sets for concurrent assembly.
+    /**
+     * Two cells receive different colors whenever the container indices they write to
+     * intersect. The write set of a cell consists of the container indices of its local
+     * test space, the indices its constrained DOFs are distributed to and - if requested -
+     * the same information for all neighbors across an intersection, which covers the
+     * contributions of skeleton terms to the neighbor rows.
+     *
+     * The colors are computed by a greedy algorithm in the order of the grid traversal,
+     * and the cells of each color are stored in that order as well. The resulting
+     * assembly order is thus independent of the number of threads used to process
+     * a single color.
+     *
+     * \tparam GV  The grid view whose cells are colored.
+     */
+    template<typename GV>
+    class ElementColoring
+    {
+
+      typedef typename GV::Traits::template Codim<0>::Iterator ElementIterator;
+      typedef typename GV::IntersectionIterator IntersectionIterator;
+
+    public:
+
+      typedef typename GV::Traits::template Codim<0>::EntityPointer ElementPointer;
+      typedef std::size_t size_type;
+
+      ElementColoring()
+        : _offsets(1,0)
+        , _includes_neighbors(false)
+      {}
+
+      //! Computes the coloring.
+      /**
+       * \param gv                 The grid view to color.
+       * \param lfsv               A local test function space used to extract the DOFs of each cell.
+       * \param lfsv_cache         An index cache bound to lfsv and the test space constraints.
+       * \param include_neighbors  Whether the write set of a cell includes the DOFs of its neighbors.
+       */
+      template<typename LFSV, typename LFSVCache>
+      void build(const GV& gv, LFSV& lfsv, LFSVCache& lfsv_cache, bool include_neighbors)
+      {
+        typedef typename LFSVCache::Ordering::Traits::ContainerIndex CI;
+        typedef unordered_map<CI,size_type,ContainerIndexHash> DOFMap;
+
+        DOFMap dof_map;
+        std::vector<std::vector<size_type> > dof_colors;
+        std::vector<size_type> write_set;
+        std::vector<char> forbidden;
+
+        std::vector<ElementPointer> cells;
+        std::vector<size_type> cell_colors;
+        size_type color_count = 0;
+
+        for (ElementIterator it = gv.template begin<0>(); it != gv.template end<0>(); ++it)
+          {
+            write_set.clear();
+            collect(*it,lfsv,lfsv_cache,dof_map,write_set);
+
+            if (include_neighbors)
+              {
+                IntersectionIterator endit = gv.iend(*it);
+                for (IntersectionIterator iit = gv.ibegin(*it); iit != endit; ++iit)
+                  if (iit->neighbor())
+                    collect(*(iit->outside()),lfsv,lfsv_cache,dof_map,write_set);
+              }
+
+            dof_colors.resize(dof_map.size());
+
+            // Pick the smallest color not yet used by a cell writing to one of our DOFs
+            forbidden.assign(color_count + 1,0);
+            for (std::vector<size_type>::const_iterator dit = write_set.begin(); dit != write_set.end(); ++dit)
+              for (std::vector<size_type>::const_iterator cit = dof_colors[*dit].begin(); cit != dof_colors[*dit].end(); ++cit)
+                forbidden[*cit] = 1;
+
+            const size_type color = std::find(forbidden.begin(),forbidden.end(),0) - forbidden.begin();
+            color_count = std::max(color_count,color + 1);
+
+            for (std::vector<size_type>::const_iterator dit = write_set.begin(); dit != write_set.end(); ++dit)
+              {
+                std::vector<size_type>& colors = dof_colors[*dit];
+                if (std::find(colors.begin(),colors.end(),color) == colors.end())
+                  colors.push_back(color);
+              }
+
+            cells.push_back(ElementPointer(it));
+            cell_colors.push_back(color);
+          }
+
+        // Stable counting sort of the cells by color
+        _offsets.assign(color_count + 1,0);
+        for (size_type i = 0; i < cell_colors.size(); ++i)
+          ++_offsets[cell_colors[i] + 1];
+        for (size_type c = 0; c < color_count; ++c)
+          _offsets[c + 1] += _offsets[c];
+
+        std::vector<size_type> permutation(cells.size());
+        std::vector<size_type> position(_offsets.begin(),_offsets.end() - 1);
+        for (size_type i = 0; i < cell_colors.size(); ++i)
+          permutation[position[cell_colors[i]]++] = i;
+
+        _cells.clear();
+        _cells.reserve(cells.size());
+        for (size_type i = 0; i < permutation.size(); ++i)
+          _cells.push_back(cells[permutation[i]]);
+
+        _includes_neighbors = include_neighbors;
+      }
+
+      //! Discards the coloring, e.g. after the grid or the function spaces have changed.
+      void clear()
+      {
+        _cells.clear();
+        _offsets.assign(1,0);
+        _includes_neighbors = false;
+      }
+
+      //! Returns whether the coloring has been computed.
+      bool empty() const
+      {
+        return _cells.empty();
+      }
+
+      //! Returns whether the write sets used for the coloring included the neighbor DOFs.
+      bool includesNeighbors() const
+      {
+        return _includes_neighbors;
+      }
+
+      //! The number of colors.
+      size_type colors() const
+      {
+        return _offsets.size() - 1;
+      }
+
+      //! The total number of cells.
+      size_type size() const
+      {
+        return _cells.size();
+      }
+
+      //! Index of the first cell of the given color.
+      size_type begin(size_type color) const
+      {
+        return _offsets[color];
+      }
+
+      //! Index one past the last cell of the given color.
+      size_type end(size_type color) const
+      {
+        return _offsets[color + 1];
+      }
+
+      //! Returns the i-th cell in color order.
+      const ElementPointer& cell(size_type i) const
+      {
+        return _cells[i];
+      }
+
+    private:
+
+      template<typename E, typename LFSV, typename LFSVCache, typename DOFMap>
+      static void collect(const E& e, LFSV& lfsv, LFSVCache& lfsv_cache, DOFMap& dof_map, std::vector<size_type>& write_set)
+      {
+        lfsv.bind(e);
+        lfsv_cache.update();
+        for (size_type i = 0; i < lfsv_cache.size(); ++i)
+          {
+            write_set.push_back(dofId(lfsv_cache.containerIndex(i),dof_map));
+            if (lfsv_cache.isConstrained(i))
+              for (typename LFSVCache::ConstraintsIterator cit = lfsv_cache.constraintsBegin(i);
+                   cit != lfsv_cache.constraintsEnd(i);
+                   ++cit)
+                write_set.push_back(dofId(cit->containerIndex(),dof_map));
+          }
+      }
+
+      template<typename CI, typename DOFMap>
+      static size_type dofId(const CI& ci, DOFMap& dof_map)
+      {
+        const size_type next_id = dof_map.size();
+        return dof_map.insert(std::make_pair(ci,next_id)).first->second;
+      }
+
+      std::vector<ElementPointer> _cells;
+      std::vector<size_type> _offsets;
+      bool _includes_neighbors;
+
+    };
+
+    /** \} group GridOperator */
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_GRIDOPERATOR_COMMON_ELEMENTCOLORING_HH
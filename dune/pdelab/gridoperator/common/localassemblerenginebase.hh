@@ -4,6 +4,8 @@
 #ifndef DUNE_PDELAB_GRIDOPERATOR_COMMON_LOCALASSEMBLERENGINEBASE_HH
 #define DUNE_PDELAB_GRIDOPERATOR_COMMON_LOCALASSEMBLERENGINEBASE_HH
 
+#include <type_traits>
+
 namespace Dune {
   namespace PDELab {
 
@@ -99,6 +101,11 @@ namespace Dune {
           return false;
         }
 
+        bool requireUVVolumeBatch() const
+        {
+          return false;
+        }
+
         //! @}
 
         //! @name Callbacks for LocalFunctionSpace binding and unbinding events
@@ -371,6 +378,90 @@ namespace Dune {
       };
 
 
+      //! Traits class that tells whether a LocalAssemblerEngine can be used for colored, thread-parallel assembly.
+      /**
+       * An engine supports threaded assembly if it exports a static constant
+       * \code
+       * static const bool supports_threaded_assembly = true;
+       * \endcode
+       * This promises that a copy of the engine can be used to assemble a subset of the cells
+       * concurrently with other copies, as long as the cells assembled concurrently never
+       * write to the same global DOF. The copies must not share any local scratch data and
+       * the engine must not rely on state accumulated between preAssembly() and postAssembly(),
+       * as only the original engine receives these two calls.
+       */
+      template<typename LAE, typename = void>
+      struct EngineSupportsThreadedAssembly
+        : public std::false_type
+      {};
+
+#ifndef DOXYGEN
+
+      template<typename LAE>
+      struct EngineSupportsThreadedAssembly<LAE,typename std::enable_if<LAE::supports_threaded_assembly>::type>
+        : public std::true_type
+      {};
+
+#endif // DOXYGEN
+
+      //! Traits class that tells whether links to different rows may be added to a matrix pattern concurrently.
+      /**
+       * A pattern builder supports concurrent insertion if it exports a static constant
+       * \code
+       * static const bool supports_concurrent_insertion = true;
+       * \endcode
+       * Only then does the pattern engine take part in the colored, thread-parallel assembly.
+       * Pattern builders that share data between rows, e.g. the Eigen inserter, which works
+       * on the sparse matrix itself, must not export it.
+       */
+      template<typename P, typename = void>
+      struct PatternSupportsConcurrentInsertion
+        : public std::false_type
+      {};
+
+#ifndef DOXYGEN
+
+      template<typename P>
+      struct PatternSupportsConcurrentInsertion<P,typename std::enable_if<P::supports_concurrent_insertion>::type>
+        : public std::true_type
+      {};
+
+#endif // DOXYGEN
+
+      //! Traits class that tells whether a LocalAssemblerEngine can be used for batched assembly.
+      /**
+       * An engine supports batched assembly if it exports a static constant
+       * \code
+       * static const bool supports_batched_assembly = true;
+       * \endcode
+       * and implements the methods
+       * \code
+       * bool requireUVVolumeBatch() const;
+       * template<typename LFSUC> void loadBatchCoefficients(std::size_t slot, const LFSUC& lfsu_cache);
+       * template<typename Batch, typename LFSUC, typename LFSVC>
+       * void assembleUVVolumeBatch(const Batch& batch, const LFSUC& lfsu_cache, const LFSVC& lfsv_cache);
+       * void setBatchSlot(int slot);
+       * \endcode
+       * After assembleUVVolumeBatch() has evaluated the volume terms of a whole ElementBatch,
+       * the assembler visits the cells of the batch one after another with the slot of the
+       * current cell selected by setBatchSlot(). In this state, assembleUVVolume() has to use the
+       * result of the batch instead of calling the local operator. A slot of -1 switches back to
+       * the evaluation of single cells.
+       */
+      template<typename LAE, typename = void>
+      struct EngineSupportsBatchedAssembly
+        : public std::false_type
+      {};
+
+#ifndef DOXYGEN
+
+      template<typename LAE>
+      struct EngineSupportsBatchedAssembly<LAE,typename std::enable_if<LAE::supports_batched_assembly>::type>
+        : public std::true_type
+      {};
+
+#endif // DOXYGEN
+
       //! \} group GridOperator
 
   } // namespace PDELab
@@ -0,0 +1,125 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_GRIDOPERATOR_COMMON_MATRIXSTRUCTURECACHE_HH
+#define DUNE_PDELAB_GRIDOPERATOR_COMMON_MATRIXSTRUCTURECACHE_HH
+
+#include <cstddef>
+#include <typeinfo>
+
+#include <dune/common/shared_ptr.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    /** \addtogroup GridOperator
+     *  \{
+     */
+
+    //! Storage for the sparsity structure of the matrices built from a GridOperator.
+    /**
+     * Matrix containers can store the structure of the first matrix they allocate for a
+     * GridOperator in this cache and set up further matrices from it instead of running
+     * the pattern assembly again. The content of the cache is opaque to the GridOperator,
+     * only its type is checked on retrieval.
+     *
+     * The cache remembers the revisions of the trial and test space it was filled for, as well
+     * as the address and the number of constrained DOFs of the trial and test constraints
+     * containers, and discards its content as soon as validate() is called with a different
+     * value for any of them, i.e. after one of the spaces has been updated or the constraints
+     * have changed. Constraints recomputed in place with the same number of constrained DOFs
+     * go unnoticed; the cache has to be cleared explicitly then.
+     */
+    class MatrixStructureCache
+    {
+
+    public:
+
+      MatrixStructureCache()
+        : _enabled(true)
+        , _type(nullptr)
+        , _trial_revision(0)
+        , _test_revision(0)
+        , _trial_constraints(nullptr)
+        , _trial_constraints_size(0)
+        , _test_constraints(nullptr)
+        , _test_constraints_size(0)
+      {}
+
+      //! Returns whether the cache may be filled.
+      bool enabled() const
+      {
+        return _enabled;
+      }
+
+      //! Enables or disables the cache, disabling also discards its content.
+      void setEnabled(bool enabled)
+      {
+        _enabled = enabled;
+        if (!enabled)
+          clear();
+      }
+
+      //! Returns the cached structure if it has type T, a null pointer otherwise.
+      template<typename T>
+      shared_ptr<const T> get() const
+      {
+        if (_data && *_type == typeid(T))
+          return static_pointer_cast<const T>(_data);
+        return shared_ptr<const T>();
+      }
+
+      //! Stores a new structure, does nothing if the cache is disabled.
+      template<typename T>
+      void set(const shared_ptr<const T>& data)
+      {
+        if (!_enabled)
+          return;
+        _data = data;
+        _type = &typeid(T);
+      }
+
+      //! Discards the cached structure.
+      void clear()
+      {
+        _data.reset();
+        _type = nullptr;
+      }
+
+      //! Discards the cached structure if it was built for different revisions of the function spaces or for different constraints.
+      template<typename CU, typename CV>
+      void validate(std::size_t trial_revision, std::size_t test_revision, const CU& cu, const CV& cv)
+      {
+        if (trial_revision != _trial_revision || test_revision != _test_revision ||
+            &cu != _trial_constraints || cu.size() != _trial_constraints_size ||
+            &cv != _test_constraints || cv.size() != _test_constraints_size)
+          {
+            clear();
+            _trial_revision = trial_revision;
+            _test_revision = test_revision;
+            _trial_constraints = &cu;
+            _trial_constraints_size = cu.size();
+            _test_constraints = &cv;
+            _test_constraints_size = cv.size();
+          }
+      }
+
+    private:
+
+      bool _enabled;
+      shared_ptr<const void> _data;
+      const std::type_info* _type;
+      std::size_t _trial_revision;
+      std::size_t _test_revision;
+      const void* _trial_constraints;
+      std::size_t _trial_constraints_size;
+      const void* _test_constraints;
+      std::size_t _test_constraints_size;
+
+    };
+
+    /** \} group GridOperator */
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_GRIDOPERATOR_COMMON_MATRIXSTRUCTURECACHE_HH
@@ -1,12 +1,26 @@
 #ifndef DUNE_PDELAB_DEFAULT_ASSEMBLER_HH
 #define DUNE_PDELAB_DEFAULT_ASSEMBLER_HH
 
+#include <exception>
+#include <type_traits>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <dune/common/shared_ptr.hh>
 #include <dune/common/typetraits.hh>
 #include <dune/pdelab/gridoperator/common/assemblerutilities.hh>
+#include <dune/pdelab/gridoperator/common/elementbatch.hh>
+#include <dune/pdelab/gridoperator/common/elementcoloring.hh>
+#include <dune/pdelab/gridoperator/common/localassemblerenginebase.hh>
+#include <dune/pdelab/gridfunctionspace/connectivitytable.hh>
 #include <dune/pdelab/gridfunctionspace/localfunctionspace.hh>
 #include <dune/pdelab/gridfunctionspace/lfsindexcache.hh>
 #include <dune/pdelab/common/elementmapper.hh>
 #include <dune/pdelab/common/geometrywrapper.hh>
+#include <dune/pdelab/common/performancetrace.hh>
 
 namespace Dune{
   namespace PDELab{
@@ -44,6 +58,12 @@ namespace Dune{
       //! Static check on whether this is a Galerkin method
       static const bool isGalerkinMethod = Dune::is_same<GFSU,GFSV>::value;
 
+      //! Local function spaces
+      //! @{
+      typedef LocalFunctionSpace<GFSU, TrialSpaceTag> LFSU;
+      typedef LocalFunctionSpace<GFSV, TestSpaceTag> LFSV;
+      //! @}
+
       DefaultAssembler (const GFSU& gfsu_, const GFSV& gfsv_, const CU& cu_, const CV& cv_)
         : gfsu(gfsu_)
         , gfsv(gfsv_)
@@ -53,6 +73,14 @@ namespace Dune{
         , lfsv(gfsv_)
         , lfsun(gfsu_)
         , lfsvn(gfsv_)
+        , colored_assembly(false)
+        , thread_count(0)
+        , coloring_revision(0)
+        , overlapped_communication(false)
+        , border_cells_revision(0)
+        , border_cells_neighbors(false)
+        , batched_assembly(false)
+        , precomputed_connectivity(false)
       { }
 
       DefaultAssembler (const GFSU& gfsu_, const GFSV& gfsv_)
@@ -64,6 +92,14 @@ namespace Dune{
         , lfsv(gfsv_)
         , lfsun(gfsu_)
         , lfsvn(gfsv_)
+        , colored_assembly(false)
+        , thread_count(0)
+        , coloring_revision(0)
+        , overlapped_communication(false)
+        , border_cells_revision(0)
+        , border_cells_neighbors(false)
+        , batched_assembly(false)
+        , precomputed_connectivity(false)
       { }
 
       //! Get the trial grid function space
@@ -87,8 +123,321 @@ namespace Dune{
       template<class LocalAssemblerEngine>
       void assemble(LocalAssemblerEngine & assembler_engine) const
       {
-        typedef typename GV::Traits::template Codim<0>::Entity Element;
+        prepareConnectivity();
+        if (colored_assembly)
+          assembleColored(assembler_engine,
+                          std::integral_constant<bool,EngineSupportsThreadedAssembly<LocalAssemblerEngine>::value>());
+        else if (batched_assembly)
+          assembleBatched(assembler_engine,
+                          std::integral_constant<bool,EngineSupportsBatchedAssembly<LocalAssemblerEngine>::value>());
+        else
+          assembleSequential(assembler_engine);
+      }
+
+      //! Switch between the default grid traversal and colored, thread-parallel assembly.
+      /**
+       * In colored mode, the cells of the grid view are partitioned into colors such that
+       * no two cells of the same color write to the same residual entry or matrix row (see
+       * ElementColoring). The colors are processed one after another, and the cells of each
+       * color are distributed across the threads, each of which works on its own local
+       * function spaces, index caches and copy of the assembler engine. Every global entry thus
+       * receives its contributions in an order that only depends on the coloring, which makes
+       * the result bitwise independent of the number of threads.
+       *
+       * The coloring is computed on first use and reused until update() is called.
+       * Only engines that support threaded assembly (see EngineSupportsThreadedAssembly)
+       * are run in parallel, all other engines fall back to the sequential traversal.
+       *
+       * \note Threading is implemented with OpenMP and requires compiling with OpenMP
+       *       support (add_dune_openmp_flags() with CMake, $(OPENMP_CXXFLAGS) with
+       *       autotools), otherwise the colors are processed sequentially. The local operator
+       *       is shared between the threads, so its methods must be safe to call concurrently.
+       */
+      void setColoredAssembly(bool enable)
+      {
+        colored_assembly = enable;
+      }
+
+      //! Returns whether colored assembly is enabled.
+      bool coloredAssembly() const
+      {
+        return colored_assembly;
+      }
+
+      //! Sets the number of threads used for colored assembly, 0 selects the OpenMP default.
+      void setThreads(int threads)
+      {
+        thread_count = threads;
+      }
+
+      //! Returns the number of threads used for colored assembly, 0 means the OpenMP default.
+      int threads() const
+      {
+        return thread_count;
+      }
+
+      //! Returns the coloring used for colored assembly, computing it if necessary.
+      /**
+       * \param include_neighbors  Whether the coloring has to account for skeleton contributions
+       *                           to neighboring cells.
+       */
+      const ElementColoring<GV>& coloring(bool include_neighbors = false) const
+      {
+        if (element_coloring.empty() ||
+            coloring_revision != gfsv.revision() ||
+            (include_neighbors && !element_coloring.includesNeighbors()))
+          {
+            PerformanceTrace::Region region("coloring","assembly");
+            LFSIndexCache<LFSV,CV> lfsv_cache(lfsv,cv);
+            element_coloring.build(gfsv.gridView(),lfsv,lfsv_cache,include_neighbors);
+            coloring_revision = gfsv.revision();
+          }
+        return element_coloring;
+      }
+
+      //! Switch the overlapping of the border DOF exchange with the assembly of the interior on or off.
+      /**
+       * In nonoverlapping mode, the matrix entries of border DOFs have to be summed up across
+       * the processes after assembly. If this mode is enabled, the grid operator assembles the
+       * cells touching the processor boundary first (see assembleBorderFirst()), starts the
+       * exchange of the border entries without waiting for it, assembles the remaining cells while
+       * the messages are in flight and only completes the exchange at the end.
+       *
+       * The mode has no effect in overlapping mode, for sequential runs and for colored assembly.
+       */
+      void setOverlappedCommunication(bool enable)
+      {
+        overlapped_communication = enable;
+      }
+
+      //! Returns whether the border DOF exchange is overlapped with the assembly of the interior.
+      bool overlappedCommunication() const
+      {
+        return overlapped_communication;
+      }
+
+      //! Assembles the cells touching the processor boundary first and calls border_assembled() before the remaining cells.
+      /**
+       * Border cells are those with a vertex on the processor boundary. If the engine requires
+       * skeleton terms, the face neighbors of these cells are treated as border cells as well,
+       * as they may contribute to border DOFs through the skeleton. Thus, once border_assembled()
+       * is called, the rows of all border DOFs are complete, except for the postprocessing done
+       * in LocalAssemblerEngine::postAssembly().
+       *
+       * Falls back to assemble() without calling border_assembled() if the grid operator is not
+       * in nonoverlapping mode, if there is only a single process or if colored assembly is enabled.
+       */
+      template<class LocalAssemblerEngine, class Callback>
+      void assembleBorderFirst(LocalAssemblerEngine & assembler_engine, Callback & border_assembled) const
+      {
+        if (!nonoverlapping_mode || colored_assembly || gfsu.gridView().comm().size() == 1)
+          {
+            assemble(assembler_engine);
+            return;
+          }
+
+        prepareConnectivity();
+
+        typedef typename std::conditional<
+          LocalAssemblerEngine::needs_constraints_caching,
+          LFSIndexCache<LFSU,CU>,
+          LFSIndexCache<LFSU,EmptyTransformation>
+          >::type LFSUCache;
+
+        typedef typename std::conditional<
+          LocalAssemblerEngine::needs_constraints_caching,
+          LFSIndexCache<LFSV,CV>,
+          LFSIndexCache<LFSV,EmptyTransformation>
+          >::type LFSVCache;
+
+        LFSUCache lfsu_cache(lfsu,cu);
+        LFSVCache lfsv_cache(lfsv,cv);
+        LFSUCache lfsun_cache(lfsun,cu);
+        LFSVCache lfsvn_cache(lfsvn,cv);
+
+        // Map each cell to unique id
+        ElementMapper<GV> cell_mapper(gfsu.gridView());
+
+        const std::vector<char>& border = borderCells(
+          cell_mapper,
+          assembler_engine.requireUVSkeleton() || assembler_engine.requireVSkeleton());
+
+        // Notify assembler engine about oncoming assembly
+        assembler_engine.preAssembly();
+
+        // Traverse the border cells, then start the exchange and traverse the interior
+        {
+          PerformanceTrace::Region region("grid traversal","assembly");
+          for (ElementIterator it = gfsu.gridView().template begin<0>();
+               it!=gfsu.gridView().template end<0>(); ++it)
+            if (border[cell_mapper.map(*it)])
+              assembleElement(assembler_engine,*it,cell_mapper,
+                              lfsu,lfsv,lfsun,lfsvn,
+                              lfsu_cache,lfsv_cache,lfsun_cache,lfsvn_cache);
+        }
+
+        border_assembled();
+
+        {
+          PerformanceTrace::Region region("grid traversal","assembly");
+          for (ElementIterator it = gfsu.gridView().template begin<0>();
+               it!=gfsu.gridView().template end<0>(); ++it)
+            if (!border[cell_mapper.map(*it)])
+              assembleElement(assembler_engine,*it,cell_mapper,
+                              lfsu,lfsv,lfsun,lfsvn,
+                              lfsu_cache,lfsv_cache,lfsun_cache,lfsvn_cache);
+        }
+
+        // Notify assembler engine that assembly is finished
+        PerformanceTrace::Region region("post assembly","assembly");
+        assembler_engine.postAssembly(gfsu,gfsv);
+      }
+
+      //! Switch the evaluation of the volume terms on batches of cells on or off.
+      /**
+       * In batched mode, the grid traversal collects up to LocalAssemblerEngine::batch_size
+       * consecutive cells that use the same finite elements into an ElementBatch and evaluates
+       * their volume terms with a single call to the alpha_volume_batch() or
+       * jacobian_volume_batch() method of the local operator, which can then vectorize its
+       * kernels across the cells of the batch (see LocalOperatorSupportsBatchedVolume). Afterwards,
+       * the cells of the batch are visited one after another to add the volume contributions and to
+       * assemble all remaining terms as usual, so skeleton and boundary terms are not batched.
+       *
+       * The mode only affects engines that support batched assembly (see
+       * EngineSupportsBatchedAssembly) for local operators that provide the batched methods, all
+       * other assemblies use the default traversal. Colored assembly takes precedence over
+       * this mode, and the border first traversal of assembleBorderFirst() is not batched either.
+       */
+      void setBatchedAssembly(bool enable)
+      {
+        batched_assembly = enable;
+      }
+
+      //! Returns whether the volume terms are evaluated on batches of cells.
+      bool batchedAssembly() const
+      {
+        return batched_assembly;
+      }
+
+      //! Switch the use of precomputed connectivity tables for updating the index caches on or off.
+      /**
+       * After binding the local function spaces to a cell, the traversal has to update their
+       * index caches, which maps all DOF indices of the cell to container indices through the
+       * ordering and looks up every DOF in the constraints container. With this mode enabled,
+       * the assembler instead builds a GFSConnectivityTable for the trial and the test space
+       * on first use, which stores the container indices and constraint flags of all cells, and
+       * updates the caches by copying the span of the current cell. Only DOFs with
+       * non-Dirichlet constraints (e.g. hanging nodes) are still looked up in the constraints.
+       *
+       * The tables are rebuilt automatically after the trial or test space has been updated or
+       * the number of constrained DOFs has changed (see GFSConnectivityTable::valid()). As other
+       * changes of the constraints cannot be detected, update() has to be called after
+       * recomputing them. The mode is off by default, as the tables store all container
+       * indices of the space once per cell.
+       */
+      void setPrecomputedConnectivity(bool enable)
+      {
+        precomputed_connectivity = enable;
+        if (!enable)
+          {
+            trial_connectivity.clear();
+            test_connectivity.clear();
+          }
+      }
 
+      //! Returns whether the index caches are updated from precomputed connectivity tables.
+      bool precomputedConnectivity() const
+      {
+        return precomputed_connectivity;
+      }
+
+      //! Discards all data cached by the assembler, has to be called after the grid, the function spaces or the constraints changed.
+      void update()
+      {
+        element_coloring.clear();
+        border_cells.clear();
+        trial_connectivity.clear();
+        test_connectivity.clear();
+      }
+
+    private:
+
+      //! Builds the connectivity tables if precomputed connectivity is enabled and they are out of date.
+      void prepareConnectivity() const
+      {
+        if (!precomputed_connectivity)
+          return;
+        if (!trial_connectivity.valid(gfsu,cu))
+          trial_connectivity.assign(gfsu,cu);
+        if (!test_connectivity.valid(gfsv,cv))
+          test_connectivity.assign(gfsv,cv);
+      }
+
+      //! Updates an index cache of the trial space after binding it to the given cell.
+      template<typename LFSUCache>
+      void updateTrialCache(LFSUCache & lfsu_cache, std::size_t cell) const
+      {
+        if (precomputed_connectivity)
+          lfsu_cache.update(trial_connectivity,cell);
+        else
+          lfsu_cache.update();
+      }
+
+      //! Updates an index cache of the test space after binding it to the given cell.
+      template<typename LFSVCache>
+      void updateTestCache(LFSVCache & lfsv_cache, std::size_t cell) const
+      {
+        if (precomputed_connectivity)
+          lfsv_cache.update(test_connectivity,cell);
+        else
+          lfsv_cache.update();
+      }
+
+      //! Flags the cells touching the processor boundary, computed once per revision of the test space.
+      const std::vector<char>& borderCells(const ElementMapper<GV>& cell_mapper, bool include_neighbors) const
+      {
+        if (!border_cells.empty() &&
+            border_cells_revision == gfsv.revision() &&
+            (border_cells_neighbors || !include_neighbors))
+          return border_cells;
+
+        PerformanceTrace::Region region("border cells","assembly");
+        const GV& gv = gfsu.gridView();
+        const int dim = GV::dimension;
+        border_cells.assign(gv.indexSet().size(0),0);
+        for (ElementIterator it = gv.template begin<0>(); it != gv.template end<0>(); ++it)
+          for (int i = 0; i < it->template count<dim>(); ++i)
+            if (it->template subEntity<dim>(i)->partitionType() == BorderEntity)
+              {
+                border_cells[cell_mapper.map(*it)] = 1;
+                break;
+              }
+
+        if (include_neighbors)
+          {
+            std::vector<char> border_vertex_cells(border_cells);
+            for (ElementIterator it = gv.template begin<0>(); it != gv.template end<0>(); ++it)
+              {
+                if (border_vertex_cells[cell_mapper.map(*it)])
+                  continue;
+                IntersectionIterator endit = gv.iend(*it);
+                for (IntersectionIterator iit = gv.ibegin(*it); iit != endit; ++iit)
+                  if (iit->neighbor() && border_vertex_cells[cell_mapper.map(*(iit->outside()))])
+                    {
+                      border_cells[cell_mapper.map(*it)] = 1;
+                      break;
+                    }
+              }
+          }
+
+        border_cells_revision = gfsv.revision();
+        border_cells_neighbors = include_neighbors;
+        return border_cells;
+      }
+
+      template<class LocalAssemblerEngine>
+      void assembleSequential(LocalAssemblerEngine & assembler_engine) const
+      {
         typedef typename std::conditional<
           LocalAssemblerEngine::needs_constraints_caching,
           LFSIndexCache<LFSU,CU>,
@@ -112,6 +461,269 @@ namespace Dune{
         // Map each cell to unique id
         ElementMapper<GV> cell_mapper(gfsu.gridView());
 
+        // Traverse grid view
+        {
+          PerformanceTrace::Region region("grid traversal","assembly");
+          for (ElementIterator it = gfsu.gridView().template begin<0>();
+               it!=gfsu.gridView().template end<0>(); ++it)
+            assembleElement(assembler_engine,*it,cell_mapper,
+                            lfsu,lfsv,lfsun,lfsvn,
+                            lfsu_cache,lfsv_cache,lfsun_cache,lfsvn_cache);
+        }
+
+        // Notify assembler engine that assembly is finished
+        PerformanceTrace::Region region("post assembly","assembly");
+        assembler_engine.postAssembly(gfsu,gfsv);
+      }
+
+      //! Fallback for engines that cannot evaluate batches of cells.
+      template<class LocalAssemblerEngine>
+      void assembleBatched(LocalAssemblerEngine & assembler_engine, std::false_type) const
+      {
+        assembleSequential(assembler_engine);
+      }
+
+      template<class LocalAssemblerEngine>
+      void assembleBatched(LocalAssemblerEngine & assembler_engine, std::true_type) const
+      {
+        if (!assembler_engine.requireUVVolumeBatch())
+          {
+            assembleSequential(assembler_engine);
+            return;
+          }
+
+        typedef typename std::conditional<
+          LocalAssemblerEngine::needs_constraints_caching,
+          LFSIndexCache<LFSU,CU>,
+          LFSIndexCache<LFSU,EmptyTransformation>
+          >::type LFSUCache;
+
+        typedef typename std::conditional<
+          LocalAssemblerEngine::needs_constraints_caching,
+          LFSIndexCache<LFSV,CV>,
+          LFSIndexCache<LFSV,EmptyTransformation>
+          >::type LFSVCache;
+
+        typedef ElementBatch<GV,LocalAssemblerEngine::batch_size> Batch;
+
+        // Every slot of the batch keeps its cell bound until the batch has been assembled
+        std::vector<shared_ptr<LFSU> > slot_lfsu(Batch::lanes);
+        std::vector<shared_ptr<LFSV> > slot_lfsv(Batch::lanes);
+        std::vector<shared_ptr<LFSUCache> > slot_lfsu_cache(Batch::lanes);
+        std::vector<shared_ptr<LFSVCache> > slot_lfsv_cache(Batch::lanes);
+        for (std::size_t slot = 0; slot < Batch::lanes; ++slot)
+          {
+            slot_lfsu[slot] = make_shared<LFSU>(gfsu);
+            slot_lfsv[slot] = make_shared<LFSV>(gfsv);
+            slot_lfsu_cache[slot] = make_shared<LFSUCache>(*slot_lfsu[slot],cu);
+            slot_lfsv_cache[slot] = make_shared<LFSVCache>(*slot_lfsv[slot],cv);
+          }
+
+        LFSUCache lfsun_cache(lfsun,cu);
+        LFSVCache lfsvn_cache(lfsvn,cv);
+
+        Batch batch;
+        std::vector<const void*> batch_signature;
+        std::vector<const void*> signature;
+
+        // Notify assembler engine about oncoming assembly
+        assembler_engine.preAssembly();
+
+        // Map each cell to unique id
+        ElementMapper<GV> cell_mapper(gfsu.gridView());
+
+        // Traverse grid view
+        {
+          PerformanceTrace::Region region("grid traversal","assembly");
+          for (ElementIterator it = gfsu.gridView().template begin<0>();
+               it!=gfsu.gridView().template end<0>(); ++it)
+            {
+              ElementGeometry<Element> eg(*it);
+              if (assembler_engine.assembleCell(eg))
+                continue;
+
+              std::size_t slot = batch.size();
+              bindSlot(*it,cell_mapper,*slot_lfsu[slot],*slot_lfsv[slot],*slot_lfsu_cache[slot],*slot_lfsv_cache[slot]);
+
+              // All cells of a batch have to use the same finite elements
+              signature.clear();
+              finiteElementSignature(*slot_lfsu[slot],signature);
+              finiteElementSignature(*slot_lfsv[slot],signature);
+              if (slot > 0 && signature != batch_signature)
+                {
+                  assembleBatch(assembler_engine,batch,cell_mapper,
+                                slot_lfsu,slot_lfsv,slot_lfsu_cache,slot_lfsv_cache,
+                                lfsun_cache,lfsvn_cache);
+                  slot = 0;
+                  bindSlot(*it,cell_mapper,*slot_lfsu[slot],*slot_lfsv[slot],*slot_lfsu_cache[slot],*slot_lfsv_cache[slot]);
+                }
+              if (slot == 0)
+                batch_signature.swap(signature);
+
+              assembler_engine.loadBatchCoefficients(slot,*slot_lfsu_cache[slot]);
+              batch.push_back(it);
+
+              if (batch.full())
+                assembleBatch(assembler_engine,batch,cell_mapper,
+                              slot_lfsu,slot_lfsv,slot_lfsu_cache,slot_lfsv_cache,
+                              lfsun_cache,lfsvn_cache);
+            }
+
+          assembleBatch(assembler_engine,batch,cell_mapper,
+                        slot_lfsu,slot_lfsv,slot_lfsu_cache,slot_lfsv_cache,
+                        lfsun_cache,lfsvn_cache);
+        }
+
+        // Notify assembler engine that assembly is finished
+        PerformanceTrace::Region region("post assembly","assembly");
+        assembler_engine.postAssembly(gfsu,gfsv);
+      }
+
+      template<typename LFSUCache, typename LFSVCache>
+      void bindSlot(const Element & element, const ElementMapper<GV> & cell_mapper,
+                    LFSU & lfsu, LFSV & lfsv,
+                    LFSUCache & lfsu_cache, LFSVCache & lfsv_cache) const
+      {
+        const std::size_t cell = cell_mapper.map(element);
+        lfsv.bind(element);
+        updateTestCache(lfsv_cache,cell);
+        lfsu.bind(element);
+        updateTrialCache(lfsu_cache,cell);
+      }
+
+      //! Evaluates the volume terms of a batch, then assembles its cells one by one and empties the batch.
+      template<class LocalAssemblerEngine, typename Batch, typename LFSUCache, typename LFSVCache>
+      void assembleBatch(LocalAssemblerEngine & assembler_engine,
+                         Batch & batch,
+                         const ElementMapper<GV> & cell_mapper,
+                         const std::vector<shared_ptr<LFSU> > & slot_lfsu,
+                         const std::vector<shared_ptr<LFSV> > & slot_lfsv,
+                         const std::vector<shared_ptr<LFSUCache> > & slot_lfsu_cache,
+                         const std::vector<shared_ptr<LFSVCache> > & slot_lfsv_cache,
+                         LFSUCache & lfsun_cache, LFSVCache & lfsvn_cache) const
+      {
+        if (batch.empty())
+          return;
+
+        assembler_engine.assembleUVVolumeBatch(batch,*slot_lfsu_cache[0],*slot_lfsv_cache[0]);
+
+        for (std::size_t slot = 0; slot < batch.size(); ++slot)
+          {
+            assembler_engine.setBatchSlot(slot);
+            assembleElement(assembler_engine,batch.element(slot),cell_mapper,
+                            *slot_lfsu[slot],*slot_lfsv[slot],lfsun,lfsvn,
+                            *slot_lfsu_cache[slot],*slot_lfsv_cache[slot],lfsun_cache,lfsvn_cache,
+                            true);
+          }
+        assembler_engine.setBatchSlot(-1);
+
+        batch.clear();
+      }
+
+      //! Fallback for engines that cannot be copied for threaded assembly.
+      template<class LocalAssemblerEngine>
+      void assembleColored(LocalAssemblerEngine & assembler_engine, std::false_type) const
+      {
+        assembleSequential(assembler_engine);
+      }
+
+      template<class LocalAssemblerEngine>
+      void assembleColored(LocalAssemblerEngine & assembler_engine, std::true_type) const
+      {
+        typedef typename std::conditional<
+          LocalAssemblerEngine::needs_constraints_caching,
+          LFSIndexCache<LFSU,CU>,
+          LFSIndexCache<LFSU,EmptyTransformation>
+          >::type LFSUCache;
+
+        typedef typename std::conditional<
+          LocalAssemblerEngine::needs_constraints_caching,
+          LFSIndexCache<LFSV,CV>,
+          LFSIndexCache<LFSV,EmptyTransformation>
+          >::type LFSVCache;
+
+        const bool require_skeleton =
+          assembler_engine.requireUVSkeleton() || assembler_engine.requireVSkeleton();
+        const ElementColoring<GV>& cells = coloring(require_skeleton);
+
+        // Notify assembler engine about oncoming assembly
+        assembler_engine.preAssembly();
+
+        // Map each cell to unique id
+        const ElementMapper<GV> cell_mapper(gfsu.gridView());
+
+        std::exception_ptr error;
+
+        PerformanceTrace::Region traversal_region("grid traversal","assembly");
+
+#ifdef _OPENMP
+        const int threads = thread_count > 0 ? thread_count : omp_get_max_threads();
+#pragma omp parallel num_threads(threads)
+#endif
+        {
+          // Per-thread local function spaces, index caches and engine
+          LFSU t_lfsu(gfsu);
+          LFSV t_lfsv(gfsv);
+          LFSU t_lfsun(gfsu);
+          LFSV t_lfsvn(gfsv);
+
+          LFSUCache lfsu_cache(t_lfsu,cu);
+          LFSVCache lfsv_cache(t_lfsv,cv);
+          LFSUCache lfsun_cache(t_lfsun,cu);
+          LFSVCache lfsvn_cache(t_lfsvn,cv);
+
+          LocalAssemblerEngine engine(assembler_engine);
+
+          for (std::size_t color = 0; color < cells.colors(); ++color)
+            {
+              const long color_begin = cells.begin(color);
+              const long color_end = cells.end(color);
+
+              // The implicit barrier at the end of the loop separates the colors
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+              for (long i = color_begin; i < color_end; ++i)
+                {
+                  try
+                    {
+                      assembleElement(engine,*(cells.cell(i)),cell_mapper,
+                                      t_lfsu,t_lfsv,t_lfsun,t_lfsvn,
+                                      lfsu_cache,lfsv_cache,lfsun_cache,lfsvn_cache);
+                    }
+                  catch (...)
+                    {
+#ifdef _OPENMP
+#pragma omp critical (dune_pdelab_default_assembler_error)
+#endif
+                      {
+                        if (!error)
+                          error = std::current_exception();
+                      }
+                    }
+                }
+            }
+        }
+
+        if (error)
+          std::rethrow_exception(error);
+
+        traversal_region.end();
+
+        // Notify assembler engine that assembly is finished
+        PerformanceTrace::Region region("post assembly","assembly");
+        assembler_engine.postAssembly(gfsu,gfsv);
+      }
+
+      template<class LocalAssemblerEngine, typename LFSUCache, typename LFSVCache>
+      void assembleElement(LocalAssemblerEngine & assembler_engine,
+                           const Element & element,
+                           const ElementMapper<GV> & cell_mapper,
+                           LFSU & lfsu, LFSV & lfsv, LFSU & lfsun, LFSV & lfsvn,
+                           LFSUCache & lfsu_cache, LFSVCache & lfsv_cache,
+                           LFSUCache & lfsun_cache, LFSVCache & lfsvn_cache,
+                           bool bound = false) const
+      {
         // Extract integration requirements from the local assembler
         const bool require_uv_skeleton = assembler_engine.requireUVSkeleton();
         const bool require_v_skeleton = assembler_engine.requireVSkeleton();
@@ -123,168 +735,164 @@ namespace Dune{
         const bool require_v_post_skeleton = assembler_engine.requireVVolumePostSkeleton();
         const bool require_skeleton_two_sided = assembler_engine.requireSkeletonTwoSided();
 
-        // Traverse grid view
-        for (ElementIterator it = gfsu.gridView().template begin<0>();
-             it!=gfsu.gridView().template end<0>(); ++it)
-          {
-            // Compute unique id
-            const typename GV::IndexSet::IndexType ids = cell_mapper.map(*it);
+        // Compute unique id
+        const typename GV::IndexSet::IndexType ids = cell_mapper.map(element);
 
-            ElementGeometry<Element> eg(*it);
+        ElementGeometry<Element> eg(element);
 
-            if(assembler_engine.assembleCell(eg))
-              continue;
+        // Cells of a batch have already been checked and bound
+        if(!bound && assembler_engine.assembleCell(eg))
+          return;
 
-            // Bind local test function space to element
-            lfsv.bind( *it );
-            lfsv_cache.update();
+        // Bind local test function space to element
+        if (!bound)
+          {
+            lfsv.bind( element );
+            updateTestCache(lfsv_cache,ids);
+          }
 
-            // Notify assembler engine about bind
-            assembler_engine.onBindLFSV(eg,lfsv_cache);
+        // Notify assembler engine about bind
+        assembler_engine.onBindLFSV(eg,lfsv_cache);
 
-            // Volume integration
-            assembler_engine.assembleVVolume(eg,lfsv_cache);
+        // Volume integration
+        assembler_engine.assembleVVolume(eg,lfsv_cache);
 
-            // Bind local trial function space to element
-            lfsu.bind( *it );
-            lfsu_cache.update();
+        // Bind local trial function space to element
+        if (!bound)
+          {
+            lfsu.bind( element );
+            updateTrialCache(lfsu_cache,ids);
+          }
 
-            // Notify assembler engine about bind
-            assembler_engine.onBindLFSUV(eg,lfsu_cache,lfsv_cache);
+        // Notify assembler engine about bind
+        assembler_engine.onBindLFSUV(eg,lfsu_cache,lfsv_cache);
 
-            // Load coefficients of local functions
-            assembler_engine.loadCoefficientsLFSUInside(lfsu_cache);
+        // Load coefficients of local functions
+        assembler_engine.loadCoefficientsLFSUInside(lfsu_cache);
 
-            // Volume integration
-            assembler_engine.assembleUVVolume(eg,lfsu_cache,lfsv_cache);
+        // Volume integration
+        assembler_engine.assembleUVVolume(eg,lfsu_cache,lfsv_cache);
 
-            // Skip if no intersection iterator is needed
-            if (require_uv_skeleton || require_v_skeleton ||
-                require_uv_boundary || require_v_boundary ||
-                require_uv_processor || require_v_processor)
+        // Skip if no intersection iterator is needed
+        if (require_uv_skeleton || require_v_skeleton ||
+            require_uv_boundary || require_v_boundary ||
+            require_uv_processor || require_v_processor)
+          {
+            // Traverse intersections
+            unsigned int intersection_index = 0;
+            IntersectionIterator endit = gfsu.gridView().iend(element);
+            IntersectionIterator iit = gfsu.gridView().ibegin(element);
+            for(; iit!=endit; ++iit, ++intersection_index)
               {
-                // Traverse intersections
-                unsigned int intersection_index = 0;
-                IntersectionIterator endit = gfsu.gridView().iend(*it);
-                IntersectionIterator iit = gfsu.gridView().ibegin(*it);
-                for(; iit!=endit; ++iit, ++intersection_index)
-                  {
 
-                    IntersectionGeometry<Intersection> ig(*iit,intersection_index);
+                IntersectionGeometry<Intersection> ig(*iit,intersection_index);
 
-                    switch (IntersectionType::get(*iit))
+                switch (IntersectionType::get(*iit))
+                  {
+                  case IntersectionType::skeleton:
+                    // the specific ordering of the if-statements in the old code caused periodic
+                    // boundary intersection to be handled the same as skeleton intersections
+                  case IntersectionType::periodic:
+                    if (require_uv_skeleton || require_v_skeleton)
                       {
-                      case IntersectionType::skeleton:
-                        // the specific ordering of the if-statements in the old code caused periodic
-                        // boundary intersection to be handled the same as skeleton intersections
-                      case IntersectionType::periodic:
-                        if (require_uv_skeleton || require_v_skeleton)
-                          {
-                            // compute unique id for neighbor
-
-                            const typename GV::IndexSet::IndexType idn = cell_mapper.map(*(iit->outside()));
+                        // compute unique id for neighbor
 
-                            // Visit face if id is bigger
-                            bool visit_face = ids > idn || require_skeleton_two_sided;
+                        const typename GV::IndexSet::IndexType idn = cell_mapper.map(*(iit->outside()));
 
-                            // unique vist of intersection
-                            if (visit_face)
-                              {
-                                // Bind local test space to neighbor element
-                                lfsvn.bind(*(iit->outside()));
-                                lfsvn_cache.update();
+                        // Visit face if id is bigger
+                        bool visit_face = ids > idn || require_skeleton_two_sided;
 
-                                // Notify assembler engine about binds
-                                assembler_engine.onBindLFSVOutside(ig,lfsv_cache,lfsvn_cache);
-
-                                // Skeleton integration
-                                assembler_engine.assembleVSkeleton(ig,lfsv_cache,lfsvn_cache);
+                        // unique vist of intersection
+                        if (visit_face)
+                          {
+                            // Bind local test space to neighbor element
+                            lfsvn.bind(*(iit->outside()));
+                            updateTestCache(lfsvn_cache,idn);
 
-                                if(require_uv_skeleton){
+                            // Notify assembler engine about binds
+                            assembler_engine.onBindLFSVOutside(ig,lfsv_cache,lfsvn_cache);
 
-                                  // Bind local trial space to neighbor element
-                                  lfsun.bind(*(iit->outside()));
-                                  lfsun_cache.update();
+                            // Skeleton integration
+                            assembler_engine.assembleVSkeleton(ig,lfsv_cache,lfsvn_cache);
 
-                                  // Notify assembler engine about binds
-                                  assembler_engine.onBindLFSUVOutside(ig,
-                                                                      lfsu_cache,lfsv_cache,
-                                                                      lfsun_cache,lfsvn_cache);
+                            if(require_uv_skeleton){
 
-                                  // Load coefficients of local functions
-                                  assembler_engine.loadCoefficientsLFSUOutside(lfsun_cache);
+                              // Bind local trial space to neighbor element
+                              lfsun.bind(*(iit->outside()));
+                              updateTrialCache(lfsun_cache,idn);
 
-                                  // Skeleton integration
-                                  assembler_engine.assembleUVSkeleton(ig,lfsu_cache,lfsv_cache,lfsun_cache,lfsvn_cache);
+                              // Notify assembler engine about binds
+                              assembler_engine.onBindLFSUVOutside(ig,
+                                                                  lfsu_cache,lfsv_cache,
+                                                                  lfsun_cache,lfsvn_cache);
 
-                                  // Notify assembler engine about unbinds
-                                  assembler_engine.onUnbindLFSUVOutside(ig,
-                                                                        lfsu_cache,lfsv_cache,
-                                                                        lfsun_cache,lfsvn_cache);
-                                }
+                              // Load coefficients of local functions
+                              assembler_engine.loadCoefficientsLFSUOutside(lfsun_cache);
 
-                                // Notify assembler engine about unbinds
-                                assembler_engine.onUnbindLFSVOutside(ig,lfsv_cache,lfsvn_cache);
-                              }
-                          }
-                        break;
+                              // Skeleton integration
+                              assembler_engine.assembleUVSkeleton(ig,lfsu_cache,lfsv_cache,lfsun_cache,lfsvn_cache);
 
-                      case IntersectionType::boundary:
-                        if(require_uv_boundary || require_v_boundary )
-                          {
-
-                            // Boundary integration
-                            assembler_engine.assembleVBoundary(ig,lfsv_cache);
-
-                            if(require_uv_boundary){
-                              // Boundary integration
-                              assembler_engine.assembleUVBoundary(ig,lfsu_cache,lfsv_cache);
+                              // Notify assembler engine about unbinds
+                              assembler_engine.onUnbindLFSUVOutside(ig,
+                                                                    lfsu_cache,lfsv_cache,
+                                                                    lfsun_cache,lfsvn_cache);
                             }
+
+                            // Notify assembler engine about unbinds
+                            assembler_engine.onUnbindLFSVOutside(ig,lfsv_cache,lfsvn_cache);
                           }
-                        break;
+                      }
+                    break;
 
-                      case IntersectionType::processor:
-                        if(require_uv_processor || require_v_processor )
-                          {
+                  case IntersectionType::boundary:
+                    if(require_uv_boundary || require_v_boundary )
+                      {
 
-                            // Processor integration
-                            assembler_engine.assembleVProcessor(ig,lfsv_cache);
+                        // Boundary integration
+                        assembler_engine.assembleVBoundary(ig,lfsv_cache);
 
-                            if(require_uv_processor){
-                              // Processor integration
-                              assembler_engine.assembleUVProcessor(ig,lfsu_cache,lfsv_cache);
-                            }
-                          }
-                        break;
-                      } // switch
+                        if(require_uv_boundary){
+                          // Boundary integration
+                          assembler_engine.assembleUVBoundary(ig,lfsu_cache,lfsv_cache);
+                        }
+                      }
+                    break;
 
-                  } // iit
-              } // do skeleton
+                  case IntersectionType::processor:
+                    if(require_uv_processor || require_v_processor )
+                      {
 
-            if(require_uv_post_skeleton || require_v_post_skeleton){
-              // Volume integration
-              assembler_engine.assembleVVolumePostSkeleton(eg,lfsv_cache);
+                        // Processor integration
+                        assembler_engine.assembleVProcessor(ig,lfsv_cache);
 
-              if(require_uv_post_skeleton){
-                // Volume integration
-                assembler_engine.assembleUVVolumePostSkeleton(eg,lfsu_cache,lfsv_cache);
-              }
-            }
+                        if(require_uv_processor){
+                          // Processor integration
+                          assembler_engine.assembleUVProcessor(ig,lfsu_cache,lfsv_cache);
+                        }
+                      }
+                    break;
+                  } // switch
 
-            // Notify assembler engine about unbinds
-            assembler_engine.onUnbindLFSUV(eg,lfsu_cache,lfsv_cache);
+              } // iit
+          } // do skeleton
 
-            // Notify assembler engine about unbinds
-            assembler_engine.onUnbindLFSV(eg,lfsv_cache);
+        if(require_uv_post_skeleton || require_v_post_skeleton){
+          // Volume integration
+          assembler_engine.assembleVVolumePostSkeleton(eg,lfsv_cache);
 
-          } // it
+          if(require_uv_post_skeleton){
+            // Volume integration
+            assembler_engine.assembleUVVolumePostSkeleton(eg,lfsu_cache,lfsv_cache);
+          }
+        }
 
-        // Notify assembler engine that assembly is finished
-        assembler_engine.postAssembly(gfsu,gfsv);
+        // Notify assembler engine about unbinds
+        assembler_engine.onUnbindLFSUV(eg,lfsu_cache,lfsv_cache);
 
+        // Notify assembler engine about unbinds
+        assembler_engine.onUnbindLFSV(eg,lfsv_cache);
       }
 
-    private:
 
       /* global function spaces */
       const GFSU& gfsu;
@@ -301,9 +909,6 @@ namespace Dune{
         const CV&
         >::type cv;
 
-      /* local function spaces */
-      typedef LocalFunctionSpace<GFSU, TrialSpaceTag> LFSU;
-      typedef LocalFunctionSpace<GFSV, TestSpaceTag> LFSV;
       // local function spaces in local cell
       mutable LFSU lfsu;
       mutable LFSV lfsv;
@@ -311,6 +916,26 @@ namespace Dune{
       mutable LFSU lfsun;
       mutable LFSV lfsvn;
 
+      /* colored assembly */
+      bool colored_assembly;
+      int thread_count;
+      mutable ElementColoring<GV> element_coloring;
+      mutable std::size_t coloring_revision;
+
+      /* border first assembly */
+      bool overlapped_communication;
+      mutable std::vector<char> border_cells;
+      mutable std::size_t border_cells_revision;
+      mutable bool border_cells_neighbors;
+
+      /* batched assembly */
+      bool batched_assembly;
+
+      /* precomputed connectivity */
+      bool precomputed_connectivity;
+      mutable GFSConnectivityTable<GFSU> trial_connectivity;
+      mutable GFSConnectivityTable<GFSV> test_connectivity;
+
     };
 
   }
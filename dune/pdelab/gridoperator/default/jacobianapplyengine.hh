@@ -26,6 +26,9 @@ namespace Dune{
 
       static const bool needs_constraints_caching = false;
 
+      //! Copies of this engine may assemble independent cells concurrently
+      static const bool supports_threaded_assembly = true;
+
       //! The type of the wrapping local assembler
       typedef LA LocalAssembler;
 
@@ -63,6 +66,24 @@ namespace Dune{
           rn_view(rn,1.0)
       {}
 
+      /**
+         \brief Copy constructor
+
+         The copy is attached to the same global containers, but owns
+         its own local vectors and matrices. This allows the global
+         assembler to hand out one engine per thread.
+      */
+      DefaultLocalJacobianApplyAssemblerEngine(const DefaultLocalJacobianApplyAssemblerEngine & other)
+        : LocalAssemblerEngineBase(other),
+          local_assembler(other.local_assembler), lop(other.lop),
+          global_rl_view(other.global_rl_view),
+          global_rn_view(other.global_rn_view),
+          global_sl_view(other.global_sl_view),
+          global_sn_view(other.global_sn_view),
+          rl_view(rl,1.0),
+          rn_view(rn,1.0)
+      {}
+
       //! Query methods for the global grid assembler
       //! @{
       bool requireSkeleton() const
@@ -5,8 +5,10 @@
 #include <dune/pdelab/gridfunctionspace/localvector.hh>
 #include <dune/pdelab/gridoperator/common/localmatrix.hh>
 #include <dune/pdelab/gridoperator/common/assemblerutilities.hh>
+#include <dune/pdelab/gridoperator/common/elementbatch.hh>
 #include <dune/pdelab/gridoperator/common/localassemblerenginebase.hh>
 #include <dune/pdelab/localoperator/callswitch.hh>
+#include <dune/pdelab/localoperator/flags.hh>
 
 namespace Dune{
   namespace PDELab{
@@ -26,6 +28,15 @@ namespace Dune{
 
       static const bool needs_constraints_caching = true;
 
+      //! Copies of this engine may assemble independent cells concurrently
+      static const bool supports_threaded_assembly = true;
+
+      //! Volume terms may be evaluated on batches of cells, see EngineSupportsBatchedAssembly
+      static const bool supports_batched_assembly = true;
+
+      //! The number of cells per batch
+      static const std::size_t batch_size = 8;
+
       //! The type of the wrapping local assembler
       typedef LA LocalAssembler;
 
@@ -61,7 +72,31 @@ namespace Dune{
           al_view(al,1.0),
           al_sn_view(al_sn,1.0),
           al_ns_view(al_ns,1.0),
-          al_nn_view(al_nn,1.0)
+          al_nn_view(al_nn,1.0),
+          batch_slot(-1)
+      {}
+
+      /**
+         \brief Copy constructor
+
+         The copy is attached to the same global containers, but owns
+         its own local vectors and matrices. This allows the global
+         assembler to hand out one engine per thread.
+      */
+      DefaultLocalJacobianAssemblerEngine(const DefaultLocalJacobianAssemblerEngine & other)
+        : LocalAssemblerEngineBase(other),
+          local_assembler(other.local_assembler), lop(other.lop),
+          global_s_s_view(other.global_s_s_view),
+          global_s_n_view(other.global_s_n_view),
+          global_a_ss_view(other.global_a_ss_view),
+          global_a_sn_view(other.global_a_sn_view),
+          global_a_ns_view(other.global_a_ns_view),
+          global_a_nn_view(other.global_a_nn_view),
+          al_view(al,1.0),
+          al_sn_view(al_sn,1.0),
+          al_ns_view(al_ns,1.0),
+          al_nn_view(al_nn,1.0),
+          batch_slot(-1)
       {}
 
       //! Query methods for the global grid assembler
@@ -78,6 +113,8 @@ namespace Dune{
       { return local_assembler.doAlphaBoundary(); }
       bool requireUVVolumePostSkeleton() const
       { return local_assembler.doAlphaVolumePostSkeleton(); }
+      bool requireUVVolumeBatch() const
+      { return LocalOperatorSupportsBatchedVolume<LOP>::value && local_assembler.doAlphaVolume(); }
       //! @}
 
       //! Public access to the wrapping local assembler
@@ -172,6 +209,18 @@ namespace Dune{
       template<typename LFSUC>
       void loadCoefficientsLFSUCoupling(const LFSUC & lfsu_c_cache)
       {DUNE_THROW(Dune::NotImplemented,"No coupling lfsu_cache available for ");}
+
+      //! Loads the coefficients of a cell into the given slot of the current batch.
+      template<typename LFSUC>
+      void loadBatchCoefficients(std::size_t slot, const LFSUC & lfsu_cache){
+        global_s_s_view.bind(lfsu_cache);
+        xl.resize(lfsu_cache.size());
+        global_s_s_view.read(xl);
+        if (slot == 0)
+          xb.resize(lfsu_cache.size());
+        for (std::size_t k = 0; k < xl.size(); ++k)
+          xb.entry(k,slot) = xl.base()[k];
+      }
       //! @}
 
       //! Notifier functions, called immediately before and after assembling
@@ -189,6 +238,18 @@ namespace Dune{
           local_assembler.handle_dirichlet_constraints(gfsv,jacobian);
         }
       }
+
+      //! Sets the rows of constrained DOFs ahead of postAssembly().
+      /**
+       * Used by the border first assembly, which sends the border rows to the neighboring
+       * processes before the interior has been assembled. The constrained rows are reset
+       * again by postAssembly(), so contributions added to them in the meantime are discarded.
+       */
+      void preFinalizeConstraints(const GFSV& gfsv){
+        if(local_assembler.doPostProcessing){
+          local_assembler.handle_dirichlet_constraints(gfsv,global_a_ss_view.container());
+        }
+      }
       //! @}
 
       //! Assembling methods
@@ -209,11 +270,33 @@ namespace Dune{
       template<typename EG, typename LFSUC, typename LFSVC>
       void assembleUVVolume(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
       {
+        if (batch_slot >= 0)
+          {
+            for (std::size_t j = 0; j < al.ncols(); ++j)
+              for (std::size_t i = 0; i < al.nrows(); ++i)
+                al.getEntry(i,j) += local_assembler.weight * ab.entry(i,j,batch_slot);
+            return;
+          }
         al_view.setWeight(local_assembler.weight);
         Dune::PDELab::LocalAssemblerCallSwitch<LOP,LOP::doAlphaVolume>::
           jacobian_volume(lop,eg,lfsu_cache.localFunctionSpace(),xl,lfsv_cache.localFunctionSpace(),al_view);
       }
 
+      //! Evaluates the volume terms of all cells of a batch, the local function spaces are bound to its first cell.
+      template<typename Batch, typename LFSUC, typename LFSVC>
+      void assembleUVVolumeBatch(const Batch & batch, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
+      {
+        ab.assign(lfsv_cache.size(),lfsu_cache.size(),0.0);
+        Dune::PDELab::LocalAssemblerCallSwitch<LOP,LocalOperatorSupportsBatchedVolume<LOP>::value>::
+          jacobian_volume_batch(lop,batch,lfsu_cache.localFunctionSpace(),xb,lfsv_cache.localFunctionSpace(),ab);
+      }
+
+      //! Selects the slot of the current batch used by assembleUVVolume(), -1 evaluates single cells.
+      void setBatchSlot(int slot)
+      {
+        batch_slot = slot;
+      }
+
       template<typename IG, typename LFSUC, typename LFSVC>
       void assembleUVSkeleton(const IG & ig, const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache,
                               const LFSUC & lfsu_n_cache, const LFSVC & lfsv_n_cache)
@@ -298,6 +381,12 @@ namespace Dune{
       typename JacobianMatrix::WeightedAccumulationView al_ns_view;
       typename JacobianMatrix::WeightedAccumulationView al_nn_view;
 
+      //! Coefficients and volume jacobians of the current batch
+      BatchVector<SolutionElement,batch_size> xb;
+      BatchMatrix<JacobianElement,batch_size> ab;
+      //! Slot of the current batch, -1 if cells are evaluated one by one
+      int batch_slot;
+
       //! @}
 
     }; // End of class DefaultLocalJacobianAssemblerEngine
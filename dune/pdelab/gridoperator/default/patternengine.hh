@@ -7,6 +7,7 @@
 #include <dune/pdelab/gridoperator/common/localassemblerenginebase.hh>
 #include <dune/pdelab/constraints/common/constraints.hh>
 #include <dune/pdelab/localoperator/callswitch.hh>
+#include <dune/pdelab/common/performancetrace.hh>
 
 namespace Dune{
   namespace PDELab{
@@ -26,6 +27,12 @@ namespace Dune{
 
       static const bool needs_constraints_caching = true;
 
+      //! Copies of this engine may assemble independent cells concurrently, unless border
+      //! entries have to be recorded for nonoverlapping grids or the pattern builder does
+      //! not accept concurrent insertion
+      static const bool supports_threaded_assembly = !LA::isNonOverlapping &&
+        PatternSupportsConcurrentInsertion<typename LA::Traits::MatrixPattern>::value;
+
       //! The type of the wrapping local assembler
       typedef LA LocalAssembler;
 
@@ -246,9 +253,12 @@ namespace Dune{
 
             typename LA::Traits::BorderDOFExchanger::template PatternExtender<Pattern>
               data_handle(*_border_dof_exchanger,gfsu,gfsv,*pattern);
-            gfsv.gridView().communicate(data_handle,
-                                        InteriorBorder_InteriorBorder_Interface,
-                                        ForwardCommunication);
+            {
+              PerformanceTrace::Region region("communication","communication");
+              gfsv.gridView().communicate(data_handle,
+                                          InteriorBorder_InteriorBorder_Interface,
+                                          ForwardCommunication);
+            }
           }
       }
 
@@ -3,9 +3,11 @@
 
 #include <dune/pdelab/gridfunctionspace/localvector.hh>
 #include <dune/pdelab/gridoperator/common/assemblerutilities.hh>
+#include <dune/pdelab/gridoperator/common/elementbatch.hh>
 #include <dune/pdelab/gridoperator/common/localassemblerenginebase.hh>
 #include <dune/pdelab/constraints/common/constraints.hh>
 #include <dune/pdelab/localoperator/callswitch.hh>
+#include <dune/pdelab/localoperator/flags.hh>
 
 namespace Dune{
   namespace PDELab{
@@ -25,6 +27,15 @@ namespace Dune{
 
       static const bool needs_constraints_caching = true;
 
+      //! Copies of this engine may assemble independent cells concurrently
+      static const bool supports_threaded_assembly = true;
+
+      //! Volume terms may be evaluated on batches of cells, see EngineSupportsBatchedAssembly
+      static const bool supports_batched_assembly = true;
+
+      //! The number of cells per batch
+      static const std::size_t batch_size = 8;
+
       //! The type of the wrapping local assembler
       typedef LA LocalAssembler;
 
@@ -59,7 +70,27 @@ namespace Dune{
       DefaultLocalResidualAssemblerEngine(const LocalAssembler & local_assembler_)
         : local_assembler(local_assembler_), lop(local_assembler_.lop),
           rl_view(rl,1.0),
-          rn_view(rn,1.0)
+          rn_view(rn,1.0),
+          batch_slot(-1)
+      {}
+
+      /**
+         \brief Copy constructor
+
+         The copy is attached to the same global containers, but owns
+         its own local vectors and matrices. This allows the global
+         assembler to hand out one engine per thread.
+      */
+      DefaultLocalResidualAssemblerEngine(const DefaultLocalResidualAssemblerEngine & other)
+        : LocalAssemblerEngineBase(other),
+          local_assembler(other.local_assembler), lop(other.lop),
+          global_rl_view(other.global_rl_view),
+          global_rn_view(other.global_rn_view),
+          global_sl_view(other.global_sl_view),
+          global_sn_view(other.global_sn_view),
+          rl_view(rl,1.0),
+          rn_view(rn,1.0),
+          batch_slot(-1)
       {}
 
       //! Query methods for the global grid assembler
@@ -84,6 +115,8 @@ namespace Dune{
       { return local_assembler.doAlphaVolumePostSkeleton(); }
       bool requireVVolumePostSkeleton() const
       { return local_assembler.doLambdaVolumePostSkeleton(); }
+      bool requireUVVolumeBatch() const
+      { return LocalOperatorSupportsBatchedVolume<LOP>::value && local_assembler.doAlphaVolume(); }
       //! @}
 
       //! Public access to the wrapping local assembler
@@ -200,6 +233,18 @@ namespace Dune{
       template<typename LFSUC>
       void loadCoefficientsLFSUCoupling(const LFSUC & lfsu_c_cache)
       {DUNE_THROW(Dune::NotImplemented,"No coupling lfsu available for ");}
+
+      //! Loads the coefficients of a cell into the given slot of the current batch.
+      template<typename LFSUC>
+      void loadBatchCoefficients(std::size_t slot, const LFSUC & lfsu_cache){
+        global_sl_view.bind(lfsu_cache);
+        xl.resize(lfsu_cache.size());
+        global_sl_view.read(xl);
+        if (slot == 0)
+          xb.resize(lfsu_cache.size());
+        for (std::size_t k = 0; k < xl.size(); ++k)
+          xb.entry(k,slot) = xl.base()[k];
+      }
       //! @}
 
       //! Notifier functions, called immediately before and after assembling
@@ -232,11 +277,32 @@ namespace Dune{
       template<typename EG, typename LFSUC, typename LFSVC>
       void assembleUVVolume(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
       {
+        if (batch_slot >= 0)
+          {
+            for (std::size_t k = 0; k < rl.size(); ++k)
+              rl.base()[k] += local_assembler.weight * rb.entry(k,batch_slot);
+            return;
+          }
         rl_view.setWeight(local_assembler.weight);
         Dune::PDELab::LocalAssemblerCallSwitch<LOP,LOP::doAlphaVolume>::
           alpha_volume(lop,eg,lfsu_cache.localFunctionSpace(),xl,lfsv_cache.localFunctionSpace(),rl_view);
       }
 
+      //! Evaluates the volume terms of all cells of a batch, the local function spaces are bound to its first cell.
+      template<typename Batch, typename LFSUC, typename LFSVC>
+      void assembleUVVolumeBatch(const Batch & batch, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
+      {
+        rb.assign(lfsv_cache.size(),0.0);
+        Dune::PDELab::LocalAssemblerCallSwitch<LOP,LocalOperatorSupportsBatchedVolume<LOP>::value>::
+          alpha_volume_batch(lop,batch,lfsu_cache.localFunctionSpace(),xb,lfsv_cache.localFunctionSpace(),rb);
+      }
+
+      //! Selects the slot of the current batch used by assembleUVVolume(), -1 evaluates single cells.
+      void setBatchSlot(int slot)
+      {
+        batch_slot = slot;
+      }
+
       template<typename EG, typename LFSVC>
       void assembleVVolume(const EG & eg, const LFSVC & lfsv_cache)
       {
@@ -351,6 +417,11 @@ namespace Dune{
       typename ResidualVector::WeightedAccumulationView rl_view;
       //! Outside local residual weighted view
       typename ResidualVector::WeightedAccumulationView rn_view;
+      //! Coefficients and volume residuals of the current batch
+      BatchVector<SolutionElement,batch_size> xb;
+      BatchVector<ResidualElement,batch_size> rb;
+      //! Slot of the current batch, -1 if cells are evaluated one by one
+      int batch_slot;
       //! @}
 
     }; // End of class DefaultLocalResidualAssemblerEngine
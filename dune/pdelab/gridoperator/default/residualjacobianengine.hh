@@ -0,0 +1,534 @@
+#ifndef DUNE_PDELAB_DEFAULT_RESIDUALJACOBIANENGINE_HH
+#define DUNE_PDELAB_DEFAULT_RESIDUALJACOBIANENGINE_HH
+
+#include <dune/pdelab/constraints/common/constraints.hh>
+#include <dune/pdelab/gridfunctionspace/localvector.hh>
+#include <dune/pdelab/gridoperator/common/localmatrix.hh>
+#include <dune/pdelab/gridoperator/common/assemblerutilities.hh>
+#include <dune/pdelab/gridoperator/common/elementbatch.hh>
+#include <dune/pdelab/gridoperator/common/localassemblerenginebase.hh>
+#include <dune/pdelab/localoperator/callswitch.hh>
+#include <dune/pdelab/localoperator/flags.hh>
+
+namespace Dune{
+  namespace PDELab{
+
+    /**
+       \brief The local assembler engine for DUNE grids which
+       assembles the residual vector and the jacobian matrix in a
+       single grid traversal
+
+       The local function spaces are bound and the coefficients are
+       read only once per cell. The volume terms of local operators
+       which provide alpha_jacobian_volume() (see
+       LocalOperatorSupportsFusedVolume) are evaluated in a single
+       call, all other terms by calling the residual and the
+       jacobian methods of the local operator one after the other.
+
+       \tparam LA The local assembler
+
+    */
+    template<typename LA>
+    class DefaultLocalResidualJacobianAssemblerEngine
+      : public LocalAssemblerEngineBase
+    {
+    public:
+
+      static const bool needs_constraints_caching = true;
+
+      //! Copies of this engine may assemble independent cells concurrently
+      static const bool supports_threaded_assembly = true;
+
+      //! Volume terms may be evaluated on batches of cells, see EngineSupportsBatchedAssembly
+      static const bool supports_batched_assembly = true;
+
+      //! The number of cells per batch
+      static const std::size_t batch_size = 8;
+
+      //! The type of the wrapping local assembler
+      typedef LA LocalAssembler;
+
+      //! The type of the local operator
+      typedef typename LA::LocalOperator LOP;
+
+      //! The local function spaces
+      typedef typename LA::LFSU LFSU;
+      typedef typename LA::LFSUCache LFSUCache;
+      typedef typename LFSU::Traits::GridFunctionSpace GFSU;
+      typedef typename LA::LFSV LFSV;
+      typedef typename LA::LFSVCache LFSVCache;
+      typedef typename LFSV::Traits::GridFunctionSpace GFSV;
+
+      //! The type of the residual vector
+      typedef typename LA::Traits::Residual Residual;
+      typedef typename Residual::ElementType ResidualElement;
+      typedef typename Residual::template LocalView<LFSVCache> ResidualView;
+
+      //! The type of the jacobian matrix
+      typedef typename LA::Traits::Jacobian Jacobian;
+      typedef typename Jacobian::ElementType JacobianElement;
+      typedef typename Jacobian::template LocalView<LFSVCache,LFSUCache> JacobianView;
+
+      //! The type of the solution vector
+      typedef typename LA::Traits::Solution Solution;
+      typedef typename Solution::ElementType SolutionElement;
+      typedef typename Solution::template ConstLocalView<LFSUCache> SolutionView;
+
+      /**
+         \brief Constructor
+
+         \param [in] local_assembler_ The local assembler object which
+         creates this engine
+      */
+      DefaultLocalResidualJacobianAssemblerEngine(const LocalAssembler & local_assembler_)
+        : local_assembler(local_assembler_), lop(local_assembler_.lop),
+          rl_view(rl,1.0),
+          rn_view(rn,1.0),
+          al_view(al,1.0),
+          al_sn_view(al_sn,1.0),
+          al_ns_view(al_ns,1.0),
+          al_nn_view(al_nn,1.0),
+          batch_slot(-1)
+      {}
+
+      /**
+         \brief Copy constructor
+
+         The copy is attached to the same global containers, but owns
+         its own local vectors and matrices. This allows the global
+         assembler to hand out one engine per thread.
+      */
+      DefaultLocalResidualJacobianAssemblerEngine(const DefaultLocalResidualJacobianAssemblerEngine & other)
+        : LocalAssemblerEngineBase(other),
+          local_assembler(other.local_assembler), lop(other.lop),
+          global_s_s_view(other.global_s_s_view),
+          global_s_n_view(other.global_s_n_view),
+          global_rl_view(other.global_rl_view),
+          global_rn_view(other.global_rn_view),
+          global_a_ss_view(other.global_a_ss_view),
+          global_a_sn_view(other.global_a_sn_view),
+          global_a_ns_view(other.global_a_ns_view),
+          global_a_nn_view(other.global_a_nn_view),
+          rl_view(rl,1.0),
+          rn_view(rn,1.0),
+          al_view(al,1.0),
+          al_sn_view(al_sn,1.0),
+          al_ns_view(al_ns,1.0),
+          al_nn_view(al_nn,1.0),
+          batch_slot(-1)
+      {}
+
+      //! Query methods for the global grid assembler
+      //! @{
+      bool requireSkeleton() const
+      { return ( local_assembler.doAlphaSkeleton() || local_assembler.doLambdaSkeleton() ); }
+      bool requireSkeletonTwoSided() const
+      { return local_assembler.doSkeletonTwoSided(); }
+      bool requireUVVolume() const
+      { return local_assembler.doAlphaVolume(); }
+      bool requireVVolume() const
+      { return local_assembler.doLambdaVolume(); }
+      bool requireUVSkeleton() const
+      { return local_assembler.doAlphaSkeleton(); }
+      bool requireVSkeleton() const
+      { return local_assembler.doLambdaSkeleton(); }
+      bool requireUVBoundary() const
+      { return local_assembler.doAlphaBoundary(); }
+      bool requireVBoundary() const
+      { return local_assembler.doLambdaBoundary(); }
+      bool requireUVVolumePostSkeleton() const
+      { return local_assembler.doAlphaVolumePostSkeleton(); }
+      bool requireVVolumePostSkeleton() const
+      { return local_assembler.doLambdaVolumePostSkeleton(); }
+      bool requireUVVolumeBatch() const
+      { return LocalOperatorSupportsBatchedVolume<LOP>::value && local_assembler.doAlphaVolume(); }
+      //! @}
+
+      //! Public access to the wrapping local assembler
+      const LocalAssembler & localAssembler() const { return local_assembler; }
+
+      //! Trial space constraints
+      const typename LocalAssembler::Traits::TrialGridFunctionSpaceConstraints& trialConstraints() const
+      {
+        return localAssembler().trialConstraints();
+      }
+
+      //! Test space constraints
+      const typename LocalAssembler::Traits::TestGridFunctionSpaceConstraints& testConstraints() const
+      {
+        return localAssembler().testConstraints();
+      }
+
+      //! Set current residual vector. Should be called prior to
+      //! assembling.
+      void setResidual(Residual & residual_){
+        global_rl_view.attach(residual_);
+        global_rn_view.attach(residual_);
+      }
+
+      //! Set current jacobian matrix. Should be called prior to
+      //! assembling.
+      void setJacobian(Jacobian & jacobian_){
+        global_a_ss_view.attach(jacobian_);
+        global_a_sn_view.attach(jacobian_);
+        global_a_ns_view.attach(jacobian_);
+        global_a_nn_view.attach(jacobian_);
+      }
+
+      //! Set current solution vector. Should be called prior to
+      //! assembling.
+      void setSolution(const Solution & solution_){
+        global_s_s_view.attach(solution_);
+        global_s_n_view.attach(solution_);
+      }
+
+      //! Called immediately after binding of local function space in
+      //! global assembler.
+      //! @{
+      template<typename EG, typename LFSUC, typename LFSVC>
+      void onBindLFSUV(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache){
+        global_s_s_view.bind(lfsu_cache);
+        xl.resize(lfsu_cache.size());
+        global_a_ss_view.bind(lfsv_cache,lfsu_cache);
+        al.assign(lfsv_cache.size(),lfsu_cache.size(),0.0);
+      }
+
+      template<typename EG, typename LFSVC>
+      void onBindLFSV(const EG & eg, const LFSVC & lfsv_cache){
+        global_rl_view.bind(lfsv_cache);
+        rl.assign(lfsv_cache.size(),0.0);
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      void onBindLFSUVOutside(const IG & ig,
+                              const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache,
+                              const LFSUC & lfsu_n_cache, const LFSVC & lfsv_n_cache)
+      {
+        global_s_n_view.bind(lfsu_n_cache);
+        xn.resize(lfsu_n_cache.size());
+        global_a_sn_view.bind(lfsv_s_cache,lfsu_n_cache);
+        al_sn.assign(lfsv_s_cache.size(),lfsu_n_cache.size(),0.0);
+        global_a_ns_view.bind(lfsv_n_cache,lfsu_s_cache);
+        al_ns.assign(lfsv_n_cache.size(),lfsu_s_cache.size(),0.0);
+        global_a_nn_view.bind(lfsv_n_cache,lfsu_n_cache);
+        al_nn.assign(lfsv_n_cache.size(),lfsu_n_cache.size(),0.0);
+      }
+
+      template<typename IG, typename LFSVC>
+      void onBindLFSVOutside(const IG & ig,
+                             const LFSVC & lfsv_s_cache,
+                             const LFSVC & lfsv_n_cache)
+      {
+        global_rn_view.bind(lfsv_n_cache);
+        rn.assign(lfsv_n_cache.size(),0.0);
+      }
+
+      //! @}
+
+      //! Called when the local function space is about to be rebound or
+      //! discarded
+      //! @{
+      template<typename EG, typename LFSUC, typename LFSVC>
+      void onUnbindLFSUV(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache){
+        local_assembler.etadd(al,global_a_ss_view);
+      }
+
+      template<typename EG, typename LFSVC>
+      void onUnbindLFSV(const EG & eg, const LFSVC & lfsv_cache){
+        global_rl_view.add(rl);
+        global_rl_view.commit();
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      void onUnbindLFSUVOutside(const IG & ig,
+                                const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache,
+                                const LFSUC & lfsu_n_cache, const LFSVC & lfsv_n_cache)
+      {
+        local_assembler.etadd(al_sn,global_a_sn_view);
+        local_assembler.etadd(al_ns,global_a_ns_view);
+        local_assembler.etadd(al_nn,global_a_nn_view);
+      }
+
+      template<typename IG, typename LFSVC>
+      void onUnbindLFSVOutside(const IG & ig,
+                               const LFSVC & lfsv_s_cache,
+                               const LFSVC & lfsv_n_cache)
+      {
+        global_rn_view.add(rn);
+        global_rn_view.commit();
+      }
+
+      //! @}
+
+      //! Methods for loading of the local function's coefficients
+      //! @{
+      template<typename LFSUC>
+      void loadCoefficientsLFSUInside(const LFSUC & lfsu_cache){
+        global_s_s_view.read(xl);
+      }
+      template<typename LFSUC>
+      void loadCoefficientsLFSUOutside(const LFSUC & lfsu_n_cache){
+        global_s_n_view.read(xn);
+      }
+      template<typename LFSUC>
+      void loadCoefficientsLFSUCoupling(const LFSUC & lfsu_c_cache)
+      {DUNE_THROW(Dune::NotImplemented,"No coupling lfsu_cache available for ");}
+
+      //! Loads the coefficients of a cell into the given slot of the current batch.
+      template<typename LFSUC>
+      void loadBatchCoefficients(std::size_t slot, const LFSUC & lfsu_cache){
+        global_s_s_view.bind(lfsu_cache);
+        xl.resize(lfsu_cache.size());
+        global_s_s_view.read(xl);
+        if (slot == 0)
+          xb.resize(lfsu_cache.size());
+        for (std::size_t k = 0; k < xl.size(); ++k)
+          xb.entry(k,slot) = xl.base()[k];
+      }
+      //! @}
+
+      //! Notifier functions, called immediately before and after assembling
+      //! @{
+      void postAssembly(const GFSU& gfsu, const GFSV& gfsv){
+        Jacobian& jacobian = global_a_ss_view.container();
+        global_s_s_view.detach();
+        global_s_n_view.detach();
+        global_a_ss_view.detach();
+        global_a_sn_view.detach();
+        global_a_ns_view.detach();
+        global_a_nn_view.detach();
+
+        if(local_assembler.doPostProcessing){
+          Dune::PDELab::constrain_residual(*(local_assembler.pconstraintsv),global_rl_view.container());
+          local_assembler.handle_dirichlet_constraints(gfsv,jacobian);
+        }
+      }
+
+      //! Sets the rows of constrained DOFs of the jacobian ahead of postAssembly().
+      /**
+       * See DefaultLocalJacobianAssemblerEngine::preFinalizeConstraints().
+       */
+      void preFinalizeConstraints(const GFSV& gfsv){
+        if(local_assembler.doPostProcessing){
+          local_assembler.handle_dirichlet_constraints(gfsv,global_a_ss_view.container());
+        }
+      }
+      //! @}
+
+      //! Assembling methods
+      //! @{
+
+      /** Assemble on a given cell without function spaces.
+
+          \return If true, the assembling for this cell is assumed to
+          be complete and the assembler continues with the next grid
+          cell.
+       */
+      template<typename EG>
+      bool assembleCell(const EG & eg)
+      {
+        return LocalAssembler::isNonOverlapping && eg.entity().partitionType() != Dune::InteriorEntity;
+      }
+
+      template<typename EG, typename LFSUC, typename LFSVC>
+      void assembleUVVolume(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
+      {
+        if (batch_slot >= 0)
+          {
+            for (std::size_t k = 0; k < rl.size(); ++k)
+              rl.base()[k] += local_assembler.weight * rb.entry(k,batch_slot);
+            for (std::size_t j = 0; j < al.ncols(); ++j)
+              for (std::size_t i = 0; i < al.nrows(); ++i)
+                al.getEntry(i,j) += local_assembler.weight * ab.entry(i,j,batch_slot);
+            return;
+          }
+        rl_view.setWeight(local_assembler.weight);
+        al_view.setWeight(local_assembler.weight);
+        if (LocalOperatorSupportsFusedVolume<LOP>::value)
+          Dune::PDELab::LocalAssemblerCallSwitch<LOP,LocalOperatorSupportsFusedVolume<LOP>::value>::
+            alpha_jacobian_volume(lop,eg,lfsu_cache.localFunctionSpace(),xl,lfsv_cache.localFunctionSpace(),rl_view,al_view);
+        else
+          {
+            Dune::PDELab::LocalAssemblerCallSwitch<LOP,LOP::doAlphaVolume>::
+              alpha_volume(lop,eg,lfsu_cache.localFunctionSpace(),xl,lfsv_cache.localFunctionSpace(),rl_view);
+            Dune::PDELab::LocalAssemblerCallSwitch<LOP,LOP::doAlphaVolume>::
+              jacobian_volume(lop,eg,lfsu_cache.localFunctionSpace(),xl,lfsv_cache.localFunctionSpace(),al_view);
+          }
+      }
+
+      //! Evaluates the volume terms of all cells of a batch, the local function spaces are bound to its first cell.
+      template<typename Batch, typename LFSUC, typename LFSVC>
+      void assembleUVVolumeBatch(const Batch & batch, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
+      {
+        rb.assign(lfsv_cache.size(),0.0);
+        ab.assign(lfsv_cache.size(),lfsu_cache.size(),0.0);
+        Dune::PDELab::LocalAssemblerCallSwitch<LOP,LocalOperatorSupportsBatchedVolume<LOP>::value>::
+          alpha_volume_batch(lop,batch,lfsu_cache.localFunctionSpace(),xb,lfsv_cache.localFunctionSpace(),rb);
+        Dune::PDELab::LocalAssemblerCallSwitch<LOP,LocalOperatorSupportsBatchedVolume<LOP>::value>::
+          jacobian_volume_batch(lop,batch,lfsu_cache.localFunctionSpace(),xb,lfsv_cache.localFunctionSpace(),ab);
+      }
+
+      //! Selects the slot of the current batch used by assembleUVVolume(), -1 evaluates single cells.
+      void setBatchSlot(int slot)
+      {
+        batch_slot = slot;
+      }
+
+      template<typename EG, typename LFSVC>
+      void assembleVVolume(const EG & eg, const LFSVC & lfsv_cache)
+      {
+        rl_view.setWeight(local_assembler.weight);
+        Dune::PDELab::LocalAssemblerCallSwitch<LOP,LOP::doLambdaVolume>::
+          lambda_volume(lop,eg,lfsv_cache.localFunctionSpace(),rl_view);
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      void assembleUVSkeleton(const IG & ig, const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache,
+                              const LFSUC & lfsu_n_cache, const LFSVC & lfsv_n_cache)
+      {
+        rl_view.setWeight(local_assembler.weight);
+        rn_view.setWeight(local_assembler.weight);
+        al_view.setWeight(local_assembler.weight);
+        al_sn_view.setWeight(local_assembler.weight);
+        al_ns_view.setWeight(local_assembler.weight);
+        al_nn_view.setWeight(local_assembler.weight);
+
+        Dune::PDELab::LocalAssemblerCallSwitch<LOP,LOP::doAlphaSkeleton>::
+          alpha_skeleton(lop,ig,
+                         lfsu_s_cache.localFunctionSpace(),xl,lfsv_s_cache.localFunctionSpace(),
+                         lfsu_n_cache.localFunctionSpace(),xn,lfsv_n_cache.localFunctionSpace(),
+                         rl_view,rn_view);
+        Dune::PDELab::LocalAssemblerCallSwitch<LOP,LOP::doAlphaSkeleton>::
+          jacobian_skeleton(lop,ig,
+                            lfsu_s_cache.localFunctionSpace(),xl,lfsv_s_cache.localFunctionSpace(),
+                            lfsu_n_cache.localFunctionSpace(),xn,lfsv_n_cache.localFunctionSpace(),
+                            al_view,al_sn_view,al_ns_view,al_nn_view);
+      }
+
+      template<typename IG, typename LFSVC>
+      void assembleVSkeleton(const IG & ig, const LFSVC & lfsv_s_cache, const LFSVC & lfsv_n_cache)
+      {
+        rl_view.setWeight(local_assembler.weight);
+        rn_view.setWeight(local_assembler.weight);
+        Dune::PDELab::LocalAssemblerCallSwitch<LOP,LOP::doLambdaSkeleton>::
+          lambda_skeleton(lop, ig, lfsv_s_cache.localFunctionSpace(), lfsv_n_cache.localFunctionSpace(), rl_view, rn_view);
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      void assembleUVBoundary(const IG & ig, const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache)
+      {
+        rl_view.setWeight(local_assembler.weight);
+        al_view.setWeight(local_assembler.weight);
+        Dune::PDELab::LocalAssemblerCallSwitch<LOP,LOP::doAlphaBoundary>::
+          alpha_boundary(lop,ig,lfsu_s_cache.localFunctionSpace(),xl,lfsv_s_cache.localFunctionSpace(),rl_view);
+        Dune::PDELab::LocalAssemblerCallSwitch<LOP,LOP::doAlphaBoundary>::
+          jacobian_boundary(lop,ig,lfsu_s_cache.localFunctionSpace(),xl,lfsv_s_cache.localFunctionSpace(),al_view);
+      }
+
+      template<typename IG, typename LFSVC>
+      void assembleVBoundary(const IG & ig, const LFSVC & lfsv_s_cache)
+      {
+        rl_view.setWeight(local_assembler.weight);
+        Dune::PDELab::LocalAssemblerCallSwitch<LOP,LOP::doLambdaBoundary>::
+          lambda_boundary(lop,ig,lfsv_s_cache.localFunctionSpace(),rl_view);
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      static void assembleUVEnrichedCoupling(const IG & ig,
+                                             const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache,
+                                             const LFSUC & lfsu_n_cache, const LFSVC & lfsv_n_cache,
+                                             const LFSUC & lfsu_coupling_cache, const LFSVC & lfsv_coupling_cache)
+      {DUNE_THROW(Dune::NotImplemented,"Assembling of coupling spaces is not implemented for ");}
+
+      template<typename IG, typename LFSVC>
+      static void assembleVEnrichedCoupling(const IG & ig,
+                                            const LFSVC & lfsv_s_cache,
+                                            const LFSVC & lfsv_n_cache,
+                                            const LFSVC & lfsv_coupling_cache)
+      {DUNE_THROW(Dune::NotImplemented,"Assembling of coupling spaces is not implemented for ");}
+
+      template<typename EG, typename LFSUC, typename LFSVC>
+      void assembleUVVolumePostSkeleton(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
+      {
+        rl_view.setWeight(local_assembler.weight);
+        al_view.setWeight(local_assembler.weight);
+        Dune::PDELab::LocalAssemblerCallSwitch<LOP,LOP::doAlphaVolumePostSkeleton>::
+          alpha_volume_post_skeleton(lop,eg,lfsu_cache.localFunctionSpace(),xl,lfsv_cache.localFunctionSpace(),rl_view);
+        Dune::PDELab::LocalAssemblerCallSwitch<LOP,LOP::doAlphaVolumePostSkeleton>::
+          jacobian_volume_post_skeleton(lop,eg,lfsu_cache.localFunctionSpace(),xl,lfsv_cache.localFunctionSpace(),al_view);
+      }
+
+      template<typename EG, typename LFSVC>
+      void assembleVVolumePostSkeleton(const EG & eg, const LFSVC & lfsv_cache)
+      {
+        rl_view.setWeight(local_assembler.weight);
+        Dune::PDELab::LocalAssemblerCallSwitch<LOP,LOP::doLambdaVolumePostSkeleton>::
+          lambda_volume_post_skeleton(lop,eg,lfsv_cache.localFunctionSpace(),rl_view);
+      }
+
+      //! @}
+
+    private:
+      //! Reference to the wrapping local assembler object which
+      //! constructed this engine
+      const LocalAssembler & local_assembler;
+
+      //! Reference to the local operator
+      const LOP & lop;
+
+      //! Pointer to the current solution vector for which to assemble
+      SolutionView global_s_s_view;
+      SolutionView global_s_n_view;
+
+      //! Pointer to the current residual vector in which to assemble
+      ResidualView global_rl_view;
+      ResidualView global_rn_view;
+
+      //! Pointer to the current jacobian matrix in which to assemble
+      JacobianView global_a_ss_view;
+      JacobianView global_a_sn_view;
+      JacobianView global_a_ns_view;
+      JacobianView global_a_nn_view;
+
+      //! The local vectors and matrices as required for assembling
+      //! @{
+      typedef Dune::PDELab::TrialSpaceTag LocalTrialSpaceTag;
+      typedef Dune::PDELab::TestSpaceTag LocalTestSpaceTag;
+
+      typedef Dune::PDELab::LocalVector<SolutionElement, LocalTrialSpaceTag> SolutionVector;
+      typedef Dune::PDELab::LocalVector<ResidualElement, LocalTestSpaceTag> ResidualVector;
+      typedef Dune::PDELab::LocalMatrix<JacobianElement> JacobianMatrix;
+
+      SolutionVector xl;
+      SolutionVector xn;
+
+      ResidualVector rl;
+      ResidualVector rn;
+
+      JacobianMatrix al;
+      JacobianMatrix al_sn;
+      JacobianMatrix al_ns;
+      JacobianMatrix al_nn;
+
+      typename ResidualVector::WeightedAccumulationView rl_view;
+      typename ResidualVector::WeightedAccumulationView rn_view;
+
+      typename JacobianMatrix::WeightedAccumulationView al_view;
+      typename JacobianMatrix::WeightedAccumulationView al_sn_view;
+      typename JacobianMatrix::WeightedAccumulationView al_ns_view;
+      typename JacobianMatrix::WeightedAccumulationView al_nn_view;
+
+      //! Coefficients, volume residuals and volume jacobians of the current batch
+      BatchVector<SolutionElement,batch_size> xb;
+      BatchVector<ResidualElement,batch_size> rb;
+      BatchMatrix<JacobianElement,batch_size> ab;
+      //! Slot of the current batch, -1 if cells are evaluated one by one
+      int batch_slot;
+
+      //! @}
+
+    }; // End of class DefaultLocalResidualJacobianAssemblerEngine
+
+  }
+}
+#endif
@@ -3,9 +3,11 @@
 
 #include <dune/common/tupleutility.hh>
 
+#include <dune/pdelab/common/performancetrace.hh>
 #include <dune/pdelab/gridfunctionspace/interpolate.hh>
 #include <dune/pdelab/gridoperator/common/borderdofexchanger.hh>
 #include <dune/pdelab/gridoperator/common/gridoperatorutilities.hh>
+#include <dune/pdelab/gridoperator/common/matrixstructurecache.hh>
 #include <dune/pdelab/gridoperator/default/assembler.hh>
 #include <dune/pdelab/gridoperator/default/localassembler.hh>
 
@@ -62,6 +64,9 @@ namespace Dune{
       typedef Dune::PDELab::GridOperatorTraits
       <GFSU,GFSV,MB,DF,RF,JF,CU,CV,Assembler,LocalAssembler> Traits;
 
+      //! The residual and the jacobian can be assembled together, see residual_and_jacobian()
+      static const bool supports_residual_and_jacobian = true;
+
       template <typename MFT>
       struct MatrixContainer{
         typedef typename Traits::Jacobian Type;
@@ -156,6 +161,7 @@ namespace Dune{
 
       //! Fill pattern of jacobian matrix
       void fill_pattern(Pattern & p) const {
+        PerformanceTrace::Region region("pattern","assembly");
         typedef typename LocalAssembler::LocalPatternAssemblerEngine PatternEngine;
         PatternEngine & pattern_engine = local_assembler.localPatternAssemblerEngine(p);
         global_assembler.assemble(pattern_engine);
@@ -163,6 +169,7 @@ namespace Dune{
 
       //! Assemble residual
       void residual(const Domain & x, Range & r) const {
+        PerformanceTrace::Region region("residual","assembly");
         typedef typename LocalAssembler::LocalResidualAssemblerEngine ResidualEngine;
         ResidualEngine & residual_engine = local_assembler.localResidualAssemblerEngine(r,x);
         global_assembler.assemble(residual_engine);
@@ -170,18 +177,68 @@ namespace Dune{
 
       //! Assembler jacobian
       void jacobian(const Domain & x, Jacobian & a) const {
+        PerformanceTrace::Region region("jacobian","assembly");
         typedef typename LocalAssembler::LocalJacobianAssemblerEngine JacobianEngine;
         JacobianEngine & jacobian_engine = local_assembler.localJacobianAssemblerEngine(a,x);
-        global_assembler.assemble(jacobian_engine);
+        if (global_assembler.overlappedCommunication())
+          {
+            // start the exchange of the border entries once the border cells are done
+            BorderExchangeStarter<JacobianEngine> start_exchange(*this,jacobian_engine,a);
+            global_assembler.assembleBorderFirst(jacobian_engine,start_exchange);
+            dof_exchanger->finishAccumulation();
+          }
+        else
+          global_assembler.assemble(jacobian_engine);
+      }
+
+      //! Assemble residual and jacobian in a single grid traversal
+      /**
+       * Gives the same results as calling residual(x,r) and jacobian(x,a), but binds the local
+       * function spaces and reads the coefficients of x only once per cell. Local operators that
+       * provide alpha_jacobian_volume() (see LocalOperatorSupportsFusedVolume) compute both
+       * volume contributions in a single pass over the quadrature points.
+       */
+      void residual_and_jacobian(const Domain & x, Range & r, Jacobian & a) const {
+        PerformanceTrace::Region region("residual and jacobian","assembly");
+        typedef typename LocalAssembler::LocalResidualJacobianAssemblerEngine ResidualJacobianEngine;
+        ResidualJacobianEngine & residual_jacobian_engine = local_assembler.localResidualJacobianAssemblerEngine(r,a,x);
+        if (global_assembler.overlappedCommunication())
+          {
+            // start the exchange of the border entries once the border cells are done
+            BorderExchangeStarter<ResidualJacobianEngine> start_exchange(*this,residual_jacobian_engine,a);
+            global_assembler.assembleBorderFirst(residual_jacobian_engine,start_exchange);
+            dof_exchanger->finishAccumulation();
+          }
+        else
+          global_assembler.assemble(residual_jacobian_engine);
       }
 
       //! Apply jacobian matrix without explicitly assembling it
       void jacobian_apply(const Domain & x, Range & r) const {
+        PerformanceTrace::Region region("jacobian apply","assembly");
         typedef typename LocalAssembler::LocalJacobianApplyAssemblerEngine JacobianApplyEngine;
        JacobianApplyEngine & jacobian_apply_engine = local_assembler.localJacobianApplyAssemblerEngine(r,x);
         global_assembler.assemble(jacobian_apply_engine);
       }
 
+      //! Apply the jacobian matrix at x to z without explicitly assembling it
+      /**
+       * In contrast to jacobian_apply(x,r), which assumes the operator to be linear,
+       * this evaluates the jacobian at the linearization point x and applies it to
+       * the direction z. The local operator has to provide the non-linear variants of
+       * the jacobian_apply_*() methods, see NumericalJacobianApplyVolume and friends for
+       * an implementation based on finite differences of the residual.
+       *
+       * The result is added to r, except for the rows of constrained DOFs, which are set to
+       * the corresponding entries of z like for the unit diagonal of the assembled jacobian.
+       */
+      void jacobian_apply(const Domain & x, const Domain & z, Range & r) const {
+        PerformanceTrace::Region region("jacobian apply","assembly");
+        typedef typename LocalAssembler::LocalNonlinearJacobianApplyAssemblerEngine NonlinearJacobianApplyEngine;
+        NonlinearJacobianApplyEngine & nonlinear_jacobian_apply_engine = local_assembler.localNonlinearJacobianApplyAssemblerEngine(x,z,r);
+        global_assembler.assemble(nonlinear_jacobian_apply_engine);
+      }
+
       void make_consistent(Jacobian& a) const {
         dof_exchanger->accumulateBorderEntries(*this,a);
       }
@@ -190,6 +247,9 @@ namespace Dune{
       {
         // the DOF exchanger has matrix information, so we need to update it
         dof_exchanger->update(*this);
+        // drop grid dependent data cached by the assembler
+        global_assembler.update();
+        matrix_structure_cache.clear();
       }
 
       //! Get the matrix backend for this grid operator.
@@ -198,12 +258,51 @@ namespace Dune{
         return backend;
       }
 
+      //! Get the cache for the sparsity structure of matrices built from this grid operator.
+      /**
+       * Matrix containers supporting it (currently the ISTL containers) only run the pattern
+       * assembly for the first matrix and set up all further matrices from the structure stored
+       * in this cache. The cache is discarded automatically after the trial or test space has been
+       * updated, after the number of constrained DOFs has changed and by update(). If the sparsity
+       * pattern changes for other reasons, e.g. because constraints have been recomputed in place
+       * with the same number of constrained DOFs, but different constraint entries, call update()
+       * or disable the cache.
+       */
+      MatrixStructureCache& matrixStructureCache() const
+      {
+        matrix_structure_cache.validate(trialGridFunctionSpace().revision(),
+                                        testGridFunctionSpace().revision(),
+                                        local_assembler.trialConstraints(),
+                                        local_assembler.testConstraints());
+        return matrix_structure_cache;
+      }
+
     private:
+
+      template<typename JacobianEngine>
+      struct BorderExchangeStarter
+      {
+        BorderExchangeStarter(const GridOperator& go_, JacobianEngine& engine_, const Jacobian& a_)
+          : go(go_), engine(engine_), a(a_)
+        {}
+
+        void operator()()
+        {
+          engine.preFinalizeConstraints(go.testGridFunctionSpace());
+          go.dof_exchanger->startAccumulation(go,a);
+        }
+
+        const GridOperator& go;
+        JacobianEngine& engine;
+        const Jacobian& a;
+      };
+
       Assembler global_assembler;
       shared_ptr<BorderDOFExchanger> dof_exchanger;
 
       mutable LocalAssembler local_assembler;
       MB backend;
+      mutable MatrixStructureCache matrix_structure_cache;
 
     };
 
@@ -5,6 +5,7 @@
 #include <dune/pdelab/instationary/onestep.hh>
 #include <dune/pdelab/gridoperator/onestep/localassembler.hh>
 #include <dune/pdelab/gridoperator/common/gridoperatorutilities.hh>
+#include <dune/pdelab/gridoperator/common/matrixstructurecache.hh>
 #include <dune/pdelab/constraints/common/constraints.hh>
 
 namespace Dune{
@@ -182,6 +183,26 @@ namespace Dune{
         global_assembler.assemble(jacobian_residual_engine);
       }
 
+      //! Assemble only the residuals for explicit treatment
+      /**
+       * Same as explicit_jacobian_residual(), but leaves the mass matrix
+       * untouched.  This allows to assemble a time-independent mass matrix
+       * only once.
+       */
+      void explicit_residual(unsigned int stage, const std::vector<Domain*> & x,
+                             Range & r1, Range & r0)
+      {
+        if(implicit){DUNE_THROW(Dune::Exception,"This function should not be called in implicit mode");}
+
+        local_assembler.setStage(stage);
+
+        typedef typename LocalAssembler::LocalPreStageAssemblerEngine PreStageEngine;
+        PreStageEngine & prestage_engine
+          = local_assembler.localExplicitPreStageAssemblerEngine(r0,r1,x);
+
+        global_assembler.assemble(prestage_engine);
+      }
+
       //! Interpolate constrained values from given function f
       template<typename F, typename X>
       void interpolate (unsigned stage, const X& xold, F& f, X& x) const
@@ -239,6 +260,7 @@ namespace Dune{
         go0.update();
         go1.update();
         const_residual = Range(go0.testGridFunctionSpace());
+        matrix_structure_cache.clear();
       }
 
       const typename Traits::MatrixBackend& matrixBackend() const
@@ -246,6 +268,25 @@ namespace Dune{
         return go0.matrixBackend();
       }
 
+      //! Get the cache for the sparsity structure of matrices built from this grid operator.
+      /**
+       * Matrix containers supporting it (currently the ISTL containers) only run the pattern
+       * assembly for the first matrix and set up all further matrices from the structure stored
+       * in this cache. The cache is discarded automatically after the trial or test space has been
+       * updated, after the number of constrained DOFs has changed and by update(). If the sparsity
+       * pattern changes for other reasons, e.g. because constraints have been recomputed in place
+       * with the same number of constrained DOFs, but different constraint entries, call update()
+       * or disable the cache.
+       */
+      MatrixStructureCache& matrixStructureCache() const
+      {
+        matrix_structure_cache.validate(trialGridFunctionSpace().revision(),
+                                        testGridFunctionSpace().revision(),
+                                        local_assembler.trialConstraints(),
+                                        local_assembler.testConstraints());
+        return matrix_structure_cache;
+      }
+
     private:
       Assembler & global_assembler;
       GO0 & go0;
@@ -254,6 +295,7 @@ namespace Dune{
       LocalAssemblerDT1 & la1;
       Range const_residual;
       mutable LocalAssembler local_assembler;
+      mutable MatrixStructureCache matrix_structure_cache;
     };
 
   }
@@ -211,6 +211,17 @@ namespace Dune{
         return la1.localPatternAssemblerEngine(p);
       }
 
+      //! Returns a reference to the requested engine. This engine is
+      //! completely configured and ready to use.
+      LocalPreStageAssemblerEngine & localExplicitPreStageAssemblerEngine
+      (typename Traits::Residual & r0, typename Traits::Residual & r1,
+       const std::vector<typename Traits::Solution*> & x)
+      {
+        prestage_engine.setSolutions(x);
+        prestage_engine.setConstResiduals(r0,r1);
+        return prestage_engine;
+      }
+
       //! Returns a reference to the requested engine. This engine is
       //! completely configured and ready to use.
       LocalExplicitJacobianResidualAssemblerEngine & localExplicitJacobianResidualAssemblerEngine
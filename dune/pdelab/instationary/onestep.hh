@@ -15,7 +15,10 @@
 #include <dune/common/fmatrix.hh>
 #include <dune/common/fvector.hh>
 #include <dune/common/ios_state.hh>
+#include <dune/common/shared_ptr.hh>
+#include <dune/common/typetraits.hh>
 
+#include <dune/pdelab/backend/solver.hh>
 #include <dune/pdelab/common/logtag.hh>
 #include <dune/pdelab/gridoperator/common/timesteppingparameterinterface.hh>
 
@@ -402,6 +405,190 @@ namespace Dune {
       Dune::FieldMatrix<R,4,5> B;
     };
 
+    //! Base parameter class for low-storage Runge-Kutta schemes
+    /**
+     * Describes an explicit s-stage scheme in the 2N-storage form of
+     * Williamson, which only needs the solution \f$u\f$ and one update
+     * register \f$\Delta u\f$:
+     * \f{align*}{
+     \Delta u &\leftarrow a_r \Delta u + \Delta t F(t+c_r\Delta t,u), \\
+     u &\leftarrow u + b_r \Delta u, \qquad r = 1,\ldots,s.
+     * \f}
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class LowStorageRKParameterInterface
+    {
+    public:
+      typedef R RealType;
+
+      /*! \brief Return number of stages s of the method
+       */
+      virtual unsigned s () const = 0;
+
+      /*! \brief Return the factor for the update register
+        \note that r ∈ 1,...,s and a(1) = 0
+      */
+      virtual R a (int r) const = 0;
+
+      /*! \brief Return the factor for the update of the solution
+        \note that r ∈ 1,...,s
+      */
+      virtual R b (int r) const = 0;
+
+      /*! \brief Return the time of the stage relative to the time step
+        \note that r ∈ 1,...,s
+      */
+      virtual R c (int r) const = 0;
+
+      /*! \brief Return name of the scheme
+       */
+      virtual std::string name () const = 0;
+
+      //! every abstract base class has a virtual destructor
+      virtual ~LowStorageRKParameterInterface () {}
+    };
+
+    /**
+     * \brief Parameters to turn the LowStorageExplicitOneStepMethod into
+     * the third order 2N-storage scheme of Williamson.
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class Williamson3Parameter : public LowStorageRKParameterInterface<R>
+    {
+    public:
+
+      Williamson3Parameter ()
+      {
+        A[0] = 0.0;       A[1] = -5.0/9.0;   A[2] = -153.0/128.0;
+        B[0] = 1.0/3.0;   B[1] = 15.0/16.0;  B[2] = 8.0/15.0;
+        C[0] = 0.0;       C[1] = 1.0/3.0;    C[2] = 3.0/4.0;
+      }
+
+      /*! \brief Return number of stages s of the method
+       */
+      virtual unsigned s () const
+      {
+        return 3;
+      }
+
+      /*! \brief Return the factor for the update register
+        \note that r ∈ 1,...,s
+      */
+      virtual R a (int r) const
+      {
+        return A[r-1];
+      }
+
+      /*! \brief Return the factor for the update of the solution
+        \note that r ∈ 1,...,s
+      */
+      virtual R b (int r) const
+      {
+        return B[r-1];
+      }
+
+      /*! \brief Return the time of the stage relative to the time step
+        \note that r ∈ 1,...,s
+      */
+      virtual R c (int r) const
+      {
+        return C[r-1];
+      }
+
+      /*! \brief Return name of the scheme
+       */
+      virtual std::string name () const
+      {
+        return std::string("Williamson's low-storage third order method");
+      }
+
+    private:
+      Dune::FieldVector<R,3> A;
+      Dune::FieldVector<R,3> B;
+      Dune::FieldVector<R,3> C;
+    };
+
+    /**
+     * \brief Parameters to turn the LowStorageExplicitOneStepMethod into
+     * the five stage, fourth order 2N-storage scheme of Carpenter and
+     * Kennedy.
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class CarpenterKennedy4Parameter : public LowStorageRKParameterInterface<R>
+    {
+    public:
+
+      CarpenterKennedy4Parameter ()
+      {
+        A[0] = 0.0;
+        A[1] = -567301805773.0/1357537059087.0;
+        A[2] = -2404267990393.0/2016746695238.0;
+        A[3] = -3550918686646.0/2091501179385.0;
+        A[4] = -1275806237668.0/842570457699.0;
+
+        B[0] = 1432997174477.0/9575080441755.0;
+        B[1] = 5161836677717.0/13612068292357.0;
+        B[2] = 1720146321549.0/2090206949498.0;
+        B[3] = 3134564353537.0/4481467310338.0;
+        B[4] = 2277821191437.0/14882151754819.0;
+
+        C[0] = 0.0;
+        C[1] = 1432997174477.0/9575080441755.0;
+        C[2] = 2526269341429.0/6820363962896.0;
+        C[3] = 2006345519317.0/3224310063776.0;
+        C[4] = 2802321613138.0/2924317926251.0;
+      }
+
+      /*! \brief Return number of stages s of the method
+       */
+      virtual unsigned s () const
+      {
+        return 5;
+      }
+
+      /*! \brief Return the factor for the update register
+        \note that r ∈ 1,...,s
+      */
+      virtual R a (int r) const
+      {
+        return A[r-1];
+      }
+
+      /*! \brief Return the factor for the update of the solution
+        \note that r ∈ 1,...,s
+      */
+      virtual R b (int r) const
+      {
+        return B[r-1];
+      }
+
+      /*! \brief Return the time of the stage relative to the time step
+        \note that r ∈ 1,...,s
+      */
+      virtual R c (int r) const
+      {
+        return C[r-1];
+      }
+
+      /*! \brief Return name of the scheme
+       */
+      virtual std::string name () const
+      {
+        return std::string("Carpenter-Kennedy low-storage RK4");
+      }
+
+    private:
+      Dune::FieldVector<R,5> A;
+      Dune::FieldVector<R,5> B;
+      Dune::FieldVector<R,5> C;
+    };
+
 
 
 
@@ -1129,8 +1316,38 @@ namespace Dune {
       Result res;
     };
 
+#ifndef DOXYGEN
+
+    namespace impl {
+
+      // Controls the reuse of the inverted mass matrix in linear solvers
+      // which support it
+      template<class S, bool reusable = IsBaseOf<ReusablePreconditioner,S>::value>
+      struct ExplicitOneStepSolverTraits
+      {
+        static void setReuse(S& solver, bool reuse)
+        {}
+      };
+
+      template<class S>
+      struct ExplicitOneStepSolverTraits<S,true>
+      {
+        static void setReuse(S& solver, bool reuse)
+        {
+          solver.setReuse(reuse);
+        }
+      };
+
+    } // namespace impl
+
+#endif // DOXYGEN
+
     //! Do one step of an explicit time-stepping scheme
     /**
+     * The vectors for the intermediate stages, the residual vectors and the
+     * mass matrix are kept between time steps and are only reallocated after
+     * the trial or test space has been updated.
+     *
      * \tparam T          type to represent time values
      * \tparam IGOS       assembler for instationary problems
      * \tparam LS         backend to solve diagonal linear system
@@ -1143,6 +1360,7 @@ namespace Dune {
     {
       typedef typename TrlV::ElementType Real;
       typedef typename IGOS::template MatrixContainer<Real>::Type M;
+      typedef impl::ExplicitOneStepSolverTraits<LS> SolverTraits;
 
     public:
       //! construct a new one step scheme
@@ -1158,7 +1376,8 @@ namespace Dune {
        * Use SimpleTimeController that does not control the time step.
        */
       ExplicitOneStepMethod(const TimeSteppingParameterInterface<T>& method_, IGOS& igos_, LS& ls_)
-        : method(&method_), igos(igos_), ls(ls_), verbosityLevel(1), step(1), D(igos),
+        : method(&method_), igos(igos_), ls(ls_), verbosityLevel(1), step(1),
+          trial_revision(0), test_revision(0), constant_mass(false), mass_assembled(false),
           tc(new SimpleTimeController<T>()), allocated(true)
       {
         if (method->implicit())
@@ -1180,7 +1399,8 @@ namespace Dune {
        * there).
        */
       ExplicitOneStepMethod(const TimeSteppingParameterInterface<T>& method_, IGOS& igos_, LS& ls_, TC& tc_)
-        : method(&method_), igos(igos_), ls(ls_), verbosityLevel(1), step(1), D(igos),
+        : method(&method_), igos(igos_), ls(ls_), verbosityLevel(1), step(1),
+          trial_revision(0), test_revision(0), constant_mass(false), mass_assembled(false),
           tc(&tc_), allocated(false)
       {
         if (method->implicit())
@@ -1204,6 +1424,26 @@ namespace Dune {
       //! change number of current step
       void setStepNumber(int newstep) { step = newstep; }
 
+      //! assemble the mass matrix only once and reuse it for all stages and steps
+      /**
+       * This is only correct if the temporal part of the grid operator is
+       * linear and does not depend on time.  The mass matrix is assembled
+       * again after the trial or test space has been updated.  If the linear
+       * solver is derived from ReusablePreconditioner, it is also told to keep
+       * its inverse of the mass matrix.
+       */
+      void setConstantMassMatrix(bool constant)
+      {
+        constant_mass = constant;
+        mass_assembled = false;
+      }
+
+      //! returns whether the mass matrix is assembled only once
+      bool constantMassMatrix() const
+      {
+        return constant_mass;
+      }
+
       //! redefine the method to be used; can be done before every step
       /**
        * \param method_ Parameter object.
@@ -1241,16 +1481,12 @@ namespace Dune {
         LocalTag mytag;
         mytag << "ExplicitOneStepMethod::apply(): ";
 
-        std::vector<TrlV*> x(1); // vector of pointers to all steps
-        x[0] = &xold;         // initially we have only one
-        if(verbosityLevel>=4)
-          std::cout << mytag << "Creating residual vectors alpha and beta..."
-                    << std::endl;
-        TstV alpha(igos.testGridFunctionSpace()), beta(igos.testGridFunctionSpace()); // split residual vectors
-        if(verbosityLevel>=4)
-          std::cout << mytag
-                    << "Creating residual vectors alpha and beta... done."
-                    << std::endl;
+        prepareWorkspace(mytag);
+        x.resize(1);  // vector of pointers to all steps
+        x[0] = &xold; // initially we have only one
+        TstV& alpha = *alpha_ptr; // split residual vectors
+        TstV& beta = *beta_ptr;
+        M& D = *D_ptr;
 
         if (verbosityLevel>=1){
           std::ios_base::fmtflags oldflags = std::cout.flags();
@@ -1305,25 +1541,32 @@ namespace Dune {
             else
               {
                 // intermediate step
-                x.push_back(new TrlV(igos.trialGridFunctionSpace()));
+                x.push_back(stages[r-1].get());
                 if (r>1)
                   *(x[r]) = *(x[r-1]); // use result of last stage as initial guess
                 else
                   *(x[r]) = xnew;
               }
 
-            // compute residuals and jacobian
-            if (verbosityLevel>=4) std::cout << "assembling D, alpha, beta ..." << std::endl;
-            D = 0.0;
-            alpha = 0.0;
-            beta = 0.0;
+            // compute residuals and jacobian, alpha and beta are cleared by the assembler
+            const bool assemble_mass = !constant_mass || !mass_assembled;
+            if (verbosityLevel>=4)
+              std::cout << (assemble_mass ? "assembling D, alpha, beta ..." : "assembling alpha, beta ...")
+                        << std::endl;
 
             //apply slope limiter to old solution (e.g for finite volume reconstruction scheme)
             limiter.prestage(*x[r-1]);
 
             if(verbosityLevel>=4)
               std::cout << stagetag << "Assembling residual..." << std::endl;
-            igos.explicit_jacobian_residual(r,x,D,alpha,beta);
+            if (assemble_mass)
+              {
+                D = 0.0;
+                igos.explicit_jacobian_residual(r,x,D,alpha,beta);
+                mass_assembled = constant_mass;
+              }
+            else
+              igos.explicit_residual(r,x,alpha,beta);
             if(verbosityLevel>=4)
               std::cout << stagetag << "Assembling residual... done."
                         << std::endl;
@@ -1374,6 +1617,7 @@ namespace Dune {
             if (verbosityLevel>=4)
               std::cout << stagetag << "Solving diagonal system..."
                         << std::endl;
+            SolverTraits::setReuse(ls,constant_mass && !assemble_mass);
             ls.apply(D,*x[r],alpha,0.99); // dummy reduction
             if (verbosityLevel>=4)
               std::cout << stagetag << "Solving diagonal system... done."
@@ -1393,9 +1637,6 @@ namespace Dune {
               std::cout << stagetag << "Finished." << std::endl;
           }
 
-        // delete intermediate steps
-        for(unsigned i=1; i<method->s(); ++i) delete x[i];
-
         // step cleanup
         if (verbosityLevel>=4)
           std::cout << mytag << "Cleanup..." << std::endl;
@@ -1409,6 +1650,33 @@ namespace Dune {
 
     private:
 
+      // (re)allocates the stage vectors, the residual vectors and the mass matrix
+      void prepareWorkspace(const LocalTag& mytag)
+      {
+        const std::size_t trial = igos.trialGridFunctionSpace().revision();
+        const std::size_t test = igos.testGridFunctionSpace().revision();
+        if (!D_ptr || trial != trial_revision || test != test_revision)
+          {
+            if(verbosityLevel>=4)
+              std::cout << mytag << "Creating residual vectors alpha and beta..."
+                        << std::endl;
+            stages.clear();
+            alpha_ptr = make_shared<TstV>(igos.testGridFunctionSpace());
+            beta_ptr = make_shared<TstV>(igos.testGridFunctionSpace());
+            D_ptr = make_shared<M>(igos);
+            trial_revision = trial;
+            test_revision = test;
+            mass_assembled = false;
+            if(verbosityLevel>=4)
+              std::cout << mytag
+                        << "Creating residual vectors alpha and beta... done."
+                        << std::endl;
+          }
+        // the last stage is written directly into xnew
+        while (stages.size()+1 < method->s())
+          stages.push_back(make_shared<TrlV>(igos.trialGridFunctionSpace()));
+      }
+
       //! dummy default limiter
       class DefaultLimiter
       {
@@ -1427,7 +1695,405 @@ namespace Dune {
       LS& ls;
       int verbosityLevel;
       int step;
-      M D;
+      std::vector<shared_ptr<TrlV> > stages;
+      std::vector<TrlV*> x;
+      shared_ptr<TstV> alpha_ptr;
+      shared_ptr<TstV> beta_ptr;
+      shared_ptr<M> D_ptr;
+      std::size_t trial_revision;
+      std::size_t test_revision;
+      bool constant_mass;
+      bool mass_assembled;
+      TimeControllerInterface<T> *tc;
+      bool allocated;
+    };
+
+#ifndef DOXYGEN
+
+    namespace impl {
+
+      // Presents one stage of a low-storage scheme to the one step grid
+      // operator: the residual of stage r combines the spatial part of the
+      // solution (slot 0) and the mass part of the update register (slot 1),
+      // all evaluated at the time of the stage.
+      template<class R>
+      class LowStorageStageParameter : public TimeSteppingParameterInterface<R>
+      {
+      public:
+
+        LowStorageStageParameter (const LowStorageRKParameterInterface<R>& method_)
+          : method(&method_), stage(1)
+        {}
+
+        void setMethod (const LowStorageRKParameterInterface<R>& method_)
+        {
+          method = &method_;
+        }
+
+        void setStage (int stage_)
+        {
+          stage = stage_;
+        }
+
+        virtual bool implicit () const
+        {
+          return false;
+        }
+
+        virtual unsigned s () const
+        {
+          return method->s();
+        }
+
+        virtual R a (int r, int i) const
+        {
+          if (i == r)
+            return 1.0;
+          if (i == 1)
+            return -method->a(r);
+          return 0.0;
+        }
+
+        virtual R b (int r, int i) const
+        {
+          return i == 0 ? 1.0 : 0.0;
+        }
+
+        virtual R d (int i) const
+        {
+          return method->c(stage);
+        }
+
+        virtual std::string name () const
+        {
+          return method->name();
+        }
+
+      private:
+        const LowStorageRKParameterInterface<R>* method;
+        int stage;
+      };
+
+    } // namespace impl
+
+#endif // DOXYGEN
+
+    //! Do one step of a low-storage explicit Runge-Kutta scheme
+    /**
+     * Works like ExplicitOneStepMethod, but runs schemes in the 2N-storage
+     * form described by LowStorageRKParameterInterface.  Besides the
+     * solution, only a single update register is needed, independent of the
+     * number of stages.  The update register, the residual vectors and the
+     * mass matrix are kept between time steps and are only reallocated after
+     * the trial or test space has been updated.
+     *
+     * \tparam T          type to represent time values
+     * \tparam IGOS       assembler for instationary problems
+     * \tparam LS         backend to solve diagonal linear system
+     * \tparam TrlV       vector type to represent coefficients of solutions
+     * \tparam TstV       vector type to represent residuals
+     * \tparam TC         time controller class
+     */
+    template<class T, class IGOS, class LS, class TrlV, class TstV = TrlV, class TC = SimpleTimeController<T> >
+    class LowStorageExplicitOneStepMethod
+    {
+      typedef typename TrlV::ElementType Real;
+      typedef typename IGOS::template MatrixContainer<Real>::Type M;
+      typedef impl::ExplicitOneStepSolverTraits<LS> SolverTraits;
+
+    public:
+      //! construct a new one step scheme
+      /**
+       * \param method_    Parameter object.
+       * \param igos_      Assembler object (instationary grid operator space).
+       * \param ls_        solver for the diagonal linear system.
+       *
+       * The contructed method object stores references to the object it is
+       * constructed with, so these objects should be valid for as long as the
+       * constructed object is used (or until setMethod() is called, see
+       * there).
+       * Use SimpleTimeController that does not control the time step.
+       */
+      LowStorageExplicitOneStepMethod(const LowStorageRKParameterInterface<T>& method_, IGOS& igos_, LS& ls_)
+        : method(&method_), stage_parameter(method_), igos(igos_), ls(ls_), verbosityLevel(1), step(1),
+          trial_revision(0), test_revision(0), constant_mass(false), mass_assembled(false),
+          tc(new SimpleTimeController<T>()), allocated(true)
+      {
+        if (igos.trialGridFunctionSpace().gridView().comm().rank()>0)
+          verbosityLevel = 0;
+      }
+
+      //! construct a new one step scheme
+      /**
+       * \param method_    Parameter object.
+       * \param igos_      Assembler object (instationary grid operator space).
+       * \param ls_        solver for the diagonal linear system.
+       * \param tc_        a time controller object
+       *
+       * The contructed method object stores references to the object it is
+       * constructed with, so these objects should be valid for as long as the
+       * constructed object is used (or until setMethod() is called, see
+       * there).
+       */
+      LowStorageExplicitOneStepMethod(const LowStorageRKParameterInterface<T>& method_, IGOS& igos_, LS& ls_, TC& tc_)
+        : method(&method_), stage_parameter(method_), igos(igos_), ls(ls_), verbosityLevel(1), step(1),
+          trial_revision(0), test_revision(0), constant_mass(false), mass_assembled(false),
+          tc(&tc_), allocated(false)
+      {}
+
+      ~LowStorageExplicitOneStepMethod ()
+      {
+        if (allocated) delete tc;
+      }
+
+      //! change verbosity level; 0 means completely quiet
+      void setVerbosityLevel (int level)
+      {
+        if (igos.trialGridFunctionSpace().gridView().comm().rank()>0)
+          verbosityLevel = 0;
+        else
+          verbosityLevel = level;
+      }
+
+      //! change number of current step
+      void setStepNumber(int newstep) { step = newstep; }
+
+      //! assemble the mass matrix only once and reuse it for all stages and steps
+      /**
+       * See ExplicitOneStepMethod::setConstantMassMatrix().
+       */
+      void setConstantMassMatrix(bool constant)
+      {
+        constant_mass = constant;
+        mass_assembled = false;
+      }
+
+      //! returns whether the mass matrix is assembled only once
+      bool constantMassMatrix() const
+      {
+        return constant_mass;
+      }
+
+      //! redefine the method to be used; can be done before every step
+      /**
+       * \param method_ Parameter object.
+       *
+       * The LowStorageExplicitOneStepMethod object stores a reference to the
+       * method_ object.  The old method object is no longer referenced after
+       * this member function returns.
+       */
+      void setMethod (const LowStorageRKParameterInterface<T>& method_)
+      {
+        method = &method_;
+        stage_parameter.setMethod(method_);
+      }
+
+      /*! \brief do one step;
+       * \param[in]  time start of time step
+       * \param[in]  dt suggested time step size
+       * \param[in]  xold value at begin of time step
+       * \param[out] xnew value at end of time step
+       * \return time step size
+       */
+      T apply (T time, T dt, TrlV& xold, TrlV& xnew)
+      {
+        DefaultLimiter limiter;
+        return apply(time,dt,xold,xnew,limiter);
+      }
+
+      template<typename Limiter>
+      T apply (T time, T dt, TrlV& xold, TrlV& xnew, Limiter& limiter)
+      {
+        // save formatting attributes
+        ios_base_all_saver format_attribute_saver(std::cout);
+        LocalTag mytag;
+        mytag << "LowStorageExplicitOneStepMethod::apply(): ";
+
+        prepareWorkspace(mytag);
+        TrlV& du = *du_ptr;       // update register
+        TstV& alpha = *alpha_ptr; // split residual vectors
+        TstV& beta = *beta_ptr;
+        M& D = *D_ptr;
+
+        // the solution is updated in place, all later slots refer to the update register
+        xnew = xold;
+        x.assign(method->s()+1,&du);
+        x[0] = &xnew;
+
+        if (verbosityLevel>=1){
+          std::ios_base::fmtflags oldflags = std::cout.flags();
+          std::cout << "TIME STEP [" << method->name() << "] "
+                    << std::setw(6) << step
+                    << " time (from): "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << time
+                    << " dt: "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << dt
+                    << " time (to): "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << time+dt
+                    << std::endl;
+          std::cout.flags(oldflags);
+        }
+
+        // prepare assembler
+        if(verbosityLevel>=4)
+          std::cout << mytag << "Preparing assembler..." << std::endl;
+        stage_parameter.setStage(1);
+        igos.preStep(stage_parameter,time,dt);
+        if(verbosityLevel>=4)
+          std::cout << mytag << "Preparing assembler... done." << std::endl;
+
+        // loop over all stages
+        for(unsigned r=1; r<=method->s(); ++r)
+          {
+            LocalTag stagetag(mytag);
+            stagetag << "stage " << r << ": ";
+            if (verbosityLevel>=4)
+              std::cout << stagetag << "Start." << std::endl;
+
+            if (verbosityLevel>=2){
+              std::ios_base::fmtflags oldflags = std::cout.flags();
+              std::cout << "STAGE "
+                        << r
+                        << " time: "
+                        << std::setw(12) << std::setprecision(4) << std::scientific
+                        << time+method->c(r)*dt
+                        << "." << std::endl;
+              std::cout.flags(oldflags);
+            }
+
+            stage_parameter.setStage(r);
+
+            // compute residuals and jacobian, alpha and beta are cleared by the assembler
+            const bool assemble_mass = !constant_mass || !mass_assembled;
+
+            //apply slope limiter to old solution (e.g for finite volume reconstruction scheme)
+            limiter.prestage(xnew);
+
+            if(verbosityLevel>=4)
+              std::cout << stagetag << "Assembling residual..." << std::endl;
+            if (assemble_mass)
+              {
+                D = 0.0;
+                igos.explicit_jacobian_residual(r,x,D,alpha,beta);
+                mass_assembled = constant_mass;
+              }
+            else
+              igos.explicit_residual(r,x,alpha,beta);
+            if(verbosityLevel>=4)
+              std::cout << stagetag << "Assembling residual... done."
+                        << std::endl;
+
+            // let time controller compute the optimal dt in first stage
+            if (r==1)
+              {
+                T newdt = tc->suggestTimestep(time,dt);
+                newdt = std::min(newdt, dt);
+
+                if (verbosityLevel>=2 && newdt!=dt)
+                  {
+                    std::ios_base::fmtflags oldflags = std::cout.flags();
+                    std::cout << "changed dt to "
+                              << std::setw(12) << std::setprecision(4) << std::scientific
+                              << newdt
+                              << std::endl;
+                    std::cout.flags(oldflags);
+                  }
+                dt = newdt;
+              }
+
+            // combine residual with selected dt
+            alpha.axpy(dt,beta);
+
+            // solve diagonal system for the new update register
+            if (verbosityLevel>=4)
+              std::cout << stagetag << "Solving diagonal system..."
+                        << std::endl;
+            SolverTraits::setReuse(ls,constant_mass && !assemble_mass);
+            ls.apply(D,du,alpha,0.99); // dummy reduction
+            if (verbosityLevel>=4)
+              std::cout << stagetag << "Solving diagonal system... done."
+                        << std::endl;
+
+            // update solution
+            xnew.axpy(method->b(r),du);
+
+            // apply slope limiter to new solution (e.g DG scheme)
+            limiter.poststage(xnew);
+
+            // stage cleanup
+            igos.postStage();
+
+            if (verbosityLevel>=4)
+              std::cout << stagetag << "Finished." << std::endl;
+          }
+
+        // step cleanup
+        if (verbosityLevel>=4)
+          std::cout << mytag << "Cleanup..." << std::endl;
+        igos.postStep();
+        if (verbosityLevel>=4)
+          std::cout << mytag << "Cleanup... done." << std::endl;
+
+        step++;
+        return dt;
+      }
+
+    private:
+
+      // (re)allocates the update register, the residual vectors and the mass matrix
+      void prepareWorkspace(const LocalTag& mytag)
+      {
+        const std::size_t trial = igos.trialGridFunctionSpace().revision();
+        const std::size_t test = igos.testGridFunctionSpace().revision();
+        if (!D_ptr || trial != trial_revision || test != test_revision)
+          {
+            if(verbosityLevel>=4)
+              std::cout << mytag << "Creating update register and residual vectors..."
+                        << std::endl;
+            du_ptr = make_shared<TrlV>(igos.trialGridFunctionSpace());
+            alpha_ptr = make_shared<TstV>(igos.testGridFunctionSpace());
+            beta_ptr = make_shared<TstV>(igos.testGridFunctionSpace());
+            D_ptr = make_shared<M>(igos);
+            trial_revision = trial;
+            test_revision = test;
+            mass_assembled = false;
+            if(verbosityLevel>=4)
+              std::cout << mytag << "Creating update register and residual vectors... done."
+                        << std::endl;
+          }
+      }
+
+      //! dummy default limiter
+      class DefaultLimiter
+      {
+      public:
+        template<typename V>
+        void prestage(V& v)
+        {}
+
+        template<typename V>
+        void poststage(V& v)
+        {}
+      };
+
+      const LowStorageRKParameterInterface<T> *method;
+      impl::LowStorageStageParameter<T> stage_parameter;
+      IGOS& igos;
+      LS& ls;
+      int verbosityLevel;
+      int step;
+      shared_ptr<TrlV> du_ptr;
+      std::vector<TrlV*> x;
+      shared_ptr<TstV> alpha_ptr;
+      shared_ptr<TstV> beta_ptr;
+      shared_ptr<M> D_ptr;
+      std::size_t trial_revision;
+      std::size_t test_revision;
+      bool constant_mass;
+      bool mass_assembled;
       TimeControllerInterface<T> *tc;
       bool allocated;
     };
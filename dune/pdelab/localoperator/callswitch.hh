@@ -43,6 +43,10 @@ namespace Dune {
       static void alpha_volume_post_skeleton (const LA& la, const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r)
       {
       }
+      template<typename Batch, typename LFSU, typename X, typename LFSV, typename R>
+      static void alpha_volume_batch (const LA& la, const Batch& batch, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r)
+      {
+      }
       template<typename IG, typename LFSU, typename X, typename LFSV, typename R>
       static void alpha_skeleton (const LA& la, const IG& ig,
         const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
@@ -97,6 +101,27 @@ namespace Dune {
         Y& y_s)
       {
       }
+      template<typename EG, typename LFSU, typename X, typename Z, typename LFSV, typename Y>
+      static void jacobian_apply_volume (const LA& la, const EG& eg, const LFSU& lfsu, const X& x, const Z& z, const LFSV& lfsv, Y& y)
+      {
+      }
+      template<typename EG, typename LFSU, typename X, typename Z, typename LFSV, typename Y>
+      static void jacobian_apply_volume_post_skeleton (const LA& la, const EG& eg, const LFSU& lfsu, const X& x, const Z& z, const LFSV& lfsv, Y& y)
+      {
+      }
+      template<typename IG, typename LFSU, typename X, typename Z, typename LFSV, typename Y>
+      static void jacobian_apply_skeleton (const LA& la, const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const Z& z_s, const LFSV& lfsv_s,
+        const LFSU& lfsu_n, const X& x_n, const Z& z_n, const LFSV& lfsv_n,
+        Y& y_s, Y& y_n)
+      {
+      }
+      template<typename IG, typename LFSU, typename X, typename Z, typename LFSV, typename Y>
+      static void jacobian_apply_boundary (const LA& la, const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const Z& z_s, const LFSV& lfsv_s,
+        Y& y_s)
+      {
+      }
       template<typename EG, typename LFSU, typename X, typename LFSV, typename M>
       static void jacobian_volume (const LA& la, const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, M & mat)
       {
@@ -105,6 +130,14 @@ namespace Dune {
       static void jacobian_volume_post_skeleton (const LA& la, const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, M& mat)
       {
       }
+      template<typename Batch, typename LFSU, typename X, typename LFSV, typename M>
+      static void jacobian_volume_batch (const LA& la, const Batch& batch, const LFSU& lfsu, const X& x, const LFSV& lfsv, M& mat)
+      {
+      }
+      template<typename EG, typename LFSU, typename X, typename LFSV, typename R, typename M>
+      static void alpha_jacobian_volume (const LA& la, const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r, M& mat)
+      {
+      }
       template<typename IG, typename LFSU, typename X, typename LFSV, typename M>
       static void jacobian_skeleton (const LA& la, const IG& ig,
         const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
@@ -163,6 +196,11 @@ namespace Dune {
       {
         la.alpha_volume_post_skeleton(eg,lfsu,x,lfsv,r);
       }
+      template<typename Batch, typename LFSU, typename X, typename LFSV, typename R>
+      static void alpha_volume_batch (const LA& la, const Batch& batch, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r)
+      {
+        la.alpha_volume_batch(batch,lfsu,x,lfsv,r);
+      }
       template<typename IG, typename LFSU, typename X, typename LFSV, typename R>
       static void alpha_skeleton (const LA& la, const IG& ig,
         const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
@@ -227,6 +265,31 @@ namespace Dune {
       {
         la.jacobian_apply_boundary(ig,lfsu_s,x_s,lfsv_s,y_s);
       }
+      template<typename EG, typename LFSU, typename X, typename Z, typename LFSV, typename Y>
+      static void jacobian_apply_volume (const LA& la, const EG& eg, const LFSU& lfsu, const X& x, const Z& z, const LFSV& lfsv, Y& y)
+      {
+        la.jacobian_apply_volume(eg,lfsu,x,z,lfsv,y);
+      }
+      template<typename EG, typename LFSU, typename X, typename Z, typename LFSV, typename Y>
+      static void jacobian_apply_volume_post_skeleton (const LA& la, const EG& eg, const LFSU& lfsu, const X& x, const Z& z, const LFSV& lfsv, Y& y)
+      {
+        la.jacobian_apply_volume_post_skeleton(eg,lfsu,x,z,lfsv,y);
+      }
+      template<typename IG, typename LFSU, typename X, typename Z, typename LFSV, typename Y>
+      static void jacobian_apply_skeleton (const LA& la, const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const Z& z_s, const LFSV& lfsv_s,
+        const LFSU& lfsu_n, const X& x_n, const Z& z_n, const LFSV& lfsv_n,
+        Y& y_s, Y& y_n)
+      {
+        la.jacobian_apply_skeleton(ig,lfsu_s,x_s,z_s,lfsv_s,lfsu_n,x_n,z_n,lfsv_n,y_s,y_n);
+      }
+      template<typename IG, typename LFSU, typename X, typename Z, typename LFSV, typename Y>
+      static void jacobian_apply_boundary (const LA& la, const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const Z& z_s, const LFSV& lfsv_s,
+        Y& y_s)
+      {
+        la.jacobian_apply_boundary(ig,lfsu_s,x_s,z_s,lfsv_s,y_s);
+      }
 
       template<typename EG, typename LFSU, typename X, typename LFSV, typename M>
       static void jacobian_volume (const LA& la, const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, M & mat)
@@ -238,6 +301,16 @@ namespace Dune {
       {
         la.jacobian_volume_post_skeleton(eg,lfsu,x,lfsv,mat);
       }
+      template<typename Batch, typename LFSU, typename X, typename LFSV, typename M>
+      static void jacobian_volume_batch (const LA& la, const Batch& batch, const LFSU& lfsu, const X& x, const LFSV& lfsv, M & mat)
+      {
+        la.jacobian_volume_batch(batch,lfsu,x,lfsv,mat);
+      }
+      template<typename EG, typename LFSU, typename X, typename LFSV, typename R, typename M>
+      static void alpha_jacobian_volume (const LA& la, const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r, M & mat)
+      {
+        la.alpha_jacobian_volume(eg,lfsu,x,lfsv,r,mat);
+      }
       template<typename IG, typename LFSU, typename X, typename LFSV, typename M>
       static void jacobian_skeleton (const LA& la, const IG& ig,
         const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
@@ -17,6 +17,7 @@
 #include"idefault.hh"
 #include"flags.hh"
 #include"l2.hh"
+#include"scratch.hh"
 #include"stokesparameter.hh"
 
 namespace Dune {
@@ -123,13 +124,13 @@ namespace Dune {
              ++it)
           {
             // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
-            std::vector<JacobianType_V> js(vsize);
+            std::vector<JacobianType_V>& js = scratch.get<JacobianType_V>(0,vsize);
             lfsu_v_pfs.child(0).finiteElement().localBasis().evaluateJacobian(it->position(),js);
 
             // transform gradient to real element
             const typename EG::Geometry::JacobianInverseTransposed jac =
               eg.geometry().jacobianInverseTransposed(it->position());
-            std::vector<Dune::FieldVector<RF,dim> > gradphi(vsize);
+            std::vector<Dune::FieldVector<RF,dim> >& gradphi = scratch.get<Dune::FieldVector<RF,dim> >(1,vsize);
             for (size_t i=0; i<vsize; i++)
               {
                 gradphi[i] = 0.0;
@@ -137,13 +138,13 @@ namespace Dune {
               }
 
             // evaluate basis functions
-            std::vector<RT_P> psi(psize);
+            std::vector<RT_P>& psi = scratch.get<RT_P>(2,psize);
             lfsu_p.finiteElement().localBasis().evaluateFunction(it->position(),psi);
 
             // compute u (if Navier term enabled)
             Dune::FieldVector<RF,dim> vu(0.0);
 
-            std::vector<RT_V> phi(vsize);
+            std::vector<RT_V>& phi = scratch.get<RT_V>(3,vsize);
             if(navier)
               {
                 lfsu_v_pfs.child(0).finiteElement().localBasis().evaluateFunction(it->position(),phi);
@@ -258,10 +259,10 @@ namespace Dune {
              it != endit;
              ++it)
           {
-            std::vector<RT_V> phi(vsize);
+            std::vector<RT_V>& phi = scratch.get<RT_V>(0,vsize);
             lfsv_v_pfs.child(0).finiteElement().localBasis().evaluateFunction(it->position(),phi);
 
-            std::vector<RT_P> psi(psize);
+            std::vector<RT_P>& psi = scratch.get<RT_P>(1,psize);
             lfsv_p.finiteElement().localBasis().evaluateFunction(it->position(),psi);
 
             // forcing term
@@ -341,7 +342,7 @@ namespace Dune {
             Dune::FieldVector<DF,dim> local = ig.geometryInInside().global(it->position());
 
             // evaluate basis functions
-            std::vector<RT_V> phi(vsize);
+            std::vector<RT_V>& phi = scratch.get<RT_V>(0,vsize);
             lfsv_v_pfs.child(0).finiteElement().localBasis().evaluateFunction(local,phi);
 
             const RF factor = it->weight() * ig.geometry().integrationElement(it->position());
@@ -410,13 +411,13 @@ namespace Dune {
              ++it)
           {
             // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
-            std::vector<JacobianType_V> js(vsize);
+            std::vector<JacobianType_V>& js = scratch.get<JacobianType_V>(0,vsize);
             lfsu_v_pfs.child(0).finiteElement().localBasis().evaluateJacobian(it->position(),js);
 
             // transform gradient to real element
             const typename EG::Geometry::JacobianInverseTransposed jac =
               eg.geometry().jacobianInverseTransposed(it->position());
-            std::vector<Dune::FieldVector<RF,dim> > gradphi(vsize);
+            std::vector<Dune::FieldVector<RF,dim> >& gradphi = scratch.get<Dune::FieldVector<RF,dim> >(1,vsize);
             for (size_t i=0; i<vsize; i++)
               {
                 gradphi[i] = 0.0;
@@ -424,11 +425,11 @@ namespace Dune {
               }
 
             // evaluate basis functions
-            std::vector<RT_P> psi(psize);
+            std::vector<RT_P>& psi = scratch.get<RT_P>(2,psize);
             lfsu_p.finiteElement().localBasis().evaluateFunction(it->position(),psi);
 
             // compute u (if Navier term enabled)
-            std::vector<RT_V> phi(vsize);
+            std::vector<RT_V>& phi = scratch.get<RT_V>(3,vsize);
             Dune::FieldVector<RF,dim> vu(0.0);
             if(navier){
               lfsu_v_pfs.child(0).finiteElement().localBasis().evaluateFunction(it->position(),phi);
@@ -508,6 +509,7 @@ namespace Dune {
     private:
       const P& _p;
       const std::size_t _quadrature_order;
+      mutable LocalOperatorScratch scratch;
     };
 
 
@@ -591,11 +593,13 @@ namespace Dune {
         Dune::GeometryType gt = eg.geometry().type();
         const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,intorder);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<RangeType>& phi = scratch.get<RangeType>(0,lfsu.size(),lfsu.maxSize());
+
         // loop over quadrature points
         for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
             // evaluate basis functions
-            std::vector<RangeType> phi(lfsu.size());
             FESwitch::basis(lfsu.finiteElement()).evaluateFunction(it->position(),phi);
 
             RF rho = p.rho(eg,it->position());
@@ -638,11 +642,13 @@ namespace Dune {
         Dune::GeometryType gt = eg.geometry().type();
         const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,intorder);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<RangeType>& phi = scratch.get<RangeType>(0,lfsu.size(),lfsu.maxSize());
+
         // loop over quadrature points
         for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
             // evaluate basis functions
-            std::vector<RangeType> phi(lfsu.size());
             FESwitch::basis(lfsu.finiteElement()).evaluateFunction(it->position(),phi);
 
             // integrate phi_j*phi_i
@@ -656,6 +662,7 @@ namespace Dune {
 
       const P & p;
       int intorder;
+      mutable LocalOperatorScratch scratch;
     };
 
     //! \} group LocalOperator
@@ -19,6 +19,7 @@
 #include"pattern.hh"
 #include"flags.hh"
 #include"idefault.hh"
+#include"scratch.hh"
 
 
 namespace Dune {
@@ -272,15 +273,19 @@ namespace Dune {
         tensor = param.D(eg.entity(),localcenter);
 
         // evaluate nonlinearity w(x_i); we assume here it is a Lagrange basis!
-        std::vector<typename T::Traits::RangeFieldType> w(lfsu.size());
+        std::vector<typename T::Traits::RangeFieldType>& w = scratch.get<typename T::Traits::RangeFieldType>(0,lfsu.size(),lfsu.maxSize());
         for (size_type i=0; i<lfsu.size(); i++)
           w[i] = param.w(eg.entity(),localcenter,x(lfsu,i));
 
+        // temporaries, requested once for all quadrature points
+        std::vector<RangeType>& phi = scratch.get<RangeType>(1,lfsu.size(),lfsu.maxSize());
+        std::vector<JacobianType>& js = scratch.get<JacobianType>(2,lfsu.size(),lfsu.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& gradphi = scratch.get<Dune::FieldVector<RF,dim> >(3,lfsu.size(),lfsu.maxSize());
+
         // loop over quadrature points
         for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
             // evaluate basis functions
-            std::vector<RangeType> phi(lfsu.size());
             lfsu.finiteElement().localBasis().evaluateFunction(it->position(),phi);
 
             // evaluate u
@@ -295,13 +300,11 @@ namespace Dune {
             typename T::Traits::RangeType q = param.q(eg.entity(),it->position(),u);
 
             // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
-            std::vector<JacobianType> js(lfsu.size());
             lfsu.finiteElement().localBasis().evaluateJacobian(it->position(),js);
 
             // transform gradients of shape functions to real element
             const typename EG::Geometry::JacobianInverseTransposed jac
               = eg.geometry().jacobianInverseTransposed(it->position());
-            std::vector<Dune::FieldVector<RF,dim> > gradphi(lfsu.size());
             for (size_type i=0; i<lfsu.size(); i++)
               {
                 gradphi[i] = 0.0;
@@ -351,10 +354,13 @@ namespace Dune {
         // evaluate nonlinearity w(x_i); we assume here it is a Lagrange basis!
         Dune::FieldVector<DF,dim-1> facecenterlocal = Dune::ReferenceElements<DF,dim-1>::general(gtface).position(0,0);
         Dune::FieldVector<DF,dim> facecenterinelement = ig.geometryInInside().global( facecenterlocal );
-        std::vector<typename T::Traits::RangeFieldType> w(lfsu_s.size());
+        std::vector<typename T::Traits::RangeFieldType>& w = scratch.get<typename T::Traits::RangeFieldType>(0,lfsu_s.size(),lfsu_s.maxSize());
         for (size_type i=0; i<lfsu_s.size(); i++)
           w[i] = param.w(*(ig.inside()),facecenterinelement,x_s(lfsu_s,i));
 
+        // temporaries, requested once for all quadrature points
+        std::vector<RangeType>& phi = scratch.get<RangeType>(1,lfsv_s.size(),lfsv_s.maxSize());
+
         // loop over quadrature points and integrate normal flux
         for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
@@ -367,7 +373,6 @@ namespace Dune {
             Dune::FieldVector<DF,dim> local = ig.geometryInInside().global(it->position());
 
             // evaluate test shape functions
-            std::vector<RangeType> phi(lfsv_s.size());
             lfsv_s.finiteElement().localBasis().evaluateFunction(local,phi);
 
             // evaluate u
@@ -395,6 +400,7 @@ namespace Dune {
     private:
       T& param;
       int intorder;
+      mutable LocalOperatorScratch scratch;
     };
 
     //! \} group LocalOperator
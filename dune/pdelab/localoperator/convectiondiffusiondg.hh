@@ -4,6 +4,8 @@
 
 #include<dune/common/exceptions.hh>
 #include<dune/common/fvector.hh>
+#include<dune/common/shared_ptr.hh>
+#include<dune/common/typetraits.hh>
 #include<dune/common/static_assert.hh>
 #include<dune/geometry/referenceelements.hh>
 #include<dune/pdelab/common/function.hh>
@@ -11,7 +13,9 @@
 #include<dune/pdelab/localoperator/flags.hh>
 #include<dune/pdelab/localoperator/idefault.hh>
 #include<dune/pdelab/localoperator/defaultimp.hh>
+#include<dune/pdelab/localoperator/scratch.hh>
 #include<dune/pdelab/finiteelement/localbasiscache.hh>
+#include<dune/pdelab/finiteelement/qkdgsumfactorization.hh>
 
 #include"convectiondiffusionparameter.hh"
 
@@ -91,17 +95,48 @@ namespace Dune {
           Dune::PDELab::NumericalJacobianApplySkeleton<ConvectionDiffusionDG<T,FiniteElementMap> >(1.0e-7),
           Dune::PDELab::NumericalJacobianApplyBoundary<ConvectionDiffusionDG<T,FiniteElementMap> >(1.0e-7),
           param(param_), method(method_), weights(weights_),
-          alpha(alpha_), intorderadd(intorderadd_), quadrature_factor(2),
-          cache(20)
+          alpha(alpha_), intorderadd(intorderadd_), quadrature_factor(2)
       {
         theta = 1.0;
         if (method==ConvectionDiffusionDGMethod::SIPG) theta = -1.0;
       }
 
+      //! evaluate the volume and skeleton terms of the residual with sum factorization
+      /**
+       * Only available for the tensor product bases of QkDGLocalFiniteElementMap, see
+       * QkDGSumFactorization. Intersections on which the local coordinate systems of the
+       * two elements are not aligned, boundary intersections and the analytic jacobians
+       * still use the standard evaluation. The matrix-free application of the jacobian
+       * is based on the residual and benefits as well.
+       */
+      void setSumFactorization (bool enable)
+      {
+        if (!enable)
+          {
+            sumfact.reset();
+            return;
+          }
+        if (!SumFactorizationTraits::available)
+          DUNE_THROW(Dune::NotImplemented,"sum factorization is only available for QkDGLocalFiniteElementMap");
+        makeSumFactorization(integral_constant<bool,SumFactorizationTraits::available>());
+      }
+
+      //! whether the residual is evaluated with sum factorization
+      bool sumFactorization () const
+      {
+        return sumfact.get() != 0;
+      }
+
       // volume integral depending on test and ansatz functions
       template<typename EG, typename LFSU, typename X, typename LFSV, typename R>
       void alpha_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r) const
       {
+        if (sumFactorization())
+          {
+            alpha_volume_sumfact(eg,lfsu,x,lfsv,r,integral_constant<bool,SumFactorizationTraits::available>());
+            return;
+          }
+
         // domain and range field type
         typedef typename LFSU::Traits::FiniteElementType::
           Traits::LocalBasisType::Traits::DomainFieldType DF;
@@ -131,18 +166,32 @@ namespace Dune {
         // transformation
         typename EG::Geometry::JacobianInverseTransposed jac;
 
+#if USECACHE!=0
+        // values and gradients of the basis functions at all quadrature points
+        const typename Cache::Table& lfsu_basis = cache.bind(lfsu.finiteElement().localBasis(),rule);
+        const typename Cache::Table& lfsv_basis = cache.bind(lfsv.finiteElement().localBasis(),rule);
+#else
+        std::vector<RangeType>& phi = scratch.get<RangeType>(0,lfsu.size(),lfsu.maxSize());
+        std::vector<RangeType>& psi = scratch.get<RangeType>(1,lfsv.size(),lfsv.maxSize());
+        std::vector<JacobianType>& js = scratch.get<JacobianType>(2,lfsu.size(),lfsu.maxSize());
+        std::vector<JacobianType>& js_v = scratch.get<JacobianType>(3,lfsv.size(),lfsv.maxSize());
+#endif
+
+        // temporaries, requested once for all quadrature points
+        std::vector<Dune::FieldVector<RF,dim> >& gradphi = scratch.get<Dune::FieldVector<RF,dim> >(4,lfsu.size(),lfsu.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& gradpsi = scratch.get<Dune::FieldVector<RF,dim> >(5,lfsv.size(),lfsv.maxSize());
+
         // loop over quadrature points
-        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
           {
             // evaluate basis functions
 #if USECACHE==0
-            std::vector<RangeType> phi(lfsu.size());
             lfsu.finiteElement().localBasis().evaluateFunction(it->position(),phi);
-            std::vector<RangeType> psi(lfsv.size());
             lfsv.finiteElement().localBasis().evaluateFunction(it->position(),psi);
 #else
-            const std::vector<RangeType>& phi = cache[order].evaluateFunction(it->position(),lfsu.finiteElement().localBasis());
-            const std::vector<RangeType>& psi = cache[order].evaluateFunction(it->position(),lfsv.finiteElement().localBasis());
+            const RangeType* phi = lfsu_basis.evaluateFunction(q);
+            const RangeType* psi = lfsv_basis.evaluateFunction(q);
 #endif
 
             // evaluate u
@@ -152,22 +201,18 @@ namespace Dune {
 
             // evaluate gradient of basis functions (we assume Galerkin method lfsu=lfsv)
 #if USECACHE==0
-            std::vector<JacobianType> js(lfsu.size());
             lfsu.finiteElement().localBasis().evaluateJacobian(it->position(),js);
-            std::vector<JacobianType> js_v(lfsv.size());
             lfsv.finiteElement().localBasis().evaluateJacobian(it->position(),js_v);
 #else
-            const std::vector<JacobianType>& js = cache[order].evaluateJacobian(it->position(),lfsu.finiteElement().localBasis());
-            const std::vector<JacobianType>& js_v = cache[order].evaluateJacobian(it->position(),lfsv.finiteElement().localBasis());
+            const JacobianType* js = lfsu_basis.evaluateJacobian(q);
+            const JacobianType* js_v = lfsv_basis.evaluateJacobian(q);
 #endif
 
             // transform gradients of shape functions to real element
-            jac = eg.geometry().jacobianInverseTransposed(it->position());
-            std::vector<Dune::FieldVector<RF,dim> > gradphi(lfsu.size());
+            jac = eg.jacobianInverseTransposed(it->position());
             for (size_type i=0; i<lfsu.size(); i++)
               jac.mv(js[i][0],gradphi[i]);
 
-            std::vector<Dune::FieldVector<RF,dim> > gradpsi(lfsv.size());
             for (size_type i=0; i<lfsv.size(); i++)
               jac.mv(js_v[i][0],gradpsi[i]);
 
@@ -187,7 +232,7 @@ namespace Dune {
             typename T::Traits::RangeFieldType c = param.c(eg.entity(),it->position());
 
             // integrate (A grad u - bu)*grad phi_i + a*u*phi_i
-            RF factor = it->weight() * eg.geometry().integrationElement(it->position());
+            RF factor = it->weight() * eg.integrationElement(it->position());
             for (size_type i=0; i<lfsv.size(); i++)
               r.accumulate(lfsv,i,( Agradu*gradpsi[i] - u*(b*gradpsi[i]) + c*u*psi[i] )*factor);
           }
@@ -227,29 +272,38 @@ namespace Dune {
         // transformation
         typename EG::Geometry::JacobianInverseTransposed jac;
 
+#if USECACHE!=0
+        // values and gradients of the basis functions at all quadrature points
+        const typename Cache::Table& lfsu_basis = cache.bind(lfsu.finiteElement().localBasis(),rule);
+#else
+        std::vector<RangeType>& phi = scratch.get<RangeType>(0,lfsu.size(),lfsu.maxSize());
+        std::vector<JacobianType>& js = scratch.get<JacobianType>(1,lfsu.size(),lfsu.maxSize());
+#endif
+
+        // temporaries, requested once for all quadrature points
+        std::vector<Dune::FieldVector<RF,dim> >& gradphi = scratch.get<Dune::FieldVector<RF,dim> >(2,lfsu.size(),lfsu.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& Agradphi = scratch.get<Dune::FieldVector<RF,dim> >(3,lfsu.size(),lfsu.maxSize());
+
         // loop over quadrature points
-        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
           {
             // evaluate basis functions
 #if USECACHE==0
-            std::vector<RangeType> phi(lfsu.size());
             lfsu.finiteElement().localBasis().evaluateFunction(it->position(),phi);
 #else
-            const std::vector<RangeType>& phi = cache[order].evaluateFunction(it->position(),lfsu.finiteElement().localBasis());
+            const RangeType* phi = lfsu_basis.evaluateFunction(q);
 #endif
 
             // evaluate gradient of basis functions (we assume Galerkin method lfsu=lfsv)
 #if USECACHE==0
-            std::vector<JacobianType> js(lfsu.size());
             lfsu.finiteElement().localBasis().evaluateJacobian(it->position(),js);
 #else
-            const std::vector<JacobianType>& js = cache[order].evaluateJacobian(it->position(),lfsu.finiteElement().localBasis());
+            const JacobianType* js = lfsu_basis.evaluateJacobian(q);
 #endif
 
             // transform gradients of shape functions to real element
-            jac = eg.geometry().jacobianInverseTransposed(it->position());
-            std::vector<Dune::FieldVector<RF,dim> > gradphi(lfsu.size());
-            std::vector<Dune::FieldVector<RF,dim> > Agradphi(lfsu.size());
+            jac = eg.jacobianInverseTransposed(it->position());
             for (size_type i=0; i<lfsu.size(); i++)
               {
                 jac.mv(js[i][0],gradphi[i]);
@@ -263,7 +317,7 @@ namespace Dune {
             typename T::Traits::RangeFieldType c = param.c(eg.entity(),it->position());
 
             // integrate (A grad u - bu)*grad phi_i + a*u*phi_i
-            RF factor = it->weight() * eg.geometry().integrationElement(it->position());
+            RF factor = it->weight() * eg.integrationElement(it->position());
             for (size_type j=0; j<lfsu.size(); j++)
               for (size_type i=0; i<lfsu.size(); i++)
                 mat.accumulate(lfsu,i,lfsu,j,( Agradphi[j]*gradphi[i] - phi[j]*(b*gradphi[i]) + c*phi[j]*phi[i] )*factor);
@@ -278,6 +332,11 @@ namespace Dune {
                            const LFSU& lfsu_n, const X& x_n, const LFSV& lfsv_n,
                            R& r_s, R& r_n) const
       {
+        if (sumFactorization() &&
+            alpha_skeleton_sumfact(ig,lfsu_s,x_s,lfsv_s,lfsu_n,x_n,lfsv_n,r_s,r_n,
+                                   integral_constant<bool,SumFactorizationTraits::available>()))
+          return;
+
         // domain and range field type
         typedef typename LFSV::Traits::FiniteElementType::
           Traits::LocalBasisType::Traits::DomainFieldType DF;
@@ -357,8 +416,36 @@ namespace Dune {
         // penalty factor
         RF penalty_factor = (alpha/h_F) * harmonic_average * degree*(degree+dim-1);
 
+#if USECACHE!=0
+        // values and gradients of the basis functions at all quadrature points
+        const typename Cache::Table& lfsu_s_basis =
+          cache.bind(lfsu_s.finiteElement().localBasis(),rule,ig.geometryInInside(),ig.indexInInside());
+        const typename Cache::Table& lfsu_n_basis =
+          cache.bind(lfsu_n.finiteElement().localBasis(),rule,ig.geometryInOutside(),ig.indexInOutside());
+        const typename Cache::Table& lfsv_s_basis =
+          cache.bind(lfsv_s.finiteElement().localBasis(),rule,ig.geometryInInside(),ig.indexInInside());
+        const typename Cache::Table& lfsv_n_basis =
+          cache.bind(lfsv_n.finiteElement().localBasis(),rule,ig.geometryInOutside(),ig.indexInOutside());
+#else
+        std::vector<RangeType>& phi_s = scratch.get<RangeType>(0,lfsu_s.size(),lfsu_s.maxSize());
+        std::vector<RangeType>& phi_n = scratch.get<RangeType>(1,lfsu_n.size(),lfsu_n.maxSize());
+        std::vector<RangeType>& psi_s = scratch.get<RangeType>(2,lfsv_s.size(),lfsv_s.maxSize());
+        std::vector<RangeType>& psi_n = scratch.get<RangeType>(3,lfsv_n.size(),lfsv_n.maxSize());
+        std::vector<JacobianType>& gradphi_s = scratch.get<JacobianType>(4,lfsu_s.size(),lfsu_s.maxSize());
+        std::vector<JacobianType>& gradphi_n = scratch.get<JacobianType>(5,lfsu_n.size(),lfsu_n.maxSize());
+        std::vector<JacobianType>& gradpsi_s = scratch.get<JacobianType>(6,lfsv_s.size(),lfsv_s.maxSize());
+        std::vector<JacobianType>& gradpsi_n = scratch.get<JacobianType>(7,lfsv_n.size(),lfsv_n.maxSize());
+#endif
+
+        // temporaries, requested once for all quadrature points
+        std::vector<Dune::FieldVector<RF,dim> >& tgradphi_s = scratch.get<Dune::FieldVector<RF,dim> >(8,lfsu_s.size(),lfsu_s.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& tgradpsi_s = scratch.get<Dune::FieldVector<RF,dim> >(9,lfsv_s.size(),lfsv_s.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& tgradphi_n = scratch.get<Dune::FieldVector<RF,dim> >(10,lfsu_n.size(),lfsu_n.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& tgradpsi_n = scratch.get<Dune::FieldVector<RF,dim> >(11,lfsv_n.size(),lfsv_n.maxSize());
+
         // loop over quadrature points
-        for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
           {
             // exact normal
             const Dune::FieldVector<DF,dim> n_F_local = ig.unitOuterNormal(it->position());
@@ -369,19 +456,15 @@ namespace Dune {
 
             // evaluate basis functions
 #if USECACHE==0
-            std::vector<RangeType> phi_s(lfsu_s.size());
             lfsu_s.finiteElement().localBasis().evaluateFunction(iplocal_s,phi_s);
-            std::vector<RangeType> phi_n(lfsu_n.size());
             lfsu_n.finiteElement().localBasis().evaluateFunction(iplocal_n,phi_n);
-            std::vector<RangeType> psi_s(lfsv_s.size());
             lfsv_s.finiteElement().localBasis().evaluateFunction(iplocal_s,psi_s);
-            std::vector<RangeType> psi_n(lfsv_n.size());
             lfsv_n.finiteElement().localBasis().evaluateFunction(iplocal_n,psi_n);
 #else
-            const std::vector<RangeType>& phi_s = cache[order_s].evaluateFunction(iplocal_s,lfsu_s.finiteElement().localBasis());
-            const std::vector<RangeType>& phi_n = cache[order_n].evaluateFunction(iplocal_n,lfsu_n.finiteElement().localBasis());
-            const std::vector<RangeType>& psi_s = cache[order_s].evaluateFunction(iplocal_s,lfsv_s.finiteElement().localBasis());
-            const std::vector<RangeType>& psi_n = cache[order_n].evaluateFunction(iplocal_n,lfsv_n.finiteElement().localBasis());
+            const RangeType* phi_s = lfsu_s_basis.evaluateFunction(q);
+            const RangeType* phi_n = lfsu_n_basis.evaluateFunction(q);
+            const RangeType* psi_s = lfsv_s_basis.evaluateFunction(q);
+            const RangeType* psi_n = lfsv_n_basis.evaluateFunction(q);
 #endif
 
             // evaluate u
@@ -394,31 +477,23 @@ namespace Dune {
 
             // evaluate gradient of basis functions (we assume Galerkin method lfsu=lfsv)
 #if USECACHE==0
-            std::vector<JacobianType> gradphi_s(lfsu_s.size());
             lfsu_s.finiteElement().localBasis().evaluateJacobian(iplocal_s,gradphi_s);
-            std::vector<JacobianType> gradphi_n(lfsu_n.size());
             lfsu_n.finiteElement().localBasis().evaluateJacobian(iplocal_n,gradphi_n);
-            std::vector<JacobianType> gradpsi_s(lfsv_s.size());
             lfsv_s.finiteElement().localBasis().evaluateJacobian(iplocal_s,gradpsi_s);
-            std::vector<JacobianType> gradpsi_n(lfsv_n.size());
             lfsv_n.finiteElement().localBasis().evaluateJacobian(iplocal_n,gradpsi_n);
 #else
-            const std::vector<JacobianType>& gradphi_s = cache[order_s].evaluateJacobian(iplocal_s,lfsu_s.finiteElement().localBasis());
-            const std::vector<JacobianType>& gradphi_n = cache[order_n].evaluateJacobian(iplocal_n,lfsu_n.finiteElement().localBasis());
-            const std::vector<JacobianType>& gradpsi_s = cache[order_s].evaluateJacobian(iplocal_s,lfsv_s.finiteElement().localBasis());
-            const std::vector<JacobianType>& gradpsi_n = cache[order_n].evaluateJacobian(iplocal_n,lfsv_n.finiteElement().localBasis());
+            const JacobianType* gradphi_s = lfsu_s_basis.evaluateJacobian(q);
+            const JacobianType* gradphi_n = lfsu_n_basis.evaluateJacobian(q);
+            const JacobianType* gradpsi_s = lfsv_s_basis.evaluateJacobian(q);
+            const JacobianType* gradpsi_n = lfsv_n_basis.evaluateJacobian(q);
 #endif
 
             // transform gradients of shape functions to real element
-            jac = ig.inside()->geometry().jacobianInverseTransposed(iplocal_s);
-            std::vector<Dune::FieldVector<RF,dim> > tgradphi_s(lfsu_s.size());
+            jac = ig.insideJacobianInverseTransposed(iplocal_s);
             for (size_type i=0; i<lfsu_s.size(); i++) jac.mv(gradphi_s[i][0],tgradphi_s[i]);
-            std::vector<Dune::FieldVector<RF,dim> > tgradpsi_s(lfsv_s.size());
             for (size_type i=0; i<lfsv_s.size(); i++) jac.mv(gradpsi_s[i][0],tgradpsi_s[i]);
-            jac = ig.outside()->geometry().jacobianInverseTransposed(iplocal_n);
-            std::vector<Dune::FieldVector<RF,dim> > tgradphi_n(lfsu_n.size());
+            jac = ig.outsideJacobianInverseTransposed(iplocal_n);
             for (size_type i=0; i<lfsu_n.size(); i++) jac.mv(gradphi_n[i][0],tgradphi_n[i]);
-            std::vector<Dune::FieldVector<RF,dim> > tgradpsi_n(lfsv_n.size());
             for (size_type i=0; i<lfsv_n.size(); i++) jac.mv(gradpsi_n[i][0],tgradpsi_n[i]);
 
             // compute gradient of u
@@ -445,7 +520,7 @@ namespace Dune {
               }
 
             // integration factor
-            RF factor = it->weight() * ig.geometry().integrationElement(it->position());
+            RF factor = it->weight() * ig.integrationElement(it->position());
 
             // convection term
             RF term1 = (omegaup_s*u_s + omegaup_n*u_n) * normalflux *factor;
@@ -562,8 +637,26 @@ namespace Dune {
         // penalty factor
         RF penalty_factor = (alpha/h_F) * harmonic_average * degree*(degree+dim-1);
 
+#if USECACHE!=0
+        // values and gradients of the basis functions at all quadrature points
+        const typename Cache::Table& lfsu_s_basis =
+          cache.bind(lfsu_s.finiteElement().localBasis(),rule,ig.geometryInInside(),ig.indexInInside());
+        const typename Cache::Table& lfsu_n_basis =
+          cache.bind(lfsu_n.finiteElement().localBasis(),rule,ig.geometryInOutside(),ig.indexInOutside());
+#else
+        std::vector<RangeType>& phi_s = scratch.get<RangeType>(0,lfsu_s.size(),lfsu_s.maxSize());
+        std::vector<RangeType>& phi_n = scratch.get<RangeType>(1,lfsu_n.size(),lfsu_n.maxSize());
+        std::vector<JacobianType>& gradphi_s = scratch.get<JacobianType>(2,lfsu_s.size(),lfsu_s.maxSize());
+        std::vector<JacobianType>& gradphi_n = scratch.get<JacobianType>(3,lfsu_n.size(),lfsu_n.maxSize());
+#endif
+
+        // temporaries, requested once for all quadrature points
+        std::vector<Dune::FieldVector<RF,dim> >& tgradphi_s = scratch.get<Dune::FieldVector<RF,dim> >(4,lfsu_s.size(),lfsu_s.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& tgradphi_n = scratch.get<Dune::FieldVector<RF,dim> >(5,lfsu_n.size(),lfsu_n.maxSize());
+
         // loop over quadrature points
-        for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
           {
             // exact normal
             const Dune::FieldVector<DF,dim> n_F_local = ig.unitOuterNormal(it->position());
@@ -574,32 +667,26 @@ namespace Dune {
 
             // evaluate basis functions
 #if USECACHE==0
-            std::vector<RangeType> phi_s(lfsu_s.size());
             lfsu_s.finiteElement().localBasis().evaluateFunction(iplocal_s,phi_s);
-            std::vector<RangeType> phi_n(lfsu_n.size());
             lfsu_n.finiteElement().localBasis().evaluateFunction(iplocal_n,phi_n);
 #else
-            const std::vector<RangeType>& phi_s = cache[order_s].evaluateFunction(iplocal_s,lfsu_s.finiteElement().localBasis());
-            const std::vector<RangeType>& phi_n = cache[order_n].evaluateFunction(iplocal_n,lfsu_n.finiteElement().localBasis());
+            const RangeType* phi_s = lfsu_s_basis.evaluateFunction(q);
+            const RangeType* phi_n = lfsu_n_basis.evaluateFunction(q);
 #endif
 
             // evaluate gradient of basis functions (we assume Galerkin method lfsu=lfsv)
 #if USECACHE==0
-            std::vector<JacobianType> gradphi_s(lfsu_s.size());
             lfsu_s.finiteElement().localBasis().evaluateJacobian(iplocal_s,gradphi_s);
-            std::vector<JacobianType> gradphi_n(lfsu_n.size());
             lfsu_n.finiteElement().localBasis().evaluateJacobian(iplocal_n,gradphi_n);
 #else
-            const std::vector<JacobianType>& gradphi_s = cache[order_s].evaluateJacobian(iplocal_s,lfsu_s.finiteElement().localBasis());
-            const std::vector<JacobianType>& gradphi_n = cache[order_n].evaluateJacobian(iplocal_n,lfsu_n.finiteElement().localBasis());
+            const JacobianType* gradphi_s = lfsu_s_basis.evaluateJacobian(q);
+            const JacobianType* gradphi_n = lfsu_n_basis.evaluateJacobian(q);
 #endif
 
             // transform gradients of shape functions to real element
-            jac = ig.inside()->geometry().jacobianInverseTransposed(iplocal_s);
-            std::vector<Dune::FieldVector<RF,dim> > tgradphi_s(lfsu_s.size());
+            jac = ig.insideJacobianInverseTransposed(iplocal_s);
             for (size_type i=0; i<lfsu_s.size(); i++) jac.mv(gradphi_s[i][0],tgradphi_s[i]);
-            jac = ig.outside()->geometry().jacobianInverseTransposed(iplocal_n);
-            std::vector<Dune::FieldVector<RF,dim> > tgradphi_n(lfsu_n.size());
+            jac = ig.outsideJacobianInverseTransposed(iplocal_n);
             for (size_type i=0; i<lfsu_n.size(); i++) jac.mv(gradphi_n[i][0],tgradphi_n[i]);
 
             // evaluate velocity field and upwinding, assume H(div) velocity field => may choose any side
@@ -618,7 +705,7 @@ namespace Dune {
               }
 
             // integration factor
-            RF factor = it->weight() * ig.geometry().integrationElement(it->position());
+            RF factor = it->weight() * ig.integrationElement(it->position());
             RF ipfactor = penalty_factor * factor;
 
             // do all terms in the order: I convection, II diffusion, III consistency, IV ip
@@ -729,8 +816,26 @@ namespace Dune {
         // penalty factor
         RF penalty_factor = (alpha/h_F) * harmonic_average * degree*(degree+dim-1);
 
+#if USECACHE!=0
+        // values and gradients of the basis functions at all quadrature points
+        const typename Cache::Table& lfsu_s_basis =
+          cache.bind(lfsu_s.finiteElement().localBasis(),rule,ig.geometryInInside(),ig.indexInInside());
+        const typename Cache::Table& lfsv_s_basis =
+          cache.bind(lfsv_s.finiteElement().localBasis(),rule,ig.geometryInInside(),ig.indexInInside());
+#else
+        std::vector<RangeType>& phi_s = scratch.get<RangeType>(0,lfsu_s.size(),lfsu_s.maxSize());
+        std::vector<RangeType>& psi_s = scratch.get<RangeType>(1,lfsv_s.size(),lfsv_s.maxSize());
+        std::vector<JacobianType>& gradphi_s = scratch.get<JacobianType>(2,lfsu_s.size(),lfsu_s.maxSize());
+        std::vector<JacobianType>& gradpsi_s = scratch.get<JacobianType>(3,lfsv_s.size(),lfsv_s.maxSize());
+#endif
+
+        // temporaries, requested once for all quadrature points
+        std::vector<Dune::FieldVector<RF,dim> >& tgradphi_s = scratch.get<Dune::FieldVector<RF,dim> >(4,lfsu_s.size(),lfsu_s.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& tgradpsi_s = scratch.get<Dune::FieldVector<RF,dim> >(5,lfsv_s.size(),lfsv_s.maxSize());
+
         // loop over quadrature points
-        for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
           {
             BCType bctype = param.bctype(ig.intersection(),it->position());
 
@@ -742,17 +847,15 @@ namespace Dune {
 
             // evaluate basis functions
 #if USECACHE==0
-            std::vector<RangeType> phi_s(lfsu_s.size());
             lfsu_s.finiteElement().localBasis().evaluateFunction(iplocal_s,phi_s);
-            std::vector<RangeType> psi_s(lfsv_s.size());
             lfsv_s.finiteElement().localBasis().evaluateFunction(iplocal_s,psi_s);
 #else
-            const std::vector<RangeType>& phi_s = cache[order_s].evaluateFunction(iplocal_s,lfsu_s.finiteElement().localBasis());
-            const std::vector<RangeType>& psi_s = cache[order_s].evaluateFunction(iplocal_s,lfsv_s.finiteElement().localBasis());
+            const RangeType* phi_s = lfsu_s_basis.evaluateFunction(q);
+            const RangeType* psi_s = lfsv_s_basis.evaluateFunction(q);
 #endif
 
             // integration factor
-            RF factor = it->weight() * ig.geometry().integrationElement(it->position());
+            RF factor = it->weight() * ig.integrationElement(it->position());
 
             if (bctype == ConvectionDiffusionBoundaryConditions::Neumann)
               {
@@ -801,20 +904,16 @@ namespace Dune {
             // evaluate gradient of basis functions (we assume Galerkin method lfsu=lfsv)
             assert (bctype == ConvectionDiffusionBoundaryConditions::Dirichlet);
 #if USECACHE==0
-            std::vector<JacobianType> gradphi_s(lfsu_s.size());
             lfsu_s.finiteElement().localBasis().evaluateJacobian(iplocal_s,gradphi_s);
-            std::vector<JacobianType> gradpsi_s(lfsv_s.size());
             lfsv_s.finiteElement().localBasis().evaluateJacobian(iplocal_s,gradpsi_s);
 #else
-            const std::vector<JacobianType>& gradphi_s = cache[order_s].evaluateJacobian(iplocal_s,lfsu_s.finiteElement().localBasis());
-            const std::vector<JacobianType>& gradpsi_s = cache[order_s].evaluateJacobian(iplocal_s,lfsv_s.finiteElement().localBasis());
+            const JacobianType* gradphi_s = lfsu_s_basis.evaluateJacobian(q);
+            const JacobianType* gradpsi_s = lfsv_s_basis.evaluateJacobian(q);
 #endif
 
             // transform gradients of shape functions to real element
-            jac = ig.inside()->geometry().jacobianInverseTransposed(iplocal_s);
-            std::vector<Dune::FieldVector<RF,dim> > tgradphi_s(lfsu_s.size());
+            jac = ig.insideJacobianInverseTransposed(iplocal_s);
             for (size_type i=0; i<lfsu_s.size(); i++) jac.mv(gradphi_s[i][0],tgradphi_s[i]);
-            std::vector<Dune::FieldVector<RF,dim> > tgradpsi_s(lfsv_s.size());
             for (size_type i=0; i<lfsv_s.size(); i++) jac.mv(gradpsi_s[i][0],tgradpsi_s[i]);
 
             // compute gradient of u
@@ -929,8 +1028,21 @@ namespace Dune {
         // Neumann boundary makes no contribution to boundary
         //if (bctype == ConvectionDiffusionBoundaryConditions::Neumann) return;
 
+#if USECACHE!=0
+        // values and gradients of the basis functions at all quadrature points
+        const typename Cache::Table& lfsu_s_basis =
+          cache.bind(lfsu_s.finiteElement().localBasis(),rule,ig.geometryInInside(),ig.indexInInside());
+#else
+        std::vector<RangeType>& phi_s = scratch.get<RangeType>(0,lfsu_s.size(),lfsu_s.maxSize());
+        std::vector<JacobianType>& gradphi_s = scratch.get<JacobianType>(1,lfsu_s.size(),lfsu_s.maxSize());
+#endif
+
+        // temporaries, requested once for all quadrature points
+        std::vector<Dune::FieldVector<RF,dim> >& tgradphi_s = scratch.get<Dune::FieldVector<RF,dim> >(2,lfsu_s.size(),lfsu_s.maxSize());
+
         // loop over quadrature points
-        for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
           {
             BCType bctype = param.bctype(ig.intersection(),it->position());
             if (bctype == ConvectionDiffusionBoundaryConditions::Neumann) continue;
@@ -943,14 +1055,13 @@ namespace Dune {
 
             // evaluate basis functions
 #if USECACHE==0
-            std::vector<RangeType> phi_s(lfsu_s.size());
             lfsu_s.finiteElement().localBasis().evaluateFunction(iplocal_s,phi_s);
 #else
-            const std::vector<RangeType>& phi_s = cache[order_s].evaluateFunction(iplocal_s,lfsu_s.finiteElement().localBasis());
+            const RangeType* phi_s = lfsu_s_basis.evaluateFunction(q);
 #endif
 
             // integration factor
-            RF factor = it->weight() * ig.geometry().integrationElement(it->position());
+            RF factor = it->weight() * ig.integrationElement(it->position());
 
             // evaluate velocity field and upwinding, assume H(div) velocity field => choose any side
             typename T::Traits::RangeType b = param.b(*(ig.inside()),iplocal_s);
@@ -974,15 +1085,13 @@ namespace Dune {
 
             // evaluate gradient of basis functions (we assume Galerkin method lfsu=lfsv)
 #if USECACHE==0
-            std::vector<JacobianType> gradphi_s(lfsu_s.size());
             lfsu_s.finiteElement().localBasis().evaluateJacobian(iplocal_s,gradphi_s);
 #else
-            const std::vector<JacobianType>& gradphi_s = cache[order_s].evaluateJacobian(iplocal_s,lfsu_s.finiteElement().localBasis());
+            const JacobianType* gradphi_s = lfsu_s_basis.evaluateJacobian(q);
 #endif
 
             // transform gradients of shape functions to real element
-            jac = ig.inside()->geometry().jacobianInverseTransposed(iplocal_s);
-            std::vector<Dune::FieldVector<RF,dim> > tgradphi_s(lfsu_s.size());
+            jac = ig.insideJacobianInverseTransposed(iplocal_s);
             for (size_type i=0; i<lfsu_s.size(); i++) jac.mv(gradphi_s[i][0],tgradphi_s[i]);
 
             // upwind
@@ -1024,6 +1133,12 @@ namespace Dune {
       template<typename EG, typename LFSV, typename R>
       void lambda_volume (const EG& eg, const LFSV& lfsv, R& r) const
       {
+        if (sumFactorization())
+          {
+            lambda_volume_sumfact(eg,lfsv,r,integral_constant<bool,SumFactorizationTraits::available>());
+            return;
+          }
+
         // domain and range field type
         typedef typename LFSV::Traits::FiniteElementType::
           Traits::LocalBasisType::Traits::DomainFieldType DF;
@@ -1042,15 +1157,22 @@ namespace Dune {
         Dune::GeometryType gt = eg.geometry().type();
         const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,intorder);
 
+#if USECACHE!=0
+        // values and gradients of the basis functions at all quadrature points
+        const typename Cache::Table& lfsv_basis = cache.bind(lfsv.finiteElement().localBasis(),rule);
+#else
+        std::vector<RangeType>& phi = scratch.get<RangeType>(0,lfsv.size(),lfsv.maxSize());
+#endif
+
         // loop over quadrature points
-        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
           {
             // evaluate shape functions
 #if USECACHE==0
-            std::vector<RangeType> phi(lfsv.size());
             lfsv.finiteElement().localBasis().evaluateFunction(it->position(),phi);
 #else
-            const std::vector<RangeType>& phi = cache[order].evaluateFunction(it->position(),lfsv.finiteElement().localBasis());
+            const RangeType* phi = lfsv_basis.evaluateFunction(q);
 #endif
 
             // evaluate right hand side parameter function
@@ -1058,7 +1180,7 @@ namespace Dune {
             f = param.f(eg.entity(),it->position());
 
             // integrate f
-            RF factor = it->weight() * eg.geometry().integrationElement(it->position());
+            RF factor = it->weight() * eg.integrationElement(it->position());
             for (size_type i=0; i<lfsv.size(); i++)
               r.accumulate(lfsv,i,-f*phi[i]*factor);
           }
@@ -1080,18 +1202,282 @@ namespace Dune {
       Real theta;
       typedef typename FiniteElementMap::Traits::FiniteElementType::Traits::LocalBasisType LocalBasisType;
 
-      typedef Dune::PDELab::LocalBasisCache<LocalBasisType> Cache;
+      typedef Dune::PDELab::LocalBasisQuadratureCache<LocalBasisType> Cache;
+
+      // The tables of the cache are keyed by the local basis and the
+      // quadrature rule, so finite elements of different order (p-adaptivity)
+      // or on different geometry types (hybrid meshes) can share one cache.
+      Cache cache;
+
+      typedef QkDGSumFactorizationTraits<FiniteElementMap> SumFactorizationTraits;
+      typedef typename SumFactorizationTraits::Kernel SumFactorizationKernel;
+
+      // set up by setSumFactorization(), null if sum factorization is not used
+      shared_ptr<SumFactorizationKernel> sumfact;
 
-      // In theory it is possible that one and the same local operator is
-      // called first with a finite element of one type and later with a
-      // finite element of another type.  Since finite elements of different
-      // type will usually produce different results for the same local
-      // coordinate they cannot share a cache.  Here we use a vector of caches
-      // to allow for different orders of the shape functions, which should be
-      // enough to support p-adaptivity.  (Another likely candidate would be
-      // differing geometry types, i.e. hybrid meshes.)
+      void makeSumFactorization (integral_constant<bool,true>)
+      {
+        // same quadrature order as the standard evaluation
+        sumfact = make_shared<SumFactorizationKernel>(intorderadd + quadrature_factor * SumFactorizationKernel::degree);
+      }
+
+      void makeSumFactorization (integral_constant<bool,false>)
+      {}
+
+      // volume integral of alpha_volume, evaluated with sum factorization
+      template<typename EG, typename LFSU, typename X, typename LFSV, typename R>
+      void alpha_volume_sumfact (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r,
+                                 integral_constant<bool,true>) const
+      {
+        // domain and range field type
+        typedef typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::DomainFieldType DF;
+        typedef typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeFieldType RF;
+        typedef typename LFSU::Traits::SizeType size_type;
+        typedef typename SumFactorizationKernel::GradientType GradientType;
+
+        // dimensions
+        const int dim = EG::Geometry::dimension;
+        const SumFactorizationKernel& kernel = *sumfact;
 
-      std::vector<Cache> cache;
+        // evaluate diffusion tensor at cell center, assume it is constant over elements
+        typename T::Traits::PermTensorType A;
+        Dune::GeometryType gt = eg.geometry().type();
+        Dune::FieldVector<DF,dim> localcenter = Dune::ReferenceElements<DF,dim>::general(gt).position(0,0);
+        A = param.A(eg.entity(),localcenter);
+
+        // values and reference gradients of u at all quadrature points
+        std::vector<RF>& coefficients = scratch.get<RF>(0,lfsu.size(),lfsu.maxSize());
+        for (size_type i=0; i<lfsu.size(); i++)
+          coefficients[i] = x(lfsu,i);
+        std::vector<RF>& u = scratch.get<RF>(1,kernel.points());
+        std::vector<GradientType>& gradu = scratch.get<GradientType>(0,kernel.points());
+        kernel.evaluate(coefficients.data(),u.data(),gradu.data());
+
+        // transformation
+        typename EG::Geometry::JacobianInverseTransposed jac;
+
+        // replace u and its gradient by the factors of the test functions and their reference gradients
+        for (size_type q=0; q<kernel.points(); q++)
+          {
+            const Dune::FieldVector<DF,dim>& position = kernel.position(q);
+
+            // gradient of u on the real element
+            jac = eg.jacobianInverseTransposed(position);
+            Dune::FieldVector<RF,dim> tgradu(0.0);
+            jac.umv(gradu[q],tgradu);
+
+            // evaluate velocity field and reaction term
+            typename T::Traits::RangeType b = param.b(eg.entity(),position);
+            typename T::Traits::RangeFieldType c = param.c(eg.entity(),position);
+
+            // (A grad u - bu)*grad phi_i + c*u*phi_i
+            RF factor = kernel.weight(q) * eg.integrationElement(position);
+            Dune::FieldVector<RF,dim> flux(0.0);
+            A.umv(tgradu,flux);
+            flux.axpy(-u[q],b);
+            flux *= factor;
+            jac.mtv(flux,gradu[q]);
+            u[q] *= c*factor;
+          }
+
+        // integrate
+        std::vector<RF>& residual = scratch.get<RF>(2,lfsv.size(),lfsv.maxSize());
+        std::fill(residual.begin(),residual.end(),0.0);
+        kernel.integrate(u.data(),gradu.data(),residual.data());
+        for (size_type i=0; i<lfsv.size(); i++)
+          r.accumulate(lfsv,i,residual[i]);
+      }
+
+      template<typename EG, typename LFSU, typename X, typename LFSV, typename R>
+      void alpha_volume_sumfact (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r,
+                                 integral_constant<bool,false>) const
+      {}
+
+      // skeleton integral of alpha_skeleton, evaluated with sum factorization;
+      // returns false if the face points of the two elements do not match
+      template<typename IG, typename LFSU, typename X, typename LFSV, typename R>
+      bool alpha_skeleton_sumfact (const IG& ig,
+                                   const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+                                   const LFSU& lfsu_n, const X& x_n, const LFSV& lfsv_n,
+                                   R& r_s, R& r_n, integral_constant<bool,true>) const
+      {
+        // domain and range field type
+        typedef typename LFSV::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::DomainFieldType DF;
+        typedef typename LFSV::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeFieldType RF;
+        typedef typename LFSV::Traits::SizeType size_type;
+        typedef typename SumFactorizationKernel::GradientType GradientType;
+
+        // dimensions
+        const int dim = IG::dimension;
+        const SumFactorizationKernel& kernel = *sumfact;
+
+        // the face points of the kernel have to be the same points in both elements
+        const int face_s = ig.indexInInside();
+        const int face_n = ig.indexInOutside();
+        if (!kernel.matches(face_s,ig.geometryInInside()) || !kernel.matches(face_n,ig.geometryInOutside()))
+          return false;
+
+        // evaluate permeability tensors
+        const Dune::FieldVector<DF,dim>&
+          inside_local = Dune::ReferenceElements<DF,dim>::general(ig.inside()->type()).position(0,0);
+        const Dune::FieldVector<DF,dim>&
+          outside_local = Dune::ReferenceElements<DF,dim>::general(ig.outside()->type()).position(0,0);
+        typename T::Traits::PermTensorType A_s, A_n;
+        A_s = param.A(*(ig.inside()),inside_local);
+        A_n = param.A(*(ig.outside()),outside_local);
+
+        // face diameter, as in alpha_skeleton
+        RF h_F = std::min(ig.inside()->geometry().volume(),ig.outside()->geometry().volume())/ig.geometry().volume();
+
+        // tensor times normal
+        const Dune::FieldVector<DF,dim> n_F = ig.centerUnitOuterNormal();
+        Dune::FieldVector<RF,dim> An_F_s;
+        A_s.mv(n_F,An_F_s);
+        Dune::FieldVector<RF,dim> An_F_n;
+        A_n.mv(n_F,An_F_n);
+
+        // compute weights
+        RF omega_s;
+        RF omega_n;
+        RF harmonic_average(0.0);
+        if (weights==ConvectionDiffusionDGWeights::weightsOn)
+          {
+            RF delta_s = (An_F_s*n_F);
+            RF delta_n = (An_F_n*n_F);
+            omega_s = delta_n/(delta_s+delta_n+1e-20);
+            omega_n = delta_s/(delta_s+delta_n+1e-20);
+            harmonic_average = 2.0*delta_s*delta_n/(delta_s+delta_n+1e-20);
+          }
+        else
+          {
+            omega_s = omega_n = 0.5;
+            harmonic_average = 1.0;
+          }
+
+        // penalty factor
+        const int degree = std::max(lfsu_s.finiteElement().localBasis().order(),
+                                    lfsu_n.finiteElement().localBasis().order());
+        RF penalty_factor = (alpha/h_F) * harmonic_average * degree*(degree+dim-1);
+
+        // values and reference gradients of u at all face quadrature points
+        std::vector<RF>& coefficients_s = scratch.get<RF>(0,lfsu_s.size(),lfsu_s.maxSize());
+        for (size_type i=0; i<lfsu_s.size(); i++)
+          coefficients_s[i] = x_s(lfsu_s,i);
+        std::vector<RF>& coefficients_n = scratch.get<RF>(1,lfsu_n.size(),lfsu_n.maxSize());
+        for (size_type i=0; i<lfsu_n.size(); i++)
+          coefficients_n[i] = x_n(lfsu_n,i);
+        std::vector<RF>& u_s = scratch.get<RF>(2,kernel.facePoints());
+        std::vector<RF>& u_n = scratch.get<RF>(3,kernel.facePoints());
+        std::vector<GradientType>& gradu_s = scratch.get<GradientType>(0,kernel.facePoints());
+        std::vector<GradientType>& gradu_n = scratch.get<GradientType>(1,kernel.facePoints());
+        kernel.evaluateFace(face_s,coefficients_s.data(),u_s.data(),gradu_s.data());
+        kernel.evaluateFace(face_n,coefficients_n.data(),u_n.data(),gradu_n.data());
+
+        // transformation
+        typename IG::Entity::Geometry::JacobianInverseTransposed jac_s, jac_n;
+
+        // replace u and its gradients by the factors of the test functions and their reference gradients
+        for (size_type q=0; q<kernel.facePoints(); q++)
+          {
+            const Dune::FieldVector<DF,dim-1>& position = kernel.facePosition(q);
+
+            // exact normal
+            const Dune::FieldVector<DF,dim> n_F_local = ig.unitOuterNormal(position);
+
+            // position of quadrature point in local coordinates of elements
+            const Dune::FieldVector<DF,dim>& iplocal_s = kernel.facePosition(face_s,q);
+            const Dune::FieldVector<DF,dim>& iplocal_n = kernel.facePosition(face_n,q);
+
+            // gradients of u on the real elements
+            jac_s = ig.insideJacobianInverseTransposed(iplocal_s);
+            jac_n = ig.outsideJacobianInverseTransposed(iplocal_n);
+            Dune::FieldVector<RF,dim> tgradu_s(0.0);
+            jac_s.umv(gradu_s[q],tgradu_s);
+            Dune::FieldVector<RF,dim> tgradu_n(0.0);
+            jac_n.umv(gradu_n[q],tgradu_n);
+
+            // evaluate velocity field and upwinding, assume H(div) velocity field => may choose any side
+            typename T::Traits::RangeType b = param.b(*(ig.inside()),iplocal_s);
+            RF normalflux = b*n_F_local;
+            RF omegaup_s = (normalflux>=0.0) ? 1.0 : 0.0;
+            RF omegaup_n = 1.0 - omegaup_s;
+
+            // integration factor
+            RF factor = kernel.faceWeight(q) * ig.integrationElement(position);
+
+            // convection, diffusion and penalty terms are tested with the values,
+            // the (non-)symmetric IP term with the gradients
+            RF term1 = (omegaup_s*u_s[q] + omegaup_n*u_n[q]) * normalflux *factor;
+            RF term2 = -(omega_s*(An_F_s*tgradu_s) + omega_n*(An_F_n*tgradu_n)) * factor;
+            RF term3 = (u_s[q]-u_n[q]) * factor;
+            RF term4 = penalty_factor * (u_s[q]-u_n[q]) * factor;
+
+            u_s[q] = term1 + term2 + term4;
+            u_n[q] = -(term1 + term2 + term4);
+            Dune::FieldVector<RF,dim> flux_s(An_F_s);
+            flux_s *= term3 * theta * omega_s;
+            jac_s.mtv(flux_s,gradu_s[q]);
+            Dune::FieldVector<RF,dim> flux_n(An_F_n);
+            flux_n *= term3 * theta * omega_n;
+            jac_n.mtv(flux_n,gradu_n[q]);
+          }
+
+        // integrate
+        std::vector<RF>& residual_s = scratch.get<RF>(4,lfsv_s.size(),lfsv_s.maxSize());
+        std::fill(residual_s.begin(),residual_s.end(),0.0);
+        kernel.integrateFace(face_s,u_s.data(),gradu_s.data(),residual_s.data());
+        for (size_type i=0; i<lfsv_s.size(); i++)
+          r_s.accumulate(lfsv_s,i,residual_s[i]);
+        std::vector<RF>& residual_n = scratch.get<RF>(5,lfsv_n.size(),lfsv_n.maxSize());
+        std::fill(residual_n.begin(),residual_n.end(),0.0);
+        kernel.integrateFace(face_n,u_n.data(),gradu_n.data(),residual_n.data());
+        for (size_type i=0; i<lfsv_n.size(); i++)
+          r_n.accumulate(lfsv_n,i,residual_n[i]);
+
+        return true;
+      }
+
+      template<typename IG, typename LFSU, typename X, typename LFSV, typename R>
+      bool alpha_skeleton_sumfact (const IG& ig,
+                                   const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+                                   const LFSU& lfsu_n, const X& x_n, const LFSV& lfsv_n,
+                                   R& r_s, R& r_n, integral_constant<bool,false>) const
+      {
+        return false;
+      }
+
+      // volume integral of lambda_volume, evaluated with sum factorization
+      template<typename EG, typename LFSV, typename R>
+      void lambda_volume_sumfact (const EG& eg, const LFSV& lfsv, R& r, integral_constant<bool,true>) const
+      {
+        // range field type
+        typedef typename LFSV::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeFieldType RF;
+        typedef typename LFSV::Traits::SizeType size_type;
+
+        const SumFactorizationKernel& kernel = *sumfact;
+
+        // right hand side times quadrature weight at all quadrature points
+        std::vector<RF>& f = scratch.get<RF>(0,kernel.points());
+        for (size_type q=0; q<kernel.points(); q++)
+          f[q] = -param.f(eg.entity(),kernel.position(q))
+            * kernel.weight(q) * eg.integrationElement(kernel.position(q));
+
+        // integrate f
+        std::vector<RF>& residual = scratch.get<RF>(1,lfsv.size(),lfsv.maxSize());
+        std::fill(residual.begin(),residual.end(),0.0);
+        kernel.integrate(f.data(),0,residual.data());
+        for (size_type i=0; i<lfsv.size(); i++)
+          r.accumulate(lfsv,i,residual[i]);
+      }
+
+      template<typename EG, typename LFSV, typename R>
+      void lambda_volume_sumfact (const EG& eg, const LFSV& lfsv, R& r, integral_constant<bool,false>) const
+      {}
 
       template<class GEO>
       void element_size (const GEO& geo, typename GEO::ctype& hmin, typename GEO::ctype hmax) const
@@ -1120,6 +1506,7 @@ namespace Dune {
             return;
           }
       }
+      mutable LocalOperatorScratch scratch;
     };
   }
 }
@@ -15,6 +15,7 @@
 #include<dune/pdelab/localoperator/flags.hh>
 #include<dune/pdelab/localoperator/idefault.hh>
 #include<dune/pdelab/localoperator/defaultimp.hh>
+#include<dune/pdelab/localoperator/scratch.hh>
 #include<dune/pdelab/finiteelement/localbasiscache.hh>
 
 #include"convectiondiffusionparameter.hh"
@@ -54,6 +55,12 @@ namespace Dune {
       enum { doAlphaVolume = true };
       enum { doAlphaBoundary = true };
 
+      // volume terms can be evaluated on batches of cells
+      enum { doAlphaVolumeBatch = true };
+
+      // residual and jacobian of the volume terms can be computed together
+      enum { doAlphaJacobianVolume = true };
+
       ConvectionDiffusionFEM (T& param_, int intorderadd_=0)
         : param(param_), intorderadd(intorderadd_)
       {
@@ -88,13 +95,18 @@ namespace Dune {
         Dune::FieldVector<DF,dim> localcenter = Dune::ReferenceElements<DF,dim>::general(gt).position(0,0);
         tensor = param.A(eg.entity(),localcenter);
 
+        // values and gradients of the basis at all quadrature points
+        const typename Cache::Table& basis = cache.bind(lfsu.finiteElement().localBasis(),rule);
+
+        // temporaries, requested once for all quadrature points
+        std::vector<Dune::FieldVector<RF,dim> >& gradphi = scratch.get<Dune::FieldVector<RF,dim> >(0,lfsu.size(),lfsu.maxSize());
+
         // loop over quadrature points
-        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
           {
             // evaluate basis functions
-            // std::vector<RangeType> phi(lfsu.size());
-            // lfsu.finiteElement().localBasis().evaluateFunction(it->position(),phi);
-            const std::vector<RangeType>& phi = cache.evaluateFunction(it->position(),lfsu.finiteElement().localBasis());
+            const RangeType* phi = basis.evaluateFunction(q);
 
             // evaluate u
             RF u=0.0;
@@ -102,14 +114,11 @@ namespace Dune {
               u += x(lfsu,i)*phi[i];
 
             // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
-            // std::vector<JacobianType> js(lfsu.size());
-            // lfsu.finiteElement().localBasis().evaluateJacobian(it->position(),js);
-            const std::vector<JacobianType>& js = cache.evaluateJacobian(it->position(),lfsu.finiteElement().localBasis());
+            const JacobianType* js = basis.evaluateJacobian(q);
 
             // transform gradients of shape functions to real element
             const typename EG::Geometry::JacobianInverseTransposed jac =
-              eg.geometry().jacobianInverseTransposed(it->position());
-            std::vector<Dune::FieldVector<RF,dim> > gradphi(lfsu.size());
+              eg.jacobianInverseTransposed(it->position());
             for (size_type i=0; i<lfsu.size(); i++)
               jac.mv(js[i][0],gradphi[i]);
 
@@ -128,7 +137,7 @@ namespace Dune {
             typename T::Traits::RangeFieldType f = param.f(eg.entity(),it->position());
 
             // integrate (A grad u)*grad phi_i - u b*grad phi_i + c*u*phi_i
-            RF factor = it->weight() * eg.geometry().integrationElement(it->position());
+            RF factor = it->weight() * eg.integrationElement(it->position());
             for (size_type i=0; i<lfsu.size(); i++)
               r.accumulate(lfsu,i,( Agradu*gradphi[i] - u*(b*gradphi[i]) + (c*u-f)*phi[i] )*factor);
           }
@@ -163,19 +172,23 @@ namespace Dune {
         Dune::FieldVector<DF,dim> localcenter = Dune::ReferenceElements<DF,dim>::general(gt).position(0,0);
         tensor = param.A(eg.entity(),localcenter);
 
+        // values and gradients of the basis at all quadrature points
+        const typename Cache::Table& basis = cache.bind(lfsu.finiteElement().localBasis(),rule);
+
+        // temporaries, requested once for all quadrature points
+        std::vector<Dune::FieldVector<RF,dim> >& gradphi = scratch.get<Dune::FieldVector<RF,dim> >(0,lfsu.size(),lfsu.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& Agradphi = scratch.get<Dune::FieldVector<RF,dim> >(1,lfsu.size(),lfsu.maxSize());
+
         // loop over quadrature points
-        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
           {
             // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
-            // std::vector<JacobianType> js(lfsu.size());
-            // lfsu.finiteElement().localBasis().evaluateJacobian(it->position(),js);
-            const std::vector<JacobianType>& js = cache.evaluateJacobian(it->position(),lfsu.finiteElement().localBasis());
+            const JacobianType* js = basis.evaluateJacobian(q);
 
             // transform gradient to real element
             const typename EG::Geometry::JacobianInverseTransposed jac
-              = eg.geometry().jacobianInverseTransposed(it->position());
-            std::vector<Dune::FieldVector<RF,dim> > gradphi(lfsu.size());
-            std::vector<Dune::FieldVector<RF,dim> > Agradphi(lfsu.size());
+              = eg.jacobianInverseTransposed(it->position());
             for (size_type i=0; i<lfsu.size(); i++)
               {
                 jac.mv(js[i][0],gradphi[i]);
@@ -183,22 +196,337 @@ namespace Dune {
               }
 
             // evaluate basis functions
-            // std::vector<RangeType> phi(lfsu.size());
-            // lfsu.finiteElement().localBasis().evaluateFunction(it->position(),phi);
-            const std::vector<RangeType>& phi = cache.evaluateFunction(it->position(),lfsu.finiteElement().localBasis());
+            const RangeType* phi = basis.evaluateFunction(q);
 
             // evaluate velocity field, sink term and source te
             typename T::Traits::RangeType b = param.b(eg.entity(),it->position());
             typename T::Traits::RangeFieldType c = param.c(eg.entity(),it->position());
 
             // integrate (A grad phi_j)*grad phi_i - phi_j b*grad phi_i + c*phi_j*phi_i
-            RF factor = it->weight() * eg.geometry().integrationElement(it->position());
+            RF factor = it->weight() * eg.integrationElement(it->position());
             for (size_type j=0; j<lfsu.size(); j++)
               for (size_type i=0; i<lfsu.size(); i++)
                 mat.accumulate(lfsu,i,lfsu,j,( Agradphi[j]*gradphi[i]-phi[j]*(b*gradphi[i])+c*phi[j]*phi[i] )*factor);
           }
       }
 
+      // volume integral and its jacobian, sharing the evaluation of the basis and the parameters
+      template<typename EG, typename LFSU, typename X, typename LFSV, typename R, typename M>
+      void alpha_jacobian_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv,
+                                  R& r, M& mat) const
+      {
+        // domain and range field type
+        typedef typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::DomainFieldType DF;
+        typedef typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeFieldType RF;
+        typedef typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::JacobianType JacobianType;
+        typedef typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeType RangeType;
+        typedef typename LFSU::Traits::SizeType size_type;
+
+        // dimensions
+        const int dim = EG::Geometry::dimension;
+
+        // select quadrature rule
+        Dune::GeometryType gt = eg.geometry().type();
+        const int intorder = intorderadd+2*lfsu.finiteElement().localBasis().order();
+        const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,intorder);
+
+        // evaluate diffusion tensor at cell center, assume it is constant over elements
+        typename T::Traits::PermTensorType tensor;
+        Dune::FieldVector<DF,dim> localcenter = Dune::ReferenceElements<DF,dim>::general(gt).position(0,0);
+        tensor = param.A(eg.entity(),localcenter);
+
+        // values and gradients of the basis at all quadrature points
+        const typename Cache::Table& basis = cache.bind(lfsu.finiteElement().localBasis(),rule);
+
+        // temporaries, requested once for all quadrature points
+        std::vector<Dune::FieldVector<RF,dim> >& gradphi = scratch.get<Dune::FieldVector<RF,dim> >(0,lfsu.size(),lfsu.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& Agradphi = scratch.get<Dune::FieldVector<RF,dim> >(1,lfsu.size(),lfsu.maxSize());
+
+        // loop over quadrature points
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
+          {
+            // evaluate basis functions and u
+            const RangeType* phi = basis.evaluateFunction(q);
+            RF u=0.0;
+            for (size_type i=0; i<lfsu.size(); i++)
+              u += x(lfsu,i)*phi[i];
+
+            // transform gradients of shape functions to real element
+            const JacobianType* js = basis.evaluateJacobian(q);
+            const typename EG::Geometry::JacobianInverseTransposed jac =
+              eg.jacobianInverseTransposed(it->position());
+            Dune::FieldVector<RF,dim> Agradu(0.0);
+            for (size_type i=0; i<lfsu.size(); i++)
+              {
+                jac.mv(js[i][0],gradphi[i]);
+                tensor.mv(gradphi[i],Agradphi[i]);
+                // A grad u is the combination of the A grad phi_i
+                Agradu.axpy(x(lfsu,i),Agradphi[i]);
+              }
+
+            // evaluate velocity field, sink term and source term
+            typename T::Traits::RangeType b = param.b(eg.entity(),it->position());
+            typename T::Traits::RangeFieldType c = param.c(eg.entity(),it->position());
+            typename T::Traits::RangeFieldType f = param.f(eg.entity(),it->position());
+
+            RF factor = it->weight() * eg.integrationElement(it->position());
+            for (size_type i=0; i<lfsu.size(); i++)
+              {
+                const RF bgradphi = b*gradphi[i];
+                // integrate (A grad u)*grad phi_i - u b*grad phi_i + c*u*phi_i
+                r.accumulate(lfsu,i,( Agradu*gradphi[i] - u*bgradphi + (c*u-f)*phi[i] )*factor);
+                // integrate (A grad phi_j)*grad phi_i - phi_j b*grad phi_i + c*phi_j*phi_i
+                for (size_type j=0; j<lfsu.size(); j++)
+                  mat.accumulate(lfsu,i,lfsu,j,( Agradphi[j]*gradphi[i]-phi[j]*bgradphi+c*phi[j]*phi[i] )*factor);
+              }
+          }
+      }
+
+      // volume integral on a batch of cells, the cells are processed in the innermost loops
+      template<typename Batch, typename LFSU, typename X, typename LFSV, typename R>
+      void alpha_volume_batch (const Batch& batch, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r) const
+      {
+        // domain and range field type
+        typedef typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::DomainFieldType DF;
+        typedef typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeFieldType RF;
+        typedef typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::JacobianType JacobianType;
+        typedef typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeType RangeType;
+
+        typedef typename LFSU::Traits::SizeType size_type;
+
+        // dimensions and number of cells
+        const int dim = Batch::dimension;
+        const std::size_t N = Batch::lanes;
+        const std::size_t n = batch.size();
+
+        // select quadrature rule
+        Dune::GeometryType gt = batch.type();
+        const int intorder = intorderadd+2*lfsu.finiteElement().localBasis().order();
+        const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,intorder);
+
+        // evaluate diffusion tensors at cell centers, assume they are constant over elements
+        RF A[dim][dim][N];
+        Dune::FieldVector<DF,dim> localcenter = Dune::ReferenceElements<DF,dim>::general(gt).position(0,0);
+        for (std::size_t e=0; e<n; e++)
+          {
+            typename T::Traits::PermTensorType tensor = param.A(batch.element(e),localcenter);
+            for (int k=0; k<dim; k++)
+              for (int l=0; l<dim; l++)
+                A[k][l][e] = tensor[k][l];
+          }
+
+        // values and gradients of the basis at all quadrature points
+        const typename Cache::Table& basis = cache.bind(lfsu.finiteElement().localBasis(),rule);
+
+        // transformed gradients of the shape functions, entry (i,d) of cell e at (i*dim+d)*N+e
+        std::vector<RF>& gradphi = scratch.get<RF>(0,lfsu.size()*dim*N,lfsu.maxSize()*dim*N);
+
+        // loop over quadrature points
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
+          {
+            batch.bind(it->position());
+
+            // evaluate basis functions and their gradients on the reference element
+            const RangeType* phi = basis.evaluateFunction(q);
+            const JacobianType* js = basis.evaluateJacobian(q);
+
+            // transform gradients of shape functions to real elements
+            for (size_type i=0; i<lfsu.size(); i++)
+              for (int d=0; d<dim; d++)
+                {
+                  RF* g = &gradphi[(i*dim+d)*N];
+                  for (std::size_t e=0; e<n; e++)
+                    g[e] = 0.0;
+                  for (int k=0; k<dim; k++)
+                    {
+                      const DF* jit = batch.jacobianInverseTransposed(d,k);
+                      const RF jsk = js[i][0][k];
+                      for (std::size_t e=0; e<n; e++)
+                        g[e] += jit[e]*jsk;
+                    }
+                }
+
+            // evaluate u and its gradient
+            RF u[N];
+            RF gradu[dim][N];
+            for (std::size_t e=0; e<n; e++)
+              {
+                u[e] = 0.0;
+                for (int d=0; d<dim; d++)
+                  gradu[d][e] = 0.0;
+              }
+            for (size_type i=0; i<lfsu.size(); i++)
+              {
+                const typename X::value_type* xi = x(lfsu,i);
+                for (std::size_t e=0; e<n; e++)
+                  u[e] += xi[e]*phi[i];
+                for (int d=0; d<dim; d++)
+                  {
+                    const RF* g = &gradphi[(i*dim+d)*N];
+                    for (std::size_t e=0; e<n; e++)
+                      gradu[d][e] += xi[e]*g[e];
+                  }
+              }
+
+            // compute A * gradient of u
+            RF Agradu[dim][N];
+            for (int d=0; d<dim; d++)
+              for (std::size_t e=0; e<n; e++)
+                {
+                  Agradu[d][e] = 0.0;
+                  for (int k=0; k<dim; k++)
+                    Agradu[d][e] += A[d][k][e]*gradu[k][e];
+                }
+
+            // evaluate velocity field, sink term and source term
+            RF b[dim][N], c[N], f[N], factor[N];
+            const DF* integrationelement = batch.integrationElement();
+            for (std::size_t e=0; e<n; e++)
+              {
+                typename T::Traits::RangeType be = param.b(batch.element(e),it->position());
+                for (int d=0; d<dim; d++)
+                  b[d][e] = be[d];
+                c[e] = param.c(batch.element(e),it->position());
+                f[e] = param.f(batch.element(e),it->position());
+                factor[e] = it->weight() * integrationelement[e];
+              }
+
+            // integrate (A grad u)*grad phi_i - u b*grad phi_i + c*u*phi_i
+            for (size_type i=0; i<lfsv.size(); i++)
+              {
+                typename R::value_type* ri = r(lfsv,i);
+                for (std::size_t e=0; e<n; e++)
+                  {
+                    RF value = (c[e]*u[e]-f[e])*phi[i];
+                    for (int d=0; d<dim; d++)
+                      value += (Agradu[d][e] - u[e]*b[d][e])*gradphi[(i*dim+d)*N+e];
+                    ri[e] += value*factor[e];
+                  }
+              }
+          }
+      }
+
+      // jacobian of volume term on a batch of cells
+      template<typename Batch, typename LFSU, typename X, typename LFSV, typename M>
+      void jacobian_volume_batch (const Batch& batch, const LFSU& lfsu, const X& x, const LFSV& lfsv,
+                                  M& mat) const
+      {
+        // domain and range field type
+        typedef typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::DomainFieldType DF;
+        typedef typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeFieldType RF;
+        typedef typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::JacobianType JacobianType;
+        typedef typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeType RangeType;
+        typedef typename LFSU::Traits::SizeType size_type;
+
+        // dimensions and number of cells
+        const int dim = Batch::dimension;
+        const std::size_t N = Batch::lanes;
+        const std::size_t n = batch.size();
+
+        // select quadrature rule
+        Dune::GeometryType gt = batch.type();
+        const int intorder = intorderadd+2*lfsu.finiteElement().localBasis().order();
+        const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,intorder);
+
+        // evaluate diffusion tensors at cell centers, assume they are constant over elements
+        RF A[dim][dim][N];
+        Dune::FieldVector<DF,dim> localcenter = Dune::ReferenceElements<DF,dim>::general(gt).position(0,0);
+        for (std::size_t e=0; e<n; e++)
+          {
+            typename T::Traits::PermTensorType tensor = param.A(batch.element(e),localcenter);
+            for (int k=0; k<dim; k++)
+              for (int l=0; l<dim; l++)
+                A[k][l][e] = tensor[k][l];
+          }
+
+        // values and gradients of the basis at all quadrature points
+        const typename Cache::Table& basis = cache.bind(lfsu.finiteElement().localBasis(),rule);
+
+        // transformed gradients of the shape functions and their products with A,
+        // entry (i,d) of cell e at (i*dim+d)*N+e
+        std::vector<RF>& gradphi = scratch.get<RF>(0,lfsu.size()*dim*N,lfsu.maxSize()*dim*N);
+        std::vector<RF>& Agradphi = scratch.get<RF>(1,lfsu.size()*dim*N,lfsu.maxSize()*dim*N);
+
+        // loop over quadrature points
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
+          {
+            batch.bind(it->position());
+
+            // evaluate basis functions and their gradients on the reference element
+            const RangeType* phi = basis.evaluateFunction(q);
+            const JacobianType* js = basis.evaluateJacobian(q);
+
+            // transform gradients of shape functions to real elements
+            for (size_type i=0; i<lfsu.size(); i++)
+              {
+                for (int d=0; d<dim; d++)
+                  {
+                    RF* g = &gradphi[(i*dim+d)*N];
+                    for (std::size_t e=0; e<n; e++)
+                      g[e] = 0.0;
+                    for (int k=0; k<dim; k++)
+                      {
+                        const DF* jit = batch.jacobianInverseTransposed(d,k);
+                        const RF jsk = js[i][0][k];
+                        for (std::size_t e=0; e<n; e++)
+                          g[e] += jit[e]*jsk;
+                      }
+                  }
+                for (int d=0; d<dim; d++)
+                  {
+                    RF* Ag = &Agradphi[(i*dim+d)*N];
+                    for (std::size_t e=0; e<n; e++)
+                      {
+                        Ag[e] = 0.0;
+                        for (int k=0; k<dim; k++)
+                          Ag[e] += A[d][k][e]*gradphi[(i*dim+k)*N+e];
+                      }
+                  }
+              }
+
+            // evaluate velocity field and sink term
+            RF b[dim][N], c[N], factor[N];
+            const DF* integrationelement = batch.integrationElement();
+            for (std::size_t e=0; e<n; e++)
+              {
+                typename T::Traits::RangeType be = param.b(batch.element(e),it->position());
+                for (int d=0; d<dim; d++)
+                  b[d][e] = be[d];
+                c[e] = param.c(batch.element(e),it->position());
+                factor[e] = it->weight() * integrationelement[e];
+              }
+
+            // integrate (A grad phi_j)*grad phi_i - phi_j b*grad phi_i + c*phi_j*phi_i
+            for (size_type j=0; j<lfsu.size(); j++)
+              for (size_type i=0; i<lfsv.size(); i++)
+                {
+                  typename M::value_type* mij = mat(lfsv,i,lfsu,j);
+                  for (std::size_t e=0; e<n; e++)
+                    {
+                      RF value = c[e]*phi[j]*phi[i];
+                      for (int d=0; d<dim; d++)
+                        value += (Agradphi[(j*dim+d)*N+e] - phi[j]*b[d][e])*gradphi[(i*dim+d)*N+e];
+                      mij[e] += value*factor[e];
+                    }
+                }
+          }
+      }
+
       // boundary integral
       template<typename IG, typename LFSU, typename X, typename LFSV, typename R>
       void alpha_boundary (const IG& ig,
@@ -231,16 +559,19 @@ namespace Dune {
         const int intorder = intorderadd+2*lfsu_s.finiteElement().localBasis().order();
         const Dune::QuadratureRule<DF,dim-1>& rule = Dune::QuadratureRules<DF,dim-1>::rule(gtface,intorder);
 
+        // values of the basis at all quadrature points
+        const typename Cache::Table& basis =
+          cache.bind(lfsu_s.finiteElement().localBasis(),rule,ig.geometryInInside(),ig.indexInInside());
+
         // loop over quadrature points and integrate normal flux
-        for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
           {
             // position of quadrature point in local coordinates of element
             Dune::FieldVector<DF,dim> local = ig.geometryInInside().global(it->position());
 
             // evaluate shape functions (assume Galerkin method)
-            // std::vector<RangeType> phi(lfsu_s.size());
-            // lfsu_s.finiteElement().localBasis().evaluateFunction(local,phi);
-            const std::vector<RangeType>& phi = cache.evaluateFunction(local,lfsu_s.finiteElement().localBasis());
+            const RangeType* phi = basis.evaluateFunction(q);
 
             if (bctype==ConvectionDiffusionBoundaryConditions::Neumann)
               {
@@ -248,7 +579,7 @@ namespace Dune {
                 typename T::Traits::RangeFieldType j = param.j(ig.intersection(),it->position());
 
                 // integrate j
-                RF factor = it->weight()*ig.geometry().integrationElement(it->position());
+                RF factor = it->weight()*ig.integrationElement(it->position());
                 for (size_type i=0; i<lfsu_s.size(); i++)
                   r_s.accumulate(lfsu_s,i,j*phi[i]*factor);
               }
@@ -268,7 +599,7 @@ namespace Dune {
                 typename T::Traits::RangeFieldType o = param.o(ig.intersection(),it->position());
 
                 // integrate o
-                RF factor = it->weight()*ig.geometry().integrationElement(it->position());
+                RF factor = it->weight()*ig.integrationElement(it->position());
                 for (size_type i=0; i<lfsu_s.size(); i++)
                   r_s.accumulate(lfsu_s,i,( (b*n)*u + o)*phi[i]*factor);
               }
@@ -308,23 +639,26 @@ namespace Dune {
         const int intorder = intorderadd+2*lfsu_s.finiteElement().localBasis().order();
         const Dune::QuadratureRule<DF,dim-1>& rule = Dune::QuadratureRules<DF,dim-1>::rule(gtface,intorder);
 
+        // values of the basis at all quadrature points
+        const typename Cache::Table& basis =
+          cache.bind(lfsu_s.finiteElement().localBasis(),rule,ig.geometryInInside(),ig.indexInInside());
+
         // loop over quadrature points and integrate normal flux
-        for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
           {
             // position of quadrature point in local coordinates of element
             Dune::FieldVector<DF,dim> local = ig.geometryInInside().global(it->position());
 
             // evaluate shape functions (assume Galerkin method)
-            // std::vector<RangeType> phi(lfsu_s.size());
-            // lfsu_s.finiteElement().localBasis().evaluateFunction(local,phi);
-            const std::vector<RangeType>& phi = cache.evaluateFunction(local,lfsu_s.finiteElement().localBasis());
+            const RangeType* phi = basis.evaluateFunction(q);
 
             // evaluate velocity field and outer unit normal
             typename T::Traits::RangeType b = param.b(*(ig.inside()),local);
             const Dune::FieldVector<DF,dim> n = ig.unitOuterNormal(it->position());
 
             // integrate
-            RF factor = it->weight()*ig.geometry().integrationElement(it->position());
+            RF factor = it->weight()*ig.integrationElement(it->position());
             for (size_type j=0; j<lfsu_s.size(); j++)
               for (size_type i=0; i<lfsu_s.size(); i++)
                 mat_s.accumulate(lfsu_s,i,lfsu_s,j,(b*n)*phi[j]*phi[i]*factor);
@@ -342,7 +676,9 @@ namespace Dune {
       T& param;
       int intorderadd;
       typedef typename FiniteElementMap::Traits::FiniteElementType::Traits::LocalBasisType LocalBasisType;
-      Dune::PDELab::LocalBasisCache<LocalBasisType> cache;
+      typedef Dune::PDELab::LocalBasisQuadratureCache<LocalBasisType> Cache;
+      Cache cache;
+      mutable LocalOperatorScratch scratch;
     };
 
 
@@ -407,12 +743,14 @@ namespace Dune {
         Dune::GeometryType gt = eg.geometry().type();
         const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,intorder);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<RangeType>& phi = scratch.get<RangeType>(0,lfsu.size(),lfsu.maxSize());
+
         // loop over quadrature points
         RF sum(0.0);
         for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
             // evaluate basis functions
-            std::vector<RangeType> phi(lfsu.size());
             lfsu.finiteElement().localBasis().evaluateFunction(it->position(),phi);
 
             // evaluate u
@@ -427,7 +765,7 @@ namespace Dune {
             typename T::Traits::RangeFieldType f = param.f(eg.entity(),it->position());
 
             // integrate f^2
-            RF factor = it->weight() * eg.geometry().integrationElement(it->position());
+            RF factor = it->weight() * eg.integrationElement(it->position());
             sum += (f*f-c*c*u*u)*factor;
           }
 
@@ -481,6 +819,12 @@ namespace Dune {
         Dune::FieldVector<RF,dim> An_F_n;
         A_n.mv(n_F,An_F_n);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<JacobianType>& gradphi_s = scratch.get<JacobianType>(0,lfsu_s.size(),lfsu_s.maxSize());
+        std::vector<JacobianType>& gradphi_n = scratch.get<JacobianType>(1,lfsu_n.size(),lfsu_n.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& tgradphi_s = scratch.get<Dune::FieldVector<RF,dim> >(2,lfsu_s.size(),lfsu_s.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& tgradphi_n = scratch.get<Dune::FieldVector<RF,dim> >(3,lfsu_n.size(),lfsu_n.maxSize());
+
         // loop over quadrature points and integrate normal flux
         RF sum(0.0);
         for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
@@ -490,17 +834,13 @@ namespace Dune {
             Dune::FieldVector<DF,dim> iplocal_n = ig.geometryInOutside().global(it->position());
 
             // evaluate gradient of basis functions
-            std::vector<JacobianType> gradphi_s(lfsu_s.size());
             lfsu_s.finiteElement().localBasis().evaluateJacobian(iplocal_s,gradphi_s);
-            std::vector<JacobianType> gradphi_n(lfsu_n.size());
             lfsu_n.finiteElement().localBasis().evaluateJacobian(iplocal_n,gradphi_n);
 
             // transform gradients of shape functions to real element
-            jac = ig.inside()->geometry().jacobianInverseTransposed(iplocal_s);
-            std::vector<Dune::FieldVector<RF,dim> > tgradphi_s(lfsu_s.size());
+            jac = ig.insideJacobianInverseTransposed(iplocal_s);
             for (size_type i=0; i<lfsu_s.size(); i++) jac.mv(gradphi_s[i][0],tgradphi_s[i]);
-            jac = ig.outside()->geometry().jacobianInverseTransposed(iplocal_n);
-            std::vector<Dune::FieldVector<RF,dim> > tgradphi_n(lfsu_n.size());
+            jac = ig.outsideJacobianInverseTransposed(iplocal_n);
             for (size_type i=0; i<lfsu_n.size(); i++) jac.mv(gradphi_n[i][0],tgradphi_n[i]);
 
             // compute gradient of u
@@ -512,7 +852,7 @@ namespace Dune {
               gradu_n.axpy(x_n(lfsu_n,i),tgradphi_n[i]);
 
             // integrate
-            RF factor = it->weight() * ig.geometry().integrationElement(it->position());
+            RF factor = it->weight() * ig.integrationElement(it->position());
             RF jump = (An_F_s*gradu_s)-(An_F_n*gradu_n);
             sum += 0.25*jump*jump*factor;
           }
@@ -568,6 +908,10 @@ namespace Dune {
         if (bctype != ConvectionDiffusionBoundaryConditions::Neumann)
           return;
 
+        // temporaries, requested once for all quadrature points
+        std::vector<JacobianType>& gradphi_s = scratch.get<JacobianType>(0,lfsu_s.size(),lfsu_s.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& tgradphi_s = scratch.get<Dune::FieldVector<RF,dim> >(1,lfsu_s.size(),lfsu_s.maxSize());
+
         // loop over quadrature points and integrate normal flux
         RF sum(0.0);
         for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
@@ -576,12 +920,10 @@ namespace Dune {
             Dune::FieldVector<DF,dim> iplocal_s = ig.geometryInInside().global(it->position());
 
             // evaluate gradient of basis functions
-            std::vector<JacobianType> gradphi_s(lfsu_s.size());
             lfsu_s.finiteElement().localBasis().evaluateJacobian(iplocal_s,gradphi_s);
 
             // transform gradients of shape functions to real element
-            jac = ig.inside()->geometry().jacobianInverseTransposed(iplocal_s);
-            std::vector<Dune::FieldVector<RF,dim> > tgradphi_s(lfsu_s.size());
+            jac = ig.insideJacobianInverseTransposed(iplocal_s);
             for (size_type i=0; i<lfsu_s.size(); i++) jac.mv(gradphi_s[i][0],tgradphi_s[i]);
 
             // compute gradient of u
@@ -593,7 +935,7 @@ namespace Dune {
             RF j = param.j(ig.intersection(),it->position());
 
             // integrate
-            RF factor = it->weight() * ig.geometry().integrationElement(it->position());
+            RF factor = it->weight() * ig.integrationElement(it->position());
             RF jump = j+(An_F_s*gradu_s);
             sum += jump*jump*factor;
           }
@@ -626,6 +968,7 @@ namespace Dune {
         return hmax;
       }
 
+      mutable LocalOperatorScratch scratch;
     };
 
 
@@ -689,6 +1032,9 @@ namespace Dune {
         Dune::GeometryType gt = eg.geometry().type();
         const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,intorder);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<RangeType>& phi = scratch.get<RangeType>(0,lfsu.size(),lfsu.maxSize());
+
         // loop over quadrature points
         RF sum(0.0);
         RF fsum_up(0.0);
@@ -697,7 +1043,6 @@ namespace Dune {
         for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
             // evaluate basis functions
-            std::vector<RangeType> phi(lfsu.size());
             lfsu.finiteElement().localBasis().evaluateFunction(it->position(),phi);
 
             // evaluate u
@@ -706,7 +1051,7 @@ namespace Dune {
               u += x(lfsu,i)*phi[i];
 
             // integrate f^2
-            RF factor = it->weight() * eg.geometry().integrationElement(it->position());
+            RF factor = it->weight() * eg.integrationElement(it->position());
             sum += u*u*factor;
 
             // evaluate right hand side parameter function
@@ -765,6 +1110,7 @@ namespace Dune {
         return hmax;
       }
 
+      mutable LocalOperatorScratch scratch;
     };
 
     // a functor that can be used to evaluate rhs parameter function in interpolate
@@ -859,6 +1205,11 @@ namespace Dune {
         param.setTime(time+dt);
         lfsu.finiteElement().localInterpolation().interpolate(f_adapter,f_up);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<RangeType>& phi = scratch.get<RangeType>(0,lfsu.size(),lfsu.maxSize());
+        std::vector<JacobianType>& js = scratch.get<JacobianType>(1,lfsu.size(),lfsu.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& gradphi = scratch.get<Dune::FieldVector<RF,dim> >(2,lfsu.size(),lfsu.maxSize());
+
         // loop over quadrature points
         RF sum(0.0);
         RF sum_grad(0.0);
@@ -868,7 +1219,6 @@ namespace Dune {
         for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
             // evaluate basis functions
-            std::vector<RangeType> phi(lfsu.size());
             lfsu.finiteElement().localBasis().evaluateFunction(it->position(),phi);
 
             // evaluate u
@@ -877,17 +1227,15 @@ namespace Dune {
               u += x(lfsu,i)*phi[i];
 
             // integrate jump
-            RF factor = it->weight() * eg.geometry().integrationElement(it->position());
+            RF factor = it->weight() * eg.integrationElement(it->position());
             sum += u*u*factor;
 
             // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
-            std::vector<JacobianType> js(lfsu.size());
             lfsu.finiteElement().localBasis().evaluateJacobian(it->position(),js);
 
             // transform gradients of shape functions to real element
             const typename EG::Geometry::JacobianInverseTransposed jac =
-              eg.geometry().jacobianInverseTransposed(it->position());
-            std::vector<Dune::FieldVector<RF,dim> > gradphi(lfsu.size());
+              eg.jacobianInverseTransposed(it->position());
             for (size_type i=0; i<lfsu.size(); i++)
               jac.mv(js[i][0],gradphi[i]);
 
@@ -967,7 +1315,7 @@ namespace Dune {
             RF j_up = param.j(ig.intersection(),it->position());
 
             // integrate
-            RF factor = it->weight() * ig.geometry().integrationElement(it->position());
+            RF factor = it->weight() * ig.integrationElement(it->position());
             sum_down += (j_down-j_mid)*(j_down-j_mid)*factor;
             sum_up += (j_up-j_mid)*(j_up-j_mid)*factor;
           }
@@ -1002,6 +1350,7 @@ namespace Dune {
         return hmax;
       }
 
+      mutable LocalOperatorScratch scratch;
     };
 
 
@@ -3,9 +3,11 @@
 #ifndef DUNE_PDELAB_LOCALOPERATOR_DEFAULTIMP_HH
 #define DUNE_PDELAB_LOCALOPERATOR_DEFAULTIMP_HH
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
+#include <dune/pdelab/common/dualnumber.hh>
 #include <dune/pdelab/gridfunctionspace/localvector.hh>
 #include <dune/pdelab/gridoperator/common/localmatrix.hh>
 
@@ -305,6 +307,289 @@ namespace Dune {
       const Imp& asImp () const { return static_cast<const Imp &>(*this); }
     };
 
+    ////////////////////////////////////////////////////////////////////////
+    //
+    //  Implementation of jacobian_*() in terms of alpha_*() by automatic
+    //  differentiation
+    //
+
+    namespace impl {
+
+      //! The local coefficient vector X with its entries replaced by dual numbers.
+      template<typename X, typename Dual>
+      struct DualCoefficientVector;
+
+      template<typename T, typename Tag, typename W, typename Dual>
+      struct DualCoefficientVector<LocalVector<T,Tag,W>,Dual>
+      {
+        typedef LocalVector<Dual,Tag,W> type;
+      };
+
+      //! Copies x into u and turns the coefficients begin,...,end-1 of lfs into the
+      //! independent variables 0,...,end-begin-1, all other coefficients into constants.
+      template<typename LFS, typename X, typename U>
+      void seedDualCoefficients(const LFS& lfs, const X& x, U& u, int begin, int end)
+      {
+        typedef typename U::value_type Dual;
+        for (std::size_t k = 0; k < x.size(); ++k)
+          u.base()[k] = Dual(x.base()[k]);
+        for (int j = std::max(begin,0); j < std::min(end,int(lfs.size())); ++j)
+          u(lfs,j).derivative(j-begin) = 1;
+      }
+
+    } // namespace impl
+
+    //! Implement jacobian_volume() based on alpha_volume() by automatic differentiation
+    /**
+     * Derive from this class to add an exact jacobian for volume.  The
+     * derived class needs to implement alpha_volume() for arbitrary
+     * coefficient vectors X, using <tt>typename X::value_type</tt> for all
+     * quantities depending on the coefficients.
+     *
+     * Instead of perturbing the n coefficients one at a time like
+     * NumericalJacobianVolume, alpha_volume() is evaluated with coefficients
+     * of type DualNumber, which carry the derivatives with respect to
+     * blockSize coefficients at once, so the jacobian is obtained from
+     * ceil(n/blockSize) evaluations and does not suffer from the truncation
+     * error of finite differences.  Elementary functions have to be called
+     * unqualified in alpha_volume() to be found for DualNumber (see there).
+     *
+     * \tparam Imp       Type of the derived class (CRTP-trick).
+     * \tparam blockSize Number of derivatives carried by each coefficient,
+     *                   ideally the number of local coefficients.
+     */
+    template<typename Imp, int blockSize = 8>
+    class AutomaticJacobianVolume
+    {
+    public:
+      //! compute local jacobian of the volume term
+      template<typename EG, typename LFSU, typename X, typename LFSV,
+               typename Jacobian>
+      void jacobian_volume
+      ( const EG& eg,
+        const LFSU& lfsu, const X& x, const LFSV& lfsv,
+        Jacobian& mat) const
+      {
+        typedef typename Jacobian::value_type R;
+        typedef DualNumber<R,blockSize> Dual;
+        typedef typename impl::DualCoefficientVector<X,Dual>::type DualX;
+        typedef LocalVector<Dual,TestSpaceTag,typename Jacobian::weight_type> ResidualVector;
+        typedef typename ResidualVector::WeightedAccumulationView ResidualView;
+
+        const int m=lfsv.size();
+        const int n=lfsu.size();
+
+        DualX u(x.size());
+
+        // Notice that in general lfsv.size() != mat.nrows()
+        ResidualVector r(mat.nrows());
+        ResidualView rview = r.weightedAccumulationView(mat.weight());
+
+        for (int begin=0; begin<n; begin+=blockSize) // loop over blocks of columns
+        {
+          const int end = std::min(begin+blockSize,n);
+          impl::seedDualCoefficients(lfsu,x,u,begin,end);
+          r = Dual(0.0);
+          asImp().alpha_volume(eg,lfsu,u,lfsv,rview);
+          for (int i=0; i<m; i++)
+            for (int j=begin; j<end; j++)
+              mat.rawAccumulate(lfsv,i,lfsu,j,r(lfsv,i).derivative(j-begin));
+        }
+      }
+
+    private:
+      Imp& asImp () { return static_cast<Imp &> (*this); }
+      const Imp& asImp () const { return static_cast<const Imp &>(*this); }
+    };
+
+    //! Implement jacobian_volume_post_skeleton() based on alpha_volume_post_skeleton() by automatic differentiation
+    /**
+     * Derive from this class to add an exact jacobian for the volume term
+     * assembled after the skeleton terms.  The derived class needs to
+     * implement alpha_volume_post_skeleton() for arbitrary coefficient
+     * vectors X, see AutomaticJacobianVolume.
+     *
+     * \tparam Imp       Type of the derived class (CRTP-trick).
+     * \tparam blockSize Number of derivatives carried by each coefficient,
+     *                   ideally the number of local coefficients.
+     */
+    template<typename Imp, int blockSize = 8>
+    class AutomaticJacobianVolumePostSkeleton
+    {
+    public:
+      //! compute local post-skeleton jacobian of the volume term
+      template<typename EG, typename LFSU, typename X, typename LFSV,
+               typename Jacobian>
+      void jacobian_volume_post_skeleton
+      ( const EG& eg,
+        const LFSU& lfsu, const X& x, const LFSV& lfsv,
+        Jacobian& mat) const
+      {
+        typedef typename Jacobian::value_type R;
+        typedef DualNumber<R,blockSize> Dual;
+        typedef typename impl::DualCoefficientVector<X,Dual>::type DualX;
+        typedef LocalVector<Dual,TestSpaceTag,typename Jacobian::weight_type> ResidualVector;
+        typedef typename ResidualVector::WeightedAccumulationView ResidualView;
+
+        const int m=lfsv.size();
+        const int n=lfsu.size();
+
+        DualX u(x.size());
+
+        // Notice that in general lfsv.size() != mat.nrows()
+        ResidualVector r(mat.nrows());
+        ResidualView rview = r.weightedAccumulationView(mat.weight());
+
+        for (int begin=0; begin<n; begin+=blockSize) // loop over blocks of columns
+        {
+          const int end = std::min(begin+blockSize,n);
+          impl::seedDualCoefficients(lfsu,x,u,begin,end);
+          r = Dual(0.0);
+          asImp().alpha_volume_post_skeleton(eg,lfsu,u,lfsv,rview);
+          for (int i=0; i<m; i++)
+            for (int j=begin; j<end; j++)
+              mat.rawAccumulate(lfsv,i,lfsu,j,r(lfsv,i).derivative(j-begin));
+        }
+      }
+
+    private:
+      Imp& asImp () { return static_cast<Imp &> (*this); }
+      const Imp& asImp () const { return static_cast<const Imp &>(*this); }
+    };
+
+    //! Implement jacobian_skeleton() based on alpha_skeleton() by automatic differentiation
+    /**
+     * Derive from this class to add an exact jacobian for skeleton.  The
+     * derived class needs to implement alpha_skeleton() for arbitrary
+     * coefficient vectors X, see AutomaticJacobianVolume.  The coefficients
+     * of both cells are differentiated together, so all four blocks of the
+     * jacobian are obtained from ceil((n_s+n_n)/blockSize) evaluations.
+     *
+     * \tparam Imp       Type of the derived class (CRTP-trick).
+     * \tparam blockSize Number of derivatives carried by each coefficient,
+     *                   ideally the number of coefficients of both cells.
+     */
+    template<typename Imp, int blockSize = 8>
+    class AutomaticJacobianSkeleton
+    {
+    public:
+      //! compute local jacobian of the skeleton term
+      template<typename IG, typename LFSU, typename X, typename LFSV,
+               typename Jacobian>
+      void jacobian_skeleton
+      ( const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+        const LFSU& lfsu_n, const X& x_n, const LFSV& lfsv_n,
+        Jacobian& mat_ss, Jacobian& mat_sn,
+        Jacobian& mat_ns, Jacobian& mat_nn) const
+      {
+        typedef typename Jacobian::value_type R;
+        typedef DualNumber<R,blockSize> Dual;
+        typedef typename impl::DualCoefficientVector<X,Dual>::type DualX;
+        typedef LocalVector<Dual,TestSpaceTag,typename Jacobian::weight_type> ResidualVector;
+        typedef typename ResidualVector::WeightedAccumulationView ResidualView;
+
+        const int m_s=lfsv_s.size();
+        const int m_n=lfsv_n.size();
+        const int n_s=lfsu_s.size();
+        const int n_n=lfsu_n.size();
+
+        DualX u_s(x_s.size());
+        DualX u_n(x_n.size());
+
+        // Notice that in general lfsv.size() != mat.nrows()
+        ResidualVector r_s(mat_ss.nrows());
+        ResidualView rview_s = r_s.weightedAccumulationView(1.0);
+
+        ResidualVector r_n(mat_nn.nrows());
+        ResidualView rview_n = r_n.weightedAccumulationView(1.0);
+
+        // the columns of self are numbered first, followed by those of neighbor
+        for (int begin=0; begin<n_s+n_n; begin+=blockSize)
+        {
+          const int end = std::min(begin+blockSize,n_s+n_n);
+          impl::seedDualCoefficients(lfsu_s,x_s,u_s,begin,end);
+          impl::seedDualCoefficients(lfsu_n,x_n,u_n,begin-n_s,end-n_s);
+          r_s = Dual(0.0);
+          r_n = Dual(0.0);
+          asImp().alpha_skeleton(ig,lfsu_s,u_s,lfsv_s,lfsu_n,u_n,lfsv_n,rview_s,
+                                 rview_n);
+          for (int j=begin; j<std::min(end,n_s); j++)
+          {
+            for (int i=0; i<m_s; i++)
+              mat_ss.accumulate(lfsv_s,i,lfsu_s,j,r_s(lfsv_s,i).derivative(j-begin));
+            for (int i=0; i<m_n; i++)
+              mat_ns.accumulate(lfsv_n,i,lfsu_s,j,r_n(lfsv_n,i).derivative(j-begin));
+          }
+          for (int j=std::max(begin,n_s); j<end; j++)
+          {
+            for (int i=0; i<m_s; i++)
+              mat_sn.accumulate(lfsv_s,i,lfsu_n,j-n_s,r_s(lfsv_s,i).derivative(j-begin));
+            for (int i=0; i<m_n; i++)
+              mat_nn.accumulate(lfsv_n,i,lfsu_n,j-n_s,r_n(lfsv_n,i).derivative(j-begin));
+          }
+        }
+      }
+
+    private:
+      Imp& asImp () { return static_cast<Imp &> (*this); }
+      const Imp& asImp () const { return static_cast<const Imp &>(*this); }
+    };
+
+    //! Implement jacobian_boundary() based on alpha_boundary() by automatic differentiation
+    /**
+     * Derive from this class to add an exact jacobian for boundary.  The
+     * derived class needs to implement alpha_boundary() for arbitrary
+     * coefficient vectors X, see AutomaticJacobianVolume.
+     *
+     * \tparam Imp       Type of the derived class (CRTP-trick).
+     * \tparam blockSize Number of derivatives carried by each coefficient,
+     *                   ideally the number of local coefficients.
+     */
+    template<typename Imp, int blockSize = 8>
+    class AutomaticJacobianBoundary
+    {
+    public:
+      //! compute local jacobian of the boundary term
+      template<typename IG, typename LFSU, typename X, typename LFSV,
+               typename Jacobian>
+      void jacobian_boundary
+      ( const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+        Jacobian& mat_ss) const
+      {
+        typedef typename Jacobian::value_type R;
+        typedef DualNumber<R,blockSize> Dual;
+        typedef typename impl::DualCoefficientVector<X,Dual>::type DualX;
+        typedef LocalVector<Dual,TestSpaceTag,typename Jacobian::weight_type> ResidualVector;
+        typedef typename ResidualVector::WeightedAccumulationView ResidualView;
+
+        const int m_s=lfsv_s.size();
+        const int n_s=lfsu_s.size();
+
+        DualX u_s(x_s.size());
+
+        // Notice that in general lfsv.size() != mat.nrows()
+        ResidualVector r_s(mat_ss.nrows());
+        ResidualView rview_s = r_s.weightedAccumulationView(mat_ss.weight());
+
+        for (int begin=0; begin<n_s; begin+=blockSize)
+        {
+          const int end = std::min(begin+blockSize,n_s);
+          impl::seedDualCoefficients(lfsu_s,x_s,u_s,begin,end);
+          r_s = Dual(0.0);
+          asImp().alpha_boundary(ig,lfsu_s,u_s,lfsv_s,rview_s);
+          for (int i=0; i<m_s; i++)
+            for (int j=begin; j<end; j++)
+              mat_ss.rawAccumulate(lfsv_s,i,lfsu_s,j,r_s(lfsv_s,i).derivative(j-begin));
+        }
+      }
+
+    private:
+      Imp& asImp () { return static_cast<Imp &> (*this); }
+      const Imp& asImp () const { return static_cast<const Imp &>(*this); }
+    };
+
     ////////////////////////////////////////////////////////////////////////
     //
     //  Numerical implementation of jacobian_apply_*() in terms of alpha_*()
@@ -365,6 +650,53 @@ namespace Dune {
         }
       }
 
+      //! apply local jacobian of the volume term at the linearization point x to the direction z
+      /**
+       * The jacobian is approximated by a single directional difference
+       * of alpha_volume() instead of the column-wise differences used
+       * by the linear variant.
+       */
+      template<typename EG, typename LFSU, typename X, typename Z, typename LFSV,
+               typename Y>
+      void jacobian_apply_volume
+      ( const EG& eg,
+        const LFSU& lfsu, const X& x, const Z& z, const LFSV& lfsv,
+        Y& y) const
+      {
+        typedef typename X::value_type D;
+        typedef typename Y::value_type R;
+        typedef LocalVector<R,TestSpaceTag,typename Y::weight_type> ResidualVector;
+        typedef typename ResidualVector::WeightedAccumulationView ResidualView;
+
+        const int m=lfsv.size();
+        const int n=lfsu.size();
+
+        // scale the increment with the magnitude of x and z
+        D x_norm = 0.0, z_norm = 0.0;
+        for (int j=0; j<n; j++)
+        {
+          x_norm = std::max(x_norm,D(std::abs(x(lfsu,j))));
+          z_norm = std::max(z_norm,D(std::abs(z(lfsu,j))));
+        }
+        if (z_norm == 0.0)
+          return;
+        const D delta = epsilon*(1.0+x_norm)/z_norm;
+
+        X u(x);
+        for (int j=0; j<n; j++)
+          u(lfsu,j) += delta*z(lfsu,j);
+
+        // Notice that in general lfsv.size() != y.size()
+        ResidualVector down(y.size()),up(y.size());
+        ResidualView downview = down.weightedAccumulationView(y.weight());
+        ResidualView upview = up.weightedAccumulationView(y.weight());
+
+        asImp().alpha_volume(eg,lfsu,x,lfsv,downview);
+        asImp().alpha_volume(eg,lfsu,u,lfsv,upview);
+        for (int i=0; i<m; i++)
+          y.rawAccumulate(lfsv,i,(up(lfsv,i)-down(lfsv,i))/delta);
+      }
+
     private:
       const double epsilon; // problem: this depends on data type R!
       Imp& asImp () { return static_cast<Imp &> (*this); }
@@ -428,6 +760,53 @@ namespace Dune {
         }
       }
 
+      //! apply local jacobian of the volume term (post skeleton part) at the linearization point x to the direction z
+      /**
+       * The jacobian is approximated by a single directional difference
+       * of alpha_volume_post_skeleton() instead of the column-wise differences used
+       * by the linear variant.
+       */
+      template<typename EG, typename LFSU, typename X, typename Z, typename LFSV,
+               typename Y>
+      void jacobian_apply_volume_post_skeleton
+      ( const EG& eg,
+        const LFSU& lfsu, const X& x, const Z& z, const LFSV& lfsv,
+        Y& y) const
+      {
+        typedef typename X::value_type D;
+        typedef typename Y::value_type R;
+        typedef LocalVector<R,TestSpaceTag,typename Y::weight_type> ResidualVector;
+        typedef typename ResidualVector::WeightedAccumulationView ResidualView;
+
+        const int m=lfsv.size();
+        const int n=lfsu.size();
+
+        // scale the increment with the magnitude of x and z
+        D x_norm = 0.0, z_norm = 0.0;
+        for (int j=0; j<n; j++)
+        {
+          x_norm = std::max(x_norm,D(std::abs(x(lfsu,j))));
+          z_norm = std::max(z_norm,D(std::abs(z(lfsu,j))));
+        }
+        if (z_norm == 0.0)
+          return;
+        const D delta = epsilon*(1.0+x_norm)/z_norm;
+
+        X u(x);
+        for (int j=0; j<n; j++)
+          u(lfsu,j) += delta*z(lfsu,j);
+
+        // Notice that in general lfsv.size() != y.size()
+        ResidualVector down(y.size()),up(y.size());
+        ResidualView downview = down.weightedAccumulationView(y.weight());
+        ResidualView upview = up.weightedAccumulationView(y.weight());
+
+        asImp().alpha_volume_post_skeleton(eg,lfsu,x,lfsv,downview);
+        asImp().alpha_volume_post_skeleton(eg,lfsu,u,lfsv,upview);
+        for (int i=0; i<m; i++)
+          y.rawAccumulate(lfsv,i,(up(lfsv,i)-down(lfsv,i))/delta);
+      }
+
     private:
       const double epsilon; // problem: this depends on data type R!
       Imp& asImp () {return static_cast<Imp &> (*this);}
@@ -521,6 +900,72 @@ namespace Dune {
         }
       }
 
+      //! apply local jacobian of the skeleton term at the linearization point x to the direction z
+      /**
+       * The jacobian is approximated by a single directional difference
+       * of alpha_skeleton() instead of the column-wise differences used
+       * by the linear variant.
+       */
+      template<typename IG, typename LFSU, typename X, typename Z, typename LFSV,
+               typename Y>
+      void jacobian_apply_skeleton
+      ( const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const Z& z_s, const LFSV& lfsv_s,
+        const LFSU& lfsu_n, const X& x_n, const Z& z_n, const LFSV& lfsv_n,
+        Y& y_s, Y& y_n) const
+      {
+        typedef typename X::value_type D;
+        typedef typename Y::value_type R;
+        typedef LocalVector<R,TestSpaceTag,typename Y::weight_type> ResidualVector;
+        typedef typename ResidualVector::WeightedAccumulationView ResidualView;
+
+        const int m_s=lfsv_s.size();
+        const int m_n=lfsv_n.size();
+        const int n_s=lfsu_s.size();
+        const int n_n=lfsu_n.size();
+
+        // scale the increment with the magnitude of x and z on both sides
+        D x_norm = 0.0, z_norm = 0.0;
+        for (int j=0; j<n_s; j++)
+        {
+          x_norm = std::max(x_norm,D(std::abs(x_s(lfsu_s,j))));
+          z_norm = std::max(z_norm,D(std::abs(z_s(lfsu_s,j))));
+        }
+        for (int j=0; j<n_n; j++)
+        {
+          x_norm = std::max(x_norm,D(std::abs(x_n(lfsu_n,j))));
+          z_norm = std::max(z_norm,D(std::abs(z_n(lfsu_n,j))));
+        }
+        if (z_norm == 0.0)
+          return;
+        const D delta = epsilon*(1.0+x_norm)/z_norm;
+
+        X u_s(x_s);
+        X u_n(x_n);
+        for (int j=0; j<n_s; j++)
+          u_s(lfsu_s,j) += delta*z_s(lfsu_s,j);
+        for (int j=0; j<n_n; j++)
+          u_n(lfsu_n,j) += delta*z_n(lfsu_n,j);
+
+        // Notice that in general lfsv_s.size() != y_s.size()
+        ResidualVector down_s(y_s.size()),up_s(y_s.size());
+        ResidualView downview_s = down_s.weightedAccumulationView(1.0);
+        ResidualView upview_s = up_s.weightedAccumulationView(1.0);
+
+        ResidualVector down_n(y_n.size()),up_n(y_n.size());
+        ResidualView downview_n = down_n.weightedAccumulationView(1.0);
+        ResidualView upview_n = up_n.weightedAccumulationView(1.0);
+
+        asImp().alpha_skeleton(ig,lfsu_s,x_s,lfsv_s,lfsu_n,x_n,lfsv_n,downview_s,
+                               downview_n);
+        asImp().alpha_skeleton(ig,lfsu_s,u_s,lfsv_s,lfsu_n,u_n,lfsv_n,upview_s,
+                               upview_n);
+        for (int i=0; i<m_s; i++)
+          y_s.accumulate(lfsv_s,i,(up_s(lfsv_s,i)-down_s(lfsv_s,i))/delta);
+        for (int i=0; i<m_n; i++)
+          y_n.accumulate(lfsv_n,i,(up_n(lfsv_n,i)-down_n(lfsv_n,i))/delta);
+      }
+
     private:
       const double epsilon; // problem: this depends on data type R!
       Imp& asImp () { return static_cast<Imp &> (*this); }
@@ -585,6 +1030,53 @@ namespace Dune {
         }
       }
 
+      //! apply local jacobian of the boundary term at the linearization point x to the direction z
+      /**
+       * The jacobian is approximated by a single directional difference
+       * of alpha_boundary() instead of the column-wise differences used
+       * by the linear variant.
+       */
+      template<typename IG, typename LFSU, typename X, typename Z, typename LFSV,
+               typename Y>
+      void jacobian_apply_boundary
+      ( const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const Z& z_s, const LFSV& lfsv_s,
+        Y& y_s) const
+      {
+        typedef typename X::value_type D;
+        typedef typename Y::value_type R;
+        typedef LocalVector<R,TestSpaceTag,typename Y::weight_type> ResidualVector;
+        typedef typename ResidualVector::WeightedAccumulationView ResidualView;
+
+        const int m_s=lfsv_s.size();
+        const int n_s=lfsu_s.size();
+
+        // scale the increment with the magnitude of x and z
+        D x_norm = 0.0, z_norm = 0.0;
+        for (int j=0; j<n_s; j++)
+        {
+          x_norm = std::max(x_norm,D(std::abs(x_s(lfsu_s,j))));
+          z_norm = std::max(z_norm,D(std::abs(z_s(lfsu_s,j))));
+        }
+        if (z_norm == 0.0)
+          return;
+        const D delta = epsilon*(1.0+x_norm)/z_norm;
+
+        X u_s(x_s);
+        for (int j=0; j<n_s; j++)
+          u_s(lfsu_s,j) += delta*z_s(lfsu_s,j);
+
+        // Notice that in general lfsv_s.size() != y_s.size()
+        ResidualVector down_s(y_s.size()),up_s(y_s.size());
+        ResidualView downview_s = down_s.weightedAccumulationView(1.0);
+        ResidualView upview_s = up_s.weightedAccumulationView(1.0);
+
+        asImp().alpha_boundary(ig,lfsu_s,x_s,lfsv_s,downview_s);
+        asImp().alpha_boundary(ig,lfsu_s,u_s,lfsv_s,upview_s);
+        for (int i=0; i<m_s; i++)
+          y_s.accumulate(lfsv_s,i,(up_s(lfsv_s,i)-down_s(lfsv_s,i))/delta);
+      }
+
     private:
       const double epsilon; // problem: this depends on data type R!
       Imp& asImp () { return static_cast<Imp &> (*this); }
@@ -16,6 +16,7 @@
 #include"flags.hh"
 #include"idefault.hh"
 #include "diffusionparam.hh"
+#include "scratch.hh"
 
 namespace Dune {
   namespace PDELab {
@@ -83,17 +84,20 @@ namespace Dune {
         Dune::FieldVector<DF,dim> localcenter = Dune::ReferenceElements<DF,dim>::general(gt).position(0,0);
         k.evaluate(eg.entity(),localcenter,tensor);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<JacobianType>& js = scratch.get<JacobianType>(0,lfsu.size(),lfsu.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& gradphi = scratch.get<Dune::FieldVector<RF,dim> >(1,lfsu.size(),lfsu.maxSize());
+        std::vector<RangeType>& phi = scratch.get<RangeType>(2,lfsu.size(),lfsu.maxSize());
+
         // loop over quadrature points
         for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
             // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
-            std::vector<JacobianType> js(lfsu.size());
             lfsu.finiteElement().localBasis().evaluateJacobian(it->position(),js);
 
             // transform gradient to real element
             const typename EG::Geometry::JacobianInverseTransposed jac =
               eg.geometry().jacobianInverseTransposed(it->position());
-            std::vector<Dune::FieldVector<RF,dim> > gradphi(lfsu.size());
             for (size_type i=0; i<lfsu.size(); i++)
               {
                 gradphi[i] = 0.0;
@@ -110,7 +114,6 @@ namespace Dune {
             tensor.umv(gradu,Kgradu);
 
             // evaluate basis functions
-            std::vector<RangeType> phi(lfsu.size());
             lfsu.finiteElement().localBasis().evaluateFunction(it->position(),phi);
 
             // evaluate u
@@ -157,17 +160,21 @@ namespace Dune {
         Dune::FieldVector<DF,dim> localcenter = Dune::ReferenceElements<DF,dim>::general(gt).position(0,0);
         k.evaluate(eg.entity(),localcenter,tensor);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<JacobianType>& js = scratch.get<JacobianType>(0,lfsu.size(),lfsu.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& gradphi = scratch.get<Dune::FieldVector<RF,dim> >(1,lfsu.size(),lfsu.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& Kgradphi = scratch.get<Dune::FieldVector<RF,dim> >(2,lfsu.size(),lfsu.maxSize());
+        std::vector<RangeType>& phi = scratch.get<RangeType>(3,lfsu.size(),lfsu.maxSize());
+
         // loop over quadrature points
         for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
             // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
-            std::vector<JacobianType> js(lfsu.size());
             lfsu.finiteElement().localBasis().evaluateJacobian(it->position(),js);
 
             // transform gradient to real element
             const typename EG::Geometry::JacobianInverseTransposed jac =
               eg.geometry().jacobianInverseTransposed(it->position());
-            std::vector<Dune::FieldVector<RF,dim> > gradphi(lfsu.size());
             for (size_type i=0; i<lfsu.size(); i++)
               {
                 gradphi[i] = 0.0;
@@ -175,12 +182,10 @@ namespace Dune {
               }
 
             // compute K * gradient of shape functions
-            std::vector<Dune::FieldVector<RF,dim> > Kgradphi(lfsu.size());
             for (size_type i=0; i<lfsu.size(); i++)
               tensor.mv(gradphi[i],Kgradphi[i]);
 
             // evaluate basis functions
-            std::vector<RangeType> phi(lfsu.size());
             lfsu.finiteElement().localBasis().evaluateFunction(it->position(),phi);
 
             // evaluate Helmholtz term
@@ -216,11 +221,13 @@ namespace Dune {
         Dune::GeometryType gt = eg.geometry().type();
         const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,intorder);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<RangeType>& phi = scratch.get<RangeType>(0,lfsv.size(),lfsv.maxSize());
+
         // loop over quadrature points
         for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
             // evaluate shape functions
-            std::vector<RangeType> phi(lfsv.size());
             lfsv.finiteElement().localBasis().evaluateFunction(it->position(),phi);
 
             // evaluate right hand side parameter function
@@ -255,6 +262,9 @@ namespace Dune {
         Dune::GeometryType gtface = ig.geometryInInside().type();
         const Dune::QuadratureRule<DF,dim-1>& rule = Dune::QuadratureRules<DF,dim-1>::rule(gtface,intorder);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<RangeType>& phi = scratch.get<RangeType>(0,lfsv.size(),lfsv.maxSize());
+
         // loop over quadrature points and integrate normal flux
         for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
@@ -267,7 +277,6 @@ namespace Dune {
             Dune::FieldVector<DF,dim> local = ig.geometryInInside().global(it->position());
 
             // evaluate test shape functions
-            std::vector<RangeType> phi(lfsv.size());
             lfsv.finiteElement().localBasis().evaluateFunction(local,phi);
 
             // evaluate flux boundary condition
@@ -288,6 +297,7 @@ namespace Dune {
       const B& bctype;
       const J& j;
       int intorder;
+      mutable LocalOperatorScratch scratch;
     };
 
     //! \} group LocalOperator
@@ -14,6 +14,7 @@
 #include "pattern.hh"
 #include "flags.hh"
 #include "diffusionparam.hh"
+#include "scratch.hh"
 
 namespace Dune {
   namespace PDELab {
@@ -115,17 +116,19 @@ namespace Dune {
         Dune::FieldVector<DF,dim> localcenter = Dune::ReferenceElements<DF,dim>::general(gt).position(0,0);
         k.evaluate(eg.entity(),localcenter,tensor);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<JacobianType>& js = scratch.get<JacobianType>(0,lfsu.size(),lfsu.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& gradphi = scratch.get<Dune::FieldVector<RF,dim> >(1,lfsu.size(),lfsu.maxSize());
+
         // loop over quadrature points
         for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
             // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
-            std::vector<JacobianType> js(lfsu.size());
             lfsu.finiteElement().localBasis().evaluateJacobian(it->position(),js);
 
             // transform gradient to real element
             const typename EG::Geometry::JacobianInverseTransposed jac =
               eg.geometry().jacobianInverseTransposed(it->position());
-            std::vector<Dune::FieldVector<RF,dim> > gradphi(lfsu.size());
             for (size_t i=0; i<lfsu.size(); i++)
               {
                 gradphi[i] = 0.0;
@@ -198,6 +201,16 @@ namespace Dune {
         // penalty weight for NIPG / SIPG
         RF penalty_weight = sigma / pow(ig.geometry().volume(), beta);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<JacobianType>& js_s = scratch.get<JacobianType>(0,lfsv_s.size(),lfsv_s.maxSize());
+        std::vector<JacobianType>& js_n = scratch.get<JacobianType>(1,lfsv_n.size(),lfsv_n.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& gradphi_s = scratch.get<Dune::FieldVector<RF,dim> >(2,lfsv_s.size(),lfsv_s.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& gradphi_n = scratch.get<Dune::FieldVector<RF,dim> >(3,lfsv_n.size(),lfsv_n.maxSize());
+        std::vector<RangeType>& phi_s = scratch.get<RangeType>(4,lfsv_s.size(),lfsv_s.maxSize());
+        std::vector<RangeType>& phi_n = scratch.get<RangeType>(5,lfsv_n.size(),lfsv_n.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& kgradphi_s = scratch.get<Dune::FieldVector<RF,dim> >(6,lfsu_s.size(),lfsu_s.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& kgradphi_n = scratch.get<Dune::FieldVector<RF,dim> >(7,lfsu_n.size(),lfsu_n.maxSize());
+
         // loop over quadrature points
         for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
@@ -206,15 +219,12 @@ namespace Dune {
             Dune::FieldVector<DF,dim> local_n = ig.geometryInOutside().global(it->position());
 
             // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
-            std::vector<JacobianType> js_s(lfsv_s.size());
             lfsv_s.finiteElement().localBasis().evaluateJacobian(local_s,js_s);
-            std::vector<JacobianType> js_n(lfsv_n.size());
             lfsv_n.finiteElement().localBasis().evaluateJacobian(local_n,js_n);
 
             // transform gradient to real element
             typename IG::Entity::Geometry::JacobianInverseTransposed jac_s;
             jac_s = ig.inside()->geometry().jacobianInverseTransposed(local_s);
-            std::vector<Dune::FieldVector<RF,dim> > gradphi_s(lfsv_s.size());
             for (size_t i=0; i<lfsv_s.size(); i++)
               {
                 gradphi_s[i] = 0.0;
@@ -222,7 +232,6 @@ namespace Dune {
               }
             typename IG::Entity::Geometry::JacobianInverseTransposed jac_n;
             jac_n = ig.outside()->geometry().jacobianInverseTransposed(local_n);
-            std::vector<Dune::FieldVector<RF,dim> > gradphi_n(lfsv_n.size());
             for (size_t i=0; i<lfsv_n.size(); i++)
               {
                 gradphi_n[i] = 0.0;
@@ -230,9 +239,7 @@ namespace Dune {
               }
 
             // evaluate test shape functions
-            std::vector<RangeType> phi_s(lfsv_s.size());
             lfsv_s.finiteElement().localBasis().evaluateFunction(local_s,phi_s);
-            std::vector<RangeType> phi_n(lfsv_n.size());
             lfsv_n.finiteElement().localBasis().evaluateFunction(local_n,phi_n);
 
             // compute gradient of u
@@ -272,8 +279,6 @@ namespace Dune {
             RF kgradunormal_average = (kgradu_s + kgradu_n)*normal * 0.5;
 
             // average on intersection of K * grad v * normal
-            std::vector<Dune::FieldVector<RF,dim> > kgradphi_s(lfsu_s.size());
-            std::vector<Dune::FieldVector<RF,dim> > kgradphi_n(lfsu_n.size());
             for (size_t i=0; i<lfsu_s.size(); i++)
               {
                 permeability_s.mv(gradphi_s[i],kgradphi_s[i]);
@@ -347,6 +352,11 @@ namespace Dune {
             // penalty weight for NIPG / SIPG
             RF penalty_weight = sigma / pow(ig.geometry().volume(), beta);
 
+            // temporaries, requested once for all quadrature points
+            std::vector<JacobianType>& js = scratch.get<JacobianType>(0,lfsv.size(),lfsv.maxSize());
+            std::vector<Dune::FieldVector<RF,dim> >& gradphi = scratch.get<Dune::FieldVector<RF,dim> >(1,lfsv.size(),lfsv.maxSize());
+            std::vector<RangeType>& phi = scratch.get<RangeType>(2,lfsv.size(),lfsv.maxSize());
+
             // loop over quadrature points and integrate u * phi
             for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
               {
@@ -354,13 +364,11 @@ namespace Dune {
                 Dune::FieldVector<DF,dim> local = ig.geometryInInside().global(it->position());
 
                 // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
-                std::vector<JacobianType> js(lfsv.size());
                 lfsv.finiteElement().localBasis().evaluateJacobian(local,js);
 
                 // transform gradient to real element
                 typename IG::Entity::Geometry::JacobianInverseTransposed jac;
                 jac = ig.inside()->geometry().jacobianInverseTransposed(local);
-                std::vector<Dune::FieldVector<RF,dim> > gradphi(lfsv.size());
                 for (size_t i=0; i<lfsv.size(); i++)
                   {
                     gradphi[i] = 0.0;
@@ -368,7 +376,6 @@ namespace Dune {
                   }
 
                 // evaluate test shape functions
-                std::vector<RangeType> phi(lfsv.size());
                 lfsv.finiteElement().localBasis().evaluateFunction(local,phi);
 
                 // compute gradient of u
@@ -427,11 +434,13 @@ namespace Dune {
         const int qorder = std::max ( 2 * ( (int)lfsv.finiteElement().localBasis().order() - 1 ), 0) + superintegration_order;
         const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,qorder);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<RangeType>& phi = scratch.get<RangeType>(0,lfsv.size(),lfsv.maxSize());
+
         // loop over quadrature points
         for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
             // evaluate shape functions
-            std::vector<RangeType> phi(lfsv.size());
             lfsv.finiteElement().localBasis().evaluateFunction(it->position(),phi);
 
             // evaluate right hand side parameter function
@@ -476,6 +485,9 @@ namespace Dune {
         // Neumann boundary condition
         if( bctype.isNeumann( ig, rule.begin()->position() ) )
           {
+            // temporaries, requested once for all quadrature points
+            std::vector<RangeType>& phi = scratch.get<RangeType>(0,lfsv.size(),lfsv.maxSize());
+
             // loop over quadrature points and integrate normal flux
             for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
               {
@@ -483,7 +495,6 @@ namespace Dune {
                 Dune::FieldVector<DF,dim> local = ig.geometryInInside().global(it->position());
 
                 // evaluate test shape functions
-                std::vector<RangeType> phi(lfsv.size());
                 lfsv.finiteElement().localBasis().evaluateFunction(local,phi);
 
                 // evaluate flux boundary condition
@@ -519,6 +530,11 @@ namespace Dune {
             // penalty weight for NIPG / SIPG
             RF penalty_weight = sigma / pow(ig.geometry().volume(), beta);
 
+            // temporaries, requested once for all quadrature points
+            std::vector<JacobianType>& js = scratch.get<JacobianType>(1,lfsv.size(),lfsv.maxSize());
+            std::vector<Dune::FieldVector<RF,dim> >& gradphi = scratch.get<Dune::FieldVector<RF,dim> >(2,lfsv.size(),lfsv.maxSize());
+            std::vector<RangeType>& phi = scratch.get<RangeType>(3,lfsv.size(),lfsv.maxSize());
+
             // loop over quadrature points and integrate g * phi
             for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
               {
@@ -526,13 +542,11 @@ namespace Dune {
                 Dune::FieldVector<DF,dim> local = ig.geometryInInside().global(it->position());
 
                 // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
-                std::vector<JacobianType> js(lfsv.size());
                 lfsv.finiteElement().localBasis().evaluateJacobian(local,js);
 
                 // transform gradient to real element
                 typename IG::Entity::Geometry::JacobianInverseTransposed jac;
                 jac = ig.inside()->geometry().jacobianInverseTransposed(local);
-                std::vector<Dune::FieldVector<RF,dim> > gradphi(lfsv.size());
                 for (size_t i=0; i<lfsv.size(); i++)
                   {
                     gradphi[i] = 0.0;
@@ -540,7 +554,6 @@ namespace Dune {
                   }
 
                 // evaluate test shape functions
-                std::vector<RangeType> phi(lfsv.size());
                 lfsv.finiteElement().localBasis().evaluateFunction(local,phi);
 
                 // evaluate Dirichlet boundary condition
@@ -593,17 +606,20 @@ namespace Dune {
         Dune::FieldVector<DF,dim> localcenter = Dune::ReferenceElements<DF,dim>::general(gt).position(0,0);
         k.evaluate(eg.entity(),localcenter,tensor);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<JacobianType>& js = scratch.get<JacobianType>(0,lfsu.size(),lfsu.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& gradphi = scratch.get<Dune::FieldVector<RF,dim> >(1,lfsu.size(),lfsu.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& Kgradphi = scratch.get<Dune::FieldVector<RF,dim> >(2,lfsu.size(),lfsu.maxSize());
+
         // loop over quadrature points
         for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
             // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
-            std::vector<JacobianType> js(lfsu.size());
             lfsu.finiteElement().localBasis().evaluateJacobian(it->position(),js);
 
             // transform gradient to real element
             typename EG::Geometry::JacobianInverseTransposed jac;
              jac = eg.geometry().jacobianInverseTransposed(it->position());
-            std::vector<Dune::FieldVector<RF,dim> > gradphi(lfsu.size());
             for (typename LFSU::Traits::SizeType i=0; i<lfsu.size(); i++)
               {
                 gradphi[i] = 0.0;
@@ -611,7 +627,6 @@ namespace Dune {
               }
 
             // compute K * gradient of shape functions
-            std::vector<Dune::FieldVector<RF,dim> > Kgradphi(lfsu.size());
             for (typename LFSU::Traits::SizeType i=0; i<lfsu.size(); i++)
               {
                 tensor.mv(gradphi[i],Kgradphi[i]);
@@ -678,6 +693,16 @@ namespace Dune {
         // penalty weight for NIPG / SIPG
         RF penalty_weight = sigma / pow(ig.geometry().volume(), beta);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<JacobianType>& js_s = scratch.get<JacobianType>(0,lfsv_s.size(),lfsv_s.maxSize());
+        std::vector<JacobianType>& js_n = scratch.get<JacobianType>(1,lfsv_n.size(),lfsv_n.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& gradphi_s = scratch.get<Dune::FieldVector<RF,dim> >(2,lfsv_s.size(),lfsv_s.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& gradphi_n = scratch.get<Dune::FieldVector<RF,dim> >(3,lfsv_n.size(),lfsv_n.maxSize());
+        std::vector<RangeType>& phi_s = scratch.get<RangeType>(4,lfsv_s.size(),lfsv_s.maxSize());
+        std::vector<RangeType>& phi_n = scratch.get<RangeType>(5,lfsv_n.size(),lfsv_n.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& kgradphi_s = scratch.get<Dune::FieldVector<RF,dim> >(6,lfsu_s.size(),lfsu_s.maxSize());
+        std::vector<Dune::FieldVector<RF,dim> >& kgradphi_n = scratch.get<Dune::FieldVector<RF,dim> >(7,lfsu_n.size(),lfsu_n.maxSize());
+
         // loop over quadrature points
         for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
@@ -686,15 +711,12 @@ namespace Dune {
             Dune::FieldVector<DF,dim> local_n = ig.geometryInOutside().global(it->position());
 
             // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
-            std::vector<JacobianType> js_s(lfsv_s.size());
             lfsv_s.finiteElement().localBasis().evaluateJacobian(local_s,js_s);
-            std::vector<JacobianType> js_n(lfsv_n.size());
             lfsv_n.finiteElement().localBasis().evaluateJacobian(local_n,js_n);
 
             // transform gradient to real element
             typename IG::Entity::Geometry::JacobianInverseTransposed jac_s;
             jac_s = ig.inside()->geometry().jacobianInverseTransposed(local_s);
-            std::vector<Dune::FieldVector<RF,dim> > gradphi_s(lfsv_s.size());
             for (size_t i=0; i<lfsv_s.size(); i++)
               {
                 gradphi_s[i] = 0.0;
@@ -702,7 +724,6 @@ namespace Dune {
               }
             typename IG::Entity::Geometry::JacobianInverseTransposed jac_n;
             jac_n = ig.outside()->geometry().jacobianInverseTransposed(local_n);
-            std::vector<Dune::FieldVector<RF,dim> > gradphi_n(lfsv_n.size());
             for (size_t i=0; i<lfsv_n.size(); i++)
               {
                 gradphi_n[i] = 0.0;
@@ -710,9 +731,7 @@ namespace Dune {
               }
 
             // evaluate test shape functions
-            std::vector<RangeType> phi_s(lfsv_s.size());
             lfsv_s.finiteElement().localBasis().evaluateFunction(local_s,phi_s);
-            std::vector<RangeType> phi_n(lfsv_n.size());
             lfsv_n.finiteElement().localBasis().evaluateFunction(local_n,phi_n);
 
             // compute gradient of u
@@ -746,8 +765,6 @@ namespace Dune {
               }
 
             // average on intersection of K * grad v * normal
-            std::vector<Dune::FieldVector<RF,dim> > kgradphi_s(lfsu_s.size());
-            std::vector<Dune::FieldVector<RF,dim> > kgradphi_n(lfsu_n.size());
             for (size_t i=0; i<lfsu_s.size(); i++)
               {
                 permeability_s.mv(gradphi_s[i],kgradphi_s[i]);
@@ -841,6 +858,12 @@ namespace Dune {
             // penalty weight for NIPG / SIPG
             RF penalty_weight = sigma / pow(ig.geometry().volume(), beta);
 
+            // temporaries, requested once for all quadrature points
+            std::vector<JacobianType>& js = scratch.get<JacobianType>(0,lfsv.size(),lfsv.maxSize());
+            std::vector<Dune::FieldVector<RF,dim> >& gradphi = scratch.get<Dune::FieldVector<RF,dim> >(1,lfsv.size(),lfsv.maxSize());
+            std::vector<RangeType>& phi = scratch.get<RangeType>(2,lfsv.size(),lfsv.maxSize());
+            std::vector<Dune::FieldVector<RF,dim> >& kgradphi = scratch.get<Dune::FieldVector<RF,dim> >(3,lfsu.size(),lfsu.maxSize());
+
             // loop over quadrature points and integrate u * phi
             for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
               {
@@ -848,13 +871,11 @@ namespace Dune {
                 Dune::FieldVector<DF,dim> local = ig.geometryInInside().global(it->position());
 
                 // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
-                std::vector<JacobianType> js(lfsv.size());
                 lfsv.finiteElement().localBasis().evaluateJacobian(local,js);
 
                 // transform gradient to real element
                 typename IG::Entity::Geometry::JacobianInverseTransposed jac;
                 jac = ig.inside()->geometry().jacobianInverseTransposed(local);
-                std::vector<Dune::FieldVector<RF,dim> > gradphi(lfsv.size());
                 for (size_t i=0; i<lfsv.size(); i++)
                   {
                     gradphi[i] = 0.0;
@@ -862,7 +883,6 @@ namespace Dune {
                   }
 
                 // evaluate test shape functions
-                std::vector<RangeType> phi(lfsv.size());
                 lfsv.finiteElement().localBasis().evaluateFunction(local,phi);
 
                 // compute gradient of u
@@ -873,7 +893,6 @@ namespace Dune {
                   }
 
                 // compute K * gradient of v
-                std::vector<Dune::FieldVector<RF,dim> > kgradphi(lfsu.size());
                 for (size_t i=0; i<lfsu.size(); i++)
                   {
                     tensor.mv(gradphi[i],kgradphi[i]);
@@ -907,6 +926,7 @@ namespace Dune {
       double sigma;
       double beta;
       int superintegration_order; // Quadrature order
+      mutable LocalOperatorScratch scratch;
     };
 
     //! \} group GridFunctionSpace
@@ -18,6 +18,7 @@
 #include"pattern.hh"
 #include"flags.hh"
 #include "diffusionparam.hh"
+#include "scratch.hh"
 
 namespace Dune {
   namespace PDELab {
@@ -93,14 +94,17 @@ namespace Dune {
 
         // \sigma\cdot v term
         const Dune::QuadratureRule<DF,dim>& vrule = Dune::QuadratureRules<DF,dim>::rule(gt,qorder_v);
+
+        // temporaries, requested once for all quadrature points
+        std::vector<VelocityRangeType>& vbasis = scratch.get<VelocityRangeType>(0,velocityspace.size(),velocityspace.maxSize());
+        std::vector<VelocityRangeType>& vtransformedbasis = scratch.get<VelocityRangeType>(1,velocityspace.size(),velocityspace.maxSize());
+
         for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=vrule.begin(); it!=vrule.end(); ++it)
           {
             // evaluate shape functions at ip (this is a Galerkin method)
-            std::vector<VelocityRangeType> vbasis(velocityspace.size());
             velocityspace.finiteElement().localBasis().evaluateFunction(it->position(),vbasis);
 
             // transform basis vectors
-            std::vector<VelocityRangeType> vtransformedbasis(velocityspace.size());
             for (std::size_t i=0; i<velocityspace.size(); i++)
               {
                 vtransformedbasis[i] = 0.0;
@@ -124,12 +128,16 @@ namespace Dune {
 
         // u div v term, div sigma q term, a0*u term
         const Dune::QuadratureRule<DF,dim>& prule = Dune::QuadratureRules<DF,dim>::rule(gt,qorder_p);
+
+        // temporaries, requested once for all quadrature points
+        std::vector<VelocityJacobianType>& vjacobian = scratch.get<VelocityJacobianType>(2,velocityspace.size(),velocityspace.maxSize());
+        std::vector<PressureRangeType>& pbasis = scratch.get<PressureRangeType>(3,pressurespace.size(),pressurespace.maxSize());
+        std::vector<RF>& divergence = scratch.get<RF>(0,velocityspace.size(),velocityspace.maxSize());
+
         for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=prule.begin(); it!=prule.end(); ++it)
           {
             // evaluate shape functions at ip (this is a Galerkin method)
-            std::vector<VelocityJacobianType> vbasis(velocityspace.size());
-            velocityspace.finiteElement().localBasis().evaluateJacobian(it->position(),vbasis);
-            std::vector<PressureRangeType> pbasis(pressurespace.size());
+            velocityspace.finiteElement().localBasis().evaluateJacobian(it->position(),vjacobian);
             pressurespace.finiteElement().localBasis().evaluateFunction(it->position(),pbasis);
 
             // compute u
@@ -147,10 +155,10 @@ namespace Dune {
               r.accumulate(pressurespace,i,-a0value*u*pbasis[i]*factor);
 
             // compute divergence of velocity basis functions on reference element
-            std::vector<RF> divergence(velocityspace.size(),0.0);
+            std::fill(divergence.begin(),divergence.end(),0.0);
             for (std::size_t i=0; i<velocityspace.size(); i++)
               for (int j=0; j<dim; j++)
-                divergence[i] += vbasis[i][j][j];
+                divergence[i] += vjacobian[i][j][j];
 
             // integrate sigma * phi_i
             for (std::size_t i=0; i<velocityspace.size(); i++)
@@ -190,11 +198,13 @@ namespace Dune {
         Dune::GeometryType gt = eg.geometry().type();
         const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,qorder_p);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<PressureRangeType>& pbasis = scratch.get<PressureRangeType>(0,pressurespace.size(),pressurespace.maxSize());
+
         // loop over quadrature points
         for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
             // evaluate shape functions
-            std::vector<PressureRangeType> pbasis(pressurespace.size());
             pressurespace.finiteElement().localBasis().evaluateFunction(it->position(),pbasis);
 
             // evaluate right hand side parameter function
@@ -238,6 +248,10 @@ namespace Dune {
         Dune::GeometryType gtface = ig.geometryInInside().type();
         const Dune::QuadratureRule<DF,dim-1>& rule = Dune::QuadratureRules<DF,dim-1>::rule(gtface,qorder_v);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<VelocityRangeType>& vbasis = scratch.get<VelocityRangeType>(0,velocityspace.size(),velocityspace.maxSize());
+        std::vector<VelocityRangeType>& vtransformedbasis = scratch.get<VelocityRangeType>(1,velocityspace.size(),velocityspace.maxSize());
+
         // loop over quadrature points and integrate normal flux
         for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
@@ -250,11 +264,9 @@ namespace Dune {
             Dune::FieldVector<DF,dim> local = ig.geometryInInside().global(it->position());
 
             // evaluate test shape functions
-            std::vector<VelocityRangeType> vbasis(velocityspace.size());
             velocityspace.finiteElement().localBasis().evaluateFunction(local,vbasis);
 
             // transform basis vectors
-            std::vector<VelocityRangeType> vtransformedbasis(velocityspace.size());
             for (std::size_t i=0; i<velocityspace.size(); i++)
               {
                 vtransformedbasis[i] = 0.0;
@@ -280,6 +292,7 @@ namespace Dune {
       const G& g;
       int qorder_v;
       int qorder_p;
+      mutable LocalOperatorScratch scratch;
     };
 
     //! \} group GridFunctionSpace
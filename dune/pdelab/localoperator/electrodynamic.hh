@@ -17,6 +17,7 @@
 #include"defaultimp.hh"
 #include"pattern.hh"
 #include"flags.hh"
+#include"scratch.hh"
 
 namespace Dune {
   namespace PDELab {
@@ -91,11 +92,13 @@ namespace Dune {
         Dune::GeometryType gt = eg.geometry().type();
         const QR& rule = QRs::rule(gt,qorder);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<Range>& phi = scratch.get<Range>(0,lfsu.size(),lfsu.maxSize());
+
         // loop over quadrature points
         for(typename QR::const_iterator it=rule.begin();
             it!=rule.end(); ++it) {
           // values of basefunctions
-          std::vector<Range> phi(lfsu.size());
           lfsu.finiteElement().basis().evaluateFunction(it->position(),phi);
 
           // calculate T
@@ -114,6 +117,7 @@ namespace Dune {
     private:
       const Eps &eps;
       const int qorder;
+      mutable LocalOperatorScratch scratch;
     };
 
     //! Contruct matrix S for the Electrodynamic operator
@@ -211,14 +215,16 @@ namespace Dune {
         Dune::GeometryType gt = eg.geometry().type();
         const QR& rule = QRs::rule(gt,qorder);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<Jacobian>& J = scratch.get<Jacobian>(0,lfsu.size(),lfsu.maxSize());
+        std::vector<Curl>& rotphi = scratch.get<Curl>(1,lfsu.size(),lfsu.maxSize());
+
         // loop over quadrature points
         for(typename QR::const_iterator it=rule.begin();
             it!=rule.end(); ++it) {
           // curl of the basefunctions
-          std::vector<Jacobian> J(lfsu.size());
           lfsu.finiteElement().basis().evaluateJacobian(it->position(),J);
 
-          std::vector<Curl> rotphi(lfsu.size());
           for(unsigned i = 0; i < lfsu.size(); ++i)
             jacobianToCurl(rotphi[i], J[i]);
 
@@ -239,6 +245,7 @@ namespace Dune {
     private:
       const Mu &mu;
       const int qorder;
+      mutable LocalOperatorScratch scratch;
     };
 
     //! \} group LocalOperator
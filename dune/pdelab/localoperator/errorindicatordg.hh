@@ -20,6 +20,7 @@
 #include "convectiondiffusionparameter.hh"
 #include "convectiondiffusiondg.hh"
 #include "eval.hh"
+#include "scratch.hh"
 
 // Note:
 // The residual-based error estimator implemented here (for h-refinement only!)
@@ -107,12 +108,14 @@ namespace Dune {
         // select quadrature rule
         const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,intorder);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<RangeType>& phi = scratch.get<RangeType>(0,lfsu.size(),lfsu.maxSize());
+
         // loop over quadrature points
         RF sum(0.0);
         for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
             // evaluate basis functions
-            std::vector<RangeType> phi(lfsu.size());
             lfsu.finiteElement().localBasis().evaluateFunction(it->position(),phi);
 
             // evaluate u
@@ -362,6 +365,7 @@ namespace Dune {
         return hmax;
       }
 
+      mutable LocalOperatorScratch scratch;
     };
 
 
@@ -3,6 +3,8 @@
 #ifndef DUNE_PDELAB_LOCALOPERATOR_FLAGS_HH
 #define DUNE_PDELAB_LOCALOPERATOR_FLAGS_HH
 
+#include <type_traits>
+
 namespace Dune
 {
     namespace PDELab
@@ -79,9 +81,80 @@ namespace Dune
 
             //! \brief Whether to visit the skeleton methods from both sides
             enum { /*! \hideinitializer */ doSkeletonTwoSided = false };
+            //! \brief Whether the local operator provides
+            //!        alpha_volume_batch() and jacobian_volume_batch(),
+            //!        see LocalOperatorSupportsBatchedVolume.
+            enum { /*! \hideinitializer */ doAlphaVolumeBatch = false };
+            //! \brief Whether the local operator provides
+            //!        alpha_jacobian_volume(), see
+            //!        LocalOperatorSupportsFusedVolume.
+            enum { /*! \hideinitializer */ doAlphaJacobianVolume = false };
 
             //! \} Special flags
         };
+
+        //! Tells whether a local operator can evaluate its volume terms on batches of cells.
+        /**
+         * A local operator opts in by setting
+         * \code
+         * enum { doAlphaVolumeBatch = true };
+         * \endcode
+         * and providing
+         * \code
+         * template<typename Batch, typename LFSU, typename X, typename LFSV, typename R>
+         * void alpha_volume_batch (const Batch& batch, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r) const;
+         * template<typename Batch, typename LFSU, typename X, typename LFSV, typename M>
+         * void jacobian_volume_batch (const Batch& batch, const LFSU& lfsu, const X& x, const LFSV& lfsv, M& mat) const;
+         * \endcode
+         * which compute the same contributions as alpha_volume() and jacobian_volume() for all
+         * cells of an ElementBatch at once. The results are accumulated without a weight.
+         * Operators that do not define the flag are treated as if it was false.
+         */
+        template<typename LOP, typename = void>
+        struct LocalOperatorSupportsBatchedVolume
+            : public std::false_type
+        {};
+
+#ifndef DOXYGEN
+
+        template<typename LOP>
+        struct LocalOperatorSupportsBatchedVolume<LOP,typename std::enable_if<LOP::doAlphaVolumeBatch>::type>
+            : public std::true_type
+        {};
+
+#endif // DOXYGEN
+
+        //! Tells whether a local operator can compute the residual and the jacobian of its volume terms together.
+        /**
+         * A local operator opts in by setting
+         * \code
+         * enum { doAlphaJacobianVolume = true };
+         * \endcode
+         * and providing
+         * \code
+         * template<typename EG, typename LFSU, typename X, typename LFSV, typename R, typename M>
+         * void alpha_jacobian_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r, M& mat) const;
+         * \endcode
+         * which accumulates the contributions of alpha_volume() to r and those of jacobian_volume()
+         * to mat in a single loop over the quadrature points. It is used by the combined residual
+         * and jacobian assembly, see GridOperator::residual_and_jacobian(). Operators that do not
+         * define the flag are treated as if it was false, their alpha_volume() and jacobian_volume()
+         * are called one after the other.
+         */
+        template<typename LOP, typename = void>
+        struct LocalOperatorSupportsFusedVolume
+            : public std::false_type
+        {};
+
+#ifndef DOXYGEN
+
+        template<typename LOP>
+        struct LocalOperatorSupportsFusedVolume<LOP,typename std::enable_if<LOP::doAlphaJacobianVolume>::type>
+            : public std::true_type
+        {};
+
+#endif // DOXYGEN
+
         //! \} group LocalOperator
     }
 }
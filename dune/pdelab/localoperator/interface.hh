@@ -573,6 +573,83 @@ namespace Dune {
         const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
         Y& y_s);
 
+      //! apply an element's jacobian at a linearization point to a direction
+      /**
+       * \param eg   ElementGeometry describing the entity.
+       * \param lfsu LocalFunctionSpace of the trial GridFunctionSpace.
+       * \param x    Local position in the trial GridFunctionSpace where the
+       *             jacobian is evaluated.
+       * \param z    Local coefficients of the vector the jacobian is applied
+       *             to.
+       * \param lfsv LocalFunctionSpace of the test GridFunctionSpace.
+       * \param y    Where to store the result.
+       *
+       * This is the variant of jacobian_apply_volume() for non-linear
+       * problems, which is used by GridOperator::jacobian_apply(x,z,r).  A
+       * numerical implementation in terms of alpha_volume() is provided by
+       * NumericalJacobianApplyVolume.
+       *
+       * \note The method should not clear \c y; it should just add its
+       *       entries to it.
+       *
+       * This method is controlled by the flag \ref doAlphaVolume.
+       */
+      template<typename EG, typename LFSU, typename X, typename Z,
+               typename LFSV, typename Y>
+      void jacobian_apply_volume
+      ( const EG& eg,
+        const LFSU& lfsu, const X& x, const Z& z, const LFSV& lfsv,
+        Y& y);
+
+      //! \brief apply an element's jacobian at a linearization point to a
+      //!        direction after the intersections have been handled
+      /**
+       * Non-linear variant of jacobian_apply_volume_post_skeleton(), the
+       * parameters are the same as for the non-linear variant of
+       * jacobian_apply_volume().
+       *
+       * This method is controlled by the flag \ref doAlphaVolumePostSkeleton.
+       */
+      template<typename EG, typename LFSU, typename X, typename Z,
+               typename LFSV, typename Y>
+      void jacobian_apply_volume_post_skeleton
+      ( const EG& eg,
+        const LFSU& lfsu, const X& x, const Z& z, const LFSV& lfsv,
+        Y& y);
+
+      //! \brief apply an internal intersections's jacobians at a
+      //!        linearization point to a direction
+      /**
+       * Non-linear variant of jacobian_apply_skeleton(): \c x_s and \c x_n
+       * are the positions where the jacobian is evaluated, \c z_s and \c z_n
+       * the local coefficients of the vector the jacobian is applied to.
+       *
+       * This method is controlled by the flag \ref doAlphaSkeleton.
+       */
+      template<typename IG, typename LFSU, typename X, typename Z,
+               typename LFSV, typename Y>
+      void jacobian_apply_skeleton
+      ( const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const Z& z_s, const LFSV& lfsv_s,
+        const LFSU& lfsu_n, const X& x_n, const Z& z_n, const LFSV& lfsv_n,
+        Y& y_s, Y& y_n);
+
+      //! \brief apply a boundary intersections's jacobian at a linearization
+      //!        point to a direction
+      /**
+       * Non-linear variant of jacobian_apply_boundary(): \c x_s is the
+       * position where the jacobian is evaluated, \c z_s the local
+       * coefficients of the vector the jacobian is applied to.
+       *
+       * This method is controlled by the flag \ref doAlphaBoundary.
+       */
+      template<typename IG, typename LFSU, typename X, typename Z,
+               typename LFSV, typename Y>
+      void jacobian_apply_boundary
+      ( const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const Z& z_s, const LFSV& lfsv_s,
+        Y& y_s);
+
       //! \} Methods for the application of the jacobian
 
       //////////////////////////////////////////////////////////////////////
@@ -18,6 +18,7 @@
 #include"pattern.hh"
 #include"flags.hh"
 #include"idefault.hh"
+#include"scratch.hh"
 
 namespace Dune {
   namespace PDELab {
@@ -74,11 +75,13 @@ namespace Dune {
         Dune::GeometryType gt = eg.geometry().type();
         const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,intorder);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<RangeType>& phi = scratch.get<RangeType>(0,lfsu.size(),lfsu.maxSize());
+
         // loop over quadrature points
         for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
             // evaluate basis functions
-            std::vector<RangeType> phi(lfsu.size());
             FESwitch::basis(lfsu.finiteElement()).evaluateFunction(it->position(),phi);
 
             // evaluate u
@@ -119,11 +122,13 @@ namespace Dune {
         Dune::GeometryType gt = eg.geometry().type();
         const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,intorder);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<RangeType>& phi = scratch.get<RangeType>(0,lfsu.size(),lfsu.maxSize());
+
         // loop over quadrature points
         for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
             // evaluate basis functions
-            std::vector<RangeType> phi(lfsu.size());
             FESwitch::basis(lfsu.finiteElement()).evaluateFunction(it->position(),phi);
 
             // integrate phi_j*phi_i
@@ -137,6 +142,7 @@ namespace Dune {
     private:
       int intorder;
       const double _scaling;
+      mutable LocalOperatorScratch scratch;
     };
 
     /** a local operator for the mass operator of a vector valued lfs (L_2 integral)
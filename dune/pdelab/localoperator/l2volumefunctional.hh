@@ -16,6 +16,7 @@
 #include <dune/pdelab/localoperator/idefault.hh>
 #include <dune/pdelab/localoperator/pattern.hh>
 #include <dune/pdelab/localoperator/flags.hh>
+#include <dune/pdelab/localoperator/scratch.hh>
 
 namespace Dune {
   namespace PDELab {
@@ -68,12 +69,14 @@ namespace Dune {
         const Dune::QuadratureRule<DF,dimLocal>& rule =
           Dune::QuadratureRules<DF,dimLocal>::rule(gt,quadOrder_);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<Range>& phi = scratch.get<Range>(0,lfsv.size(),lfsv.maxSize());
+
         // loop over quadrature points
         for (typename Dune::QuadratureRule<DF,dimLocal>::const_iterator it =
                rule.begin(); it!=rule.end(); ++it)
           {
             // evaluate shape functions
-            std::vector<Range> phi(lfsv.size());
             FESwitch::basis(lfsv.finiteElement()).
               evaluateFunction(it->position(),phi);
 
@@ -93,6 +96,7 @@ namespace Dune {
 
       // Quadrature rule order
       unsigned int quadOrder_;
+      mutable LocalOperatorScratch scratch;
     };
 
     //! \} group LocalOperator
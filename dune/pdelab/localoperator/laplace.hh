@@ -16,6 +16,7 @@
 
 #include <dune/pdelab/localoperator/pattern.hh>
 #include <dune/pdelab/localoperator/flags.hh>
+#include <dune/pdelab/localoperator/scratch.hh>
 
 namespace Dune {
   namespace PDELab {
@@ -145,10 +146,12 @@ namespace Dune {
         Dune::GeometryType gt = eg.geometry().type();
         const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,quadOrder_);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<Dune::FieldMatrix<RF,1,dim> >& gradphi = scratch.get<Dune::FieldMatrix<RF,1,dim> >(0,lfsu.size(),lfsu.maxSize());
+
         // loop over quadrature points
         for (typename QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
         {
-          std::vector<Dune::FieldMatrix<RF,1,dim> > gradphi(lfsu.size());
           BasisSwitch::gradient(FESwitch::basis(lfsu.finiteElement()),
                                 eg.geometry(), it->position(), gradphi);
 
@@ -169,6 +172,7 @@ namespace Dune {
     protected:
       // Quadrature rule order
       unsigned int quadOrder_;
+      mutable LocalOperatorScratch scratch;
     };
 
      //! \} group LocalOperator
@@ -21,11 +21,13 @@ namespace Dune {
     //              u = g on \partial\Omega
     // with cell centered finite volumes on axiparallel cube grids
     // G : grid function for Dirichlet boundary conditions
+    // The jacobian is computed by automatic differentiation of the residual, which gives
+    // the exact matrix of this linear operator instead of a finite difference approximation.
     template<typename G>
     class LaplaceDirichletCCFV : public NumericalJacobianApplySkeleton<LaplaceDirichletCCFV<G> >,
                                  public NumericalJacobianApplyBoundary<LaplaceDirichletCCFV<G> >,
-                                 public NumericalJacobianSkeleton<LaplaceDirichletCCFV<G> >,
-                                 public NumericalJacobianBoundary<LaplaceDirichletCCFV<G> >,
+                                 public AutomaticJacobianSkeleton<LaplaceDirichletCCFV<G>,2>,
+                                 public AutomaticJacobianBoundary<LaplaceDirichletCCFV<G>,1>,
                                  public FullSkeletonPattern,
                                  public FullVolumePattern,
                                  public LocalOperatorDefaultFlags
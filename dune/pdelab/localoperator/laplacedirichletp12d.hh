@@ -11,6 +11,7 @@
 
 #include"pattern.hh"
 #include"flags.hh"
+#include"scratch.hh"
 
 
 namespace Dune {
@@ -48,7 +49,7 @@ namespace Dune {
         // gradient of shape functions at integration point
         typedef typename LFSU::Traits::FiniteElementType::
           Traits::LocalBasisType::Traits::JacobianType JT;
-        std::vector<JT> gradients(lfsu.size());
+        std::vector<JT>& gradients = scratch.get<JT>(0,lfsu.size(),lfsu.maxSize());
         lfsu.finiteElement().localBasis().
           evaluateJacobian(integrationpoint,gradients);
 
@@ -72,6 +73,9 @@ namespace Dune {
         for (int i=0; i<3; i++)
           r.accumulate(lfsv, i, (gradu*gradphi[i])*area);
       }
+
+    private:
+      mutable LocalOperatorScratch scratch;
     };
 
     //! \} group GridFunctionSpace
@@ -14,6 +14,7 @@
 #include<dune/pdelab/localoperator/flags.hh>
 #include<dune/pdelab/localoperator/idefault.hh>
 #include<dune/pdelab/localoperator/defaultimp.hh>
+#include<dune/pdelab/localoperator/scratch.hh>
 #include<dune/pdelab/finiteelement/localbasiscache.hh>
 
 #include"linearacousticsparameter.hh"
@@ -185,7 +186,7 @@ namespace Dune {
 
       // ! constructor
       DGLinearAcousticsSpatialOperator (T& param_, int overintegration_=0)
-        : param(param_), overintegration(overintegration_), cache(20)
+        : param(param_), overintegration(overintegration_)
       {
       }
 
@@ -228,11 +229,18 @@ namespace Dune {
 
         // std::cout << "alpha_volume center=" << eg.geometry().center() << std::endl;
 
+        // values and gradients of the basis functions at all quadrature points
+        const typename Cache::Table& dgspace_basis = cache.bind(dgspace.finiteElement().localBasis(),rule);
+
+        // temporaries, requested once for all quadrature points
+        std::vector<Dune::FieldVector<RF,dim> >& gradphi = scratch.get<Dune::FieldVector<RF,dim> >(0,dgspace.size(),dgspace.maxSize());
+
         // loop over quadrature points
-        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
           {
             // evaluate basis functions
-            const std::vector<RangeType>& phi = cache[order].evaluateFunction(it->position(),dgspace.finiteElement().localBasis());
+            const RangeType* phi = dgspace_basis.evaluateFunction(q);
 
             // evaluate u
             Dune::FieldVector<RF,dim+1> u(0.0);
@@ -242,11 +250,10 @@ namespace Dune {
             // std::cout << "  u at " << it->position() << " : " << u << std::endl;
 
             // evaluate gradient of basis functions (we assume Galerkin method lfsu=lfsv)
-            const std::vector<JacobianType>& js = cache[order].evaluateJacobian(it->position(),dgspace.finiteElement().localBasis());
+            const JacobianType* js = dgspace_basis.evaluateJacobian(q);
 
             // compute global gradients
             jac = eg.geometry().jacobianInverseTransposed(it->position());
-            std::vector<Dune::FieldVector<RF,dim> > gradphi(dgspace.size());
             for (size_type i=0; i<dgspace.size(); i++)
               jac.mv(js[i][0],gradphi[i]);
 
@@ -334,16 +341,23 @@ namespace Dune {
 
         // std::cout << "alpha_skeleton center=" << ig.geometry().center() << std::endl;
 
+        // values and gradients of the basis functions at all quadrature points
+        const typename Cache::Table& dgspace_s_basis =
+          cache.bind(dgspace_s.finiteElement().localBasis(),rule,ig.geometryInInside(),ig.indexInInside());
+        const typename Cache::Table& dgspace_n_basis =
+          cache.bind(dgspace_n.finiteElement().localBasis(),rule,ig.geometryInOutside(),ig.indexInOutside());
+
         // loop over quadrature points
-        for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
           {
             // position of quadrature point in local coordinates of elements
             Dune::FieldVector<DF,dim> iplocal_s = ig.geometryInInside().global(it->position());
             Dune::FieldVector<DF,dim> iplocal_n = ig.geometryInOutside().global(it->position());
 
             // evaluate basis functions
-            const std::vector<RangeType>& phi_s = cache[order_s].evaluateFunction(iplocal_s,dgspace_s.finiteElement().localBasis());
-            const std::vector<RangeType>& phi_n = cache[order_n].evaluateFunction(iplocal_n,dgspace_n.finiteElement().localBasis());
+            const RangeType* phi_s = dgspace_s_basis.evaluateFunction(q);
+            const RangeType* phi_n = dgspace_n_basis.evaluateFunction(q);
 
             // evaluate u from inside and outside
             Dune::FieldVector<RF,dim+1> u_s(0.0);
@@ -441,14 +455,19 @@ namespace Dune {
 
         // std::cout << "alpha_boundary center=" << ig.geometry().center() << std::endl;
 
+        // values and gradients of the basis functions at all quadrature points
+        const typename Cache::Table& dgspace_s_basis =
+          cache.bind(dgspace_s.finiteElement().localBasis(),rule,ig.geometryInInside(),ig.indexInInside());
+
         // loop over quadrature points
-        for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
           {
             // position of quadrature point in local coordinates of elements
             Dune::FieldVector<DF,dim> iplocal_s = ig.geometryInInside().global(it->position());
 
             // evaluate basis functions
-            const std::vector<RangeType>& phi_s = cache[order_s].evaluateFunction(iplocal_s,dgspace_s.finiteElement().localBasis());
+            const RangeType* phi_s = dgspace_s_basis.evaluateFunction(q);
 
             // evaluate u from inside and outside
             Dune::FieldVector<RF,dim+1> u_s(0.0);
@@ -503,14 +522,18 @@ namespace Dune {
         Dune::GeometryType gt = eg.geometry().type();
         const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,intorder);
 
+        // values and gradients of the basis functions at all quadrature points
+        const typename Cache::Table& dgspace_basis = cache.bind(dgspace.finiteElement().localBasis(),rule);
+
         // loop over quadrature points
-        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
           {
             // evaluate right hand side
             Dune::FieldVector<RF,dim+1> q(param.q(eg.entity(),it->position()));
 
             // evaluate basis functions
-            const std::vector<RangeType>& phi = cache[order_s].evaluateFunction(it->position(),dgspace.finiteElement().localBasis());
+            const RangeType* phi = dgspace_basis.evaluateFunction(q);
 
             // integrate
             RF factor = it->weight() * eg.geometry().integrationElement(it->position());
@@ -551,8 +574,9 @@ namespace Dune {
       T& param;
       int overintegration;
       typedef typename FEM::Traits::FiniteElementType::Traits::LocalBasisType LocalBasisType;
-      typedef Dune::PDELab::LocalBasisCache<LocalBasisType> Cache;
-      std::vector<Cache> cache;
+      typedef Dune::PDELab::LocalBasisQuadratureCache<LocalBasisType> Cache;
+      Cache cache;
+      mutable LocalOperatorScratch scratch;
     };
 
 
@@ -578,7 +602,7 @@ namespace Dune {
       enum { doAlphaVolume = true };
 
       DGLinearAcousticsTemporalOperator (T& param_, int overintegration_=0)
-        : param(param_), overintegration(overintegration_), cache(20)
+        : param(param_), overintegration(overintegration_)
       {}
 
       // define sparsity pattern of operator representation
@@ -621,11 +645,15 @@ namespace Dune {
         Dune::GeometryType gt = eg.geometry().type();
         const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,intorder);
 
+        // values and gradients of the basis functions at all quadrature points
+        const typename Cache::Table& dgspace_basis = cache.bind(dgspace.finiteElement().localBasis(),rule);
+
         // loop over quadrature points
-        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
           {
             // evaluate basis functions
-            const std::vector<RangeType>& phi = cache[order].evaluateFunction(it->position(),dgspace.finiteElement().localBasis());
+            const RangeType* phi = dgspace_basis.evaluateFunction(q);
 
             // evaluate u
             Dune::FieldVector<RF,dim+1> u(0.0);
@@ -665,11 +693,15 @@ namespace Dune {
         Dune::GeometryType gt = eg.geometry().type();
         const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,intorder);
 
+        // values and gradients of the basis functions at all quadrature points
+        const typename Cache::Table& dgspace_basis = cache.bind(dgspace.finiteElement().localBasis(),rule);
+
         // loop over quadrature points
-        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
+        size_type q = 0;
+        for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it, ++q)
           {
             // evaluate basis functions
-            const std::vector<RangeType>& phi = cache[order].evaluateFunction(it->position(),dgspace.finiteElement().localBasis());
+            const RangeType* phi = dgspace_basis.evaluateFunction(q);
 
             // integrate
             RF factor = it->weight() * eg.geometry().integrationElement(it->position());
@@ -684,8 +716,8 @@ namespace Dune {
       T& param;
       int overintegration;
       typedef typename FEM::Traits::FiniteElementType::Traits::LocalBasisType LocalBasisType;
-      typedef Dune::PDELab::LocalBasisCache<LocalBasisType> Cache;
-      std::vector<Cache> cache;
+      typedef Dune::PDELab::LocalBasisQuadratureCache<LocalBasisType> Cache;
+      Cache cache;
     };
 
   }
@@ -16,6 +16,7 @@
 #include "pattern.hh"
 #include "flags.hh"
 #include "idefault.hh"
+#include "scratch.hh"
 
 #include "linearelasticityparameter.hh"
 
@@ -53,6 +54,9 @@ namespace Dune {
       enum { doLambdaVolume = true };
       enum { doLambdaBoundary = true };
 
+      // volume terms can be evaluated on batches of cells
+      enum { doAlphaVolumeBatch = true };
+
       LinearElasticity (const ParameterType & p, int intorder=4)
         : intorder_(intorder), param_(p)
       {}
@@ -82,17 +86,19 @@ namespace Dune {
         GeometryType gt = eg.geometry().type();
         const QuadratureRule<DF,dim>& rule = QuadratureRules<DF,dim>::rule(gt,intorder_);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<JacobianType>& js = scratch.get<JacobianType>(0,lfsu.child(0).size(),lfsu.child(0).maxSize());
+        std::vector<FieldVector<RF,dim> >& gradphi = scratch.get<FieldVector<RF,dim> >(1,lfsu.child(0).size(),lfsu.child(0).maxSize());
+
         // loop over quadrature points
         for (typename QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
         {
           // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
-          std::vector<JacobianType> js(lfsu.child(0).size());
           lfsu.child(0).finiteElement().localBasis().evaluateJacobian(it->position(),js);
 
           // transform gradient to real element
           const typename EG::Geometry::JacobianInverseTransposed jac
-            = eg.geometry().jacobianInverseTransposed(it->position());
-          std::vector<FieldVector<RF,dim> > gradphi(lfsu.child(0).size());
+            = eg.jacobianInverseTransposed(it->position());
           for (size_type i=0; i<lfsu.child(0).size(); i++)
           {
             gradphi[i] = 0.0;
@@ -104,7 +110,7 @@ namespace Dune {
           RF lambda = param_.lambda(eg.entity(),it->position());
 
           // geometric weight
-          RF factor = it->weight() * eg.geometry().integrationElement(it->position());
+          RF factor = it->weight() * eg.integrationElement(it->position());
 
           for(int d=0; d<dim; ++d)
           {
@@ -160,17 +166,19 @@ namespace Dune {
         GeometryType gt = eg.geometry().type();
         const QuadratureRule<DF,dim>& rule = QuadratureRules<DF,dim>::rule(gt,intorder_);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<JacobianType>& js = scratch.get<JacobianType>(0,lfsu_hat.child(0).size(),lfsu_hat.child(0).maxSize());
+        std::vector<FieldVector<RF,dim> >& gradphi = scratch.get<FieldVector<RF,dim> >(1,lfsu_hat.child(0).size(),lfsu_hat.child(0).maxSize());
+
         // loop over quadrature points
         for (typename QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
         {
           // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
-          std::vector<JacobianType> js(lfsu_hat.child(0).size());
           lfsu_hat.child(0).finiteElement().localBasis().evaluateJacobian(it->position(),js);
 
           // transform gradient to real element
           const typename EG::Geometry::JacobianInverseTransposed jac
-            = eg.geometry().jacobianInverseTransposed(it->position());
-          std::vector<FieldVector<RF,dim> > gradphi(lfsu_hat.child(0).size());
+            = eg.jacobianInverseTransposed(it->position());
           for (size_type i=0; i<lfsu_hat.child(0).size(); i++)
           {
             gradphi[i] = 0.0;
@@ -182,7 +190,7 @@ namespace Dune {
           RF lambda = param_.lambda(eg.entity(),it->position());
 
           // geometric weight
-          RF factor = it->weight() * eg.geometry().integrationElement(it->position());
+          RF factor = it->weight() * eg.integrationElement(it->position());
 
           for(int d=0; d<dim; ++d)
           {
@@ -218,6 +226,214 @@ namespace Dune {
         }
       }
 
+      // jacobian of volume term on a batch of cells, the cells are processed in the innermost loops
+      template<typename Batch, typename LFSU, typename X, typename LFSV, typename M>
+      void jacobian_volume_batch (const Batch& batch, const LFSU& lfsu, const X& x, const LFSV& lfsv, M & mat) const
+      {
+        // extract local function spaces
+        typedef typename LFSU::template Child<0>::Type LFSU_SUB;
+
+        // domain and range field type
+        typedef typename LFSU_SUB::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::DomainFieldType DF;
+        typedef typename LFSU_SUB::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeFieldType RF;
+        typedef typename LFSU_SUB::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::JacobianType JacobianType;
+
+        typedef typename LFSU_SUB::Traits::SizeType size_type;
+
+        // dimensions and number of cells
+        const int dim = Batch::dimension;
+        const int dimw = Batch::dimensionworld;
+        dune_static_assert(dim == dimw, "doesn't work on manifolds");
+        const std::size_t N = Batch::lanes;
+        const std::size_t n = batch.size();
+
+        // select quadrature rule
+        GeometryType gt = batch.type();
+        const QuadratureRule<DF,dim>& rule = QuadratureRules<DF,dim>::rule(gt,intorder_);
+
+        // temporaries, requested once for all quadrature points
+        std::vector<JacobianType>& js = scratch.get<JacobianType>(0,lfsu.child(0).size(),lfsu.child(0).maxSize());
+        std::vector<RF>& gradphi = scratch.get<RF>(2,lfsu.child(0).size()*dim*N,lfsu.child(0).maxSize()*dim*N);
+
+        // loop over quadrature points
+        for (typename QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
+        {
+          batch.bind(it->position());
+
+          // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
+          lfsu.child(0).finiteElement().localBasis().evaluateJacobian(it->position(),js);
+
+          // transform gradient to real elements, entry (i,d) of cell e at (i*dim+d)*N+e
+          for (size_type i=0; i<lfsu.child(0).size(); i++)
+            for (int d=0; d<dim; d++)
+            {
+              RF* g = &gradphi[(i*dim+d)*N];
+              for (std::size_t e=0; e<n; e++)
+                g[e] = 0.0;
+              for (int k=0; k<dim; k++)
+              {
+                const DF* jit = batch.jacobianInverseTransposed(d,k);
+                const RF jsk = js[i][0][k];
+                for (std::size_t e=0; e<n; e++)
+                  g[e] += jit[e]*jsk;
+              }
+            }
+
+          // material parameters and geometric weight
+          RF mu[N], lambda[N], factor[N];
+          const DF* integrationelement = batch.integrationElement();
+          for (std::size_t e=0; e<n; e++)
+          {
+            mu[e] = param_.mu(batch.element(e),it->position());
+            lambda[e] = param_.lambda(batch.element(e),it->position());
+            factor[e] = it->weight() * integrationelement[e];
+          }
+
+          for(int d=0; d<dim; ++d)
+          {
+            for (size_type i=0; i<lfsu.child(0).size(); i++)
+            {
+              for (int k=0; k<dim; k++)
+              {
+                for (size_type j=0; j<lfsv.child(k).size(); j++)
+                {
+                  const RF* gi_d = &gradphi[(i*dim+d)*N];
+                  const RF* gi_k = &gradphi[(i*dim+k)*N];
+                  const RF* gj_d = &gradphi[(j*dim+d)*N];
+                  const RF* gj_k = &gradphi[(j*dim+k)*N];
+                  // integrate \mu (grad u + (grad u)^T) * (grad phi_i + (grad phi_i)^T)
+                  typename M::value_type* m_kk = mat(lfsv.child(k),j,lfsu.child(k),i);
+                  for (std::size_t e=0; e<n; e++)
+                    // mu (d u_k / d x_d) (d v_k / d x_d)
+                    m_kk[e] += mu[e] * gi_d[e] * gj_d[e] * factor[e];
+                  typename M::value_type* m_kd = mat(lfsv.child(k),j,lfsu.child(d),i);
+                  for (std::size_t e=0; e<n; e++)
+                  {
+                    // mu (d u_d / d x_k) (d v_k / d x_d)
+                    m_kd[e] += mu[e] * gi_k[e] * gj_d[e] * factor[e];
+                    // integrate \lambda sum_(k=0..dim) (d u_d / d x_d) * (d v_k / d x_k)
+                    m_kd[e] += lambda[e] * gi_d[e] * gj_k[e] * factor[e];
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+
+      // volume integral on a batch of cells
+      template<typename Batch, typename LFSU_HAT, typename X, typename LFSV, typename R>
+      void alpha_volume_batch (const Batch& batch, const LFSU_HAT& lfsu_hat, const X& x, const LFSV& lfsv, R& r) const
+      {
+        // extract local function spaces
+        typedef typename LFSU_HAT::template Child<0>::Type LFSU;
+
+        // domain and range field type
+        typedef typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::DomainFieldType DF;
+        typedef typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeFieldType RF;
+        typedef typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::JacobianType JacobianType;
+
+        typedef typename LFSU::Traits::SizeType size_type;
+
+        // dimensions and number of cells
+        const int dim = Batch::dimension;
+        const int dimw = Batch::dimensionworld;
+        dune_static_assert(dim == dimw, "doesn't work on manifolds");
+        const std::size_t N = Batch::lanes;
+        const std::size_t n = batch.size();
+
+        // select quadrature rule
+        GeometryType gt = batch.type();
+        const QuadratureRule<DF,dim>& rule = QuadratureRules<DF,dim>::rule(gt,intorder_);
+
+        // temporaries, requested once for all quadrature points
+        std::vector<JacobianType>& js = scratch.get<JacobianType>(0,lfsu_hat.child(0).size(),lfsu_hat.child(0).maxSize());
+        std::vector<RF>& gradphi = scratch.get<RF>(2,lfsu_hat.child(0).size()*dim*N,lfsu_hat.child(0).maxSize()*dim*N);
+
+        // loop over quadrature points
+        for (typename QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
+        {
+          batch.bind(it->position());
+
+          // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
+          lfsu_hat.child(0).finiteElement().localBasis().evaluateJacobian(it->position(),js);
+
+          // transform gradient to real elements, entry (i,d) of cell e at (i*dim+d)*N+e
+          for (size_type i=0; i<lfsu_hat.child(0).size(); i++)
+            for (int d=0; d<dim; d++)
+            {
+              RF* g = &gradphi[(i*dim+d)*N];
+              for (std::size_t e=0; e<n; e++)
+                g[e] = 0.0;
+              for (int k=0; k<dim; k++)
+              {
+                const DF* jit = batch.jacobianInverseTransposed(d,k);
+                const RF jsk = js[i][0][k];
+                for (std::size_t e=0; e<n; e++)
+                  g[e] += jit[e]*jsk;
+              }
+            }
+
+          // material parameters and geometric weight
+          RF mu[N], lambda[N], factor[N];
+          const DF* integrationelement = batch.integrationElement();
+          for (std::size_t e=0; e<n; e++)
+          {
+            mu[e] = param_.mu(batch.element(e),it->position());
+            lambda[e] = param_.lambda(batch.element(e),it->position());
+            factor[e] = it->weight() * integrationelement[e];
+          }
+
+          for(int d=0; d<dim; ++d)
+          {
+            const LFSU & lfsu = lfsu_hat.child(d);
+
+            // compute gradient of u
+            RF gradu[dim][N];
+            for (int k=0; k<dim; k++)
+              for (std::size_t e=0; e<n; e++)
+                gradu[k][e] = 0.0;
+            for (size_t i=0; i<lfsu.size(); i++)
+            {
+              const typename X::value_type* xi = x(lfsu,i);
+              for (int k=0; k<dim; k++)
+              {
+                const RF* g = &gradphi[(i*dim+k)*N];
+                for (std::size_t e=0; e<n; e++)
+                  gradu[k][e] += xi[e]*g[e];
+              }
+            }
+
+            for (size_type i=0; i<lfsv.child(d).size(); i++)
+            {
+              const RF* gi_d = &gradphi[(i*dim+d)*N];
+              for (int k=0; k<dim; k++)
+              {
+                const RF* gi_k = &gradphi[(i*dim+k)*N];
+                typename R::value_type* r_d = r(lfsv.child(d),i);
+                typename R::value_type* r_k = r(lfsv.child(k),i);
+                for (std::size_t e=0; e<n; e++)
+                {
+                  // integrate \mu (grad u + (grad u)^T) * (grad phi_i + (grad phi_i)^T)
+                  // mu (d u_d / d x_k) (d phi_i_d / d x_k)
+                  r_d[e] += mu[e] * gradu[k][e] * gi_k[e] * factor[e];
+                  // mu (d u_d / d x_k) (d phi_i_k / d x_d)
+                  r_k[e] += mu[e] * gradu[k][e] * gi_d[e] * factor[e];
+                  // integrate \lambda sum_(k=0..dim) (d u / d x_d) * (d phi_i / d x_k)
+                  r_k[e] += lambda[e] * gradu[d][e] * gi_k[e] * factor[e];
+                }
+              }
+            }
+          }
+        }
+      }
+
       // volume integral depending only on test functions
       template<typename EG, typename LFSV_HAT, typename R>
       void lambda_volume (const EG& eg, const LFSV_HAT& lfsv_hat, R& r) const
@@ -242,11 +458,13 @@ namespace Dune {
         GeometryType gt = eg.geometry().type();
         const QuadratureRule<DF,dim>& rule = QuadratureRules<DF,dim>::rule(gt,intorder_);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<RangeType>& phi = scratch.get<RangeType>(0,lfsv_hat.child(0).size(),lfsv_hat.child(0).maxSize());
+
         // loop over quadrature points
         for (typename QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
         {
           // evaluate shape functions
-          std::vector<RangeType> phi(lfsv_hat.child(0).size());
           lfsv_hat.child(0).finiteElement().localBasis().evaluateFunction(it->position(),phi);
 
           // evaluate right hand side parameter function
@@ -254,7 +472,7 @@ namespace Dune {
           param_.f(eg.entity(),it->position(),y);
 
           // weight
-          RF factor = it->weight() * eg.geometry().integrationElement(it->position());
+          RF factor = it->weight() * eg.integrationElement(it->position());
 
           for(int d=0; d<dim; ++d)
           {
@@ -291,6 +509,9 @@ namespace Dune {
         GeometryType gt = ig.geometry().type();
         const QuadratureRule<DF,dim-1>& rule = QuadratureRules<DF,dim-1>::rule(gt,intorder_);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<RangeType>& phi = scratch.get<RangeType>(0,lfsv_hat.child(0).size(),lfsv_hat.child(0).maxSize());
+
         // loop over quadrature points
         for (typename QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
         {
@@ -303,7 +524,6 @@ namespace Dune {
             continue;
 
           // evaluate shape functions
-          std::vector<RangeType> phi(lfsv_hat.child(0).size());
           lfsv_hat.child(0).finiteElement().localBasis().evaluateFunction(local,phi);
 
           // evaluate surface force
@@ -312,7 +532,7 @@ namespace Dune {
           // param_.g(eg.entity(),it->position(),y);
 
           // weight
-          RF factor = it->weight() * ig.geometry().integrationElement(it->position());
+          RF factor = it->weight() * ig.integrationElement(it->position());
 
           for(int d=0; d<dim; ++d)
           {
@@ -328,6 +548,7 @@ namespace Dune {
     protected:
       int intorder_;
       const ParameterType & param_;
+      mutable LocalOperatorScratch scratch;
     };
 
     //! \} group LocalOperator
@@ -21,6 +21,7 @@
 #include"idefault.hh"
 #include"pattern.hh"
 #include"flags.hh"
+#include"scratch.hh"
 
 namespace Dune {
   namespace PDELab {
@@ -109,12 +110,14 @@ namespace Dune {
         const Dune::QuadratureRule<DF,dimLocal>& rule =
           Dune::QuadratureRules<DF,dimLocal>::rule(gt,quadOrder_);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<Range>& phi = scratch.get<Range>(0,lfsv.size(),lfsv.maxSize());
+
         // loop over quadrature points
         for (typename Dune::QuadratureRule<DF,dimLocal>::const_iterator it =
                rule.begin(); it!=rule.end(); ++it)
           {
             // evaluate shape functions
-            std::vector<Range> phi(lfsv.size());
             FESwitch::basis(lfsv.finiteElement()).
               evaluateFunction(it->position(),phi);
 
@@ -153,6 +156,9 @@ namespace Dune {
         const Dune::QuadratureRule<DF,dimLocal>& rule =
           Dune::QuadratureRules<DF,dimLocal>::rule(gtface,quadOrder_);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<Range>& phi = scratch.get<Range>(0,lfsv.size(),lfsv.maxSize());
+
         // loop over quadrature points and integrate normal flux
         for (typename Dune::QuadratureRule<DF,dimLocal>::const_iterator it =
                rule.begin(); it!=rule.end(); ++it)
@@ -167,7 +173,6 @@ namespace Dune {
               ig.geometryInInside().global(it->position());
 
             // evaluate test shape functions
-            std::vector<Range> phi(lfsv.size());
             FESwitch::basis(lfsv.finiteElement()).evaluateFunction(local,phi);
 
             // evaluate flux boundary condition
@@ -239,6 +244,9 @@ namespace Dune {
         j.setTime(t);
         IDefault::setTime(t);
       }
+
+    private:
+      mutable LocalOperatorScratch scratch;
     };
 
     //! \} group LocalOperator
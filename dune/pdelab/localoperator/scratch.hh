@@ -0,0 +1,108 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_LOCALOPERATOR_SCRATCH_HH
+#define DUNE_PDELAB_LOCALOPERATOR_SCRATCH_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <typeinfo>
+#include <vector>
+
+#include <dune/common/shared_ptr.hh>
+
+#include <dune/pdelab/common/threadlocal.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! \addtogroup LocalOperator
+    //! \ingroup PDELab
+    //! \{
+
+    //! Reusable temporary storage for the methods of a local operator.
+    /**
+     * Local operators need a number of temporary arrays per element or intersection,
+     * e.g. for the transformed gradients of the basis functions. Allocating those as
+     * local std::vectors causes heap traffic in every call. Instead, an operator holds
+     * a mutable LocalOperatorScratch and requests its temporaries from it:
+     *
+     * \code
+     * std::vector<Dune::FieldVector<RF,dim> >& gradphi =
+     *   scratch.get<Dune::FieldVector<RF,dim> >(0,lfsu.size(),lfsu.maxSize());
+     * \endcode
+     *
+     * Each array is identified by its entry type and a slot number, which has to be unique
+     * among the arrays of the same type that are used at the same time. The first request
+     * reserves storage for the given capacity, usually the maxSize() of the local function
+     * space, so later requests only adjust the size of the array and never allocate.
+     * The contents of an array are unspecified after get().
+     *
+     * Every OpenMP thread uses its own set of arrays (see ThreadLocal), so an operator
+     * holding a scratch object can still be called concurrently as in the colored mode of
+     * DefaultAssembler. Copies of a scratch object do not share any storage.
+     */
+    class LocalOperatorScratch
+    {
+
+      struct Entry
+      {
+        const std::type_info* type;
+        std::size_t slot;
+        shared_ptr<void> data;
+      };
+
+      typedef std::vector<Entry> ThreadStorage;
+
+    public:
+
+      //! Returns the array of type T in the given slot, resized to n entries.
+      /**
+       * \param slot      Slot number of the array.
+       * \param n         Requested number of entries.
+       * \param capacity  Storage reserved when the array is created.
+       */
+      template<typename T>
+      std::vector<T>& get(std::size_t slot, std::size_t n, std::size_t capacity = 0) const
+      {
+        std::vector<T>& v = lookup<T>(slot,std::max(n,capacity));
+        v.resize(n);
+        return v;
+      }
+
+      //! Releases the storage of all threads.
+      void clear()
+      {
+        for (std::size_t t = 0; t < _threads.size(); ++t)
+          _threads[t].clear();
+      }
+
+    private:
+
+      template<typename T>
+      std::vector<T>& lookup(std::size_t slot, std::size_t capacity) const
+      {
+        ThreadStorage& storage = _threads.local();
+        for (ThreadStorage::iterator it = storage.begin(); it != storage.end(); ++it)
+          if (it->slot == slot && *it->type == typeid(T))
+            return *static_cast<std::vector<T>*>(it->data.get());
+
+        shared_ptr<std::vector<T> > v = make_shared<std::vector<T> >();
+        v->reserve(capacity);
+        Entry entry;
+        entry.type = &typeid(T);
+        entry.slot = slot;
+        entry.data = v;
+        storage.push_back(entry);
+        return *v;
+      }
+
+      ThreadLocal<ThreadStorage> _threads;
+
+    };
+
+    //! \} group LocalOperator
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_LOCALOPERATOR_SCRATCH_HH
@@ -15,6 +15,7 @@
 #include "defaultimp.hh"
 #include "pattern.hh"
 #include "flags.hh"
+#include "scratch.hh"
 #include "stokesdgparameter.hh"
 
 #ifndef VBLOCK
@@ -131,6 +132,10 @@ namespace Dune {
 
                 const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,qorder);
 
+                // temporaries, requested once for all quadrature points
+                std::vector<RT>& phi_v = scratch.get<RT>(0,vsize);
+                std::vector<RT>& phi_p = scratch.get<RT>(1,psize);
+
                 // loop over quadrature points
                 for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
                 {
@@ -138,11 +143,9 @@ namespace Dune {
                     //const Dune::FieldVector<DF,dimw> global = eg.geometry().global(local);
 
                     // values of velocity shape functions
-                    std::vector<RT> phi_v(vsize);
                     FESwitch_V::basis(lfsv_v.finiteElement()).evaluateFunction(local,phi_v);
 
                     // values of pressure shape functions
-                    std::vector<RT> phi_p(psize);
                     FESwitch_P::basis(lfsv_p.finiteElement()).evaluateFunction(local,phi_p);
 
                     const RF weight = it->weight() * eg.geometry().integrationElement(it->position());
@@ -222,6 +225,11 @@ namespace Dune {
                 const int epsilon = prm.epsilonIPSymmetryFactor();
                 const RF incomp_scaling = prm.incompressibilityScaling(current_dt);
 
+                // temporaries, requested once for all quadrature points
+                std::vector<RT>& phi_v = scratch.get<RT>(0,vsize);
+                std::vector<RT>& phi_p = scratch.get<RT>(1,psize);
+                std::vector<Dune::FieldMatrix<RF,1,dim> >& grad_phi_v = scratch.get<Dune::FieldMatrix<RF,1,dim> >(2,vsize);
+
                 // loop over quadrature points and integrate normal flux
                 for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
                 {
@@ -233,13 +241,10 @@ namespace Dune {
                     const RF penalty_factor = prm.getFaceIP(ig,flocal);
 
                     // value of velocity shape functions
-                    std::vector<RT> phi_v(vsize);
                     FESwitch_V::basis(lfsv_v.finiteElement()).evaluateFunction(local,phi_v);
                     // and value of pressure shape functions
-                    std::vector<RT> phi_p(psize);
                     FESwitch_P::basis(lfsv_p.finiteElement()).evaluateFunction(local,phi_p);
 
-                    std::vector<Dune::FieldMatrix<RF,1,dim> > grad_phi_v(vsize);
                     BasisSwitch_V::gradient(FESwitch_V::basis(lfsv_v.finiteElement()),
                                           ig.inside()->geometry(), local, grad_phi_v);
 
@@ -365,6 +370,10 @@ namespace Dune {
 
                 const RF incomp_scaling = prm.incompressibilityScaling(current_dt);
 
+                // temporaries, requested once for all quadrature points
+                std::vector<RT>& phi_p = scratch.get<RT>(0,psize);
+                std::vector<Dune::FieldMatrix<RF,1,dim> >& grad_phi_v = scratch.get<Dune::FieldMatrix<RF,1,dim> >(1,vsize);
+
                 // loop over quadrature points
                 for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
                 {
@@ -372,11 +381,9 @@ namespace Dune {
                     const RF mu = prm.mu(eg,local);
 
                     // and value of pressure shape functions
-                    std::vector<RT> phi_p(psize);
                     FESwitch_P::basis(lfsv_p.finiteElement()).evaluateFunction(local,phi_p);
 
                     // compute gradients
-                    std::vector<Dune::FieldMatrix<RF,1,dim> > grad_phi_v(vsize);
                     BasisSwitch_V::gradient(FESwitch_V::basis(lfsv_v.finiteElement()),
                                             eg.geometry(), local, grad_phi_v);
 
@@ -485,6 +492,14 @@ namespace Dune {
                 const int epsilon = prm.epsilonIPSymmetryFactor();
                 const RF incomp_scaling = prm.incompressibilityScaling(current_dt);
 
+                // temporaries, requested once for all quadrature points
+                std::vector<RT>& phi_v_s = scratch.get<RT>(0,vsize_s);
+                std::vector<RT>& phi_v_n = scratch.get<RT>(1,vsize_n);
+                std::vector<RT>& phi_p_s = scratch.get<RT>(2,psize_s);
+                std::vector<RT>& phi_p_n = scratch.get<RT>(3,psize_n);
+                std::vector<Dune::FieldMatrix<RF,1,dim> >& grad_phi_v_s = scratch.get<Dune::FieldMatrix<RF,1,dim> >(4,vsize_s);
+                std::vector<Dune::FieldMatrix<RF,1,dim> >& grad_phi_v_n = scratch.get<Dune::FieldMatrix<RF,1,dim> >(5,vsize_n);
+
                 // loop over quadrature points and integrate normal flux
                 for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
                 {
@@ -496,22 +511,16 @@ namespace Dune {
                     const RF penalty_factor = prm.getFaceIP(ig,it->position());
 
                     // value of velocity shape functions
-                    std::vector<RT> phi_v_s(vsize_s);
-                    std::vector<RT> phi_v_n(vsize_n);
                     FESwitch_V::basis(lfsv_s_v.finiteElement()).evaluateFunction(local_s,phi_v_s);
                     FESwitch_V::basis(lfsv_n_v.finiteElement()).evaluateFunction(local_n,phi_v_n);
                     // and value of pressure shape functions
-                    std::vector<RT> phi_p_s(psize_s);
-                    std::vector<RT> phi_p_n(psize_n);
                     FESwitch_P::basis(lfsv_s_p.finiteElement()).evaluateFunction(local_s,phi_p_s);
                     FESwitch_P::basis(lfsv_n_p.finiteElement()).evaluateFunction(local_n,phi_p_n);
 
                     // compute gradients
-                    std::vector<Dune::FieldMatrix<RF,1,dim> > grad_phi_v_s(vsize_s);
                     BasisSwitch_V::gradient(FESwitch_V::basis(lfsv_s_v.finiteElement()),
                                             ig.inside()->geometry(), local_s, grad_phi_v_s);
 
-                    std::vector<Dune::FieldMatrix<RF,1,dim> > grad_phi_v_n(vsize_n);
                     BasisSwitch_V::gradient(FESwitch_V::basis(lfsv_n_v.finiteElement()),
                                             ig.outside()->geometry(), local_n, grad_phi_v_n);
 
@@ -776,6 +785,11 @@ namespace Dune {
                 const int epsilon = prm.epsilonIPSymmetryFactor();
                 const RF incomp_scaling = prm.incompressibilityScaling(current_dt);
 
+                // temporaries, requested once for all quadrature points
+                std::vector<RT>& phi_v = scratch.get<RT>(0,vsize);
+                std::vector<RT>& phi_p = scratch.get<RT>(1,psize);
+                std::vector<Dune::FieldMatrix<RF,1,dim> >& grad_phi_v = scratch.get<Dune::FieldMatrix<RF,1,dim> >(2,vsize);
+
                 // loop over quadrature points and integrate normal flux
                 for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
                 {
@@ -785,13 +799,10 @@ namespace Dune {
                     const RF penalty_factor = prm.getFaceIP(ig,it->position() );
 
                     // value of velocity shape functions
-                    std::vector<RT> phi_v(vsize);
                     FESwitch_V::basis(lfsv_v.finiteElement()).evaluateFunction(local,phi_v);
                     // and value of pressure shape functions
-                    std::vector<RT> phi_p(psize);
                     FESwitch_P::basis(lfsv_p.finiteElement()).evaluateFunction(local,phi_p);
 
-                    std::vector<Dune::FieldMatrix<RF,1,dim> > grad_phi_v(vsize);
                     BasisSwitch_V::gradient(FESwitch_V::basis(lfsv_v.finiteElement()),
                                           ig.inside()->geometry(), local, grad_phi_v);
 
@@ -940,6 +951,7 @@ namespace Dune {
           PRM & prm;                  // Parameter class for this local operator
           int superintegration_order; // Quadrature order
           Real current_dt;
+          mutable LocalOperatorScratch scratch;
         };
 
 
@@ -1010,6 +1022,10 @@ namespace Dune {
                 const int qorder = 3*v_order - 1 + jac_order + det_jac_order + superintegration_order;
                 const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,qorder);
 
+                // temporaries, requested once for all quadrature points
+                std::vector<RT>& phi_v = scratch.get<RT>(0,vsize);
+                std::vector<Dune::FieldMatrix<RF,1,dim> >& grad_phi_v = scratch.get<Dune::FieldMatrix<RF,1,dim> >(1,vsize);
+
                 // loop over quadrature points
                 for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
                     {
@@ -1020,11 +1036,9 @@ namespace Dune {
                         if(rho == 0) continue;
 
                         // and value of pressure shape functions
-                        std::vector<RT> phi_v(vsize);
                         FESwitch_V::basis(lfsv_v.finiteElement()).evaluateFunction(local,phi_v);
 
                         // compute gradients
-                        std::vector<Dune::FieldMatrix<RF,1,dim> > grad_phi_v(vsize);
                         BasisSwitch_V::gradient(FESwitch_V::basis(lfsv_v.finiteElement()),
                                                 eg.geometry(), local, grad_phi_v);
 
@@ -1106,6 +1120,10 @@ namespace Dune {
                 const int qorder = 3*v_order - 1 + jac_order + det_jac_order + superintegration_order;
                 const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,qorder);
 
+                // temporaries, requested once for all quadrature points
+                std::vector<RT>& phi_v = scratch.get<RT>(0,vsize);
+                std::vector<Dune::FieldMatrix<RF,1,dim> >& grad_phi_v = scratch.get<Dune::FieldMatrix<RF,1,dim> >(1,vsize);
+
                 // loop over quadrature points
                 for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
                     {
@@ -1116,11 +1134,9 @@ namespace Dune {
                         if(rho == 0) continue;
 
                         // and value of pressure shape functions
-                        std::vector<RT> phi_v(vsize);
                         FESwitch_V::basis(lfsv_v.finiteElement()).evaluateFunction(local,phi_v);
 
                         // compute gradients
-                        std::vector<Dune::FieldMatrix<RF,1,dim> > grad_phi_v(vsize);
                         BasisSwitch_V::gradient(FESwitch_V::basis(lfsv_v.finiteElement()),
                                                 eg.geometry(), local, grad_phi_v);
 
@@ -1152,6 +1168,9 @@ namespace Dune {
                     }
             }
 
+
+        private:
+          mutable LocalOperatorScratch scratch;
         };
 
         /** \brief A local operator for solving the stokes equation using a DG discretization
@@ -1227,13 +1246,15 @@ namespace Dune {
                 const int qorder = 2*v_order + det_jac_order + superintegration_order;
                 const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,qorder);
 
+                // temporaries, requested once for all quadrature points
+                std::vector<RT>& psi_v = scratch.get<RT>(0,vsize);
+
                 // loop over quadrature points
                 for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
                 {
                     const Dune::FieldVector<DF,dim> local = it->position();
 
                     // and value of pressure shape functions
-                    std::vector<RT> psi_v(vsize);
                     FESwitch_V::basis(lfsv_v.finiteElement()).evaluateFunction(local,psi_v);
 
                     const RF rho = prm.rho(eg,local);
@@ -1262,6 +1283,7 @@ namespace Dune {
         protected:
           PRM & prm;                  // Parameter class for this local operator
           int superintegration_order; // Quadrature order
+          mutable LocalOperatorScratch scratch;
         };
 
         //! \} group GridFunctionSpace
@@ -16,6 +16,7 @@
 #include "pattern.hh"
 #include "flags.hh"
 #include "stokesdg.hh"
+#include "scratch.hh"
 
 #ifndef VBLOCK
 #define VBLOCK 0
@@ -162,6 +163,12 @@ namespace Dune {
         Dune::GeometryType gt = eg.geometry().type();
         const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,qorder);
 
+        // temporaries, requested once for all quadrature points
+        std::vector<Range_V>& phi_v = scratch.get<Range_V>(0,lfsv_v.size(),lfsv_v.maxSize());
+        std::vector<Range_P>& phi_p = scratch.get<Range_P>(1,lfsv_p.size(),lfsv_p.maxSize());
+        std::vector<Dune::FieldMatrix<RF,dim,dim> >& jac_phi_v = scratch.get<Dune::FieldMatrix<RF,dim,dim> >(2,lfsu_v.size(),lfsu_v.maxSize());
+        std::vector<RF>& div_phi_v = scratch.get<RF>(0,lfsv_v.size(),lfsv_v.maxSize());
+
         // loop over quadrature points
         for (typename Dune::QuadratureRule<DF,dim>::const_iterator it=rule.begin(); it!=rule.end(); ++it)
           {
@@ -171,20 +178,17 @@ namespace Dune {
             const RF weight = it->weight() * eg.geometry().integrationElement(it->position());
 
             // values of velocity shape functions
-            std::vector<Range_V> phi_v(lfsv_v.size());
             FESwitch_V::basis(lfsv_v.finiteElement()).evaluateFunction(local,phi_v);
 
             // values of velocity shape functions
-            std::vector<Range_P> phi_p(lfsv_p.size());
             FESwitch_P::basis(lfsv_p.finiteElement()).evaluateFunction(local,phi_p);
 
             // evaluate jacobian of basis functions on reference element
-            std::vector<Dune::FieldMatrix<RF,dim,dim> > jac_phi_v(lfsu_v.size());
             VectorBasisSwitch_V::jacobian
               (FESwitch_V::basis(lfsv_v.finiteElement()), eg.geometry(), it->position(), jac_phi_v);
 
             // compute divergence of test functions
-            std::vector<RF> div_phi_v(lfsv_v.size(),0.0);
+            std::fill(div_phi_v.begin(),div_phi_v.end(),0.0);
             for (size_type i=0; i<lfsv_v.size(); i++)
               for (size_type d=0; d<dim; d++)
                 div_phi_v[i] += jac_phi_v[i][d][d];
@@ -281,6 +285,16 @@ namespace Dune {
         const typename IG::EntityPointer self = ig.inside();
         const typename IG::EntityPointer neighbor = ig.outside();
 
+        // temporaries, requested once for all quadrature points
+        std::vector<Range_V>& phi_v_s = scratch.get<Range_V>(0,lfsv_v_s.size(),lfsv_v_s.maxSize());
+        std::vector<Range_V>& phi_v_n = scratch.get<Range_V>(1,lfsv_v_n.size(),lfsv_v_n.maxSize());
+        std::vector<Range_P>& phi_p_s = scratch.get<Range_P>(2,lfsv_p_s.size(),lfsv_p_s.maxSize());
+        std::vector<Range_P>& phi_p_n = scratch.get<Range_P>(3,lfsv_p_n.size(),lfsv_p_n.maxSize());
+        std::vector<Dune::FieldMatrix<RF,dim,dim> >& jac_phi_v_s = scratch.get<Dune::FieldMatrix<RF,dim,dim> >(4,lfsu_v_s.size(),lfsu_v_s.maxSize());
+        std::vector<Dune::FieldMatrix<RF,dim,dim> >& jac_phi_v_n = scratch.get<Dune::FieldMatrix<RF,dim,dim> >(5,lfsu_v_n.size(),lfsu_v_n.maxSize());
+        std::vector<RF>& div_phi_v_s = scratch.get<RF>(0,lfsv_v_s.size(),lfsv_v_s.maxSize());
+        std::vector<RF>& div_phi_v_n = scratch.get<RF>(1,lfsv_v_s.size(),lfsv_v_s.maxSize());
+
         // loop over quadrature points
         for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it){
 
@@ -291,28 +305,22 @@ namespace Dune {
           const RF weight = it->weight() * ig.geometry().integrationElement(it->position());
 
           // values of velocity shape functions
-          std::vector<Range_V> phi_v_s(lfsv_v_s.size());
-          std::vector<Range_V> phi_v_n(lfsv_v_n.size());
           FESwitch_V::basis(lfsv_v_s.finiteElement()).evaluateFunction(local_s,phi_v_s);
           FESwitch_V::basis(lfsv_v_n.finiteElement()).evaluateFunction(local_n,phi_v_n);
 
           // values of velocity shape functions
-          std::vector<Range_P> phi_p_s(lfsv_p_s.size());
-          std::vector<Range_P> phi_p_n(lfsv_p_n.size());
           FESwitch_P::basis(lfsv_p_s.finiteElement()).evaluateFunction(local_s,phi_p_s);
           FESwitch_P::basis(lfsv_p_n.finiteElement()).evaluateFunction(local_n,phi_p_n);
 
           // evaluate jacobian of basis functions on reference element
-          std::vector<Dune::FieldMatrix<RF,dim,dim> > jac_phi_v_s(lfsu_v_s.size());
-          std::vector<Dune::FieldMatrix<RF,dim,dim> > jac_phi_v_n(lfsu_v_n.size());
           VectorBasisSwitch_V::jacobian
             (FESwitch_V::basis(lfsv_v_s.finiteElement()), ig.inside()->geometry(), local_s, jac_phi_v_s);
           VectorBasisSwitch_V::jacobian
             (FESwitch_V::basis(lfsv_v_n.finiteElement()), ig.outside()->geometry(), local_n, jac_phi_v_n);
 
           // compute divergence of test functions
-          std::vector<RF> div_phi_v_s(lfsv_v_s.size(),0.0);
-          std::vector<RF> div_phi_v_n(lfsv_v_s.size(),0.0);
+          std::fill(div_phi_v_s.begin(),div_phi_v_s.end(),0.0);
+          std::fill(div_phi_v_n.begin(),div_phi_v_n.end(),0.0);
           for (size_type d=0; d<dim; d++){
             for (size_type i=0; i<lfsv_v_s.size(); i++)
               div_phi_v_s[i] += jac_phi_v_s[i][d][d];
@@ -449,6 +457,12 @@ namespace Dune {
 
         const typename IG::EntityPointer self = ig.inside();
 
+        // temporaries, requested once for all quadrature points
+        std::vector<Range_V>& phi_v_s = scratch.get<Range_V>(0,lfsv_v_s.size(),lfsv_v_s.maxSize());
+        std::vector<Range_P>& phi_p_s = scratch.get<Range_P>(1,lfsv_p_s.size(),lfsv_p_s.maxSize());
+        std::vector<Dune::FieldMatrix<RF,dim,dim> >& jac_phi_v_s = scratch.get<Dune::FieldMatrix<RF,dim,dim> >(2,lfsu_v_s.size(),lfsu_v_s.maxSize());
+        std::vector<RF>& div_phi_v_s = scratch.get<RF>(0,lfsv_v_s.size(),lfsv_v_s.maxSize());
+
         // loop over quadrature points
         for (typename Dune::QuadratureRule<DF,dim-1>::const_iterator it=rule.begin(); it!=rule.end(); ++it){
 
@@ -462,20 +476,17 @@ namespace Dune {
           b.evaluate(ig,it->position(),bctype);
 
           // values of velocity shape functions
-          std::vector<Range_V> phi_v_s(lfsv_v_s.size());
           FESwitch_V::basis(lfsv_v_s.finiteElement()).evaluateFunction(local_s,phi_v_s);
 
           // values of velocity shape functions
-          std::vector<Range_P> phi_p_s(lfsv_p_s.size());
           FESwitch_P::basis(lfsv_p_s.finiteElement()).evaluateFunction(local_s,phi_p_s);
 
           // evaluate jacobian of basis functions on reference element
-          std::vector<Dune::FieldMatrix<RF,dim,dim> > jac_phi_v_s(lfsu_v_s.size());
           VectorBasisSwitch_V::jacobian
             (FESwitch_V::basis(lfsv_v_s.finiteElement()), ig.inside()->geometry(), local_s, jac_phi_v_s);
 
           // compute divergence of test functions
-          std::vector<RF> div_phi_v_s(lfsv_v_s.size(),0.0);
+          std::fill(div_phi_v_s.begin(),div_phi_v_s.end(),0.0);
 
           for (size_type d=0; d<dim; d++){
             for (size_type i=0; i<lfsv_v_s.size(); i++)
@@ -593,6 +604,7 @@ namespace Dune {
       // physical parameters
       double mu;
       const IP & ip_factor;
+      mutable LocalOperatorScratch scratch;
     };
 
     //! \} group GridFunctionSpace
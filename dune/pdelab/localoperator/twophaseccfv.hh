@@ -14,6 +14,7 @@
 #include"pattern.hh"
 #include"flags.hh"
 #include"idefault.hh"
+#include"scratch.hh"
 
 namespace Dune {
   namespace PDELab {
@@ -799,7 +800,7 @@ namespace Dune {
           }
 
         // compute velocity on reference element
-        std::vector<RT0RangeType> rt0vectors(rt0fe.localBasis().size());
+        std::vector<RT0RangeType>& rt0vectors = scratch.get<RT0RangeType>(0,rt0fe.localBasis().size());
         rt0fe.localBasis().evaluateFunction(x,rt0vectors);
         typename Traits::RangeType yhat(0);
         for (unsigned int i=0; i<rt0fe.localBasis().size(); i++)
@@ -836,6 +837,7 @@ namespace Dune {
         T eps = 1E-30;
         return 2.0/(1.0/(a+eps) + 1.0/(b+eps));
       }
+      mutable LocalOperatorScratch scratch;
     };
 
     /** \brief Provide velocity field for gas phase
@@ -1031,7 +1033,7 @@ namespace Dune {
           }
 
         // compute velocity on reference element
-        std::vector<RT0RangeType> rt0vectors(rt0fe.localBasis().size());
+        std::vector<RT0RangeType>& rt0vectors = scratch.get<RT0RangeType>(0,rt0fe.localBasis().size());
         rt0fe.localBasis().evaluateFunction(x,rt0vectors);
         typename Traits::RangeType yhat(0);
         for (unsigned int i=0; i<rt0fe.localBasis().size(); i++)
@@ -1063,6 +1065,7 @@ namespace Dune {
         T eps = 1E-30;
         return 2.0/(1.0/(a+eps) + 1.0/(b+eps));
       }
+      mutable LocalOperatorScratch scratch;
     };
 
 
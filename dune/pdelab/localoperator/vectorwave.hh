@@ -19,6 +19,7 @@
 #include <dune/pdelab/localoperator/flags.hh>
 #include <dune/pdelab/localoperator/idefault.hh>
 #include <dune/pdelab/localoperator/pattern.hh>
+#include <dune/pdelab/localoperator/scratch.hh>
 #include <dune/pdelab/multistep/cache.hh>
 
 namespace Dune {
@@ -239,11 +240,11 @@ RangeField mu(const Domain& xg) const;
           GeometryType gt = eg.geometry().type();
           const QR& rule = QRs::rule(gt,qorder);
 
-          std::vector<JacobianU> jacobianU(lfsu.size());
-          std::vector<JacobianV> jacobianV(lfsv.size());
+          std::vector<JacobianU>& jacobianU = scratch.get<JacobianU>(0,lfsu.size(),lfsu.maxSize());
+          std::vector<JacobianV>& jacobianV = scratch.get<JacobianV>(1,lfsv.size(),lfsv.maxSize());
 
-          std::vector<CurlU> curlU(lfsu.size());
-          std::vector<CurlV> curlV(lfsv.size());
+          std::vector<CurlU>& curlU = scratch.get<CurlU>(2,lfsu.size(),lfsu.maxSize());
+          std::vector<CurlV>& curlV = scratch.get<CurlV>(3,lfsv.size(),lfsv.maxSize());
 
           // loop over quadrature points
           for(QRIterator it=rule.begin(); it != rule.end(); ++it) {
@@ -271,6 +272,9 @@ RangeField mu(const Domain& xg) const;
           params.setTime(time);
           IBase::setTime(time);
         }
+
+      private:
+        mutable LocalOperatorScratch scratch;
       };
 
       //! \brief Local operator for the vector wave problem,
@@ -395,8 +399,8 @@ RangeField mu(const Domain& xg) const;
           GeometryType gt = eg.geometry().type();
           const QR& rule = QRs::rule(gt,qorder);
 
-          std::vector<RangeU> phiU(lfsu.size());
-          std::vector<RangeV> phiV(lfsv.size());
+          std::vector<RangeU>& phiU = scratch.get<RangeU>(0,lfsu.size(),lfsu.maxSize());
+          std::vector<RangeV>& phiV = scratch.get<RangeV>(1,lfsv.size(),lfsv.maxSize());
 
           // loop over quadrature points
           for(QRIterator it=rule.begin(); it != rule.end(); ++it) {
@@ -419,6 +423,9 @@ RangeField mu(const Domain& xg) const;
           params.setTime(time);
           IBase::setTime(time);
         }
+
+      private:
+        mutable LocalOperatorScratch scratch;
       };
 
       //! MultiStepCachePolicy for VectorWave operators
@@ -8,13 +8,17 @@
 #include <cmath>
 
 #include <math.h>
+#include <type_traits>
 
 #include <dune/common/exceptions.hh>
 #include <dune/common/ios_state.hh>
 #include <dune/common/timer.hh>
 #include <dune/common/parametertree.hh>
+#include <dune/common/shared_ptr.hh>
+#include <dune/common/typetraits.hh>
 
 #include <dune/pdelab/backend/solver.hh>
+#include <dune/pdelab/common/performancetrace.hh>
 
 namespace Dune
 {
@@ -36,12 +40,185 @@ namespace Dune
       double assembler_time;     // Cumulative time for matrix assembly
       double linear_solver_time; // Cumulative time for linear sovler
       int linear_solver_iterations; // Total number of linear iterations
+      int jacobian_reuses;       // Number of iterations which reused an old jacobian
+      int preconditioner_reuses; // Number of linear solves which reused an old preconditioner
+      double saved_assembler_time;      // Estimated assembly time saved by reusing the jacobian
+      double saved_preconditioner_time; // Estimated setup time saved by reusing the preconditioner
 
       NewtonResult() :
         first_defect(0.0), defect(0.0), assembler_time(0.0), linear_solver_time(0.0),
-        linear_solver_iterations(0) {}
+        linear_solver_iterations(0), jacobian_reuses(0), preconditioner_reuses(0),
+        saved_assembler_time(0.0), saved_preconditioner_time(0.0) {}
     };
 
+    //! Decides when the Newton solver renews the jacobian or the preconditioner
+    /**
+     * An object is renewed if it is not available, if it has already been used
+     * in maxAge() Newton iterations (0 disables this criterion) or if the defect
+     * reduction of the last Newton iteration is worse than threshold().  Unless
+     * keepAcrossSolves() is set, the object is discarded at the beginning of each
+     * call to NewtonSolver::apply(), i.e. in each stage of a OneStepMethod.
+     */
+    template<class RFType>
+    class NewtonReusePolicy
+    {
+    public:
+      NewtonReusePolicy()
+        : _threshold(0.0)
+        , _max_age(0)
+        , _keep(false)
+      {}
+
+      //! The maximum defect reduction of the last iteration which still allows reuse.
+      RFType threshold() const
+      {
+        return _threshold;
+      }
+
+      void setThreshold(RFType threshold)
+      {
+        _threshold = threshold;
+      }
+
+      //! The maximum number of iterations an object is used for, 0 means no limit.
+      unsigned int maxAge() const
+      {
+        return _max_age;
+      }
+
+      void setMaxAge(unsigned int max_age)
+      {
+        _max_age = max_age;
+      }
+
+      //! Whether the object is kept between calls to NewtonSolver::apply().
+      bool keepAcrossSolves() const
+      {
+        return _keep;
+      }
+
+      void setKeepAcrossSolves(bool keep)
+      {
+        _keep = keep;
+      }
+
+      //! Returns whether an object used in age iterations has to be renewed.
+      bool renew(bool available, unsigned int age, RFType rate) const
+      {
+        return !available || (_max_age > 0 && age >= _max_age) || rate > _threshold;
+      }
+
+      //! Returns whether renew() is true for an object used in age iterations, whatever the (positive) defect reduction.
+      bool renewForAnyRate(bool available, unsigned int age) const
+      {
+        return !available || (_max_age > 0 && age >= _max_age) || _threshold <= 0;
+      }
+
+    private:
+      RFType _threshold;
+      unsigned int _max_age;
+      bool _keep;
+    };
+
+#ifndef DOXYGEN
+
+    namespace impl {
+
+      // Switches between linear solvers working on the assembled jacobian
+      // and matrix-free solvers at compile time
+      template<class S, bool matrix_free = IsBaseOf<MatrixFreeLinearSolver,S>::value>
+      struct NewtonLinearSolverTraits
+      {
+        static const bool isMatrixFree = false;
+
+        template<class Matrix, class GOS>
+        static shared_ptr<Matrix> makeMatrix(GOS& go)
+        {
+          return make_shared<Matrix>(go);
+        }
+
+        template<class TrlV>
+        static void setLinearizationPoint(S& solver, const TrlV& u)
+        {}
+      };
+
+      template<class S>
+      struct NewtonLinearSolverTraits<S,true>
+      {
+        static const bool isMatrixFree = true;
+
+        // the jacobian is never assembled, so the matrix does not need any storage
+        template<class Matrix, class GOS>
+        static shared_ptr<Matrix> makeMatrix(GOS& go)
+        {
+          return make_shared<Matrix>();
+        }
+
+        template<class TrlV>
+        static void setLinearizationPoint(S& solver, const TrlV& u)
+        {
+          solver.setLinearizationPoint(u);
+        }
+      };
+
+      // Controls the preconditioner of linear solvers which support its reuse
+      template<class S, bool reusable = IsBaseOf<ReusablePreconditioner,S>::value>
+      struct NewtonPreconditionerTraits
+      {
+        static const bool isReusable = false;
+
+        static void setReuse(S& solver, bool reuse)
+        {}
+
+        static double setupTime(const S& solver)
+        {
+          return 0.0;
+        }
+      };
+
+      template<class S>
+      struct NewtonPreconditionerTraits<S,true>
+      {
+        static const bool isReusable = true;
+
+        static void setReuse(S& solver, bool reuse)
+        {
+          solver.setReuse(reuse);
+        }
+
+        static double setupTime(const S& solver)
+        {
+          return solver.preconditionerSetupTime();
+        }
+      };
+
+      // Detects grid operators which assemble the residual and the jacobian in a single traversal
+      template<class GOS, class = void>
+      struct NewtonFusedAssemblyTraits
+      {
+        static const bool isSupported = false;
+
+        template<class TrlV, class TstV, class Matrix>
+        static void residualAndJacobian(const GOS& go, const TrlV& u, TstV& r, Matrix& A)
+        {}
+      };
+
+      template<class GOS>
+      struct NewtonFusedAssemblyTraits<GOS,typename std::enable_if<GOS::supports_residual_and_jacobian>::type>
+      {
+        static const bool isSupported = true;
+
+        template<class TrlV, class TstV, class Matrix>
+        static void residualAndJacobian(const GOS& go, const TrlV& u, TstV& r, Matrix& A)
+        {
+          go.residual_and_jacobian(u,r,A);
+        }
+      };
+
+    } // namespace impl
+
+#endif // DOXYGEN
+
     template<class GOS, class TrlV, class TstV>
     class NewtonBase
     {
@@ -65,6 +242,77 @@ namespace Dune
           verbosity_level = verbosity_level_;
       }
 
+      //! Reassemble the jacobian at the latest after it has been used in max_age iterations (0: no limit)
+      void setJacobianMaxAge(unsigned int max_age)
+      {
+        jacobian_policy.setMaxAge(max_age);
+      }
+
+      //! Keep the jacobian between calls to apply(), e.g. across the time steps of a OneStepMethod
+      void setKeepJacobian(bool keep)
+      {
+        jacobian_policy.setKeepAcrossSolves(keep);
+      }
+
+      //! \brief Only rebuild the preconditioner of a reassembled jacobian if the defect reduction
+      //!        of the last iteration is worse than threshold
+      /**
+       * Setting any of the preconditioner options makes the Newton solver control when the
+       * linear solver sets up its preconditioner.  This requires a linear solver derived
+       * from ReusablePreconditioner, for all other solvers these options have no effect.
+       * The preconditioner is never rebuilt if the jacobian has not been reassembled.
+       */
+      void setPreconditionerRebuildThreshold(RFType threshold)
+      {
+        preconditioner_policy.setThreshold(threshold);
+        manage_preconditioner = true;
+      }
+
+      //! Rebuild the preconditioner at the latest after it has been used in max_age iterations (0: no limit)
+      void setPreconditionerMaxAge(unsigned int max_age)
+      {
+        preconditioner_policy.setMaxAge(max_age);
+        manage_preconditioner = true;
+      }
+
+      //! Keep the preconditioner between calls to apply(), e.g. across the time steps of a OneStepMethod
+      void setKeepPreconditioner(bool keep)
+      {
+        preconditioner_policy.setKeepAcrossSolves(keep);
+        manage_preconditioner = true;
+      }
+
+      //! Assemble the jacobian together with the defect if it is going to be reassembled anyway
+      /**
+       * This is only done for grid operators providing residual_and_jacobian(), e.g. the default
+       * GridOperator, and saves one grid traversal per Newton iteration. The defect is evaluated
+       * before the solver knows whether the jacobian will be reassembled, so the fused assembly
+       * is only used if the jacobian policy reassembles it regardless of the defect reduction.
+       * The line search assembles the jacobian together with the defect of the full step, which
+       * it tries first. The jacobian is kept if the full step is accepted and discarded otherwise;
+       * the damped trial iterates are never assembled with the jacobian. As the solver
+       * only knows after evaluating the defect whether it has converged, the jacobian at the
+       * final iterate is assembled in vain, which costs more than the saved traversals for
+       * solves taking only one or two iterations. The fused assembly is therefore disabled by
+       * default.
+       */
+      void setFusedAssembly(bool fused)
+      {
+        fused_assembly = fused;
+      }
+
+      //! The policy for the reassembly of the jacobian
+      const NewtonReusePolicy<RFType>& jacobianPolicy() const
+      {
+        return jacobian_policy;
+      }
+
+      //! The policy for the setup of the preconditioner
+      const NewtonReusePolicy<RFType>& preconditionerPolicy() const
+      {
+        return preconditioner_policy;
+      }
+
     protected:
       GridOperator& gridoperator;
       TrialVector *u;
@@ -75,11 +323,45 @@ namespace Dune
       bool reassembled;
       RFType reduction;
       RFType abs_limit;
+      //! Whether the linear solver only applies the jacobian, which is then never assembled
+      bool matrix_free;
+      //! Whether the jacobian may be assembled together with the defect, see setFusedAssembly()
+      bool fused_assembly;
+      //! Whether the jacobian has been assembled together with the defect at the current iterate
+      bool jacobian_prefetched;
+      //! Whether the defect is evaluated at a damped trial iterate of the line search
+      bool line_search_trial;
+
+      //! Reuse of the jacobian and the preconditioner
+      //! @{
+      NewtonReusePolicy<RFType> jacobian_policy;
+      NewtonReusePolicy<RFType> preconditioner_policy;
+      bool manage_preconditioner;
+      bool jacobian_available;
+      unsigned int jacobian_age;
+      double jacobian_assembler_time;
+      bool preconditioner_available;
+      unsigned int preconditioner_age;
+      double preconditioner_setup_time;
+      bool rebuild_preconditioner;
+      //! @}
 
       NewtonBase(GridOperator& go, TrialVector& u_)
         : gridoperator(go)
         , u(&u_)
         , verbosity_level(1)
+        , matrix_free(false)
+        , fused_assembly(false)
+        , jacobian_prefetched(false)
+        , line_search_trial(false)
+        , manage_preconditioner(false)
+        , jacobian_available(false)
+        , jacobian_age(0)
+        , jacobian_assembler_time(0.0)
+        , preconditioner_available(false)
+        , preconditioner_age(0)
+        , preconditioner_setup_time(0.0)
+        , rebuild_preconditioner(true)
       {
         if (gridoperator.trialGridFunctionSpace().gridView().comm().rank()>0)
           verbosity_level = 0;
@@ -89,6 +371,18 @@ namespace Dune
         : gridoperator(go)
         , u(0)
         , verbosity_level(1)
+        , matrix_free(false)
+        , fused_assembly(false)
+        , jacobian_prefetched(false)
+        , line_search_trial(false)
+        , manage_preconditioner(false)
+        , jacobian_available(false)
+        , jacobian_age(0)
+        , jacobian_assembler_time(0.0)
+        , preconditioner_available(false)
+        , preconditioner_age(0)
+        , preconditioner_setup_time(0.0)
+        , rebuild_preconditioner(true)
       {
         if (gridoperator.trialGridFunctionSpace().gridView().comm().rank()>0)
           verbosity_level = 0;
@@ -113,6 +407,10 @@ namespace Dune
       typedef typename TestVector::ElementType RFType;
       typedef typename GOS::Traits::Jacobian Matrix;
 
+      typedef impl::NewtonLinearSolverTraits<Solver> LinearSolverTraits;
+      typedef impl::NewtonPreconditionerTraits<Solver> PreconditionerTraits;
+      typedef impl::NewtonFusedAssemblyTraits<GOS> FusedAssemblyTraits;
+
     public:
       typedef NewtonResult<RFType> Result;
 
@@ -120,13 +418,19 @@ namespace Dune
         : NewtonBase<GOS,TrlV,TstV>(go,u_)
         , solver(solver_)
         , result_valid(false)
-      {}
+        , jacobian_revision(0)
+      {
+        this->matrix_free = LinearSolverTraits::isMatrixFree;
+      }
 
       NewtonSolver(GridOperator& go, Solver& solver_)
         : NewtonBase<GOS,TrlV,TstV>(go)
         , solver(solver_)
         , result_valid(false)
-      {}
+        , jacobian_revision(0)
+      {
+        this->matrix_free = LinearSolverTraits::isMatrixFree;
+      }
 
       void apply();
 
@@ -143,22 +447,65 @@ namespace Dune
     protected:
       virtual void defect(TestVector& r)
       {
+        PerformanceTrace::Region region("defect","newton");
         r = 0.0;                                        // TODO: vector interface
-        this->gridoperator.residual(*this->u, r);
+        this->jacobian_prefetched = false;
+        const bool fused = prefetchJacobian();
+        if (fused)
+          {
+            // the jacobian will be reassembled at this iterate, so assemble it in the same traversal
+            Timer assembler_timer;
+            Matrix& A = *jacobian;
+            this->jacobian_available = false;
+            A = 0.0;                                    // TODO: Matrix interface
+            FusedAssemblyTraits::residualAndJacobian(this->gridoperator, *this->u, r, A);
+            this->jacobian_assembler_time = assembler_timer.elapsed();
+            this->res.assembler_time += this->jacobian_assembler_time;
+          }
+        else
+          this->gridoperator.residual(*this->u, r);
         this->res.defect = this->solver.norm(r);                    // TODO: solver interface
         if (!std::isfinite(this->res.defect))
           DUNE_THROW(NewtonDefectError,
                      "NewtonSolver::defect(): Non-linear defect is NaN or Inf");
+        this->jacobian_prefetched = fused;
       }
 
 
     private:
-      void linearSolve(Matrix& A, TrialVector& z, TestVector& r) const
+      void linearSolve(Matrix& A, TrialVector& z, TestVector& r)
       {
+        PerformanceTrace::Region region("linear solve","newton");
         if (this->verbosity_level >= 4)
           std::cout << "      Solving linear system..." << std::endl;
+        LinearSolverTraits::setLinearizationPoint(this->solver, *this->u);
+        const bool manage_preconditioner =
+          this->manage_preconditioner && PreconditionerTraits::isReusable;
+        if (manage_preconditioner)
+          {
+            PreconditionerTraits::setReuse(this->solver, !this->rebuild_preconditioner);
+            if (this->verbosity_level >= 3 && this->rebuild_preconditioner)
+              std::cout << "      Rebuilding preconditioner..." << std::endl;
+          }
         z = 0.0;                                        // TODO: vector interface
         this->solver.apply(A, z, r, this->linear_reduction);        // TODO: solver interface
+        PerformanceTrace::instance().count("krylov iterations",this->solver.result().iterations);
+
+        if (manage_preconditioner)
+          {
+            if (this->rebuild_preconditioner)
+              {
+                this->preconditioner_setup_time = PreconditionerTraits::setupTime(this->solver);
+                this->preconditioner_available = true;
+                this->preconditioner_age = 0;
+              }
+            else
+              {
+                this->res.saved_preconditioner_time += this->preconditioner_setup_time;
+                this->res.preconditioner_reuses++;
+              }
+            this->preconditioner_age++;
+          }
 
         ios_base_all_saver restorer(std::cout); // store old ios flags
 
@@ -174,8 +521,34 @@ namespace Dune
                     << solver.result().reduction << std::endl;
       }
 
+      // Whether the next defect evaluation should assemble the jacobian, too
+      bool prefetchJacobian() const
+      {
+        return FusedAssemblyTraits::isSupported && this->fused_assembly && !this->matrix_free && jacobian
+          && !this->line_search_trial
+          && this->jacobian_policy.renewForAnyRate(this->jacobian_available,this->jacobian_age);
+      }
+
+      // Sets up the jacobian storage at the beginning of apply()
+      void prepareJacobian()
+      {
+        const std::size_t revision = this->gridoperator.trialGridFunctionSpace().revision();
+        if (!jacobian || !this->jacobian_policy.keepAcrossSolves() || revision != jacobian_revision)
+          {
+            // matrix-free solvers never see an assembled jacobian
+            jacobian = LinearSolverTraits::template makeMatrix<Matrix>(this->gridoperator);
+            jacobian_revision = revision;
+            this->jacobian_available = false;
+            this->preconditioner_available = false;
+          }
+        if (!this->preconditioner_policy.keepAcrossSolves())
+          this->preconditioner_available = false;
+      }
+
       Solver& solver;
       bool result_valid;
+      shared_ptr<Matrix> jacobian;
+      std::size_t jacobian_revision;
     };
 
     template<class GOS, class S, class TrlV, class TstV>
@@ -196,11 +569,19 @@ namespace Dune
       this->res.assembler_time = 0.0;
       this->res.linear_solver_time = 0.0;
       this->res.linear_solver_iterations = 0;
+      this->res.jacobian_reuses = 0;
+      this->res.preconditioner_reuses = 0;
+      this->res.saved_assembler_time = 0.0;
+      this->res.saved_preconditioner_time = 0.0;
       result_valid = true;
+      PerformanceTrace::Region region("newton","newton");
       Timer timer;
 
       try
         {
+          // set up the jacobian first, it may be assembled along with the initial defect
+          prepareJacobian();
+
           TestVector r(this->gridoperator.testGridFunctionSpace());
           this->defect(r);
           this->res.first_defect = this->res.defect;
@@ -215,7 +596,7 @@ namespace Dune
                         << this->res.defect << std::endl;
             }
 
-          Matrix A(this->gridoperator);
+          Matrix& A = *jacobian;
           TrialVector z(this->gridoperator.trialGridFunctionSpace());
 
           while (!this->terminate())
@@ -227,6 +608,7 @@ namespace Dune
               Timer assembler_timer;
               try
                 {
+                  PerformanceTrace::Region jacobian_region("jacobian","newton");
                   this->prepare_step(A,r);
                 }
               catch (...)
@@ -258,6 +640,7 @@ namespace Dune
 
               try
                 {
+                  PerformanceTrace::Region line_search_region("line search","newton");
                   this->line_search(z, r);
                 }
               catch (NewtonLineSearchError)
@@ -266,11 +649,13 @@ namespace Dune
                     throw;
                   if (this->verbosity_level >= 3)
                     std::cout << "      line search failed - trying again with reassembled matrix" << std::endl;
+                  this->jacobian_available = false;
                   continue;
                 }
 
               this->res.reduction = this->res.defect/this->res.first_defect;
               this->res.iterations++;
+              PerformanceTrace::instance().count("newton iterations");
               this->res.conv_rate = std::pow(this->res.reduction, 1.0/this->res.iterations);
 
               // store old ios flags
@@ -398,14 +783,12 @@ namespace Dune
         : NewtonBase<GOS,TrlV,TstV>(go,u_)
         , min_linear_reduction(1e-3)
         , fixed_linear_reduction(0.0)
-        , reassemble_threshold(0.0)
       {}
 
       NewtonPrepareStep(GridOperator& go)
         : NewtonBase<GOS,TrlV,TstV>(go)
         , min_linear_reduction(1e-3)
         , fixed_linear_reduction(0.0)
-        , reassemble_threshold(0.0)
       {}
 
       /* with min_linear_reduction > 0, the linear reduction will be
@@ -424,22 +807,56 @@ namespace Dune
         fixed_linear_reduction = fixed_linear_reduction_;
       }
 
+      /* the jacobian is only reassembled if the defect reduction of
+         the last iteration was worse than reassemble_threshold, see
+         also NewtonBase::setJacobianMaxAge() and setKeepJacobian(). */
       void setReassembleThreshold(RFType reassemble_threshold_)
       {
-        reassemble_threshold = reassemble_threshold_;
+        this->jacobian_policy.setThreshold(reassemble_threshold_);
       }
 
       virtual void prepare_step(Matrix& A, TstV& )
       {
+        // there is no convergence rate yet in the first iteration of a solve
+        const RFType rate = this->res.iterations > 0 ? this->res.defect/this->prev_defect : RFType(0.0);
         this->reassembled = false;
-        if (this->res.defect/this->prev_defect > reassemble_threshold)
+        if (this->matrix_free)
+          {
+            // the jacobian is applied at the current iterate by the linear solver
+            this->reassembled = true;
+          }
+        else if (this->jacobian_prefetched)
+          {
+            // the jacobian has been assembled together with the defect at the current iterate
+            if (this->verbosity_level >= 3)
+              std::cout << "      Matrix assembled with the defect" << std::endl;
+            this->jacobian_available = true;
+            this->jacobian_age = 0;
+            this->reassembled = true;
+          }
+        else if (this->jacobian_policy.renew(this->jacobian_available,this->jacobian_age,rate))
           {
             if (this->verbosity_level >= 3)
               std::cout << "      Reassembling matrix..." << std::endl;
+            Timer assembler_timer;
             A = 0.0;                                    // TODO: Matrix interface
             this->gridoperator.jacobian(*this->u, A);
+            this->jacobian_assembler_time = assembler_timer.elapsed();
+            this->jacobian_available = true;
+            this->jacobian_age = 0;
             this->reassembled = true;
           }
+        else
+          {
+            this->res.saved_assembler_time += this->jacobian_assembler_time;
+            this->res.jacobian_reuses++;
+          }
+        this->jacobian_age++;
+
+        // a preconditioner can only be rebuilt for a new jacobian
+        this->rebuild_preconditioner = !this->preconditioner_available ||
+          (this->reassembled &&
+           this->preconditioner_policy.renew(this->preconditioner_available,this->preconditioner_age,rate));
 
         if (fixed_linear_reduction == true)
           this->linear_reduction = min_linear_reduction;
@@ -479,7 +896,6 @@ namespace Dune
     private:
       RFType min_linear_reduction;
       bool fixed_linear_reduction;
-      RFType reassemble_threshold;
     };
 
     template<class GOS, class TrlV, class TstV>
@@ -548,6 +964,9 @@ namespace Dune
         unsigned int i = 0;
         ios_base_all_saver restorer(std::cout); // store old ios flags
 
+        // the jacobian is only assembled with the defect of the full step, see setFusedAssembly()
+        LineSearchTrialGuard trial_guard(this->line_search_trial);
+
         while (1)
           {
             if (this->verbosity_level >= 4)
@@ -557,6 +976,9 @@ namespace Dune
                         << std::endl;
 
             this->u->axpy(-lambda, z);                  // TODO: vector interface
+            // a rejected full step leaves no jacobian behind, as defect() has marked the
+            // jacobian as unavailable, and the damped trial iterates are assembled without one
+            this->line_search_trial = i > 0;
             try {
               this->defect(r);
             }
@@ -583,6 +1005,8 @@ namespace Dune
               {
                 if (this->verbosity_level >= 4)
                   std::cout << "          max line search iterations exceeded" << std::endl;
+                // the defect is evaluated again at the iterate the solver continues with
+                this->line_search_trial = false;
                 switch (strategy)
                   {
                   case hackbuschReusken:
@@ -625,6 +1049,25 @@ namespace Dune
       }
 
     protected:
+      // resets the marker of damped trial iterates when the line search is left
+      class LineSearchTrialGuard
+      {
+      public:
+        explicit LineSearchTrialGuard(bool& trial)
+          : _trial(trial)
+        {
+          _trial = false;
+        }
+
+        ~LineSearchTrialGuard()
+        {
+          _trial = false;
+        }
+
+      private:
+        bool& _trial;
+      };
+
       /** helper function to get the different strategies from their name */
       Strategy strategyFromName(const std::string & s) {
         if (s == "noLineSearch")
@@ -718,6 +1161,21 @@ namespace Dune
         if (param.hasKey("ReassembleThreshold"))
           this->setReassembleThreshold(
             param.get<RFType>("ReassembleThreshold"));
+        if (param.hasKey("JacobianMaxAge"))
+          this->setJacobianMaxAge(
+            param.get<unsigned int>("JacobianMaxAge"));
+        if (param.hasKey("KeepJacobian"))
+          this->setKeepJacobian(
+            param.get<bool>("KeepJacobian"));
+        if (param.hasKey("PreconditionerRebuildThreshold"))
+          this->setPreconditionerRebuildThreshold(
+            param.get<RFType>("PreconditionerRebuildThreshold"));
+        if (param.hasKey("PreconditionerMaxAge"))
+          this->setPreconditionerMaxAge(
+            param.get<unsigned int>("PreconditionerMaxAge"));
+        if (param.hasKey("KeepPreconditioner"))
+          this->setKeepPreconditioner(
+            param.get<bool>("KeepPreconditioner"));
         if (param.hasKey("LineSearchStrategy"))
           this->setLineSearchStrategy(
             param.get<std::string>("LineSearchStrategy"));
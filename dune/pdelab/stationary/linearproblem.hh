@@ -10,6 +10,7 @@
 #include <dune/pdelab/backend/backendselector.hh>
 #include <dune/pdelab/constraints/common/constraints.hh>
 #include <dune/pdelab/backend/solver.hh>
+#include <dune/pdelab/common/performancetrace.hh>
 
 namespace Dune {
   namespace PDELab {
@@ -180,6 +181,7 @@ namespace Dune {
 
       void apply ()
       {
+        PerformanceTrace::Region region("linear problem","linear problem");
         Dune::Timer watch;
         double timing,assembler_time=0;
 
@@ -188,6 +190,7 @@ namespace Dune {
 
         if (!_jacobian)
           {
+            PerformanceTrace::Region matrix_region("matrix setup","linear problem");
             _jacobian = make_shared<M>(_go);
             timing = watch.elapsed();
             if (_go.trialGridFunctionSpace().gridView().comm().rank()==0 && _verbose>=1)
@@ -233,8 +236,12 @@ namespace Dune {
         typename V::ElementType red = std::max(_reduction,_min_defect/defect);
         if (_go.trialGridFunctionSpace().gridView().comm().rank()==0)
           std::cout << "=== solving (reduction: " << red << ") ";
-        _ls.apply(*_jacobian,z,r,red); // solver makes right hand side consistent
-        _linear_solver_result = _ls.result();
+        {
+          PerformanceTrace::Region solve_region("linear solve","linear problem");
+          _ls.apply(*_jacobian,z,r,red); // solver makes right hand side consistent
+          _linear_solver_result = _ls.result();
+          PerformanceTrace::instance().count("krylov iterations",_linear_solver_result.iterations);
+        }
         timing = watch.elapsed();
         // timing = gos.trialGridFunctionSpace().gridView().comm().max(timing);
         if (_go.trialGridFunctionSpace().gridView().comm().rank()==0 && _verbose>=1)
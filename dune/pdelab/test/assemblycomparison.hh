@@ -0,0 +1,207 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_TEST_ASSEMBLYCOMPARISON_HH
+#define DUNE_PDELAB_TEST_ASSEMBLYCOMPARISON_HH
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include <dune/common/fvector.hh>
+#include <dune/common/timer.hh>
+#include <dune/grid/geometrygrid/coordfunction.hh>
+
+#include <dune/pdelab/localoperator/linearelasticityparameter.hh>
+
+// Fixtures and helpers shared by the tests comparing the optional
+// assembly modes of DefaultAssembler with the default assembly
+
+// Linear elasticity clamped at x_0 = 0 under a constant body force, with Lame
+// parameters varying with the position to exercise the evaluation per cell
+template<typename GV>
+class ElasticityProblem
+  : public Dune::PDELab::LinearElasticityParameterInterface<
+  Dune::PDELab::LinearElasticityParameterTraits<GV,double>,
+  ElasticityProblem<GV> >
+{
+public:
+
+  typedef Dune::PDELab::LinearElasticityParameterTraits<GV,double> Traits;
+
+  void f (const typename Traits::ElementType& e, const typename Traits::DomainType& x,
+          typename Traits::RangeType & y) const
+  {
+    y = 0.0;
+    y[GV::dimension-1] = -1.0;
+  }
+
+  template<typename I>
+  bool isDirichlet(const I & ig, const typename Traits::IntersectionDomainType & coord) const
+  {
+    return ig.geometry().global(coord)[0] < 1e-10;
+  }
+
+  void u (const typename Traits::ElementType& e, const typename Traits::DomainType& x,
+          typename Traits::RangeType & y) const
+  {
+    y = 0.0;
+  }
+
+  typename Traits::RangeFieldType
+  lambda (const typename Traits::ElementType& e, const typename Traits::DomainType& x) const
+  {
+    return 1.0 + e.geometry().global(x)[0];
+  }
+
+  typename Traits::RangeFieldType
+  mu (const typename Traits::ElementType& e, const typename Traits::DomainType& x) const
+  {
+    return 2.0 + e.geometry().global(x)[1];
+  }
+};
+
+// Smooth deformation of the unit cube for use with Dune::GeometryGrid, which gives
+// non-affine cells and, in 3D, non-affine faces, and keeps the face x_0 = 0 in place
+template<int dim>
+class Deformation
+  : public Dune::AnalyticalCoordFunction<double,dim,dim,Deformation<dim> >
+{
+public:
+
+  void evaluate (const Dune::FieldVector<double,dim>& x, Dune::FieldVector<double,dim>& y) const
+  {
+    y = x;
+    y[0] += 0.2*x[0]*x[1];
+    y[1] += 0.1*std::sin(x[0]);
+    if (dim > 2)
+      y[dim-1] += 0.1*x[0]*x[dim-1] + 0.05*x[1]*x[1];
+  }
+};
+
+// Fills a coefficient vector with values that do not repeat any pattern of the grid
+template<typename V>
+void fillCoefficients (V& x)
+{
+  double value = 0.0;
+  for (typename V::iterator it = x.begin(); it != x.end(); ++it)
+    *it = std::sin(value += 1.0);
+}
+
+// Compares a residual and a jacobian with the reference ones, relative to the size of
+// the reference, and reports differences above the tolerance. The arguments r and m are
+// overwritten by the differences.
+template<typename V, typename M>
+bool compareResults (V& r, M& m, const V& reference_r, const M& reference_m,
+                     double tolerance, std::string name, std::string mode)
+{
+  const double residual_scale = std::max(reference_r.infinity_norm(),1.0);
+  r -= reference_r;
+  const double residual_difference = r.infinity_norm()/residual_scale;
+
+  const double jacobian_scale = std::max(reference_m.base().infinity_norm(),1.0);
+  m.base() -= reference_m.base();
+  const double jacobian_difference = m.base().infinity_norm()/jacobian_scale;
+
+  std::cout << name << ": relative difference residual " << residual_difference
+            << ", jacobian " << jacobian_difference << std::endl;
+  if (residual_difference > tolerance || jacobian_difference > tolerance)
+    {
+      std::cerr << name << ": " << mode << " gives different results" << std::endl;
+      return false;
+    }
+  return true;
+}
+
+// Assembles the residual and the jacobian with the assembly mode switched off and on by
+// the given method of the assembler, both sequentially and in the colored mode, and
+// checks that the results agree exactly
+template<typename GO>
+bool compareAssemblyModes (GO& go, void (GO::Traits::Assembler::*setMode)(bool),
+                           std::string name, std::string mode)
+{
+  typedef typename GO::Traits::Domain V;
+  typedef typename GO::Traits::Jacobian M;
+
+  V x(go.trialGridFunctionSpace());
+  fillCoefficients(x);
+
+  bool passed = true;
+  for (int colored = 0; colored < 2; ++colored)
+    {
+      go.assembler().setColoredAssembly(colored);
+
+      V r(go.testGridFunctionSpace(),0.0), mr(go.testGridFunctionSpace(),0.0);
+      M m(go), mm(go);
+      m = 0.0;
+      mm = 0.0;
+
+      (go.assembler().*setMode)(false);
+      go.residual(x,r);
+      go.jacobian(x,m);
+
+      (go.assembler().*setMode)(true);
+      go.residual(x,mr);
+      go.jacobian(x,mm);
+
+      passed &= compareResults(mr,mm,r,m,0.0,colored ? name + " (colored)" : name,mode);
+    }
+  go.assembler().setColoredAssembly(false);
+  (go.assembler().*setMode)(false);
+
+  return passed;
+}
+
+// Measures the time of repeated residual and jacobian assemblies with the assembly mode
+// switched off and on by the given method of the assembler and compares the results
+template<typename GO>
+bool benchmarkAssemblyModes (GO& go, void (GO::Traits::Assembler::*setMode)(bool),
+                             double tolerance, std::string name, std::string mode)
+{
+  typedef typename GO::Traits::Domain V;
+  typedef typename GO::Traits::Jacobian M;
+  const std::size_t runs = 5;
+
+  V x(go.trialGridFunctionSpace());
+  fillCoefficients(x);
+
+  V r(go.testGridFunctionSpace(),0.0), mr(go.testGridFunctionSpace(),0.0);
+  M m(go), mm(go);
+
+  double time[2][2];
+  for (int enabled = 0; enabled < 2; ++enabled)
+    {
+      (go.assembler().*setMode)(enabled);
+      V& res = enabled ? mr : r;
+      M& jac = enabled ? mm : m;
+
+      // data the mode precomputes on first use is not included in the timings
+      res = 0.0;
+      go.residual(x,res);
+
+      Dune::Timer timer;
+      for (std::size_t run = 0; run < runs; ++run)
+        {
+          res = 0.0;
+          go.residual(x,res);
+        }
+      time[enabled][0] = timer.elapsed()/runs;
+
+      timer.reset();
+      for (std::size_t run = 0; run < runs; ++run)
+        {
+          jac = 0.0;
+          go.jacobian(x,jac);
+        }
+      time[enabled][1] = timer.elapsed()/runs;
+    }
+  (go.assembler().*setMode)(false);
+
+  std::cout << name << ": residual " << time[0][0] << " s, " << mode << " " << time[1][0] << " s" << std::endl;
+  std::cout << name << ": jacobian " << time[0][1] << " s, " << mode << " " << time[1][1] << " s" << std::endl;
+
+  return compareResults(mr,mm,r,m,tolerance,name,mode);
+}
+
+#endif // DUNE_PDELAB_TEST_ASSEMBLYCOMPARISON_HH
@@ -0,0 +1,159 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/geometrygrid.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/constraints/common/constraints.hh>
+#include <dune/pdelab/constraints/conforming.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/vectorgridfunctionspace.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/localoperator/convectiondiffusionparameter.hh>
+#include <dune/pdelab/localoperator/convectiondiffusionfem.hh>
+#include <dune/pdelab/localoperator/linearelasticity.hh>
+
+#include "assemblycomparison.hh"
+
+//===============================================================
+// Measures the time of repeated residual and jacobian assemblies
+// with and without evaluating the volume terms on batches of
+// cells on an affine and on a deformed grid and checks that both
+// paths give the same results
+//===============================================================
+
+template<typename GV, typename FEM>
+bool benchmarkConvectionDiffusion (const GV& gv, const FEM& fem, int degree, std::string name)
+{
+  typedef double R;
+  const int dim = GV::dimension;
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::ConformingDirichletConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef Dune::PDELab::ConvectionDiffusionModelProblem<GV,R> Problem;
+  Problem problem;
+  Dune::PDELab::ConvectionDiffusionBoundaryConditionAdapter<Problem> bctype(gv,problem);
+
+  typedef typename GFS::template ConstraintsContainer<R>::Type C;
+  C cg;
+  Dune::PDELab::constraints(bctype,gfs,cg);
+
+  typedef Dune::PDELab::ConvectionDiffusionFEM<Problem,FEM> LOP;
+  LOP lop(problem);
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  int entries = 1;
+  for (int i = 0; i < dim; ++i)
+    entries *= 2*degree+1;
+  MBE mbe(entries);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,cg,gfs,cg,lop,mbe);
+
+  return benchmarkAssemblyModes(go,&GO::Traits::Assembler::setBatchedAssembly,1e-12,name,"batched assembly");
+}
+
+template<typename GV, typename FEM>
+bool benchmarkElasticity (const GV& gv, const FEM& fem, std::string name)
+{
+  typedef double R;
+  const int dim = GV::dimension;
+
+  typedef Dune::PDELab::VectorGridFunctionSpace<GV,FEM,dim,
+    Dune::PDELab::ISTLVectorBackend<>,
+    Dune::PDELab::ISTLVectorBackend<>,
+    Dune::PDELab::ConformingDirichletConstraints> GFS;
+  GFS gfs(gv,fem);
+
+  typedef ElasticityProblem<GV> Problem;
+  Problem problem;
+
+  typedef typename GFS::template ConstraintsContainer<R>::Type C;
+  C cg;
+  Dune::PDELab::constraints(problem,gfs,cg);
+
+  typedef Dune::PDELab::LinearElasticity<Problem> LOP;
+  LOP lop(problem);
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  MBE mbe(9*dim);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,cg,gfs,cg,lop,mbe);
+
+  return benchmarkAssemblyModes(go,&GO::Traits::Assembler::setBatchedAssembly,1e-12,name,"batched assembly");
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(64));
+    Dune::YaspGrid<2> grid(L,N);
+
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    const GV& gv=grid.leafGridView();
+
+    // ConvectionDiffusionFEM with Q1 and Q2
+    {
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+      FEM fem(gv);
+      passed &= benchmarkConvectionDiffusion(gv,fem,1,"convectiondiffusionfem_Q1_2d");
+    }
+    {
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,2> FEM;
+      FEM fem(gv);
+      passed &= benchmarkConvectionDiffusion(gv,fem,2,"convectiondiffusionfem_Q2_2d");
+    }
+
+    // LinearElasticity with Q1
+    {
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+      FEM fem(gv);
+      passed &= benchmarkElasticity(gv,fem,"linearelasticity_Q1_2d");
+    }
+
+    // the same operators on a deformed grid, whose cells are not affine
+    {
+      typedef Dune::GeometryGrid<Dune::YaspGrid<2>,Deformation<2> > DeformedGrid;
+      Deformation<2> deformation;
+      DeformedGrid deformed_grid(grid,deformation);
+
+      typedef DeformedGrid::LeafGridView DGV;
+      const DGV& dgv=deformed_grid.leafGridView();
+
+      typedef Dune::PDELab::QkLocalFiniteElementMap<DGV,double,double,1> FEM;
+      FEM fem(dgv);
+      passed &= benchmarkConvectionDiffusion(dgv,fem,1,"convectiondiffusionfem_Q1_2d_deformed");
+      passed &= benchmarkElasticity(dgv,fem,"linearelasticity_Q1_2d_deformed");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
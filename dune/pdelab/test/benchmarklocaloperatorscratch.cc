@@ -0,0 +1,234 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/timer.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/finiteelementmap/qkdg.hh>
+#include <dune/pdelab/constraints/common/constraints.hh>
+#include <dune/pdelab/constraints/conforming.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/localoperator/convectiondiffusionparameter.hh>
+#include <dune/pdelab/localoperator/convectiondiffusionfem.hh>
+#include <dune/pdelab/localoperator/convectiondiffusiondg.hh>
+
+//===============================================================
+// Counts the heap allocations and measures the time of repeated
+// residual and jacobian assemblies with the shipped convection
+// diffusion operators. Once the scratch storage of the operators
+// has been set up by a warm-up assembly, no further allocations
+// may happen at all.
+//===============================================================
+
+namespace {
+
+  std::size_t allocations = 0;
+
+}
+
+void* operator new (std::size_t size)
+{
+  ++allocations;
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void* operator new[] (std::size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete (void* p) throw()
+{
+  std::free(p);
+}
+
+void operator delete[] (void* p) throw()
+{
+  std::free(p);
+}
+
+template<typename GO, typename V, typename M>
+bool benchmark (const GO& go, const V& x, V& r, M& m, std::size_t cells, std::string name)
+{
+  const std::size_t runs = 5;
+  bool passed = true;
+
+  // the first assemblies set up the scratch storage
+  r = 0.0;
+  go.residual(x,r);
+  m = 0.0;
+  go.jacobian(x,m);
+
+  std::size_t start = allocations;
+  Dune::Timer timer;
+  for (std::size_t run = 0; run < runs; ++run)
+    {
+      r = 0.0;
+      go.residual(x,r);
+    }
+  double time = timer.elapsed();
+  std::size_t count = allocations - start;
+  std::cout << name << ": residual " << time/runs << " s, "
+            << double(count)/(runs*cells) << " allocations per cell" << std::endl;
+  if (count != 0)
+    {
+      std::cerr << name << ": residual assembly allocates " << count << " times after warm-up" << std::endl;
+      passed = false;
+    }
+
+  start = allocations;
+  timer.reset();
+  for (std::size_t run = 0; run < runs; ++run)
+    {
+      m = 0.0;
+      go.jacobian(x,m);
+    }
+  time = timer.elapsed();
+  count = allocations - start;
+  std::cout << name << ": jacobian " << time/runs << " s, "
+            << double(count)/(runs*cells) << " allocations per cell" << std::endl;
+  if (count != 0)
+    {
+      std::cerr << name << ": jacobian assembly allocates " << count << " times after warm-up" << std::endl;
+      passed = false;
+    }
+
+  return passed;
+}
+
+template<typename GV, typename FEM>
+bool benchmarkFEM (const GV& gv, const FEM& fem, int degree, std::string name)
+{
+  typedef double R;
+  const int dim = GV::dimension;
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::ConformingDirichletConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef Dune::PDELab::ConvectionDiffusionModelProblem<GV,R> Problem;
+  Problem problem;
+  Dune::PDELab::ConvectionDiffusionBoundaryConditionAdapter<Problem> bctype(gv,problem);
+
+  typedef typename GFS::template ConstraintsContainer<R>::Type C;
+  C cg;
+  Dune::PDELab::constraints(bctype,gfs,cg);
+
+  typedef Dune::PDELab::ConvectionDiffusionFEM<Problem,FEM> LOP;
+  LOP lop(problem);
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  int entries = 1;
+  for (int i = 0; i < dim; ++i)
+    entries *= 2*degree+1;
+  MBE mbe(entries);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,cg,gfs,cg,lop,mbe);
+
+  typedef typename GO::Traits::Domain V;
+  typedef typename GO::Traits::Jacobian M;
+  V x(gfs,1.0);
+  V r(gfs,0.0);
+  M m(go);
+
+  return benchmark(go,x,r,m,gv.size(0),name);
+}
+
+template<typename GV, typename FEM>
+bool benchmarkDG (const GV& gv, const FEM& fem, std::string name)
+{
+  typedef double R;
+  const int dim = GV::dimension;
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef Dune::PDELab::ConvectionDiffusionModelProblem<GV,R> Problem;
+  Problem problem;
+
+  typedef Dune::PDELab::EmptyTransformation C;
+
+  typedef Dune::PDELab::ConvectionDiffusionDG<Problem,FEM> LOP;
+  LOP lop(problem,Dune::PDELab::ConvectionDiffusionDGMethod::SIPG,
+          Dune::PDELab::ConvectionDiffusionDGWeights::weightsOn,2.0);
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  MBE mbe(2*dim+1);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,gfs,lop,mbe);
+
+  typedef typename GO::Traits::Domain V;
+  typedef typename GO::Traits::Jacobian M;
+  V x(gfs,1.0);
+  V r(gfs,0.0);
+  M m(go);
+
+  return benchmark(go,x,r,m,gv.size(0),name);
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(64));
+    Dune::YaspGrid<2> grid(L,N);
+
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    const GV& gv=grid.leafGridView();
+
+    // ConvectionDiffusionFEM with Q1 and Q2
+    {
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+      FEM fem(gv);
+      passed &= benchmarkFEM(gv,fem,1,"convectiondiffusionfem_Q1_2d");
+    }
+    {
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,2> FEM;
+      FEM fem(gv);
+      passed &= benchmarkFEM(gv,fem,2,"convectiondiffusionfem_Q2_2d");
+    }
+
+    // ConvectionDiffusionDG with Q2
+    {
+      typedef Dune::PDELab::QkDGLocalFiniteElementMap<double,double,2,2> FEM;
+      FEM fem;
+      passed &= benchmarkDG(gv,fem,"convectiondiffusiondg_Q2_2d");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,387 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/timer.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/finiteelementmap/qkdg.hh>
+#include <dune/pdelab/constraints/common/constraints.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/localfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/lfsindexcache.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/backend/istl/bcrspattern.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/localoperator/convectiondiffusionparameter.hh>
+#include <dune/pdelab/localoperator/convectiondiffusionfem.hh>
+#include <dune/pdelab/localoperator/convectiondiffusiondg.hh>
+
+//===============================================================
+// Measures the time and the peak heap memory of building the
+// sparsity pattern for conforming Q1 and Q2 and for DG Q1
+// discretizations on a 3D hex mesh, with a realistic and with a
+// low estimate of the entries per row:
+//  - the same link sequence inserted into the std::set based
+//    overflow storage BCRSPattern used before and into the
+//    current append buffers
+//  - setting up the jacobian of a grid operator with the
+//    sequential traversal and with colored, thread-parallel
+//    pattern assembly
+// and checks that all variants give the same structure.
+//===============================================================
+
+namespace {
+
+  std::size_t current_bytes = 0;
+  std::size_t peak_bytes = 0;
+
+  // keeps the allocation size in front of each block
+  union Header
+  {
+    std::size_t size;
+    double align_double;
+    long double align_long_double;
+    void* align_pointer;
+  };
+
+}
+
+void* operator new (std::size_t size)
+{
+  Header* h = static_cast<Header*>(std::malloc(sizeof(Header) + size));
+  if (!h)
+    throw std::bad_alloc();
+  h->size = size;
+#ifdef _OPENMP
+#pragma omp critical (benchmarkpattern_allocation)
+#endif
+  {
+    current_bytes += size;
+    peak_bytes = std::max(peak_bytes,current_bytes);
+  }
+  return h + 1;
+}
+
+void* operator new[] (std::size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete (void* p) throw()
+{
+  if (!p)
+    return;
+  Header* h = static_cast<Header*>(p) - 1;
+#ifdef _OPENMP
+#pragma omp critical (benchmarkpattern_allocation)
+#endif
+  current_bytes -= h->size;
+  std::free(h);
+}
+
+void operator delete[] (void* p) throw()
+{
+  operator delete(p);
+}
+
+// Measures the time and the additional peak heap memory of a code section
+class Measurement
+{
+public:
+
+  Measurement ()
+    : _base(current_bytes)
+  {
+    peak_bytes = current_bytes;
+  }
+
+  double time () const
+  {
+    return _timer.elapsed();
+  }
+
+  double megabytes () const
+  {
+    return double(peak_bytes - _base)/(1024*1024);
+  }
+
+private:
+  std::size_t _base;
+  Dune::Timer _timer;
+};
+
+// The storage scheme of BCRSPattern before the append buffers: a fixed number of
+// slots per row and a std::set for all entries that do not fit into them
+class SetOverflowPattern
+{
+public:
+
+  typedef std::size_t size_type;
+
+  SetOverflowPattern (size_type rows, size_type entries_per_row)
+    : _entries_per_row(entries_per_row)
+    , _indices(rows*entries_per_row,empty)
+  {}
+
+  template<typename RI, typename CI>
+  void add_link (const RI& ri, const CI& ci)
+  {
+    const size_type i = ri.back();
+    const size_type j = ci.back();
+    std::vector<size_type>::iterator it = _indices.begin() + _entries_per_row*i;
+    const std::vector<size_type>::iterator end = it + _entries_per_row;
+    for (; it != end; ++it)
+      if (*it == j || *it == empty)
+        {
+          *it = j;
+          return;
+        }
+    _overflow.insert(std::make_pair(i,j));
+  }
+
+  std::vector<size_type> sizes () const
+  {
+    std::vector<size_type> r(_indices.size()/_entries_per_row,0);
+    for (size_type k = 0; k < _indices.size(); ++k)
+      if (_indices[k] != empty)
+        ++r[k/_entries_per_row];
+    for (std::set<std::pair<size_type,size_type> >::const_iterator it = _overflow.begin();
+         it != _overflow.end(); ++it)
+      ++r[it->first];
+    return r;
+  }
+
+private:
+
+  static const size_type empty = ~static_cast<size_type>(0);
+
+  size_type _entries_per_row;
+  std::vector<size_type> _indices;
+  std::set<std::pair<size_type,size_type> > _overflow;
+};
+
+// Adds the links of a full volume pattern and, if requested, of a full skeleton
+// pattern in the order the pattern engine produces them
+template<typename GFS, typename P>
+void addLinks (const GFS& gfs, bool skeleton, P& pattern)
+{
+  typedef typename GFS::Traits::GridViewType GV;
+  typedef Dune::PDELab::LocalFunctionSpace<GFS> LFS;
+  typedef Dune::PDELab::LFSIndexCache<LFS> LFSCache;
+
+  const GV& gv = gfs.gridView();
+  LFS lfs(gfs), lfs_n(gfs);
+  LFSCache lfs_cache(lfs), lfs_cache_n(lfs_n);
+
+  for (typename GV::template Codim<0>::Iterator it = gv.template begin<0>(); it != gv.template end<0>(); ++it)
+    {
+      lfs.bind(*it);
+      lfs_cache.update();
+      for (std::size_t i = 0; i < lfs_cache.size(); ++i)
+        for (std::size_t j = 0; j < lfs_cache.size(); ++j)
+          pattern.add_link(lfs_cache.containerIndex(i),lfs_cache.containerIndex(j));
+
+      if (!skeleton)
+        continue;
+
+      for (typename GV::IntersectionIterator iit = gv.ibegin(*it); iit != gv.iend(*it); ++iit)
+        {
+          if (!iit->neighbor())
+            continue;
+          lfs_n.bind(*(iit->outside()));
+          lfs_cache_n.update();
+          for (std::size_t i = 0; i < lfs_cache.size(); ++i)
+            for (std::size_t j = 0; j < lfs_cache_n.size(); ++j)
+              pattern.add_link(lfs_cache.containerIndex(i),lfs_cache_n.containerIndex(j));
+        }
+    }
+}
+
+// Builds the pattern of gfs with both storage schemes and the jacobian of go with
+// both traversals
+template<typename GO>
+bool benchmark (GO& go, bool skeleton, std::size_t entries_per_row, std::string name)
+{
+  typedef typename GO::Traits::TrialGridFunctionSpace GFS;
+  typedef typename GFS::Ordering Ordering;
+  typedef typename GO::Traits::Jacobian M;
+  typedef Dune::PDELab::istl::BCRSPattern<Ordering,Ordering> Pattern;
+
+  const GFS& gfs = go.trialGridFunctionSpace();
+  bool passed = true;
+
+  std::vector<std::size_t> set_sizes, buffer_sizes;
+  double set_time, set_memory, buffer_time, buffer_memory;
+  {
+    Measurement measurement;
+    SetOverflowPattern pattern(gfs.ordering().blockCount(),entries_per_row);
+    addLinks(gfs,skeleton,pattern);
+    set_sizes = pattern.sizes();
+    set_time = measurement.time();
+    set_memory = measurement.megabytes();
+  }
+  {
+    Measurement measurement;
+    Pattern pattern(gfs.ordering(),gfs.ordering(),entries_per_row);
+    addLinks(gfs,skeleton,pattern);
+    buffer_sizes = pattern.sizes();
+    buffer_time = measurement.time();
+    buffer_memory = measurement.megabytes();
+  }
+  std::cout << name << ": pattern with std::set overflow " << set_time << " s, " << set_memory << " MB, "
+            << "with append buffers " << buffer_time << " s, " << buffer_memory << " MB" << std::endl;
+  if (set_sizes != buffer_sizes)
+    {
+      std::cerr << name << ": the overflow storage schemes give different patterns" << std::endl;
+      passed = false;
+    }
+
+  // every matrix has to run the pattern engine
+  go.matrixStructureCache().setEnabled(false);
+
+  // the coloring is computed on first use and not included in the timings
+  go.assembler().setColoredAssembly(true);
+  {
+    M m(go);
+  }
+
+  double time[2], memory[2];
+  std::size_t nonzeroes[2];
+  for (int colored = 0; colored < 2; ++colored)
+    {
+      go.assembler().setColoredAssembly(colored);
+      Measurement measurement;
+      M m(go);
+      time[colored] = measurement.time();
+      memory[colored] = measurement.megabytes();
+      nonzeroes[colored] = m.base().nonzeroes();
+    }
+  go.assembler().setColoredAssembly(false);
+
+  std::cout << name << ": jacobian setup " << time[0] << " s, " << memory[0] << " MB, "
+            << "colored " << time[1] << " s, " << memory[1] << " MB" << std::endl;
+  if (nonzeroes[0] != nonzeroes[1])
+    {
+      std::cerr << name << ": colored pattern assembly gives " << nonzeroes[1]
+                << " nonzeroes instead of " << nonzeroes[0] << std::endl;
+      passed = false;
+    }
+
+  return passed;
+}
+
+template<typename GV, typename FEM>
+bool benchmarkFEM (const GV& gv, const FEM& fem, std::size_t entries_per_row, std::string name)
+{
+  typedef double R;
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef Dune::PDELab::ConvectionDiffusionModelProblem<GV,R> Problem;
+  Problem problem;
+
+  typedef Dune::PDELab::ConvectionDiffusionFEM<Problem,FEM> LOP;
+  LOP lop(problem);
+
+  typedef Dune::PDELab::EmptyTransformation C;
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,gfs,lop,MBE(entries_per_row));
+
+  return benchmark(go,false,entries_per_row,name);
+}
+
+template<typename GV, typename FEM>
+bool benchmarkDG (const GV& gv, const FEM& fem, std::size_t entries_per_row, std::string name)
+{
+  typedef double R;
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef Dune::PDELab::ConvectionDiffusionModelProblem<GV,R> Problem;
+  Problem problem;
+
+  typedef Dune::PDELab::ConvectionDiffusionDG<Problem,FEM> LOP;
+  LOP lop(problem,Dune::PDELab::ConvectionDiffusionDGMethod::SIPG,
+          Dune::PDELab::ConvectionDiffusionDGWeights::weightsOn,2.0);
+
+  typedef Dune::PDELab::EmptyTransformation C;
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,gfs,lop,MBE(entries_per_row));
+
+  return benchmark(go,true,entries_per_row,name);
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    Dune::FieldVector<double,3> L(1.0);
+    Dune::array<int,3> N(Dune::fill_array<int,3>(16));
+    Dune::YaspGrid<3> grid(L,N);
+
+    typedef Dune::YaspGrid<3>::LeafGridView GV;
+    const GV& gv=grid.leafGridView();
+
+    // the exact number of entries per interior row and an estimate that moves
+    // most links into the overflow area
+
+    // ConvectionDiffusionFEM with Q1 and Q2
+    {
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+      FEM fem(gv);
+      passed &= benchmarkFEM(gv,fem,27,"convectiondiffusionfem_Q1_3d");
+      passed &= benchmarkFEM(gv,fem,9,"convectiondiffusionfem_Q1_3d_low_estimate");
+    }
+    {
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,2> FEM;
+      FEM fem(gv);
+      passed &= benchmarkFEM(gv,fem,125,"convectiondiffusionfem_Q2_3d");
+      passed &= benchmarkFEM(gv,fem,27,"convectiondiffusionfem_Q2_3d_low_estimate");
+    }
+
+    // ConvectionDiffusionDG with Q1, the flat vector backend has one row per degree of freedom
+    {
+      typedef Dune::PDELab::QkDGLocalFiniteElementMap<double,double,1,3> FEM;
+      FEM fem;
+      passed &= benchmarkDG(gv,fem,56,"convectiondiffusiondg_Q1_3d");
+      passed &= benchmarkDG(gv,fem,8,"convectiondiffusiondg_Q1_3d_low_estimate");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,177 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_TEST_NONLINEARDIFFUSION_HH
+#define DUNE_PDELAB_TEST_NONLINEARDIFFUSION_HH
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+#include <dune/geometry/quadraturerules.hh>
+
+#include <dune/pdelab/common/function.hh>
+#include <dune/pdelab/localoperator/defaultimp.hh>
+#include <dune/pdelab/localoperator/flags.hh>
+#include <dune/pdelab/localoperator/pattern.hh>
+
+// Nonlinear local operators shared by the tests of the Newton solver and of the
+// jacobian mixins. The residuals are written for a generic coefficient type, so
+// they can be differentiated by the AutomaticJacobian* mixins as well.
+
+// Finite element operator for - div ((1 + u^2) grad u) + exp(u) = 1
+class NonlinearDiffusionFEM
+  : public Dune::PDELab::FullVolumePattern
+  , public Dune::PDELab::LocalOperatorDefaultFlags
+{
+public:
+  enum { doPatternVolume = true };
+  enum { doAlphaVolume = true };
+
+  template<typename EG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r) const
+  {
+    using std::exp;
+
+    typedef typename LFSU::Traits::FiniteElementType::
+      Traits::LocalBasisType::Traits LBTraits;
+    typedef typename LBTraits::DomainFieldType DF;
+    typedef typename LBTraits::RangeFieldType RF;
+    typedef typename LBTraits::RangeType RangeType;
+    typedef typename LBTraits::JacobianType JacobianType;
+    typedef typename X::value_type U;
+    const int dim = EG::Geometry::dimension;
+
+    const Dune::QuadratureRule<DF,dim>& rule =
+      Dune::QuadratureRules<DF,dim>::rule(eg.geometry().type(),4);
+
+    std::vector<RangeType> phi(lfsu.size());
+    std::vector<JacobianType> js(lfsu.size());
+    std::vector<Dune::FieldVector<RF,dim> > gradphi(lfsu.size());
+
+    for (typename Dune::QuadratureRule<DF,dim>::const_iterator it = rule.begin(); it != rule.end(); ++it)
+      {
+        lfsu.finiteElement().localBasis().evaluateFunction(it->position(),phi);
+        lfsu.finiteElement().localBasis().evaluateJacobian(it->position(),js);
+
+        const typename EG::Geometry::JacobianInverseTransposed
+          jac = eg.geometry().jacobianInverseTransposed(it->position());
+        for (std::size_t i = 0; i < lfsu.size(); ++i)
+          {
+            gradphi[i] = 0.0;
+            jac.umv(js[i][0],gradphi[i]);
+          }
+
+        U u = 0.0;
+        std::vector<U> gradu(dim,0.0);
+        for (std::size_t i = 0; i < lfsu.size(); ++i)
+          {
+            u += x(lfsu,i)*phi[i][0];
+            for (int d = 0; d < dim; ++d)
+              gradu[d] += x(lfsu,i)*gradphi[i][d];
+          }
+
+        const RF factor = it->weight()*eg.geometry().integrationElement(it->position());
+        for (std::size_t i = 0; i < lfsv.size(); ++i)
+          {
+            U gradu_gradphi = 0.0;
+            for (int d = 0; d < dim; ++d)
+              gradu_gradphi += gradu[d]*gradphi[i][d];
+            r.accumulate(lfsv,i,((1.0 + u*u)*gradu_gradphi + (exp(u) - 1.0)*phi[i][0])*factor);
+          }
+      }
+  }
+};
+
+// NonlinearDiffusionFEM with the jacobian and its matrix-free application by finite differences
+class NumericalNonlinearDiffusionFEM
+  : public NonlinearDiffusionFEM
+  , public Dune::PDELab::NumericalJacobianVolume<NumericalNonlinearDiffusionFEM>
+  , public Dune::PDELab::NumericalJacobianApplyVolume<NumericalNonlinearDiffusionFEM>
+{};
+
+// Cell-centered finite volume operator for - div (exp(u) grad u) + u^3 = 1 with u = 0 on the boundary
+class NonlinearDiffusionCCFV
+  : public Dune::PDELab::FullSkeletonPattern
+  , public Dune::PDELab::FullVolumePattern
+  , public Dune::PDELab::LocalOperatorDefaultFlags
+{
+public:
+  enum { doPatternVolume = true };
+  enum { doPatternSkeleton = true };
+  enum { doAlphaVolume = true };
+  enum { doAlphaSkeleton = true };
+  enum { doAlphaBoundary = true };
+
+  template<typename EG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r) const
+  {
+    r.accumulate(lfsv,0,(x(lfsu,0)*x(lfsu,0)*x(lfsu,0) - 1.0)*eg.geometry().volume());
+  }
+
+  template<typename IG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_skeleton (const IG& ig,
+                       const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+                       const LFSU& lfsu_n, const X& x_n, const LFSV& lfsv_n,
+                       R& r_s, R& r_n) const
+  {
+    using std::exp;
+    typedef typename X::value_type U;
+
+    Dune::FieldVector<double,IG::dimension> d = ig.outside()->geometry().center();
+    d -= ig.inside()->geometry().center();
+    const double distance = d.two_norm();
+
+    const U k = 0.5*(exp(x_s(lfsu_s,0)) + exp(x_n(lfsu_n,0)));
+    const U flux = k*(x_s(lfsu_s,0) - x_n(lfsu_n,0))/distance*ig.geometry().volume();
+    r_s.accumulate(lfsv_s,0,flux);
+    r_n.accumulate(lfsv_n,0,-flux);
+  }
+
+  template<typename IG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_boundary (const IG& ig,
+                       const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+                       R& r_s) const
+  {
+    using std::exp;
+
+    Dune::FieldVector<double,IG::dimension> d = ig.geometry().center();
+    d -= ig.inside()->geometry().center();
+    const double distance = d.two_norm();
+
+    r_s.accumulate(lfsv_s,0,exp(x_s(lfsu_s,0))*x_s(lfsu_s,0)/distance*ig.geometry().volume());
+  }
+};
+
+// NonlinearDiffusionCCFV with the jacobian and its matrix-free application by finite differences
+class NumericalNonlinearDiffusionCCFV
+  : public NonlinearDiffusionCCFV
+  , public Dune::PDELab::NumericalJacobianVolume<NumericalNonlinearDiffusionCCFV>
+  , public Dune::PDELab::NumericalJacobianSkeleton<NumericalNonlinearDiffusionCCFV>
+  , public Dune::PDELab::NumericalJacobianBoundary<NumericalNonlinearDiffusionCCFV>
+  , public Dune::PDELab::NumericalJacobianApplyVolume<NumericalNonlinearDiffusionCCFV>
+  , public Dune::PDELab::NumericalJacobianApplySkeleton<NumericalNonlinearDiffusionCCFV>
+  , public Dune::PDELab::NumericalJacobianApplyBoundary<NumericalNonlinearDiffusionCCFV>
+{};
+
+// Initial guess and Dirichlet values: a Gaussian centered in the unit cube
+template<typename GV, typename RF>
+class G
+  : public Dune::PDELab::AnalyticGridFunctionBase<Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1>,
+                                                  G<GV,RF> >
+{
+public:
+  typedef Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1> Traits;
+  typedef Dune::PDELab::AnalyticGridFunctionBase<Traits,G<GV,RF> > BaseT;
+
+  G (const GV& gv) : BaseT(gv) {}
+  inline void evaluateGlobal (const typename Traits::DomainType& x,
+                              typename Traits::RangeType& y) const
+  {
+    typename Traits::DomainType center(0.5);
+    center -= x;
+    y = exp(-center.two_norm2());
+  }
+};
+
+#endif // DUNE_PDELAB_TEST_NONLINEARDIFFUSION_HH
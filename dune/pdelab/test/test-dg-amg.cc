@@ -228,6 +228,16 @@ int main(int argc, char **argv)
   slp.setHangingNodeModifications(false);
   slp.apply();
 
+  // solve again, now only the numeric part of the Galerkin product is recomputed
+  // and the AMG hierarchy is reused
+  ls.setReuse(true);
+  slp.apply();
+  if (!slp.ls_result().converged)
+    {
+      std::cerr << "second solve with cached coarse space matrix did not converge" << std::endl;
+      return 1;
+    }
+
   // output grid to VTK file
   // Dune::SubsamplingVTKWriter<GM::LeafGridView> vtkwriter(grid->leafGridView(),2*(degree-1));
   // FS::DGF xdgf(fs.getGFS(),x);
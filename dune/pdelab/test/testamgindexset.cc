@@ -0,0 +1,146 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <bitset>
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/constraints/common/constraints.hh>
+#include <dune/pdelab/constraints/common/constraintsparameters.hh>
+#include <dune/pdelab/constraints/conforming.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/backend/ovlpistlsolverbackend.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/localoperator/l2.hh>
+
+//===============================================================
+// Solves with the overlapping AMG backend several times and
+// checks that the parallel index set is only built again after
+// the grid function space has been updated
+//===============================================================
+
+template<typename GFS, typename LS>
+bool solve (const GFS& gfs, LS& ls, std::string name)
+{
+  typedef double R;
+
+  typedef typename GFS::template ConstraintsContainer<R>::Type C;
+  C cg;
+  Dune::PDELab::NoDirichletConstraintsParameters constraintsparameters;
+  Dune::PDELab::constraints(constraintsparameters,gfs,cg);
+
+  typedef Dune::PDELab::L2 LOP;
+  LOP lop(2);
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  MBE mbe(9);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,cg,gfs,cg,lop,mbe);
+
+  typedef typename GO::Traits::Domain V;
+  typedef typename GO::Traits::Jacobian M;
+  V one(gfs,1.0);
+  M A(go);
+  A = 0.0;
+  go.jacobian(one,A);
+
+  // the mass matrix applied to the constant function is the residual
+  V r(gfs,0.0);
+  go.residual(one,r);
+  V z(gfs,0.0);
+  ls.apply(A,z,r,1e-10);
+
+  z -= one;
+  const R error = ls.norm(z);
+  std::cout << name << ": error " << error << std::endl;
+  return error < 1e-6;
+}
+
+template<typename Grid>
+bool testAMGIndexSet (Grid& grid, std::string name)
+{
+  typedef typename Grid::LeafGridView GV;
+  GV gv = grid.leafGridView();
+
+  typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+  FEM fem(gv);
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,
+    Dune::PDELab::OverlappingConformingDirichletConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,Dune::PDELab::L2,
+    Dune::PDELab::istl::BCRSMatrixBackend<>,double,double,double,
+    typename GFS::template ConstraintsContainer<double>::Type,
+    typename GFS::template ConstraintsContainer<double>::Type> GO;
+  typedef Dune::PDELab::ISTLBackend_CG_AMG_SSOR<GO> LS;
+  LS ls(gfs,100,0);
+
+  bool passed = true;
+  passed &= solve(gfs,ls,name);
+  passed &= solve(gfs,ls,name);
+
+  const Dune::PDELab::ISTLAMGStatistics& stats = ls.statistics();
+  std::cout << name << ": " << stats.indexSetBuilds << " index set builds, "
+            << stats.indexSetReuses << " reuses, "
+            << stats.savedCommunicationRounds << " communication rounds saved" << std::endl;
+  if (stats.indexSetBuilds != 1 || stats.indexSetReuses != 1)
+    {
+      std::cerr << name << ": parallel index set has not been reused" << std::endl;
+      passed = false;
+    }
+
+  // the DOF layout changes with the grid
+  grid.globalRefine(1);
+  gfs.update();
+  passed &= solve(gfs,ls,name);
+  if (stats.indexSetBuilds != 2 || stats.indexSetReuses != 1)
+    {
+      std::cerr << name << ": parallel index set has not been rebuilt after update()" << std::endl;
+      passed = false;
+    }
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper& helper = Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    // YaspGrid Q1 2D test
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(16));
+      std::bitset<2> B(false);
+      Dune::YaspGrid<2> grid(helper.getCommunicator(),L,N,B,1);
+
+      passed &= testAMGIndexSet(grid,"yasp_Q1_2d");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
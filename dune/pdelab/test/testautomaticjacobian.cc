@@ -0,0 +1,223 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/common/dualnumber.hh>
+#include <dune/pdelab/finiteelementmap/p0fem.hh>
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/constraints/common/constraints.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/localoperator/defaultimp.hh>
+#include <dune/pdelab/localoperator/flags.hh>
+#include <dune/pdelab/localoperator/pattern.hh>
+
+#include "nonlineardiffusion.hh"
+
+//===============================================================
+// Checks the derivatives computed with DualNumber against the
+// analytic ones, and compares the jacobians assembled with the
+// AutomaticJacobian* mixins to those of the NumericalJacobian*
+// mixins for a nonlinear finite element operator and a nonlinear
+// cell-centered finite volume operator, with the coefficients
+// differentiated in one and in several blocks and with the volume
+// term assembled before and after the skeleton terms
+//===============================================================
+
+bool testDualNumber ()
+{
+  using std::exp;
+  using std::log;
+  using std::sin;
+  using std::sqrt;
+
+  typedef Dune::PDELab::DualNumber<double,2> Dual;
+  const double a = 1.5, b = 0.5;
+  const Dual x(a,0), y(b,1);
+
+  // f = x^2 y + sin(y) - 2x/y + exp(x) log(x) + sqrt(x) + pow(x,y)
+  const Dual f = x*x*y + sin(y) - 2*x/y + exp(x)*log(x) + sqrt(x) + pow(x,y);
+  const double f_x = 2*a*b - 2/b + std::exp(a)*(std::log(a) + 1/a) + 0.5/std::sqrt(a)
+    + b*std::pow(a,b-1);
+  const double f_y = a*a + std::cos(b) + 2*a/(b*b) + std::pow(a,b)*std::log(a);
+
+  const double difference = std::max(std::abs(f.derivative(0) - f_x),std::abs(f.derivative(1) - f_y));
+  std::cout << "dualnumber: difference of the derivatives " << difference << std::endl;
+  if (difference > 1e-12 || x < y || !(-x < y))
+    {
+      std::cerr << "dualnumber: wrong derivatives or comparisons" << std::endl;
+      return false;
+    }
+
+  // powers at zero keep a finite value, with a derivative of 0 for the exponent 0
+  const Dual zero(0.0,0);
+  const Dual root = pow(zero,0.5), constant = pow(zero,0.0), square = pow(zero,2);
+  if (root.value() != 0.0 || constant.value() != 1.0 || constant.derivative(0) != 0.0 ||
+      square.value() != 0.0 || square.derivative(0) != 0.0)
+    {
+      std::cerr << "dualnumber: wrong powers of zero" << std::endl;
+      return false;
+    }
+  return true;
+}
+
+template<int blockSize>
+class AutomaticNonlinearDiffusionFEM
+  : public NonlinearDiffusionFEM
+  , public Dune::PDELab::AutomaticJacobianVolume<AutomaticNonlinearDiffusionFEM<blockSize>,blockSize>
+{};
+
+template<int blockSize>
+class AutomaticNonlinearDiffusionCCFV
+  : public NonlinearDiffusionCCFV
+  , public Dune::PDELab::AutomaticJacobianVolume<AutomaticNonlinearDiffusionCCFV<blockSize>,blockSize>
+  , public Dune::PDELab::AutomaticJacobianSkeleton<AutomaticNonlinearDiffusionCCFV<blockSize>,blockSize>
+  , public Dune::PDELab::AutomaticJacobianBoundary<AutomaticNonlinearDiffusionCCFV<blockSize>,blockSize>
+{};
+
+// The same operator with the reaction term assembled after the skeleton terms
+class NonlinearDiffusionCCFVPostSkeleton
+  : public NonlinearDiffusionCCFV
+{
+public:
+  enum { doAlphaVolume = false };
+  enum { doAlphaVolumePostSkeleton = true };
+
+  template<typename EG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_volume_post_skeleton (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r) const
+  {
+    alpha_volume(eg,lfsu,x,lfsv,r);
+  }
+};
+
+class NumericalNonlinearDiffusionCCFVPostSkeleton
+  : public NonlinearDiffusionCCFVPostSkeleton
+  , public Dune::PDELab::NumericalJacobianVolumePostSkeleton<NumericalNonlinearDiffusionCCFVPostSkeleton>
+  , public Dune::PDELab::NumericalJacobianSkeleton<NumericalNonlinearDiffusionCCFVPostSkeleton>
+  , public Dune::PDELab::NumericalJacobianBoundary<NumericalNonlinearDiffusionCCFVPostSkeleton>
+{};
+
+class AutomaticNonlinearDiffusionCCFVPostSkeleton
+  : public NonlinearDiffusionCCFVPostSkeleton
+  , public Dune::PDELab::AutomaticJacobianVolumePostSkeleton<AutomaticNonlinearDiffusionCCFVPostSkeleton,1>
+  , public Dune::PDELab::AutomaticJacobianSkeleton<AutomaticNonlinearDiffusionCCFVPostSkeleton,2>
+  , public Dune::PDELab::AutomaticJacobianBoundary<AutomaticNonlinearDiffusionCCFVPostSkeleton,1>
+{};
+
+template<typename GFS, typename NumericalLOP, typename AutomaticLOP>
+bool compareJacobians (const GFS& gfs, int entries, std::string name)
+{
+  typedef double R;
+  typedef Dune::PDELab::EmptyTransformation C;
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,NumericalLOP,MBE,R,R,R,C,C> NumericalGO;
+  NumericalLOP numerical_lop;
+  NumericalGO numerical_go(gfs,gfs,numerical_lop,MBE(entries));
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,AutomaticLOP,MBE,R,R,R,C,C> AutomaticGO;
+  AutomaticLOP automatic_lop;
+  AutomaticGO automatic_go(gfs,gfs,automatic_lop,MBE(entries));
+
+  typedef typename NumericalGO::Traits::Domain V;
+  V x(gfs);
+  double value = 0.0;
+  for (typename V::iterator it = x.begin(); it != x.end(); ++it)
+    *it = std::sin(value += 1.0);
+
+  typename NumericalGO::Traits::Jacobian numerical_jacobian(numerical_go);
+  numerical_jacobian = 0.0;
+  numerical_go.jacobian(x,numerical_jacobian);
+
+  typename AutomaticGO::Traits::Jacobian automatic_jacobian(automatic_go);
+  automatic_jacobian = 0.0;
+  automatic_go.jacobian(x,automatic_jacobian);
+
+  // the finite differences are accurate to about the square root of the machine precision
+  const double scale = std::max(numerical_jacobian.base().infinity_norm(),1.0);
+  automatic_jacobian.base() -= numerical_jacobian.base();
+  const double difference = automatic_jacobian.base().infinity_norm()/scale;
+
+  std::cout << name << ": relative difference of the jacobians " << difference << std::endl;
+  if (difference > 1e-5)
+    {
+      std::cerr << name << ": automatic and numerical jacobian differ" << std::endl;
+      return false;
+    }
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = testDualNumber();
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(8));
+    Dune::YaspGrid<2> grid(L,N);
+
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    const GV& gv=grid.leafGridView();
+
+    {
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+      FEM fem(gv);
+      typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+        Dune::PDELab::ISTLVectorBackend<> > GFS;
+      GFS gfs(gv,fem);
+      passed &= compareJacobians<GFS,NumericalNonlinearDiffusionFEM,
+        AutomaticNonlinearDiffusionFEM<4> >(gfs,9,"nonlineardiffusionfem_Q1_2d");
+    }
+    {
+      // 9 coefficients per cell, differentiated in three blocks
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,2> FEM;
+      FEM fem(gv);
+      typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+        Dune::PDELab::ISTLVectorBackend<> > GFS;
+      GFS gfs(gv,fem);
+      passed &= compareJacobians<GFS,NumericalNonlinearDiffusionFEM,
+        AutomaticNonlinearDiffusionFEM<4> >(gfs,25,"nonlineardiffusionfem_Q2_2d");
+    }
+    {
+      typedef Dune::PDELab::P0LocalFiniteElementMap<double,double,2> FEM;
+      FEM fem(Dune::GeometryType(Dune::GeometryType::cube,2));
+      typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+        Dune::PDELab::ISTLVectorBackend<> > GFS;
+      GFS gfs(gv,fem);
+      passed &= compareJacobians<GFS,NumericalNonlinearDiffusionCCFV,
+        AutomaticNonlinearDiffusionCCFV<2> >(gfs,5,"nonlineardiffusionccfv_2d");
+      // one coefficient per block, the skeleton term is differentiated separately for both cells
+      passed &= compareJacobians<GFS,NumericalNonlinearDiffusionCCFV,
+        AutomaticNonlinearDiffusionCCFV<1> >(gfs,5,"nonlineardiffusionccfv_2d_blocked");
+      passed &= compareJacobians<GFS,NumericalNonlinearDiffusionCCFVPostSkeleton,
+        AutomaticNonlinearDiffusionCCFVPostSkeleton>(gfs,5,"nonlineardiffusionccfv_2d_post_skeleton");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,159 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/pdelab/backend/istl/bcrspattern.hh>
+
+//===============================================================
+// Fills a BCRSPattern with links that exceed the number of
+// entries per row, including rows without any entries, rows
+// whose overflow triggers the compaction of the append buffers
+// and duplicate links, and compares the row sizes and the
+// column indices returned by the row iterators with a reference.
+// Links added after the pattern has been read are merged into
+// the existing overflow area. With OpenMP, the rows are filled
+// concurrently.
+//===============================================================
+
+// The parts of an ordering used by BCRSPattern
+struct Ordering
+{
+  struct Traits
+  {
+    typedef std::size_t size_type;
+  };
+
+  Ordering (std::size_t blocks)
+    : _blocks(blocks)
+  {}
+
+  std::size_t blockCount () const
+  {
+    return _blocks;
+  }
+
+  std::size_t _blocks;
+};
+
+// A flat multi-index
+struct Index
+{
+  Index (std::size_t i)
+    : _i(i)
+  {}
+
+  std::size_t back () const
+  {
+    return _i;
+  }
+
+  std::size_t _i;
+};
+
+typedef Dune::PDELab::istl::BCRSPattern<Ordering,Ordering> Pattern;
+typedef std::vector<std::set<std::size_t> > Reference;
+
+// Adds the links of row i, every link twice; every eighth row stays empty and row 1
+// gets enough overflow entries to compact its buffer several times
+void addRow (Pattern& pattern, std::set<std::size_t>& reference, std::size_t i, std::size_t rows, std::size_t offset)
+{
+  const std::size_t links = i == 1 ? 5000 : i % 8;
+  for (std::size_t k = 0; k < links; ++k)
+    for (int repeat = 0; repeat < 2; ++repeat)
+      {
+        const std::size_t j = (offset + 7*i + 13*k) % (i == 1 ? 10*rows : rows);
+        pattern.add_link(Index(i),Index(j));
+        reference.insert(j);
+      }
+}
+
+bool compare (const Pattern& pattern, const Reference& reference, std::string name)
+{
+  bool passed = true;
+
+  std::size_t overflow = 0;
+  const std::vector<std::size_t> sizes = pattern.sizes();
+  for (std::size_t i = 0; i < reference.size(); ++i)
+    {
+      std::vector<std::size_t> columns;
+      for (Pattern::iterator it = pattern.begin(i); it != pattern.end(i); ++it)
+        columns.push_back(*it);
+      std::sort(columns.begin(),columns.end());
+
+      if (sizes[i] != reference[i].size() ||
+          columns.size() != reference[i].size() ||
+          !std::equal(columns.begin(),columns.end(),reference[i].begin()))
+        {
+          std::cerr << name << ": wrong entries in row " << i << ", size " << sizes[i]
+                    << ", " << columns.size() << " columns, expected " << reference[i].size() << std::endl;
+          passed = false;
+        }
+
+      if (reference[i].size() > pattern.entriesPerRow())
+        overflow += reference[i].size() - pattern.entriesPerRow();
+    }
+
+  std::cout << name << ": " << pattern.overflowCount() << " overflow entries" << std::endl;
+  if (pattern.overflowCount() != overflow)
+    {
+      std::cerr << name << ": " << pattern.overflowCount() << " overflow entries, expected "
+                << overflow << std::endl;
+      passed = false;
+    }
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper::instance(argc, argv);
+
+    const std::size_t rows = 200;
+    const Ordering ordering(rows);
+    Pattern pattern(ordering,ordering,3);
+    Reference reference(rows);
+
+    bool passed = true;
+
+    // rows are only ever filled by a single thread
+    const int row_count = rows;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0; i < row_count; ++i)
+      addRow(pattern,reference[i],i,rows,0);
+    passed &= compare(pattern,reference,"first fill");
+
+    // new links after reading the pattern end up in the merged overflow area
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0; i < row_count; ++i)
+      addRow(pattern,reference[i],i,rows,i % 3 == 0 ? 5 : 0);
+    passed &= compare(pattern,reference,"second fill");
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
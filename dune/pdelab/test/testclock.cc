@@ -52,6 +52,29 @@ int main(int argc, char** argv) {
       result = 1;
     }
 
+    std::cout << std::endl;
+
+    // Check Monotonic Time
+    std::cout << "Testing monotonic time" << std::endl;
+    try {
+      std::cout << "  Monotonic time implemented by: "
+                << Dune::PDELab::getMonotonicTimeImp() << std::endl;
+      std::cout << "  Monotonic time resolution: "
+                << Dune::PDELab::getMonotonicTimeResolution() << std::endl;
+      Dune::PDELab::TimeSpec first = Dune::PDELab::getMonotonicTime();
+      Dune::PDELab::TimeSpec second = Dune::PDELab::getMonotonicTime();
+      std::cout << "  Current monotonic time: " << second << std::endl;
+      if(second.tv_sec < first.tv_sec ||
+         (second.tv_sec == first.tv_sec && second.tv_nsec < first.tv_nsec)) {
+        std::cerr << "  Monotonic time went backwards" << std::endl;
+        result = 1;
+      }
+    }
+    catch(Dune::PDELab::ClockError &e) {
+      std::cerr << "  Cought ClockError: " << e << std::endl;
+      result = 1;
+    }
+
     // tests done
     return result;
   }
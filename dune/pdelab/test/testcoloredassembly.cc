@@ -0,0 +1,352 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/finiteelementmap/qkdg.hh>
+#include <dune/pdelab/constraints/common/constraints.hh>
+#include <dune/pdelab/constraints/conforming.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/interpolate.hh>
+#include <dune/pdelab/common/function.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/localoperator/poisson.hh>
+#include <dune/pdelab/localoperator/convectiondiffusionparameter.hh>
+#include <dune/pdelab/localoperator/convectiondiffusiondg.hh>
+
+//===============================================================
+// Compares the colored assembly of residual and jacobian
+// to the default sequential grid traversal, for a conforming
+// discretization and for a DG discretization with skeleton
+// terms, whose coloring has to include the neighbors
+//===============================================================
+
+template<typename GV, typename RF>
+class F
+  : public Dune::PDELab::AnalyticGridFunctionBase<Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1>,
+                                                  F<GV,RF> >
+{
+public:
+  typedef Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1> Traits;
+  typedef Dune::PDELab::AnalyticGridFunctionBase<Traits,F<GV,RF> > BaseT;
+
+  F (const GV& gv) : BaseT(gv) {}
+  inline void evaluateGlobal (const typename Traits::DomainType& x,
+                              typename Traits::RangeType& y) const
+  {
+    y = x[0]*x[1] + 1.0;
+  }
+};
+
+template<typename GV, typename RF>
+class G
+  : public Dune::PDELab::AnalyticGridFunctionBase<Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1>,
+                                                  G<GV,RF> >
+{
+public:
+  typedef Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1> Traits;
+  typedef Dune::PDELab::AnalyticGridFunctionBase<Traits,G<GV,RF> > BaseT;
+
+  G (const GV& gv) : BaseT(gv) {}
+  inline void evaluateGlobal (const typename Traits::DomainType& x,
+                              typename Traits::RangeType& y) const
+  {
+    typename Traits::DomainType center(0.5);
+    center -= x;
+    y = exp(-center.two_norm2());
+  }
+};
+
+template<typename GV, typename RF>
+class J
+  : public Dune::PDELab::AnalyticGridFunctionBase<Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1>,
+                                                  J<GV,RF> >
+{
+public:
+  typedef Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1> Traits;
+  typedef Dune::PDELab::AnalyticGridFunctionBase<Traits,J<GV,RF> > BaseT;
+
+  J (const GV& gv) : BaseT(gv) {}
+  inline void evaluateGlobal (const typename Traits::DomainType& x,
+                              typename Traits::RangeType& y) const
+  {
+    y = 1.0;
+  }
+};
+
+class ConstraintsParameters
+  : public Dune::PDELab::DirichletConstraintsParameters
+{
+
+public:
+
+  template<typename I>
+  bool isDirichlet(const I & ig, const Dune::FieldVector<typename I::ctype, I::dimension-1> & x) const
+  {
+    Dune::FieldVector<typename I::ctype,I::dimension>
+      xg = ig.geometry().global(x);
+    return xg[0] < 1E-6;
+  }
+
+  template<typename I>
+  bool isNeumann(const I & ig, const Dune::FieldVector<typename I::ctype, I::dimension-1> & x) const
+  {
+    return !isDirichlet(ig,x);
+  }
+
+};
+
+template<typename GV, typename FEM>
+bool testColoredAssembly (const GV& gv, const FEM& fem, std::string name)
+{
+  typedef double R;
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::ConformingDirichletConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef typename GFS::template ConstraintsContainer<R>::Type C;
+  C cg;
+  ConstraintsParameters constraintsparameters;
+  Dune::PDELab::constraints(constraintsparameters,gfs,cg);
+
+  typedef F<GV,R> FType;
+  FType f(gv);
+  typedef J<GV,R> JType;
+  JType j(gv);
+  typedef Dune::PDELab::Poisson<FType,ConstraintsParameters,JType> LOP;
+  LOP lop(f,constraintsparameters,j,2);
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  MBE mbe(27);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,cg,gfs,cg,lop,mbe);
+
+  typedef typename GO::Traits::Domain V;
+  typedef typename GO::Traits::Jacobian M;
+
+  V x(gfs,0.0);
+  G<GV,R> g(gv);
+  Dune::PDELab::interpolate(g,gfs,x);
+
+  // reference: sequential traversal
+  V r_seq(gfs,0.0);
+  M m_seq(go);
+  m_seq = 0.0;
+  go.residual(x,r_seq);
+  go.jacobian(x,m_seq);
+
+  // colored assembly with a single thread
+  go.assembler().setColoredAssembly(true);
+  go.assembler().setThreads(1);
+  V r_1(gfs,0.0);
+  M m_1(go);
+  m_1 = 0.0;
+  go.residual(x,r_1);
+  go.jacobian(x,m_1);
+
+  // colored assembly with several threads
+  go.assembler().setThreads(4);
+  V r_4(gfs,0.0);
+  M m_4(go);
+  m_4 = 0.0;
+  go.residual(x,r_4);
+  go.jacobian(x,m_4);
+
+  std::cout << name << ": " << go.assembler().coloring().colors() << " colors for "
+            << go.assembler().coloring().size() << " cells" << std::endl;
+
+  bool passed = true;
+
+  // results must not depend on the number of threads
+  r_4 -= r_1;
+  m_4.base() -= m_1.base();
+  if (r_4.infinity_norm() != 0.0 || m_4.base().infinity_norm() != 0.0)
+    {
+      std::cerr << name << ": colored assembly depends on the number of threads" << std::endl;
+      passed = false;
+    }
+
+  // ... and agree with the sequential traversal up to round-off
+  r_1 -= r_seq;
+  m_1.base() -= m_seq.base();
+  if (r_1.infinity_norm() > 1e-12 || m_1.base().infinity_norm() > 1e-12)
+    {
+      std::cerr << name << ": colored assembly differs from sequential assembly" << std::endl;
+      passed = false;
+    }
+
+  return passed;
+}
+
+// convection-diffusion-reaction problem with all terms present
+template<typename GV, typename RF>
+class DGProblem
+  : public Dune::PDELab::ConvectionDiffusionModelProblem<GV,RF>
+{
+public:
+  typedef Dune::PDELab::ConvectionDiffusionParameterTraits<GV,RF> Traits;
+
+  //! velocity field
+  typename Traits::RangeType
+  b (const typename Traits::ElementType& e, const typename Traits::DomainType& x) const
+  {
+    typename Traits::RangeType v(0.5);
+    v[0] = 1.0;
+    return v;
+  }
+
+  //! sink term
+  typename Traits::RangeFieldType
+  c (const typename Traits::ElementType& e, const typename Traits::DomainType& x) const
+  {
+    return 1.0;
+  }
+};
+
+template<typename GV, typename FEM>
+bool testColoredDGAssembly (const GV& gv, const FEM& fem, std::string name)
+{
+  typedef double R;
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef DGProblem<GV,R> Param;
+  Param param;
+
+  typedef Dune::PDELab::ConvectionDiffusionDG<Param,FEM> LOP;
+  LOP lop(param,Dune::PDELab::ConvectionDiffusionDGMethod::SIPG,
+          Dune::PDELab::ConvectionDiffusionDGWeights::weightsOn,2.0);
+
+  typedef Dune::PDELab::EmptyTransformation C;
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,gfs,lop,MBE(2*GV::dimension+1));
+
+  typedef typename GO::Traits::Domain V;
+  typedef typename GO::Traits::Jacobian M;
+
+  V x(gfs,0.0);
+  for (std::size_t i = 0; i < x.base().N(); ++i)
+    x.base()[i] = std::sin(1.0 + i);
+
+  // reference: sequential traversal
+  V r_seq(gfs,0.0);
+  M m_seq(go);
+  m_seq = 0.0;
+  go.residual(x,r_seq);
+  go.jacobian(x,m_seq);
+
+  // colored assembly with several threads
+  go.assembler().setColoredAssembly(true);
+  go.assembler().setThreads(4);
+  V r_4(gfs,0.0);
+  M m_4(go);
+  m_4 = 0.0;
+  go.residual(x,r_4);
+  go.jacobian(x,m_4);
+
+  std::cout << name << ": " << go.assembler().coloring(true).colors() << " colors for "
+            << go.assembler().coloring(true).size() << " cells" << std::endl;
+
+  bool passed = true;
+
+  if (!go.assembler().coloring().includesNeighbors())
+    {
+      std::cerr << name << ": coloring for skeleton terms does not include the neighbors" << std::endl;
+      passed = false;
+    }
+
+  r_4 -= r_seq;
+  m_4.base() -= m_seq.base();
+  if (r_4.infinity_norm() > 1e-12 || m_4.base().infinity_norm() > 1e-12)
+    {
+      std::cerr << name << ": colored assembly differs from sequential assembly" << std::endl;
+      passed = false;
+    }
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    // YaspGrid Q1 2D test
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(1));
+      Dune::YaspGrid<2> grid(L,N);
+      grid.globalRefine(4);
+
+      typedef Dune::YaspGrid<2>::LeafGridView GV;
+      const GV& gv=grid.leafGridView();
+
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+      FEM fem(gv);
+
+      passed &= testColoredAssembly(gv,fem,"yasp_Q1_2d");
+    }
+
+    // YaspGrid Q2 3D test
+    {
+      Dune::FieldVector<double,3> L(1.0);
+      Dune::array<int,3> N(Dune::fill_array<int,3>(1));
+      Dune::YaspGrid<3> grid(L,N);
+      grid.globalRefine(2);
+
+      typedef Dune::YaspGrid<3>::LeafGridView GV;
+      const GV& gv=grid.leafGridView();
+
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,2> FEM;
+      FEM fem(gv);
+
+      passed &= testColoredAssembly(gv,fem,"yasp_Q2_3d");
+    }
+
+    // YaspGrid DG Q2 2D test
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(1));
+      Dune::YaspGrid<2> grid(L,N);
+      grid.globalRefine(4);
+
+      typedef Dune::YaspGrid<2>::LeafGridView GV;
+      const GV& gv=grid.leafGridView();
+
+      typedef Dune::PDELab::QkDGLocalFiniteElementMap<double,double,2,2> FEM;
+      FEM fem;
+
+      passed &= testColoredDGAssembly(gv,fem,"yasp_dg_Q2_2d");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
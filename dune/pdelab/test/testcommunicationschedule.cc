@@ -0,0 +1,159 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <bitset>
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/constraints/conforming.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/genericdatahandle.hh>
+#include <dune/pdelab/gridfunctionspace/communicationschedule.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+
+//===============================================================
+// Exchanges vector data with a precomputed communication schedule
+// and through the grid and checks that the results agree. On a
+// single process there are no neighbors, the test is therefore
+// also run on 2 and 4 processes (see MPITESTS).
+//===============================================================
+
+template<typename GFS, typename V>
+void fill (const GFS& gfs, V& v)
+{
+  typedef typename V::ElementType R;
+  R value = gfs.gridView().comm().rank();
+  for (typename V::iterator it = v.begin(); it != v.end(); ++it)
+    *it = (value += 1.0);
+}
+
+template<typename GFS, typename GatherScatter>
+bool compare (const GFS& gfs, Dune::InterfaceType interface, GatherScatter gather_scatter, std::string name)
+{
+  typedef typename Dune::PDELab::BackendVectorSelector<GFS,double>::Type V;
+  V x(gfs), y(gfs);
+  fill(gfs,x);
+  fill(gfs,y);
+
+  Dune::PDELab::GFSDataHandle<GFS,V,Dune::PDELab::DataGatherScatter<GatherScatter> >
+    data_handle(gfs,x,Dune::PDELab::DataGatherScatter<GatherScatter>(gather_scatter));
+  gfs.gridView().communicate(data_handle,interface,Dune::ForwardCommunication);
+
+  Dune::PDELab::GFSCommunicationSchedule<GFS> schedule(gfs,interface);
+  bool passed = true;
+  if (gfs.gridView().comm().size() > 1 && gfs.gridView().comm().min(schedule.neighbors()) == 0)
+    {
+      std::cerr << name << ": some process has no neighbors in the schedule" << std::endl;
+      passed = false;
+    }
+  // the second run reuses the buffers and requests
+  for (int run = 0; run < 2; ++run)
+    {
+      if (run > 0)
+        fill(gfs,y);
+      schedule.communicate(y,gather_scatter);
+
+      V d(y);
+      d -= x;
+      const double difference = gfs.gridView().comm().max(d.infinity_norm());
+      if (gfs.gridView().comm().rank() == 0)
+        std::cout << name << ": " << gfs.gridView().comm().size() << " processes, run " << run
+                  << ", difference " << difference << std::endl;
+      if (difference > 1e-12)
+        {
+          std::cerr << name << ": scheduled communication differs from grid communication" << std::endl;
+          passed = false;
+        }
+    }
+  return passed;
+}
+
+template<typename GV>
+bool testOverlapping (const GV& gv, std::string name)
+{
+  typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,2> FEM;
+  FEM fem(gv);
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,
+    Dune::PDELab::OverlappingConformingDirichletConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  bool passed = true;
+  passed &= compare(gfs,Dune::All_All_Interface,Dune::PDELab::AddGatherScatter(),name + "_add_all_all");
+  passed &= compare(gfs,Dune::InteriorBorder_All_Interface,Dune::PDELab::AddGatherScatter(),name + "_add_interiorborder_all");
+  passed &= compare(gfs,Dune::InteriorBorder_All_Interface,Dune::PDELab::MinGatherScatter(),name + "_min_interiorborder_all");
+  passed &= compare(gfs,Dune::InteriorBorder_All_Interface,Dune::PDELab::CopyGatherScatter(),name + "_copy_interiorborder_all");
+  passed &= compare(gfs,Dune::All_All_Interface,Dune::PDELab::MaxGatherScatter(),name + "_max_all_all");
+  return passed;
+}
+
+template<typename GV>
+bool testNonoverlapping (const GV& gv, std::string name)
+{
+  typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,2> FEM;
+  FEM fem(gv);
+
+  typedef Dune::PDELab::NonoverlappingConformingDirichletConstraints<GV> CON;
+  CON con(gv);
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,CON,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem,con);
+  con.compute_ghosts(gfs);
+
+  bool passed = true;
+  passed &= compare(gfs,Dune::InteriorBorder_InteriorBorder_Interface,Dune::PDELab::AddGatherScatter(),name + "_add_interiorborder_interiorborder");
+  passed &= compare(gfs,Dune::InteriorBorder_InteriorBorder_Interface,Dune::PDELab::MinGatherScatter(),name + "_min_interiorborder_interiorborder");
+  passed &= compare(gfs,Dune::InteriorBorder_InteriorBorder_Interface,Dune::PDELab::MaxGatherScatter(),name + "_max_interiorborder_interiorborder");
+  passed &= compare(gfs,Dune::InteriorBorder_InteriorBorder_Interface,Dune::PDELab::CopyGatherScatter(),name + "_copy_interiorborder_interiorborder");
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper& helper = Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    // YaspGrid Q2 2D test, overlapping
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(16));
+      std::bitset<2> B(false);
+      Dune::YaspGrid<2> grid(helper.getCommunicator(),L,N,B,1);
+
+      passed &= testOverlapping(grid.leafGridView(),"yasp_Q2_2d_ovlp");
+    }
+
+    // YaspGrid Q2 2D test, nonoverlapping
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(16));
+      std::bitset<2> B(false);
+      Dune::YaspGrid<2> grid(helper.getCommunicator(),L,N,B,0);
+
+      passed &= testNonoverlapping(grid.leafGridView(),"yasp_Q2_2d_novlp");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
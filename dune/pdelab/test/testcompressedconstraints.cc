@@ -0,0 +1,279 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/constraints/common/constraints.hh>
+#include <dune/pdelab/constraints/common/constraintsparameters.hh>
+#include <dune/pdelab/constraints/conforming.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/powergridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/localfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/lfsindexcache.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/localoperator/l2.hh>
+
+//===============================================================
+// Builds the compressed constraints container from the map based
+// one and checks that both describe the same constraints and lead
+// to the same assembled operator, for Dirichlet constraints and for
+// constraints with weighted rows like those of hanging nodes
+//===============================================================
+
+// Adds weighted constraint rows to cc: every fifth unconstrained DOF (in the order of the
+// container indices) is constrained to the next two DOFs, which remain unconstrained. The
+// entries are inserted with the larger container index first, so the compressed container
+// has to sort them.
+template<typename GFS, typename CC>
+void addWeightedConstraints (const GFS& gfs, CC& cc)
+{
+  typedef typename GFS::Ordering::Traits::ContainerIndex CI;
+  typedef Dune::PDELab::LocalFunctionSpace<GFS> LFS;
+  typedef Dune::PDELab::LFSIndexCache<LFS> LFSCache;
+  typedef typename GFS::Traits::GridViewType GV;
+  typedef typename GV::template Codim<0>::Iterator ElementIterator;
+
+  LFS lfs(gfs);
+  LFSCache lfs_cache(lfs);
+  std::set<CI> dofs;
+  for (ElementIterator it = gfs.gridView().template begin<0>(); it != gfs.gridView().template end<0>(); ++it)
+    {
+      lfs.bind(*it);
+      lfs_cache.update();
+      for (std::size_t i = 0; i < lfs_cache.size(); ++i)
+        if (cc.find(lfs_cache.containerIndex(i)) == cc.end())
+          dofs.insert(lfs_cache.containerIndex(i));
+    }
+
+  std::vector<CI> free_dofs(dofs.begin(),dofs.end());
+  for (std::size_t i = 0; i + 2 < free_dofs.size(); i += 5)
+    {
+      typename CC::mapped_type& row = cc[free_dofs[i]];
+      row[free_dofs[i+2]] = 0.75;
+      row[free_dofs[i+1]] = 0.25;
+    }
+}
+
+template<typename GFS, typename CC, typename CCC>
+bool compareConstraints (const GFS& gfs, const CC& cc, const CCC& ccc, std::string name)
+{
+  if (cc.size() != ccc.size())
+    {
+      std::cerr << name << ": " << ccc.size() << " compressed rows, "
+                << cc.size() << " constrained DOFs" << std::endl;
+      return false;
+    }
+
+  // every row of the map is found with the same entries
+  for (typename CC::const_iterator it = cc.begin(); it != cc.end(); ++it)
+    {
+      typename CCC::const_iterator cit = ccc.find(it->first);
+      if (cit == ccc.end() || !(cit->first == it->first) || cit->second.size() != it->second.size())
+        {
+          std::cerr << name << ": constraint row " << it->first << " differs" << std::endl;
+          return false;
+        }
+      for (typename CCC::mapped_type::const_iterator eit = cit->second.begin(); eit != cit->second.end(); ++eit)
+        {
+          typename CC::mapped_type::const_iterator mit = it->second.find(eit->first);
+          if (mit == it->second.end() || mit->second != eit->second)
+            {
+              std::cerr << name << ": entry of constraint row " << it->first << " differs" << std::endl;
+              return false;
+            }
+        }
+    }
+
+  // rows and the entries of each row are sorted by container index
+  for (typename CCC::const_iterator it = ccc.begin(); it != ccc.end(); ++it)
+    {
+      if (it != ccc.begin() && !((it-1)->first < it->first))
+        {
+          std::cerr << name << ": compressed rows are not sorted" << std::endl;
+          return false;
+        }
+      for (typename CCC::mapped_type::const_iterator eit = it->second.begin(); eit != it->second.end(); ++eit)
+        if (eit != it->second.begin() && !((eit-1)->first < eit->first))
+          {
+            std::cerr << name << ": entries of row " << it->first << " are not sorted" << std::endl;
+            return false;
+          }
+      if (!ccc.contains(it->first))
+        {
+          std::cerr << name << ": row " << it->first << " is not flagged" << std::endl;
+          return false;
+        }
+    }
+
+  // the unconstrained DOFs are not flagged
+  typedef typename Dune::PDELab::BackendVectorSelector<GFS,double>::Type V;
+  V x(gfs,1.0), y(gfs,1.0);
+  Dune::PDELab::set_constrained_dofs(cc,0.0,x);
+  Dune::PDELab::set_constrained_dofs(ccc,0.0,y);
+  y -= x;
+  if (y.infinity_norm() != 0.0)
+    {
+      std::cerr << name << ": set_constrained_dofs() differs" << std::endl;
+      return false;
+    }
+
+  std::cout << name << ": " << ccc.size() << " constrained DOFs, "
+            << ccc.entries() << " entries" << std::endl;
+  return true;
+}
+
+template<typename GV>
+bool testScalar (const GV& gv, bool weighted, std::string name)
+{
+  typedef double R;
+
+  typedef Dune::PDELab::QkLocalFiniteElementMap<GV,R,R,1> FEM;
+  FEM fem(gv);
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,
+    Dune::PDELab::ConformingDirichletConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef typename GFS::template ConstraintsContainer<R>::Type CC;
+  CC cc;
+  Dune::PDELab::DirichletConstraintsParameters constraintsparameters;
+  Dune::PDELab::constraints(constraintsparameters,gfs,cc);
+  if (weighted)
+    addWeightedConstraints(gfs,cc);
+
+  typedef Dune::PDELab::CompressedConstraintsTransformation<GFS,R> CCC;
+  CCC ccc(gfs,cc);
+
+  bool passed = compareConstraints(gfs,cc,ccc,name);
+  if (weighted && ccc.entries() == 0)
+    {
+      std::cerr << name << ": no weighted constraint rows" << std::endl;
+      passed = false;
+    }
+
+  // a copy has to refer to its own entries
+  CCC ccc_copy(ccc);
+  ccc = CCC(gfs,CC());
+  passed &= compareConstraints(gfs,cc,ccc_copy,name + "_copy");
+
+  typedef Dune::PDELab::L2 LOP;
+  LOP lop(2);
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  MBE mbe(9);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,CC,CC> GO;
+  GO go(gfs,cc,gfs,cc,lop,mbe);
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,CCC,CCC> CGO;
+  CGO cgo(gfs,ccc_copy,gfs,ccc_copy,lop,mbe);
+
+  typedef typename GO::Traits::Domain V;
+  V x(gfs);
+  R value = 0.0;
+  for (typename V::iterator it = x.begin(); it != x.end(); ++it)
+    *it = (value += 1.0);
+
+  // residuals
+  V r(gfs,0.0), cr(gfs,0.0);
+  go.residual(x,r);
+  cgo.residual(x,cr);
+  cr -= r;
+
+  // matrix vector products with the assembled jacobians
+  typename GO::Traits::Jacobian A(go);
+  A = 0.0;
+  go.jacobian(x,A);
+  typename CGO::Traits::Jacobian CA(cgo);
+  CA = 0.0;
+  cgo.jacobian(x,CA);
+  V y(gfs,0.0), cy(gfs,0.0);
+  A.base().mv(x.base(),y.base());
+  CA.base().mv(x.base(),cy.base());
+  cy -= y;
+
+  std::cout << name << ": residual difference " << cr.infinity_norm()
+            << ", jacobian difference " << cy.infinity_norm() << std::endl;
+  if (cr.infinity_norm() > 1e-12 || cy.infinity_norm() > 1e-12)
+    {
+      std::cerr << name << ": operators assembled with compressed constraints differ" << std::endl;
+      passed = false;
+    }
+
+  return passed;
+}
+
+template<typename GV>
+bool testBlocked (const GV& gv, std::string name)
+{
+  typedef double R;
+
+  typedef Dune::PDELab::QkLocalFiniteElementMap<GV,R,R,1> FEM;
+  FEM fem(gv);
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,
+    Dune::PDELab::ConformingDirichletConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  // blocked container indices with two levels
+  typedef Dune::PDELab::PowerGridFunctionSpace<GFS,2,
+    Dune::PDELab::ISTLVectorBackend<Dune::PDELab::ISTLParameters::static_blocking,2> > PGFS;
+  PGFS pgfs(gfs);
+
+  typedef typename PGFS::template ConstraintsContainer<R>::Type CC;
+  CC cc;
+  Dune::PDELab::DirichletConstraintsParameters constraintsparameters;
+  Dune::PDELab::PowerConstraintsParameters<Dune::PDELab::DirichletConstraintsParameters,2>
+    powerconstraintsparameters(constraintsparameters);
+  Dune::PDELab::constraints(powerconstraintsparameters,pgfs,cc);
+
+  typedef Dune::PDELab::CompressedConstraintsTransformation<PGFS,R> CCC;
+  CCC ccc(pgfs,cc);
+
+  return compareConstraints(pgfs,cc,ccc,name);
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    // YaspGrid Q1 2D test
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(8));
+      Dune::YaspGrid<2> grid(L,N);
+
+      passed &= testScalar(grid.leafGridView(),false,"yasp_Q1_2d");
+      passed &= testScalar(grid.leafGridView(),true,"yasp_Q1_2d_weighted");
+      passed &= testBlocked(grid.leafGridView(),"yasp_Q1_2d_blocked");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
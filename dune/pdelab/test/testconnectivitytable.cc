@@ -0,0 +1,260 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/finiteelementmap/qkdg.hh>
+#include <dune/pdelab/constraints/common/constraints.hh>
+#include <dune/pdelab/constraints/conforming.hh>
+#include <dune/pdelab/gridfunctionspace/connectivitytable.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/vectorgridfunctionspace.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/localoperator/convectiondiffusionparameter.hh>
+#include <dune/pdelab/localoperator/convectiondiffusionfem.hh>
+#include <dune/pdelab/localoperator/convectiondiffusiondg.hh>
+#include <dune/pdelab/localoperator/linearelasticity.hh>
+
+#include "assemblycomparison.hh"
+
+//===============================================================
+// Checks that updating the index caches from precomputed
+// connectivity tables gives exactly the same residuals and
+// jacobians as the default update, for a scalar and a blocked
+// conforming space with Dirichlet constraints and for a DG space,
+// whose skeleton terms bind the neighbors of each cell, and that
+// the tables are rebuilt after the constraints have changed
+//===============================================================
+
+template<typename GFS>
+bool checkTable (const GFS& gfs, std::string name)
+{
+  typedef Dune::PDELab::LocalFunctionSpace<GFS> LFS;
+  typedef Dune::PDELab::LFSIndexCache<LFS> LFSCache;
+  typedef typename GFS::Traits::GridViewType GV;
+
+  Dune::PDELab::GFSConnectivityTable<GFS> table(gfs);
+  LFS lfs(gfs);
+  LFSCache lfs_cache(lfs);
+  Dune::PDELab::ElementMapper<GV> cell_mapper(gfs.gridView());
+
+  bool passed = table.valid(gfs) && table.cells() == gfs.gridView().size(0);
+  for (typename GV::template Codim<0>::Iterator it = gfs.gridView().template begin<0>();
+       it != gfs.gridView().template end<0>(); ++it)
+    {
+      lfs.bind(*it);
+      lfs_cache.update();
+      const std::size_t cell = cell_mapper.map(*it);
+      if (table.size(cell) != lfs_cache.size())
+        {
+          passed = false;
+          continue;
+        }
+      for (std::size_t i = 0; i < lfs_cache.size(); ++i)
+        passed &= table.containerIndices(cell)[i] == lfs_cache.containerIndex(i);
+    }
+
+  if (!passed)
+    std::cerr << name << ": connectivity table differs from the index cache" << std::endl;
+  return passed;
+}
+
+// Checks that tables built for a constraints container are invalidated when the
+// container is exchanged or its constraints change, and that the assembler rebuilds
+// its tables after the constraints have been removed
+template<typename GO, typename C>
+bool checkConstraintsChange (GO& go, C& cg, std::string name)
+{
+  typedef typename GO::Traits::TrialGridFunctionSpace GFS;
+  typedef typename GO::Traits::Domain V;
+  typedef typename GO::Traits::Jacobian M;
+  const GFS& gfs = go.trialGridFunctionSpace();
+
+  Dune::PDELab::GFSConnectivityTable<GFS> table(gfs,cg);
+  const C other(cg);
+  bool passed = table.valid(gfs,cg) && !table.valid(gfs,other) && !table.valid(gfs);
+
+  V x(gfs);
+  fillCoefficients(x);
+  V r(go.testGridFunctionSpace(),0.0), tr(go.testGridFunctionSpace(),0.0);
+  M m(go), tm(go);
+  m = 0.0;
+  tm = 0.0;
+
+  // build the tables of the assembler with the constraints in place
+  go.assembler().setPrecomputedConnectivity(true);
+  go.residual(x,tr);
+  tr = 0.0;
+
+  cg.clear();
+  passed &= !table.valid(gfs,cg);
+
+  go.residual(x,tr);
+  go.jacobian(x,tm);
+  go.assembler().setPrecomputedConnectivity(false);
+  go.residual(x,r);
+  go.jacobian(x,m);
+
+  passed &= compareResults(tr,tm,r,m,0.0,name + " (constraints removed)","assembly with connectivity tables");
+  if (!passed)
+    std::cerr << name << ": connectivity tables are not invalidated by changed constraints" << std::endl;
+  return passed;
+}
+
+template<typename GV, typename FEM>
+bool testConvectionDiffusion (const GV& gv, const FEM& fem, int degree, std::string name)
+{
+  typedef double R;
+  const int dim = GV::dimension;
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::ConformingDirichletConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef Dune::PDELab::ConvectionDiffusionModelProblem<GV,R> Problem;
+  Problem problem;
+  Dune::PDELab::ConvectionDiffusionBoundaryConditionAdapter<Problem> bctype(gv,problem);
+
+  typedef typename GFS::template ConstraintsContainer<R>::Type C;
+  C cg;
+  Dune::PDELab::constraints(bctype,gfs,cg);
+
+  typedef Dune::PDELab::ConvectionDiffusionFEM<Problem,FEM> LOP;
+  LOP lop(problem);
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  int entries = 1;
+  for (int i = 0; i < dim; ++i)
+    entries *= 2*degree+1;
+  MBE mbe(entries);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,cg,gfs,cg,lop,mbe);
+
+  bool passed = checkTable(gfs,name);
+  passed &= compareAssemblyModes(go,&GO::Traits::Assembler::setPrecomputedConnectivity,
+                                 name,"assembly with connectivity tables");
+  passed &= checkConstraintsChange(go,cg,name);
+  return passed;
+}
+
+template<typename GV, typename FEM>
+bool testElasticity (const GV& gv, const FEM& fem, std::string name)
+{
+  typedef double R;
+  const int dim = GV::dimension;
+
+  typedef Dune::PDELab::VectorGridFunctionSpace<GV,FEM,dim,
+    Dune::PDELab::ISTLVectorBackend<>,
+    Dune::PDELab::ISTLVectorBackend<>,
+    Dune::PDELab::ConformingDirichletConstraints> GFS;
+  GFS gfs(gv,fem);
+
+  typedef ElasticityProblem<GV> Problem;
+  Problem problem;
+
+  typedef typename GFS::template ConstraintsContainer<R>::Type C;
+  C cg;
+  Dune::PDELab::constraints(problem,gfs,cg);
+
+  typedef Dune::PDELab::LinearElasticity<Problem> LOP;
+  LOP lop(problem);
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  MBE mbe(9*dim);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,cg,gfs,cg,lop,mbe);
+
+  bool passed = checkTable(gfs,name);
+  passed &= compareAssemblyModes(go,&GO::Traits::Assembler::setPrecomputedConnectivity,
+                                 name,"assembly with connectivity tables");
+  passed &= checkConstraintsChange(go,cg,name);
+  return passed;
+}
+
+template<typename GV, typename FEM>
+bool testConvectionDiffusionDG (const GV& gv, const FEM& fem, std::string name)
+{
+  typedef double R;
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef Dune::PDELab::ConvectionDiffusionModelProblem<GV,R> Problem;
+  Problem problem;
+
+  typedef Dune::PDELab::ConvectionDiffusionDG<Problem,FEM> LOP;
+  LOP lop(problem,Dune::PDELab::ConvectionDiffusionDGMethod::SIPG,
+          Dune::PDELab::ConvectionDiffusionDGWeights::weightsOn,2.0);
+
+  typedef Dune::PDELab::EmptyTransformation C;
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,gfs,lop,MBE(2*GV::dimension+1));
+
+  bool passed = checkTable(gfs,name);
+  passed &= compareAssemblyModes(go,&GO::Traits::Assembler::setPrecomputedConnectivity,
+                                 name,"assembly with connectivity tables");
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(16));
+    Dune::YaspGrid<2> grid(L,N);
+
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    const GV& gv=grid.leafGridView();
+
+    {
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+      FEM fem(gv);
+      passed &= testConvectionDiffusion(gv,fem,1,"convectiondiffusionfem_Q1_2d");
+    }
+    {
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,2> FEM;
+      FEM fem(gv);
+      passed &= testConvectionDiffusion(gv,fem,2,"convectiondiffusionfem_Q2_2d");
+    }
+    {
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+      FEM fem(gv);
+      passed &= testElasticity(gv,fem,"linearelasticity_Q1_2d");
+    }
+    {
+      typedef Dune::PDELab::QkDGLocalFiniteElementMap<double,double,2,2> FEM;
+      FEM fem;
+      passed &= testConvectionDiffusionDG(gv,fem,"convectiondiffusiondg_Q2_2d");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
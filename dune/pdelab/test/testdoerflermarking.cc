@@ -0,0 +1,185 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/finiteelementmap/p0fem.hh>
+#include <dune/pdelab/constraints/common/constraints.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/interpolate.hh>
+#include <dune/pdelab/common/function.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/adaptivity/adaptivity.hh>
+
+//===============================================================
+// Checks the thresholds of the error and element fraction
+// strategies and the marking of the grid with them
+//===============================================================
+
+template<typename GV, typename RF>
+class Indicator
+  : public Dune::PDELab::AnalyticGridFunctionBase<Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1>,
+                                                  Indicator<GV,RF> >
+{
+public:
+  typedef Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1> Traits;
+  typedef Dune::PDELab::AnalyticGridFunctionBase<Traits,Indicator<GV,RF> > BaseT;
+
+  Indicator (const GV& gv) : BaseT(gv) {}
+  inline void evaluateGlobal (const typename Traits::DomainType& x,
+                              typename Traits::RangeType& y) const
+  {
+    typename Traits::DomainType center(0.3);
+    center -= x;
+    y = exp(-50.0*center.two_norm2());
+    // a few cells without any error
+    if (x[0] > 0.9)
+      y = 0.0;
+  }
+};
+
+// The fraction of the error or of the elements above and below the thresholds
+template<typename V>
+void fractions(const V& x, double eta_alpha, double eta_beta, bool weighted,
+               double& alpha_fraction, double& beta_fraction)
+{
+  double total = 0.0;
+  double above = 0.0;
+  double below = 0.0;
+  for (typename V::const_iterator it = x.begin(); it != x.end(); ++it)
+    {
+      const double w = weighted ? *it : 1.0;
+      total += w;
+      if (*it >= eta_alpha)
+        above += w;
+      if (*it < eta_beta)
+        below += w;
+    }
+  alpha_fraction = above/total;
+  beta_fraction = below/total;
+}
+
+template<typename Grid>
+bool testDoerflerMarking (Grid& grid, std::string name)
+{
+  typedef typename Grid::LeafGridView GV;
+  const GV gv = grid.leafGridView();
+
+  Dune::GeometryType gt;
+  gt.makeCube(GV::dimension);
+  typedef Dune::PDELab::P0LocalFiniteElementMap<double,double,GV::dimension> FEM;
+  FEM fem(gt);
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef typename Dune::PDELab::BackendVectorSelector<GFS,double>::Type V;
+  V x(gfs,0.0);
+  Indicator<GV,double> indicator(gv);
+  Dune::PDELab::interpolate(indicator,gfs,x);
+
+  const double alpha = 0.5;
+  const double beta = 0.1;
+  const double tolerance = 0.01;
+  bool passed = true;
+
+  // error fraction
+  double eta_alpha, eta_beta, alpha_fraction, beta_fraction;
+  Dune::PDELab::error_fraction(x,alpha,beta,eta_alpha,eta_beta,1);
+  fractions(x,eta_alpha,eta_beta,true,alpha_fraction,beta_fraction);
+  std::cout << name << ": error fractions " << alpha_fraction << " " << beta_fraction << std::endl;
+  if (std::abs(alpha_fraction - alpha) > tolerance || std::abs(beta_fraction - beta) > tolerance)
+    {
+      std::cerr << name << ": error fraction thresholds are off" << std::endl;
+      passed = false;
+    }
+
+  // element fraction
+  double eta_alpha_elements, eta_beta_elements;
+  Dune::PDELab::element_fraction(x,alpha,beta,eta_alpha_elements,eta_beta_elements,1);
+  fractions(x,eta_alpha_elements,eta_beta_elements,false,alpha_fraction,beta_fraction);
+  std::cout << name << ": element fractions " << alpha_fraction << " " << beta_fraction << std::endl;
+  if (std::abs(alpha_fraction - alpha) > tolerance || std::abs(beta_fraction - beta) > tolerance)
+    {
+      std::cerr << name << ": element fraction thresholds are off" << std::endl;
+      passed = false;
+    }
+
+  // the marking has to arrive at the same thresholds independent of the number of threads
+  // and mark exactly the cells above and below them
+  Dune::PDELab::DoerflerMarking<Grid,V> marking(grid,x);
+  for (int threads = 1; threads <= 4; threads *= 2)
+    {
+      marking.setThreads(threads);
+      marking.update();
+      double marking_eta_alpha, marking_eta_beta;
+      marking.errorFraction(alpha,beta,marking_eta_alpha,marking_eta_beta);
+      if (std::abs(marking_eta_alpha - eta_alpha) > 1e-12*eta_alpha ||
+          std::abs(marking_eta_beta - eta_beta) > 1e-12*eta_alpha)
+        {
+          std::cerr << name << ": DoerflerMarking with " << threads
+                    << " threads computed different thresholds" << std::endl;
+          passed = false;
+        }
+    }
+
+  std::size_t refine = 0;
+  std::size_t coarsen = 0;
+  for (typename V::const_iterator it = x.begin(); it != x.end(); ++it)
+    {
+      if (*it >= eta_alpha)
+        ++refine;
+      if (*it <= eta_beta)
+        ++coarsen;
+    }
+  // all cells are on level 1, so coarsening is possible everywhere
+  marking.mark(eta_alpha,eta_beta,0,std::numeric_limits<int>::max(),1);
+  if (marking.refined() != refine || marking.coarsened() != coarsen)
+    {
+      std::cerr << name << ": DoerflerMarking marked the wrong number of cells" << std::endl;
+      passed = false;
+    }
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    // YaspGrid 2D test
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(32));
+      Dune::YaspGrid<2> grid(L,N);
+      grid.globalRefine(1);
+
+      passed &= testDoerflerMarking(grid,"yasp_2d");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
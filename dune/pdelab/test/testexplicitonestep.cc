@@ -0,0 +1,381 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/finiteelementmap/p0fem.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/backend/seqistlsolverbackend.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/gridoperator/onestep.hh>
+#include <dune/pdelab/instationary/onestep.hh>
+#include <dune/pdelab/localoperator/defaultimp.hh>
+#include <dune/pdelab/localoperator/flags.hh>
+#include <dune/pdelab/localoperator/idefault.hh>
+#include <dune/pdelab/localoperator/l2.hh>
+#include <dune/pdelab/localoperator/pattern.hh>
+
+//===============================================================
+// Solves du/dt = -u with explicit Runge-Kutta methods, once with
+// the mass matrix assembled in every stage and once with the mass
+// matrix and its inverse kept for all steps, and compares both to
+// the amplification factor of the method. The same is done for
+// the low-storage schemes. Finally, for both kinds of methods,
+// the constant mass matrix is switched on and off between steps for a mass matrix that
+// depends on time, which has to give the same solutions as a new
+// method started from the same state.
+//===============================================================
+
+// Temporal operator (1 + t) u for P0 spaces
+class TimeDependentMass
+  : public Dune::PDELab::NumericalJacobianApplyVolume<TimeDependentMass>
+  , public Dune::PDELab::FullVolumePattern
+  , public Dune::PDELab::LocalOperatorDefaultFlags
+  , public Dune::PDELab::InstationaryLocalOperatorDefaultMethods<double>
+{
+public:
+  enum { doPatternVolume = true };
+  enum { doAlphaVolume = true };
+
+  template<typename EG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r) const
+  {
+    r.accumulate(lfsv,0,(1.0 + getTime())*x(lfsu,0)*eg.geometry().volume());
+  }
+
+  template<typename EG, typename LFSU, typename X, typename LFSV, typename M>
+  void jacobian_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, M& mat) const
+  {
+    mat.accumulate(lfsv,0,lfsu,0,(1.0 + getTime())*eg.geometry().volume());
+  }
+};
+
+template<typename GV>
+bool testExplicitOneStep (const GV& gv, bool constant_mass, std::string name)
+{
+  typedef double R;
+  const int dim = GV::dimension;
+
+  Dune::GeometryType gt;
+  gt.makeCube(dim);
+  typedef Dune::PDELab::P0LocalFiniteElementMap<typename GV::Grid::ctype,R,dim> FEM;
+  FEM fem(gt);
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  // the spatial and the temporal operator are both the L2 product
+  typedef Dune::PDELab::L2 LOP;
+  LOP lop(2);
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  MBE mbe(1);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R> GO0;
+  GO0 go0(gfs,gfs,lop,mbe);
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R> GO1;
+  GO1 go1(gfs,gfs,lop,mbe);
+
+  typedef Dune::PDELab::OneStepGridOperator<GO0,GO1,false> IGO;
+  IGO igo(go0,go1);
+
+  typedef typename IGO::Traits::Domain V;
+  typedef Dune::PDELab::ISTLBackend_SEQ_ExplicitDiagonal LS;
+  LS ls;
+
+  Dune::PDELab::RK4Parameter<R> rk4;
+  Dune::PDELab::HeunParameter<R> heun;
+  Dune::PDELab::ExplicitOneStepMethod<R,IGO,LS,V,V> osm(rk4,igo,ls);
+  osm.setVerbosityLevel(0);
+  osm.setConstantMassMatrix(constant_mass);
+
+  const R dt = 0.1;
+  R time = 0.0;
+  R exact = 1.0;
+  V uold(gfs,1.0), unew(gfs,1.0);
+
+  // the number of stages decreases after the first steps
+  for (int i = 0; i < 10; ++i)
+    {
+      if (i == 5)
+        osm.setMethod(heun);
+      osm.apply(time,dt,uold,unew);
+      uold = unew;
+      time += dt;
+      exact *= (i < 5) ? 1.0 - dt + dt*dt/2.0 - dt*dt*dt/6.0 + dt*dt*dt*dt/24.0
+        : 1.0 - dt + dt*dt/2.0;
+    }
+
+  V error(gfs,exact);
+  error -= unew;
+  const R e = error.infinity_norm();
+
+  std::cout << name << ": constant mass matrix " << constant_mass
+            << ", reused inverse " << ls.getReuse()
+            << ", error " << e << std::endl;
+
+  if (constant_mass != ls.getReuse())
+    {
+      std::cerr << name << ": inverse of the mass matrix has not been reused" << std::endl;
+      return false;
+    }
+  if (e > 1e-12)
+    {
+      std::cerr << name << ": solution does not match the amplification factor" << std::endl;
+      return false;
+    }
+  return true;
+}
+
+// Runs the 2N-storage recursion for du/dt = -u with a scalar
+template<typename R>
+R lowStorageAmplification (const Dune::PDELab::LowStorageRKParameterInterface<R>& method, R dt)
+{
+  R u = 1.0, du = 0.0;
+  for (unsigned r = 1; r <= method.s(); ++r)
+    {
+      du = method.a(r)*du - dt*u;
+      u += method.b(r)*du;
+    }
+  return u;
+}
+
+template<typename GV>
+bool testLowStorage (const GV& gv, const Dune::PDELab::LowStorageRKParameterInterface<double>& method,
+                     bool constant_mass, std::string name)
+{
+  typedef double R;
+  const int dim = GV::dimension;
+
+  Dune::GeometryType gt;
+  gt.makeCube(dim);
+  typedef Dune::PDELab::P0LocalFiniteElementMap<typename GV::Grid::ctype,R,dim> FEM;
+  FEM fem(gt);
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef Dune::PDELab::L2 LOP;
+  LOP lop(2);
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  MBE mbe(1);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R> GO0;
+  GO0 go0(gfs,gfs,lop,mbe);
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R> GO1;
+  GO1 go1(gfs,gfs,lop,mbe);
+
+  typedef Dune::PDELab::OneStepGridOperator<GO0,GO1,false> IGO;
+  IGO igo(go0,go1);
+
+  typedef typename IGO::Traits::Domain V;
+  typedef Dune::PDELab::ISTLBackend_SEQ_ExplicitDiagonal LS;
+  LS ls;
+
+  Dune::PDELab::LowStorageExplicitOneStepMethod<R,IGO,LS,V,V> osm(method,igo,ls);
+  osm.setVerbosityLevel(0);
+  osm.setConstantMassMatrix(constant_mass);
+
+  const R dt = 0.1;
+  R time = 0.0;
+  R exact = 1.0;
+  V uold(gfs,1.0), unew(gfs,1.0);
+
+  for (int i = 0; i < 10; ++i)
+    {
+      osm.apply(time,dt,uold,unew);
+      uold = unew;
+      time += dt;
+      exact *= lowStorageAmplification(method,dt);
+    }
+
+  V error(gfs,exact);
+  error -= unew;
+  const R e = error.infinity_norm();
+
+  std::cout << name << ": " << method.name()
+            << ", constant mass matrix " << constant_mass
+            << ", error " << e
+            << ", error to exp(-t) " << std::abs(exact - std::exp(-time)) << std::endl;
+
+  if (e > 1e-12)
+    {
+      std::cerr << name << ": solution does not match the low-storage recursion" << std::endl;
+      return false;
+    }
+  // both schemes are at least third order
+  if (std::abs(exact - std::exp(-time)) > 1e-4)
+    {
+      std::cerr << name << ": low-storage scheme is not accurate enough" << std::endl;
+      return false;
+    }
+  return true;
+}
+
+// Selects ExplicitOneStepMethod in testToggleConstantMass()
+struct SelectExplicitOneStepMethod
+{
+  template<typename R, typename IGO, typename LS, typename V>
+  struct OneStepMethod
+  {
+    typedef Dune::PDELab::ExplicitOneStepMethod<R,IGO,LS,V,V> Type;
+  };
+};
+
+// Selects LowStorageExplicitOneStepMethod in testToggleConstantMass()
+struct SelectLowStorageExplicitOneStepMethod
+{
+  template<typename R, typename IGO, typename LS, typename V>
+  struct OneStepMethod
+  {
+    typedef Dune::PDELab::LowStorageExplicitOneStepMethod<R,IGO,LS,V,V> Type;
+  };
+};
+
+// Switches the constant mass matrix on, off and on again every few steps and compares
+// each phase with a new method that starts from the same state
+template<typename Select, typename GV, typename Method>
+bool testToggleConstantMass (const GV& gv, const Method& method, std::string name)
+{
+  typedef double R;
+  const int dim = GV::dimension;
+
+  Dune::GeometryType gt;
+  gt.makeCube(dim);
+  typedef Dune::PDELab::P0LocalFiniteElementMap<typename GV::Grid::ctype,R,dim> FEM;
+  FEM fem(gt);
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef Dune::PDELab::L2 LOP;
+  LOP lop(2);
+  TimeDependentMass mass;
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  MBE mbe(1);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R> GO0;
+  GO0 go0(gfs,gfs,lop,mbe);
+  typedef Dune::PDELab::GridOperator<GFS,GFS,TimeDependentMass,MBE,R,R,R> GO1;
+  GO1 go1(gfs,gfs,mass,mbe);
+
+  typedef Dune::PDELab::OneStepGridOperator<GO0,GO1,false> IGO;
+  IGO igo(go0,go1);
+
+  typedef typename IGO::Traits::Domain V;
+  typedef Dune::PDELab::ISTLBackend_SEQ_ExplicitDiagonal LS;
+  LS ls;
+
+  typedef typename Select::template OneStepMethod<R,IGO,LS,V>::Type OSM;
+  OSM osm(method,igo,ls);
+  osm.setVerbosityLevel(0);
+
+  const R dt = 0.1;
+  R time = 0.0;
+  V uold(gfs,1.0), unew(gfs,1.0);
+
+  bool passed = true;
+  for (int phase = 0; phase < 3; ++phase)
+    {
+      const bool constant_mass = phase != 1;
+      osm.setConstantMassMatrix(constant_mass);
+
+      LS reference_ls;
+      OSM reference_osm(method,igo,reference_ls);
+      reference_osm.setVerbosityLevel(0);
+      reference_osm.setConstantMassMatrix(constant_mass);
+      R reference_time = time;
+      V reference_uold(uold), reference_unew(uold);
+
+      for (int i = 0; i < 3; ++i)
+        {
+          osm.apply(time,dt,uold,unew);
+          uold = unew;
+          time += dt;
+
+          reference_osm.apply(reference_time,dt,reference_uold,reference_unew);
+          reference_uold = reference_unew;
+          reference_time += dt;
+        }
+
+      V error(reference_unew);
+      error -= unew;
+      const R e = error.infinity_norm();
+
+      std::cout << name << ": phase " << phase << ", constant mass matrix " << constant_mass
+                << ", reused inverse " << ls.getReuse() << ", difference " << e << std::endl;
+
+      if (constant_mass != ls.getReuse())
+        {
+          std::cerr << name << ": reuse of the inverse mass matrix does not follow setConstantMassMatrix()"
+                    << std::endl;
+          passed = false;
+        }
+      if (e > 1e-12)
+        {
+          std::cerr << name << ": solution differs from a new method started from the same state" << std::endl;
+          passed = false;
+        }
+    }
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    // YaspGrid P0 2D test
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(1));
+      Dune::YaspGrid<2> grid(L,N);
+      grid.globalRefine(4);
+
+      typedef Dune::YaspGrid<2>::LeafGridView GV;
+      const GV& gv=grid.leafGridView();
+
+      passed &= testExplicitOneStep(gv,false,"yasp_P0_2d");
+      passed &= testExplicitOneStep(gv,true,"yasp_P0_2d");
+
+      Dune::PDELab::RK4Parameter<double> rk4;
+      passed &= testToggleConstantMass<SelectExplicitOneStepMethod>(gv,rk4,"yasp_P0_2d");
+
+      Dune::PDELab::Williamson3Parameter<double> williamson3;
+      Dune::PDELab::CarpenterKennedy4Parameter<double> carpenterkennedy4;
+      passed &= testLowStorage(gv,williamson3,false,"yasp_P0_2d");
+      passed &= testLowStorage(gv,carpenterkennedy4,false,"yasp_P0_2d");
+      passed &= testLowStorage(gv,carpenterkennedy4,true,"yasp_P0_2d");
+      passed &= testToggleConstantMass<SelectLowStorageExplicitOneStepMethod>(gv,carpenterkennedy4,"yasp_P0_2d");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
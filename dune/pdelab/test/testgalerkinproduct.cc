@@ -0,0 +1,159 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/matrixmatrix.hh>
+
+#include <dune/pdelab/backend/istl/galerkinproduct.hh>
+
+//===============================================================
+// Compares the Galerkin product P^T A P computed by the symbolic
+// and numeric phases of GalerkinProduct with the result of the
+// ISTL matrix-matrix products, also after changing the values of
+// the fine matrix.
+//===============================================================
+
+typedef Dune::FieldMatrix<double,2,2> Block;
+typedef Dune::FieldMatrix<double,2,1> PBlock;
+typedef Dune::FieldMatrix<double,1,1> CBlock;
+typedef Dune::BCRSMatrix<Block> Matrix;
+typedef Dune::BCRSMatrix<PBlock> P;
+typedef Dune::BCRSMatrix<CBlock> CMatrix;
+
+// tridiagonal block matrix on n rows
+void fillFine (Matrix& A, std::size_t n, double shift)
+{
+  A.setSize(n,n,3*n);
+  A.setBuildMode(Matrix::row_wise);
+  for (Matrix::CreateIterator row = A.createbegin(); row != A.createend(); ++row)
+    {
+      const std::size_t i = row.index();
+      if (i > 0)
+        row.insert(i-1);
+      row.insert(i);
+      if (i < n-1)
+        row.insert(i+1);
+    }
+  for (std::size_t i = 0; i < n; ++i)
+    for (Matrix::ColIterator it = A[i].begin(); it != A[i].end(); ++it)
+      for (int r = 0; r < 2; ++r)
+        for (int c = 0; c < 2; ++c)
+          (*it)[r][c] = (it.index() == i ? 4.0 : -1.0) + shift*(r+1) - 0.5*c + 0.1*i;
+}
+
+// each fine block row couples to two neighboring coarse DOFs
+void fillProlongation (P& p, std::size_t n, std::size_t nc)
+{
+  p.setSize(n,nc,2*n);
+  p.setBuildMode(P::row_wise);
+  for (P::CreateIterator row = p.createbegin(); row != p.createend(); ++row)
+    {
+      const std::size_t j = (row.index()*(nc-1))/n;
+      row.insert(j);
+      row.insert(j+1);
+    }
+  for (std::size_t i = 0; i < n; ++i)
+    for (P::ColIterator it = p[i].begin(); it != p[i].end(); ++it)
+      {
+        (*it)[0][0] = 0.25 + 0.5*(it.index() % 2) + 0.01*i;
+        (*it)[1][0] = 0.75 - 0.5*(it.index() % 2);
+      }
+}
+
+bool compare (const CMatrix& a, const CMatrix& b)
+{
+  if (a.N() != b.N() || a.M() != b.M())
+    return false;
+  for (std::size_t i = 0; i < a.N(); ++i)
+    for (CMatrix::ConstColIterator it = b[i].begin(); it != b[i].end(); ++it)
+      {
+        const double value = a.exists(i,it.index()) ? a[i][it.index()][0][0] : 0.0;
+        if (std::abs(value - (*it)[0][0]) > 1e-12)
+          {
+            std::cerr << "entry (" << i << "," << it.index() << ") is " << value
+                      << ", expected " << (*it)[0][0] << std::endl;
+            return false;
+          }
+      }
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper::instance(argc, argv);
+
+    const std::size_t n = 20;
+    const std::size_t nc = 8;
+    bool passed = true;
+
+    Matrix A;
+    fillFine(A,n,0.0);
+    P p;
+    fillProlongation(p,n,nc);
+
+    Dune::PDELab::istl::GalerkinProduct<P,Matrix,CMatrix> product;
+    CMatrix ac;
+    product.setup(p,A,ac,1);
+    product.apply(p,A,ac);
+
+    typedef Dune::TransposedMatMultMatResult<P,Matrix>::type PTA;
+    PTA pta;
+    CMatrix reference;
+    Dune::transposeMatMultMat(pta,p,A);
+    Dune::matMultMat(reference,pta,p);
+    passed &= compare(ac,reference);
+
+    // new values in the same structure only need the numeric phase
+    Matrix B;
+    fillFine(B,n,0.3);
+    if (!product.matches(B,1))
+      {
+        std::cerr << "matrix with identical structure not recognized" << std::endl;
+        passed = false;
+      }
+    product.apply(p,B,ac);
+    PTA ptb;
+    CMatrix reference2;
+    Dune::transposeMatMultMat(ptb,p,B);
+    Dune::matMultMat(reference2,ptb,p);
+    passed &= compare(ac,reference2);
+
+    // a different structure has to be detected
+    Matrix C;
+    fillFine(C,n-1,0.0);
+    if (product.matches(C,1))
+      {
+        std::cerr << "matrix with different structure not detected" << std::endl;
+        passed = false;
+      }
+
+    // as well as a new revision of the structure
+    if (product.matches(B,2))
+      {
+        std::cerr << "new revision of the structure not detected" << std::endl;
+        passed = false;
+      }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
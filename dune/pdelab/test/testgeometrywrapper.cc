@@ -0,0 +1,171 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/geometry/quadraturerules.hh>
+#include <dune/grid/geometrygrid.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/common/geometrywrapper.hh>
+
+#include "assemblycomparison.hh"
+
+//===============================================================
+// Checks that the geometric data returned by ElementGeometry and
+// IntersectionGeometry agrees with the geometries of the grid at
+// all quadrature points, both for affine grids, where the data
+// is only evaluated once per entity, and for deformed grids, in
+// 2D and 3D
+//===============================================================
+
+// Maximum difference of two matrices, compared column by column with mv()
+template<typename M, int rows, int cols>
+double difference (const M& a, const M& b)
+{
+  double diff = 0.0;
+  for (int c = 0; c < cols; ++c)
+    {
+      Dune::FieldVector<double,cols> unit(0.0);
+      unit[c] = 1.0;
+      Dune::FieldVector<double,rows> ca, cb;
+      a.mv(unit,ca);
+      b.mv(unit,cb);
+      ca -= cb;
+      diff = std::max(diff,ca.infinity_norm());
+    }
+  return diff;
+}
+
+template<typename GV>
+bool testGeometryWrapper (const GV& gv, bool expect_affine, std::string name)
+{
+  const int dim = GV::dimension;
+  typedef typename GV::template Codim<0>::Iterator ElementIterator;
+  typedef typename GV::template Codim<0>::Entity Element;
+  typedef typename GV::IntersectionIterator IntersectionIterator;
+  typedef typename IntersectionIterator::Intersection Intersection;
+  typedef typename Element::Geometry::JacobianInverseTransposed JIT;
+
+  const double tolerance = 1e-12;
+  double diff = 0.0;
+  bool passed = true;
+
+  for (ElementIterator it = gv.template begin<0>(); it != gv.template end<0>(); ++it)
+    {
+      Dune::PDELab::ElementGeometry<Element> eg(*it);
+      const typename Element::Geometry geo = it->geometry();
+      passed &= eg.affine() == geo.affine();
+      passed &= eg.affine() == expect_affine;
+
+      const Dune::QuadratureRule<double,dim>& rule = Dune::QuadratureRules<double,dim>::rule(geo.type(),3);
+      // a result must stay valid after evaluating the wrapper at other positions
+      const JIT first_jit = eg.jacobianInverseTransposed(rule.begin()->position());
+      for (typename Dune::QuadratureRule<double,dim>::const_iterator qit = rule.begin(); qit != rule.end(); ++qit)
+        {
+          const JIT jit = geo.jacobianInverseTransposed(qit->position());
+          diff = std::max(diff,difference<JIT,dim,dim>(eg.jacobianInverseTransposed(qit->position()),jit));
+          diff = std::max(diff,std::abs(eg.integrationElement(qit->position()) - geo.integrationElement(qit->position())));
+        }
+      diff = std::max(diff,difference<JIT,dim,dim>(first_jit,geo.jacobianInverseTransposed(rule.begin()->position())));
+
+      unsigned int intersection_index = 0;
+      for (IntersectionIterator iit = gv.ibegin(*it); iit != gv.iend(*it); ++iit, ++intersection_index)
+        {
+          Dune::PDELab::IntersectionGeometry<Intersection> ig(*iit,intersection_index);
+          passed &= ig.affine() == iit->geometry().affine();
+
+          const Dune::QuadratureRule<double,dim-1>& face_rule =
+            Dune::QuadratureRules<double,dim-1>::rule(iit->geometry().type(),3);
+          for (typename Dune::QuadratureRule<double,dim-1>::const_iterator qit = face_rule.begin(); qit != face_rule.end(); ++qit)
+            {
+              const Dune::FieldVector<double,dim-1>& x = qit->position();
+              diff = std::max(diff,std::abs(ig.integrationElement(x) - iit->geometry().integrationElement(x)));
+
+              Dune::FieldVector<double,dim> n = ig.unitOuterNormal(x);
+              n -= iit->unitOuterNormal(x);
+              diff = std::max(diff,n.infinity_norm());
+              n = ig.integrationOuterNormal(x);
+              n -= iit->integrationOuterNormal(x);
+              diff = std::max(diff,n.infinity_norm());
+
+              const Dune::FieldVector<double,dim> x_inside = iit->geometryInInside().global(x);
+              const JIT jit_inside = iit->inside()->geometry().jacobianInverseTransposed(x_inside);
+              diff = std::max(diff,difference<JIT,dim,dim>(ig.insideJacobianInverseTransposed(x_inside),jit_inside));
+
+              if (iit->neighbor())
+                {
+                  const Dune::FieldVector<double,dim> x_outside = iit->geometryInOutside().global(x);
+                  const JIT jit_outside = iit->outside()->geometry().jacobianInverseTransposed(x_outside);
+                  diff = std::max(diff,difference<JIT,dim,dim>(ig.outsideJacobianInverseTransposed(x_outside),jit_outside));
+                }
+            }
+        }
+    }
+
+  std::cout << name << ": maximum difference " << diff << std::endl;
+  if (!passed || diff > tolerance)
+    {
+      std::cerr << name << ": geometry wrapper returns wrong data" << std::endl;
+      return false;
+    }
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(8));
+      Dune::YaspGrid<2> grid(L,N);
+
+      // YaspGrid has affine cells and faces
+      passed &= testGeometryWrapper(grid.leafGridView(),true,"yasp_2d");
+
+      // the deformed grid has non-affine cells
+      typedef Dune::GeometryGrid<Dune::YaspGrid<2>,Deformation<2> > DeformedGrid;
+      Deformation<2> deformation;
+      DeformedGrid deformed_grid(grid,deformation);
+      passed &= testGeometryWrapper(deformed_grid.leafGridView(),false,"deformed_yasp_2d");
+    }
+
+    {
+      Dune::FieldVector<double,3> L(1.0);
+      Dune::array<int,3> N(Dune::fill_array<int,3>(4));
+      Dune::YaspGrid<3> grid(L,N);
+
+      passed &= testGeometryWrapper(grid.leafGridView(),true,"yasp_3d");
+
+      // in 3D, the faces of the deformed grid are not affine either
+      typedef Dune::GeometryGrid<Dune::YaspGrid<3>,Deformation<3> > DeformedGrid;
+      Deformation<3> deformation;
+      DeformedGrid deformed_grid(grid,deformation);
+      passed &= testGeometryWrapper(deformed_grid.leafGridView(),false,"deformed_yasp_3d");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
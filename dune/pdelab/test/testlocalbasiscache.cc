@@ -0,0 +1,166 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/geometry/quadraturerules.hh>
+#include <dune/geometry/referenceelements.hh>
+#include <dune/localfunctions/lagrange/pk.hh>
+
+#include <dune/pdelab/finiteelement/localbasiscache.hh>
+#include <dune/pdelab/finiteelementmap/qkdg.hh>
+
+//===============================================================
+// Checks the tables of LocalBasisQuadratureCache against direct
+// evaluations of the local basis for element and face quadrature
+// rules, checks that tables are reused across different basis
+// objects of the same type, and, with OpenMP, that concurrent
+// binds from several threads give correct tables
+//===============================================================
+
+template<typename Basis>
+double compareTable (const typename Dune::PDELab::LocalBasisQuadratureCache<Basis>::Table& table,
+                     const Basis& basis,
+                     const std::vector<typename Basis::Traits::DomainType>& positions)
+{
+  typedef typename Basis::Traits::RangeType RangeType;
+  typedef typename Basis::Traits::JacobianType JacobianType;
+
+  double diff = table.size() == basis.size() && table.points() == positions.size() ? 0.0 : 1.0;
+  std::vector<RangeType> phi;
+  std::vector<JacobianType> js;
+  for (std::size_t q = 0; q < positions.size(); ++q)
+    {
+      basis.evaluateFunction(positions[q],phi);
+      basis.evaluateJacobian(positions[q],js);
+      for (std::size_t i = 0; i < basis.size(); ++i)
+        {
+          RangeType d = table.evaluateFunction(q)[i];
+          d -= phi[i];
+          diff = std::max(diff,d.infinity_norm());
+          JacobianType dj = table.evaluateJacobian(q)[i];
+          dj -= js[i];
+          diff = std::max(diff,dj.infinity_norm());
+        }
+    }
+  return diff;
+}
+
+// binds all element rules up to order 6 and the face rules of all faces and compares the tables
+template<typename Basis>
+double checkCache (const Dune::PDELab::LocalBasisQuadratureCache<Basis>& cache,
+                   const Basis& basis, const Dune::GeometryType& gt)
+{
+  typedef typename Basis::Traits::DomainFieldType DF;
+  typedef typename Basis::Traits::DomainType DomainType;
+  typedef Dune::PDELab::LocalBasisQuadratureCache<Basis> Cache;
+  const int dim = Basis::Traits::dimDomain;
+
+  double diff = 0.0;
+  const Dune::ReferenceElement<DF,dim>& reference = Dune::ReferenceElements<DF,dim>::general(gt);
+  for (int order = 0; order <= 6; ++order)
+    {
+      const Dune::QuadratureRule<DF,dim>& rule = Dune::QuadratureRules<DF,dim>::rule(gt,order);
+      std::vector<DomainType> positions(rule.size());
+      for (std::size_t q = 0; q < rule.size(); ++q)
+        positions[q] = rule[q].position();
+      const typename Cache::Table& table = cache.bind(basis,rule);
+      diff = std::max(diff,compareTable(table,basis,positions));
+      if (&cache.bind(basis,rule) != &table)
+        diff = std::max(diff,1.0);
+
+      for (int face = 0; face < reference.size(1); ++face)
+        {
+          typedef typename Dune::ReferenceElement<DF,dim>::template Codim<1>::Geometry FaceGeometry;
+          const FaceGeometry face_geometry = reference.template geometry<1>(face);
+          const Dune::QuadratureRule<DF,dim-1>& face_rule =
+            Dune::QuadratureRules<DF,dim-1>::rule(face_geometry.type(),order);
+          positions.resize(face_rule.size());
+          for (std::size_t q = 0; q < face_rule.size(); ++q)
+            positions[q] = face_geometry.global(face_rule[q].position());
+          diff = std::max(diff,compareTable(cache.bind(basis,face_rule,face_geometry,face),basis,positions));
+        }
+    }
+  return diff;
+}
+
+template<typename FE>
+bool testCache (const FE& fe, const FE& other_fe, std::string name)
+{
+  typedef typename FE::Traits::LocalBasisType Basis;
+  typedef Dune::PDELab::LocalBasisQuadratureCache<Basis> Cache;
+  const int dim = Basis::Traits::dimDomain;
+
+  Cache cache;
+  double diff = checkCache(cache,fe.localBasis(),fe.type());
+
+  // a second basis object of the same type and order shares the tables of the first one
+  const Dune::QuadratureRule<double,dim>& rule = Dune::QuadratureRules<double,dim>::rule(fe.type(),3);
+  if (&cache.bind(fe.localBasis(),rule) != &cache.bind(other_fe.localBasis(),rule))
+    diff = std::max(diff,1.0);
+
+#ifdef _OPENMP
+  // every thread builds and checks its own tables in a fresh cache
+  Cache threaded_cache;
+  double thread_diff = 0.0;
+#pragma omp parallel num_threads(4) reduction(max:thread_diff)
+  for (int i = 0; i < 10; ++i)
+    thread_diff = std::max(thread_diff,checkCache(threaded_cache,fe.localBasis(),fe.type()));
+  diff = std::max(diff,thread_diff);
+#endif
+
+  std::cout << name << ": maximum difference " << diff << std::endl;
+  if (diff > 1e-14)
+    {
+      std::cerr << name << ": cached basis values differ from the local basis" << std::endl;
+      return false;
+    }
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    {
+      typedef Dune::QkDGLocalFiniteElement<double,double,2,2> FE;
+      FE fe, other_fe;
+      passed &= testCache(fe,other_fe,"qkdg_Q2_2d");
+    }
+    {
+      typedef Dune::QkDGLocalFiniteElement<double,double,1,3> FE;
+      FE fe, other_fe;
+      passed &= testCache(fe,other_fe,"qkdg_Q1_3d");
+    }
+    {
+      // the orientation variants of the P3 element only differ in their local coefficients
+      typedef Dune::PkLocalFiniteElement<double,double,2,3> FE;
+      const unsigned int vertexmap[3] = {2, 0, 1};
+      FE fe, other_fe(vertexmap);
+      passed &= testCache(fe,other_fe,"pk_P3_2d");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
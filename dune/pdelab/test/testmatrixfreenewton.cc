@@ -0,0 +1,231 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/finiteelementmap/p0fem.hh>
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/constraints/common/constraints.hh>
+#include <dune/pdelab/constraints/conforming.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/interpolate.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/backend/seqistlsolverbackend.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/newton/newton.hh>
+
+#include "nonlineardiffusion.hh"
+
+//===============================================================
+// Compares the matrix-free application of the jacobian of a
+// nonlinear problem to the assembled jacobian and solves the
+// problem with Newton's method with and without assembling
+// the jacobian, for a conforming finite element operator, which
+// only has volume terms, and for a cell-centered finite volume
+// operator, whose skeleton and boundary terms are applied by
+// the NumericalJacobianApplySkeleton/Boundary mixins
+//===============================================================
+
+template<typename GO>
+bool compareJacobianApplication (const GO& go, const typename GO::Traits::Domain& x, std::string name)
+{
+  typedef typename GO::Traits::Domain V;
+  typedef typename GO::Traits::Jacobian M;
+
+  // some direction that is unrelated to x
+  V z(go.trialGridFunctionSpace(),0.0);
+  for (std::size_t i = 0; i < z.base().N(); ++i)
+    z.base()[i] = std::sin(1.0 + i);
+
+  M m(go);
+  m = 0.0;
+  go.jacobian(x,m);
+  V r_assembled(go.testGridFunctionSpace(),0.0);
+  m.base().mv(z.base(),r_assembled.base());
+
+  V r_matrixfree(go.testGridFunctionSpace(),0.0);
+  go.jacobian_apply(x,z,r_matrixfree);
+
+  r_matrixfree -= r_assembled;
+  const double error = r_matrixfree.base().infinity_norm()/r_assembled.base().infinity_norm();
+  std::cout << name << ": relative difference of the jacobian applications " << error << std::endl;
+  if (error > 1e-5)
+    {
+      std::cerr << name << ": matrix-free jacobian differs from the assembled jacobian" << std::endl;
+      return false;
+    }
+  return true;
+}
+
+template<typename GO>
+bool compareNewtonSolutions (GO& go, const typename GO::Traits::Domain& x, std::string name)
+{
+  typedef typename GO::Traits::Domain V;
+
+  V x_assembled(x);
+  typedef Dune::PDELab::ISTLBackend_SEQ_BCGS_SSOR LS;
+  LS ls(5000,0);
+  Dune::PDELab::Newton<GO,LS,V> newton(go,x_assembled,ls);
+  newton.setReduction(1e-10);
+  newton.setVerbosityLevel(1);
+  newton.apply();
+
+  V x_matrixfree(x);
+  typedef Dune::PDELab::ISTLBackend_SEQ_MatrixFree_BCGS<GO> MFLS;
+  MFLS mfls(go,5000,0);
+  Dune::PDELab::Newton<GO,MFLS,V> mfnewton(go,x_matrixfree,mfls);
+  mfnewton.setReduction(1e-10);
+  mfnewton.setVerbosityLevel(1);
+  mfnewton.apply();
+
+  x_matrixfree -= x_assembled;
+  const double error = x_matrixfree.base().infinity_norm();
+  std::cout << name << ": difference of the Newton solutions " << error << std::endl;
+  if (error > 1e-6)
+    {
+      std::cerr << name << ": matrix-free Newton differs from Newton with assembled jacobian" << std::endl;
+      return false;
+    }
+  return true;
+}
+
+template<typename GV, typename FEM>
+bool testMatrixFreeNewton (const GV& gv, const FEM& fem, std::string name)
+{
+  typedef double R;
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::ConformingDirichletConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef typename GFS::template ConstraintsContainer<R>::Type C;
+  C cg;
+  Dune::PDELab::DirichletConstraintsParameters constraintsparameters;
+  Dune::PDELab::constraints(constraintsparameters,gfs,cg);
+
+  typedef NumericalNonlinearDiffusionFEM LOP;
+  LOP lop;
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  MBE mbe(27);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,cg,gfs,cg,lop,mbe);
+
+  typedef typename GO::Traits::Domain V;
+  V x(gfs,0.0);
+  G<GV,R> g(gv);
+  Dune::PDELab::interpolate(g,gfs,x);
+
+  bool passed = true;
+  passed &= compareJacobianApplication(go,x,name);
+  passed &= compareNewtonSolutions(go,x,name);
+  return passed;
+}
+
+template<typename GV>
+bool testMatrixFreeNewtonCCFV (const GV& gv, std::string name)
+{
+  typedef double R;
+
+  typedef Dune::PDELab::P0LocalFiniteElementMap<double,R,GV::dimension> FEM;
+  FEM fem(Dune::GeometryType(Dune::GeometryType::cube,GV::dimension));
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef NumericalNonlinearDiffusionCCFV LOP;
+  LOP lop;
+
+  typedef Dune::PDELab::EmptyTransformation C;
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  MBE mbe(2*GV::dimension+1);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,gfs,lop,mbe);
+
+  typedef typename GO::Traits::Domain V;
+  V x(gfs,0.0);
+  G<GV,R> g(gv);
+  Dune::PDELab::interpolate(g,gfs,x);
+
+  bool passed = true;
+  passed &= compareJacobianApplication(go,x,name);
+  passed &= compareNewtonSolutions(go,x,name);
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    // YaspGrid Q1 2D test
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(1));
+      Dune::YaspGrid<2> grid(L,N);
+      grid.globalRefine(4);
+
+      typedef Dune::YaspGrid<2>::LeafGridView GV;
+      const GV& gv=grid.leafGridView();
+
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+      FEM fem(gv);
+
+      passed &= testMatrixFreeNewton(gv,fem,"yasp_Q1_2d");
+    }
+
+    // YaspGrid Q2 2D test
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(1));
+      Dune::YaspGrid<2> grid(L,N);
+      grid.globalRefine(3);
+
+      typedef Dune::YaspGrid<2>::LeafGridView GV;
+      const GV& gv=grid.leafGridView();
+
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,2> FEM;
+      FEM fem(gv);
+
+      passed &= testMatrixFreeNewton(gv,fem,"yasp_Q2_2d");
+    }
+
+    // YaspGrid cell-centered finite volumes 2D test
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(1));
+      Dune::YaspGrid<2> grid(L,N);
+      grid.globalRefine(5);
+
+      typedef Dune::YaspGrid<2>::LeafGridView GV;
+      const GV& gv=grid.leafGridView();
+
+      passed &= testMatrixFreeNewtonCCFV(gv,"yasp_ccfv_2d");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
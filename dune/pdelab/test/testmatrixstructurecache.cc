@@ -0,0 +1,273 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+#include <dune/istl/bcrsmatrix.hh>
+
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/constraints/common/constraints.hh>
+#include <dune/pdelab/constraints/conforming.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/vectorgridfunctionspace.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/istlmatrixbackend.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/localoperator/convectiondiffusionparameter.hh>
+#include <dune/pdelab/localoperator/convectiondiffusionfem.hh>
+#include <dune/pdelab/localoperator/linearelasticity.hh>
+
+#include "assemblycomparison.hh"
+
+//===============================================================
+// Checks that the matrices set up from the MatrixStructureCache
+// of a GridOperator have the same structure and, after assembly,
+// the same entries as a matrix built by a grid operator without
+// the cache, for a scalar and a nested BCRSMatrix, and that the
+// cache is discarded after the grid has been refined and the
+// function space updated, and after the constraints have been
+// replaced by constraints with a different pattern
+//===============================================================
+
+template<typename K, int n, int m>
+bool sameStructure (const Dune::FieldMatrix<K,n,m>&, const Dune::FieldMatrix<K,n,m>&)
+{
+  return true;
+}
+
+template<typename B, typename A>
+bool sameStructure (const Dune::BCRSMatrix<B,A>& a, const Dune::BCRSMatrix<B,A>& b)
+{
+  if (a.N() != b.N() || a.M() != b.M() || a.nonzeroes() != b.nonzeroes())
+    return false;
+  for (typename Dune::BCRSMatrix<B,A>::ConstRowIterator ra = a.begin(), rb = b.begin(); ra != a.end(); ++ra, ++rb)
+    {
+      if (ra->size() != rb->size())
+        return false;
+      for (typename Dune::BCRSMatrix<B,A>::ConstColIterator ca = ra->begin(), cb = rb->begin(); ca != ra->end(); ++ca, ++cb)
+        if (ca.index() != cb.index() || !sameStructure(*ca,*cb))
+          return false;
+    }
+  return true;
+}
+
+// Builds two matrices from the cache of go and compares them with a matrix
+// of a grid operator that does not use the cache
+template<typename GO, typename C, typename LOP>
+bool checkCache (GO& go, const C& cg, LOP& lop, std::string name)
+{
+  typedef typename GO::Traits::Domain V;
+  typedef typename GO::Traits::Jacobian M;
+
+  GO reference_go(go.trialGridFunctionSpace(),cg,go.testGridFunctionSpace(),cg,lop,go.matrixBackend());
+  reference_go.matrixStructureCache().setEnabled(false);
+
+  V x(go.trialGridFunctionSpace());
+  fillCoefficients(x);
+
+  V reference_r(go.testGridFunctionSpace(),0.0);
+  reference_go.residual(x,reference_r);
+  M reference_m(reference_go);
+  reference_m = 0.0;
+  reference_go.jacobian(x,reference_m);
+
+  bool passed = true;
+
+  // the first matrix fills the cache, the second one is set up from it
+  for (int matrix = 0; matrix < 2; ++matrix)
+    {
+      M m(go);
+      if (!sameStructure(m.base(),reference_m.base()))
+        {
+          std::cerr << name << ": matrix " << matrix << " has a wrong structure" << std::endl;
+          passed = false;
+          continue;
+        }
+
+      V r(go.testGridFunctionSpace(),0.0);
+      go.residual(x,r);
+      m = 0.0;
+      go.jacobian(x,m);
+      passed &= compareResults(r,m,reference_r,reference_m,0.0,name,"matrix structure cache");
+    }
+
+  return passed;
+}
+
+// Checks the cache, refines the grid and checks that the cache follows the new space
+template<typename Grid, typename GFS, typename GO, typename LOP>
+bool checkRefinement (Grid& grid, GFS& gfs, GO& go, LOP& lop, std::string name)
+{
+  const Dune::PDELab::EmptyTransformation cg;
+  bool passed = checkCache(go,cg,lop,name);
+
+  const std::size_t revision = gfs.revision();
+  grid.globalRefine(1);
+  gfs.update();
+  if (gfs.revision() == revision)
+    {
+      std::cerr << name << ": revision of the function space unchanged after update()" << std::endl;
+      passed = false;
+    }
+
+  passed &= checkCache(go,cg,lop,name + " (refined)");
+  return passed;
+}
+
+// Checks the cache, then replaces the Dirichlet constraints by a single constraint that
+// couples the first and the last formerly constrained DOF, which changes the sparsity
+// pattern, and checks that the cache follows the new constraints
+template<typename GO, typename C, typename LOP>
+bool checkConstraintsChange (GO& go, C& cg, LOP& lop, std::string name)
+{
+  bool passed = checkCache(go,cg,lop,name);
+
+  std::vector<typename C::key_type> dofs;
+  for (typename C::const_iterator it = cg.begin(); it != cg.end(); ++it)
+    dofs.push_back(it->first);
+  cg.clear();
+  cg[dofs.front()][dofs.back()] = 1.0;
+
+  passed &= checkCache(go,cg,lop,name + " (constraints changed)");
+  return passed;
+}
+
+template<typename Grid, typename GV>
+bool testConvectionDiffusion (Grid& grid, const GV& gv, std::string name)
+{
+  typedef double R;
+
+  typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+  FEM fem(gv);
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef Dune::PDELab::ConvectionDiffusionModelProblem<GV,R> Problem;
+  Problem problem;
+  typedef Dune::PDELab::ConvectionDiffusionFEM<Problem,FEM> LOP;
+  LOP lop(problem);
+
+  typedef Dune::PDELab::EmptyTransformation C;
+  typedef Dune::PDELab::ISTLMatrixBackend MBE;
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,gfs,lop);
+
+  return checkRefinement(grid,gfs,go,lop,name);
+}
+
+template<typename GV>
+bool testConstrainedConvectionDiffusion (const GV& gv, std::string name)
+{
+  typedef double R;
+
+  typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+  FEM fem(gv);
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::ConformingDirichletConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef Dune::PDELab::ConvectionDiffusionModelProblem<GV,R> Problem;
+  Problem problem;
+  Dune::PDELab::ConvectionDiffusionBoundaryConditionAdapter<Problem> bctype(gv,problem);
+
+  typedef typename GFS::template ConstraintsContainer<R>::Type C;
+  C cg;
+  Dune::PDELab::constraints(bctype,gfs,cg);
+
+  typedef Dune::PDELab::ConvectionDiffusionFEM<Problem,FEM> LOP;
+  LOP lop(problem);
+
+  typedef Dune::PDELab::ISTLMatrixBackend MBE;
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,cg,gfs,cg,lop);
+
+  return checkConstraintsChange(go,cg,lop,name);
+}
+
+template<typename Grid, typename GV>
+bool testElasticity (Grid& grid, const GV& gv, std::string name)
+{
+  typedef double R;
+  const int dim = GV::dimension;
+
+  // one BCRSMatrix block per pair of components
+  typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+  FEM fem(gv);
+  typedef Dune::PDELab::VectorGridFunctionSpace<GV,FEM,dim,
+    Dune::PDELab::ISTLVectorBackend<Dune::PDELab::ISTLParameters::dynamic_blocking>,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef ElasticityProblem<GV> Problem;
+  Problem problem;
+  typedef Dune::PDELab::LinearElasticity<Problem> LOP;
+  LOP lop(problem);
+
+  typedef Dune::PDELab::EmptyTransformation C;
+  typedef Dune::PDELab::ISTLMatrixBackend MBE;
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,gfs,lop);
+
+  return checkRefinement(grid,gfs,go,lop,name);
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(8));
+      Dune::YaspGrid<2> grid(L,N);
+
+      typedef Dune::YaspGrid<2>::LeafGridView GV;
+      const GV gv=grid.leafGridView();
+      passed &= testConvectionDiffusion(grid,gv,"convectiondiffusionfem_Q1_2d");
+    }
+
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(8));
+      Dune::YaspGrid<2> grid(L,N);
+
+      typedef Dune::YaspGrid<2>::LeafGridView GV;
+      const GV gv=grid.leafGridView();
+      passed &= testConstrainedConvectionDiffusion(gv,"convectiondiffusionfem_Q1_2d_constrained");
+    }
+
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(8));
+      Dune::YaspGrid<2> grid(L,N);
+
+      typedef Dune::YaspGrid<2>::LeafGridView GV;
+      const GV gv=grid.leafGridView();
+      passed &= testElasticity(grid,gv,"linearelasticity_Q1_2d_nested");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,151 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/constraints/common/constraints.hh>
+#include <dune/pdelab/constraints/conforming.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/interpolate.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/backend/seqistlsolverbackend.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/newton/newton.hh>
+
+#include "nonlineardiffusion.hh"
+
+//===============================================================
+// Solves a nonlinear problem with Newton's method while reusing
+// the jacobian and the AMG preconditioner and compares the
+// solution to the one obtained with a fresh jacobian in every
+// iteration
+//===============================================================
+
+template<typename GV, typename FEM>
+bool testNewtonReuse (const GV& gv, const FEM& fem, std::string name)
+{
+  typedef double R;
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::ConformingDirichletConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef typename GFS::template ConstraintsContainer<R>::Type C;
+  C cg;
+  Dune::PDELab::DirichletConstraintsParameters constraintsparameters;
+  Dune::PDELab::constraints(constraintsparameters,gfs,cg);
+
+  typedef NumericalNonlinearDiffusionFEM LOP;
+  LOP lop;
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  MBE mbe(27);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,cg,gfs,cg,lop,mbe);
+
+  typedef typename GO::Traits::Domain V;
+  typedef Dune::PDELab::ISTLBackend_SEQ_BCGS_AMG_SSOR<GO> LS;
+
+  G<GV,R> g(gv);
+  bool passed = true;
+
+  // reference: new jacobian and preconditioner in every iteration
+  V x_reference(gfs,0.0);
+  Dune::PDELab::interpolate(g,gfs,x_reference);
+  LS ls_reference(5000,0);
+  Dune::PDELab::Newton<GO,LS,V> newton_reference(go,x_reference,ls_reference);
+  newton_reference.setReduction(1e-10);
+  newton_reference.setVerbosityLevel(1);
+  newton_reference.apply();
+
+  // lagged jacobian and preconditioner, kept across two solves
+  V x_lagged(gfs,0.0);
+  Dune::PDELab::interpolate(g,gfs,x_lagged);
+  LS ls_lagged(5000,0);
+  Dune::PDELab::Newton<GO,LS,V> newton_lagged(go,x_lagged,ls_lagged);
+  newton_lagged.setReduction(1e-10);
+  newton_lagged.setMaxIterations(100);
+  newton_lagged.setVerbosityLevel(1);
+  newton_lagged.setReassembleThreshold(0.5);
+  newton_lagged.setJacobianMaxAge(3);
+  newton_lagged.setPreconditionerRebuildThreshold(0.5);
+  newton_lagged.setKeepJacobian(true);
+  newton_lagged.setKeepPreconditioner(true);
+  newton_lagged.apply();
+
+  const int reuses = newton_lagged.result().jacobian_reuses;
+  std::cout << name << ": " << reuses << " jacobian reuses, "
+            << newton_lagged.result().preconditioner_reuses << " preconditioner reuses, "
+            << newton_lagged.result().saved_assembler_time << "s assembly and "
+            << newton_lagged.result().saved_preconditioner_time << "s setup saved" << std::endl;
+
+  V difference(x_lagged);
+  difference -= x_reference;
+  const R error = difference.base().infinity_norm();
+  std::cout << name << ": difference of the Newton solutions " << error << std::endl;
+  if (error > 1e-6)
+    {
+      std::cerr << name << ": Newton with reused jacobian differs from the reference" << std::endl;
+      passed = false;
+    }
+
+  // a second solve starting from the solution has to get along with the kept jacobian
+  newton_lagged.setForceIteration(true);
+  newton_lagged.setJacobianMaxAge(0);
+  newton_lagged.apply();
+  if (newton_lagged.result().jacobian_reuses == 0)
+    {
+      std::cerr << name << ": jacobian has not been kept across calls to apply()" << std::endl;
+      passed = false;
+    }
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    // YaspGrid Q1 2D test
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(1));
+      Dune::YaspGrid<2> grid(L,N);
+      grid.globalRefine(5);
+
+      typedef Dune::YaspGrid<2>::LeafGridView GV;
+      const GV& gv=grid.leafGridView();
+
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+      FEM fem(gv);
+
+      passed &= testNewtonReuse(gv,fem,"yasp_Q1_2d");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,137 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <bitset>
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/constraints/common/constraints.hh>
+#include <dune/pdelab/constraints/common/constraintsparameters.hh>
+#include <dune/pdelab/constraints/conforming.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/localoperator/l2.hh>
+
+//===============================================================
+// Assembles the jacobian in nonoverlapping mode with and without
+// overlapping the exchange of the border entries with the assembly
+// of the interior and checks that the consistent matrices agree.
+// On a single process there is nothing to exchange, the test is
+// therefore also run on 2 and 4 processes (see MPITESTS).
+//===============================================================
+
+template<typename GO>
+void assemble (const GO& go, typename GO::Traits::Jacobian& A)
+{
+  typedef typename GO::Traits::Domain V;
+  V x(go.trialGridFunctionSpace(),1.0);
+  A = 0.0;
+  go.jacobian(x,A);
+  go.make_consistent(A);
+}
+
+template<typename GV, typename CP>
+bool test (const GV& gv, const CP& constraintsparameters, std::string name)
+{
+  typedef double R;
+
+  typedef Dune::PDELab::QkLocalFiniteElementMap<GV,R,R,2> FEM;
+  FEM fem(gv);
+
+  typedef Dune::PDELab::NonoverlappingConformingDirichletConstraints<GV> CON;
+  CON con(gv);
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,CON,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem,con);
+  con.compute_ghosts(gfs);
+
+  typedef typename GFS::template ConstraintsContainer<R>::Type C;
+  C cg;
+  Dune::PDELab::constraints(constraintsparameters,gfs,cg);
+
+  typedef Dune::PDELab::L2 LOP;
+  LOP lop(4);
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  MBE mbe(25);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C,true> GO;
+  GO go(gfs,cg,gfs,cg,lop,mbe);
+
+  typedef typename GO::Traits::Jacobian M;
+  M A(go);
+  assemble(go,A);
+
+  go.assembler().setOverlappedCommunication(true);
+  M OA(go);
+  bool passed = true;
+  // the second run reuses the communication schedule
+  for (int run = 0; run < 2; ++run)
+    {
+      assemble(go,OA);
+
+      typedef typename GO::Traits::Domain V;
+      V x(gfs);
+      R value = 0.0;
+      for (typename V::iterator it = x.begin(); it != x.end(); ++it)
+        *it = (value += 1.0);
+      V y(gfs,0.0), oy(gfs,0.0);
+      A.base().mv(x.base(),y.base());
+      OA.base().mv(x.base(),oy.base());
+      oy -= y;
+
+      const R difference = gv.comm().max(oy.infinity_norm());
+      if (gv.comm().rank() == 0)
+        std::cout << name << ": " << gv.comm().size() << " processes, run " << run
+                  << ", jacobian difference " << difference << std::endl;
+      if (difference > 1e-12)
+        {
+          std::cerr << name << ": overlapped assembly gives a different matrix" << std::endl;
+          passed = false;
+        }
+    }
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper& helper = Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    // YaspGrid Q2 2D test, nonoverlapping
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(16));
+      std::bitset<2> B(false);
+      Dune::YaspGrid<2> grid(helper.getCommunicator(),L,N,B,0);
+
+      passed &= test(grid.leafGridView(),Dune::PDELab::NoDirichletConstraintsParameters(),"yasp_Q2_2d");
+      passed &= test(grid.leafGridView(),Dune::PDELab::DirichletConstraintsParameters(),"yasp_Q2_2d_dirichlet");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,144 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstddef>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/pdelab/common/performancetrace.hh>
+
+typedef Dune::PDELab::PerformanceTrace Trace;
+
+// returns the child of node with the given name, 0 if there is none
+std::size_t child(const Trace& trace, std::size_t node, const std::string& name)
+{
+  const std::vector<std::size_t>& children = trace.nodes()[node].children;
+  for (std::size_t i = 0; i < children.size(); ++i)
+    if (trace.nodes()[children[i]].name == name)
+      return children[i];
+  return 0;
+}
+
+bool contains(const std::string& s, const std::string& part)
+{
+  return s.find(part) != std::string::npos;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper::instance(argc, argv);
+
+    int result = 0;
+    Trace& trace = Trace::instance();
+
+    // nothing is recorded while the trace is disabled
+    {
+      Trace::Region region("disabled");
+      trace.count("disabled counter");
+    }
+    if (trace.nodes().size() != 1 || !trace.events().empty())
+      {
+        std::cerr << "disabled trace recorded data" << std::endl;
+        result = 1;
+      }
+
+    trace.setEnabled(true);
+    for (int i = 0; i < 3; ++i)
+      {
+        Trace::Region outer("outer","test");
+        for (int j = 0; j < 2; ++j)
+          {
+            Trace::Region inner("inner \"quoted\"","test");
+            trace.count("iterations",2.0);
+          }
+        Trace::Region second("second","test");
+        second.end();
+      }
+    trace.count("top level counter");
+    trace.setEnabled(false);
+
+    const std::size_t outer = child(trace,0,"outer");
+    const std::size_t inner = outer ? child(trace,outer,"inner \"quoted\"") : 0;
+    const std::size_t second = outer ? child(trace,outer,"second") : 0;
+    if (!outer || !inner || !second || trace.nodes().size() != 4)
+      {
+        std::cerr << "wrong region hierarchy" << std::endl;
+        return 1;
+      }
+
+    if (trace.nodes()[outer].calls != 3 || trace.nodes()[inner].calls != 6 ||
+        trace.nodes()[second].calls != 3)
+      {
+        std::cerr << "wrong number of calls" << std::endl;
+        result = 1;
+      }
+    if (trace.nodes()[inner].counters.find("iterations")->second != 12.0 ||
+        trace.nodes()[0].counters.find("top level counter")->second != 1.0)
+      {
+        std::cerr << "wrong counter values" << std::endl;
+        result = 1;
+      }
+    if (trace.nodes()[inner].total > trace.nodes()[outer].total ||
+        trace.nodes()[inner].min > trace.nodes()[inner].max)
+      {
+        std::cerr << "inconsistent timings" << std::endl;
+        result = 1;
+      }
+    if (trace.events().size() != 12)
+      {
+        std::cerr << "wrong number of events: " << trace.events().size() << std::endl;
+        result = 1;
+      }
+
+    std::ostringstream json;
+    trace.writeJSON(json,3);
+    std::cout << json.str();
+    if (!contains(json.str(),"\"rank\": 3") ||
+        !contains(json.str(),"\"name\": \"outer\"") ||
+        !contains(json.str(),"\"name\": \"inner \\\"quoted\\\"\"") ||
+        !contains(json.str(),"\"iterations\": 12"))
+      {
+        std::cerr << "incomplete JSON output" << std::endl;
+        result = 1;
+      }
+
+    std::ostringstream chrome;
+    trace.writeChromeTrace(chrome,3);
+    if (!contains(chrome.str(),"\"traceEvents\"") ||
+        !contains(chrome.str(),"\"ph\": \"X\"") ||
+        !contains(chrome.str(),"\"ph\": \"C\"") ||
+        !contains(chrome.str(),"\"pid\": 3"))
+      {
+        std::cerr << "incomplete Chrome trace output" << std::endl;
+        result = 1;
+      }
+
+    trace.clear();
+    if (trace.nodes().size() != 1 || !trace.events().empty())
+      {
+        std::cerr << "clear() did not discard the recorded data" << std::endl;
+        result = 1;
+      }
+
+    return result;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
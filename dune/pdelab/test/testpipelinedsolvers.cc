@@ -0,0 +1,265 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <bitset>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/constraints/common/constraints.hh>
+#include <dune/pdelab/constraints/common/constraintsparameters.hh>
+#include <dune/pdelab/constraints/conforming.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/interpolate.hh>
+#include <dune/pdelab/common/function.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/backend/ovlpistlsolverbackend.hh>
+#include <dune/pdelab/backend/novlpistlsolverbackend.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/localoperator/l2.hh>
+#include <dune/pdelab/localoperator/laplace.hh>
+
+//===============================================================
+// Solves the same system with the classical and the pipelined
+// Krylov backends and checks that both reach the solution in a
+// comparable number of iterations, for a mass matrix and for the
+// Poisson problem. The test is also run on 2 and 4 processes (see
+// MPITESTS).
+//===============================================================
+
+// smooth reference solution
+template<typename GV, typename RF>
+class U
+  : public Dune::PDELab::AnalyticGridFunctionBase<Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1>,
+                                                  U<GV,RF> >
+{
+public:
+  typedef Dune::PDELab::AnalyticGridFunctionTraits<GV,RF,1> Traits;
+  typedef Dune::PDELab::AnalyticGridFunctionBase<Traits,U<GV,RF> > BaseT;
+
+  U (const GV& gv) : BaseT(gv) {}
+  inline void evaluateGlobal (const typename Traits::DomainType& x,
+                              typename Traits::RangeType& y) const
+  {
+    typename Traits::DomainType center(0.5);
+    center -= x;
+    y = std::exp(-center.two_norm2());
+  }
+};
+
+// Solves the linear problem whose solution is the interpolant u of U, starting from u with
+// all unconstrained DOFs set to zero, and checks the error and the final residual.
+template<typename GO, typename C, typename LS>
+bool solve (const GO& go, const C& cg, LS& ls, std::string name, int& iterations)
+{
+  typedef typename GO::Traits::Domain V;
+  typedef typename GO::Traits::Jacobian M;
+  typedef typename V::ElementType R;
+  typedef typename GO::Traits::TrialGridFunctionSpace GFS;
+  typedef typename GFS::Traits::GridViewType GV;
+
+  const GFS& gfs = go.trialGridFunctionSpace();
+  V u(gfs,0.0);
+  Dune::PDELab::interpolate(U<GV,R>(gfs.gridView()),gfs,u);
+  V x(u);
+  Dune::PDELab::set_nonconstrained_dofs(cg,0.0,x);
+
+  M A(go);
+  A = 0.0;
+  go.jacobian(x,A);
+
+  // the operator is affine, so A (x - u) = r(x) - r(u)
+  V r(go.testGridFunctionSpace(),0.0), ru(go.testGridFunctionSpace(),0.0);
+  go.residual(x,r);
+  go.residual(u,ru);
+  r -= ru;
+  const R initial_defect = ls.norm(r);
+
+  V z(gfs,0.0);
+  ls.apply(A,z,r,1e-10);
+  iterations = ls.result().iterations;
+  x -= z;
+
+  go.residual(x,r);
+  r -= ru;
+  const R reduction = ls.norm(r)/initial_defect;
+
+  x -= u;
+  const R error = gfs.gridView().comm().max(x.infinity_norm());
+  if (gfs.gridView().comm().rank() == 0)
+    std::cout << name << ": " << iterations << " iterations, defect reduction " << reduction
+              << ", error " << error << std::endl;
+  return ls.result().converged && reduction < 1e-8 && error < 1e-6;
+}
+
+bool compareIterations (int classical, int pipelined, std::string name)
+{
+  // the pipelined recurrences are mathematically equivalent, but may
+  // need a few more steps because of the accumulated rounding
+  if (pipelined > classical + 3 + classical/10)
+    {
+      std::cerr << name << ": pipelined solver needs " << pipelined
+                << " iterations, classical solver " << classical << std::endl;
+      return false;
+    }
+  return true;
+}
+
+template<typename GV, typename LOP, typename CP>
+bool testOverlapping (const GV& gv, const LOP& lop, const CP& constraintsparameters, std::string name)
+{
+  typedef double R;
+
+  typedef Dune::PDELab::QkLocalFiniteElementMap<GV,R,R,1> FEM;
+  FEM fem(gv);
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,
+    Dune::PDELab::OverlappingConformingDirichletConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef typename GFS::template ConstraintsContainer<R>::Type C;
+  C cg;
+  Dune::PDELab::constraints(constraintsparameters,gfs,cg);
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  MBE mbe(9);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,cg,gfs,cg,lop,mbe);
+
+  bool passed = true;
+  int classical = 0, pipelined = 0;
+  {
+    Dune::PDELab::ISTLBackend_OVLP_CG_SSORk<GFS,C> ls(gfs,cg,1000,1,0);
+    passed &= solve(go,cg,ls,name + "_CG_SSORk",classical);
+  }
+  {
+    Dune::PDELab::ISTLBackend_OVLP_PipelinedCG_SSORk<GFS,C> ls(gfs,cg,1000,1,0);
+    passed &= solve(go,cg,ls,name + "_PipelinedCG_SSORk",pipelined);
+  }
+  passed &= compareIterations(classical,pipelined,name + "_CG");
+
+  {
+    Dune::PDELab::ISTLBackend_OVLP_BCGS_SSORk<GFS,C> ls(gfs,cg,1000,1,0);
+    passed &= solve(go,cg,ls,name + "_BCGS_SSORk",classical);
+  }
+  {
+    Dune::PDELab::ISTLBackend_OVLP_PipelinedBCGS_SSORk<GFS,C> ls(gfs,cg,1000,1,0);
+    passed &= solve(go,cg,ls,name + "_PipelinedBCGS_SSORk",pipelined);
+  }
+  passed &= compareIterations(classical,pipelined,name + "_BCGS");
+
+  {
+    Dune::PDELab::ISTLBackend_OVLP_PipelinedBCGS_ILU0<GFS,C> ls(gfs,cg,1000,0);
+    passed &= solve(go,cg,ls,name + "_PipelinedBCGS_ILU0",pipelined);
+  }
+
+  return passed;
+}
+
+template<typename GV, typename LOP, typename CP>
+bool testNonoverlapping (const GV& gv, const LOP& lop, const CP& constraintsparameters, std::string name)
+{
+  typedef double R;
+
+  typedef Dune::PDELab::QkLocalFiniteElementMap<GV,R,R,1> FEM;
+  FEM fem(gv);
+
+  typedef Dune::PDELab::NonoverlappingConformingDirichletConstraints<GV> CON;
+  CON con(gv);
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,CON,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem,con);
+  con.compute_ghosts(gfs);
+
+  typedef typename GFS::template ConstraintsContainer<R>::Type C;
+  C cg;
+  Dune::PDELab::constraints(constraintsparameters,gfs,cg);
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  MBE mbe(9);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C,true> GO;
+  GO go(gfs,cg,gfs,cg,lop,mbe);
+
+  bool passed = true;
+  int classical = 0, pipelined = 0;
+  {
+    Dune::PDELab::ISTLBackend_NOVLP_CG_Jacobi<GFS> ls(gfs,1000,0);
+    passed &= solve(go,cg,ls,name + "_CG_Jacobi",classical);
+  }
+  {
+    Dune::PDELab::ISTLBackend_NOVLP_PipelinedCG_Jacobi<GFS> ls(gfs,1000,0);
+    passed &= solve(go,cg,ls,name + "_PipelinedCG_Jacobi",pipelined);
+  }
+  passed &= compareIterations(classical,pipelined,name + "_CG");
+
+  {
+    Dune::PDELab::ISTLBackend_NOVLP_BCGS_Jacobi<GFS> ls(gfs,1000,0);
+    passed &= solve(go,cg,ls,name + "_BCGS_Jacobi",classical);
+  }
+  {
+    Dune::PDELab::ISTLBackend_NOVLP_PipelinedBCGS_Jacobi<GFS> ls(gfs,1000,0);
+    passed &= solve(go,cg,ls,name + "_PipelinedBCGS_Jacobi",pipelined);
+  }
+  passed &= compareIterations(classical,pipelined,name + "_BCGS");
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper& helper = Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    // YaspGrid Q1 2D test, overlapping
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(32));
+      std::bitset<2> B(false);
+      Dune::YaspGrid<2> grid(helper.getCommunicator(),L,N,B,1);
+
+      passed &= testOverlapping(grid.leafGridView(),Dune::PDELab::L2(2),
+                                Dune::PDELab::NoDirichletConstraintsParameters(),"yasp_Q1_2d_ovlp_mass");
+      passed &= testOverlapping(grid.leafGridView(),Dune::PDELab::Laplace(2),
+                                Dune::PDELab::DirichletConstraintsParameters(),"yasp_Q1_2d_ovlp_poisson");
+    }
+
+    // YaspGrid Q1 2D test, nonoverlapping
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(32));
+      std::bitset<2> B(false);
+      Dune::YaspGrid<2> grid(helper.getCommunicator(),L,N,B,0);
+
+      passed &= testNonoverlapping(grid.leafGridView(),Dune::PDELab::L2(2),
+                                   Dune::PDELab::NoDirichletConstraintsParameters(),"yasp_Q1_2d_novlp_mass");
+      passed &= testNonoverlapping(grid.leafGridView(),Dune::PDELab::Laplace(2),
+                                   Dune::PDELab::DirichletConstraintsParameters(),"yasp_Q1_2d_novlp_poisson");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
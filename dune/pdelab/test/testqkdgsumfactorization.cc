@@ -0,0 +1,278 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/finiteelementmap/qkdg.hh>
+#include <dune/pdelab/finiteelement/qkdgsumfactorization.hh>
+#include <dune/pdelab/constraints/common/constraints.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/localoperator/convectiondiffusionparameter.hh>
+#include <dune/pdelab/localoperator/convectiondiffusiondg.hh>
+
+//===============================================================
+// Compares the sum-factorized kernels for QkDG bases to the
+// evaluation of every basis function at every quadrature point,
+// and the residual of ConvectionDiffusionDG with and without
+// sum factorization, sequentially and with colored assembly
+//===============================================================
+
+template<int k, int d>
+bool testKernel (std::string name)
+{
+  typedef Dune::QkDGLocalFiniteElement<double,double,k,d> FE;
+  typedef typename FE::Traits::LocalBasisType::Traits::RangeType RangeType;
+  typedef typename FE::Traits::LocalBasisType::Traits::JacobianType JacobianType;
+  typedef Dune::PDELab::QkDGSumFactorization<double,double,k,d> Kernel;
+  typedef typename Kernel::GradientType GradientType;
+
+  FE fe;
+  Kernel kernel(2*k);
+  const std::size_t n = kernel.size();
+  double error = 0.0;
+
+  std::vector<double> coefficients(n);
+  for (std::size_t i = 0; i < n; ++i)
+    coefficients[i] = std::sin(1.0 + i);
+
+  std::vector<RangeType> phi;
+  std::vector<JacobianType> js;
+
+  // element
+  {
+    std::vector<double> u(kernel.points());
+    std::vector<GradientType> gradu(kernel.points());
+    kernel.evaluate(&coefficients[0],&u[0],&gradu[0]);
+
+    std::vector<double> f(kernel.points());
+    std::vector<GradientType> g(kernel.points());
+    std::vector<double> residual(n,0.0);
+    std::vector<double> reference(n,0.0);
+    for (std::size_t q = 0; q < kernel.points(); ++q)
+      {
+        fe.localBasis().evaluateFunction(kernel.position(q),phi);
+        fe.localBasis().evaluateJacobian(kernel.position(q),js);
+        double value = 0.0;
+        GradientType gradient(0.0);
+        for (std::size_t i = 0; i < n; ++i)
+          {
+            value += coefficients[i]*phi[i];
+            gradient.axpy(coefficients[i],js[i][0]);
+          }
+        error = std::max(error,std::abs(value - u[q]));
+        gradient -= gradu[q];
+        error = std::max(error,gradient.infinity_norm());
+
+        f[q] = std::cos(1.0 + q)*kernel.weight(q);
+        for (int j = 0; j < d; ++j)
+          g[q][j] = std::cos(2.0 + j + q)*kernel.weight(q);
+        for (std::size_t i = 0; i < n; ++i)
+          reference[i] += f[q]*phi[i] + g[q]*js[i][0];
+      }
+    kernel.integrate(&f[0],&g[0],&residual[0]);
+    for (std::size_t i = 0; i < n; ++i)
+      error = std::max(error,std::abs(residual[i] - reference[i]));
+  }
+
+  // faces
+  for (int face = 0; face < 2*d; ++face)
+    {
+      std::vector<double> u(kernel.facePoints());
+      std::vector<GradientType> gradu(kernel.facePoints());
+      kernel.evaluateFace(face,&coefficients[0],&u[0],&gradu[0]);
+
+      std::vector<double> f(kernel.facePoints());
+      std::vector<GradientType> g(kernel.facePoints());
+      std::vector<double> residual(n,0.0);
+      std::vector<double> reference(n,0.0);
+      for (std::size_t q = 0; q < kernel.facePoints(); ++q)
+        {
+          fe.localBasis().evaluateFunction(kernel.facePosition(face,q),phi);
+          fe.localBasis().evaluateJacobian(kernel.facePosition(face,q),js);
+          double value = 0.0;
+          GradientType gradient(0.0);
+          for (std::size_t i = 0; i < n; ++i)
+            {
+              value += coefficients[i]*phi[i];
+              gradient.axpy(coefficients[i],js[i][0]);
+            }
+          error = std::max(error,std::abs(value - u[q]));
+          gradient -= gradu[q];
+          error = std::max(error,gradient.infinity_norm());
+
+          f[q] = std::cos(1.0 + q)*kernel.faceWeight(q);
+          for (int j = 0; j < d; ++j)
+            g[q][j] = std::cos(2.0 + j + q)*kernel.faceWeight(q);
+          for (std::size_t i = 0; i < n; ++i)
+            reference[i] += f[q]*phi[i] + g[q]*js[i][0];
+        }
+      kernel.integrateFace(face,&f[0],&g[0],&residual[0]);
+      for (std::size_t i = 0; i < n; ++i)
+        error = std::max(error,std::abs(residual[i] - reference[i]));
+    }
+
+  std::cout << name << ": maximum difference to the direct evaluation " << error << std::endl;
+  if (error > 1e-10)
+    {
+      std::cerr << name << ": sum-factorized kernel differs from the direct evaluation" << std::endl;
+      return false;
+    }
+  return true;
+}
+
+// convection-diffusion-reaction problem with all terms present
+template<typename GV, typename RF>
+class Problem
+  : public Dune::PDELab::ConvectionDiffusionModelProblem<GV,RF>
+{
+public:
+  typedef Dune::PDELab::ConvectionDiffusionParameterTraits<GV,RF> Traits;
+
+  //! velocity field
+  typename Traits::RangeType
+  b (const typename Traits::ElementType& e, const typename Traits::DomainType& x) const
+  {
+    typename Traits::RangeType v(0.5);
+    v[0] = 1.0;
+    return v;
+  }
+
+  //! sink term
+  typename Traits::RangeFieldType
+  c (const typename Traits::ElementType& e, const typename Traits::DomainType& x) const
+  {
+    return 1.0;
+  }
+
+  //! source term
+  typename Traits::RangeFieldType
+  f (const typename Traits::ElementType& e, const typename Traits::DomainType& x) const
+  {
+    return e.geometry().global(x).two_norm2();
+  }
+};
+
+template<typename GV, typename FEM>
+bool testConvectionDiffusionDG (const GV& gv, const FEM& fem, std::string name)
+{
+  typedef double R;
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef Problem<GV,R> Param;
+  Param param;
+
+  typedef Dune::PDELab::ConvectionDiffusionDG<Param,FEM> LOP;
+  LOP lop(param,Dune::PDELab::ConvectionDiffusionDGMethod::SIPG,
+          Dune::PDELab::ConvectionDiffusionDGWeights::weightsOn,2.0);
+
+  typedef Dune::PDELab::EmptyTransformation C;
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,gfs,lop,MBE(2*GV::dimension+1));
+
+  typedef typename GO::Traits::Domain V;
+  V x(gfs,0.0);
+  for (std::size_t i = 0; i < x.base().N(); ++i)
+    x.base()[i] = std::sin(1.0 + i);
+
+  V r(gfs,0.0);
+  go.residual(x,r);
+
+  lop.setSumFactorization(true);
+  V r_sumfact(gfs,0.0);
+  go.residual(x,r_sumfact);
+
+  // the kernel is shared by all threads of the colored assembly
+  go.assembler().setColoredAssembly(true);
+  go.assembler().setThreads(4);
+  V r_threaded(gfs,0.0);
+  go.residual(x,r_threaded);
+  r_threaded -= r_sumfact;
+  const R threaded_error = r_threaded.base().infinity_norm()/r.base().infinity_norm();
+
+  r_sumfact -= r;
+  const R error = r_sumfact.base().infinity_norm()/r.base().infinity_norm();
+  std::cout << name << ": relative difference of the residuals " << error
+            << ", with colored assembly " << threaded_error << std::endl;
+  if (error > 1e-10)
+    {
+      std::cerr << name << ": residual with sum factorization differs" << std::endl;
+      return false;
+    }
+  if (threaded_error > 1e-12)
+    {
+      std::cerr << name << ": colored residual with sum factorization differs" << std::endl;
+      return false;
+    }
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    passed &= testKernel<1,2>("kernel_Q1_2d");
+    passed &= testKernel<3,2>("kernel_Q3_2d");
+    passed &= testKernel<2,3>("kernel_Q2_3d");
+
+    // YaspGrid Q3 2D test
+    {
+      Dune::FieldVector<double,2> L(1.0);
+      Dune::array<int,2> N(Dune::fill_array<int,2>(8));
+      Dune::YaspGrid<2> grid(L,N);
+
+      typedef Dune::YaspGrid<2>::LeafGridView GV;
+      const GV& gv=grid.leafGridView();
+
+      typedef Dune::PDELab::QkDGLocalFiniteElementMap<double,double,3,2> FEM;
+      FEM fem;
+
+      passed &= testConvectionDiffusionDG(gv,fem,"yasp_Q3_2d");
+    }
+
+    // YaspGrid Q2 3D test
+    {
+      Dune::FieldVector<double,3> L(1.0);
+      Dune::array<int,3> N(Dune::fill_array<int,3>(4));
+      Dune::YaspGrid<3> grid(L,N);
+
+      typedef Dune::YaspGrid<3>::LeafGridView GV;
+      const GV& gv=grid.leafGridView();
+
+      typedef Dune::PDELab::QkDGLocalFiniteElementMap<double,double,2,3> FEM;
+      FEM fem;
+
+      passed &= testConvectionDiffusionDG(gv,fem,"yasp_Q2_3d");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,376 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab/finiteelementmap/qkfem.hh>
+#include <dune/pdelab/constraints/common/constraints.hh>
+#include <dune/pdelab/constraints/conforming.hh>
+#include <dune/pdelab/gridfunctionspace/gridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/vectorgridfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/interpolate.hh>
+#include <dune/pdelab/backend/istlvectorbackend.hh>
+#include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
+#include <dune/pdelab/backend/seqistlsolverbackend.hh>
+#include <dune/pdelab/gridoperator/gridoperator.hh>
+#include <dune/pdelab/localoperator/convectiondiffusionparameter.hh>
+#include <dune/pdelab/localoperator/convectiondiffusionfem.hh>
+#include <dune/pdelab/localoperator/linearelasticity.hh>
+#include <dune/pdelab/newton/newton.hh>
+
+#include "assemblycomparison.hh"
+#include "nonlineardiffusion.hh"
+
+//===============================================================
+// Checks that assembling the residual and the jacobian in a
+// single grid traversal gives the same results as the separate
+// assemblies, both for a local operator with a combined volume
+// method and for one without, that Newton's method finds the
+// same solution with and without the combined assembly, and that
+// the combined assembly saves one grid traversal per Newton
+// iteration with and without line search
+//===============================================================
+
+// A grid operator that counts its grid traversals
+template<typename GO>
+class CountingGridOperator
+  : public GO
+{
+public:
+  typedef typename GO::Traits::Domain Domain;
+  typedef typename GO::Traits::Range Range;
+  typedef typename GO::Traits::Jacobian Jacobian;
+
+  template<typename GFS, typename C, typename LOP, typename MBE>
+  CountingGridOperator (const GFS& gfs, const C& cg, LOP& lop, const MBE& mbe)
+    : GO(gfs,cg,gfs,cg,lop,mbe)
+  {
+    reset();
+  }
+
+  void residual (const Domain& x, Range& r) const
+  {
+    ++residuals;
+    GO::residual(x,r);
+  }
+
+  void jacobian (const Domain& x, Jacobian& a) const
+  {
+    ++jacobians;
+    GO::jacobian(x,a);
+  }
+
+  void residual_and_jacobian (const Domain& x, Range& r, Jacobian& a) const
+  {
+    ++combined;
+    GO::residual_and_jacobian(x,r,a);
+  }
+
+  void reset ()
+  {
+    residuals = 0;
+    jacobians = 0;
+    combined = 0;
+  }
+
+  std::size_t traversals () const
+  {
+    return residuals + jacobians + combined;
+  }
+
+  mutable std::size_t residuals;
+  mutable std::size_t jacobians;
+  mutable std::size_t combined;
+};
+
+template<typename GO>
+bool compareAssembly (GO& go, std::string name)
+{
+  typedef typename GO::Traits::Domain V;
+  typedef typename GO::Traits::Jacobian M;
+
+  V x(go.trialGridFunctionSpace());
+  fillCoefficients(x);
+
+  bool passed = true;
+  for (int batched = 0; batched < 2; ++batched)
+    {
+      go.assembler().setBatchedAssembly(batched);
+
+      V r(go.testGridFunctionSpace(),0.0), fr(go.testGridFunctionSpace(),0.0);
+      M m(go), fm(go);
+      m = 0.0;
+      fm = 0.0;
+
+      go.residual(x,r);
+      go.jacobian(x,m);
+      go.residual_and_jacobian(x,fr,fm);
+
+      passed &= compareResults(fr,fm,r,m,1e-12,batched ? name + " (batched)" : name,"combined assembly");
+    }
+  go.assembler().setBatchedAssembly(false);
+
+  return passed;
+}
+
+template<typename GV, typename FEM>
+bool testConvectionDiffusion (const GV& gv, const FEM& fem, int degree, std::string name)
+{
+  typedef double R;
+  const int dim = GV::dimension;
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::ConformingDirichletConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef Dune::PDELab::ConvectionDiffusionModelProblem<GV,R> Problem;
+  Problem problem;
+  Dune::PDELab::ConvectionDiffusionBoundaryConditionAdapter<Problem> bctype(gv,problem);
+
+  typedef typename GFS::template ConstraintsContainer<R>::Type C;
+  C cg;
+  Dune::PDELab::constraints(bctype,gfs,cg);
+
+  typedef Dune::PDELab::ConvectionDiffusionFEM<Problem,FEM> LOP;
+  LOP lop(problem);
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  int entries = 1;
+  for (int i = 0; i < dim; ++i)
+    entries *= 2*degree+1;
+  MBE mbe(entries);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,cg,gfs,cg,lop,mbe);
+
+  bool passed = compareAssembly(go,name);
+
+  // solve with Newton's method with and without the combined assembly
+  typedef typename GO::Traits::Domain V;
+  typedef Dune::PDELab::ISTLBackend_SEQ_BCGS_AMG_SSOR<GO> LS;
+
+  V x(gfs,0.0), fx(gfs,0.0);
+  LS ls(5000,0);
+  Dune::PDELab::Newton<GO,LS,V> newton(go,x,ls);
+  newton.setReduction(1e-10);
+  newton.setVerbosityLevel(0);
+  newton.setLineSearchStrategy(Dune::PDELab::Newton<GO,LS,V>::noLineSearch);
+  newton.apply();
+
+  LS fls(5000,0);
+  Dune::PDELab::Newton<GO,LS,V> fused_newton(go,fx,fls);
+  fused_newton.setReduction(1e-10);
+  fused_newton.setVerbosityLevel(0);
+  fused_newton.setLineSearchStrategy(Dune::PDELab::Newton<GO,LS,V>::noLineSearch);
+  fused_newton.setFusedAssembly(true);
+  fused_newton.apply();
+
+  fx -= x;
+  const double solution_difference = fx.infinity_norm()/std::max(x.infinity_norm(),1.0);
+  std::cout << name << ": Newton iterations " << newton.result().iterations
+            << ", combined " << fused_newton.result().iterations
+            << ", relative difference of the solutions " << solution_difference << std::endl;
+  if (newton.result().iterations != fused_newton.result().iterations || solution_difference > 1e-8)
+    {
+      std::cerr << name << ": Newton's method gives different results with combined assembly" << std::endl;
+      passed = false;
+    }
+
+  return passed;
+}
+
+template<typename GV, typename FEM>
+bool testElasticity (const GV& gv, const FEM& fem, std::string name)
+{
+  typedef double R;
+  const int dim = GV::dimension;
+
+  typedef Dune::PDELab::VectorGridFunctionSpace<GV,FEM,dim,
+    Dune::PDELab::ISTLVectorBackend<>,
+    Dune::PDELab::ISTLVectorBackend<>,
+    Dune::PDELab::ConformingDirichletConstraints> GFS;
+  GFS gfs(gv,fem);
+
+  typedef ElasticityProblem<GV> Problem;
+  Problem problem;
+
+  typedef typename GFS::template ConstraintsContainer<R>::Type C;
+  C cg;
+  Dune::PDELab::constraints(problem,gfs,cg);
+
+  typedef Dune::PDELab::LinearElasticity<Problem> LOP;
+  LOP lop(problem);
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  MBE mbe(9*dim);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> GO;
+  GO go(gfs,cg,gfs,cg,lop,mbe);
+
+  return compareAssembly(go,name);
+}
+
+// Solves a nonlinear problem with Newton's method with and without the combined assembly
+// and counts the grid traversals. Without the combined assembly, every iteration traverses
+// the grid for the jacobian and for the defect at the new iterate. With it, the jacobian
+// is assembled together with the defect of the full step, so an iteration whose full step
+// is accepted takes a single traversal, with and without line search.
+template<typename GV, typename FEM>
+bool testNewtonTraversals (const GV& gv, const FEM& fem, std::string name)
+{
+  typedef double R;
+
+  typedef Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::ConformingDirichletConstraints,
+    Dune::PDELab::ISTLVectorBackend<> > GFS;
+  GFS gfs(gv,fem);
+
+  typedef typename GFS::template ConstraintsContainer<R>::Type C;
+  C cg;
+  Dune::PDELab::DirichletConstraintsParameters constraintsparameters;
+  Dune::PDELab::constraints(constraintsparameters,gfs,cg);
+
+  typedef NumericalNonlinearDiffusionFEM LOP;
+  LOP lop;
+
+  typedef Dune::PDELab::istl::BCRSMatrixBackend<> MBE;
+  MBE mbe(9);
+
+  typedef Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,R,R,R,C,C> BaseGO;
+  typedef CountingGridOperator<BaseGO> GO;
+  GO go(gfs,cg,lop,mbe);
+
+  typedef typename GO::Traits::Domain V;
+  typedef Dune::PDELab::ISTLBackend_SEQ_BCGS_AMG_SSOR<GO> LS;
+  typedef Dune::PDELab::Newton<GO,LS,V> Newton;
+
+  G<GV,R> g(gv);
+  bool passed = true;
+
+  for (int line_search = 0; line_search < 2; ++line_search)
+    {
+      const std::string variant = name + (line_search ? " (line search)" : " (no line search)");
+
+      V x[2] = { V(gfs,0.0), V(gfs,0.0) };
+      std::size_t iterations[2];
+      for (int fused = 0; fused < 2; ++fused)
+        {
+          Dune::PDELab::interpolate(g,gfs,x[fused]);
+          LS ls(5000,0);
+          Newton newton(go,x[fused],ls);
+          newton.setReduction(1e-10);
+          newton.setVerbosityLevel(0);
+          newton.setLineSearchStrategy(line_search ? Newton::hackbuschReusken : Newton::noLineSearch);
+          newton.setFusedAssembly(fused);
+          go.reset();
+          newton.apply();
+          iterations[fused] = newton.result().iterations;
+
+          std::cout << variant << (fused ? ", combined" : ", separate") << ": "
+                    << iterations[fused] << " iterations, " << go.traversals() << " grid traversals ("
+                    << go.residuals << " residual, " << go.jacobians << " jacobian, "
+                    << go.combined << " combined), "
+                    << double(go.traversals())/iterations[fused] << " per iteration" << std::endl;
+
+          if (!fused)
+            {
+              if (go.combined != 0 || go.jacobians != iterations[fused] || go.residuals < iterations[fused] + 1)
+                {
+                  std::cerr << variant << ": wrong grid traversals without combined assembly" << std::endl;
+                  passed = false;
+                }
+            }
+          else if (go.residuals == 0)
+            {
+              // every full step has been accepted
+              if (go.jacobians != 0 || go.combined != iterations[fused] + 1)
+                {
+                  std::cerr << variant << ": " << go.traversals() << " grid traversals for "
+                            << iterations[fused] << " iterations, expected "
+                            << iterations[fused] + 1 << std::endl;
+                  passed = false;
+                }
+            }
+          else if (go.jacobians > go.residuals)
+            {
+              // only a rejected full step requires a separate jacobian
+              std::cerr << variant << ": " << go.jacobians << " separate jacobians for "
+                        << go.residuals << " damped trial iterates" << std::endl;
+              passed = false;
+            }
+        }
+
+      x[1] -= x[0];
+      const double solution_difference = x[1].infinity_norm()/std::max(x[0].infinity_norm(),1.0);
+      if (iterations[0] != iterations[1] || solution_difference > 1e-8)
+        {
+          std::cerr << variant << ": Newton's method gives different results with combined assembly"
+                    << ", relative difference of the solutions " << solution_difference << std::endl;
+          passed = false;
+        }
+    }
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try{
+    //Maybe initialize Mpi
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> N(Dune::fill_array<int,2>(16));
+    Dune::YaspGrid<2> grid(L,N);
+
+    typedef Dune::YaspGrid<2>::LeafGridView GV;
+    const GV& gv=grid.leafGridView();
+
+    // ConvectionDiffusionFEM provides alpha_jacobian_volume()
+    {
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+      FEM fem(gv);
+      passed &= testConvectionDiffusion(gv,fem,1,"convectiondiffusionfem_Q1_2d");
+    }
+    {
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,2> FEM;
+      FEM fem(gv);
+      passed &= testConvectionDiffusion(gv,fem,2,"convectiondiffusionfem_Q2_2d");
+    }
+
+    // LinearElasticity calls alpha_volume() and jacobian_volume() one after the other
+    {
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+      FEM fem(gv);
+      passed &= testElasticity(gv,fem,"linearelasticity_Q1_2d");
+    }
+
+    // grid traversals of Newton's method for a nonlinear problem
+    {
+      typedef Dune::PDELab::QkLocalFiniteElementMap<GV,double,double,1> FEM;
+      FEM fem(gv);
+      passed &= testNewtonTraversals(gv,fem,"nonlineardiffusion_Q1_2d");
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (Dune::Exception &e){
+    std::cerr << "Dune reported error: " << e << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -423,6 +423,30 @@ void testgridfunctions (const GV& gv)
       exit(1);
     if (vgrad[1][1]!=2.0)
       exit(1);
+
+    // evaluation at several points of the element at once has to agree
+    // with the evaluation point by point
+    std::vector<typename DGFV::Traits::DomainType> points(3);
+    points[0] = 0.25;
+    points[1] = 0.5;
+    points[2][0] = 0.75; points[2][1] = 0.1;
+    std::vector<typename DGFV::Traits::RangeType> values;
+    std::vector<typename DGFVG::Traits::RangeType> gradients;
+    dgfv.evaluate(*eit, points, values);
+    dgfvg.evaluate(*eit, points, gradients);
+    if (values.size()!=points.size() || gradients.size()!=points.size())
+      exit(1);
+    for (std::size_t i=0; i<points.size(); i++)
+    {
+      typename DGFV::Traits::RangeType v;
+      typename DGFVG::Traits::RangeType g;
+      dgfv.evaluate(*eit, points[i], v);
+      dgfvg.evaluate(*eit, points[i], g);
+      v -= values[i];
+      g -= gradients[i];
+      if (v.infinity_norm()>1e-14 || g.infinity_norm()>1e-14)
+        exit(1);
+    }
   }
 }
 
@@ -0,0 +1,35 @@
+dnl DUNE_OPENMP
+dnl ------------------------------------------------------
+dnl Check for the compiler and linker flags that enable OpenMP for C++.
+dnl OpenMP is optional: the threaded code paths of dune-pdelab (e.g. the
+dnl colored mode of DefaultAssembler) are only compiled when _OPENMP is
+dnl defined, and the flags are not added to the module flags, so every
+dnl program that wants to use threads has to add them explicitly.  The
+dnl check can be disabled with --disable-openmp.  The result is recorded
+dnl as follows:
+dnl
+dnl automake conditionals:
+dnl   OPENMP
+dnl
+dnl Makefile variables:
+dnl   OPENMP_CXXFLAGS
+dnl     the flags to enable OpenMP for C++, empty if not found
+dnl   OPENMP_CPPFLAGS
+dnl   OPENMP_LDFLAGS
+dnl     the same flags for use in per-target CPPFLAGS and LDFLAGS
+AC_DEFUN([DUNE_OPENMP], [
+  AC_LANG_PUSH([C++])
+  AC_OPENMP
+  AC_LANG_POP([C++])
+
+  AS_IF([test "x$ac_cv_prog_cxx_openmp" != "x" &&
+         test "x$ac_cv_prog_cxx_openmp" != "xunsupported"],
+    [dune_cv_openmp=yes],
+    [dune_cv_openmp=no])
+
+  AC_SUBST([OPENMP_CPPFLAGS], ["$OPENMP_CXXFLAGS"])
+  AC_SUBST([OPENMP_LDFLAGS],  ["$OPENMP_CXXFLAGS"])
+  AM_CONDITIONAL([OPENMP], [test x"$dune_cv_openmp" = xyes])
+
+  DUNE_ADD_SUMMARY_ENTRY([OpenMP], [$dune_cv_openmp])
+])
@@ -5,6 +5,7 @@ AC_DEFUN([DUNE_PDELAB_CHECKS],
   AC_REQUIRE([DUNE_PATH_PETSC])
   AC_REQUIRE([DUNE_EIGEN])
   AC_REQUIRE([DUNE_FUNC_POSIX_CLOCK])
+  AC_REQUIRE([DUNE_OPENMP])
   DUNE_ADD_MODULE_DEPS([dune-pdelab], [POSIX_CLOCK],
     [$POSIX_CLOCK_CPPFLAGS], [$POSIX_CLOCK_LDFLAGS], [$POSIX_CLOCK_LIBS])
 ])